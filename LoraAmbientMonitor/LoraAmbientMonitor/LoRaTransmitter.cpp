@@ -10,6 +10,9 @@
   Revision History:
 
   2023/03/25 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Save/Restore of State for Deep Sleep
+  2026/10/18 -rs:   V1.02 Time-on-Air Calculation and Duty Cycle Budget
+  2026/10/18 -rs:   V1.03 Optional slotted Transmit Schedule
 
 ****************************************************************************/
 
@@ -59,6 +62,28 @@ LoraTransmitter::LoraTransmitter()
     m_ui32TransmitCycleTime         = 0;
     m_ui32SysTickLastTransmitPacket = 0;
 
+    m_iLoraSpreadingFactor          = 7;
+    m_lLoraSignalBandwidth          = 125E3;
+    m_iLoraCodingRateDenominator    = 5;
+
+    m_ui32DutyCycleWindow           = 0;
+    m_ui32DutyCycleMaxAirTime       = 0;
+    m_ui32DutyCycleBucketTime       = 0;
+    m_ui32DutyCycleBucketStartTick  = 0;
+    m_iDutyCycleBucketIdx           = 0;
+    memset(m_aui32DutyCycleBucket, 0x00, sizeof(m_aui32DutyCycleBucket));
+    m_ui32LastAirTime               = 0;
+    m_ui32TransmitCount             = 0;
+    m_ui32DeferredCount             = 0;
+
+    m_fSlottedSchedule              = false;
+    m_ui16SlotID                    = 0;
+    m_ui16SlotCount                 = 1;
+    m_ui32SlotCycleTime             = 0;
+    m_ui32SlotGuardTime             = 0;
+    m_ui32SlotEpochTick             = 0;                // Slot Grid starts with Power-On (Uptime 0)
+    m_ui32MeasuredAirTime           = 0;
+
     return;
 
 }
@@ -111,6 +136,26 @@ int  iRes;
         return (-1);
     }
 
+    // keep radio settings for Time-on-Air calculation
+    m_iLoraSpreadingFactor       = pSettings_p->m_iLoraSpreadingFactor;
+    m_lLoraSignalBandwidth       = pSettings_p->m_lLoraSignalBandwidth;
+    m_iLoraCodingRateDenominator = pSettings_p->m_iLoraCodingRateDenominator;
+
+    // setup Duty Cycle Budget: sliding window, divided into DUTY_CYCLE_BUCKETS
+    // buckets, each holding the airtime of the packets sent within its period
+    m_ui32DutyCycleWindow = pSettings_p->m_ui32DutyCycleWindow;
+    m_ui32DutyCycleMaxAirTime = 0;
+    m_ui32DutyCycleBucketTime = 0;
+    if ((pSettings_p->m_ui16DutyCycleLimit > 0) && (m_ui32DutyCycleWindow >= DUTY_CYCLE_BUCKETS))
+    {
+        // [ms] * [1/10 %] -> [us]: Window * Limit / 1000 * 1000
+        m_ui32DutyCycleMaxAirTime = m_ui32DutyCycleWindow * (uint32_t)pSettings_p->m_ui16DutyCycleLimit;
+        m_ui32DutyCycleBucketTime = m_ui32DutyCycleWindow / DUTY_CYCLE_BUCKETS;
+    }
+    m_ui32DutyCycleBucketStartTick = millis();
+    m_iDutyCycleBucketIdx = 0;
+    memset(m_aui32DutyCycleBucket, 0x00, sizeof(m_aui32DutyCycleBucket));
+
     // init random generator, used by <CalcNextTransmitCycleTime>
     randomSeed(uiRandomSeed_p);
     
@@ -120,6 +165,36 @@ int  iRes;
 
 
 
+//---------------------------------------------------------------------------
+//  SetupSlottedSchedule
+//---------------------------------------------------------------------------
+
+//  Instead of a random Cycle Time, Packets are transmitted in a fixed Slot
+//  of a Grid with period <ui32SlotCycleTime_p>. The Grid is anchored at the
+//  Uptime (0 = Power-On, continued across Deep Sleep by Save/RestoreState),
+//  so a Fleet powered up together shares the same Grid without any Downlink.
+//  The Slots of all <ui16SlotCount_p> IDs are spread evenly over the Cycle.
+
+int  LoraTransmitter::SetupSlottedSchedule (uint16_t ui16SlotID_p, uint16_t ui16SlotCount_p, uint32_t ui32SlotCycleTime_p, uint32_t ui32SlotGuardTime_p)
+{
+
+    if ((ui16SlotCount_p == 0) || (ui16SlotID_p >= ui16SlotCount_p) || (ui32SlotCycleTime_p == 0))
+    {
+        return (-1);
+    }
+
+    m_fSlottedSchedule  = true;
+    m_ui16SlotID        = ui16SlotID_p;
+    m_ui16SlotCount     = ui16SlotCount_p;
+    m_ui32SlotCycleTime = ui32SlotCycleTime_p;
+    m_ui32SlotGuardTime = ui32SlotGuardTime_p;
+
+    return (0);
+
+}
+
+
+
 //---------------------------------------------------------------------------
 //  CalcNextTransmitCycleTime
 //---------------------------------------------------------------------------
@@ -127,15 +202,34 @@ int  iRes;
 uint32_t  LoraTransmitter::CalcNextTransmitCycleTime (uint32_t ui32LoraPacketInhibitTime_p, uint32_t ui32LoraPacketCycleTime_p)
 {
 
-float  flCycleTimeLowerBound;
-float  flCycleTimeUpperBound;
-float  flCycleTimeRange;
-float  flCycleTimeShift;
-float  flRandomValue;
+float     flCycleTimeLowerBound;
+float     flCycleTimeUpperBound;
+float     flCycleTimeRange;
+float     flCycleTimeShift;
+float     flRandomValue;
+uint32_t  ui32MinCycleTime;
+uint32_t  ui32NextSlotTick;
 
 
     m_ui32TransmitInhibitTime = ui32LoraPacketInhibitTime_p;
 
+    if ( m_fSlottedSchedule )
+    {
+        // transmit in the next own Slot, but not before the Inhibit Time has
+        // expired; a late Transmission is made up by shortening the following
+        // Cycle by max. 1/SLOT_MAX_CORRECTION, if it was even later (e.g. deferred
+        // by the Duty Cycle Budget) the next Slot is skipped
+        ui32MinCycleTime = ui32LoraPacketCycleTime_p - (ui32LoraPacketCycleTime_p / SLOT_MAX_CORRECTION);
+        if (ui32MinCycleTime < m_ui32TransmitInhibitTime)
+        {
+            ui32MinCycleTime = m_ui32TransmitInhibitTime;
+        }
+        ui32NextSlotTick = CalcNextSlotTime(m_ui32SysTickLastTransmitPacket + ui32MinCycleTime);
+        m_ui32TransmitCycleTime = ui32NextSlotTick - m_ui32SysTickLastTransmitPacket;
+
+        return (m_ui32TransmitCycleTime);
+    }
+
     flCycleTimeLowerBound = round((float)ui32LoraPacketCycleTime_p * 0.95F);            // LowerBound =  95%
     flCycleTimeUpperBound = round((float)ui32LoraPacketCycleTime_p * 1.05F);            // UpperBound = 105%
 
@@ -162,7 +256,7 @@ float  flRandomValue;
 //  GetReasonToTransmitPacket
 //---------------------------------------------------------------------------
 
-int  LoraTransmitter::GetReasonToTransmitPacket (bool* pfAsyncTransmitEvent_p)
+int  LoraTransmitter::GetReasonToTransmitPacket (bool* pfAsyncTransmitEvent_p, uint8_t ui8TxPacketLen_p)
 {
 
 uint32_t  ui32CurrTick;
@@ -176,6 +270,18 @@ uint32_t  ui32CurrTick;
         return (-1);
     }
 
+    if ( *pfAsyncTransmitEvent_p || ((ui32CurrTick - m_ui32SysTickLastTransmitPacket) >= m_ui32TransmitCycleTime) )
+    {
+        if (GetDutyCycleWaitTime(ui8TxPacketLen_p) > 0)
+        {
+            // defer transmission until the Duty Cycle Budget allows it again,
+            // a pending asynchronous event is kept, so further events arriving
+            // in the meantime are coalesced into one transmission
+            m_ui32DeferredCount++;
+            return (-2);
+        }
+    }
+
     if ( *pfAsyncTransmitEvent_p )
     {
         // trigger asynchronous transmission before expiration of regular cycle time
@@ -223,7 +329,8 @@ int32_t   i32RemainingTime;
 int  LoraTransmitter::TransmitPacket (const void* pTxPacket_p, uint8_t ui8TxPacketLen_p, bool fLogDataToConsole_p /* = false */)
 {
 
-int  iRes;
+uint32_t  ui32StartTick;
+int       iRes;
 
 
     iRes = LoRa.beginPacket();
@@ -243,6 +350,8 @@ int  iRes;
         return (-2);
     }
 
+    // <endPacket> blocks until the Packet is sent, so its duration is the Time-on-Air
+    ui32StartTick = millis();
     iRes = LoRa.endPacket();
     if (iRes != 1)
     {
@@ -250,6 +359,16 @@ int  iRes;
     }
 
     m_ui32SysTickLastTransmitPacket = millis();
+    if ((m_ui32SysTickLastTransmitPacket - ui32StartTick) > m_ui32MeasuredAirTime)
+    {
+        m_ui32MeasuredAirTime = m_ui32SysTickLastTransmitPacket - ui32StartTick;
+    }
+
+    // charge Duty Cycle Budget
+    m_ui32LastAirTime = GetTimeOnAir(ui8TxPacketLen_p);
+    AdvanceDutyCycleWindow(m_ui32SysTickLastTransmitPacket);
+    m_aui32DutyCycleBucket[m_iDutyCycleBucketIdx] += m_ui32LastAirTime;
+    m_ui32TransmitCount++;
 
     return (0);
 
@@ -284,6 +403,254 @@ bool      fIndicatorState;
 
 
 
+//---------------------------------------------------------------------------
+//  Sleep (Radio Transceiver in Sleep Mode, woken up by next <TransmitPacket>)
+//---------------------------------------------------------------------------
+
+void  LoraTransmitter::Sleep ()
+{
+
+    LoRa.sleep();
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  SaveState
+//---------------------------------------------------------------------------
+
+void  LoraTransmitter::SaveState (tRetainState* pRetainState_p)
+{
+
+    pRetainState_p->m_ui32TransmitInhibitTime   = m_ui32TransmitInhibitTime;
+    pRetainState_p->m_ui32TransmitCycleTime     = m_ui32TransmitCycleTime;
+    pRetainState_p->m_ui32TimeSinceLastTransmit = millis() - m_ui32SysTickLastTransmitPacket;
+    pRetainState_p->m_ui32TimeSinceBucketStart  = millis() - m_ui32DutyCycleBucketStartTick;
+    pRetainState_p->m_iDutyCycleBucketIdx       = m_iDutyCycleBucketIdx;
+    memcpy(pRetainState_p->m_aui32DutyCycleBucket, m_aui32DutyCycleBucket, sizeof(pRetainState_p->m_aui32DutyCycleBucket));
+    pRetainState_p->m_ui32TransmitCount         = m_ui32TransmitCount;
+    pRetainState_p->m_ui32DeferredCount         = m_ui32DeferredCount;
+    pRetainState_p->m_ui32TimeSinceSlotEpoch    = millis() - m_ui32SlotEpochTick;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  RestoreState
+//---------------------------------------------------------------------------
+
+void  LoraTransmitter::RestoreState (const tRetainState* pRetainState_p, uint32_t ui32ElapsedTime_p)
+{
+
+    // millis() restarts after Deep Sleep, so the time of the last transmission
+    // is rebuilt relative to the current SysTick (<ui32ElapsedTime_p> = time
+    // between <SaveState> and <RestoreState>)
+    m_ui32TransmitInhibitTime       = pRetainState_p->m_ui32TransmitInhibitTime;
+    m_ui32TransmitCycleTime         = pRetainState_p->m_ui32TransmitCycleTime;
+    m_ui32SysTickLastTransmitPacket = millis() - (pRetainState_p->m_ui32TimeSinceLastTransmit + ui32ElapsedTime_p);
+
+    m_ui32DutyCycleBucketStartTick  = millis() - (pRetainState_p->m_ui32TimeSinceBucketStart + ui32ElapsedTime_p);
+    m_iDutyCycleBucketIdx           = pRetainState_p->m_iDutyCycleBucketIdx;
+    memcpy(m_aui32DutyCycleBucket, pRetainState_p->m_aui32DutyCycleBucket, sizeof(m_aui32DutyCycleBucket));
+    m_ui32TransmitCount             = pRetainState_p->m_ui32TransmitCount;
+    m_ui32DeferredCount             = pRetainState_p->m_ui32DeferredCount;
+    AdvanceDutyCycleWindow(millis());
+
+    // re-phase Slot Grid to the Uptime before Deep Sleep
+    m_ui32SlotEpochTick             = millis() - (pRetainState_p->m_ui32TimeSinceSlotEpoch + ui32ElapsedTime_p);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  GetTimeOnAir [us] (for current Radio Settings)
+//---------------------------------------------------------------------------
+
+uint32_t  LoraTransmitter::GetTimeOnAir (uint8_t ui8TxPacketLen_p)
+{
+
+    return (CalcTimeOnAir(m_iLoraSpreadingFactor, m_lLoraSignalBandwidth, m_iLoraCodingRateDenominator,
+                          LORA_PREAMBLE_LENGTH, LORA_CRC_ENABLED, false, ui8TxPacketLen_p));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  GetDutyCycleWaitTime [ms] (0 = Packet can be transmitted immediately)
+//---------------------------------------------------------------------------
+
+uint32_t  LoraTransmitter::GetDutyCycleWaitTime (uint8_t ui8TxPacketLen_p)
+{
+
+uint32_t  ui32TimeOnAir;
+uint32_t  ui32UsedAirTime;
+uint32_t  ui32WaitTime;
+int       iIdx;
+int       iCnt;
+
+
+    if (m_ui32DutyCycleMaxAirTime == 0)
+    {
+        return (0);                                                 // no limit configured
+    }
+
+    AdvanceDutyCycleWindow(millis());
+
+    ui32TimeOnAir = GetTimeOnAir(ui8TxPacketLen_p);
+    if (ui32TimeOnAir > m_ui32DutyCycleMaxAirTime)
+    {
+        return (m_ui32DutyCycleWindow);                             // can never be sent, retry after one window
+    }
+
+    ui32UsedAirTime = GetUsedAirTime();
+    if ((ui32UsedAirTime + ui32TimeOnAir) <= m_ui32DutyCycleMaxAirTime)
+    {
+        return (0);
+    }
+
+    // release the oldest buckets until the packet fits into the budget
+    // (oldest bucket = bucket following the current one)
+    ui32WaitTime = m_ui32DutyCycleBucketTime - (millis() - m_ui32DutyCycleBucketStartTick);
+    iIdx = m_iDutyCycleBucketIdx;
+    for (iCnt=0; iCnt<(DUTY_CYCLE_BUCKETS-1); iCnt++)
+    {
+        iIdx = (iIdx + 1) % DUTY_CYCLE_BUCKETS;
+        ui32UsedAirTime -= m_aui32DutyCycleBucket[iIdx];
+        if ((ui32UsedAirTime + ui32TimeOnAir) <= m_ui32DutyCycleMaxAirTime)
+        {
+            break;
+        }
+        ui32WaitTime += m_ui32DutyCycleBucketTime;
+    }
+
+    return (ui32WaitTime);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  GetDutyCycleInfo
+//---------------------------------------------------------------------------
+
+void  LoraTransmitter::GetDutyCycleInfo (tDutyCycleInfo* pDutyCycleInfo_p)
+{
+
+    AdvanceDutyCycleWindow(millis());
+
+    pDutyCycleInfo_p->m_ui32Window        = m_ui32DutyCycleWindow;
+    pDutyCycleInfo_p->m_ui32MaxAirTime    = m_ui32DutyCycleMaxAirTime;
+    pDutyCycleInfo_p->m_ui32UsedAirTime   = GetUsedAirTime();
+    pDutyCycleInfo_p->m_ui32LastAirTime   = m_ui32LastAirTime;
+    pDutyCycleInfo_p->m_ui32TransmitCount = m_ui32TransmitCount;
+    pDutyCycleInfo_p->m_ui32DeferredCount = m_ui32DeferredCount;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  GetSlotOffset [ms] (Position of own Slot within the Cycle)
+//---------------------------------------------------------------------------
+
+uint32_t  LoraTransmitter::GetSlotOffset ()
+{
+
+uint32_t  ui32SlotLength;
+uint32_t  ui32SlotSpacing;
+uint32_t  ui32SlotsPerCycle;
+
+
+    if ( !m_fSlottedSchedule )
+    {
+        return (0);
+    }
+
+    // Slot Length = Time-on-Air (calculated or measured, whichever is longer) + Guard Time
+    ui32SlotLength = (m_ui32LastAirTime + 999) / 1000;
+    if (m_ui32MeasuredAirTime > ui32SlotLength)
+    {
+        ui32SlotLength = m_ui32MeasuredAirTime;
+    }
+    ui32SlotLength += m_ui32SlotGuardTime;
+
+    ui32SlotSpacing = m_ui32SlotCycleTime / m_ui16SlotCount;
+    ui32SlotsPerCycle = m_ui16SlotCount;
+    if (ui32SlotSpacing < ui32SlotLength)
+    {
+        // not all Slots fit into the Cycle -> pack them as close as possible,
+        // the remaining IDs have to share Slots
+        ui32SlotSpacing = ui32SlotLength;
+        ui32SlotsPerCycle = m_ui32SlotCycleTime / ui32SlotSpacing;
+        if (ui32SlotsPerCycle == 0)
+        {
+            ui32SlotsPerCycle = 1;
+        }
+    }
+
+    return ((m_ui16SlotID % ui32SlotsPerCycle) * ui32SlotSpacing);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  CalcTimeOnAir [us] (Semtech SX1276 Datasheet, Chapter 4.1.1.7)
+//---------------------------------------------------------------------------
+
+uint32_t  LoraTransmitter::CalcTimeOnAir (int iSpreadingFactor_p, long lSignalBandwidth_p, int iCodingRateDenominator_p,
+                                          int iPreambleLength_p, bool fCrcEnabled_p, bool fImplicitHeader_p, uint8_t ui8PayloadLen_p)
+{
+
+int       iLowDataRateOpt;
+int       iNumerator;
+int       iDenominator;
+int       iPayloadSymbols;
+uint64_t  ui64QuarterSymbols;
+uint64_t  ui64TimeOnAir;
+
+
+    if ((iSpreadingFactor_p < 6) || (iSpreadingFactor_p > 12) || (lSignalBandwidth_p < (1L << iSpreadingFactor_p)))
+    {
+        return (0);
+    }
+
+    // LowDataRateOptimize is enabled by the LoRa library if symbol duration exceeds 16ms,
+    // use the same integer calculation as <LoRaClass::setLdoFlag()> (SF11/125kHz -> 16ms -> off)
+    iLowDataRateOpt = ((1000L / (lSignalBandwidth_p / (1L << iSpreadingFactor_p))) > 16) ? 1 : 0;
+
+    // PayloadSymbols = 8 + max(ceil((8PL - 4SF + 28 + 16CRC - 20IH) / (4(SF - 2DE))) * (CR + 4), 0)
+    iNumerator = (8 * (int)ui8PayloadLen_p) - (4 * iSpreadingFactor_p) + 28 + (fCrcEnabled_p ? 16 : 0) - (fImplicitHeader_p ? 20 : 0);
+    iDenominator = 4 * (iSpreadingFactor_p - (2 * iLowDataRateOpt));
+    iPayloadSymbols = 8;
+    if (iNumerator > 0)
+    {
+        iPayloadSymbols += ((iNumerator + iDenominator - 1) / iDenominator) * iCodingRateDenominator_p;
+    }
+
+    // Preamble = (PreambleLength + 4.25) Symbols, calculate in 1/4 Symbols to stay in integer range
+    ui64QuarterSymbols = (uint64_t)((4 * iPreambleLength_p) + 17) + (uint64_t)(4 * iPayloadSymbols);
+
+    // SymbolTime = 2^SF / BW
+    ui64TimeOnAir = (ui64QuarterSymbols * ((uint64_t)1000000 << iSpreadingFactor_p)) / ((uint64_t)lSignalBandwidth_p * 4);
+
+    return ((uint32_t)ui64TimeOnAir);
+
+}
+
+
+
 
 
 /////////////////////////////////////////////////////////////////////////////
@@ -376,4 +743,91 @@ int                   nCol;
 
 
 
+//---------------------------------------------------------------------------
+//  Private: AdvanceDutyCycleWindow (discard buckets outside of window)
+//---------------------------------------------------------------------------
+
+void  LoraTransmitter::AdvanceDutyCycleWindow (uint32_t ui32CurrTick_p)
+{
+
+int  iCnt;
+
+
+    if (m_ui32DutyCycleBucketTime == 0)
+    {
+        return;
+    }
+
+    for (iCnt=0; (ui32CurrTick_p - m_ui32DutyCycleBucketStartTick) >= m_ui32DutyCycleBucketTime; iCnt++)
+    {
+        if (iCnt >= DUTY_CYCLE_BUCKETS)
+        {
+            // whole window expired
+            memset(m_aui32DutyCycleBucket, 0x00, sizeof(m_aui32DutyCycleBucket));
+            m_ui32DutyCycleBucketStartTick = ui32CurrTick_p;
+            break;
+        }
+
+        m_iDutyCycleBucketIdx = (m_iDutyCycleBucketIdx + 1) % DUTY_CYCLE_BUCKETS;
+        m_aui32DutyCycleBucket[m_iDutyCycleBucketIdx] = 0;
+        m_ui32DutyCycleBucketStartTick += m_ui32DutyCycleBucketTime;
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Private: GetUsedAirTime [us] (within sliding window)
+//---------------------------------------------------------------------------
+
+uint32_t  LoraTransmitter::GetUsedAirTime ()
+{
+
+uint32_t  ui32UsedAirTime;
+int       iIdx;
+
+
+    ui32UsedAirTime = 0;
+    for (iIdx=0; iIdx<DUTY_CYCLE_BUCKETS; iIdx++)
+    {
+        ui32UsedAirTime += m_aui32DutyCycleBucket[iIdx];
+    }
+
+    return (ui32UsedAirTime);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Private: CalcNextSlotTime (first own Slot at or after <ui32EarliestTick_p>)
+//---------------------------------------------------------------------------
+
+uint32_t  LoraTransmitter::CalcNextSlotTime (uint32_t ui32EarliestTick_p)
+{
+
+uint32_t  ui32Cycles;
+uint32_t  ui32SlotTick;
+
+
+    // move Epoch to the last Cycle start before <ui32EarliestTick_p>, so the
+    // differences stay small across the wrap around of millis() (49 days)
+    ui32Cycles = (ui32EarliestTick_p - m_ui32SlotEpochTick) / m_ui32SlotCycleTime;
+    m_ui32SlotEpochTick += ui32Cycles * m_ui32SlotCycleTime;
+
+    ui32SlotTick = m_ui32SlotEpochTick + GetSlotOffset();
+    if ((int32_t)(ui32SlotTick - ui32EarliestTick_p) < 0)
+    {
+        ui32SlotTick += m_ui32SlotCycleTime;
+    }
+
+    return (ui32SlotTick);
+
+}
+
+
+
 //  EOF
@@ -10,6 +10,9 @@
   Revision History:
 
   2023/03/25 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Save/Restore of State for Deep Sleep
+  2026/10/18 -rs:   V1.02 Time-on-Air Calculation and Duty Cycle Budget
+  2026/10/18 -rs:   V1.03 Optional slotted Transmit Schedule
 
 ****************************************************************************/
 
@@ -47,23 +50,58 @@ class  LoraTransmitter
 
     public:
 
+        static const int    LORA_PREAMBLE_LENGTH    = 8;                // LoRa library default
+        static const bool   LORA_CRC_ENABLED        = false;            // LoRa library default (no enableCrc())
+        static const int    DUTY_CYCLE_BUCKETS      = 60;               // resolution of sliding Duty Cycle Window
+        static const int    SLOT_MAX_CORRECTION     = 20;               // late Transmissions shorten the next Cycle by max. 1/20 (5%)
+
         typedef struct
         {
         
-            int     m_iPinLora_SCK;
-            int     m_iPinLora_MISO;
-            int     m_iPinLora_MOSI;
-            int     m_iPinLora_CS;
-            int     m_iPinLora_RST;
-            int     m_iPinLora_DIO0;
-            int     m_iLoraTxPower;
-            int     m_iLoraSpreadingFactor;
-            long    m_lLoraSignalBandwidth;
-            int     m_iLoraCodingRateDenominator;
+            int         m_iPinLora_SCK;
+            int         m_iPinLora_MISO;
+            int         m_iPinLora_MOSI;
+            int         m_iPinLora_CS;
+            int         m_iPinLora_RST;
+            int         m_iPinLora_DIO0;
+            int         m_iLoraTxPower;
+            int         m_iLoraSpreadingFactor;
+            long        m_lLoraSignalBandwidth;
+            int         m_iLoraCodingRateDenominator;
+            uint16_t    m_ui16DutyCycleLimit;                           // [1/10 %], 0 = no limit (EU868: 10 = 1%)
+            uint32_t    m_ui32DutyCycleWindow;                          // [ms] (EU868: 1h)
 
         } tLoraTransmitterSettings;
 
 
+        typedef struct
+        {
+            uint32_t    m_ui32Window;                                   // [ms]
+            uint32_t    m_ui32MaxAirTime;                               // [us] permitted within Window
+            uint32_t    m_ui32UsedAirTime;                              // [us] used within Window
+            uint32_t    m_ui32LastAirTime;                              // [us] Time-on-Air of last transmitted Packet
+            uint32_t    m_ui32TransmitCount;
+            uint32_t    m_ui32DeferredCount;                            // number of Checks deferred due to exhausted Budget
+
+        } tDutyCycleInfo;
+
+
+        // state to be retained in RTC Memory during Deep Sleep
+        typedef struct
+        {
+            uint32_t    m_ui32TransmitInhibitTime;
+            uint32_t    m_ui32TransmitCycleTime;
+            uint32_t    m_ui32TimeSinceLastTransmit;                    // [ms] at the time of <SaveState>
+            uint32_t    m_ui32TimeSinceBucketStart;                     // [ms] at the time of <SaveState>
+            int         m_iDutyCycleBucketIdx;
+            uint32_t    m_aui32DutyCycleBucket[DUTY_CYCLE_BUCKETS];     // [us]
+            uint32_t    m_ui32TransmitCount;
+            uint32_t    m_ui32DeferredCount;
+            uint32_t    m_ui32TimeSinceSlotEpoch;                       // [ms] at the time of <SaveState>
+
+        } tRetainState;
+
+
 
     //-----------------------------------------------------------------------
     //  Private Attributes
@@ -75,6 +113,28 @@ class  LoraTransmitter
         uint32_t  m_ui32TransmitCycleTime;
         uint32_t  m_ui32SysTickLastTransmitPacket;
 
+        int       m_iLoraSpreadingFactor;
+        long      m_lLoraSignalBandwidth;
+        int       m_iLoraCodingRateDenominator;
+
+        uint32_t  m_ui32DutyCycleWindow;
+        uint32_t  m_ui32DutyCycleMaxAirTime;
+        uint32_t  m_ui32DutyCycleBucketTime;
+        uint32_t  m_ui32DutyCycleBucketStartTick;
+        int       m_iDutyCycleBucketIdx;
+        uint32_t  m_aui32DutyCycleBucket[DUTY_CYCLE_BUCKETS];
+        uint32_t  m_ui32LastAirTime;
+        uint32_t  m_ui32TransmitCount;
+        uint32_t  m_ui32DeferredCount;
+
+        bool      m_fSlottedSchedule;
+        uint16_t  m_ui16SlotID;
+        uint16_t  m_ui16SlotCount;
+        uint32_t  m_ui32SlotCycleTime;
+        uint32_t  m_ui32SlotGuardTime;
+        uint32_t  m_ui32SlotEpochTick;                                  // start of a Cycle of the Slot Grid (Uptime 0 + n * SlotCycleTime)
+        uint32_t  m_ui32MeasuredAirTime;                                // [ms] longest measured Transmission
+
 
 
     //-----------------------------------------------------------------------
@@ -87,11 +147,23 @@ class  LoraTransmitter
         ~LoraTransmitter();
 
         int       Setup(const tLoraTransmitterSettings* pLoraTransmitterSettings_p, unsigned long uiRandomSeed_p);
+        int       SetupSlottedSchedule(uint16_t ui16SlotID_p, uint16_t ui16SlotCount_p, uint32_t ui32SlotCycleTime_p, uint32_t ui32SlotGuardTime_p);
         uint32_t  CalcNextTransmitCycleTime(uint32_t ui32LoraPacketInhibitTime_p, uint32_t ui32LoraPacketCycleTime_p);
-        int       GetReasonToTransmitPacket(bool* pfAsyncTransmitEvent_p);
+        int       GetReasonToTransmitPacket(bool* pfAsyncTransmitEvent_p, uint8_t ui8TxPacketLen_p);
         int32_t   GetRemainingTransmitCycleTime();
         int       TransmitPacket(const void* pTxPacket_p, uint8_t ui8TxPacketLen_p, bool fLogDataToConsole_p = false);
         bool      GetTransmitIndicatorState(uint32_t ui32SignalActiveTime_p);
+        void      Sleep();
+        void      SaveState(tRetainState* pRetainState_p);
+        void      RestoreState(const tRetainState* pRetainState_p, uint32_t ui32ElapsedTime_p);
+
+        uint32_t  GetTimeOnAir(uint8_t ui8TxPacketLen_p);
+        uint32_t  GetDutyCycleWaitTime(uint8_t ui8TxPacketLen_p);
+        void      GetDutyCycleInfo(tDutyCycleInfo* pDutyCycleInfo_p);
+        uint32_t  GetSlotOffset(void);
+
+        static uint32_t  CalcTimeOnAir(int iSpreadingFactor_p, long lSignalBandwidth_p, int iCodingRateDenominator_p,
+                                       int iPreambleLength_p, bool fCrcEnabled_p, bool fImplicitHeader_p, uint8_t ui8PayloadLen_p);
 
 
 
@@ -101,7 +173,10 @@ class  LoraTransmitter
 
     private:
 
-        void  DumpBuffer(const void* pabDataBuff_p, unsigned int uiDataBuffLen_p);
+        void      DumpBuffer(const void* pabDataBuff_p, unsigned int uiDataBuffLen_p);
+        void      AdvanceDutyCycleWindow(uint32_t ui32CurrTick_p);
+        uint32_t  GetUsedAirTime(void);
+        uint32_t  CalcNextSlotTime(uint32_t ui32EarliestTick_p);
 
 
 };
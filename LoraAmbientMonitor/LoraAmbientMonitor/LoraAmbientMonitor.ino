@@ -68,6 +68,20 @@
   Revision History:
 
   2023/03/25 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Moving Average Filters with compile-time Window Size
+                          and exact Fixed-Point Sum
+  2026/10/18 -rs:   V1.02 Deadline driven Task Scheduler replaces the fixed
+                          10-step Main Loop
+  2026/10/18 -rs:   V1.03 Low Power Mode (Light/Deep Sleep) with State retained
+                          in RTC Memory, Energy Budget per LoRa Cycle
+  2026/10/18 -rs:   V1.04 Duty Cycle Budget based on LoRa Time-on-Air
+  2026/10/18 -rs:   V1.05 Optional slotted Transmit Schedule derived from DevID
+  2026/10/18 -rs:   V1.06 Optional Delta Data Packet with configurable
+                          Generation Depth
+  2026/10/18 -rs:   V1.07 Optional Compact Data Packet with Record Layout
+                          derived from Sensor Configuration
+  2026/10/18 -rs:   V1.08 Retained State and Energy Model moved to Class
+                          <LowPowerState> (Host buildable)
 
 ****************************************************************************/
 
@@ -79,10 +93,15 @@
 #include <Adafruit_ADS1X15.h>
 #include <U8x8lib.h>
 #include <DHT.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include <sys/time.h>
 #include "SimpleMovingAverage.hpp"
 #include "LoraPacket.h"
 #include "LoraPayloadEncoder.h"
 #include "LoraTransmitter.h"
+#include "TaskScheduler.h"
+#include "LowPowerState.h"
 #include "Trace.h"
 
 
@@ -102,7 +121,7 @@
 //---------------------------------------------------------------------------
 
 const int       APP_VERSION                         = 1;                // 1.xx
-const int       APP_REVISION                        = 0;                // x.00
+const int       APP_REVISION                        = 7;                // x.07
 const char      APP_BUILD_TIMESTAMP[]               = __DATE__ " " __TIME__;
 
 const int       CFG_ENABLE_OLED_DISPLAY             = 1;
@@ -112,6 +131,15 @@ const int       CFG_ENABLE_ADS1115_LIGHT_SENSOR     = 1;
 const int       CFG_ENABLE_ADS1115_CAR_BATT_AIN     = 1;
 const int       CFG_ENABLE_LOG_LORA_PACKET_DATA     = 1;
 const int       CFG_ENABLE_LOG_LORA_PACKET_DUMP     = 1;
+const int       CFG_ENABLE_LOG_SCHED_STATISTICS     = 1;
+const int       CFG_ENABLE_LORA_SLOTTED_SCHEDULE    = 0;                // 0 = random Cycle Time (95..105%), 1 = fixed Slot per DevID
+const int       CFG_LORA_DATA_GEN_DEPTH             = 0;                // 0 = classic Data Packet (Gen0/Gen1/Gen2), 1..16 = Delta Data Packet with Gen0..Gen(n-1)
+const int       CFG_LORA_DATA_COMPACT_LAYOUT        = 0;                // 1 = Compact Data Packet, only values of enabled Sensors (Generations as CFG_LORA_DATA_GEN_DEPTH)
+
+const int       LOW_POWER_MODE_OFF                  = 0;                // CPU is waiting by delay() between the Task Deadlines
+const int       LOW_POWER_MODE_LIGHT_SLEEP          = 1;                // CPU is in Light Sleep between the Task Deadlines
+const int       LOW_POWER_MODE_DEEP_SLEEP           = 2;                // CPU is in Deep Sleep between the Task Deadlines (if possible, otherwise in Light Sleep)
+const int       CFG_LOW_POWER_MODE                  = LOW_POWER_MODE_OFF;
 
 const uint8_t   OLED_LINE_DEV_INFO                  = 0;
 const uint8_t   OLED_LINE_TEMPERATURE               = 1;
@@ -130,6 +158,8 @@ const float     ADC_CAR_BATT_VALID_LEVEL_MIN        = ((float)3.0);
 
 const int       SMA_DHT_SAMPLE_WINDOW_SIZE          = 200;              // Window Size of Simple Moving Average Filter for DHT-Sensor (Temperature/Humidity)
 const int       SMA_CARBATT_SAMPLE_WINDOW_SIZE      = 20;               // Window Size of Simple Moving Average Filter for CarBattLevel (AI1 @ ADS1115)
+const int       SMA_DHT_VALUE_SCALE                 = 10;               // Fixed-Point Resolution of DHT Samples (0.1 °C / 0.1 %)
+const int       SMA_CARBATT_VALUE_SCALE             = 100;              // Fixed-Point Resolution of CarBattLevel Samples (0.01 V)
 
 
 
@@ -182,6 +212,11 @@ const int       LORA_CODING_RATE_DENOMINATOR        = 5;                // LoRa
 
 const uint32_t  LORA_PACKET_INHIBIT_TIME            = (     30 * 1000); // LoRa Packet Inhibit Time [ms]
 
+const uint16_t  LORA_DUTY_CYCLE_LIMIT               = 10;               // LoRa Duty Cycle Limit [1/10 %] (EU868 Sub-Band g1: 1%, 0 = no limit)
+const uint32_t  LORA_DUTY_CYCLE_WINDOW              = (60 * 60 * 1000); // LoRa Duty Cycle Observation Window [ms]
+
+const uint16_t  LORA_SLOT_COUNT                     = 4;                // Number of Transmit Slots per Cycle (DevID 0..3 from DIP3/DIP4)
+
 const uint32_t  LORA_PACKET_FIRST_TIME              = ( 5 * 60 * 1000); // Normal LoRa Mode:   Time between BootupPacket and first DataPacket [ms]
 const uint32_t  LORA_PACKET_CYCLE_TIME              = (30 * 60 * 1000); // Normal LoRa Mode:   Time between DataPackets [ms]
 
@@ -192,6 +227,38 @@ const uint32_t  LORA_TX_LED_SIGNAL_ACTIVE_TIME      = (     10 * 1000); // Activ
 
 
 
+//---------------------------------------------------------------------------
+//  Task Scheduler Configuration
+//---------------------------------------------------------------------------
+
+const uint32_t  TASK_PERIOD_MAIN_INFO               = (1 * 1000);       // Period for Main Information (Cycle/Uptime) in [ms]
+const uint32_t  TASK_PERIOD_SEN_HC_SR501            = 100;              // Poll Period for HC-SR501 Sensor (IR Motion Sensor) in [ms], defines Motion Edge Latency
+const uint32_t  TASK_PERIOD_ADS1115_LIGHT_SENSOR    = (1 * 1000);       // Sample Period for Light Sensor (AI0 @ ADS1115) in [ms]
+const uint32_t  TASK_PERIOD_ADS1115_CAR_BATT_AIN    = (1 * 1000);       // Sample Period for CarBattLevel (AI1 @ ADS1115) in [ms]
+const uint32_t  TASK_PERIOD_LORA_TRANSMIT           = (1 * 1000);       // Check Period for LoRa Transmission in [ms] (asynchronous Events are handled immediately)
+const uint32_t  TASK_PERIOD_OLED_UPDATE             = (1 * 1000);       // Update Period for OLED Display in [ms]
+const uint32_t  TASK_PERIOD_STATUS_LEDS             = 100;              // Update Period for Status LEDs in [ms]
+const uint32_t  TASK_PERIOD_SCHED_STATISTICS        = (10 * 60 * 1000); // Log Period for Scheduler Statistics in [ms]
+const uint32_t  TASK_SCHED_MAX_SLEEP_TIME           = (1 * 1000);       // max. Sleep Time of Scheduler between two Deadlines in [ms]
+
+
+
+//---------------------------------------------------------------------------
+//  Low Power Configuration
+//---------------------------------------------------------------------------
+
+const uint32_t  LOW_POWER_SAMPLE_PERIOD             = (30 * 1000);      // Low Power Mode: min. Period for all Tasks in [ms] (HC-SR501 Sensor additionally wakes up the CPU)
+const uint32_t  LOW_POWER_DEEP_SLEEP_MIN_TIME       = (10 * 1000);      // Low Power Mode: min. Sleep Time to use Deep Sleep instead of Light Sleep in [ms]
+
+const float     POWER_CURRENT_ACTIVE                = 50.0f;            // estimated Supply Current: CPU active, LoRa Radio idle [mA]
+const float     POWER_CURRENT_LORA_TX               = 130.0f;           // estimated Supply Current: CPU active, LoRa Radio transmitting with 20dB [mA]
+const float     POWER_CURRENT_LIGHT_SLEEP           = 1.0f;             // estimated Supply Current: CPU in Light Sleep, LoRa Radio sleeping [mA]
+const float     POWER_CURRENT_DEEP_SLEEP            = 0.2f;             // estimated Supply Current: CPU in Deep Sleep, incl. Sensors and Voltage Regulator [mA]
+const uint32_t  POWER_LIGHT_SLEEP_WAKEUP_TIME       = 2;                // estimated Time from Wakeup out of Light Sleep until the first Task runs [ms]
+const uint32_t  POWER_DEEP_SLEEP_BOOT_TIME          = 300;              // estimated Time from Wakeup out of Deep Sleep until setup() has restored the State [ms]
+
+
+
 //---------------------------------------------------------------------------
 //  Local types
 //---------------------------------------------------------------------------
@@ -250,6 +317,26 @@ typedef struct
 } tSensorData;
 
 
+// Moving Average Filters
+typedef FixedMovingAverage<float, SMA_DHT_SAMPLE_WINDOW_SIZE, SMA_DHT_VALUE_SCALE>          tDhtMovingAverage;
+typedef FixedMovingAverage<float, SMA_CARBATT_SAMPLE_WINDOW_SIZE, SMA_CARBATT_VALUE_SCALE>  tCarBattMovingAverage;
+
+
+// State retained in RTC Memory during Deep Sleep
+typedef struct
+{
+    LowPowerState::tRetainState     m_LowPowerState;                    // SysTick, Energy Budget, LoraPayloadEncoder, LoraTransmitter
+    ulong       m_ulMainLoopCycle;
+    tSensorData m_SensorDataRec;
+    bool        m_fCarBattPlugged;
+    uint16_t    m_ui16MotionActiveTimeBase;
+    uint8_t     m_abAverageTemperature[sizeof(tDhtMovingAverage)];      // Moving Average Filters are plain data objects,
+    uint8_t     m_abAverageHumidity[sizeof(tDhtMovingAverage)];         // so they are retained as byte copy
+    uint8_t     m_abAverageCarBattLevel[sizeof(tCarBattMovingAverage)];
+
+} tRetainState;
+
+
 
 //---------------------------------------------------------------------------
 //  Local variables
@@ -259,20 +346,23 @@ static  DHT                                 DhtSensor_g(PIN_DHT22_SENSOR, TYPE_D
 static  Adafruit_ADS1115                    Ads1115_g;                  // I2C Address = 0x48 is hardcoded in Adafruit ADS1115 Library
 static  U8X8_SSD1306_128X64_NONAME_SW_I2C   Oled_U8x8_g(PIN_OLED_SCL, PIN_OLED_SDA, PIN_OLED_RST);
 
-static  SimpleMovingAverage<float>          AverageTemperature_g(SMA_DHT_SAMPLE_WINDOW_SIZE);
-static  SimpleMovingAverage<float>          AverageHumidity_g(SMA_DHT_SAMPLE_WINDOW_SIZE);
-static  SimpleMovingAverage<float>          AverageCarBattLevel_g(SMA_CARBATT_SAMPLE_WINDOW_SIZE);
+static  tDhtMovingAverage                   AverageTemperature_g;
+static  tDhtMovingAverage                   AverageHumidity_g;
+static  tCarBattMovingAverage               AverageCarBattLevel_g;
 
 static  LoraPayloadEncoder                  LoraPayloadEnc_g;
 static  LoraTransmitter                     LoraTransmitter_g;
+static  TaskScheduler                       TaskScheduler_g;
+static  LowPowerState                       LowPowerState_g;
 
 static  ulong           ulMainLoopCycle_g           = 0;
-static  uint            uiMainLoopProcStep_g        = 0;
-static  uint32_t        ui32LastTickDhtRead_g       = 0;
+static  int             iTaskIdLoraTransmit_g       = -1;
+static  int             iTaskIdHcSr501_g            = -1;
 static  uint32_t        ui32StartTickMotionSegm_g   = 0;
 static  uint16_t        ui16MotionActiveTimeBase_g  = 0;
 static  uint32_t        ui32StartTickPauseSr501_g   = 0;
 static  bool            fPauseActiveSr501_g         = false;
+static  bool            fLogPausedSr501_g           = false;
 static  bool            fCarBattPlugged_g           = false;
 static  bool            fAsyncLoraTransmitEvent_g   = false;
 
@@ -288,6 +378,9 @@ static  tDeviceConfig   DeviceConfig_g              = { 0 };
 static  tSensorData     SensorDataRec_g             = { 0 };
 static  tSensorData     PrevSensorDataRec_g         = { 0 };
 
+static  bool            fResumeFromDeepSleep_g      = false;
+static  RTC_DATA_ATTR   tRetainState    RetainState_g;                  // located in RTC Memory, survives Deep Sleep
+
 
 
 //---------------------------------------------------------------------------
@@ -315,6 +408,7 @@ LoraTransmitter::tLoraTransmitterSettings  LoraTransmitterSettings;
 tLoraDataPacket*  pLoraDataPacket;
 char              szTextBuff[256];
 uint8_t           ui8DevID;
+uint8_t           ui8SensorLayout;
 unsigned long     uiRandomSeed;
 uint32_t          ui32LoraNextTransmitCycleTime;
 bool              fLogDataToConsole;
@@ -341,12 +435,13 @@ int               iRes;
 
     // Initialize Workspace
     ulMainLoopCycle_g          = 0;
-    uiMainLoopProcStep_g       = 0;
-    ui32LastTickDhtRead_g      = 0;
+    iTaskIdLoraTransmit_g      = -1;
+    iTaskIdHcSr501_g           = -1;
     ui32StartTickMotionSegm_g  = 0;
     ui16MotionActiveTimeBase_g = 0;
     ui32StartTickPauseSr501_g  = 0;
     fPauseActiveSr501_g        = false;
+    fLogPausedSr501_g          = false;
     fCarBattPlugged_g          = false;
     fAsyncLoraTransmitEvent_g  = false;
     fGenAsyncLoraEvent_g       = false;
@@ -359,6 +454,15 @@ int               iRes;
     memset(&DeviceConfig_g, 0x00, sizeof(DeviceConfig_g));
     memset(&SensorDataRec_g, 0x00, sizeof(SensorDataRec_g));
     memset(&PrevSensorDataRec_g, 0x00, sizeof(PrevSensorDataRec_g));
+    LowPowerSetup();
+
+
+    // Check for Wakeup from Deep Sleep
+    fResumeFromDeepSleep_g = LowPowerCheckResume();
+    if ( fResumeFromDeepSleep_g )
+    {
+        Serial.println("Wakeup from Deep Sleep");
+    }
 
 
     // Setup Status LEDs
@@ -410,8 +514,11 @@ int               iRes;
 
 
     // Test all LED'a
-    Serial.println("Run LED System Test...");
-    RunLedSystemTest();
+    if ( !fResumeFromDeepSleep_g )
+    {
+        Serial.println("Run LED System Test...");
+        RunLedSystemTest();
+    }
 
 
     // Setup DHT22 Sensor (Temerature/Humidity)
@@ -458,6 +565,42 @@ int               iRes;
     // Setup LoRa Payload Encoder
     Serial.println("Setup LoRa Payload Encoder...");
     LoraPayloadEnc_g.Setup(ui8DevID);
+    iRes = LoraPayloadEnc_g.SetupGenerationDepth(CFG_LORA_DATA_GEN_DEPTH);
+    if (iRes == 0)
+    {
+        if ( CFG_LORA_DATA_COMPACT_LAYOUT )
+        {
+            // the Record Layout follows the Sensor Configuration, which is also reported by the Bootup Packet
+            ui8SensorLayout  = (CFG_ENABLE_DHT_SENSOR           ? LORA_DATA_LAYOUT_DHT_SENSOR   : 0);
+            ui8SensorLayout |= (CFG_ENABLE_SEN_HC_SR501_SENSOR  ? LORA_DATA_LAYOUT_SR501_SENSOR : 0);
+            ui8SensorLayout |= (CFG_ENABLE_ADS1115_LIGHT_SENSOR ? LORA_DATA_LAYOUT_ADC_LIGHT    : 0);
+            ui8SensorLayout |= (CFG_ENABLE_ADS1115_CAR_BATT_AIN ? LORA_DATA_LAYOUT_ADC_CAR_BATT : 0);
+            iRes = LoraPayloadEnc_g.SetupCompactLayout(true, ui8SensorLayout);
+            if (iRes == 0)
+            {
+                snprintf(szTextBuff, sizeof(szTextBuff), "  DataPacket Format:      Compact (Gen0..Gen%u, Layout 0x%02X)",
+                                                        (unsigned int)(((CFG_LORA_DATA_GEN_DEPTH == 0) ? LoraPayloadEncoder::GEN_DEPTH_CLASSIC : CFG_LORA_DATA_GEN_DEPTH) - 1),
+                                                        (unsigned int)ui8SensorLayout);
+            }
+            else
+            {
+                snprintf(szTextBuff, sizeof(szTextBuff), "  LoraPayloadEnc_g.SetupCompactLayout() FAILED! (iRes=%d)", iRes);
+            }
+        }
+        else if (CFG_LORA_DATA_GEN_DEPTH == 0)
+        {
+            snprintf(szTextBuff, sizeof(szTextBuff), "  DataPacket Format:      Classic (Gen0/Gen1/Gen2)");
+        }
+        else
+        {
+            snprintf(szTextBuff, sizeof(szTextBuff), "  DataPacket Format:      Delta (Gen0..Gen%u)", (unsigned int)(CFG_LORA_DATA_GEN_DEPTH - 1));
+        }
+    }
+    else
+    {
+        snprintf(szTextBuff, sizeof(szTextBuff), "  LoraPayloadEnc_g.SetupGenerationDepth() FAILED! (iRes=%d)", iRes);
+    }
+    Serial.println(szTextBuff);
 
 
     // Setup LoRa Transmitter
@@ -472,6 +615,8 @@ int               iRes;
     LoraTransmitterSettings.m_iLoraSpreadingFactor       = LORA_SPREADING_FACTOR;
     LoraTransmitterSettings.m_lLoraSignalBandwidth       = LORA_SIGNAL_BANDWIDTH;
     LoraTransmitterSettings.m_iLoraCodingRateDenominator = LORA_CODING_RATE_DENOMINATOR;
+    LoraTransmitterSettings.m_ui16DutyCycleLimit         = LORA_DUTY_CYCLE_LIMIT;
+    LoraTransmitterSettings.m_ui32DutyCycleWindow        = LORA_DUTY_CYCLE_WINDOW;
     snprintf(szTextBuff, sizeof(szTextBuff), "  TxPower:                %u [dB]\n  SpreadingFactor:        %u\n  SignalBandwidth:        %.1f [kHz]\n  CodingRateDenominator:  %u",
                                             (unsigned int)LoraTransmitterSettings.m_iLoraTxPower,
                                             (unsigned int)LoraTransmitterSettings.m_iLoraSpreadingFactor,
@@ -479,13 +624,36 @@ int               iRes;
                                             (unsigned int)LoraTransmitterSettings.m_iLoraCodingRateDenominator);
     Serial.println(szTextBuff);
     uiRandomSeed = ui8DevID * 1000;
+    if ( fResumeFromDeepSleep_g )
+    {
+        // avoid the same random sequence after each wakeup
+        uiRandomSeed += RetainState_g.m_LowPowerState.m_LoraPayloadEncState.m_ui32SequNum;
+    }
     snprintf(szTextBuff, sizeof(szTextBuff), "  RandomSeed:             %u", uiRandomSeed);
     Serial.println(szTextBuff);
     LoraTransmitter_g.Setup(&LoraTransmitterSettings, uiRandomSeed);
+    snprintf(szTextBuff, sizeof(szTextBuff), "  DutyCycleLimit:         %u.%u [%%] per %s", (unsigned int)(LORA_DUTY_CYCLE_LIMIT / 10), (unsigned int)(LORA_DUTY_CYCLE_LIMIT % 10), FormatDateTime(LORA_DUTY_CYCLE_WINDOW, false, true).c_str());
+    Serial.println(szTextBuff);
+    snprintf(szTextBuff, sizeof(szTextBuff), "  TimeOnAir DataPacket:   %lu [ms]", (unsigned long)(LoraTransmitter_g.GetTimeOnAir(LoraPayloadEnc_g.GetTxDataPayloadMaxSize()) / 1000));
+    Serial.println(szTextBuff);
+    if ( CFG_ENABLE_LORA_SLOTTED_SCHEDULE )
+    {
+        // Slot Grid with the Cycle Time of DataPackets, the Check Period of the
+        // LoRa Transmit Task is the Guard Time between two Slots
+        iRes = LoraTransmitter_g.SetupSlottedSchedule(ui8DevID, LORA_SLOT_COUNT, LoraGetCyclicPacketIntervalTime(), TASK_PERIOD_LORA_TRANSMIT);
+        if (iRes == 0)
+        {
+            snprintf(szTextBuff, sizeof(szTextBuff), "  TransmitSchedule:       Slot %u of %u", (unsigned int)ui8DevID, (unsigned int)LORA_SLOT_COUNT);
+        }
+        else
+        {
+            snprintf(szTextBuff, sizeof(szTextBuff), "  LoraTransmitter_g.SetupSlottedSchedule() FAILED! (iRes=%d)", iRes);
+        }
+        Serial.println(szTextBuff);
+    }
 
 
-    // Encode and transmit LoRa Bootup Packet
-    Serial.println("Encode LoRa Bootup Packet...");
+    // Setup Device Configuration (used for Bootup Packet and LoRa Data Packet Cycle Time)
     DeviceConfig_g.m_iFirmwareVersion    = APP_VERSION;
     DeviceConfig_g.m_iFirmwareRevision   = APP_REVISION;
     DeviceConfig_g.m_ui32DataPackCycleTm = LoraGetCyclicPacketIntervalTime();
@@ -499,315 +667,75 @@ int               iRes;
     DeviceConfig_g.m_fCommissioningMode  = fCommissioningMode_g;
     DeviceConfig_g.m_iLoraTxPower        = LORA_TX_POWER;
     DeviceConfig_g.m_iLoraSpreadFactor   = LORA_SPREADING_FACTOR;
-    fLogDataToConsole = CFG_ENABLE_LOG_LORA_PACKET_DATA;
-    pLoraDataPacket = LoraEncodeBootupPacket(&DeviceConfig_g, fLogDataToConsole);
-    if (pLoraDataPacket == NULL)
-    {
-        Serial.println("  LoraEncodeBootupPacket() FAILED!");
-    }
-    else
-    {
-        Serial.println("Transmit LoRa Bootup Packet...");
-        if ( fSr501PauseOnLoraTx_g )
-        {
-            Serial.println("  Pause SEN_HC_SR501 Sensor during LoRa transmission");
-            HcSr501SensorStartPause();
-        }
-        fLogDataToConsole = CFG_ENABLE_LOG_LORA_PACKET_DUMP;
-        iRes = LoraTransmitter_g.TransmitPacket(pLoraDataPacket, sizeof(tLoraDataPacket), fLogDataToConsole);
-        if (iRes == 0)
-        {
-            SensorDataRec_g.m_ui32LoraPacketCount++;
-            snprintf(szTextBuff, sizeof(szTextBuff), "  LoraPacketCounter: %lu", (unsigned long)SensorDataRec_g.m_ui32LoraPacketCount);
-            Serial.println(szTextBuff);
-        }
-        else
-        {
-            snprintf(szTextBuff, sizeof(szTextBuff), "  LoraTransmitter_g.TransmitPacket() FAILED! (iRes=%d)", iRes);
-            Serial.println(szTextBuff);
-        }
-    }
-
-    // Calculate time interval for transmitting 1st LoRa Data Packet
-    ui32LoraNextTransmitCycleTime = LoraTransmitter_g.CalcNextTransmitCycleTime(LORA_PACKET_INHIBIT_TIME, LoraGetFirstPacketIntervalTime());
-    snprintf(szTextBuff, sizeof(szTextBuff), "TimeSpan until transmitting first cyclic LoRa DataPacket: %s", FormatDateTime(ui32LoraNextTransmitCycleTime, false, true).c_str());
-    Serial.println(szTextBuff);
-
-
-    return;
-
-}
-
-
-
-//---------------------------------------------------------------------------
-//  Application Main Loop
-//---------------------------------------------------------------------------
-
-void loop()
-{
-
-tLoraDataPacket*  pLoraDataPacket;
-char      szTextBuff[128];
-uint32_t  ui32CurrTick;
-uint      uiProcStep;
-uint32_t  ui32Uptime;
-String    strUptime;
-float     flTemperature;
-float     flAverageTemperature;
-float     flHumidity;
-float     flAverageHumidity;
-bool      fMotionActive;
-uint16_t  ui16MotionActiveTime;
-uint16_t  ui16AdcVal;
-uint8_t   ui8LightLevel;
-float     flCarBattLevel;
-float     flAverageCarBattLevel;
-uint32_t  ui32LoraNextTransmitCycleTime;
-bool      fLogDataToConsole;
-int       iRes;
 
 
-    uiProcStep = uiMainLoopProcStep_g++ % 10;
-    switch (uiProcStep)
+    if ( !fResumeFromDeepSleep_g )
     {
-        // provide main information
-        case 0:
+        // Encode and transmit LoRa Bootup Packet
+        Serial.println("Encode LoRa Bootup Packet...");
+        fLogDataToConsole = CFG_ENABLE_LOG_LORA_PACKET_DATA;
+        pLoraDataPacket = LoraEncodeBootupPacket(&DeviceConfig_g, fLogDataToConsole);
+        if (pLoraDataPacket == NULL)
         {
-            ulMainLoopCycle_g++;
-            Serial.println();
-            strUptime = GetSysUptime(&ui32Uptime);
-            snprintf(szTextBuff, sizeof(szTextBuff), "Main Loop Cycle:       %lu (Uptime: %s)", ulMainLoopCycle_g, strUptime.c_str());
-            Serial.println(szTextBuff);
-            SensorDataRec_g.m_ulMainLoopCycle = ulMainLoopCycle_g;
-            SensorDataRec_g.m_ui32Uptime = ui32Uptime;
-            break;
+            Serial.println("  LoraEncodeBootupPacket() FAILED!");
         }
-
-        // process DHT Sensor (Temperature/Humidity)
-        case 1:
+        else
         {
-            if ( CFG_ENABLE_DHT_SENSOR )
+            Serial.println("Transmit LoRa Bootup Packet...");
+            if ( fSr501PauseOnLoraTx_g )
             {
-                Serial.print("DHT22 Sensor:          ");
-                ui32CurrTick = millis();
-                if ((ui32CurrTick - ui32LastTickDhtRead_g) < DHT_SENSOR_SAMPLE_PERIOD)
-                {
-                    Serial.println("[skipped]");
-                    break;
-                }
-                iRes = DhtSensorGetData(&flTemperature, &flHumidity);
-                if (iRes == 0)
-                {
-                    flAverageTemperature = AverageTemperature_g.CalcMovingAverage(flTemperature);
-                    flAverageHumidity = AverageHumidity_g.CalcMovingAverage(flHumidity);
-                    snprintf(szTextBuff, sizeof(szTextBuff), "Temperature = %.1f °C (Ø %.1f °C), Humidity = %.1f %% (Ø %.1f %%)", flTemperature, flAverageTemperature, flHumidity, flAverageHumidity);
-                }
-                else
-                {
-                    snprintf(szTextBuff, sizeof(szTextBuff), "FAILED! (iRes=%d)", iRes);
-                }
-                Serial.println(szTextBuff);
-                SensorDataRec_g.m_flTemperature = flAverageTemperature;
-                SensorDataRec_g.m_flHumidity = flAverageHumidity;
-                ui32LastTickDhtRead_g = ui32CurrTick;
+                Serial.println("  Pause SEN_HC_SR501 Sensor during LoRa transmission");
+                HcSr501SensorStartPause();
             }
-            break;
-        }
-
-        // process SEN-HC-SR501 Sensor (IR Motion Sensor)
-        case 2:
-        {
-            if ( CFG_ENABLE_SEN_HC_SR501_SENSOR )
+            fLogDataToConsole = CFG_ENABLE_LOG_LORA_PACKET_DUMP;
+            iRes = LoraTransmitter_g.TransmitPacket(pLoraDataPacket, sizeof(tLoraDataPacket), fLogDataToConsole);
+            if (iRes == 0)
             {
-                Serial.print("SEN_HC_SR501 Sensor:   ");
-                if ( IsPausedHcSr501Sensor() )
-                {
-                    Serial.println("PAUSED during LoRa transmission");
-                    break;
-                }
-                iRes = HcSr501SensorGetData(&fMotionActive, &ui16MotionActiveTime);
-                if (iRes == 0)
-                {
-                    if ( fMotionActive )
-                    {
-                        snprintf(szTextBuff, sizeof(szTextBuff), "Active (for %u sec)", (uint)ui16MotionActiveTime);
-                    }
-                    else
-                    {
-                        snprintf(szTextBuff, sizeof(szTextBuff), "Idle");
-                    }
-                }
-                else
-                {
-                    snprintf(szTextBuff, sizeof(szTextBuff), "FAILED! (iRes=%d)", iRes);
-                }
+                SensorDataRec_g.m_ui32LoraPacketCount++;
+                snprintf(szTextBuff, sizeof(szTextBuff), "  LoraPacketCounter: %lu", (unsigned long)SensorDataRec_g.m_ui32LoraPacketCount);
                 Serial.println(szTextBuff);
-                if ( !(SensorDataRec_g.m_fMotionActive) && fMotionActive )
-                {
-                    // rising edge on <fMotionActive> detected
-                    SensorDataRec_g.m_ui16MotionActiveCount++;
-                    if ( fGenAsyncLoraEvent_g )
-                    {
-                        // generate asynchronous LoRa transmission Event due to rising edge on <fMotionActive>
-                        fAsyncLoraTransmitEvent_g = true;
-                    }
-                }
-                SensorDataRec_g.m_fMotionActive = fMotionActive;
-                SensorDataRec_g.m_ui16MotionActiveTime = ui16MotionActiveTime;
-                fLedMotionActive_g = fMotionActive;
             }
-            break;
-        }
-
-        // process Light Sensor (AI0 @ ADS1115)
-        case 3:
-        {
-            if ( CFG_ENABLE_ADS1115_LIGHT_SENSOR )
+            else
             {
-                Serial.print("ADS1115/Light Sensor:  ");
-                iRes = GetAds1115LightSensorData(&ui16AdcVal, &ui8LightLevel);
-                if (iRes == 0)
-                {
-                    snprintf(szTextBuff, sizeof(szTextBuff), "LightLevel = %u %% (ADC=%05u)", (uint)ui8LightLevel, ui16AdcVal);
-                }
-                else
-                {
-                    snprintf(szTextBuff, sizeof(szTextBuff), "FAILED! (iRes=%d)", iRes);
-                }
+                snprintf(szTextBuff, sizeof(szTextBuff), "  LoraTransmitter_g.TransmitPacket() FAILED! (iRes=%d)", iRes);
                 Serial.println(szTextBuff);
-                SensorDataRec_g.m_ui16AdcValLightLevel = ui16AdcVal;
-                SensorDataRec_g.m_ui8LightLevel = ui8LightLevel;
             }
-            break;
         }
 
-        // process CarBatt AnalogIn (AI1 @ ADS1115)
-        case 4:
-        {
-            if ( CFG_ENABLE_ADS1115_CAR_BATT_AIN )
-            {
-                Serial.print("ADS1115/CarBatt AIN:   ");
-                flAverageCarBattLevel = 0.0;
-                iRes = GetAds1115CarBattAinData(&ui16AdcVal, &flCarBattLevel);
-                if (iRes == 0)      // iRes == 0 -> Vadc >> 0V -> CarBatt connected
-                {
-                    if ( !fCarBattPlugged_g )
-                    {
-                        // rising edge on <flCarBattLevel> detected
-                        if ( fGenAsyncLoraEvent_g )
-                        {
-                            // generate asynchronous LoRa transmission Event due to rising edge on <flCarBattLevel>
-                            fAsyncLoraTransmitEvent_g = true;
-                        }
-                    }
-                    fCarBattPlugged_g = true;
-                    flAverageCarBattLevel = AverageCarBattLevel_g.CalcMovingAverage(flCarBattLevel);
-                    snprintf(szTextBuff, sizeof(szTextBuff), "CarBattLevel = %.1f V (Ø %.1f V)", flCarBattLevel, flAverageCarBattLevel);
-                }
-                else                // iRes == -1 -> Vadc ~ 0V (noise) -> CarBatt disconnected
-                {
-                    if ( fCarBattPlugged_g )
-                    {
-                        // falling edge on <flCarBattLevel> detected
-                        if ( fGenAsyncLoraEvent_g )
-                        {
-                            // generate asynchronous LoRa transmission Event due to falling edge on <flCarBattLevel>
-                            fAsyncLoraTransmitEvent_g = true;
-                        }
-                        AverageCarBattLevel_g.Clean();      // clean history of Simple Moving Average Filter
-                    }
-                    fCarBattPlugged_g = false;
-                    snprintf(szTextBuff, sizeof(szTextBuff), "NOT_CONNECTED (iRes=%d)", iRes);
-                }
-                Serial.println(szTextBuff);
-                SensorDataRec_g.m_ui16AdcValCarBattLevel = ui16AdcVal;
-                SensorDataRec_g.m_flCarBattLevel = flAverageCarBattLevel;
-                fLedCarBattPlugged_g = fCarBattPlugged_g ? HIGH : LOW;
-            }
-            break;
-        }
+        // Calculate time interval for transmitting 1st LoRa Data Packet
+        ui32LoraNextTransmitCycleTime = LoraTransmitter_g.CalcNextTransmitCycleTime(LORA_PACKET_INHIBIT_TIME, LoraGetFirstPacketIntervalTime());
+        snprintf(szTextBuff, sizeof(szTextBuff), "TimeSpan until transmitting first cyclic LoRa DataPacket: %s", FormatDateTime(ui32LoraNextTransmitCycleTime, false, true).c_str());
+        Serial.println(szTextBuff);
+    }
+    else
+    {
+        // Restore State retained in RTC Memory, no Bootup Packet is sent after a
+        // Wakeup, so the receiver does not recognize it as a reboot of the device
+        Serial.println("Restore State from RTC Memory...");
+        LowPowerRestoreState();
+    }
 
-        case 5:
-        case 6:
-        case 7:
-        {
-            break;
-        }
 
-        // encode and transmit LoRa data packet
-        case 8:
-        {
-            iRes = LoraTransmitter_g.GetReasonToTransmitPacket(&fAsyncLoraTransmitEvent_g);
-            snprintf(szTextBuff, sizeof(szTextBuff), "Check Reason to Transmit Packet: -> %d", iRes);
-            Serial.println(szTextBuff);
-            if (iRes > 0)
-            {
-                Serial.print("LoraEncodeDataPacket... ");
-                fLogDataToConsole = CFG_ENABLE_LOG_LORA_PACKET_DATA;
-                pLoraDataPacket = LoraEncodeDataPacket(&SensorDataRec_g, fLogDataToConsole);
-                if (pLoraDataPacket == NULL)
-                {
-                    Serial.println("LoraEncodeDataPacket() FAILED!");
-                    break;
-                }
-                Serial.println("Transmit LoRa Data Packet...");
-                if ( fSr501PauseOnLoraTx_g )
-                {
-                    Serial.println("  Pause SEN_HC_SR501 Sensor during LoRa transmission");
-                    HcSr501SensorStartPause();
-                }
-                fLogDataToConsole = CFG_ENABLE_LOG_LORA_PACKET_DUMP;
-                iRes = LoraTransmitter_g.TransmitPacket(pLoraDataPacket, sizeof(tLoraDataPacket), fLogDataToConsole);
-                if (iRes == 0)
-                {
-                    SensorDataRec_g.m_ui32LoraPacketCount++;
-                    snprintf(szTextBuff, sizeof(szTextBuff), "  LoraPacketCounter: %lu", (unsigned long)SensorDataRec_g.m_ui32LoraPacketCount);
-                    Serial.println(szTextBuff);
-                }
-                else
-                {
-                    snprintf(szTextBuff, sizeof(szTextBuff), "  LoraTransmitter_g.TransmitPacket() FAILED! (iRes=%d)", iRes);
-                    Serial.println(szTextBuff);
-                }
-                HcSr501SensorRestMotionActiveTime();
+    // Setup Task Scheduler
+    Serial.println("Setup Task Scheduler...");
+    SchedulerSetupTasks();
 
-                // Calculate time interval for transmitting next LoRa Data Packet
-                ui32LoraNextTransmitCycleTime = LoraTransmitter_g.CalcNextTransmitCycleTime(LORA_PACKET_INHIBIT_TIME, DeviceConfig_g.m_ui32DataPackCycleTm);
-                snprintf(szTextBuff, sizeof(szTextBuff), "TimeSpan until transmitting next cyclic LoRa DataPacket: %s", FormatDateTime(ui32LoraNextTransmitCycleTime, false, true).c_str());
-                Serial.println(szTextBuff);
-                SensorDataRec_g.m_i32LoraRemainingCycleTime = LoraTransmitter_g.GetRemainingTransmitCycleTime();
-            }
-            else
-            {
-                SensorDataRec_g.m_i32LoraRemainingCycleTime = LoraTransmitter_g.GetRemainingTransmitCycleTime();
-                snprintf(szTextBuff, sizeof(szTextBuff), "Remaining TimeSpan until transmitting next cyclic LoRa DataPacket: %s", FormatDateTime(SensorDataRec_g.m_i32LoraRemainingCycleTime, false, true).c_str());
-                Serial.println(szTextBuff);
-            }
-            fLedLoRaTransmit_g = LoraTransmitter_g.GetTransmitIndicatorState(LORA_TX_LED_SIGNAL_ACTIVE_TIME);
-            break;
-        }
 
-        // update process information on OLED
-        case 9:
-        {
-            OledUpdateProcessData(&SensorDataRec_g, &PrevSensorDataRec_g);
-            break;
-        }
+    return;
 
-        default:
-        {
-            break;
-        }
-    }
+}
 
 
-    // set Status LEDs
-    SetLedLoRaTransmit(GetStateLedLoRaTransmit(fLedLoRaTransmit_g, fCommissioningMode_g, uiMainLoopProcStep_g));
-    SetLedMotionActive(fLedMotionActive_g);
-    SetLedCarBattPlugged(fLedCarBattPlugged_g);
 
-    delay(100);
+//---------------------------------------------------------------------------
+//  Application Main Loop
+//---------------------------------------------------------------------------
+
+void loop()
+{
+
+    // run all tasks whose deadline has been reached, then sleep until the next deadline
+    TaskScheduler_g.Schedule();
 
     return;
 
@@ -824,64 +752,857 @@ int       iRes;
 //=========================================================================//
 
 //---------------------------------------------------------------------------
-//  LoRa: Encode Bootup Packet
+//  Scheduler: Setup Tasks
 //---------------------------------------------------------------------------
 
-tLoraDataPacket*  LoraEncodeBootupPacket (const tDeviceConfig* pDeviceConfig_p, bool fLogDataToConsole_p)
+void  SchedulerSetupTasks (void)
 {
 
-LoraPayloadEncoder::tDeviceConfig  DeviceConfig;
-tLoraDataPacket*  pLoraDataPacket;                  // <tLoraDataPacket> is also used for Bootup Packets
-const char*       pszLogBuffer;
-int               iRes;
+char      szTextBuff[128];
+uint32_t  ui32MaxSleepTime;
+uint32_t  ui32Stagger;
 
 
-    if (pDeviceConfig_p == NULL)
+    ui32MaxSleepTime = SchedulerGetTaskPeriod(TASK_SCHED_MAX_SLEEP_TIME);
+    TaskScheduler_g.Setup(SchedulerGetTick, SchedulerSleep, ui32MaxSleepTime);
+
+    // Stagger the first deadlines to spread the load over the first second.
+    // After a wakeup from Deep Sleep a deadline has been reached, so all
+    // tasks run immediately.
+    ui32Stagger = fResumeFromDeepSleep_g ? 0 : 100;
+    TaskScheduler_g.AddTask("MainInfo", TaskMainInfo, SchedulerGetTaskPeriod(TASK_PERIOD_MAIN_INFO), 0);
+    if ( CFG_ENABLE_DHT_SENSOR )
     {
-        return (NULL);
+        TaskScheduler_g.AddTask("DHT22", TaskDhtSensor, SchedulerGetTaskPeriod(DHT_SENSOR_SAMPLE_PERIOD), fResumeFromDeepSleep_g ? 0 : DHT_SENSOR_SAMPLE_PERIOD);
     }
-
-    DeviceConfig.m_ui8FirmwareVersion  = (uint8_t)(pDeviceConfig_p->m_iFirmwareVersion);
-    DeviceConfig.m_ui8FirmwareRevision = (uint8_t)(pDeviceConfig_p->m_iFirmwareRevision);
-    DeviceConfig.m_ui16DataPackCycleTm = pDeviceConfig_p->m_ui32DataPackCycleTm / 1000;     // [ms] -> [sec]
-    DeviceConfig.m_fCfgOledDisplay     = (bool)(pDeviceConfig_p->m_fCfgOledDisplay);
-    DeviceConfig.m_fCfgDhtSensor       = (bool)(pDeviceConfig_p->m_fCfgDhtSensor);
-    DeviceConfig.m_fCfgSr501Sensor     = (bool)(pDeviceConfig_p->m_fCfgSr501Sensor);
-    DeviceConfig.m_fCfgAdcLightSensor  = (bool)(pDeviceConfig_p->m_fCfgAdcLightSensor);
-    DeviceConfig.m_fCfgAdcCarBatAin    = (bool)(pDeviceConfig_p->m_fCfgAdcCarBatAin);
-    DeviceConfig.m_fCfgAsyncLoraEvent  = pDeviceConfig_p->m_fCfgAsyncLoraEvent;
-    DeviceConfig.m_fSr501PauseOnLoraTx = pDeviceConfig_p->m_fSr501PauseOnLoraTx;
-    DeviceConfig.m_fCommissioningMode  = pDeviceConfig_p->m_fCommissioningMode;
-    DeviceConfig.m_ui8LoraTxPower      = (uint8_t)(pDeviceConfig_p->m_iLoraTxPower);
-    DeviceConfig.m_ui8LoraSpreadFactor = (uint8_t)(pDeviceConfig_p->m_iLoraSpreadFactor);
-    iRes = LoraPayloadEnc_g.EncodeTxBootupPacket(&DeviceConfig);
-    if (iRes != 0)
+    if ( CFG_ENABLE_SEN_HC_SR501_SENSOR )
     {
-        return (NULL);
+        iTaskIdHcSr501_g = TaskScheduler_g.AddTask("HC-SR501", TaskHcSr501Sensor, SchedulerGetTaskPeriod(TASK_PERIOD_SEN_HC_SR501), 2 * ui32Stagger);
     }
-    pLoraDataPacket = LoraPayloadEnc_g.GetTxBootupPacket();
-
-    if ( fLogDataToConsole_p )
+    if ( CFG_ENABLE_ADS1115_LIGHT_SENSOR )
     {
-        pszLogBuffer = LoraPayloadEnc_g.LogDeviceConfig(&DeviceConfig);
-        Serial.println(pszLogBuffer);
+        TaskScheduler_g.AddTask("Light", TaskAds1115LightSensor, SchedulerGetTaskPeriod(TASK_PERIOD_ADS1115_LIGHT_SENSOR), 3 * ui32Stagger);
+    }
+    if ( CFG_ENABLE_ADS1115_CAR_BATT_AIN )
+    {
+        TaskScheduler_g.AddTask("CarBatt", TaskAds1115CarBattAin, SchedulerGetTaskPeriod(TASK_PERIOD_ADS1115_CAR_BATT_AIN), 4 * ui32Stagger);
+    }
+    iTaskIdLoraTransmit_g = TaskScheduler_g.AddTask("LoraTx", TaskLoraTransmit, SchedulerGetTaskPeriod(TASK_PERIOD_LORA_TRANSMIT), 8 * ui32Stagger);
+    if ( CFG_ENABLE_OLED_DISPLAY )
+    {
+        TaskScheduler_g.AddTask("OLED", TaskOledUpdate, SchedulerGetTaskPeriod(TASK_PERIOD_OLED_UPDATE), 9 * ui32Stagger);
+    }
+    TaskScheduler_g.AddTask("StatusLEDs", TaskStatusLeds, SchedulerGetTaskPeriod(TASK_PERIOD_STATUS_LEDS), 0);
+    if ( CFG_ENABLE_LOG_SCHED_STATISTICS )
+    {
+        TaskScheduler_g.AddTask("SchedStat", TaskLogSchedStatistics, TASK_PERIOD_SCHED_STATISTICS, TASK_PERIOD_SCHED_STATISTICS);
     }
 
-    return (pLoraDataPacket);
+    snprintf(szTextBuff, sizeof(szTextBuff), "  Max Sleep Time:         %u [ms]", (unsigned int)ui32MaxSleepTime);
+    Serial.println(szTextBuff);
+    snprintf(szTextBuff, sizeof(szTextBuff), "  Low Power Mode:         %d", CFG_LOW_POWER_MODE);
+    Serial.println(szTextBuff);
+
+    return;
 
 }
 
 
 
 //---------------------------------------------------------------------------
-//  LoRa: Encode Data Packet
+//  Scheduler: Get Task Period (extended in Low Power Mode)
 //---------------------------------------------------------------------------
 
-tLoraDataPacket*  LoraEncodeDataPacket (const tSensorData* pSensorDataRec_p, bool fLogDataToConsole_p)
+uint32_t  SchedulerGetTaskPeriod (uint32_t ui32Period_p)
+{
+
+    if (CFG_LOW_POWER_MODE != LOW_POWER_MODE_OFF)
+    {
+        if (ui32Period_p < LOW_POWER_SAMPLE_PERIOD)
+        {
+            return (LOW_POWER_SAMPLE_PERIOD);
+        }
+    }
+
+    return (ui32Period_p);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Scheduler: Time Base and Sleep Function
+//---------------------------------------------------------------------------
+
+uint32_t  SchedulerGetTick (void)
+{
+
+    return ((uint32_t)millis());
+
+}
+
+//---------------------------------------------------------------------------
+
+void  SchedulerSleep (uint32_t ui32SleepTime_p)
+{
+
+    if (CFG_LOW_POWER_MODE == LOW_POWER_MODE_DEEP_SLEEP)
+    {
+        if ( LowPowerIsDeepSleepPossible(ui32SleepTime_p) )
+        {
+            LowPowerEnterDeepSleep(ui32SleepTime_p);        // does not return, CPU restarts with setup()
+        }
+        LowPowerEnterLightSleep(ui32SleepTime_p);
+    }
+    else if (CFG_LOW_POWER_MODE == LOW_POWER_MODE_LIGHT_SLEEP)
+    {
+        LowPowerEnterLightSleep(ui32SleepTime_p);
+    }
+    else
+    {
+        // delay() blocks the calling FreeRTOS task, so the CPU runs the Idle Task
+        delay(ui32SleepTime_p);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Task: provide main information
+//---------------------------------------------------------------------------
+
+void  TaskMainInfo (void)
+{
+
+char      szTextBuff[128];
+uint32_t  ui32Uptime;
+String    strUptime;
+
+
+    ulMainLoopCycle_g++;
+    Serial.println();
+    strUptime = GetSysUptime(&ui32Uptime);
+    snprintf(szTextBuff, sizeof(szTextBuff), "Main Loop Cycle:       %lu (Uptime: %s)", ulMainLoopCycle_g, strUptime.c_str());
+    Serial.println(szTextBuff);
+    SensorDataRec_g.m_ulMainLoopCycle = ulMainLoopCycle_g;
+    SensorDataRec_g.m_ui32Uptime = ui32Uptime;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Task: process DHT Sensor (Temperature/Humidity)
+//---------------------------------------------------------------------------
+
+void  TaskDhtSensor (void)
+{
+
+char   szTextBuff[128];
+float  flTemperature;
+float  flAverageTemperature;
+float  flHumidity;
+float  flAverageHumidity;
+int    iRes;
+
+
+    Serial.print("DHT22 Sensor:          ");
+    flAverageTemperature = AverageTemperature_g.GetAverageValue();
+    flAverageHumidity = AverageHumidity_g.GetAverageValue();
+    iRes = DhtSensorGetData(&flTemperature, &flHumidity);
+    if (iRes == 0)
+    {
+        flAverageTemperature = AverageTemperature_g.CalcMovingAverage(flTemperature);
+        flAverageHumidity = AverageHumidity_g.CalcMovingAverage(flHumidity);
+        snprintf(szTextBuff, sizeof(szTextBuff), "Temperature = %.1f °C (Ø %.1f °C), Humidity = %.1f %% (Ø %.1f %%)", flTemperature, flAverageTemperature, flHumidity, flAverageHumidity);
+    }
+    else
+    {
+        snprintf(szTextBuff, sizeof(szTextBuff), "FAILED! (iRes=%d)", iRes);
+    }
+    Serial.println(szTextBuff);
+    SensorDataRec_g.m_flTemperature = flAverageTemperature;
+    SensorDataRec_g.m_flHumidity = flAverageHumidity;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Task: process SEN-HC-SR501 Sensor (IR Motion Sensor)
+//---------------------------------------------------------------------------
+
+void  TaskHcSr501Sensor (void)
+{
+
+char      szTextBuff[128];
+bool      fMotionActive;
+uint16_t  ui16MotionActiveTime;
+int       iRes;
+
+
+    // The sensor is polled at a short period to keep the latency of motion
+    // edges low, so only state changes are logged to the console
+    if ( IsPausedHcSr501Sensor() )
+    {
+        if ( !fLogPausedSr501_g )
+        {
+            Serial.println("SEN_HC_SR501 Sensor:   PAUSED during LoRa transmission");
+            fLogPausedSr501_g = true;
+        }
+        return;
+    }
+    fLogPausedSr501_g = false;
+
+    iRes = HcSr501SensorGetData(&fMotionActive, &ui16MotionActiveTime);
+    if (iRes != 0)
+    {
+        snprintf(szTextBuff, sizeof(szTextBuff), "SEN_HC_SR501 Sensor:   FAILED! (iRes=%d)", iRes);
+        Serial.println(szTextBuff);
+        return;
+    }
+
+    if ( !(SensorDataRec_g.m_fMotionActive) && fMotionActive )
+    {
+        // rising edge on <fMotionActive> detected
+        Serial.println("SEN_HC_SR501 Sensor:   Active");
+        SensorDataRec_g.m_ui16MotionActiveCount++;
+        if ( fGenAsyncLoraEvent_g )
+        {
+            // generate asynchronous LoRa transmission Event due to rising edge on <fMotionActive>
+            LoraSignalAsyncTransmitEvent();
+        }
+    }
+    else if ( SensorDataRec_g.m_fMotionActive && !fMotionActive )
+    {
+        // falling edge on <fMotionActive> detected
+        snprintf(szTextBuff, sizeof(szTextBuff), "SEN_HC_SR501 Sensor:   Idle (Active for %u sec)", (uint)ui16MotionActiveTime);
+        Serial.println(szTextBuff);
+    }
+    SensorDataRec_g.m_fMotionActive = fMotionActive;
+    SensorDataRec_g.m_ui16MotionActiveTime = ui16MotionActiveTime;
+    fLedMotionActive_g = fMotionActive;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Task: process Light Sensor (AI0 @ ADS1115)
+//---------------------------------------------------------------------------
+
+void  TaskAds1115LightSensor (void)
+{
+
+char      szTextBuff[128];
+uint16_t  ui16AdcVal;
+uint8_t   ui8LightLevel;
+int       iRes;
+
+
+    Serial.print("ADS1115/Light Sensor:  ");
+    iRes = GetAds1115LightSensorData(&ui16AdcVal, &ui8LightLevel);
+    if (iRes == 0)
+    {
+        snprintf(szTextBuff, sizeof(szTextBuff), "LightLevel = %u %% (ADC=%05u)", (uint)ui8LightLevel, ui16AdcVal);
+    }
+    else
+    {
+        snprintf(szTextBuff, sizeof(szTextBuff), "FAILED! (iRes=%d)", iRes);
+    }
+    Serial.println(szTextBuff);
+    SensorDataRec_g.m_ui16AdcValLightLevel = ui16AdcVal;
+    SensorDataRec_g.m_ui8LightLevel = ui8LightLevel;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Task: process CarBatt AnalogIn (AI1 @ ADS1115)
+//---------------------------------------------------------------------------
+
+void  TaskAds1115CarBattAin (void)
+{
+
+char      szTextBuff[128];
+uint16_t  ui16AdcVal;
+float     flCarBattLevel;
+float     flAverageCarBattLevel;
+int       iRes;
+
+
+    Serial.print("ADS1115/CarBatt AIN:   ");
+    flAverageCarBattLevel = 0.0;
+    iRes = GetAds1115CarBattAinData(&ui16AdcVal, &flCarBattLevel);
+    if (iRes == 0)      // iRes == 0 -> Vadc >> 0V -> CarBatt connected
+    {
+        if ( !fCarBattPlugged_g )
+        {
+            // rising edge on <flCarBattLevel> detected
+            if ( fGenAsyncLoraEvent_g )
+            {
+                // generate asynchronous LoRa transmission Event due to rising edge on <flCarBattLevel>
+                LoraSignalAsyncTransmitEvent();
+            }
+        }
+        fCarBattPlugged_g = true;
+        flAverageCarBattLevel = AverageCarBattLevel_g.CalcMovingAverage(flCarBattLevel);
+        snprintf(szTextBuff, sizeof(szTextBuff), "CarBattLevel = %.1f V (Ø %.1f V)", flCarBattLevel, flAverageCarBattLevel);
+    }
+    else                // iRes == -1 -> Vadc ~ 0V (noise) -> CarBatt disconnected
+    {
+        if ( fCarBattPlugged_g )
+        {
+            // falling edge on <flCarBattLevel> detected
+            if ( fGenAsyncLoraEvent_g )
+            {
+                // generate asynchronous LoRa transmission Event due to falling edge on <flCarBattLevel>
+                LoraSignalAsyncTransmitEvent();
+            }
+            AverageCarBattLevel_g.Clean();      // clean history of Simple Moving Average Filter
+        }
+        fCarBattPlugged_g = false;
+        snprintf(szTextBuff, sizeof(szTextBuff), "NOT_CONNECTED (iRes=%d)", iRes);
+    }
+    Serial.println(szTextBuff);
+    SensorDataRec_g.m_ui16AdcValCarBattLevel = ui16AdcVal;
+    SensorDataRec_g.m_flCarBattLevel = flAverageCarBattLevel;
+    fLedCarBattPlugged_g = fCarBattPlugged_g ? HIGH : LOW;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Task: encode and transmit LoRa data packet
+//---------------------------------------------------------------------------
+
+void  TaskLoraTransmit (void)
+{
+
+const void*   pLoraDataPayload;
+unsigned int  uiLoraDataPayloadSize;
+char      szTextBuff[128];
+uint32_t  ui32LoraNextTransmitCycleTime;
+uint32_t  ui32TxStartTick;
+LoraTransmitter::tDutyCycleInfo  DutyCycleInfo;
+bool      fLogDataToConsole;
+int       iRes;
+
+
+    iRes = LoraTransmitter_g.GetReasonToTransmitPacket(&fAsyncLoraTransmitEvent_g, LoraPayloadEnc_g.GetTxDataPayloadMaxSize());
+    snprintf(szTextBuff, sizeof(szTextBuff), "Check Reason to Transmit Packet: -> %d", iRes);
+    Serial.println(szTextBuff);
+    if (iRes == -2)
+    {
+        snprintf(szTextBuff, sizeof(szTextBuff), "  Duty Cycle Budget exhausted, transmission deferred for %s", FormatDateTime(LoraTransmitter_g.GetDutyCycleWaitTime(LoraPayloadEnc_g.GetTxDataPayloadMaxSize()), false, true).c_str());
+        Serial.println(szTextBuff);
+    }
+    if (iRes > 0)
+    {
+        Serial.print("LoraEncodeDataPacket... ");
+        fLogDataToConsole = CFG_ENABLE_LOG_LORA_PACKET_DATA;
+        pLoraDataPayload = LoraEncodeDataPacket(&SensorDataRec_g, fLogDataToConsole, &uiLoraDataPayloadSize);
+        if (pLoraDataPayload == NULL)
+        {
+            Serial.println("LoraEncodeDataPacket() FAILED!");
+            return;
+        }
+        Serial.println("Transmit LoRa Data Packet...");
+        if ( fSr501PauseOnLoraTx_g )
+        {
+            Serial.println("  Pause SEN_HC_SR501 Sensor during LoRa transmission");
+            HcSr501SensorStartPause();
+        }
+        if ( fResumeFromDeepSleep_g )
+        {
+            // millis() restarts with the wakeup from Deep Sleep
+            snprintf(szTextBuff, sizeof(szTextBuff), "  Wakeup-to-Transmit Latency: %lu [ms] (estimated: %lu [ms])", (unsigned long)millis(),
+                     (unsigned long)LowPowerState_g.EstimateWakeupLatency(LowPowerState::SLEEP_MODE_DEEP, 0, 0));
+            Serial.println(szTextBuff);
+        }
+        fLogDataToConsole = CFG_ENABLE_LOG_LORA_PACKET_DUMP;
+        ui32TxStartTick = millis();
+        iRes = LoraTransmitter_g.TransmitPacket(pLoraDataPayload, uiLoraDataPayloadSize, fLogDataToConsole);
+        LowPowerState_g.AddLoraTxTime(millis() - ui32TxStartTick);
+        if (iRes == 0)
+        {
+            SensorDataRec_g.m_ui32LoraPacketCount++;
+            snprintf(szTextBuff, sizeof(szTextBuff), "  LoraPacketCounter: %lu", (unsigned long)SensorDataRec_g.m_ui32LoraPacketCount);
+            Serial.println(szTextBuff);
+            LoraTransmitter_g.GetDutyCycleInfo(&DutyCycleInfo);
+            snprintf(szTextBuff, sizeof(szTextBuff), "  Duty Cycle Budget: %lu of %lu [ms] used (TimeOnAir: %lu [ms], Deferred: %lu)",
+                     (unsigned long)(DutyCycleInfo.m_ui32UsedAirTime / 1000), (unsigned long)(DutyCycleInfo.m_ui32MaxAirTime / 1000),
+                     (unsigned long)(DutyCycleInfo.m_ui32LastAirTime / 1000), (unsigned long)DutyCycleInfo.m_ui32DeferredCount);
+            Serial.println(szTextBuff);
+        }
+        else
+        {
+            snprintf(szTextBuff, sizeof(szTextBuff), "  LoraTransmitter_g.TransmitPacket() FAILED! (iRes=%d)", iRes);
+            Serial.println(szTextBuff);
+        }
+        HcSr501SensorRestMotionActiveTime();
+        LowPowerLogEnergyBudget();
+
+        // Calculate time interval for transmitting next LoRa Data Packet
+        ui32LoraNextTransmitCycleTime = LoraTransmitter_g.CalcNextTransmitCycleTime(LORA_PACKET_INHIBIT_TIME, DeviceConfig_g.m_ui32DataPackCycleTm);
+        snprintf(szTextBuff, sizeof(szTextBuff), "TimeSpan until transmitting next cyclic LoRa DataPacket: %s", FormatDateTime(ui32LoraNextTransmitCycleTime, false, true).c_str());
+        Serial.println(szTextBuff);
+        SensorDataRec_g.m_i32LoraRemainingCycleTime = LoraTransmitter_g.GetRemainingTransmitCycleTime();
+    }
+    else
+    {
+        SensorDataRec_g.m_i32LoraRemainingCycleTime = LoraTransmitter_g.GetRemainingTransmitCycleTime();
+        snprintf(szTextBuff, sizeof(szTextBuff), "Remaining TimeSpan until transmitting next cyclic LoRa DataPacket: %s", FormatDateTime(SensorDataRec_g.m_i32LoraRemainingCycleTime, false, true).c_str());
+        Serial.println(szTextBuff);
+    }
+    fLedLoRaTransmit_g = LoraTransmitter_g.GetTransmitIndicatorState(LORA_TX_LED_SIGNAL_ACTIVE_TIME);
+
+    // In Low Power Mode the task period is extended, so the task is
+    // rescheduled to the end of the current transmit cycle if this is earlier
+    if (CFG_LOW_POWER_MODE != LOW_POWER_MODE_OFF)
+    {
+        if ((SensorDataRec_g.m_i32LoraRemainingCycleTime > 0) &&
+            ((uint32_t)SensorDataRec_g.m_i32LoraRemainingCycleTime < SchedulerGetTaskPeriod(TASK_PERIOD_LORA_TRANSMIT)))
+        {
+            TaskScheduler_g.RescheduleTask(iTaskIdLoraTransmit_g, (uint32_t)SensorDataRec_g.m_i32LoraRemainingCycleTime);
+        }
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Task: update process information on OLED
+//---------------------------------------------------------------------------
+
+void  TaskOledUpdate (void)
+{
+
+    OledUpdateProcessData(&SensorDataRec_g, &PrevSensorDataRec_g);
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Task: set Status LEDs
+//---------------------------------------------------------------------------
+
+void  TaskStatusLeds (void)
+{
+
+    SetLedLoRaTransmit(GetStateLedLoRaTransmit(fLedLoRaTransmit_g, fCommissioningMode_g, millis()));
+    SetLedMotionActive(fLedMotionActive_g);
+    SetLedCarBattPlugged(fLedCarBattPlugged_g);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Task: log Scheduler Statistics (Jitter, CPU Idle Ratio)
+//---------------------------------------------------------------------------
+
+void  TaskLogSchedStatistics (void)
+{
+
+const char*  pszLogBuffer;
+
+
+    pszLogBuffer = TaskScheduler_g.LogStatistics();
+    Serial.println();
+    Serial.println(pszLogBuffer);
+    TaskScheduler_g.ResetStatistics();
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Low Power: Setup Energy Model
+//---------------------------------------------------------------------------
+
+void  LowPowerSetup (void)
+{
+
+LowPowerState::tPowerModel  PowerModel;
+
+
+    PowerModel.m_flCurrentActive          = POWER_CURRENT_ACTIVE;
+    PowerModel.m_flCurrentLoraTx          = POWER_CURRENT_LORA_TX;
+    PowerModel.m_flCurrentLightSleep      = POWER_CURRENT_LIGHT_SLEEP;
+    PowerModel.m_flCurrentDeepSleep       = POWER_CURRENT_DEEP_SLEEP;
+    PowerModel.m_ui32LightSleepWakeupTime = POWER_LIGHT_SLEEP_WAKEUP_TIME;
+    PowerModel.m_ui32DeepSleepBootTime    = POWER_DEEP_SLEEP_BOOT_TIME;
+
+    LowPowerState_g.Setup(&PowerModel);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Low Power: Check for Wakeup from Deep Sleep with valid retained State
+//---------------------------------------------------------------------------
+
+bool  LowPowerCheckResume (void)
+{
+
+esp_sleep_wakeup_cause_t  WakeupCause;
+
+
+    if (CFG_LOW_POWER_MODE != LOW_POWER_MODE_DEEP_SLEEP)
+    {
+        return (false);
+    }
+
+    WakeupCause = esp_sleep_get_wakeup_cause();
+    if ((WakeupCause != ESP_SLEEP_WAKEUP_TIMER) && (WakeupCause != ESP_SLEEP_WAKEUP_EXT0))
+    {
+        // Power-on or Reset -> discard retained State
+        RetainState_g.m_LowPowerState.m_ui32Magic = 0;
+        return (false);
+    }
+
+    if ( !LowPowerState::IsRetainStateValid(&RetainState_g.m_LowPowerState) )
+    {
+        return (false);
+    }
+
+    return (true);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Low Power: Check if Deep Sleep is possible
+//---------------------------------------------------------------------------
+
+bool  LowPowerIsDeepSleepPossible (uint32_t ui32SleepTime_p)
+{
+
+    if (ui32SleepTime_p < LOW_POWER_DEEP_SLEEP_MIN_TIME)
+    {
+        return (false);
+    }
+
+    // MotionActiveTime and SR501 Pause are measured by millis(), which
+    // restarts after Deep Sleep -> use Light Sleep as long as they are running
+    if ( SensorDataRec_g.m_fMotionActive || fPauseActiveSr501_g )
+    {
+        return (false);
+    }
+
+    return (true);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Low Power: Enter Light Sleep
+//---------------------------------------------------------------------------
+
+void  LowPowerEnterLightSleep (uint32_t ui32SleepTime_p)
+{
+
+uint32_t  ui32StartTick;
+
+
+    ui32StartTick = millis();
+
+    Serial.flush();
+    LoraTransmitter_g.Sleep();
+
+    esp_sleep_enable_timer_wakeup((uint64_t)ui32SleepTime_p * 1000);
+    if ( CFG_ENABLE_SEN_HC_SR501_SENSOR && !fPauseActiveSr501_g )
+    {
+        // wakeup on next edge of IR Motion Sensor
+        gpio_wakeup_enable((gpio_num_t)PIN_SEN_HC_SR501, SensorDataRec_g.m_fMotionActive ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+        esp_sleep_enable_gpio_wakeup();
+    }
+
+    // RAM and millis() are preserved in Light Sleep
+    esp_light_sleep_start();
+
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO)
+    {
+        TaskScheduler_g.TriggerTask(iTaskIdHcSr501_g);
+    }
+    gpio_wakeup_disable((gpio_num_t)PIN_SEN_HC_SR501);
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+
+    LowPowerState_g.AddLightSleepTime(millis() - ui32StartTick);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Low Power: Enter Deep Sleep
+//---------------------------------------------------------------------------
+
+void  LowPowerEnterDeepSleep (uint32_t ui32SleepTime_p)
+{
+
+char  szTextBuff[128];
+
+
+    snprintf(szTextBuff, sizeof(szTextBuff), "Enter Deep Sleep for %s", FormatDateTime(ui32SleepTime_p, false, true).c_str());
+    Serial.println(szTextBuff);
+
+    LowPowerSaveState();
+
+    Serial.flush();
+    LoraTransmitter_g.Sleep();
+    if ( CFG_ENABLE_OLED_DISPLAY )
+    {
+        Oled_U8x8_g.setPowerSave(1);
+    }
+
+    esp_sleep_enable_timer_wakeup((uint64_t)ui32SleepTime_p * 1000);
+    if ( CFG_ENABLE_SEN_HC_SR501_SENSOR )
+    {
+        // wakeup on rising edge of IR Motion Sensor (GPIO2 = RTC_GPIO12)
+        esp_sleep_enable_ext0_wakeup((gpio_num_t)PIN_SEN_HC_SR501, 1);
+    }
+
+    // CPU restarts with setup() after wakeup
+    esp_deep_sleep_start();
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Low Power: Save State to RTC Memory
+//---------------------------------------------------------------------------
+
+void  LowPowerSaveState (void)
+{
+
+    RetainState_g.m_ulMainLoopCycle          = ulMainLoopCycle_g;
+    RetainState_g.m_SensorDataRec            = SensorDataRec_g;
+    RetainState_g.m_fCarBattPlugged          = fCarBattPlugged_g;
+    RetainState_g.m_ui16MotionActiveTimeBase = ui16MotionActiveTimeBase_g;
+
+    memcpy(RetainState_g.m_abAverageTemperature,  &AverageTemperature_g,  sizeof(RetainState_g.m_abAverageTemperature));
+    memcpy(RetainState_g.m_abAverageHumidity,     &AverageHumidity_g,     sizeof(RetainState_g.m_abAverageHumidity));
+    memcpy(RetainState_g.m_abAverageCarBattLevel, &AverageCarBattLevel_g, sizeof(RetainState_g.m_abAverageCarBattLevel));
+
+    // saved last, because it marks the retained State as valid
+    LowPowerState_g.SaveState(&RetainState_g.m_LowPowerState, GetRtcTick(), &LoraPayloadEnc_g, &LoraTransmitter_g);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Low Power: Restore State from RTC Memory
+//---------------------------------------------------------------------------
+
+void  LowPowerRestoreState (void)
+{
+
+char      szTextBuff[128];
+uint32_t  ui32SleepTime;
+
+
+    ulMainLoopCycle_g          = RetainState_g.m_ulMainLoopCycle;
+    SensorDataRec_g            = RetainState_g.m_SensorDataRec;
+    fCarBattPlugged_g          = RetainState_g.m_fCarBattPlugged;
+    fLedCarBattPlugged_g       = fCarBattPlugged_g ? HIGH : LOW;
+    ui16MotionActiveTimeBase_g = RetainState_g.m_ui16MotionActiveTimeBase;
+
+    memcpy(&AverageTemperature_g,  RetainState_g.m_abAverageTemperature,  sizeof(RetainState_g.m_abAverageTemperature));
+    memcpy(&AverageHumidity_g,     RetainState_g.m_abAverageHumidity,     sizeof(RetainState_g.m_abAverageHumidity));
+    memcpy(&AverageCarBattLevel_g, RetainState_g.m_abAverageCarBattLevel, sizeof(RetainState_g.m_abAverageCarBattLevel));
+
+    // SysTick, Energy Budget, LoraPayloadEncoder and LoraTransmitter, consumes the retained State
+    ui32SleepTime = LowPowerState_g.RestoreState(&RetainState_g.m_LowPowerState, GetRtcTick(), &LoraPayloadEnc_g, &LoraTransmitter_g);
+
+    snprintf(szTextBuff, sizeof(szTextBuff), "  Sleep Time:             %s", FormatDateTime(ui32SleepTime, false, true).c_str());
+    Serial.println(szTextBuff);
+    snprintf(szTextBuff, sizeof(szTextBuff), "  SequNum:                %lu", (unsigned long)RetainState_g.m_LowPowerState.m_LoraPayloadEncState.m_ui32SequNum);
+    Serial.println(szTextBuff);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Low Power: Log Energy Budget of last LoRa Transmit Cycle
+//---------------------------------------------------------------------------
+
+void  LowPowerLogEnergyBudget (void)
+{
+
+char                          szTextBuff[128];
+LowPowerState::tEnergyBudget  EnergyBudget;
+
+
+    LowPowerState_g.GetEnergyBudget(&EnergyBudget);
+
+    Serial.println("Energy Budget of last LoRa Cycle:");
+    snprintf(szTextBuff, sizeof(szTextBuff), "  Cycle Time:             %s (Wakeups: %lu)", FormatDateTime(EnergyBudget.m_ui32CycleTime, false, true).c_str(), (unsigned long)EnergyBudget.m_ui32WakeupCount);
+    Serial.println(szTextBuff);
+    snprintf(szTextBuff, sizeof(szTextBuff), "  Active / LoRa Tx:       %lu / %lu [ms]", (unsigned long)EnergyBudget.m_ui32ActiveTime, (unsigned long)EnergyBudget.m_ui32LoraTxTime);
+    Serial.println(szTextBuff);
+    snprintf(szTextBuff, sizeof(szTextBuff), "  LightSleep / DeepSleep: %lu / %lu [ms]", (unsigned long)EnergyBudget.m_ui32LightSleepTime, (unsigned long)EnergyBudget.m_ui32DeepSleepTime);
+    Serial.println(szTextBuff);
+    snprintf(szTextBuff, sizeof(szTextBuff), "  Estimated Charge:       %.1f [uAh] (avg. %.3f [mA])", EnergyBudget.m_flCharge, EnergyBudget.m_flAvgCurrent);
+    Serial.println(szTextBuff);
+
+    LowPowerState_g.StartCycle();
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Low Power: Get SysTick (continues across Deep Sleep)
+//---------------------------------------------------------------------------
+
+uint32_t  GetSysTick (void)
+{
+
+    return (LowPowerState_g.GetSysTick());
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Low Power: Get RTC Tick (keeps running during Deep Sleep)
+//---------------------------------------------------------------------------
+
+uint32_t  GetRtcTick (void)
+{
+
+struct timeval  TimeVal;
+
+
+    gettimeofday(&TimeVal, NULL);
+
+    return ((uint32_t)(((uint64_t)TimeVal.tv_sec * 1000) + (TimeVal.tv_usec / 1000)));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  LoRa: Signal asynchronous Transmission Event
+//---------------------------------------------------------------------------
+
+void  LoraSignalAsyncTransmitEvent (void)
+{
+
+    // The LoRa transmit task checks the inhibit time itself, so it is just
+    // scheduled immediately instead of waiting for its next period
+    fAsyncLoraTransmitEvent_g = true;
+    TaskScheduler_g.TriggerTask(iTaskIdLoraTransmit_g);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  LoRa: Encode Bootup Packet
+//---------------------------------------------------------------------------
+
+tLoraDataPacket*  LoraEncodeBootupPacket (const tDeviceConfig* pDeviceConfig_p, bool fLogDataToConsole_p)
+{
+
+LoraPayloadEncoder::tDeviceConfig  DeviceConfig;
+tLoraDataPacket*  pLoraDataPacket;                  // <tLoraDataPacket> is also used for Bootup Packets
+const char*       pszLogBuffer;
+int               iRes;
+
+
+    if (pDeviceConfig_p == NULL)
+    {
+        return (NULL);
+    }
+
+    DeviceConfig.m_ui8FirmwareVersion  = (uint8_t)(pDeviceConfig_p->m_iFirmwareVersion);
+    DeviceConfig.m_ui8FirmwareRevision = (uint8_t)(pDeviceConfig_p->m_iFirmwareRevision);
+    DeviceConfig.m_ui16DataPackCycleTm = pDeviceConfig_p->m_ui32DataPackCycleTm / 1000;     // [ms] -> [sec]
+    DeviceConfig.m_fCfgOledDisplay     = (bool)(pDeviceConfig_p->m_fCfgOledDisplay);
+    DeviceConfig.m_fCfgDhtSensor       = (bool)(pDeviceConfig_p->m_fCfgDhtSensor);
+    DeviceConfig.m_fCfgSr501Sensor     = (bool)(pDeviceConfig_p->m_fCfgSr501Sensor);
+    DeviceConfig.m_fCfgAdcLightSensor  = (bool)(pDeviceConfig_p->m_fCfgAdcLightSensor);
+    DeviceConfig.m_fCfgAdcCarBatAin    = (bool)(pDeviceConfig_p->m_fCfgAdcCarBatAin);
+    DeviceConfig.m_fCfgAsyncLoraEvent  = pDeviceConfig_p->m_fCfgAsyncLoraEvent;
+    DeviceConfig.m_fSr501PauseOnLoraTx = pDeviceConfig_p->m_fSr501PauseOnLoraTx;
+    DeviceConfig.m_fCommissioningMode  = pDeviceConfig_p->m_fCommissioningMode;
+    DeviceConfig.m_ui8LoraTxPower      = (uint8_t)(pDeviceConfig_p->m_iLoraTxPower);
+    DeviceConfig.m_ui8LoraSpreadFactor = (uint8_t)(pDeviceConfig_p->m_iLoraSpreadFactor);
+    iRes = LoraPayloadEnc_g.EncodeTxBootupPacket(&DeviceConfig);
+    if (iRes != 0)
+    {
+        return (NULL);
+    }
+    pLoraDataPacket = LoraPayloadEnc_g.GetTxBootupPacket();
+
+    if ( fLogDataToConsole_p )
+    {
+        pszLogBuffer = LoraPayloadEnc_g.LogDeviceConfig(&DeviceConfig);
+        Serial.println(pszLogBuffer);
+    }
+
+    return (pLoraDataPacket);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  LoRa: Encode Data Packet
+//---------------------------------------------------------------------------
+
+const void*  LoraEncodeDataPacket (const tSensorData* pSensorDataRec_p, bool fLogDataToConsole_p, unsigned int* puiPayloadSize_p)
 {
 
 LoraPayloadEncoder::tSensorDataRec  SensorDataRec;
-tLoraDataPacket*  pLoraDataPacket;
+const void*       pLoraDataPayload;
 const char*       pszLogBuffer;
 int               iRes;
 
@@ -904,7 +1625,7 @@ int               iRes;
     {
         return (NULL);
     }
-    pLoraDataPacket = LoraPayloadEnc_g.GetTxDataPacket();
+    pLoraDataPayload = LoraPayloadEnc_g.GetTxDataPayload(puiPayloadSize_p);
 
     if ( fLogDataToConsole_p )
     {
@@ -912,7 +1633,7 @@ int               iRes;
         Serial.println(pszLogBuffer);
     }
 
-    return (pLoraDataPacket);
+    return (pLoraDataPayload);
 
 }
 
@@ -1035,7 +1756,7 @@ void  SetLedCarBattPlugged (bool fLedState_p)
 //  LEDs: Get State for 'LoRaTransmit'
 //---------------------------------------------------------------------------
 
-bool  GetStateLedLoRaTransmit (bool fLedLoRaTransmit_p, bool fCommissioningMode_p, uint uiMainLoopProcStep_p)
+bool  GetStateLedLoRaTransmit (bool fLedLoRaTransmit_p, bool fCommissioningMode_p, uint32_t ui32CurrTick_p)
 {
 
 bool  fStateLedLoRaTransmit;
@@ -1051,7 +1772,7 @@ bool  fStateLedLoRaTransmit;
     {
         if ( fCommissioningMode_p )
         {
-            fStateLedLoRaTransmit = ((uiMainLoopProcStep_p % 20) / 10) ? HIGH : LOW;
+            fStateLedLoRaTransmit = ((ui32CurrTick_p % 2000) / 1000) ? HIGH : LOW;
         }
     }
 
@@ -1623,7 +2344,7 @@ uint32_t  ui32Uptime;
 String    strUptime;
 
 
-    ui32Uptime = millis();
+    ui32Uptime = GetSysTick();
     strUptime = FormatDateTime(ui32Uptime, false, true);
 
     *pui32Uptime_p = ui32Uptime;
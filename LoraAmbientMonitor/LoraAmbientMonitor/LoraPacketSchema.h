@@ -0,0 +1,527 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Ambient Monitor
+  Description:  Schema of Over-the-Air LoRa Data Packet Records
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Access to CRC16 independent of Byte Order
+  2026/10/18 -rs:   V1.02 Schema Version
+  2026/10/18 -rs:   V1.03 Fixed-Width Load/Store of Fields
+  2026/10/18 -rs:   V1.04 Rounding of Fields (Encoding as V1.00 Firmware)
+
+****************************************************************************/
+
+#ifndef _LORAPACKETSCHEMA_H_
+#define _LORAPACKETSCHEMA_H_
+
+#include <stdint.h>
+#include <math.h>
+
+
+
+//---------------------------------------------------------------------------
+//  Schema Version
+//---------------------------------------------------------------------------
+//  Has to be incremented with each change of the tables below that changes
+//  the decoding of a record (position, size, type of sign or scaling). It is
+//  stored in files which keep the raw records (e.g. binary MessageLog of the
+//  Gateway), so that readers can reject records they would decode wrongly.
+
+const uint16_t  LORA_SCHEMA_VERSION = 1;
+
+
+
+//---------------------------------------------------------------------------
+//  Field Description
+//---------------------------------------------------------------------------
+// Notice:  Every record of the LoRa packets (see LoraPacket.h) is described once by
+//          a table of <tLoraFieldDesc>. The records are little-endian Bit Streams,
+//          Bit0 is the LSB of Byte0, the fields follow each other without gaps in
+//          the order of the table. The physical value of a field is:
+//
+//              Value = Raw * ScaleMul / ScaleDiv + Offset
+//
+//          Type and Rounding only affect the encoding: they reproduce the
+//          conversions of the V1.00 Firmware exactly, so that the bytes on air
+//          don't depend on the version of the Encoder.
+//
+//          Encoder and Decoder access the fields only via <LoraField<>>, which is
+//          instantiated from the table at compile time and results in a fixed
+//          shift-and-mask sequence per field. Name, Unit and Decimals are used by
+//          the Gateway to build the JSON and Line Protocol records.
+//---------------------------------------------------------------------------
+
+typedef enum
+{
+    kLoraFieldModulo,                                   // 0..2^n-1, value is taken modulo 2^n (counters, identifiers)
+    kLoraFieldUnsigned,                                 // 0..2^n-1, value is limited to the value range
+    kLoraFieldSigned                                    // two's complement, value is limited to -(2^(n-1)-1)..+(2^(n-1)-1)
+
+} tLoraFieldType;
+
+
+typedef enum
+{
+    kLoraRoundNearest,                                  // value is rounded to the nearest step (halves away from zero)
+    kLoraRoundTrunc                                     // value is truncated to the step below (towards zero)
+
+} tLoraFieldRounding;
+
+
+typedef struct
+{
+    const char*         m_pszName;                      // Name in JSON and Line Protocol
+    const char*         m_pszUnit;                      // physical Unit ("" = none)
+    uint8_t             m_ui8BitPos;                    // Position in Record (Bit0 = LSB of Byte0)
+    uint8_t             m_ui8Bits;                      // Size [Bit], 1..32
+    tLoraFieldType      m_FieldType;
+    tLoraFieldRounding  m_Rounding;                     // physical value -> Raw
+    int32_t             m_i32ScaleMul;
+    int32_t             m_i32ScaleDiv;
+    int32_t             m_i32Offset;
+    uint8_t             m_ui8Decimals;                  // 0 = integer value
+    bool                m_fPublish;                     // part of JSON and Line Protocol record
+
+} tLoraFieldDesc;
+
+
+
+//---------------------------------------------------------------------------
+//  Schema of <tLoraBootupHeader>
+//---------------------------------------------------------------------------
+
+typedef enum
+{
+    kLoraBootupPacketType,
+    kLoraBootupDevID,
+    kLoraBootupFirmwareVersion,
+    kLoraBootupFirmwareRevision,
+    kLoraBootupDataPackCycleTm,
+    kLoraBootupCfgOledDisplay,
+    kLoraBootupCfgDhtSensor,
+    kLoraBootupCfgSr501Sensor,
+    kLoraBootupCfgAdcLightSensor,
+    kLoraBootupCfgAdcCarBatAin,
+    kLoraBootupCfgAsyncLoraEvent,
+    kLoraBootupSr501PauseOnLoraTx,
+    kLoraBootupCommissioningMode,
+    kLoraBootupLoraTxPower,
+    kLoraBootupLoraSpreadFactor,
+    kLoraBootupNumFields
+
+} tLoraBootupField;
+
+constexpr tLoraFieldDesc  LORA_SCHEMA_BOOTUP_HEADER[] =
+{   // Name                     Unit    Pos  Bits  Type                 Rounding           Mul  Div  Off  Dec  Publish
+    { "PacketType",             "",       0,   4,  kLoraFieldModulo,    kLoraRoundNearest,   1,   1,   0,   0,  false },
+    { "DevID",                  "",       4,   4,  kLoraFieldModulo,    kLoraRoundNearest,   1,   1,   0,   0,  false },
+    { "FirmwareVersion",        "",       8,   8,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,   1,   0,   0,  false },
+    { "FirmwareRevision",       "",      16,   8,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,   1,   0,   0,  false },
+    { "DataPackCycleTm",        "sec",   24,  16,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,   1,   0,   0,  true  },
+    { "CfgOledDisplay",         "",      40,   1,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,   1,   0,   0,  true  },
+    { "CfgDhtSensor",           "",      41,   1,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,   1,   0,   0,  true  },
+    { "CfgSr501Sensor",         "",      42,   1,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,   1,   0,   0,  true  },
+    { "CfgAdcLightSensor",      "",      43,   1,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,   1,   0,   0,  true  },
+    { "CfgAdcCarBatAin",        "",      44,   1,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,   1,   0,   0,  true  },
+    { "CfgAsyncLoraEvent",      "",      45,   1,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,   1,   0,   0,  true  },
+    { "Sr501PauseOnLoraTx",     "",      46,   1,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,   1,   0,   0,  true  },
+    { "CommissioningMode",      "",      47,   1,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,   1,   0,   0,  true  },
+    { "LoraTxPower",            "dB",    48,   8,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,   1,   0,   0,  true  },
+    { "LoraSpreadFactor",       "",      56,   8,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,   1,   0,   0,  true  }
+};
+
+
+
+//---------------------------------------------------------------------------
+//  Schema of <tLoraDataHeader>
+//---------------------------------------------------------------------------
+
+typedef enum
+{
+    kLoraHeaderPacketType,
+    kLoraHeaderDevID,
+    kLoraHeaderSequNum,
+    kLoraHeaderUptime,
+    kLoraHeaderNumFields
+
+} tLoraHeaderField;
+
+constexpr tLoraFieldDesc  LORA_SCHEMA_DATA_HEADER[] =
+{   // Name                     Unit    Pos  Bits  Type                 Rounding           Mul  Div  Off  Dec  Publish
+    { "PacketType",             "",       0,   4,  kLoraFieldModulo,    kLoraRoundNearest,   1,   1,   0,   0,  false },
+    { "DevID",                  "",       4,   4,  kLoraFieldModulo,    kLoraRoundNearest,   1,   1,   0,   0,  false },
+    { "SequNum",                "",       8,  24,  kLoraFieldModulo,    kLoraRoundNearest,   1,   1,   0,   0,  false },
+    { "Uptime",                 "sec",   32,  32,  kLoraFieldModulo,    kLoraRoundNearest,   1,   1,   0,   0,  false }
+};
+
+
+
+//---------------------------------------------------------------------------
+//  Schema of <tLoraDataRec>
+//---------------------------------------------------------------------------
+
+typedef enum
+{
+    kLoraDataRecPacketType,
+    kLoraDataRecUptimeSnippet,
+    kLoraDataRecTemperature,
+    kLoraDataRecHumidity,
+    kLoraDataRecMotionActive,
+    kLoraDataRecMotionActiveTime,
+    kLoraDataRecMotionActiveCount,
+    kLoraDataRecLightLevel,
+    kLoraDataRecCarBattLevel,
+    kLoraDataRecNumFields
+
+} tLoraDataRecField;
+
+constexpr tLoraFieldDesc  LORA_SCHEMA_DATA_REC[] =
+{   // Name                     Unit    Pos  Bits  Type                 Rounding           Mul  Div  Off  Dec  Publish
+    { "PacketType",             "",       0,   4,  kLoraFieldModulo,    kLoraRoundNearest,   1,   1,   0,   0,  false },
+    { "UptimeSnippet",          "sec",    4,  12,  kLoraFieldModulo,    kLoraRoundTrunc,    10,   1,   0,   0,  false },
+    { "Temperature",            "C",     16,   8,  kLoraFieldSigned,    kLoraRoundNearest,   1,   2,   0,   1,  true  },
+    { "Humidity",               "%",     24,   7,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,   1,   0,   1,  true  },
+    { "MotionActive",           "",      31,   1,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,   1,   0,   0,  true  },
+    { "MotionActiveTime",       "sec",   32,   8,  kLoraFieldModulo,    kLoraRoundNearest,  10,   1,   0,   0,  true  },
+    { "MotionActiveCount",      "",      40,  10,  kLoraFieldModulo,    kLoraRoundNearest,   1,   1,   0,   0,  true  },
+    { "LightLevel",             "%",     50,   6,  kLoraFieldModulo,    kLoraRoundTrunc,     2,   1,   0,   0,  true  },
+    { "CarBattLevel",           "V",     56,   8,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,  10,   0,   1,  true  }
+};
+
+
+
+//---------------------------------------------------------------------------
+//  Schema of <tLoraDataDeltaRec>
+//---------------------------------------------------------------------------
+
+typedef enum
+{
+    kLoraDeltaRecUptimeAge,
+    kLoraDeltaRecTemperatureDelta,
+    kLoraDeltaRecHumidityDelta,
+    kLoraDeltaRecMotionActive,
+    kLoraDeltaRecMotionActiveTime,
+    kLoraDeltaRecMotionCountDelta,
+    kLoraDeltaRecLightLevel,
+    kLoraDeltaRecCarBattLevel,
+    kLoraDeltaRecClipped,
+    kLoraDeltaRecNumFields
+
+} tLoraDeltaRecField;
+
+constexpr tLoraFieldDesc  LORA_SCHEMA_DATA_DELTA_REC[] =
+{   // Name                     Unit    Pos  Bits  Type                 Rounding           Mul  Div  Off  Dec  Publish
+    { "UptimeAge",              "sec",    0,  12,  kLoraFieldModulo,    kLoraRoundTrunc,    10,   1,   0,   0,  false },
+    { "TemperatureDelta",       "C",     12,   6,  kLoraFieldSigned,    kLoraRoundNearest,   1,   2,   0,   1,  false },
+    { "HumidityDelta",          "%",     18,   6,  kLoraFieldSigned,    kLoraRoundNearest,   1,   1,   0,   1,  false },
+    { "MotionActive",           "",      24,   1,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,   1,   0,   0,  false },
+    { "MotionActiveTime",       "sec",   25,   8,  kLoraFieldModulo,    kLoraRoundNearest,  10,   1,   0,   0,  false },
+    { "MotionCountDelta",       "",      33,   8,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,   1,   0,   0,  false },
+    { "LightLevel",             "%",     41,   6,  kLoraFieldModulo,    kLoraRoundTrunc,     2,   1,   0,   0,  false },
+    { "CarBattLevel",           "V",     47,   8,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,  10,   0,   1,  false },
+    { "Clipped",                "",      55,   1,  kLoraFieldUnsigned,  kLoraRoundNearest,   1,   1,   0,   0,  false }
+};
+
+
+
+//---------------------------------------------------------------------------
+//  Compile Time Checks of Schema
+//---------------------------------------------------------------------------
+
+// fields must follow each other without gaps, the result is the size of the record [Bit]
+constexpr unsigned int  LoraSchemaBits (const tLoraFieldDesc* paSchema_p, unsigned int uiNumFields_p)
+{
+    return ((uiNumFields_p == 0) ? 0 :
+            ((paSchema_p[uiNumFields_p-1].m_ui8BitPos != LoraSchemaBits(paSchema_p, uiNumFields_p-1)) ? 0xFFFF :
+             (paSchema_p[uiNumFields_p-1].m_ui8BitPos + paSchema_p[uiNumFields_p-1].m_ui8Bits)));
+}
+
+static_assert(LoraSchemaBits(LORA_SCHEMA_BOOTUP_HEADER,  kLoraBootupNumFields)   == 64, "Schema <tLoraBootupHeader> does not match the packet format");
+static_assert(LoraSchemaBits(LORA_SCHEMA_DATA_HEADER,    kLoraHeaderNumFields)   == 64, "Schema <tLoraDataHeader> does not match the packet format");
+static_assert(LoraSchemaBits(LORA_SCHEMA_DATA_REC,       kLoraDataRecNumFields)  == 64, "Schema <tLoraDataRec> does not match the packet format");
+static_assert(LoraSchemaBits(LORA_SCHEMA_DATA_DELTA_REC, kLoraDeltaRecNumFields) == 56, "Schema <tLoraDataDeltaRec> does not match the packet format");
+
+static_assert(sizeof(LORA_SCHEMA_BOOTUP_HEADER)  / sizeof(tLoraFieldDesc) == kLoraBootupNumFields,   "Schema <tLoraBootupHeader> incomplete");
+static_assert(sizeof(LORA_SCHEMA_DATA_HEADER)    / sizeof(tLoraFieldDesc) == kLoraHeaderNumFields,   "Schema <tLoraDataHeader> incomplete");
+static_assert(sizeof(LORA_SCHEMA_DATA_REC)       / sizeof(tLoraFieldDesc) == kLoraDataRecNumFields,  "Schema <tLoraDataRec> incomplete");
+static_assert(sizeof(LORA_SCHEMA_DATA_DELTA_REC) / sizeof(tLoraFieldDesc) == kLoraDeltaRecNumFields, "Schema <tLoraDataDeltaRec> incomplete");
+
+
+
+
+
+//---------------------------------------------------------------------------
+//  Little-endian Load/Store of the Bytes covering a Field
+//---------------------------------------------------------------------------
+//  Specialised by the number of Bytes, so that the access of a field is a
+//  single fixed-width shift-and-mask sequence without a byte loop. Fields
+//  within 4 Bytes use 32 Bit words (native word size of the ESP32), a 32 Bit
+//  field not aligned to a Byte boundary covers 5 Bytes.
+
+template <unsigned int uiBytes_p>  struct  LoraFieldWord;
+
+template <>  struct  LoraFieldWord<1>
+{
+    typedef uint32_t  tWord;
+    static inline tWord  Load (const uint8_t* pab_p)            { return ((tWord)pab_p[0]); }
+    static inline void   Store (uint8_t* pab_p, tWord Word_p)   { pab_p[0] = (uint8_t)Word_p; }
+};
+
+template <>  struct  LoraFieldWord<2>
+{
+    typedef uint32_t  tWord;
+    static inline tWord  Load (const uint8_t* pab_p)            { return ((tWord)pab_p[0] | ((tWord)pab_p[1] << 8)); }
+    static inline void   Store (uint8_t* pab_p, tWord Word_p)   { pab_p[0] = (uint8_t)Word_p;  pab_p[1] = (uint8_t)(Word_p >> 8); }
+};
+
+template <>  struct  LoraFieldWord<3>
+{
+    typedef uint32_t  tWord;
+    static inline tWord  Load (const uint8_t* pab_p)            { return ((tWord)pab_p[0] | ((tWord)pab_p[1] << 8) | ((tWord)pab_p[2] << 16)); }
+    static inline void   Store (uint8_t* pab_p, tWord Word_p)   { LoraFieldWord<2>::Store(pab_p, Word_p);  pab_p[2] = (uint8_t)(Word_p >> 16); }
+};
+
+template <>  struct  LoraFieldWord<4>
+{
+    typedef uint32_t  tWord;
+    static inline tWord  Load (const uint8_t* pab_p)            { return (LoraFieldWord<3>::Load(pab_p) | ((tWord)pab_p[3] << 24)); }
+    static inline void   Store (uint8_t* pab_p, tWord Word_p)   { LoraFieldWord<3>::Store(pab_p, Word_p);  pab_p[3] = (uint8_t)(Word_p >> 24); }
+};
+
+template <>  struct  LoraFieldWord<5>
+{
+    typedef uint64_t  tWord;
+    static inline tWord  Load (const uint8_t* pab_p)            { return ((tWord)LoraFieldWord<4>::Load(pab_p) | ((tWord)pab_p[4] << 32)); }
+    static inline void   Store (uint8_t* pab_p, tWord Word_p)   { LoraFieldWord<4>::Store(pab_p, (uint32_t)Word_p);  pab_p[4] = (uint8_t)(Word_p >> 32); }
+};
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          CLASS  LoraField                                               */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//  Access to a single field of a record, all parameters are taken from the
+//  schema table at compile time. The Bytes covering the field are read and
+//  written little-endian as one word of fixed width <LoraFieldWord<BYTES>>,
+//  independent of the byte order of the CPU.
+
+template <const tLoraFieldDesc* paSchema_p, unsigned int uiField_p>
+class  LoraField
+{
+
+    //-----------------------------------------------------------------------
+    //  Definitions
+    //-----------------------------------------------------------------------
+
+    public:
+
+        enum
+        {
+            BIT_POS     = paSchema_p[uiField_p].m_ui8BitPos,
+            BITS        = paSchema_p[uiField_p].m_ui8Bits,
+            FIRST_BYTE  = BIT_POS / 8,
+            LAST_BYTE   = (BIT_POS + BITS - 1) / 8,
+            BYTES       = LAST_BYTE - FIRST_BYTE + 1,
+            SHIFT       = BIT_POS % 8,
+            IS_SIGNED   = (paSchema_p[uiField_p].m_FieldType == kLoraFieldSigned),
+            IS_MODULO   = (paSchema_p[uiField_p].m_FieldType == kLoraFieldModulo),
+            IS_TRUNC    = (paSchema_p[uiField_p].m_Rounding == kLoraRoundTrunc),
+            SCALE_MUL   = paSchema_p[uiField_p].m_i32ScaleMul,
+            SCALE_DIV   = paSchema_p[uiField_p].m_i32ScaleDiv,
+            OFFSET      = paSchema_p[uiField_p].m_i32Offset
+        };
+
+        static_assert((BITS >= 1) && (BITS <= 32), "invalid field size");
+        static_assert((SCALE_MUL > 0) && (SCALE_DIV > 0), "invalid field scale");
+
+        typedef LoraFieldWord<BYTES>       tFieldWord;
+        typedef typename tFieldWord::tWord  tWord;
+
+        static constexpr uint64_t  Mask (void)    { return ((1ULL << BITS) - 1); }
+        static constexpr int64_t   RawMax (void)  { return (IS_SIGNED ? ((1LL << (BITS - 1)) - 1) : ((1LL << BITS) - 1)); }
+        static constexpr int64_t   RawMin (void)  { return (IS_SIGNED ? -((1LL << (BITS - 1)) - 1) : 0); }
+
+
+
+    //-----------------------------------------------------------------------
+    //  Public Methodes
+    //-----------------------------------------------------------------------
+
+    public:
+
+        // Raw value of the field
+        static inline uint32_t  Get (const void* pRec_p)
+        {
+            const tWord  Word = tFieldWord::Load((const uint8_t*)pRec_p + FIRST_BYTE);
+            return ((uint32_t)((Word >> SHIFT) & (tWord)Mask()));
+        }
+
+        // fields covering whole Bytes are stored without reading the neighbouring Bits
+        static inline void  Put (void* pRec_p, uint32_t ui32Raw_p)
+        {
+            uint8_t*     pabRec    = (uint8_t*)pRec_p + FIRST_BYTE;
+            const tWord  FieldMask = (tWord)Mask() << SHIFT;
+            tWord        Word      = ((tWord)ui32Raw_p << SHIFT) & FieldMask;
+            if ((SHIFT != 0) || (BITS != (8 * BYTES)))
+            {
+                Word |= tFieldWord::Load(pabRec) & ~FieldMask;
+            }
+            tFieldWord::Store(pabRec, Word);
+        }
+
+        // Raw value interpreted as number (sign extended for kLoraFieldSigned)
+        static inline int64_t  RawToInt (uint32_t ui32Raw_p)
+        {
+            const uint64_t  ui64Sign = (IS_SIGNED ? (1ULL << (BITS - 1)) : 0);
+            return ((int64_t)((((uint64_t)ui32Raw_p & Mask()) ^ ui64Sign) - ui64Sign));
+        }
+
+        // Raw -> physical value
+        static inline int64_t  ToInt (uint32_t ui32Raw_p)
+        {
+            return ((RawToInt(ui32Raw_p) * SCALE_MUL) / SCALE_DIV + OFFSET);
+        }
+
+        static inline float  ToFloat (uint32_t ui32Raw_p)
+        {
+            return ((float)(RawToInt(ui32Raw_p) * SCALE_MUL) / (float)SCALE_DIV + (float)OFFSET);
+        }
+
+        static inline int64_t  GetInt (const void* pRec_p)
+        {
+            return (ToInt(Get(pRec_p)));
+        }
+
+        static inline float  GetFloat (const void* pRec_p)
+        {
+            return (ToFloat(Get(pRec_p)));
+        }
+
+        // physical value -> Raw (rounded or truncated, then limited or wrapped around)
+        static inline uint32_t  FromInt (int64_t i64Value_p)
+        {
+            int64_t  i64Raw = (i64Value_p - OFFSET) * SCALE_DIV;
+            if ( !IS_TRUNC )
+            {
+                i64Raw += ((i64Raw < 0) ? -(SCALE_MUL / 2) : (SCALE_MUL / 2));
+            }
+            i64Raw /= SCALE_MUL;
+            if ( IS_MODULO )
+            {
+                return ((uint32_t)((uint64_t)i64Raw & Mask()));
+            }
+            return (Limit(i64Raw));
+        }
+
+        static inline uint32_t  FromFloat (float flValue_p)
+        {
+            float  flRaw = (flValue_p - (float)OFFSET) * (float)SCALE_DIV / (float)SCALE_MUL;
+            if ( IS_MODULO )
+            {
+                return ((uint32_t)((uint64_t)(IS_TRUNC ? (int64_t)flRaw : (int64_t)round(flRaw)) & Mask()));
+            }
+            flRaw = ((flRaw > (float)RawMax()) ? (float)RawMax() : flRaw);
+            flRaw = ((flRaw < (float)RawMin()) ? (float)RawMin() : flRaw);
+            return (Limit(IS_TRUNC ? (int64_t)flRaw : (int64_t)round(flRaw)));
+        }
+
+        static inline void  SetInt (void* pRec_p, int64_t i64Value_p)
+        {
+            Put(pRec_p, FromInt(i64Value_p));
+        }
+
+        static inline void  SetFloat (void* pRec_p, float flValue_p)
+        {
+            Put(pRec_p, FromFloat(flValue_p));
+        }
+
+
+
+    //-----------------------------------------------------------------------
+    //  Private Methodes
+    //-----------------------------------------------------------------------
+
+    private:
+
+        static inline uint32_t  Limit (int64_t i64Raw_p)
+        {
+            i64Raw_p = ((i64Raw_p > RawMax()) ? RawMax() : i64Raw_p);
+            i64Raw_p = ((i64Raw_p < RawMin()) ? RawMin() : i64Raw_p);
+            return ((uint32_t)((uint64_t)i64Raw_p & Mask()));
+        }
+
+};
+
+
+template <unsigned int uiField_p>  using  LoraBootupHeaderField = LoraField<LORA_SCHEMA_BOOTUP_HEADER,  uiField_p>;
+template <unsigned int uiField_p>  using  LoraDataHeaderField   = LoraField<LORA_SCHEMA_DATA_HEADER,    uiField_p>;
+template <unsigned int uiField_p>  using  LoraDataRecField      = LoraField<LORA_SCHEMA_DATA_REC,       uiField_p>;
+template <unsigned int uiField_p>  using  LoraDeltaRecField     = LoraField<LORA_SCHEMA_DATA_DELTA_REC, uiField_p>;
+
+
+
+//---------------------------------------------------------------------------
+//  CRC16 of Records (little-endian, independent of Byte Order of the Target)
+//---------------------------------------------------------------------------
+
+inline uint16_t  LoraGetCrc16 (const uint8_t* pabCrc16_p)
+{
+    return ((uint16_t)(pabCrc16_p[0] | (pabCrc16_p[1] << 8)));
+}
+
+inline void  LoraPutCrc16 (uint8_t* pabCrc16_p, uint16_t ui16Crc16_p)
+{
+    pabCrc16_p[0] = (uint8_t)(ui16Crc16_p & 0xFF);
+    pabCrc16_p[1] = (uint8_t)(ui16Crc16_p >> 8);
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Field Access by Description (Runtime)
+//---------------------------------------------------------------------------
+//  Used where all fields of a record are iterated (e.g. JSON records), the
+//  Encoder and Decoder use the specialised <LoraField<>> instead.
+
+inline uint32_t  LoraSchemaGetRaw (const tLoraFieldDesc* pFieldDesc_p, const void* pRec_p)
+{
+    const uint8_t*  pabRec = (const uint8_t*)pRec_p;
+    uint64_t        ui64Word = 0;
+    unsigned int    uiFirstByte = pFieldDesc_p->m_ui8BitPos / 8;
+    unsigned int    uiLastByte  = (pFieldDesc_p->m_ui8BitPos + pFieldDesc_p->m_ui8Bits - 1) / 8;
+    for (unsigned int uiByte=uiFirstByte; uiByte<=uiLastByte; uiByte++)
+    {
+        ui64Word |= ((uint64_t)pabRec[uiByte] << (8 * (uiByte - uiFirstByte)));
+    }
+    return ((uint32_t)((ui64Word >> (pFieldDesc_p->m_ui8BitPos % 8)) & ((1ULL << pFieldDesc_p->m_ui8Bits) - 1)));
+}
+
+inline double  LoraSchemaGetValue (const tLoraFieldDesc* pFieldDesc_p, const void* pRec_p)
+{
+    int64_t   i64Raw  = LoraSchemaGetRaw(pFieldDesc_p, pRec_p);
+    uint64_t  ui64Sign = ((pFieldDesc_p->m_FieldType == kLoraFieldSigned) ? (1ULL << (pFieldDesc_p->m_ui8Bits - 1)) : 0);
+    i64Raw = (int64_t)(((uint64_t)i64Raw ^ ui64Sign) - ui64Sign);
+    return ((double)(i64Raw * pFieldDesc_p->m_i32ScaleMul) / (double)pFieldDesc_p->m_i32ScaleDiv + (double)pFieldDesc_p->m_i32Offset);
+}
+
+
+
+#endif  // _LORAPACKETSCHEMA_H_
+
+
+
+// EOF
+
@@ -10,6 +10,13 @@
   Revision History:
 
   2023/03/25 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Save/Restore of State for Deep Sleep
+  2026/10/18 -rs:   V1.02 Delta Data Packet with configurable Generation Depth
+  2026/10/18 -rs:   V1.03 Compact Data Packet with Record Layout derived from
+                          Sensor Configuration
+  2026/10/18 -rs:   V1.04 Field access and scaling generated from <LoraPacketSchema.h>
+  2026/10/18 -rs:   V1.05 CRC16 written byte-wise (independent of Byte Order)
+  2026/10/18 -rs:   V1.06 Include <string.h> for Host Builds (LoraMsgLog)
 
 ****************************************************************************/
 
@@ -19,10 +26,12 @@
 #else
     #define _CRT_SECURE_NO_WARNINGS
     #include <iostream>
+    #include <string.h>
     typedef  unsigned int  uint;
 #endif
 
 #include "LoraPacket.h"
+#include "LoraPacketSchema.h"
 #include "LoraPayloadEncoder.h"
 #include <stdarg.h>
 
@@ -68,6 +77,17 @@ LoraPayloadEncoder::LoraPayloadEncoder()
     memset(&m_TxLoraBootupPacket, 0x00, sizeof(m_TxLoraBootupPacket));
     memset(&m_TxLoraDataPacket, 0x00, sizeof(m_TxLoraDataPacket));
 
+    m_uiGenDepth = 0;
+    memset(m_aDataRecHist, 0x00, sizeof(m_aDataRecHist));
+    m_uiDataRecHistCount = 0;
+    memset(&m_TxLoraDataDeltaPacket, 0x00, sizeof(m_TxLoraDataDeltaPacket));
+    m_uiTxDataDeltaPacketSize = 0;
+
+    m_fCompactLayout  = false;
+    m_ui8SensorLayout = LORA_DATA_LAYOUT_SENSOR_MASK;
+    memset(&m_TxLoraDataCompactPacket, 0x00, sizeof(m_TxLoraDataCompactPacket));
+    m_uiTxDataCompactPacketSize = 0;
+
     return;
 
 }
@@ -110,6 +130,52 @@ void  LoraPayloadEncoder::Setup (uint8_t ui8DevID_p)
 
 
 
+//---------------------------------------------------------------------------
+//  SetupGenerationDepth
+//---------------------------------------------------------------------------
+//  0 = classic Data Packet <tLoraDataPacket> (Gen0/Gen1/Gen2 as complete DataRecords)
+//  1..LORA_DATA_GEN_DEPTH_MAX = Delta Data Packet <tLoraDataDeltaPacket> with Gen0..Gen(n-1)
+
+int  LoraPayloadEncoder::SetupGenerationDepth (unsigned int uiGenDepth_p)
+{
+
+    if (uiGenDepth_p > LORA_DATA_GEN_DEPTH_MAX)
+    {
+        return (-1);
+    }
+
+    m_uiGenDepth = uiGenDepth_p;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  SetupCompactLayout
+//---------------------------------------------------------------------------
+//  Compact Data Packet <tLoraDataCompactPacket>, only the values of the sensors
+//  given in <ui8SensorLayout_p> (LORA_DATA_LAYOUT_xxx) are transmitted. The
+//  generations are taken from <SetupGenerationDepth()>, 0 means Gen0/Gen1/Gen2.
+
+int  LoraPayloadEncoder::SetupCompactLayout (bool fEnable_p, uint8_t ui8SensorLayout_p)
+{
+
+    if ((ui8SensorLayout_p & ~LORA_DATA_LAYOUT_SENSOR_MASK) != 0)
+    {
+        return (-1);
+    }
+
+    m_fCompactLayout  = fEnable_p;
+    m_ui8SensorLayout = ui8SensorLayout_p;
+
+    return (0);
+
+}
+
+
+
 //---------------------------------------------------------------------------
 //  EncodeTxBootupPacket
 //---------------------------------------------------------------------------
@@ -123,22 +189,22 @@ tLoraBootupHeader*  pLoraBootupHeader;
     pLoraBootupHeader = (tLoraBootupHeader*)&m_TxLoraBootupPacket.m_LoraHeader;
 
     // setup Header of LoRa Bootup Packet
-    pLoraBootupHeader->m_ui4PacketType         = kLoraPacketBootup;
-    pLoraBootupHeader->m_ui4DevID              = (m_ui8DevID & 0x0F);
-    pLoraBootupHeader->m_ui8FirmwareVersion    = pDeviceConfig_p->m_ui8FirmwareVersion;
-    pLoraBootupHeader->m_ui8FirmwareRevision   = pDeviceConfig_p->m_ui8FirmwareRevision;
-    pLoraBootupHeader->m_ui16DataPackCycleTm   = pDeviceConfig_p->m_ui16DataPackCycleTm;
-    pLoraBootupHeader->m_ui1CfgOledDisplay     = pDeviceConfig_p->m_fCfgOledDisplay;
-    pLoraBootupHeader->m_ui1CfgDhtSensor       = pDeviceConfig_p->m_fCfgDhtSensor;
-    pLoraBootupHeader->m_ui1CfgSr501Sensor     = pDeviceConfig_p->m_fCfgSr501Sensor;
-    pLoraBootupHeader->m_ui1CfgAdcLightSensor  = pDeviceConfig_p->m_fCfgAdcLightSensor;
-    pLoraBootupHeader->m_ui1CfgAdcCarBatAin    = pDeviceConfig_p->m_fCfgAdcCarBatAin;
-    pLoraBootupHeader->m_ui1CfgAsyncLoraEvent  = pDeviceConfig_p->m_fCfgAsyncLoraEvent;
-    pLoraBootupHeader->m_ui1Sr501PauseOnLoraTx = pDeviceConfig_p->m_fSr501PauseOnLoraTx;
-    pLoraBootupHeader->m_ui1CommissioningMode  = pDeviceConfig_p->m_fCommissioningMode;
-    pLoraBootupHeader->m_ui8LoraTxPower        = pDeviceConfig_p->m_ui8LoraTxPower;
-    pLoraBootupHeader->m_ui8LoraSpreadFactor   = pDeviceConfig_p->m_ui8LoraSpreadFactor;
-    pLoraBootupHeader->m_ui16CRC16             = CalcCrc16(&m_TxLoraBootupPacket.m_LoraHeader, (64/8));
+    LoraBootupHeaderField<kLoraBootupPacketType        >::Put   (pLoraBootupHeader, kLoraPacketBootup);
+    LoraBootupHeaderField<kLoraBootupDevID             >::SetInt(pLoraBootupHeader, m_ui8DevID);
+    LoraBootupHeaderField<kLoraBootupFirmwareVersion   >::SetInt(pLoraBootupHeader, pDeviceConfig_p->m_ui8FirmwareVersion);
+    LoraBootupHeaderField<kLoraBootupFirmwareRevision  >::SetInt(pLoraBootupHeader, pDeviceConfig_p->m_ui8FirmwareRevision);
+    LoraBootupHeaderField<kLoraBootupDataPackCycleTm   >::SetInt(pLoraBootupHeader, pDeviceConfig_p->m_ui16DataPackCycleTm);
+    LoraBootupHeaderField<kLoraBootupCfgOledDisplay    >::SetInt(pLoraBootupHeader, pDeviceConfig_p->m_fCfgOledDisplay);
+    LoraBootupHeaderField<kLoraBootupCfgDhtSensor      >::SetInt(pLoraBootupHeader, pDeviceConfig_p->m_fCfgDhtSensor);
+    LoraBootupHeaderField<kLoraBootupCfgSr501Sensor    >::SetInt(pLoraBootupHeader, pDeviceConfig_p->m_fCfgSr501Sensor);
+    LoraBootupHeaderField<kLoraBootupCfgAdcLightSensor >::SetInt(pLoraBootupHeader, pDeviceConfig_p->m_fCfgAdcLightSensor);
+    LoraBootupHeaderField<kLoraBootupCfgAdcCarBatAin   >::SetInt(pLoraBootupHeader, pDeviceConfig_p->m_fCfgAdcCarBatAin);
+    LoraBootupHeaderField<kLoraBootupCfgAsyncLoraEvent >::SetInt(pLoraBootupHeader, pDeviceConfig_p->m_fCfgAsyncLoraEvent);
+    LoraBootupHeaderField<kLoraBootupSr501PauseOnLoraTx>::SetInt(pLoraBootupHeader, pDeviceConfig_p->m_fSr501PauseOnLoraTx);
+    LoraBootupHeaderField<kLoraBootupCommissioningMode >::SetInt(pLoraBootupHeader, pDeviceConfig_p->m_fCommissioningMode);
+    LoraBootupHeaderField<kLoraBootupLoraTxPower       >::SetInt(pLoraBootupHeader, pDeviceConfig_p->m_ui8LoraTxPower);
+    LoraBootupHeaderField<kLoraBootupLoraSpreadFactor  >::SetInt(pLoraBootupHeader, pDeviceConfig_p->m_ui8LoraSpreadFactor);
+    LoraPutCrc16(pLoraBootupHeader->m_abCRC16, CalcCrc16(&m_TxLoraBootupPacket.m_LoraHeader, (64/8)));
 
     return (0);
 
@@ -166,41 +232,68 @@ tLoraDataPacket*  LoraPayloadEncoder::GetTxBootupPacket (void)
 int  LoraPayloadEncoder::EncodeTxDataPacket (const tSensorDataRec* pSensorDataRec_p)
 {
 
+tLoraDataHeader*  pLoraHeader;
+tLoraDataRec*     pLoraDataRec;
+
+
     // update SequenceNumber
     m_ui32SequNum++;
 
     // setup Header of LoRa Data Packet
-    m_TxLoraDataPacket.m_LoraHeader.m_ui4PacketType = kLoraPacketDataHeader;
-    m_TxLoraDataPacket.m_LoraHeader.m_ui4DevID      = (m_ui8DevID & 0x0F);
-    m_TxLoraDataPacket.m_LoraHeader.m_ui24SequNum   = (m_ui32SequNum & 0x00FFFFFF);
-    m_TxLoraDataPacket.m_LoraHeader.m_ui32Uptime    = pSensorDataRec_p->m_ui32Uptime;
-    m_TxLoraDataPacket.m_LoraHeader.m_ui16CRC16     = CalcCrc16(&m_TxLoraDataPacket.m_LoraHeader, (64/8));
+    pLoraHeader = &m_TxLoraDataPacket.m_LoraHeader;
+    LoraDataHeaderField<kLoraHeaderPacketType>::Put   (pLoraHeader, kLoraPacketDataHeader);
+    LoraDataHeaderField<kLoraHeaderDevID     >::SetInt(pLoraHeader, m_ui8DevID);
+    LoraDataHeaderField<kLoraHeaderSequNum   >::SetInt(pLoraHeader, m_ui32SequNum);
+    LoraDataHeaderField<kLoraHeaderUptime    >::SetInt(pLoraHeader, pSensorDataRec_p->m_ui32Uptime);
+    LoraPutCrc16(pLoraHeader->m_abCRC16, CalcCrc16(pLoraHeader, (64/8)));
 
     // process generation list ([2]->[1] | [1]->[0])
     m_TxLoraDataPacket.m_aLoraDataRec[2] = m_TxLoraDataPacket.m_aLoraDataRec[1];
-    if ((tLoraPacketType)(m_TxLoraDataPacket.m_aLoraDataRec[2].m_ui4PacketType) == kLoraPacketDataGen1)
+    pLoraDataRec = &m_TxLoraDataPacket.m_aLoraDataRec[2];
+    if (LoraDataRecField<kLoraDataRecPacketType>::Get(pLoraDataRec) == kLoraPacketDataGen1)
     {
-        m_TxLoraDataPacket.m_aLoraDataRec[2].m_ui4PacketType = kLoraPacketDataGen2;
-        m_TxLoraDataPacket.m_aLoraDataRec[2].m_ui16CRC16 = CalcCrc16(&m_TxLoraDataPacket.m_aLoraDataRec[2], (64/8));
+        LoraDataRecField<kLoraDataRecPacketType>::Put(pLoraDataRec, kLoraPacketDataGen2);
+        LoraPutCrc16(pLoraDataRec->m_abCRC16, CalcCrc16(pLoraDataRec, (64/8)));
     }
     m_TxLoraDataPacket.m_aLoraDataRec[1] = m_TxLoraDataPacket.m_aLoraDataRec[0];
-    if ((tLoraPacketType)(m_TxLoraDataPacket.m_aLoraDataRec[1].m_ui4PacketType) == kLoraPacketDataGen0)
+    pLoraDataRec = &m_TxLoraDataPacket.m_aLoraDataRec[1];
+    if (LoraDataRecField<kLoraDataRecPacketType>::Get(pLoraDataRec) == kLoraPacketDataGen0)
     {
-        m_TxLoraDataPacket.m_aLoraDataRec[1].m_ui4PacketType = kLoraPacketDataGen1;
-        m_TxLoraDataPacket.m_aLoraDataRec[1].m_ui16CRC16 = CalcCrc16(&m_TxLoraDataPacket.m_aLoraDataRec[1], (64/8));
+        LoraDataRecField<kLoraDataRecPacketType>::Put(pLoraDataRec, kLoraPacketDataGen1);
+        LoraPutCrc16(pLoraDataRec->m_abCRC16, CalcCrc16(pLoraDataRec, (64/8)));
     }
 
-    // setup newest element with current process data
-    m_TxLoraDataPacket.m_aLoraDataRec[0].m_ui4PacketType         = kLoraPacketDataGen0;
-    m_TxLoraDataPacket.m_aLoraDataRec[0].m_ui12UptimeSnippet     = ((pSensorDataRec_p->m_ui32Uptime / 10) & 0x0FFF);
-    m_TxLoraDataPacket.m_aLoraDataRec[0].m_i8Temperature         = (FloatToI8(pSensorDataRec_p->m_flTemperature * 2) & 0xFF);
-    m_TxLoraDataPacket.m_aLoraDataRec[0].m_ui7Humidity           = (FloatToUI7(pSensorDataRec_p->m_flHumidity) & 0x7F);
-    m_TxLoraDataPacket.m_aLoraDataRec[0].m_ui1MotionActive       = (pSensorDataRec_p->m_fMotionActive ? 1 : 0);
-    m_TxLoraDataPacket.m_aLoraDataRec[0].m_ui8MotionActiveTime   = (((pSensorDataRec_p->m_ui16MotionActiveTime + 5) / 10) & 0xFF);
-    m_TxLoraDataPacket.m_aLoraDataRec[0].m_ui10MotionActiveCount = (pSensorDataRec_p->m_ui16MotionActiveCount & 0x03FF);
-    m_TxLoraDataPacket.m_aLoraDataRec[0].m_ui6LightLevel         = ((pSensorDataRec_p->m_ui8LightLevel / 2) & 0x3F);
-    m_TxLoraDataPacket.m_aLoraDataRec[0].m_ui8CarBattLevel       = (FloatToUI8(pSensorDataRec_p->m_flCarBattLevel * 10.0f) & 0xFF);
-    m_TxLoraDataPacket.m_aLoraDataRec[0].m_ui16CRC16             = CalcCrc16(&m_TxLoraDataPacket.m_aLoraDataRec[0], (64/8));
+    // setup newest element with current process data (scaling and value ranges see <LORA_SCHEMA_DATA_REC>)
+    pLoraDataRec = &m_TxLoraDataPacket.m_aLoraDataRec[0];
+    LoraDataRecField<kLoraDataRecPacketType       >::Put     (pLoraDataRec, kLoraPacketDataGen0);
+    LoraDataRecField<kLoraDataRecUptimeSnippet    >::SetInt  (pLoraDataRec, pSensorDataRec_p->m_ui32Uptime);
+    LoraDataRecField<kLoraDataRecTemperature      >::SetFloat(pLoraDataRec, pSensorDataRec_p->m_flTemperature);
+    LoraDataRecField<kLoraDataRecHumidity         >::SetFloat(pLoraDataRec, pSensorDataRec_p->m_flHumidity);
+    LoraDataRecField<kLoraDataRecMotionActive     >::SetInt  (pLoraDataRec, pSensorDataRec_p->m_fMotionActive);
+    LoraDataRecField<kLoraDataRecMotionActiveTime >::SetInt  (pLoraDataRec, pSensorDataRec_p->m_ui16MotionActiveTime);
+    LoraDataRecField<kLoraDataRecMotionActiveCount>::SetInt  (pLoraDataRec, pSensorDataRec_p->m_ui16MotionActiveCount);
+    LoraDataRecField<kLoraDataRecLightLevel       >::SetInt  (pLoraDataRec, pSensorDataRec_p->m_ui8LightLevel);
+    LoraDataRecField<kLoraDataRecCarBattLevel     >::SetFloat(pLoraDataRec, pSensorDataRec_p->m_flCarBattLevel);
+    LoraPutCrc16(pLoraDataRec->m_abCRC16, CalcCrc16(pLoraDataRec, (64/8)));
+
+    // process Generation History for Delta Data Packet ([n-1]->[n] | ... | [0]->[1])
+    memmove(&m_aDataRecHist[1], &m_aDataRecHist[0], (LORA_DATA_GEN_DEPTH_MAX - 1) * sizeof(tDataRecHist));
+    m_aDataRecHist[0].m_ui32Uptime  = pSensorDataRec_p->m_ui32Uptime;
+    m_aDataRecHist[0].m_LoraDataRec = m_TxLoraDataPacket.m_aLoraDataRec[0];
+    if (m_uiDataRecHistCount < LORA_DATA_GEN_DEPTH_MAX)
+    {
+        m_uiDataRecHistCount++;
+    }
+
+    // the Compact Data Packet is built from the generations of the Delta Data Packet
+    if ((m_uiGenDepth > 0) || m_fCompactLayout)
+    {
+        EncodeTxDataDeltaPacket();
+    }
+    if ( m_fCompactLayout )
+    {
+        EncodeTxDataCompactPacket();
+    }
 
     return (0);
 
@@ -221,6 +314,100 @@ tLoraDataPacket*  LoraPayloadEncoder::GetTxDataPacket (void)
 
 
 
+//---------------------------------------------------------------------------
+//  GetTxDataPayload
+//---------------------------------------------------------------------------
+//  Returns the Data Packet in the format selected by <SetupGenerationDepth()>
+
+const void*  LoraPayloadEncoder::GetTxDataPayload (unsigned int* puiPayloadSize_p)
+{
+
+    if ( m_fCompactLayout )
+    {
+        *puiPayloadSize_p = m_uiTxDataCompactPacketSize;
+        return (&m_TxLoraDataCompactPacket);
+    }
+
+    if (m_uiGenDepth == 0)
+    {
+        *puiPayloadSize_p = sizeof(m_TxLoraDataPacket);
+        return (&m_TxLoraDataPacket);
+    }
+
+    *puiPayloadSize_p = m_uiTxDataDeltaPacketSize;
+    return (&m_TxLoraDataDeltaPacket);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  GetTxDataPayloadMaxSize
+//---------------------------------------------------------------------------
+//  Size of a Data Packet with completely filled Generation History, used to
+//  check the Duty Cycle Budget before the next Data Packet is encoded
+
+unsigned int  LoraPayloadEncoder::GetTxDataPayloadMaxSize (void)
+{
+
+    if ( m_fCompactLayout )
+    {
+        return (LORA_DATA_COMPACT_PACKET_SIZE(m_ui8SensorLayout, GetGenDepth()));
+    }
+
+    if (m_uiGenDepth == 0)
+    {
+        return (sizeof(m_TxLoraDataPacket));
+    }
+
+    return (LORA_DATA_DELTA_PACKET_SIZE(m_uiGenDepth));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  SaveState
+//---------------------------------------------------------------------------
+
+void  LoraPayloadEncoder::SaveState (tRetainState* pRetainState_p)
+{
+
+    pRetainState_p->m_ui32SequNum      = m_ui32SequNum;
+    pRetainState_p->m_TxLoraDataPacket = m_TxLoraDataPacket;
+    memcpy(pRetainState_p->m_aDataRecHist, m_aDataRecHist, sizeof(m_aDataRecHist));
+    pRetainState_p->m_ui8DataRecHistCount = (uint8_t)m_uiDataRecHistCount;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  RestoreState
+//---------------------------------------------------------------------------
+
+void  LoraPayloadEncoder::RestoreState (const tRetainState* pRetainState_p)
+{
+
+    // SequNum and Generation History continue seamlessly, so that the
+    // receiver does not recognize the wakeup as a reboot of the device
+    m_ui32SequNum      = pRetainState_p->m_ui32SequNum;
+    m_TxLoraDataPacket = pRetainState_p->m_TxLoraDataPacket;
+    memcpy(m_aDataRecHist, pRetainState_p->m_aDataRecHist, sizeof(m_aDataRecHist));
+    m_uiDataRecHistCount = pRetainState_p->m_ui8DataRecHistCount;
+    if (m_uiDataRecHistCount > LORA_DATA_GEN_DEPTH_MAX)
+    {
+        m_uiDataRecHistCount = LORA_DATA_GEN_DEPTH_MAX;
+    }
+
+    return;
+
+}
+
+
+
 //---------------------------------------------------------------------------
 //  LogDeviceConfig
 //---------------------------------------------------------------------------
@@ -306,166 +493,258 @@ char  szLogBuff[sizeof(m_szLogSensorDataRec)];
 /////////////////////////////////////////////////////////////////////////////
 
 //---------------------------------------------------------------------------
-//  Private: FloatToI7
+//  Private: GetGenDepth
+//---------------------------------------------------------------------------
+//  Generation Depth of Delta/Compact Data Packet
+
+unsigned int  LoraPayloadEncoder::GetGenDepth (void)
+{
+
+    if (m_uiGenDepth == 0)
+    {
+        return (GEN_DEPTH_CLASSIC);
+    }
+
+    return (m_uiGenDepth);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Private: EncodeTxDataDeltaPacket
 //---------------------------------------------------------------------------
 
-int8_t  LoraPayloadEncoder::FloatToI7 (float flDataValue_p)
+void  LoraPayloadEncoder::EncodeTxDataDeltaPacket (void)
 {
 
-int     iDataValue;
-int8_t  i8DataValue;
-
-
-    //   B7  B6  B5  B4  B3  B2  B1  B0
-    // +---+---+---+---+---+---+---+---+
-    // | - | S |     -63 ... +63       |
-    // +---+---+---+---+---+---+---+---+
-    //
-    //       0   1   1   1   1   1   1      +63
-    //                ...
-    //       0   0   0   0   0   0   1       +1
-    //       0   0   0   0   0   0   0        0
-    //       1   1   1   1   1   1   1       -1
-    //                ...
-    //       1   0   0   0   0   0   1      -63
-
-    // limit values to mappable range
-    if (flDataValue_p > 63.0f)
+const tLoraDataRec*  pGen0;
+const tLoraDataRec*  pGenN;
+tLoraDataDeltaRec*   pDeltaRec;
+unsigned int         uiNumGen;
+unsigned int         uiGen;
+uint32_t             ui32UptimeAge;
+uint32_t             ui32MotionCountDelta;
+int                  iTemperatureDelta;
+int                  iHumidityDelta;
+bool                 fClipped;
+
+
+    // setup Header of LoRa Delta Data Packet (same content as classic Data Packet, different PacketType)
+    m_TxLoraDataDeltaPacket.m_LoraHeader = m_TxLoraDataPacket.m_LoraHeader;
+    LoraDataHeaderField<kLoraHeaderPacketType>::Put(&m_TxLoraDataDeltaPacket.m_LoraHeader, kLoraPacketDataHeaderDelta);
+    LoraPutCrc16(m_TxLoraDataDeltaPacket.m_LoraHeader.m_abCRC16, CalcCrc16(&m_TxLoraDataDeltaPacket.m_LoraHeader, (64/8)));
+
+    // Gen0 is transmitted as complete DataRecord
+    pGen0 = &m_aDataRecHist[0].m_LoraDataRec;
+    m_TxLoraDataDeltaPacket.m_LoraDataRecGen0 = *pGen0;
+
+    uiNumGen = GetGenDepth();
+    if (uiNumGen > m_uiDataRecHistCount)
     {
-        flDataValue_p = 63.0f;
+        uiNumGen = m_uiDataRecHistCount;
     }
-    if (flDataValue_p < -63.0f)
+
+    // Gen1..GenN are transmitted as DeltaRecords relative to Gen0
+    memset(m_TxLoraDataDeltaPacket.m_aLoraDeltaRec, 0x00, sizeof(m_TxLoraDataDeltaPacket.m_aLoraDeltaRec));
+    for (uiGen=1; uiGen<uiNumGen; uiGen++)
     {
-        flDataValue_p = -63.0f;
+        // the UptimeAge is limited to 12 Bit (11 hours), older generations are dropped
+        ui32UptimeAge = (m_aDataRecHist[0].m_ui32Uptime / 10) - (m_aDataRecHist[uiGen].m_ui32Uptime / 10);
+        if (ui32UptimeAge > 0x0FFF)
+        {
+            break;
+        }
+
+        pGenN = &m_aDataRecHist[uiGen].m_LoraDataRec;
+        pDeltaRec = &m_TxLoraDataDeltaPacket.m_aLoraDeltaRec[uiGen-1];
+        fClipped = false;
+
+        // differences are built from the raw values of Gen0 and GenN
+        iTemperatureDelta = (int)(LoraDataRecField<kLoraDataRecTemperature>::RawToInt(LoraDataRecField<kLoraDataRecTemperature>::Get(pGenN)) -
+                                  LoraDataRecField<kLoraDataRecTemperature>::RawToInt(LoraDataRecField<kLoraDataRecTemperature>::Get(pGen0)));
+        iHumidityDelta    = (int)LoraDataRecField<kLoraDataRecHumidity>::Get(pGenN) - (int)LoraDataRecField<kLoraDataRecHumidity>::Get(pGen0);
+
+        LoraDeltaRecField<kLoraDeltaRecUptimeAge       >::Put(pDeltaRec, ui32UptimeAge);
+        LoraDeltaRecField<kLoraDeltaRecTemperatureDelta>::Put(pDeltaRec, LimitDelta(iTemperatureDelta, LoraDeltaRecField<kLoraDeltaRecTemperatureDelta>::BITS, &fClipped));
+        LoraDeltaRecField<kLoraDeltaRecHumidityDelta   >::Put(pDeltaRec, LimitDelta(iHumidityDelta,    LoraDeltaRecField<kLoraDeltaRecHumidityDelta>::BITS,    &fClipped));
+        LoraDeltaRecField<kLoraDeltaRecMotionActive    >::Put(pDeltaRec, LoraDataRecField<kLoraDataRecMotionActive    >::Get(pGenN));
+        LoraDeltaRecField<kLoraDeltaRecMotionActiveTime>::Put(pDeltaRec, LoraDataRecField<kLoraDataRecMotionActiveTime>::Get(pGenN));
+        LoraDeltaRecField<kLoraDeltaRecLightLevel      >::Put(pDeltaRec, LoraDataRecField<kLoraDataRecLightLevel      >::Get(pGenN));
+        LoraDeltaRecField<kLoraDeltaRecCarBattLevel    >::Put(pDeltaRec, LoraDataRecField<kLoraDataRecCarBattLevel    >::Get(pGenN));
+
+        // MotionActiveCount is a 10 Bit counter that only increments
+        ui32MotionCountDelta = ((LoraDataRecField<kLoraDataRecMotionActiveCount>::Get(pGen0) - LoraDataRecField<kLoraDataRecMotionActiveCount>::Get(pGenN)) & 0x03FF);
+        if (ui32MotionCountDelta > 0xFF)
+        {
+            ui32MotionCountDelta = 0xFF;
+            fClipped = true;
+        }
+        LoraDeltaRecField<kLoraDeltaRecMotionCountDelta>::Put(pDeltaRec, ui32MotionCountDelta);
+
+        LoraDeltaRecField<kLoraDeltaRecClipped>::Put(pDeltaRec, (fClipped ? 1 : 0));
     }
+    uiNumGen = uiGen;
 
-    iDataValue = (int)round(flDataValue_p);         // float -> int
-    i8DataValue = (int8_t)(iDataValue & 0x7F);      // mask Signum + B5..B0
+    LoraPutCrc16(m_TxLoraDataDeltaPacket.m_abDeltaCRC16, CalcCrc16(m_TxLoraDataDeltaPacket.m_aLoraDeltaRec, ((uiNumGen - 1) * sizeof(tLoraDataDeltaRec))));
+    m_uiTxDataDeltaPacketSize = LORA_DATA_DELTA_PACKET_SIZE(uiNumGen);
 
-    return (i8DataValue);
+    return;
 
 }
 
 
 
 //---------------------------------------------------------------------------
-//  Private: FloatToI8
+//  Private: EncodeTxDataCompactPacket
 //---------------------------------------------------------------------------
 
-int8_t  LoraPayloadEncoder::FloatToI8 (float flDataValue_p)
+void  LoraPayloadEncoder::EncodeTxDataCompactPacket (void)
 {
 
-int     iDataValue;
-int8_t  i8DataValue;
-
-
-    //   B7  B6  B5  B4  B3  B2  B1  B0
-    // +---+---+---+---+---+---+---+---+
-    // | S |       -127 ... +127       |
-    // +---+---+---+---+---+---+---+---+
-    //
-    //   0   1   1   1   1   1   1   1      +127
-    //                ...
-    //   0   0   0   0   0   0   0   1        +1
-    //   0   0   0   0   0   0   0   0         0
-    //   1   1   1   1   1   1   1   1        -1
-    //                ...
-    //   1   0   0   0   0   0   0   1      -127
-
-    // limit values to mappable range
-    if (flDataValue_p > 127.0f)
+const tLoraDataRec*       pGen0;
+const tLoraDataDeltaRec*  pDeltaRec;
+uint8_t*                  pabStream;
+unsigned int              uiNumGen;
+unsigned int              uiGen;
+unsigned int              uiBitPos;
+unsigned int              uiStreamSize;
+uint16_t                  ui16CrcSum;
+
+
+    // setup Header of LoRa Compact Data Packet (same content as classic Data Packet, different PacketType)
+    m_TxLoraDataCompactPacket.m_LoraHeader = m_TxLoraDataPacket.m_LoraHeader;
+    LoraDataHeaderField<kLoraHeaderPacketType>::Put(&m_TxLoraDataCompactPacket.m_LoraHeader, kLoraPacketDataHeaderCompact);
+    LoraPutCrc16(m_TxLoraDataCompactPacket.m_LoraHeader.m_abCRC16, CalcCrc16(&m_TxLoraDataCompactPacket.m_LoraHeader, (64/8)));
+
+    // same generations as in Delta Data Packet (limited by history and UptimeAge)
+    uiNumGen = 1 + ((m_uiTxDataDeltaPacketSize - LORA_DATA_DELTA_PACKET_SIZE(1)) / sizeof(tLoraDataDeltaRec));
+    m_TxLoraDataCompactPacket.m_ui8Layout = (uint8_t)((m_ui8SensorLayout & LORA_DATA_LAYOUT_SENSOR_MASK) | ((uiNumGen - 1) << 4));
+
+    pabStream = m_TxLoraDataCompactPacket.m_abRecStream;
+    memset(pabStream, 0x00, sizeof(m_TxLoraDataCompactPacket.m_abRecStream));
+    uiBitPos = 0;
+
+    // Gen0 (absolute values)
+    pGen0 = &m_TxLoraDataDeltaPacket.m_LoraDataRecGen0;
+    PutField< LoraDataRecField<kLoraDataRecUptimeSnippet> >(pabStream, &uiBitPos, pGen0);
+    if (m_ui8SensorLayout & LORA_DATA_LAYOUT_DHT_SENSOR)
     {
-        flDataValue_p = 127.0f;
+        PutField< LoraDataRecField<kLoraDataRecTemperature      > >(pabStream, &uiBitPos, pGen0);
+        PutField< LoraDataRecField<kLoraDataRecHumidity         > >(pabStream, &uiBitPos, pGen0);
     }
-    if (flDataValue_p < -127.0f)
+    if (m_ui8SensorLayout & LORA_DATA_LAYOUT_SR501_SENSOR)
+    {
+        PutField< LoraDataRecField<kLoraDataRecMotionActive     > >(pabStream, &uiBitPos, pGen0);
+        PutField< LoraDataRecField<kLoraDataRecMotionActiveTime > >(pabStream, &uiBitPos, pGen0);
+        PutField< LoraDataRecField<kLoraDataRecMotionActiveCount> >(pabStream, &uiBitPos, pGen0);
+    }
+    if (m_ui8SensorLayout & LORA_DATA_LAYOUT_ADC_LIGHT)
+    {
+        PutField< LoraDataRecField<kLoraDataRecLightLevel       > >(pabStream, &uiBitPos, pGen0);
+    }
+    if (m_ui8SensorLayout & LORA_DATA_LAYOUT_ADC_CAR_BATT)
+    {
+        PutField< LoraDataRecField<kLoraDataRecCarBattLevel     > >(pabStream, &uiBitPos, pGen0);
+    }
+
+    // Gen1..GenN (DeltaRecords relative to Gen0)
+    for (uiGen=1; uiGen<uiNumGen; uiGen++)
     {
-        flDataValue_p = -127.0f;
+        pDeltaRec = &m_TxLoraDataDeltaPacket.m_aLoraDeltaRec[uiGen-1];
+        PutField< LoraDeltaRecField<kLoraDeltaRecUptimeAge> >(pabStream, &uiBitPos, pDeltaRec);
+        if (m_ui8SensorLayout & LORA_DATA_LAYOUT_DHT_SENSOR)
+        {
+            PutField< LoraDeltaRecField<kLoraDeltaRecTemperatureDelta> >(pabStream, &uiBitPos, pDeltaRec);
+            PutField< LoraDeltaRecField<kLoraDeltaRecHumidityDelta   > >(pabStream, &uiBitPos, pDeltaRec);
+        }
+        if (m_ui8SensorLayout & LORA_DATA_LAYOUT_SR501_SENSOR)
+        {
+            PutField< LoraDeltaRecField<kLoraDeltaRecMotionActive    > >(pabStream, &uiBitPos, pDeltaRec);
+            PutField< LoraDeltaRecField<kLoraDeltaRecMotionActiveTime> >(pabStream, &uiBitPos, pDeltaRec);
+            PutField< LoraDeltaRecField<kLoraDeltaRecMotionCountDelta> >(pabStream, &uiBitPos, pDeltaRec);
+        }
+        if (m_ui8SensorLayout & LORA_DATA_LAYOUT_ADC_LIGHT)
+        {
+            PutField< LoraDeltaRecField<kLoraDeltaRecLightLevel      > >(pabStream, &uiBitPos, pDeltaRec);
+        }
+        if (m_ui8SensorLayout & LORA_DATA_LAYOUT_ADC_CAR_BATT)
+        {
+            PutField< LoraDeltaRecField<kLoraDeltaRecCarBattLevel    > >(pabStream, &uiBitPos, pDeltaRec);
+        }
+        PutField< LoraDeltaRecField<kLoraDeltaRecClipped> >(pabStream, &uiBitPos, pDeltaRec);
     }
 
-    iDataValue = (int)round(flDataValue_p);         // float -> int
-    i8DataValue = (int8_t)(iDataValue & 0xFF);      // mask Signum + B6..B0
+    // CRC16 over Layout Byte and Bit Stream, appended little-endian
+    uiStreamSize = (uiBitPos + 7) / 8;
+    ui16CrcSum = CalcCrc16(&m_TxLoraDataCompactPacket.m_ui8Layout, (sizeof(uint8_t) + uiStreamSize));
+    LoraPutCrc16(&pabStream[uiStreamSize], ui16CrcSum);
+
+    m_uiTxDataCompactPacketSize = LORA_DATA_COMPACT_PACKET_SIZE(m_ui8SensorLayout, uiNumGen);
 
-    return (i8DataValue);
+    return;
 
 }
 
 
 
 //---------------------------------------------------------------------------
-//  Private: FloatToUI7
+//  Private: LimitDelta
 //---------------------------------------------------------------------------
 
-int8_t  LoraPayloadEncoder::FloatToUI7 (float flDataValue_p)
+uint8_t  LoraPayloadEncoder::LimitDelta (int iDelta_p, unsigned int uiBits_p, bool* pfClipped_p)
 {
 
-uint     uiDataValue;
-uint8_t  ui8DataValue;
+int  iMax;
+int  iMin;
 
 
-    //   B7  B6  B5  B4  B3  B2  B1  B0
-    // +---+---+---+---+---+---+---+---+
-    // | - |        0 ... +127         |
-    // +---+---+---+---+---+---+---+---+
-    //
-    //       1   1   1   1   1   1   1      +127
-    //                ...
-    //       0   0   0   0   0   0   1        +1
-    //       0   0   0   0   0   0   0         0
+    // two's complement with <uiBits_p> Bits, e.g. 6 Bit -> -32..31
+    iMax = (1 << (uiBits_p - 1)) - 1;
+    iMin = -(1 << (uiBits_p - 1));
 
-    // limit values to mappable range
-    if (flDataValue_p > 127.0f)
+    if (iDelta_p > iMax)
     {
-        flDataValue_p = 127.0f;
+        iDelta_p = iMax;
+        *pfClipped_p = true;
     }
-    if (flDataValue_p < 0.0f)
+    if (iDelta_p < iMin)
     {
-        flDataValue_p = 0.0f;
+        iDelta_p = iMin;
+        *pfClipped_p = true;
     }
 
-    uiDataValue  = (uint)round(flDataValue_p);      // float -> uint
-    ui8DataValue = (uint8_t)(uiDataValue & 0x7F);   // mask B6..B0
-
-    return (ui8DataValue);
+    return ((uint8_t)(iDelta_p & ((1 << uiBits_p) - 1)));
 
 }
 
 
 
 //---------------------------------------------------------------------------
-//  Private: FloatToUI8
+//  Private: PutBits
 //---------------------------------------------------------------------------
+//  Appends <uiBits_p> Bits of <ui32Value_p> to a little-endian Bit Stream (LSB
+//  first), the Stream must be cleared before
 
-int8_t  LoraPayloadEncoder::FloatToUI8 (float flDataValue_p)
+void  LoraPayloadEncoder::PutBits (uint8_t* pabStream_p, unsigned int* puiBitPos_p, uint32_t ui32Value_p, unsigned int uiBits_p)
 {
 
-uint    uiDataValue;
-int8_t  ui8DataValue;
-
+unsigned int  uiBit;
+unsigned int  uiBitPos;
 
-    //   B7  B6  B5  B4  B3  B2  B1  B0
-    // +---+---+---+---+---+---+---+---+
-    // |          0 ... +255           |
-    // +---+---+---+---+---+---+---+---+
-    //
-    //   1   1   1   1   1   1   1   1      +255
-    //                ...
-    //   0   0   0   0   0   0   0   1        +1
-    //   0   0   0   0   0   0   0   0         0
 
-    // limit values to mappable range
-    if (flDataValue_p > 255.0f)
-    {
-        flDataValue_p = 255.0f;
-    }
-    if (flDataValue_p < 0.0f)
+    uiBitPos = *puiBitPos_p;
+    for (uiBit=0; uiBit<uiBits_p; uiBit++)
     {
-        flDataValue_p = 0.0f;
+        if (ui32Value_p & (1UL << uiBit))
+        {
+            pabStream_p[uiBitPos >> 3] |= (uint8_t)(1 << (uiBitPos & 0x07));
+        }
+        uiBitPos++;
     }
+    *puiBitPos_p = uiBitPos;
 
-    uiDataValue  = (uint)round(flDataValue_p);      // float -> uint
-    ui8DataValue = (uint8_t)(uiDataValue & 0xFF);   // mask B7..B0
-
-    return (ui8DataValue);
+    return;
 
 }
 
@@ -10,6 +10,11 @@
   Revision History:
 
   2023/03/25 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Save/Restore of State for Deep Sleep
+  2026/10/18 -rs:   V1.02 Delta Data Packet with configurable Generation Depth
+  2026/10/18 -rs:   V1.03 Compact Data Packet with Record Layout derived from
+                          Sensor Configuration
+  2026/10/18 -rs:   V1.04 Field access and scaling generated from <LoraPacketSchema.h>
 
 ****************************************************************************/
 
@@ -47,6 +52,8 @@ class  LoraPayloadEncoder
 
     public:
 
+        static const unsigned int   GEN_DEPTH_CLASSIC   = 3;            // Gen0/Gen1/Gen2, used by Compact Data Packet if no Generation Depth is set
+
         // data used to build-up LoRa packet substructure <tLoraBootupHeader>
         typedef struct
         {
@@ -82,6 +89,26 @@ class  LoraPayloadEncoder
         } tSensorDataRec;
 
 
+        // entry of Generation History used to build-up <tLoraDataDeltaPacket>
+        typedef struct
+        {
+            uint32_t        m_ui32Uptime;                               // [sec]
+            tLoraDataRec    m_LoraDataRec;                              // generation encoded as Gen0
+
+        } tDataRecHist;
+
+
+        // state to be retained in RTC Memory during Deep Sleep
+        typedef struct
+        {
+            uint32_t        m_ui32SequNum;
+            tLoraDataPacket m_TxLoraDataPacket;                         // incl. Generation History Gen0/Gen1/Gen2
+            tDataRecHist    m_aDataRecHist[LORA_DATA_GEN_DEPTH_MAX];    // Generation History for Delta Data Packet
+            uint8_t         m_ui8DataRecHistCount;
+
+        } tRetainState;
+
+
 
     //-----------------------------------------------------------------------
     //  Private Attributes
@@ -93,6 +120,15 @@ class  LoraPayloadEncoder
         uint32_t        m_ui32SequNum;
         tLoraDataPacket m_TxLoraBootupPacket;
         tLoraDataPacket m_TxLoraDataPacket;
+        unsigned int    m_uiGenDepth;                                   // 0 = classic Data Packet, 1..LORA_DATA_GEN_DEPTH_MAX = Delta Data Packet
+        tDataRecHist    m_aDataRecHist[LORA_DATA_GEN_DEPTH_MAX];
+        unsigned int    m_uiDataRecHistCount;
+        tLoraDataDeltaPacket  m_TxLoraDataDeltaPacket;
+        unsigned int    m_uiTxDataDeltaPacketSize;
+        bool            m_fCompactLayout;                               // true = Compact Data Packet
+        uint8_t         m_ui8SensorLayout;                              // LORA_DATA_LAYOUT_xxx
+        tLoraDataCompactPacket  m_TxLoraDataCompactPacket;
+        unsigned int    m_uiTxDataCompactPacketSize;
         char            m_szLogDeviceConfig[1024];
         char            m_szLogSensorDataRec[1024];
 
@@ -108,10 +144,16 @@ class  LoraPayloadEncoder
         ~LoraPayloadEncoder();
 
         void              Setup(uint8_t ui8DevID_p);
+        int               SetupGenerationDepth(unsigned int uiGenDepth_p);
+        int               SetupCompactLayout(bool fEnable_p, uint8_t ui8SensorLayout_p);
         int               EncodeTxBootupPacket(const tDeviceConfig* pDeviceConfig_p);
         tLoraDataPacket*  GetTxBootupPacket(void);
         int               EncodeTxDataPacket(const tSensorDataRec* pSensorDataRec_p);
         tLoraDataPacket*  GetTxDataPacket(void);
+        const void*       GetTxDataPayload(unsigned int* puiPayloadSize_p);
+        unsigned int      GetTxDataPayloadMaxSize(void);
+        void              SaveState(tRetainState* pRetainState_p);
+        void              RestoreState(const tRetainState* pRetainState_p);
 
         const char*       LogDeviceConfig(const tDeviceConfig* pDeviceConfig_p);
         const char*       LogSensorDataRec(const tSensorDataRec* pSensorDataRec_p);
@@ -124,13 +166,21 @@ class  LoraPayloadEncoder
 
     private:
 
-        int8_t    FloatToI7(float flDataValue_p);
-        int8_t    FloatToI8(float flDataValue_p);
-        int8_t    FloatToUI7(float flDataValue_p);
-        int8_t    FloatToUI8(float flDataValue_p);
+        unsigned int  GetGenDepth(void);
+        void      EncodeTxDataDeltaPacket(void);
+        void      EncodeTxDataCompactPacket(void);
+        uint8_t   LimitDelta(int iDelta_p, unsigned int uiBits_p, bool* pfClipped_p);
+        void      PutBits(uint8_t* pabStream_p, unsigned int* puiBitPos_p, uint32_t ui32Value_p, unsigned int uiBits_p);
         uint16_t  CalcCrc16(const void* pDataBlock_p, unsigned int uiDataBlockSize_p);
         size_t    LogStr(char* pszLogBuff_p, size_t nLogBuffSize_p, const char* pszFmt_p, ...);
 
+        // appends the field <tField> (LoraField<>) of record <pRec_p> to the Bit Stream
+        template <class tField>
+        void      PutField(uint8_t* pabStream_p, unsigned int* puiBitPos_p, const void* pRec_p)
+        {
+            PutBits(pabStream_p, puiBitPos_p, tField::Get(pRec_p), tField::BITS);
+        }
+
 };
 
 
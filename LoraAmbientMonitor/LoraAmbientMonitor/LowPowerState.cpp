@@ -0,0 +1,374 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Ambient Monitor
+  Description:  Class <LowPowerState> Implementation
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+
+#include "Arduino.h"
+#include "LoraPacket.h"
+#include "LoraPayloadEncoder.h"
+#include "LoraTransmitter.h"
+#include "LowPowerState.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          CLASS  LowPowerState                                           */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+/////////////////////////////////////////////////////////////////////////////
+//                                                                         //
+//          P R I V A T E   A T T R I B U T E S                            //
+//                                                                         //
+/////////////////////////////////////////////////////////////////////////////
+
+
+
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//                                                                         //
+//          C O N S T R U C T O R   /   D E S T R U C T O R                //
+//                                                                         //
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+//  Constructor
+//---------------------------------------------------------------------------
+
+LowPowerState::LowPowerState()
+{
+
+    memset(&m_PowerModel, 0x00, sizeof(m_PowerModel));
+    memset(&m_PowerStat, 0x00, sizeof(m_PowerStat));
+    m_ui32SysTickOffset = 0;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Destructor
+//---------------------------------------------------------------------------
+
+LowPowerState::~LowPowerState()
+{
+
+    return;
+
+}
+
+
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//                                                                         //
+//          P U B L I C    M E T H O D E N                                 //
+//                                                                         //
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+//  Setup
+//---------------------------------------------------------------------------
+
+void  LowPowerState::Setup (const tPowerModel* pPowerModel_p)
+{
+
+    m_PowerModel = *pPowerModel_p;
+    m_ui32SysTickOffset = 0;
+    StartCycle();
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  GetSysTick [ms] (continues across Deep Sleep)
+//---------------------------------------------------------------------------
+
+uint32_t  LowPowerState::GetSysTick (void)
+{
+
+    return ((uint32_t)millis() + m_ui32SysTickOffset);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  StartCycle (start Energy Budget of next LoRa Transmit Cycle)
+//---------------------------------------------------------------------------
+
+void  LowPowerState::StartCycle (void)
+{
+
+    memset(&m_PowerStat, 0x00, sizeof(m_PowerStat));
+    m_PowerStat.m_ui32CycleStartTick = GetSysTick();
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  AddLightSleepTime / AddLoraTxTime
+//---------------------------------------------------------------------------
+
+void  LowPowerState::AddLightSleepTime (uint32_t ui32SleepTime_p)
+{
+
+    m_PowerStat.m_ui32LightSleepTime += ui32SleepTime_p;
+    m_PowerStat.m_ui32WakeupCount++;
+
+    return;
+
+}
+
+//---------------------------------------------------------------------------
+
+void  LowPowerState::AddLoraTxTime (uint32_t ui32TxTime_p)
+{
+
+    m_PowerStat.m_ui32LoraTxTime += ui32TxTime_p;
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  GetEnergyBudget (of the current LoRa Transmit Cycle until now)
+//---------------------------------------------------------------------------
+
+void  LowPowerState::GetEnergyBudget (tEnergyBudget* pEnergyBudget_p)
+{
+
+    CalcCharge(&m_PowerStat, GetSysTick() - m_PowerStat.m_ui32CycleStartTick, pEnergyBudget_p);
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  SaveState (before entering Deep Sleep)
+//---------------------------------------------------------------------------
+
+void  LowPowerState::SaveState (tRetainState* pRetainState_p, uint32_t ui32RtcTick_p, LoraPayloadEncoder* pLoraPayloadEnc_p, LoraTransmitter* pLoraTransmitter_p)
+{
+
+    pRetainState_p->m_ui32SysTickAtSleep = GetSysTick();
+    pRetainState_p->m_ui32RtcTickAtSleep = ui32RtcTick_p;
+    pRetainState_p->m_PowerStat          = m_PowerStat;
+
+    pLoraPayloadEnc_p->SaveState(&pRetainState_p->m_LoraPayloadEncState);
+    pLoraTransmitter_p->SaveState(&pRetainState_p->m_LoraTransmitterState);
+
+    pRetainState_p->m_ui32Magic = RETAIN_STATE_MAGIC;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  RestoreState (after Wakeup from Deep Sleep, returns Sleep Time [ms])
+//---------------------------------------------------------------------------
+
+uint32_t  LowPowerState::RestoreState (tRetainState* pRetainState_p, uint32_t ui32RtcTick_p, LoraPayloadEncoder* pLoraPayloadEnc_p, LoraTransmitter* pLoraTransmitter_p)
+{
+
+uint32_t  ui32ElapsedTime;
+uint32_t  ui32BootTime;
+
+
+    // The RTC keeps running during Deep Sleep, <ui32ElapsedTime> also
+    // contains the boot time after the wakeup (= current millis()); if the
+    // RTC was set back in the meantime, only the boot time is accounted
+    ui32ElapsedTime = ui32RtcTick_p - pRetainState_p->m_ui32RtcTickAtSleep;
+    ui32BootTime = (uint32_t)millis();
+    if ((int32_t)ui32ElapsedTime < (int32_t)ui32BootTime)
+    {
+        ui32ElapsedTime = ui32BootTime;
+    }
+    m_ui32SysTickOffset = (pRetainState_p->m_ui32SysTickAtSleep + ui32ElapsedTime) - ui32BootTime;
+
+    m_PowerStat = pRetainState_p->m_PowerStat;
+    m_PowerStat.m_ui32DeepSleepTime += ui32ElapsedTime - ui32BootTime;
+    m_PowerStat.m_ui32WakeupCount++;
+
+    pLoraPayloadEnc_p->RestoreState(&pRetainState_p->m_LoraPayloadEncState);
+    pLoraTransmitter_p->RestoreState(&pRetainState_p->m_LoraTransmitterState, ui32ElapsedTime);
+
+    // the retained State is consumed, a Reset during the next wake phase must not restore it again
+    pRetainState_p->m_ui32Magic = 0;
+
+    return (ui32ElapsedTime - ui32BootTime);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  EstimateEnergyBudget (Model of a LoRa Transmit Cycle)
+//---------------------------------------------------------------------------
+
+//  The CPU wakes up every <ui32WakeupPeriod_p> and is active for
+//  <ui32ActiveTime_p> (plus the Wakeup/Boot Time of the Sleep Mode), once
+//  per Cycle the LoRa Radio transmits for <ui32LoraTxTime_p>. The remaining
+//  time of the Cycle is spent in the selected Sleep Mode.
+
+void  LowPowerState::EstimateEnergyBudget (int iSleepMode_p, uint32_t ui32CycleTime_p, uint32_t ui32WakeupPeriod_p,
+                                           uint32_t ui32ActiveTime_p, uint32_t ui32LoraTxTime_p, tEnergyBudget* pEnergyBudget_p)
+{
+
+tPowerStat  PowerStat;
+uint32_t    ui32WakeupTime;
+uint32_t    ui32ActiveTime;
+uint32_t    ui32SleepTime;
+
+
+    memset(&PowerStat, 0x00, sizeof(PowerStat));
+    PowerStat.m_ui32LoraTxTime = ui32LoraTxTime_p;
+
+    if ((iSleepMode_p != SLEEP_MODE_NONE) && (ui32WakeupPeriod_p > 0))
+    {
+        ui32WakeupTime = (iSleepMode_p == SLEEP_MODE_DEEP) ? m_PowerModel.m_ui32DeepSleepBootTime : m_PowerModel.m_ui32LightSleepWakeupTime;
+        PowerStat.m_ui32WakeupCount = ui32CycleTime_p / ui32WakeupPeriod_p;
+        ui32ActiveTime = PowerStat.m_ui32WakeupCount * (ui32WakeupTime + ui32ActiveTime_p);
+
+        ui32SleepTime = 0;
+        if (ui32CycleTime_p > (ui32ActiveTime + ui32LoraTxTime_p))
+        {
+            ui32SleepTime = ui32CycleTime_p - ui32ActiveTime - ui32LoraTxTime_p;
+        }
+        if (iSleepMode_p == SLEEP_MODE_DEEP)
+        {
+            PowerStat.m_ui32DeepSleepTime = ui32SleepTime;
+        }
+        else
+        {
+            PowerStat.m_ui32LightSleepTime = ui32SleepTime;
+        }
+    }
+
+    CalcCharge(&PowerStat, ui32CycleTime_p, pEnergyBudget_p);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  EstimateWakeupLatency [ms] (Motion Edge until end of LoRa Transmission)
+//---------------------------------------------------------------------------
+
+//  Without Sleep the Motion Sensor is polled every <ui32PollPeriod_p>, in
+//  both Sleep Modes it wakes up the CPU, which then needs the Wakeup or Boot
+//  Time of the Sleep Mode. The asynchronous Transmit Event triggers the LoRa
+//  Transmit Task immediately, so the Time-on-Air is added without further delay
+//  (Inhibit Time and Duty Cycle Budget not considered).
+
+uint32_t  LowPowerState::EstimateWakeupLatency (int iSleepMode_p, uint32_t ui32PollPeriod_p, uint32_t ui32LoraTxTime_p)
+{
+
+uint32_t  ui32Latency;
+
+
+    switch (iSleepMode_p)
+    {
+        case SLEEP_MODE_LIGHT:  ui32Latency = m_PowerModel.m_ui32LightSleepWakeupTime;  break;
+        case SLEEP_MODE_DEEP:   ui32Latency = m_PowerModel.m_ui32DeepSleepBootTime;     break;
+        default:                ui32Latency = ui32PollPeriod_p;                         break;
+    }
+
+    return (ui32Latency + ui32LoraTxTime_p);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  IsRetainStateValid
+//---------------------------------------------------------------------------
+
+bool  LowPowerState::IsRetainStateValid (const tRetainState* pRetainState_p)
+{
+
+    return (pRetainState_p->m_ui32Magic == RETAIN_STATE_MAGIC);
+
+}
+
+
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//                                                                         //
+//          P R I V A T E    M E T H O D E N                               //
+//                                                                         //
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+//  Private: CalcCharge
+//---------------------------------------------------------------------------
+
+void  LowPowerState::CalcCharge (const tPowerStat* pPowerStat_p, uint32_t ui32CycleTime_p, tEnergyBudget* pEnergyBudget_p)
+{
+
+uint32_t  ui32SleepTime;
+
+
+    pEnergyBudget_p->m_ui32CycleTime      = ui32CycleTime_p;
+    pEnergyBudget_p->m_ui32LoraTxTime     = pPowerStat_p->m_ui32LoraTxTime;
+    pEnergyBudget_p->m_ui32LightSleepTime = pPowerStat_p->m_ui32LightSleepTime;
+    pEnergyBudget_p->m_ui32DeepSleepTime  = pPowerStat_p->m_ui32DeepSleepTime;
+    pEnergyBudget_p->m_ui32WakeupCount    = pPowerStat_p->m_ui32WakeupCount;
+
+    ui32SleepTime = pPowerStat_p->m_ui32LightSleepTime + pPowerStat_p->m_ui32DeepSleepTime;
+    pEnergyBudget_p->m_ui32ActiveTime = 0;
+    if (ui32CycleTime_p > (ui32SleepTime + pPowerStat_p->m_ui32LoraTxTime))
+    {
+        pEnergyBudget_p->m_ui32ActiveTime = ui32CycleTime_p - ui32SleepTime - pPowerStat_p->m_ui32LoraTxTime;
+    }
+
+    // [mA] * [ms] / 3600 = [uAh]
+    pEnergyBudget_p->m_flCharge = ((m_PowerModel.m_flCurrentActive     * (float)pEnergyBudget_p->m_ui32ActiveTime) +
+                                   (m_PowerModel.m_flCurrentLoraTx     * (float)pPowerStat_p->m_ui32LoraTxTime) +
+                                   (m_PowerModel.m_flCurrentLightSleep * (float)pPowerStat_p->m_ui32LightSleepTime) +
+                                   (m_PowerModel.m_flCurrentDeepSleep  * (float)pPowerStat_p->m_ui32DeepSleepTime)) / 3600.0f;
+
+    pEnergyBudget_p->m_flAvgCurrent = (ui32CycleTime_p > 0) ? ((pEnergyBudget_p->m_flCharge * 3600.0f) / (float)ui32CycleTime_p) : 0.0f;
+
+    return;
+
+}
+
+
+
+//  EOF
@@ -0,0 +1,173 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Ambient Monitor
+  Description:  Class <LowPowerState> Declaration
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _LOWPOWERSTATE_H_
+#define _LOWPOWERSTATE_H_
+
+#include <stdint.h>
+
+
+
+
+
+//---------------------------------------------------------------------------
+//  Type Definitions
+//---------------------------------------------------------------------------
+
+
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          CLASS  LowPowerState                                           */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//  State of the Low Power Mode: SysTick continued across Deep Sleep, Energy
+//  Budget of the current LoRa Transmit Cycle and the State of <LoraPayloadEncoder>
+//  and <LoraTransmitter> retained in RTC Memory. The Class only uses millis(),
+//  RTC Tick and Sleep Hardware are handled by the Application, so the Class
+//  can also be built on a Host to check the continuity across a Deep Sleep and
+//  the Energy and Latency Model. "LoraPayloadEncoder.h" and "LoraTransmitter.h"
+//  have to be included before.
+
+class  LowPowerState
+{
+
+    //-----------------------------------------------------------------------
+    //  Definitions
+    //-----------------------------------------------------------------------
+
+    public:
+
+        static const uint32_t   RETAIN_STATE_MAGIC  = 0x4C414D31;       // 'LAM1', marks a valid State in RTC Memory
+
+        static const int        SLEEP_MODE_NONE     = 0;                // CPU is waiting by delay()
+        static const int        SLEEP_MODE_LIGHT    = 1;
+        static const int        SLEEP_MODE_DEEP     = 2;
+
+        // estimated Supply Currents and Wakeup Times of the Hardware
+        typedef struct
+        {
+            float       m_flCurrentActive;                              // [mA] CPU active, LoRa Radio idle
+            float       m_flCurrentLoraTx;                              // [mA] CPU active, LoRa Radio transmitting
+            float       m_flCurrentLightSleep;                          // [mA] CPU in Light Sleep, LoRa Radio sleeping
+            float       m_flCurrentDeepSleep;                           // [mA] CPU in Deep Sleep, incl. Sensors and Voltage Regulator
+            uint32_t    m_ui32LightSleepWakeupTime;                     // [ms] Wakeup from Light Sleep until the first Task runs
+            uint32_t    m_ui32DeepSleepBootTime;                        // [ms] Wakeup from Deep Sleep until the State is restored in setup()
+
+        } tPowerModel;
+
+
+        // Energy Budget of current LoRa Transmit Cycle
+        typedef struct
+        {
+            uint32_t    m_ui32CycleStartTick;                           // [ms] SysTick
+            uint32_t    m_ui32LightSleepTime;                           // [ms]
+            uint32_t    m_ui32DeepSleepTime;                            // [ms]
+            uint32_t    m_ui32LoraTxTime;                               // [ms]
+            uint32_t    m_ui32WakeupCount;
+
+        } tPowerStat;
+
+
+        typedef struct
+        {
+            uint32_t    m_ui32CycleTime;                                // [ms]
+            uint32_t    m_ui32ActiveTime;                               // [ms] CPU active without LoRa Tx
+            uint32_t    m_ui32LoraTxTime;                               // [ms]
+            uint32_t    m_ui32LightSleepTime;                           // [ms]
+            uint32_t    m_ui32DeepSleepTime;                            // [ms]
+            uint32_t    m_ui32WakeupCount;
+            float       m_flCharge;                                     // [uAh]
+            float       m_flAvgCurrent;                                 // [mA]
+
+        } tEnergyBudget;
+
+
+        // state to be retained in RTC Memory during Deep Sleep
+        typedef struct
+        {
+            uint32_t    m_ui32Magic;
+            uint32_t    m_ui32SysTickAtSleep;                           // [ms]
+            uint32_t    m_ui32RtcTickAtSleep;                           // [ms]
+            tPowerStat  m_PowerStat;
+            LoraPayloadEncoder::tRetainState    m_LoraPayloadEncState;
+            LoraTransmitter::tRetainState       m_LoraTransmitterState;
+
+        } tRetainState;
+
+
+
+    //-----------------------------------------------------------------------
+    //  Private Attributes
+    //-----------------------------------------------------------------------
+
+    private:
+
+        tPowerModel     m_PowerModel;
+        tPowerStat      m_PowerStat;
+        uint32_t        m_ui32SysTickOffset;                            // SysTick = millis() + Offset, continues across Deep Sleep
+
+
+
+    //-----------------------------------------------------------------------
+    //  Public Methodes
+    //-----------------------------------------------------------------------
+
+    public:
+
+        LowPowerState();
+        ~LowPowerState();
+
+        void        Setup(const tPowerModel* pPowerModel_p);
+        uint32_t    GetSysTick(void);
+        void        StartCycle(void);
+        void        AddLightSleepTime(uint32_t ui32SleepTime_p);
+        void        AddLoraTxTime(uint32_t ui32TxTime_p);
+        void        GetEnergyBudget(tEnergyBudget* pEnergyBudget_p);
+
+        void        SaveState(tRetainState* pRetainState_p, uint32_t ui32RtcTick_p, LoraPayloadEncoder* pLoraPayloadEnc_p, LoraTransmitter* pLoraTransmitter_p);
+        uint32_t    RestoreState(tRetainState* pRetainState_p, uint32_t ui32RtcTick_p, LoraPayloadEncoder* pLoraPayloadEnc_p, LoraTransmitter* pLoraTransmitter_p);
+
+        void        EstimateEnergyBudget(int iSleepMode_p, uint32_t ui32CycleTime_p, uint32_t ui32WakeupPeriod_p,
+                                         uint32_t ui32ActiveTime_p, uint32_t ui32LoraTxTime_p, tEnergyBudget* pEnergyBudget_p);
+        uint32_t    EstimateWakeupLatency(int iSleepMode_p, uint32_t ui32PollPeriod_p, uint32_t ui32LoraTxTime_p);
+
+        static bool IsRetainStateValid(const tRetainState* pRetainState_p);
+
+
+
+    //-----------------------------------------------------------------------
+    //  Private Methodes
+    //-----------------------------------------------------------------------
+
+    private:
+
+        void        CalcCharge(const tPowerStat* pPowerStat_p, uint32_t ui32CycleTime_p, tEnergyBudget* pEnergyBudget_p);
+
+};
+
+
+
+#endif  // _LOWPOWERSTATE_H_
+
+
+
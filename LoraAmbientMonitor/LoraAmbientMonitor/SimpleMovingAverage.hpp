@@ -3,16 +3,88 @@
   Copyright (c) 2022 Ronald Sieber
 
   Project:      Project independent
-  Description:  Implementation of Template Class <SimpleMovingAverage>
+  Description:  Implementation of Template Classes <SimpleMovingAverage>,
+                <FixedMovingAverage> and <ExpMovingAverage>
 
   -------------------------------------------------------------------------
 
   Revision History:
 
   28.01.2022 -rs:   Start of implementation
+  18.10.2026 -rs:   Fix release of SampleWindow (delete[] instead of delete)
+  18.10.2026 -rs:   Add <FixedMovingAverage> (compile-time Window Size, static
+                    buffer, exact Integer Sum) and <ExpMovingAverage>
+  18.10.2026 -rs:   Round negative Fixed-Point Averages symmetrically
+                    (no right shift of negative values), branchless
+                    conversion of Samples
 
 ****************************************************************************/
 
+#include <stdint.h>
+#include <math.h>
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//                                                                         //
+//                                                                         //
+//          F I X E D - P O I N T   R O U N D I N G                        //
+//                                                                         //
+//                                                                         //
+/////////////////////////////////////////////////////////////////////////////
+
+//  Used by <FixedMovingAverage> and <ExpMovingAverage>. Both functions round
+//  half away from zero, so positive and negative Values are rounded
+//  symmetrically. They operate on the unsigned Magnitude: a right shift of
+//  a negative signed Value is implementation-defined (and rounds towards
+//  minus infinity on GCC), and the Magnitude of INT32_MIN doesn't fit into
+//  an int32_t.
+
+//---------------------------------------------------------------------------
+//  Divide by 2^iShift_p and round half away from zero
+//---------------------------------------------------------------------------
+
+inline int32_t  MovAvgRoundShift (int32_t i32Value_p, int iShift_p)
+{
+
+uint32_t  ui32Half;
+
+
+    if (iShift_p == 0)
+    {
+        return (i32Value_p);
+    }
+
+    ui32Half = (uint32_t)1 << (iShift_p - 1);
+    if (i32Value_p >= 0)
+    {
+        return ((int32_t)(((uint32_t)i32Value_p + ui32Half) >> iShift_p));
+    }
+
+    return (-(int32_t)(((0U - (uint32_t)i32Value_p) + ui32Half) >> iShift_p));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Divide by ui32Divisor_p (1...65536) and round half away from zero
+//---------------------------------------------------------------------------
+
+inline int32_t  MovAvgRoundDiv (int32_t i32Value_p, uint32_t ui32Divisor_p)
+{
+
+    if (i32Value_p >= 0)
+    {
+        return ((int32_t)(((uint32_t)i32Value_p + (ui32Divisor_p / 2)) / ui32Divisor_p));
+    }
+
+    return (-(int32_t)(((0U - (uint32_t)i32Value_p) + (ui32Divisor_p / 2)) / ui32Divisor_p));
+
+}
+
+
+
 
 
 /////////////////////////////////////////////////////////////////////////////
@@ -91,7 +163,7 @@ template <class T>  SimpleMovingAverage<T>::SimpleMovingAverage (int iSampleWind
 template <class T>  SimpleMovingAverage<T>::~SimpleMovingAverage ()
 {
 
-    delete m_paSampleWindow;
+    delete[] m_paSampleWindow;
     return;
 
 }
@@ -215,4 +287,482 @@ template <class T>  T  SimpleMovingAverage<T>::GetAverageValue ()
 
 
 
+
+/////////////////////////////////////////////////////////////////////////////
+//                                                                         //
+//                                                                         //
+//          C L A S S   <FixedMovingAverage>                               //
+//                                                                         //
+//                                                                         //
+/////////////////////////////////////////////////////////////////////////////
+
+//  Simple Moving Average with the Window Size as compile-time Parameter.
+//  The SampleWindow is a member array (no heap allocation). Samples are
+//  stored as 16Bit Fixed-Point Values (NewValue_p * VALUE_SCALE, e.g. 0.1
+//  resolution for VALUE_SCALE=10) and summed up in a 32Bit Integer, so the
+//  running Sum is exact over an unlimited number of samples (no rounding
+//  drift as with a floating point Sum). For a Power-of-Two Window Size the
+//  Integer Average is calculated by a Shift instead of a Division.
+
+template <class T, int WINDOW_SIZE, int VALUE_SCALE = 10> class FixedMovingAverage
+{
+
+    static_assert((WINDOW_SIZE > 0) && (WINDOW_SIZE <= 65536), "WINDOW_SIZE out of range (1...65536)");
+    static_assert((VALUE_SCALE > 0), "VALUE_SCALE must be positive");
+
+private:
+
+    // Configuration / Default Definitions
+    static const bool   WINDOW_SIZE_IS_POW2         = ((WINDOW_SIZE & (WINDOW_SIZE - 1)) == 0);
+    static const int    WINDOW_SIZE_SHIFT           = ((WINDOW_SIZE <=    1) ?  0 : (WINDOW_SIZE <=    2) ?  1 :
+                                                       (WINDOW_SIZE <=    4) ?  2 : (WINDOW_SIZE <=    8) ?  3 :
+                                                       (WINDOW_SIZE <=   16) ?  4 : (WINDOW_SIZE <=   32) ?  5 :
+                                                       (WINDOW_SIZE <=   64) ?  6 : (WINDOW_SIZE <=  128) ?  7 :
+                                                       (WINDOW_SIZE <=  256) ?  8 : (WINDOW_SIZE <=  512) ?  9 :
+                                                       (WINDOW_SIZE <= 1024) ? 10 : (WINDOW_SIZE <= 2048) ? 11 :
+                                                       (WINDOW_SIZE <= 4096) ? 12 : (WINDOW_SIZE <= 8192) ? 13 :
+                                                       (WINDOW_SIZE <= 16384) ? 14 : (WINDOW_SIZE <= 32768) ? 15 : 16);
+
+    // Private Attributes
+    int16_t m_ai16SampleWindow[WINDOW_SIZE];    // Fixed-Point Samples (Value * VALUE_SCALE)
+    int32_t m_i32WindowSum;                     // exact Sum of all Samples in SampleWindow
+    T       m_AverageValue;
+    int     m_iSampleWindowIndex;
+    bool    m_fAverageSettled;
+
+    // Private Methods
+    static int16_t  ValueToFixed (T Value_p);
+
+
+public:
+
+    // Constructor/Destructor
+    FixedMovingAverage ();
+
+    // Public Memebers
+    void     Clean ();
+    int      GetSampleWindowSize ();
+    T        CalcMovingAverage (T NewValue_p);
+    T        GetAverageValue ();
+    int32_t  GetAverageFixed ();
+
+};
+
+
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//                                                                         //
+//                                                                         //
+//          C O N S T R U C T I O N   /   D E S T R U C T I O N            //
+//                                                                         //
+//                                                                         //
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+//  Constructor
+//---------------------------------------------------------------------------
+
+template <class T, int WINDOW_SIZE, int VALUE_SCALE>  FixedMovingAverage<T, WINDOW_SIZE, VALUE_SCALE>::FixedMovingAverage ()
+{
+
+    Clean();
+
+    return;
+
+}
+
+
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//                                                                         //
+//                                                                         //
+//          P U B L I C    M E T H O D S                                   //
+//                                                                         //
+//                                                                         //
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+//  Clean
+//---------------------------------------------------------------------------
+
+template <class T, int WINDOW_SIZE, int VALUE_SCALE>  void  FixedMovingAverage<T, WINDOW_SIZE, VALUE_SCALE>::Clean ()
+{
+
+int  iIdx;
+
+
+    for (iIdx=0; iIdx<WINDOW_SIZE; iIdx++)
+    {
+        m_ai16SampleWindow[iIdx] = 0;
+    }
+    m_iSampleWindowIndex = 0;
+    m_i32WindowSum = 0;
+    m_AverageValue = 0;
+
+    m_fAverageSettled = false;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get SampleWindow Size
+//---------------------------------------------------------------------------
+
+template <class T, int WINDOW_SIZE, int VALUE_SCALE>  int  FixedMovingAverage<T, WINDOW_SIZE, VALUE_SCALE>::GetSampleWindowSize ()
+{
+
+    return (WINDOW_SIZE);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Calculate Moving Average
+//---------------------------------------------------------------------------
+
+template <class T, int WINDOW_SIZE, int VALUE_SCALE>  T  FixedMovingAverage<T, WINDOW_SIZE, VALUE_SCALE>::CalcMovingAverage (T NewValue_p)
+{
+
+int16_t  i16NewValue;
+T        AverageValue;
+
+
+    i16NewValue = ValueToFixed(NewValue_p);
+
+    // subtract oldest value from previous sum (still 0 as long as the
+    // SampleWindow is not completely filled), add the new value
+    m_i32WindowSum = m_i32WindowSum - m_ai16SampleWindow[m_iSampleWindowIndex] + i16NewValue;
+
+    // assign new value to the position in the sample window
+    m_ai16SampleWindow[m_iSampleWindowIndex] = i16NewValue;
+
+    // The divisor (WINDOW_SIZE * VALUE_SCALE) is a compile-time constant,
+    // so the compiler replaces the division by a multiplication with its
+    // reciprocal. Until the first complete filling of the SampleWindow the
+    // classic arithmetic average value is calculated.
+    if ( m_fAverageSettled )
+    {
+        AverageValue = (T)m_i32WindowSum * ((T)1 / (T)(WINDOW_SIZE * VALUE_SCALE));
+    }
+    else
+    {
+        AverageValue = (T)m_i32WindowSum / (T)((m_iSampleWindowIndex + 1) * VALUE_SCALE);
+    }
+
+    // shift index pointer to next position
+    m_iSampleWindowIndex++;
+    if (m_iSampleWindowIndex >= WINDOW_SIZE)
+    {
+        m_iSampleWindowIndex = 0;
+        m_fAverageSettled = true;
+    }
+
+    m_AverageValue = AverageValue;
+
+    return (AverageValue);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get last calculated Average Value
+//---------------------------------------------------------------------------
+
+template <class T, int WINDOW_SIZE, int VALUE_SCALE>  T  FixedMovingAverage<T, WINDOW_SIZE, VALUE_SCALE>::GetAverageValue ()
+{
+
+    return (m_AverageValue);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Average Value as rounded Fixed-Point Value (Value * VALUE_SCALE)
+//---------------------------------------------------------------------------
+
+template <class T, int WINDOW_SIZE, int VALUE_SCALE>  int32_t  FixedMovingAverage<T, WINDOW_SIZE, VALUE_SCALE>::GetAverageFixed ()
+{
+
+int32_t  i32Average;
+
+
+    if ( !m_fAverageSettled )
+    {
+        if (m_iSampleWindowIndex == 0)
+        {
+            return (0);
+        }
+        i32Average = MovAvgRoundDiv(m_i32WindowSum, (uint32_t)m_iSampleWindowIndex);
+    }
+    else if ( WINDOW_SIZE_IS_POW2 )
+    {
+        i32Average = MovAvgRoundShift(m_i32WindowSum, WINDOW_SIZE_SHIFT);
+    }
+    else
+    {
+        i32Average = MovAvgRoundDiv(m_i32WindowSum, (uint32_t)WINDOW_SIZE);
+    }
+
+    return (i32Average);
+
+}
+
+
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//                                                                         //
+//                                                                         //
+//          P R I V A T E    M E T H O D S                                 //
+//                                                                         //
+//                                                                         //
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+//  Convert Value to rounded and saturated Fixed-Point Sample
+//---------------------------------------------------------------------------
+
+template <class T, int WINDOW_SIZE, int VALUE_SCALE>  int16_t  FixedMovingAverage<T, WINDOW_SIZE, VALUE_SCALE>::ValueToFixed (T Value_p)
+{
+
+T  ScaledValue;
+
+
+    // clamp and round without branches (compiles to min/max and a sign
+    // copy), a mispredicted branch for samples around 0 costs more than
+    // the complete update of the average
+    ScaledValue = Value_p * (T)VALUE_SCALE;
+    ScaledValue = (ScaledValue < (T)INT16_MAX) ? ScaledValue : (T)INT16_MAX;
+    ScaledValue = (ScaledValue > (T)INT16_MIN) ? ScaledValue : (T)INT16_MIN;
+
+    return ((int16_t)(ScaledValue + copysign((T)0.5, ScaledValue)));
+
+}
+
+
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//                                                                         //
+//                                                                         //
+//          C L A S S   <ExpMovingAverage>                                 //
+//                                                                         //
+//                                                                         //
+/////////////////////////////////////////////////////////////////////////////
+
+//  Exponential Moving Average with Smoothing Factor alpha = 1/2^SMOOTH_SHIFT,
+//  as cheaper alternative to the Simple Moving Average: no SampleWindow,
+//  only one Accumulator, Shifts instead of Divisions. The Accumulator holds
+//  the Average as Fixed-Point Value with SMOOTH_SHIFT additional fractional
+//  bits, so the rounded Average (GetAverageFixed) settles exactly to a
+//  constant input, GetAverageValue() within half a Fixed-Point step. The response
+//  roughly corresponds to a Simple Moving Average over 2^(SMOOTH_SHIFT+1)
+//  samples.
+
+template <class T, int SMOOTH_SHIFT, int VALUE_SCALE = 10> class ExpMovingAverage
+{
+
+    static_assert((SMOOTH_SHIFT > 0) && (SMOOTH_SHIFT <= 15), "SMOOTH_SHIFT out of range (1...15)");
+    static_assert((VALUE_SCALE > 0), "VALUE_SCALE must be positive");
+
+private:
+
+    // Private Attributes
+    int32_t m_i32Accumulator;                   // Average * VALUE_SCALE * 2^SMOOTH_SHIFT
+    T       m_AverageValue;
+    bool    m_fAverageInitialized;
+
+    // Private Methods
+    static int16_t  ValueToFixed (T Value_p);
+
+
+public:
+
+    // Constructor/Destructor
+    ExpMovingAverage ();
+
+    // Public Memebers
+    void     Clean ();
+    int      GetSampleWindowSize ();
+    T        CalcMovingAverage (T NewValue_p);
+    T        GetAverageValue ();
+    int32_t  GetAverageFixed ();
+
+};
+
+
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//                                                                         //
+//                                                                         //
+//          C O N S T R U C T I O N   /   D E S T R U C T I O N            //
+//                                                                         //
+//                                                                         //
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+//  Constructor
+//---------------------------------------------------------------------------
+
+template <class T, int SMOOTH_SHIFT, int VALUE_SCALE>  ExpMovingAverage<T, SMOOTH_SHIFT, VALUE_SCALE>::ExpMovingAverage ()
+{
+
+    Clean();
+
+    return;
+
+}
+
+
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//                                                                         //
+//                                                                         //
+//          P U B L I C    M E T H O D S                                   //
+//                                                                         //
+//                                                                         //
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+//  Clean
+//---------------------------------------------------------------------------
+
+template <class T, int SMOOTH_SHIFT, int VALUE_SCALE>  void  ExpMovingAverage<T, SMOOTH_SHIFT, VALUE_SCALE>::Clean ()
+{
+
+    m_i32Accumulator = 0;
+    m_AverageValue = 0;
+
+    m_fAverageInitialized = false;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get equivalent SampleWindow Size
+//---------------------------------------------------------------------------
+
+template <class T, int SMOOTH_SHIFT, int VALUE_SCALE>  int  ExpMovingAverage<T, SMOOTH_SHIFT, VALUE_SCALE>::GetSampleWindowSize ()
+{
+
+    return ((1 << (SMOOTH_SHIFT + 1)) - 1);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Calculate Moving Average
+//---------------------------------------------------------------------------
+
+template <class T, int SMOOTH_SHIFT, int VALUE_SCALE>  T  ExpMovingAverage<T, SMOOTH_SHIFT, VALUE_SCALE>::CalcMovingAverage (T NewValue_p)
+{
+
+int32_t  i32NewValue;
+T        AverageValue;
+
+
+    i32NewValue = ValueToFixed(NewValue_p);
+
+    // The first sample initializes the Accumulator, otherwise the average
+    // would start at 0 and needs several time constants to settle
+    if ( m_fAverageInitialized )
+    {
+        // Avg += (New - Avg) * alpha  ->  Accu += New - Accu/2^SMOOTH_SHIFT
+        m_i32Accumulator += i32NewValue - MovAvgRoundShift(m_i32Accumulator, SMOOTH_SHIFT);
+    }
+    else
+    {
+        m_i32Accumulator = i32NewValue * (1 << SMOOTH_SHIFT);
+        m_fAverageInitialized = true;
+    }
+
+    AverageValue = (T)m_i32Accumulator * ((T)1 / (T)((int32_t)VALUE_SCALE << SMOOTH_SHIFT));
+    m_AverageValue = AverageValue;
+
+    return (AverageValue);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get last calculated Average Value
+//---------------------------------------------------------------------------
+
+template <class T, int SMOOTH_SHIFT, int VALUE_SCALE>  T  ExpMovingAverage<T, SMOOTH_SHIFT, VALUE_SCALE>::GetAverageValue ()
+{
+
+    return (m_AverageValue);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Average Value as rounded Fixed-Point Value (Value * VALUE_SCALE)
+//---------------------------------------------------------------------------
+
+template <class T, int SMOOTH_SHIFT, int VALUE_SCALE>  int32_t  ExpMovingAverage<T, SMOOTH_SHIFT, VALUE_SCALE>::GetAverageFixed ()
+{
+
+    return (MovAvgRoundShift(m_i32Accumulator, SMOOTH_SHIFT));
+
+}
+
+
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//                                                                         //
+//                                                                         //
+//          P R I V A T E    M E T H O D S                                 //
+//                                                                         //
+//                                                                         //
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+//  Convert Value to rounded and saturated Fixed-Point Sample
+//---------------------------------------------------------------------------
+
+template <class T, int SMOOTH_SHIFT, int VALUE_SCALE>  int16_t  ExpMovingAverage<T, SMOOTH_SHIFT, VALUE_SCALE>::ValueToFixed (T Value_p)
+{
+
+T  ScaledValue;
+
+
+    // clamp and round without branches (compiles to min/max and a sign
+    // copy), a mispredicted branch for samples around 0 costs more than
+    // the complete update of the average
+    ScaledValue = Value_p * (T)VALUE_SCALE;
+    ScaledValue = (ScaledValue < (T)INT16_MAX) ? ScaledValue : (T)INT16_MAX;
+    ScaledValue = (ScaledValue > (T)INT16_MIN) ? ScaledValue : (T)INT16_MIN;
+
+    return ((int16_t)(ScaledValue + copysign((T)0.5, ScaledValue)));
+
+}
+
+
+
+
 // EOF
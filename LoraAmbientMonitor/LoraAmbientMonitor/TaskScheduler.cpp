@@ -0,0 +1,536 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Ambient Monitor
+  Description:  Class <TaskScheduler> Implementation
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Add RescheduleTask(), Idle Time based on measured Sleep Time
+
+****************************************************************************/
+
+
+#if defined(ARDUINO_ARCH_ESP32)
+    #include "Arduino.h"
+#else
+    #define _CRT_SECURE_NO_WARNINGS
+    #include <stdint.h>
+    #include <stdio.h>
+    #include <string.h>
+#endif
+
+#include "TaskScheduler.h"
+#include <stdarg.h>
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          CLASS  TaskScheduler                                           */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+/////////////////////////////////////////////////////////////////////////////
+//                                                                         //
+//          P R I V A T E   A T T R I B U T E S                            //
+//                                                                         //
+/////////////////////////////////////////////////////////////////////////////
+
+
+
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//                                                                         //
+//          C O N S T R U C T O R   /   D E S T R U C T O R                //
+//                                                                         //
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+//  Constructor
+//---------------------------------------------------------------------------
+
+TaskScheduler::TaskScheduler()
+{
+
+    m_pfnGetTick        = NULL;
+    m_pfnSleep          = NULL;
+    m_ui32MaxSleepTime  = 0;
+    m_iNumTasks         = 0;
+    m_ui32StatStartTick = 0;
+    m_ui32StatIdleTime  = 0;
+
+    memset(m_aTaskTab, 0x00, sizeof(m_aTaskTab));
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Destructor
+//---------------------------------------------------------------------------
+
+TaskScheduler::~TaskScheduler()
+{
+
+    return;
+
+}
+
+
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//                                                                         //
+//          P U B L I C    M E T H O D E N                                 //
+//                                                                         //
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+//  Setup
+//---------------------------------------------------------------------------
+
+void  TaskScheduler::Setup (tGetTickFunc pfnGetTick_p, tSleepFunc pfnSleep_p, uint32_t ui32MaxSleepTime_p)
+{
+
+    m_pfnGetTick       = pfnGetTick_p;
+    m_pfnSleep         = pfnSleep_p;
+    m_ui32MaxSleepTime = ui32MaxSleepTime_p;
+    m_iNumTasks        = 0;
+
+    memset(m_aTaskTab, 0x00, sizeof(m_aTaskTab));
+
+    ResetStatistics();
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Add Task
+//---------------------------------------------------------------------------
+
+int  TaskScheduler::AddTask (const char* pszName_p, tTaskFunc pfnTaskFunc_p, uint32_t ui32Period_p, uint32_t ui32FirstDelay_p /* = 0 */)
+{
+
+tTask*  pTask;
+int     iTaskID;
+
+
+    if ((m_pfnGetTick == NULL) || (pfnTaskFunc_p == NULL))
+    {
+        return (-1);
+    }
+    if (m_iNumTasks >= MAX_TASKS)
+    {
+        return (-2);
+    }
+
+    iTaskID = m_iNumTasks;
+    pTask = &m_aTaskTab[iTaskID];
+
+    memset(pTask, 0x00, sizeof(tTask));
+    pTask->m_pszName      = (pszName_p != NULL) ? pszName_p : "";
+    pTask->m_pfnTaskFunc  = pfnTaskFunc_p;
+    pTask->m_ui32Period   = ui32Period_p;
+    pTask->m_ui32Deadline = m_pfnGetTick() + ui32FirstDelay_p;
+    pTask->m_fArmed       = (ui32Period_p != 0) || (ui32FirstDelay_p != 0);
+
+    m_iNumTasks++;
+
+    return (iTaskID);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Trigger Task (set Deadline to now, e.g. for asynchronous Events)
+//---------------------------------------------------------------------------
+
+int  TaskScheduler::TriggerTask (int iTaskID_p)
+{
+
+tTask*  pTask;
+
+
+    if ((iTaskID_p < 0) || (iTaskID_p >= m_iNumTasks))
+    {
+        return (-1);
+    }
+
+    pTask = &m_aTaskTab[iTaskID_p];
+    pTask->m_ui32Deadline = m_pfnGetTick();
+    pTask->m_fArmed       = true;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Reschedule Task (set Deadline to now + Delay)
+//---------------------------------------------------------------------------
+
+int  TaskScheduler::RescheduleTask (int iTaskID_p, uint32_t ui32Delay_p)
+{
+
+tTask*  pTask;
+
+
+    if ((iTaskID_p < 0) || (iTaskID_p >= m_iNumTasks))
+    {
+        return (-1);
+    }
+
+    pTask = &m_aTaskTab[iTaskID_p];
+    pTask->m_ui32Deadline = m_pfnGetTick() + ui32Delay_p;
+    pTask->m_fArmed       = true;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Schedule: run all due Tasks, then sleep until the next Deadline
+//---------------------------------------------------------------------------
+
+int  TaskScheduler::Schedule (void)
+{
+
+uint32_t  ui32SleepTime;
+uint32_t  ui32StartTick;
+int       iRunCount;
+int       iRes;
+
+
+    if (m_pfnGetTick == NULL)
+    {
+        return (-1);
+    }
+
+    // Every Task runs at most once per call, so that a Task with an
+    // overlong runtime can not starve the others
+    iRunCount = 0;
+    while (iRunCount < m_iNumTasks)
+    {
+        iRes = RunNextDueTask(m_pfnGetTick());
+        if (iRes < 0)
+        {
+            break;
+        }
+        iRunCount++;
+    }
+
+    // sleep until next Deadline (limited to <m_ui32MaxSleepTime>), the
+    // Sleep Function may return earlier (e.g. Wakeup by GPIO)
+    ui32SleepTime = GetTimeToNextDeadline();
+    if ((ui32SleepTime > 0) && (m_pfnSleep != NULL))
+    {
+        ui32StartTick = m_pfnGetTick();
+        m_pfnSleep(ui32SleepTime);
+        m_ui32StatIdleTime += m_pfnGetTick() - ui32StartTick;
+    }
+
+    return (iRunCount);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Time until the next Deadline
+//---------------------------------------------------------------------------
+
+uint32_t  TaskScheduler::GetTimeToNextDeadline (void)
+{
+
+uint32_t  ui32CurrTick;
+uint32_t  ui32TimeToDeadline;
+int32_t   i32Delta;
+int       iIdx;
+
+
+    ui32CurrTick = m_pfnGetTick();
+    ui32TimeToDeadline = m_ui32MaxSleepTime;
+
+    for (iIdx=0; iIdx<m_iNumTasks; iIdx++)
+    {
+        if ( !m_aTaskTab[iIdx].m_fArmed )
+        {
+            continue;
+        }
+        i32Delta = (int32_t)(m_aTaskTab[iIdx].m_ui32Deadline - ui32CurrTick);
+        if (i32Delta <= 0)
+        {
+            return (0);
+        }
+        if ((uint32_t)i32Delta < ui32TimeToDeadline)
+        {
+            ui32TimeToDeadline = (uint32_t)i32Delta;
+        }
+    }
+
+    return (ui32TimeToDeadline);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Reset Statistics
+//---------------------------------------------------------------------------
+
+void  TaskScheduler::ResetStatistics (void)
+{
+
+int  iIdx;
+
+
+    for (iIdx=0; iIdx<m_iNumTasks; iIdx++)
+    {
+        m_aTaskTab[iIdx].m_ui32RunCount    = 0;
+        m_aTaskTab[iIdx].m_ui32SumLateness = 0;
+        m_aTaskTab[iIdx].m_ui32MaxLateness = 0;
+        m_aTaskTab[iIdx].m_ui32MaxRunTime  = 0;
+    }
+
+    m_ui32StatStartTick = (m_pfnGetTick != NULL) ? m_pfnGetTick() : 0;
+    m_ui32StatIdleTime  = 0;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get CPU Idle Ratio since last <ResetStatistics> [1/10 %]
+//---------------------------------------------------------------------------
+
+uint32_t  TaskScheduler::GetIdleRatio (void)
+{
+
+uint32_t  ui32Elapsed;
+
+
+    ui32Elapsed = m_pfnGetTick() - m_ui32StatStartTick;
+    if (ui32Elapsed == 0)
+    {
+        return (1000);
+    }
+    if (m_ui32StatIdleTime >= ui32Elapsed)
+    {
+        return (1000);
+    }
+
+    return ((uint32_t)(((uint64_t)m_ui32StatIdleTime * 1000) / ui32Elapsed));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Task Info (incl. Statistics)
+//---------------------------------------------------------------------------
+
+const TaskScheduler::tTask*  TaskScheduler::GetTaskInfo (int iTaskID_p)
+{
+
+    if ((iTaskID_p < 0) || (iTaskID_p >= m_iNumTasks))
+    {
+        return (NULL);
+    }
+
+    return (&m_aTaskTab[iTaskID_p]);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Log Statistics
+//---------------------------------------------------------------------------
+
+const char*  TaskScheduler::LogStatistics (void)
+{
+
+char          szLogBuff[sizeof(m_szLogStatistics)];
+const tTask*  pTask;
+uint32_t      ui32IdleRatio;
+uint32_t      ui32AvgLateness;
+int           iIdx;
+
+
+    memset(m_szLogStatistics, '\0', sizeof(m_szLogStatistics));
+    memset(szLogBuff, '\0', sizeof(szLogBuff));
+
+    ui32IdleRatio = GetIdleRatio();
+    LogStr(szLogBuff, sizeof(szLogBuff), " === TaskScheduler ===\n");
+    LogStr(szLogBuff, sizeof(szLogBuff), "  CPU Idle Ratio:         %lu.%lu [%%]\n", (unsigned long)(ui32IdleRatio / 10), (unsigned long)(ui32IdleRatio % 10));
+    LogStr(szLogBuff, sizeof(szLogBuff), "  Task            Period     Runs  AvgLate  MaxLate   MaxRun [ms]\n");
+    for (iIdx=0; iIdx<m_iNumTasks; iIdx++)
+    {
+        pTask = &m_aTaskTab[iIdx];
+        ui32AvgLateness = (pTask->m_ui32RunCount > 0) ? (pTask->m_ui32SumLateness / pTask->m_ui32RunCount) : 0;
+        LogStr(szLogBuff, sizeof(szLogBuff), "  %-14.14s %7lu %8lu %8lu %8lu %8lu\n",
+               pTask->m_pszName,
+               (unsigned long)pTask->m_ui32Period,
+               (unsigned long)pTask->m_ui32RunCount,
+               (unsigned long)ui32AvgLateness,
+               (unsigned long)pTask->m_ui32MaxLateness,
+               (unsigned long)pTask->m_ui32MaxRunTime);
+    }
+
+    strncpy(m_szLogStatistics, szLogBuff, sizeof(m_szLogStatistics));
+
+    return (m_szLogStatistics);
+
+}
+
+
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//                                                                         //
+//          P R I V A T E    M E T H O D E N                               //
+//                                                                         //
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+//  Private: Run the due Task with the earliest Deadline
+//---------------------------------------------------------------------------
+
+int  TaskScheduler::RunNextDueTask (uint32_t ui32CurrTick_p)
+{
+
+tTask*    pTask;
+uint32_t  ui32Lateness;
+uint32_t  ui32MaxLateness;
+uint32_t  ui32StartTick;
+uint32_t  ui32RunTime;
+int32_t   i32Delta;
+int       iTaskID;
+int       iIdx;
+
+
+    // search the Task with the earliest Deadline that is already reached
+    // (on equal Deadlines the Task registered first wins)
+    iTaskID = -1;
+    ui32MaxLateness = 0;
+    for (iIdx=0; iIdx<m_iNumTasks; iIdx++)
+    {
+        if ( !m_aTaskTab[iIdx].m_fArmed )
+        {
+            continue;
+        }
+        i32Delta = (int32_t)(ui32CurrTick_p - m_aTaskTab[iIdx].m_ui32Deadline);
+        if (i32Delta < 0)
+        {
+            continue;
+        }
+        if ((iTaskID < 0) || ((uint32_t)i32Delta > ui32MaxLateness))
+        {
+            iTaskID = iIdx;
+            ui32MaxLateness = (uint32_t)i32Delta;
+        }
+    }
+    if (iTaskID < 0)
+    {
+        return (-1);
+    }
+
+    pTask = &m_aTaskTab[iTaskID];
+    ui32Lateness = ui32MaxLateness;
+
+    // calculate next Deadline before running the Task, so that the Task
+    // itself can re-trigger or re-arm its own Deadline
+    if (pTask->m_ui32Period != 0)
+    {
+        // keep the Period free of drift, but skip missed Periods
+        pTask->m_ui32Deadline += pTask->m_ui32Period;
+        if ((int32_t)(pTask->m_ui32Deadline - ui32CurrTick_p) <= 0)
+        {
+            pTask->m_ui32Deadline = ui32CurrTick_p + pTask->m_ui32Period;
+        }
+    }
+    else
+    {
+        pTask->m_fArmed = false;
+    }
+
+    ui32StartTick = m_pfnGetTick();
+    pTask->m_pfnTaskFunc();
+    ui32RunTime = m_pfnGetTick() - ui32StartTick;
+
+    pTask->m_ui32RunCount++;
+    pTask->m_ui32SumLateness += ui32Lateness;
+    if (ui32Lateness > pTask->m_ui32MaxLateness)
+    {
+        pTask->m_ui32MaxLateness = ui32Lateness;
+    }
+    if (ui32RunTime > pTask->m_ui32MaxRunTime)
+    {
+        pTask->m_ui32MaxRunTime = ui32RunTime;
+    }
+
+    return (iTaskID);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Private: LogStr
+//---------------------------------------------------------------------------
+
+size_t  TaskScheduler::LogStr (char* pszLogBuff_p, size_t nLogBuffSize_p, const char* pszFmt_p, ...)
+{
+
+va_list  pArgList;
+size_t   nUsedBuffLen;
+size_t   nFreeBuffLen;
+
+
+    if ((pszLogBuff_p == NULL) || (nLogBuffSize_p == 0) || (pszFmt_p == NULL))
+    {
+        return (0);
+    }
+
+    nUsedBuffLen = strlen(pszLogBuff_p);
+    nFreeBuffLen = nLogBuffSize_p - nUsedBuffLen;
+    if (nFreeBuffLen <= 0)
+    {
+        return (0);
+    }
+
+    va_start(pArgList, pszFmt_p);
+    vsnprintf(&pszLogBuff_p[nUsedBuffLen], nFreeBuffLen, pszFmt_p, pArgList);
+    va_end(pArgList);
+
+    return (strlen(pszLogBuff_p) - nUsedBuffLen);
+
+}
+
+
+
+//  EOF
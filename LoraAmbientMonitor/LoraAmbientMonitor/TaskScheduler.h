@@ -0,0 +1,140 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Ambient Monitor
+  Description:  Class <TaskScheduler> Declaration
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Add RescheduleTask(), Idle Time based on measured Sleep Time
+  2026/10/18 -rs:   V1.02 Include <stdint.h> and <stddef.h> (independent of Include Order)
+
+****************************************************************************/
+
+#ifndef _TASKSCHEDULER_H_
+#define _TASKSCHEDULER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+
+
+
+//---------------------------------------------------------------------------
+//  Type Definitions
+//---------------------------------------------------------------------------
+
+
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          CLASS  TaskScheduler                                           */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//  Cooperative, deadline driven Scheduler: each Task is registered with its
+//  own Period and is called as soon as its Deadline is reached. Between the
+//  Deadlines the Scheduler sleeps instead of spinning. Time Base and Sleep
+//  Function are supplied by the Application, so the Class can also be built
+//  on a Host to measure Scheduling Jitter and CPU Idle Ratio.
+
+class  TaskScheduler
+{
+
+    //-----------------------------------------------------------------------
+    //  Definitions
+    //-----------------------------------------------------------------------
+
+    public:
+
+        static const int    MAX_TASKS           = 12;
+
+        typedef void      (*tTaskFunc)(void);
+        typedef uint32_t  (*tGetTickFunc)(void);                        // [ms]
+        typedef void      (*tSleepFunc)(uint32_t ui32SleepTime_p);      // [ms]
+
+        typedef struct
+        {
+            const char* m_pszName;
+            tTaskFunc   m_pfnTaskFunc;
+            uint32_t    m_ui32Period;                                   // [ms], 0 = one-shot (re-armed by <TriggerTask>)
+            uint32_t    m_ui32Deadline;                                 // [ms]
+            bool        m_fArmed;
+
+            uint32_t    m_ui32RunCount;
+            uint32_t    m_ui32SumLateness;                              // [ms] sum of delays between Deadline and Task Start
+            uint32_t    m_ui32MaxLateness;                              // [ms]
+            uint32_t    m_ui32MaxRunTime;                               // [ms]
+
+        } tTask;
+
+
+
+    //-----------------------------------------------------------------------
+    //  Private Attributes
+    //-----------------------------------------------------------------------
+
+    private:
+
+        tGetTickFunc    m_pfnGetTick;
+        tSleepFunc      m_pfnSleep;
+        uint32_t        m_ui32MaxSleepTime;
+        tTask           m_aTaskTab[MAX_TASKS];
+        int             m_iNumTasks;
+        uint32_t        m_ui32StatStartTick;
+        uint32_t        m_ui32StatIdleTime;
+        char            m_szLogStatistics[1024];
+
+
+
+    //-----------------------------------------------------------------------
+    //  Public Methodes
+    //-----------------------------------------------------------------------
+
+    public:
+
+        TaskScheduler();
+        ~TaskScheduler();
+
+        void          Setup(tGetTickFunc pfnGetTick_p, tSleepFunc pfnSleep_p, uint32_t ui32MaxSleepTime_p);
+        int           AddTask(const char* pszName_p, tTaskFunc pfnTaskFunc_p, uint32_t ui32Period_p, uint32_t ui32FirstDelay_p = 0);
+        int           TriggerTask(int iTaskID_p);
+        int           RescheduleTask(int iTaskID_p, uint32_t ui32Delay_p);
+        int           Schedule(void);
+        uint32_t      GetTimeToNextDeadline(void);
+
+        void          ResetStatistics(void);
+        uint32_t      GetIdleRatio(void);
+        const tTask*  GetTaskInfo(int iTaskID_p);
+        const char*   LogStatistics(void);
+
+
+
+    //-----------------------------------------------------------------------
+    //  Private Methodes
+    //-----------------------------------------------------------------------
+
+    private:
+
+        int     RunNextDueTask(uint32_t ui32CurrTick_p);
+        size_t  LogStr(char* pszLogBuff_p, size_t nLogBuffSize_p, const char* pszFmt_p, ...);
+
+};
+
+
+
+#endif  // _TASKSCHEDULER_H_
+
+
+
@@ -0,0 +1,902 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Channel Simulator
+  Description:  Implementation of Discrete-Event Simulation of LoRa Channel
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Slotted Transmit Schedule, Bootup Spread and Clock Drift
+  2026/10/18 -rs:   V1.02 Generation Depth of Data Packets, time-on-air per Packet
+  2026/10/18 -rs:   V1.03 Compact Data Packets with Sensor dependent Layout
+
+****************************************************************************/
+
+#include "Arduino.h"                                    // HostShim: virtual time base and random generator
+#include <time.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <queue>
+#include <random>
+#include "LoraPacket.h"
+#include "LoraTransmitter.h"
+#include "LoraPayloadEncoder.h"
+#include "LoraPayloadDecoder.h"
+#include "RH_RF95.h"                                     // HostShim: RH_RF95_MAX_PAYLOAD_LEN for <tJsonMessage>
+#include "PacketProcessing.h"
+#include "MessageQualification.h"
+#include "ChannelSim.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+static  const  int      CSM_RSSI_NONE           = -1000;
+static  const  uint8_t  CSM_TX_PACKET_LEN       = sizeof(tLoraDataPacket);      // as used by firmware for Bootup and classic Data Packets
+static  const  uint     CSM_TX_PAYLOAD_MAX      = (sizeof(tLoraDataDeltaPacket) > sizeof(tLoraDataCompactPacket)) ? sizeof(tLoraDataDeltaPacket) : sizeof(tLoraDataCompactPacket);
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+//  Events at the same tick are processed in the order of this enumeration,
+//  so a transmission ending at tick T does not collide with one starting at T.
+typedef enum
+{
+    kCsmEventTxEnd      = 0,
+    kCsmEventBootup     = 1,
+    kCsmEventAsync      = 2,
+    kCsmEventCheck      = 3
+
+} tCsmEventType;
+
+
+typedef struct
+{
+    uint64_t            m_ui64Tick;                 // [ms]
+    uint64_t            m_ui64Order;                // insertion order, keeps the simulation deterministic
+    tCsmEventType       m_EventType;
+    uint                m_uiDevice;
+    uint32_t            m_ui32Param;                // kCsmEventCheck: generation, kCsmEventTxEnd: transmission ID
+
+} tCsmEvent;
+
+
+struct  tCsmEventLater
+{
+    bool  operator() (const tCsmEvent& Event1_p, const tCsmEvent& Event2_p) const
+    {
+        if (Event1_p.m_ui64Tick != Event2_p.m_ui64Tick)
+        {
+            return (Event1_p.m_ui64Tick > Event2_p.m_ui64Tick);
+        }
+        if (Event1_p.m_EventType != Event2_p.m_EventType)
+        {
+            return (Event1_p.m_EventType > Event2_p.m_EventType);
+        }
+        return (Event1_p.m_ui64Order > Event2_p.m_ui64Order);
+    }
+};
+
+
+typedef struct
+{
+    // sensor device (firmware classes)
+    LoraTransmitter     m_LoraTransmitter;
+    LoraPayloadEncoder  m_LoraPayloadEnc;
+    uint32_t            m_ui32RandomState;          // random generator of device, used by <LoraTransmitter::CalcNextTransmitCycleTime>
+    uint64_t            m_ui64BootupTick;           // [ms] the LoRa Transmit Task runs at BootupTick + n * PollPeriod
+    double              m_dClockRate;               // device time per simulation time (1.0 = exact clock)
+    uint32_t            m_ui32CheckGen;             // only the latest scheduled kCsmEventCheck is valid
+    bool                m_fAsyncTransmitEvent;
+    int                 m_iRssi;                    // [dBm] at the gateway
+
+    // gateway side
+    uint32_t            m_aui32SequNumHistList[SEQU_NUM_HIST_LIST];
+
+} tCsmDevice;
+
+
+typedef struct
+{
+    uint32_t            m_ui32TxID;
+    uint                m_uiDevice;
+    int                 m_iRssi;
+    int                 m_iMaxInterferer;           // [dBm] strongest overlapping transmission
+    uint                m_uiPayloadLen;
+    uint8_t             m_abPayload[CSM_TX_PAYLOAD_MAX];
+
+} tCsmTransmission;
+
+
+typedef struct
+{
+    const tCsmConfig*               m_pConfig;
+    tCsmResult*                     m_pResult;
+    uint64_t                        m_ui64Tick;
+    uint64_t                        m_ui64EventOrder;
+    uint32_t                        m_ui32NextTxID;
+    std::vector<tCsmDevice>         m_vecDevices;
+    std::vector<tCsmTransmission>   m_vecActiveTx;
+    std::priority_queue<tCsmEvent, std::vector<tCsmEvent>, tCsmEventLater>  m_EventQueue;
+    std::mt19937_64                 m_RandomGen;
+    LoraPayloadDecoder              m_LoraPayloadDec;
+    LoraTransmitter::tLoraTransmitterSettings   m_TransmitterSettings;
+    LoraPayloadEncoder::tDeviceConfig           m_DeviceConfig;
+
+} tCsmSimulation;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  void  CsmSetDeviceTick (
+    tCsmSimulation* pSim_p,
+    uint uiDevice_p);
+
+static  void  CsmPostEvent (
+    tCsmSimulation* pSim_p,
+    uint64_t ui64Tick_p,
+    tCsmEventType EventType_p,
+    uint uiDevice_p,
+    uint32_t ui32Param_p);
+
+static  void  CsmScheduleCheck (
+    tCsmSimulation* pSim_p,
+    uint uiDevice_p,
+    uint32_t ui32Delay_p);
+
+static  void  CsmScheduleAsyncEvent (
+    tCsmSimulation* pSim_p,
+    uint uiDevice_p);
+
+static  void  CsmOnBootup (
+    tCsmSimulation* pSim_p,
+    uint uiDevice_p);
+
+static  void  CsmOnCheck (
+    tCsmSimulation* pSim_p,
+    uint uiDevice_p);
+
+static  void  CsmStartTransmission (
+    tCsmSimulation* pSim_p,
+    uint uiDevice_p,
+    const void* pPayload_p,
+    uint uiPayloadLen_p);
+
+static  void  CsmOnTxEnd (
+    tCsmSimulation* pSim_p,
+    uint32_t ui32TxID_p);
+
+static  void  CsmReceivePacket (
+    tCsmSimulation* pSim_p,
+    const tCsmTransmission* pTransmission_p);
+
+static  uint32_t  CsmCalcTimeOnAir (
+    const tCsmSimulation* pSim_p,
+    uint uiPayloadLen_p);
+
+static  double  CsmGetWallTime (void);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Get Default Configuration (same values as LoraAmbientMonitor.ino)
+//---------------------------------------------------------------------------
+
+void  CsmGetDefaultConfig (
+    tCsmConfig* pConfig_p)                              // [OUT]    Ptr to Configuration
+{
+
+    memset(pConfig_p, 0x00, sizeof(tCsmConfig));
+
+    pConfig_p->m_uiDevices              = 100;
+    pConfig_p->m_uiSimDays              = 90;
+    pConfig_p->m_ui32FirstTime          = ( 5 * 60 * 1000);
+    pConfig_p->m_ui32CycleTime          = (30 * 60 * 1000);
+    pConfig_p->m_ui32InhibitTime        = (     30 * 1000);
+    pConfig_p->m_ui32PollPeriod         = (      1 * 1000);
+    pConfig_p->m_ui32BootupSpread       = (30 * 60 * 1000);
+    pConfig_p->m_dClockDriftPpm         = 0.0;
+    pConfig_p->m_fSlottedSchedule       = false;
+    pConfig_p->m_dAsyncEventsPerHour    = 0.0;
+    pConfig_p->m_uiGenDepth             = 0;
+    pConfig_p->m_fCompactLayout         = false;
+    pConfig_p->m_ui8SensorLayout        = LORA_DATA_LAYOUT_SENSOR_MASK;
+    pConfig_p->m_iSpreadingFactor       = 12;
+    pConfig_p->m_lSignalBandwidth       = 125000;
+    pConfig_p->m_iCodingRateDenominator = 5;
+    pConfig_p->m_ui16DutyCycleLimit     = 10;
+    pConfig_p->m_ui32DutyCycleWindow    = (60 * 60 * 1000);
+    pConfig_p->m_iCaptureThreshold      = CSM_CAPTURE_DISABLED;
+    pConfig_p->m_iRssiMin               = -125;
+    pConfig_p->m_iRssiMax               = -70;
+    pConfig_p->m_ui32Seed               = 1;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Run Simulation of one Fleet (reentrant, may be called by several threads)
+//---------------------------------------------------------------------------
+
+int  CsmRunSimulation (
+    const tCsmConfig* pConfig_p,                        // [IN]     Ptr to Configuration
+    tCsmResult* pResult_p)                              // [OUT]    Ptr to Result
+{
+
+tCsmSimulation*  pSim;
+tCsmDevice*      pDevice;
+tCsmEvent        Event;
+uint64_t         ui64EndTick;
+double           dStartTime;
+uint             uiDevice;
+
+
+    if ((pConfig_p == NULL) || (pResult_p == NULL) ||
+        (pConfig_p->m_uiDevices == 0) || (pConfig_p->m_uiDevices > CSM_MAX_DEVICES) ||
+        (pConfig_p->m_ui32PollPeriod == 0) || (pConfig_p->m_iRssiMin > pConfig_p->m_iRssiMax) ||
+        (pConfig_p->m_fSlottedSchedule && (pConfig_p->m_uiDevices > CSM_MAX_SLOTTED_DEVICES)) ||
+        (pConfig_p->m_dClockDriftPpm < 0) || (pConfig_p->m_dClockDriftPpm > 1000) ||
+        (pConfig_p->m_uiGenDepth > LORA_DATA_GEN_DEPTH_MAX) ||
+        ((pConfig_p->m_ui8SensorLayout & ~LORA_DATA_LAYOUT_SENSOR_MASK) != 0))
+    {
+        return (-1);
+    }
+
+    dStartTime = CsmGetWallTime();
+
+    memset(pResult_p, 0x00, sizeof(tCsmResult));
+    pResult_p->m_uiDevices = pConfig_p->m_uiDevices;
+
+    // the simulation state is allocated per call, so parallel calls are independent
+    pSim = new tCsmSimulation;
+    pSim->m_pConfig        = pConfig_p;
+    pSim->m_pResult        = pResult_p;
+    pSim->m_ui64Tick       = 0;
+    pSim->m_ui64EventOrder = 0;
+    pSim->m_ui32NextTxID   = 0;
+    pSim->m_RandomGen.seed(((uint64_t)pConfig_p->m_ui32Seed << 32) | pConfig_p->m_uiDevices);
+    pSim->m_vecDevices.resize(pConfig_p->m_uiDevices);
+
+    memset(&pSim->m_TransmitterSettings, 0x00, sizeof(pSim->m_TransmitterSettings));
+    pSim->m_TransmitterSettings.m_iLoraSpreadingFactor       = pConfig_p->m_iSpreadingFactor;
+    pSim->m_TransmitterSettings.m_lLoraSignalBandwidth       = pConfig_p->m_lSignalBandwidth;
+    pSim->m_TransmitterSettings.m_iLoraCodingRateDenominator = pConfig_p->m_iCodingRateDenominator;
+    pSim->m_TransmitterSettings.m_ui16DutyCycleLimit         = pConfig_p->m_ui16DutyCycleLimit;
+    pSim->m_TransmitterSettings.m_ui32DutyCycleWindow        = pConfig_p->m_ui32DutyCycleWindow;
+
+    memset(&pSim->m_DeviceConfig, 0x00, sizeof(pSim->m_DeviceConfig));
+    pSim->m_DeviceConfig.m_ui16DataPackCycleTm  = (uint16_t)(pConfig_p->m_ui32CycleTime / (60 * 1000));
+    pSim->m_DeviceConfig.m_fCfgAsyncLoraEvent   = (pConfig_p->m_dAsyncEventsPerHour > 0);
+    pSim->m_DeviceConfig.m_ui8LoraSpreadFactor  = (uint8_t)pConfig_p->m_iSpreadingFactor;
+
+    if ( pConfig_p->m_fCompactLayout )
+    {
+        pResult_p->m_uiDataPacketLen = LORA_DATA_COMPACT_PACKET_SIZE(pConfig_p->m_ui8SensorLayout,
+                                                                     (pConfig_p->m_uiGenDepth == 0) ? LoraPayloadEncoder::GEN_DEPTH_CLASSIC : pConfig_p->m_uiGenDepth);
+    }
+    else
+    {
+        pResult_p->m_uiDataPacketLen = (pConfig_p->m_uiGenDepth == 0) ? CSM_TX_PACKET_LEN : LORA_DATA_DELTA_PACKET_SIZE(pConfig_p->m_uiGenDepth);
+    }
+    pResult_p->m_ui32TimeOnAirUs = CsmCalcTimeOnAir(pSim, pResult_p->m_uiDataPacketLen);
+
+    // devices are switched on at random times within the Bootup Spread
+    std::uniform_int_distribution<uint64_t>  BootupDist(0, pConfig_p->m_ui32BootupSpread);
+    std::uniform_int_distribution<int>       RssiDist(pConfig_p->m_iRssiMin, pConfig_p->m_iRssiMax);
+    std::uniform_real_distribution<double>   DriftDist(-pConfig_p->m_dClockDriftPpm, pConfig_p->m_dClockDriftPpm);
+    for (uiDevice=0; uiDevice<pConfig_p->m_uiDevices; uiDevice++)
+    {
+        pDevice = &pSim->m_vecDevices[uiDevice];
+        pDevice->m_ui32RandomState     = 1;
+        pDevice->m_ui64BootupTick      = BootupDist(pSim->m_RandomGen);
+        pDevice->m_dClockRate          = 1.0 + (DriftDist(pSim->m_RandomGen) / 1000000.0);
+        pDevice->m_ui32CheckGen        = 0;
+        pDevice->m_fAsyncTransmitEvent = false;
+        pDevice->m_iRssi               = RssiDist(pSim->m_RandomGen);
+        memset(pDevice->m_aui32SequNumHistList, 0x00, sizeof(pDevice->m_aui32SequNumHistList));
+        CsmPostEvent(pSim, pDevice->m_ui64BootupTick, kCsmEventBootup, uiDevice, 0);
+    }
+
+
+    // run event loop
+    ui64EndTick = (uint64_t)pConfig_p->m_uiSimDays * 24 * 60 * 60 * 1000;
+    while ( !pSim->m_EventQueue.empty() )
+    {
+        Event = pSim->m_EventQueue.top();
+        if (Event.m_ui64Tick > ui64EndTick)
+        {
+            break;
+        }
+        pSim->m_EventQueue.pop();
+        pResult_p->m_ui64Events++;
+
+        pSim->m_ui64Tick = Event.m_ui64Tick;
+
+        switch (Event.m_EventType)
+        {
+            case kCsmEventTxEnd:
+            {
+                CsmOnTxEnd(pSim, Event.m_ui32Param);
+                break;
+            }
+
+            case kCsmEventBootup:
+            {
+                CsmOnBootup(pSim, Event.m_uiDevice);
+                break;
+            }
+
+            case kCsmEventAsync:
+            {
+                // same as <LoraSignalAsyncTransmitEvent()>, evaluated by the next run of the LoRa Transmit Task
+                pSim->m_vecDevices[Event.m_uiDevice].m_fAsyncTransmitEvent = true;
+                pResult_p->m_ui64AsyncEvents++;
+                CsmScheduleCheck(pSim, Event.m_uiDevice, 0);
+                CsmScheduleAsyncEvent(pSim, Event.m_uiDevice);
+                break;
+            }
+
+            case kCsmEventCheck:
+            {
+                if (Event.m_ui32Param == pSim->m_vecDevices[Event.m_uiDevice].m_ui32CheckGen)
+                {
+                    CsmOnCheck(pSim, Event.m_uiDevice);
+                }
+                break;
+            }
+        }
+    }
+
+    pResult_p->m_ui64SimTimeMs = ui64EndTick;
+    pResult_p->m_dRunTime = CsmGetWallTime() - dStartTime;
+
+    ArduinoSimSetRandomState(NULL);
+    delete pSim;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Print Header of Result Table
+//---------------------------------------------------------------------------
+
+void  CsmPrintResultHeader (void)
+{
+
+    printf("Devices   DataPkts    Lost  Captured   Load     PDR   Gen0 only    +Gen1..N   Deferred   Events  Time[s]\n");
+    printf("-------  ---------  ------  --------  -----  ------  ---------  ----------  ---------  -------  -------\n");
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Print Result as Line of Result Table
+//---------------------------------------------------------------------------
+
+void  CsmPrintResult (
+    const tCsmResult* pResult_p)                        // [IN]     Ptr to Result
+{
+
+uint64_t  ui64TxPackets;
+uint64_t  ui64Delivered;
+double    dLoad;
+double    dPdr;
+double    dGen0Ratio;
+double    dRecordRatio;
+uint      uiDataGen;
+
+
+    ui64TxPackets = pResult_p->m_ui64TxBootup + pResult_p->m_ui64TxData;
+    ui64Delivered = 0;
+    for (uiDataGen=0; uiDataGen<LORA_DATA_GEN_DEPTH_MAX; uiDataGen++)
+    {
+        ui64Delivered += pResult_p->m_aui64Delivered[uiDataGen];
+    }
+
+    // offered channel load G (pure ALOHA without capture: PDR = e^(-2G))
+    dLoad        = (pResult_p->m_ui64SimTimeMs > 0) ? ((double)pResult_p->m_ui64AirTimeUs / ((double)pResult_p->m_ui64SimTimeMs * 1000.0)) : 0;
+    dPdr         = (ui64TxPackets > 0) ? ((double)pResult_p->m_ui64RxPackets * 100.0 / (double)ui64TxPackets) : 0;
+    dGen0Ratio   = (pResult_p->m_ui64TxData > 0) ? ((double)pResult_p->m_aui64Delivered[0] * 100.0 / (double)pResult_p->m_ui64TxData) : 0;
+    dRecordRatio = (pResult_p->m_ui64TxData > 0) ? ((double)ui64Delivered * 100.0 / (double)pResult_p->m_ui64TxData) : 0;
+
+    printf("%7u  %9llu  %5.2f%%  %8llu  %5.3f  %5.2f%%    %6.2f%%     %6.2f%%  %9llu  %6.1fM  %7.2f\n",
+           pResult_p->m_uiDevices,
+           (unsigned long long)pResult_p->m_ui64TxData,
+           (ui64TxPackets > 0) ? ((double)pResult_p->m_ui64Collisions * 100.0 / (double)ui64TxPackets) : 0,
+           (unsigned long long)pResult_p->m_ui64Captured,
+           dLoad, dPdr, dGen0Ratio, dRecordRatio,
+           (unsigned long long)pResult_p->m_ui64DeferredChecks,
+           (double)pResult_p->m_ui64Events / 1000000.0,
+           pResult_p->m_dRunTime);
+
+    return;
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Set Time Base of Device (millis() = Uptime of Device in its own Clock)
+//---------------------------------------------------------------------------
+
+static  void  CsmSetDeviceTick (
+    tCsmSimulation* pSim_p,
+    uint uiDevice_p)
+{
+
+tCsmDevice*  pDevice;
+
+
+    pDevice = &pSim_p->m_vecDevices[uiDevice_p];
+    ArduinoSimSetTick((uint64_t)((double)(pSim_p->m_ui64Tick - pDevice->m_ui64BootupTick) * pDevice->m_dClockRate));
+    ArduinoSimSetRandomState(&pDevice->m_ui32RandomState);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Post Event
+//---------------------------------------------------------------------------
+
+static  void  CsmPostEvent (
+    tCsmSimulation* pSim_p,
+    uint64_t ui64Tick_p,
+    tCsmEventType EventType_p,
+    uint uiDevice_p,
+    uint32_t ui32Param_p)
+{
+
+tCsmEvent  Event;
+
+
+    Event.m_ui64Tick   = ui64Tick_p;
+    Event.m_ui64Order  = pSim_p->m_ui64EventOrder++;
+    Event.m_EventType  = EventType_p;
+    Event.m_uiDevice   = uiDevice_p;
+    Event.m_ui32Param  = ui32Param_p;
+    pSim_p->m_EventQueue.push(Event);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Schedule next Run of LoRa Transmit Task
+//---------------------------------------------------------------------------
+
+//  The firmware polls <GetReasonToTransmitPacket()> every PollPeriod. Instead
+//  of simulating every poll, only the first poll at which the result can
+//  change is scheduled, aligned to the poll grid of the device.
+
+static  void  CsmScheduleCheck (
+    tCsmSimulation* pSim_p,
+    uint uiDevice_p,
+    uint32_t ui32Delay_p)
+{
+
+tCsmDevice*  pDevice;
+double       dPollPeriod;
+double       dPolls;
+uint64_t     ui64Tick;
+
+
+    pDevice = &pSim_p->m_vecDevices[uiDevice_p];
+
+    // delay and poll period are given in device time
+    dPollPeriod = (double)pSim_p->m_pConfig->m_ui32PollPeriod / pDevice->m_dClockRate;
+
+    // next poll at or after (now + delay), but not the current one again
+    ui64Tick = pSim_p->m_ui64Tick + (uint64_t)((double)ui32Delay_p / pDevice->m_dClockRate);
+    dPolls = ceil((double)(ui64Tick - pDevice->m_ui64BootupTick) / dPollPeriod);
+    ui64Tick = pDevice->m_ui64BootupTick + (uint64_t)ceil(dPolls * dPollPeriod);
+    if (ui64Tick <= pSim_p->m_ui64Tick)
+    {
+        ui64Tick = pDevice->m_ui64BootupTick + (uint64_t)ceil((dPolls + 1) * dPollPeriod);
+    }
+
+    pDevice->m_ui32CheckGen++;
+    CsmPostEvent(pSim_p, ui64Tick, kCsmEventCheck, uiDevice_p, pDevice->m_ui32CheckGen);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Schedule next asynchronous Transmit Event (Poisson Process)
+//---------------------------------------------------------------------------
+
+static  void  CsmScheduleAsyncEvent (
+    tCsmSimulation* pSim_p,
+    uint uiDevice_p)
+{
+
+double  dInterval;
+
+
+    if (pSim_p->m_pConfig->m_dAsyncEventsPerHour <= 0)
+    {
+        return;
+    }
+
+    std::exponential_distribution<double>  AsyncDist(pSim_p->m_pConfig->m_dAsyncEventsPerHour / (60.0 * 60.0 * 1000.0));
+    dInterval = AsyncDist(pSim_p->m_RandomGen);
+    CsmPostEvent(pSim_p, pSim_p->m_ui64Tick + (uint64_t)dInterval + 1, kCsmEventAsync, uiDevice_p, 0);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Device Bootup (same sequence as setup() of LoraAmbientMonitor.ino)
+//---------------------------------------------------------------------------
+
+static  void  CsmOnBootup (
+    tCsmSimulation* pSim_p,
+    uint uiDevice_p)
+{
+
+tCsmDevice*  pDevice;
+uint32_t     ui32NextTransmitCycleTime;
+
+
+    pDevice = &pSim_p->m_vecDevices[uiDevice_p];
+    CsmSetDeviceTick(pSim_p, uiDevice_p);
+
+    // the DevID has only 4 bits in the LoRa Packet, the gateway side of the
+    // simulation distinguishes the devices by their index instead
+    pDevice->m_LoraTransmitter.Setup(&pSim_p->m_TransmitterSettings, ((unsigned long)(uiDevice_p + 1) * 1000) ^ pSim_p->m_pConfig->m_ui32Seed);
+    pDevice->m_LoraPayloadEnc.Setup((uint8_t)(uiDevice_p & 0x0F));
+    pDevice->m_LoraPayloadEnc.SetupGenerationDepth(pSim_p->m_pConfig->m_uiGenDepth);
+    pDevice->m_LoraPayloadEnc.SetupCompactLayout(pSim_p->m_pConfig->m_fCompactLayout, pSim_p->m_pConfig->m_ui8SensorLayout);
+    if ( pSim_p->m_pConfig->m_fSlottedSchedule )
+    {
+        // as in LoraAmbientMonitor.ino: one Slot per device, Guard Time = Check Period
+        pDevice->m_LoraTransmitter.SetupSlottedSchedule((uint16_t)uiDevice_p, (uint16_t)pSim_p->m_pConfig->m_uiDevices,
+                                                        pSim_p->m_pConfig->m_ui32CycleTime, pSim_p->m_pConfig->m_ui32PollPeriod);
+    }
+
+    pDevice->m_LoraPayloadEnc.EncodeTxBootupPacket(&pSim_p->m_DeviceConfig);
+    pDevice->m_LoraTransmitter.TransmitPacket(pDevice->m_LoraPayloadEnc.GetTxBootupPacket(), CSM_TX_PACKET_LEN);
+    CsmStartTransmission(pSim_p, uiDevice_p, pDevice->m_LoraPayloadEnc.GetTxBootupPacket(), CSM_TX_PACKET_LEN);
+    pSim_p->m_pResult->m_ui64TxBootup++;
+
+    ui32NextTransmitCycleTime = pDevice->m_LoraTransmitter.CalcNextTransmitCycleTime(pSim_p->m_pConfig->m_ui32InhibitTime, pSim_p->m_pConfig->m_ui32FirstTime);
+    CsmScheduleCheck(pSim_p, uiDevice_p, ui32NextTransmitCycleTime);
+    CsmScheduleAsyncEvent(pSim_p, uiDevice_p);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Run of LoRa Transmit Task (same sequence as TaskLoraTransmit())
+//---------------------------------------------------------------------------
+
+static  void  CsmOnCheck (
+    tCsmSimulation* pSim_p,
+    uint uiDevice_p)
+{
+
+tCsmDevice*                          pDevice;
+LoraPayloadEncoder::tSensorDataRec   SensorDataRec;
+const void*                          pPayload;
+unsigned int                         uiPayloadLen;
+int32_t                              i32RemainingTime;
+uint32_t                             ui32Delay;
+int                                  iRes;
+
+
+    pDevice = &pSim_p->m_vecDevices[uiDevice_p];
+    CsmSetDeviceTick(pSim_p, uiDevice_p);
+
+    iRes = pDevice->m_LoraTransmitter.GetReasonToTransmitPacket(&pDevice->m_fAsyncTransmitEvent, pDevice->m_LoraPayloadEnc.GetTxDataPayloadMaxSize());
+    if (iRes > 0)
+    {
+        memset(&SensorDataRec, 0x00, sizeof(SensorDataRec));
+        SensorDataRec.m_ui32Uptime    = (uint32_t)((pSim_p->m_ui64Tick - pDevice->m_ui64BootupTick) / 1000);
+        SensorDataRec.m_flTemperature = 20.0f;
+        SensorDataRec.m_flHumidity    = 50.0f;
+        SensorDataRec.m_fMotionActive = (iRes == 1);
+        pDevice->m_LoraPayloadEnc.EncodeTxDataPacket(&SensorDataRec);
+        pPayload = pDevice->m_LoraPayloadEnc.GetTxDataPayload(&uiPayloadLen);
+        pDevice->m_LoraTransmitter.TransmitPacket(pPayload, (uint8_t)uiPayloadLen);
+        CsmStartTransmission(pSim_p, uiDevice_p, pPayload, uiPayloadLen);
+        pSim_p->m_pResult->m_ui64TxData++;
+
+        pDevice->m_LoraTransmitter.CalcNextTransmitCycleTime(pSim_p->m_pConfig->m_ui32InhibitTime, pSim_p->m_pConfig->m_ui32CycleTime);
+    }
+    else if (iRes == -2)
+    {
+        pSim_p->m_pResult->m_ui64DeferredChecks++;
+        CsmScheduleCheck(pSim_p, uiDevice_p, pDevice->m_LoraTransmitter.GetDutyCycleWaitTime(pDevice->m_LoraPayloadEnc.GetTxDataPayloadMaxSize()));
+        return;
+    }
+
+    if ( pDevice->m_fAsyncTransmitEvent )
+    {
+        // event pending during inhibit time -> poll
+        ui32Delay = pSim_p->m_pConfig->m_ui32PollPeriod;
+    }
+    else
+    {
+        i32RemainingTime = pDevice->m_LoraTransmitter.GetRemainingTransmitCycleTime();
+        ui32Delay = (i32RemainingTime > 0) ? (uint32_t)i32RemainingTime : pSim_p->m_pConfig->m_ui32PollPeriod;
+    }
+    CsmScheduleCheck(pSim_p, uiDevice_p, ui32Delay);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Start Transmission on Channel
+//---------------------------------------------------------------------------
+
+static  void  CsmStartTransmission (
+    tCsmSimulation* pSim_p,
+    uint uiDevice_p,
+    const void* pPayload_p,
+    uint uiPayloadLen_p)
+{
+
+tCsmTransmission  Transmission;
+uint32_t          ui32TimeOnAirUs;
+size_t            nIdx;
+
+
+    Transmission.m_ui32TxID       = pSim_p->m_ui32NextTxID++;
+    Transmission.m_uiDevice       = uiDevice_p;
+    Transmission.m_iRssi          = pSim_p->m_vecDevices[uiDevice_p].m_iRssi;
+    Transmission.m_iMaxInterferer = CSM_RSSI_NONE;
+    Transmission.m_uiPayloadLen   = uiPayloadLen_p;
+    memcpy(Transmission.m_abPayload, pPayload_p, uiPayloadLen_p);
+
+    // all transmissions still on air overlap with the new one
+    for (nIdx=0; nIdx<pSim_p->m_vecActiveTx.size(); nIdx++)
+    {
+        if (pSim_p->m_vecActiveTx[nIdx].m_iMaxInterferer < Transmission.m_iRssi)
+        {
+            pSim_p->m_vecActiveTx[nIdx].m_iMaxInterferer = Transmission.m_iRssi;
+        }
+        if (Transmission.m_iMaxInterferer < pSim_p->m_vecActiveTx[nIdx].m_iRssi)
+        {
+            Transmission.m_iMaxInterferer = pSim_p->m_vecActiveTx[nIdx].m_iRssi;
+        }
+    }
+    pSim_p->m_vecActiveTx.push_back(Transmission);
+
+    // Delta DataPackets have a variable length, so time-on-air is calculated per Packet
+    ui32TimeOnAirUs = CsmCalcTimeOnAir(pSim_p, uiPayloadLen_p);
+    pSim_p->m_pResult->m_ui64AirTimeUs += ui32TimeOnAirUs;
+    CsmPostEvent(pSim_p, pSim_p->m_ui64Tick + ((ui32TimeOnAirUs + 999) / 1000), kCsmEventTxEnd, uiDevice_p, Transmission.m_ui32TxID);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  End of Transmission on Channel
+//---------------------------------------------------------------------------
+
+static  void  CsmOnTxEnd (
+    tCsmSimulation* pSim_p,
+    uint32_t ui32TxID_p)
+{
+
+tCsmTransmission  Transmission;
+size_t            nIdx;
+bool              fReceived;
+
+
+    for (nIdx=0; nIdx<pSim_p->m_vecActiveTx.size(); nIdx++)
+    {
+        if (pSim_p->m_vecActiveTx[nIdx].m_ui32TxID == ui32TxID_p)
+        {
+            break;
+        }
+    }
+    if (nIdx >= pSim_p->m_vecActiveTx.size())
+    {
+        return;
+    }
+    Transmission = pSim_p->m_vecActiveTx[nIdx];
+    pSim_p->m_vecActiveTx[nIdx] = pSim_p->m_vecActiveTx.back();
+    pSim_p->m_vecActiveTx.pop_back();
+
+    if (Transmission.m_iMaxInterferer == CSM_RSSI_NONE)
+    {
+        fReceived = true;
+    }
+    else if ((pSim_p->m_pConfig->m_iCaptureThreshold != CSM_CAPTURE_DISABLED) &&
+             ((Transmission.m_iRssi - Transmission.m_iMaxInterferer) >= pSim_p->m_pConfig->m_iCaptureThreshold))
+    {
+        fReceived = true;
+        pSim_p->m_pResult->m_ui64Captured++;
+    }
+    else
+    {
+        fReceived = false;
+        pSim_p->m_pResult->m_ui64Collisions++;
+    }
+
+    if ( fReceived )
+    {
+        pSim_p->m_pResult->m_ui64RxPackets++;
+        CsmReceivePacket(pSim_p, &Transmission);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Gateway: decode Packet and qualify its Records (same as LoraPacketRecv)
+//---------------------------------------------------------------------------
+
+static  void  CsmReceivePacket (
+    tCsmSimulation* pSim_p,
+    const tCsmTransmission* pTransmission_p)
+{
+
+LoraPayloadDecoder::tLoraStationData  LoraStationData;
+tLoraPacketType  PacketType;
+uint32_t*        paui32SequNumHistList;
+int              iDataGen;
+int              iRes;
+
+
+    paui32SequNumHistList = pSim_p->m_vecDevices[pTransmission_p->m_uiDevice].m_aui32SequNumHistList;
+
+    PacketType = pSim_p->m_LoraPayloadDec.GetRxPacketType((const tLoraDataPacket*)pTransmission_p->m_abPayload);
+    if (PacketType == kLoraPacketBootup)
+    {
+        MquIsSequNumToBeProcessed(paui32SequNumHistList, kLoraPacketBootup, 0);
+        return;
+    }
+
+    if (PacketType == kLoraPacketDataHeaderCompact)
+    {
+        LoraStationData = pSim_p->m_LoraPayloadDec.DecodeRxDataCompactPacket((const tLoraDataCompactPacket*)pTransmission_p->m_abPayload,
+                                                                             pTransmission_p->m_uiPayloadLen);
+    }
+    else if (PacketType == kLoraPacketDataHeaderDelta)
+    {
+        LoraStationData = pSim_p->m_LoraPayloadDec.DecodeRxDataDeltaPacket((const tLoraDataDeltaPacket*)pTransmission_p->m_abPayload,
+                                                                           pTransmission_p->m_uiPayloadLen);
+    }
+    else
+    {
+        LoraStationData = pSim_p->m_LoraPayloadDec.DecodeRxDataPacket((const tLoraDataPacket*)pTransmission_p->m_abPayload);
+    }
+    if (LoraStationData.m_DataHeader.m_DataStatus != LoraPayloadDecoder::kStatusValid)
+    {
+        return;
+    }
+
+    // process generations in order GenN..Gen1/Gen0, as done by LoraPacketRecv
+    for (iDataGen=(int)LoraStationData.m_uiNumDataRec-1; iDataGen>=0; iDataGen--)
+    {
+        if (LoraStationData.m_aDataRec[iDataGen].m_DataStatus != LoraPayloadDecoder::kStatusValid)
+        {
+            continue;
+        }
+        iRes = MquIsSequNumToBeProcessed(paui32SequNumHistList, LoraStationData.m_aDataRec[iDataGen].m_PacketType,
+                                         LoraStationData.m_DataHeader.m_ui32SequNum - iDataGen);
+        if (iRes == 1)
+        {
+            pSim_p->m_pResult->m_aui64Delivered[iDataGen]++;
+        }
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Calculate time-on-air of a Packet [us]
+//---------------------------------------------------------------------------
+
+static  uint32_t  CsmCalcTimeOnAir (
+    const tCsmSimulation* pSim_p,
+    uint uiPayloadLen_p)
+{
+
+uint32_t  ui32TimeOnAirUs;
+
+
+    ui32TimeOnAirUs = LoraTransmitter::CalcTimeOnAir(pSim_p->m_pConfig->m_iSpreadingFactor, pSim_p->m_pConfig->m_lSignalBandwidth,
+                                                     pSim_p->m_pConfig->m_iCodingRateDenominator, LoraTransmitter::LORA_PREAMBLE_LENGTH,
+                                                     LoraTransmitter::LORA_CRC_ENABLED, false, (uint8_t)uiPayloadLen_p);
+
+    return (ui32TimeOnAirUs);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Wall Clock Time [sec]
+//---------------------------------------------------------------------------
+
+static  double  CsmGetWallTime (void)
+{
+
+struct timespec  TimeSpec;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &TimeSpec);
+
+    return ((double)TimeSpec.tv_sec + ((double)TimeSpec.tv_nsec / 1000000000.0));
+
+}
+
+
+
+// EOF
@@ -0,0 +1,109 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Channel Simulator
+  Description:  Declarations for Discrete-Event Simulation of LoRa Channel
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Slotted Transmit Schedule, Bootup Spread and Clock Drift
+  2026/10/18 -rs:   V1.02 Generation Depth of Data Packets
+  2026/10/18 -rs:   V1.03 Compact Data Packets with Sensor dependent Layout
+
+****************************************************************************/
+
+#ifndef _CHANNELSIM_H_
+#define _CHANNELSIM_H_
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+const  uint  CSM_MAX_DEVICES            = 100000;
+const  uint  CSM_MAX_SLOTTED_DEVICES    = 65535;            // SlotID of <LoraTransmitter> is 16 bit
+const  int   CSM_CAPTURE_DISABLED       = -1;
+
+
+
+//---------------------------------------------------------------------------
+//  Type definitions
+//---------------------------------------------------------------------------
+
+typedef struct
+{
+    uint                m_uiDevices;                // number of devices sharing the channel
+    uint                m_uiSimDays;                // simulated time [days]
+    uint32_t            m_ui32FirstTime;            // Bootup -> first DataPacket [ms] (LORA_PACKET_FIRST_TIME)
+    uint32_t            m_ui32CycleTime;            // time between DataPackets [ms] (LORA_PACKET_CYCLE_TIME)
+    uint32_t            m_ui32InhibitTime;          // LORA_PACKET_INHIBIT_TIME [ms]
+    uint32_t            m_ui32PollPeriod;           // TASK_PERIOD_LORA_TRANSMIT [ms]
+    uint32_t            m_ui32BootupSpread;         // devices are switched on uniformly within this time [ms]
+    double              m_dClockDriftPpm;           // max. deviation of device clocks [ppm], distributed uniformly
+    bool                m_fSlottedSchedule;         // false = random Cycle Time, true = Slot per device (CFG_ENABLE_LORA_SLOTTED_SCHEDULE)
+    double              m_dAsyncEventsPerHour;      // asynchronous transmit events per device, 0 = off (DIP1)
+    uint                m_uiGenDepth;               // 0 = classic DataPacket (Gen0/Gen1/Gen2), 1..16 = Delta DataPacket (CFG_LORA_DATA_GEN_DEPTH)
+    bool                m_fCompactLayout;           // Compact DataPacket (CFG_LORA_DATA_COMPACT_LAYOUT)
+    uint8_t             m_ui8SensorLayout;          // LORA_DATA_LAYOUT_xxx of Compact DataPacket
+    int                 m_iSpreadingFactor;
+    long                m_lSignalBandwidth;         // [Hz]
+    int                 m_iCodingRateDenominator;
+    uint16_t            m_ui16DutyCycleLimit;       // [1/10 %], 0 = no limit
+    uint32_t            m_ui32DutyCycleWindow;      // [ms]
+    int                 m_iCaptureThreshold;        // [dB] power ratio to survive an overlap, CSM_CAPTURE_DISABLED = every overlap is a collision
+    int                 m_iRssiMin;                 // [dBm] RSSI of devices is distributed uniformly
+    int                 m_iRssiMax;                 // [dBm]
+    uint32_t            m_ui32Seed;
+
+} tCsmConfig;
+
+
+typedef struct
+{
+    uint                m_uiDevices;
+    uint64_t            m_ui64SimTimeMs;
+    uint64_t            m_ui64Events;               // processed simulation events
+    uint64_t            m_ui64TxBootup;             // transmitted Bootup Packets
+    uint64_t            m_ui64TxData;               // transmitted Data Packets (= generated Data Records)
+    uint64_t            m_ui64RxPackets;            // Packets received by Gateway
+    uint64_t            m_ui64Collisions;           // Packets lost by overlapping transmissions
+    uint64_t            m_ui64Captured;             // Packets received despite overlap (capture effect)
+    uint64_t            m_ui64AsyncEvents;
+    uint64_t            m_ui64DeferredChecks;       // transmit checks deferred by Duty Cycle Budget
+    uint64_t            m_aui64Delivered[LORA_DATA_GEN_DEPTH_MAX];  // Data Records processed by <MquIsSequNumToBeProcessed> from Gen0..GenN
+    uint64_t            m_ui64AirTimeUs;            // sum of time-on-air of all Packets
+    uint                m_uiDataPacketLen;          // max. length of a DataPacket [Bytes]
+    uint32_t            m_ui32TimeOnAirUs;          // time-on-air of one DataPacket with max. length
+    double              m_dRunTime;                 // wall clock time of simulation [sec]
+
+} tCsmResult;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of public functions
+//---------------------------------------------------------------------------
+
+void  CsmGetDefaultConfig (
+    tCsmConfig* pConfig_p);                             // [OUT]    Ptr to Configuration
+
+int   CsmRunSimulation (
+    const tCsmConfig* pConfig_p,                        // [IN]     Ptr to Configuration
+    tCsmResult* pResult_p);                             // [OUT]    Ptr to Result
+
+void  CsmPrintResultHeader (void);
+
+void  CsmPrintResult (
+    const tCsmResult* pResult_p);                       // [IN]     Ptr to Result
+
+
+
+#endif  // #ifndef _CHANNELSIM_H_
+
+
+// EOF
@@ -0,0 +1,70 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Channel Simulator
+  Description:  Host Replacement of Arduino Runtime (subset used by the
+                Firmware Classes <LoraTransmitter> and <LoraPayloadEncoder>)
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _ARDUINO_H_
+#define _ARDUINO_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+
+
+//---------------------------------------------------------------------------
+//  Simulation Context
+//---------------------------------------------------------------------------
+
+//  Each simulation thread has its own virtual time base, and each simulated
+//  device has its own state of the random generator. Both are selected by
+//  the simulator before calling a method of the firmware classes, so several
+//  independent simulations can run in parallel threads.
+
+void  ArduinoSimSetTick (
+    uint64_t ui64Tick_p);                               // [IN]     Virtual Time of calling Thread [ms]
+
+void  ArduinoSimSetRandomState (
+    uint32_t* pui32RandomState_p);                      // [IN]     Ptr to Random Generator State of current Device
+
+
+
+//---------------------------------------------------------------------------
+//  Arduino Runtime
+//---------------------------------------------------------------------------
+
+unsigned long  millis (void);                           // 32Bit as on ESP32, wraps after 49.7 days
+void  delay (uint32_t ui32Delay_p);
+long  random (long lHowBig_p);
+long  random (long lHowSmall_p, long lHowBig_p);
+void  randomSeed (unsigned long ulSeed_p);
+
+
+class  SimSerial
+{
+    public:
+        void  print (const char* pszText_p);
+        void  println (const char* pszText_p);
+};
+
+extern  SimSerial  Serial;
+
+
+
+#endif  // _ARDUINO_H_
+
+
+// EOF
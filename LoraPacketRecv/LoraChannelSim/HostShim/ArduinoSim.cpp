@@ -0,0 +1,196 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Channel Simulator
+  Description:  Implementation of Host Replacement of Arduino Runtime
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#include "Arduino.h"
+#include "SPI.h"
+#include "LoRa.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+SimSerial  Serial;
+SimSPI     SPI;
+SimLoRa    LoRa;
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+static  thread_local  uint64_t   ui64Tick_l             = 0;
+static  thread_local  uint32_t   ui32DefRandomState_l   = 1;
+static  thread_local  uint32_t*  pui32RandomState_l     = &ui32DefRandomState_l;
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Set Virtual Time of calling Thread
+//---------------------------------------------------------------------------
+
+void  ArduinoSimSetTick (
+    uint64_t ui64Tick_p)                                // [IN]     Virtual Time of calling Thread [ms]
+{
+
+    ui64Tick_l = ui64Tick_p;
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Select Random Generator State of current Device
+//---------------------------------------------------------------------------
+
+void  ArduinoSimSetRandomState (
+    uint32_t* pui32RandomState_p)                       // [IN]     Ptr to Random Generator State of current Device
+{
+
+    pui32RandomState_l = (pui32RandomState_p != NULL) ? pui32RandomState_p : &ui32DefRandomState_l;
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  millis
+//---------------------------------------------------------------------------
+
+unsigned long  millis (void)
+{
+
+    return ((unsigned long)(uint32_t)ui64Tick_l);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  delay (virtual time is advanced by the Simulator only)
+//---------------------------------------------------------------------------
+
+void  delay (
+    uint32_t ui32Delay_p)
+{
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  random / randomSeed (Xorshift32, one state per simulated Device)
+//---------------------------------------------------------------------------
+
+long  random (
+    long lHowBig_p)
+{
+
+uint32_t  ui32State;
+
+
+    if (lHowBig_p <= 0)
+    {
+        return (0);
+    }
+
+    ui32State = *pui32RandomState_l;
+    ui32State ^= ui32State << 13;
+    ui32State ^= ui32State >> 17;
+    ui32State ^= ui32State << 5;
+    *pui32RandomState_l = ui32State;
+
+    return ((long)(ui32State % (uint32_t)lHowBig_p));
+
+}
+
+
+long  random (
+    long lHowSmall_p,
+    long lHowBig_p)
+{
+
+    if (lHowSmall_p >= lHowBig_p)
+    {
+        return (lHowSmall_p);
+    }
+
+    return (lHowSmall_p + random(lHowBig_p - lHowSmall_p));
+
+}
+
+
+void  randomSeed (
+    unsigned long ulSeed_p)
+{
+
+    // the state of Xorshift must not be 0
+    *pui32RandomState_l = ((uint32_t)ulSeed_p * 2654435761U) | 1;
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Serial (only used by <LoraTransmitter::DumpBuffer>)
+//---------------------------------------------------------------------------
+
+void  SimSerial::print (
+    const char* pszText_p)
+{
+
+    fputs(pszText_p, stdout);
+    return;
+
+}
+
+
+void  SimSerial::println (
+    const char* pszText_p)
+{
+
+    puts(pszText_p);
+    return;
+
+}
+
+
+
+// EOF
@@ -0,0 +1,48 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Channel Simulator
+  Description:  Host Replacement of Arduino LoRa Library, the Radio
+                Channel itself is modeled by the Simulator
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _LORA_H_
+#define _LORA_H_
+
+#define PA_OUTPUT_RFO_PIN       0
+#define PA_OUTPUT_PA_BOOST_PIN  1
+
+
+
+class  SimLoRa
+{
+    public:
+        void    setPins (int iSs_p, int iReset_p, int iDio0_p)              { return; }
+        void    setTxPower (int iLevel_p, int iOutputPin_p)                 { return; }
+        void    setSpreadingFactor (int iSF_p)                              { return; }
+        void    setSignalBandwidth (long lSbw_p)                            { return; }
+        void    setCodingRate4 (int iDenominator_p)                         { return; }
+        int     begin (long lFrequency_p)                                   { return (1); }
+        int     beginPacket (void)                                          { return (1); }
+        size_t  write (const uint8_t* pabBuffer_p, size_t nSize_p)          { return (nSize_p); }
+        int     endPacket (bool fAsync_p = false)                           { return (1); }
+        void    sleep (void)                                                { return; }
+        void    idle (void)                                                 { return; }
+};
+
+extern  SimLoRa  LoRa;
+
+
+
+#endif  // _LORA_H_
+
+
+// EOF
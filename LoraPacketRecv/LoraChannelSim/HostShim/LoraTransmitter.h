@@ -0,0 +1,21 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Channel Simulator
+  Description:  The Firmware includes "LoraTransmitter.h" while the file is
+                named "LoRaTransmitter.h", which only works on case
+                insensitive file systems (Arduino IDE on Windows)
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#include "../../../LoraAmbientMonitor/LoraAmbientMonitor/LoRaTransmitter.h"
+
+
+// EOF
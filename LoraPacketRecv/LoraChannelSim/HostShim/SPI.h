@@ -0,0 +1,34 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Channel Simulator
+  Description:  Host Replacement of Arduino SPI Library
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _SPI_H_
+#define _SPI_H_
+
+
+
+class  SimSPI
+{
+    public:
+        void  begin (int iSck_p, int iMiso_p, int iMosi_p, int iSs_p)  { return; }
+};
+
+extern  SimSPI  SPI;
+
+
+
+#endif  // _SPI_H_
+
+
+// EOF
@@ -0,0 +1,639 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Channel Simulator
+  Description:  Implementation of Main Module
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Options for slotted Transmit Schedule, Bootup Spread
+                          and Clock Drift
+  2026/10/18 -rs:   V1.02 Option for Generation Depth of Data Packets
+  2026/10/18 -rs:   V1.03 Option for Compact Data Packets
+
+****************************************************************************/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include "LoraPacket.h"
+#include "ChannelSim.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+#define APP_VER_MAIN            1                       // Version 1.xx
+#define APP_VER_REL             3                       // Version x.03
+
+#define APP_MAX_SCENARIOS       32
+
+
+static  const  uint             APP_DEF_DEVICE_LIST[]   = { 10, 20, 50, 100, 200, 500, 1000 };
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+static  tCsmConfig              CsmConfig_l;
+static  uint                    auiDeviceList_l[APP_MAX_SCENARIOS];
+static  uint                    uiScenarioCount_l       = 0;
+static  uint                    uiThreads_l             = 0;
+
+static  tCsmResult              aCsmResult_l[APP_MAX_SCENARIOS];
+static  int                     aiSimRes_l[APP_MAX_SCENARIOS];
+static  std::atomic<uint>       uiNextScenario_l;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  bool  AppEvalCmdlnArgs (int iArgCnt_p, char* apszArg_p[]);
+static  void  AppPrintHelpScreen  (const char* pszArg0_p);
+static  bool  AppParseDeviceList (const char* pszDeviceList_p);
+
+static  void  AppWorkerThread (void);
+
+static  double  AppGetTime (void);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Main function of this application
+//---------------------------------------------------------------------------
+
+int  main (int iArgCnt_p, char* apszArg_p[])
+{
+
+std::vector<std::thread>  vecThreads;
+double   dStartTime;
+uint     uiScenario;
+uint     uiThread;
+uint     uiIdx;
+bool     fRes;
+
+
+    //-------------------------------------------------------------------
+    // Step(1): Setup
+    //-------------------------------------------------------------------
+    printf("\n");
+    printf("********************************************************************\n");
+    printf("  LoRa Channel Simulator\n");
+    printf("  Version: %u.%02u\n", APP_VER_MAIN, APP_VER_REL);
+    printf("  (c) 2026 Ronald Sieber\n");
+    printf("********************************************************************\n");
+    printf("\n");
+
+
+    // setup Workspace
+    CsmGetDefaultConfig(&CsmConfig_l);
+    CsmConfig_l.m_ui32BootupSpread = 0xFFFFFFFF;            // default: one cycle (option '-c' may follow)
+    uiScenarioCount_l = sizeof(APP_DEF_DEVICE_LIST) / sizeof(APP_DEF_DEVICE_LIST[0]);
+    for (uiIdx=0; uiIdx<uiScenarioCount_l; uiIdx++)
+    {
+        auiDeviceList_l[uiIdx] = APP_DEF_DEVICE_LIST[uiIdx];
+    }
+    uiThreads_l = std::thread::hardware_concurrency();
+
+
+    // evaluate Command Line Arguments
+    fRes = AppEvalCmdlnArgs(iArgCnt_p, apszArg_p);
+    if ( !fRes )
+    {
+        AppPrintHelpScreen(apszArg_p[0]);
+        return (-1);
+    }
+
+    if (CsmConfig_l.m_ui32BootupSpread == 0xFFFFFFFF)
+    {
+        CsmConfig_l.m_ui32BootupSpread = CsmConfig_l.m_ui32CycleTime;
+    }
+
+    if (uiThreads_l == 0)
+    {
+        uiThreads_l = 1;
+    }
+    if (uiThreads_l > uiScenarioCount_l)
+    {
+        uiThreads_l = uiScenarioCount_l;
+    }
+
+
+    // print Runtime Configuration
+    printf("Runtime Configuration:\n");
+    printf("  '-n' Devices       = ");
+    for (uiIdx=0; uiIdx<uiScenarioCount_l; uiIdx++)
+    {
+        printf("%s%u", (uiIdx > 0) ? "," : "", auiDeviceList_l[uiIdx]);
+    }
+    printf("\n");
+    printf("  '-d' SimDays       = %u\n", CsmConfig_l.m_uiSimDays);
+    printf("  '-c' CycleTime     = %u [min]\n", (uint)(CsmConfig_l.m_ui32CycleTime / (60 * 1000)));
+    printf("  '-a' AsyncEvents   = %.2f [1/h]\n", CsmConfig_l.m_dAsyncEventsPerHour);
+    printf("  '-q' Schedule      = %s\n", CsmConfig_l.m_fSlottedSchedule ? "slotted" : "random");
+    printf("  '-b' BootupSpread  = %u [sec]\n", (uint)(CsmConfig_l.m_ui32BootupSpread / 1000));
+    printf("  '-p' ClockDrift    = %.1f [ppm]\n", CsmConfig_l.m_dClockDriftPpm);
+    if (CsmConfig_l.m_uiGenDepth == 0)
+    {
+        printf("  '-g' GenDepth      = classic (Gen0/Gen1/Gen2)\n");
+    }
+    else
+    {
+        printf("  '-g' GenDepth      = %u (Delta, Gen0..Gen%u)\n", CsmConfig_l.m_uiGenDepth, CsmConfig_l.m_uiGenDepth - 1);
+    }
+    if ( CsmConfig_l.m_fCompactLayout )
+    {
+        printf("  '-m' SensorLayout  = 0x%02X (Compact)\n", (uint)CsmConfig_l.m_ui8SensorLayout);
+    }
+    else
+    {
+        printf("  '-m' SensorLayout  = off\n");
+    }
+    printf("  '-s' SpreadFactor  = SF%d\n", CsmConfig_l.m_iSpreadingFactor);
+    printf("  '-l' DutyCycle     = %u.%u%%\n", CsmConfig_l.m_ui16DutyCycleLimit / 10, CsmConfig_l.m_ui16DutyCycleLimit % 10);
+    if (CsmConfig_l.m_iCaptureThreshold == CSM_CAPTURE_DISABLED)
+    {
+        printf("  '-t' Capture       = off\n");
+    }
+    else
+    {
+        printf("  '-t' Capture       = %d [dB]\n", CsmConfig_l.m_iCaptureThreshold);
+    }
+    printf("  '-r' RandomSeed    = %u\n", CsmConfig_l.m_ui32Seed);
+    printf("  '-j' Threads       = %u\n", uiThreads_l);
+    printf("\n");
+
+
+    //-------------------------------------------------------------------
+    // Step(2): Run Scenarios in parallel
+    //-------------------------------------------------------------------
+    dStartTime = AppGetTime();
+
+    uiNextScenario_l = 0;
+    for (uiThread=0; uiThread<uiThreads_l; uiThread++)
+    {
+        vecThreads.push_back(std::thread(AppWorkerThread));
+    }
+    for (uiThread=0; uiThread<uiThreads_l; uiThread++)
+    {
+        vecThreads[uiThread].join();
+    }
+
+
+    //-------------------------------------------------------------------
+    // Step(3): Print Results
+    //-------------------------------------------------------------------
+    printf("TimeOnAir = %u [us] per DataPacket (%u Bytes)\n\n", aCsmResult_l[0].m_ui32TimeOnAirUs, aCsmResult_l[0].m_uiDataPacketLen);
+    CsmPrintResultHeader();
+    for (uiScenario=0; uiScenario<uiScenarioCount_l; uiScenario++)
+    {
+        if (aiSimRes_l[uiScenario] != 0)
+        {
+            printf("%7u  ERROR: CsmRunSimulation() failed (iRes=%d)!\n", auiDeviceList_l[uiScenario], aiSimRes_l[uiScenario]);
+            continue;
+        }
+        CsmPrintResult(&aCsmResult_l[uiScenario]);
+    }
+    printf("\n");
+    printf("Load = offered channel load G, PDR = Packet Delivery Ratio (pure ALOHA: e^(-2G))\n");
+    printf("Gen0 only = records delivered by their own packet, +Gen1..N = incl. records\n");
+    printf("recovered from the generation history of later packets\n");
+    printf("\n");
+    printf("Total Runtime: %.2f [sec]\n", AppGetTime() - dStartTime);
+    printf("\n");
+
+    return (0);
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Evaluate command line arguments
+//---------------------------------------------------------------------------
+
+static  bool  AppEvalCmdlnArgs (
+    int iArgCnt_p,
+    char* apszArg_p[])
+{
+
+char*  pszArg;
+ulong  ulLayout;
+int    iIdx;
+bool   fRes;
+
+
+    fRes = true;
+
+    for (iIdx=1; iIdx<iArgCnt_p; iIdx++)
+    {
+        pszArg = apszArg_p[iIdx];
+        if (pszArg != NULL)
+        {
+            // argument '-n=' -> List of Fleet Sizes
+            if ( !strncasecmp("-n=", pszArg, sizeof("-n=")-1) )
+            {
+                pszArg += sizeof("-n=")-1;
+                fRes = AppParseDeviceList(pszArg);
+                if ( !fRes )
+                {
+                    printf("\nERROR: invalid list of fleet sizes!\n");
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-d=' -> Simulated Days
+            if ( !strncasecmp("-d=", pszArg, sizeof("-d=")-1) )
+            {
+                pszArg += sizeof("-d=")-1;
+                CsmConfig_l.m_uiSimDays = (uint)atoi(pszArg);
+                if ((CsmConfig_l.m_uiSimDays == 0) || (CsmConfig_l.m_uiSimDays > 3650))
+                {
+                    printf("\nERROR: invalid number of days!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-c=' -> Cycle Time
+            if ( !strncasecmp("-c=", pszArg, sizeof("-c=")-1) )
+            {
+                pszArg += sizeof("-c=")-1;
+                CsmConfig_l.m_ui32CycleTime = (uint32_t)atoi(pszArg) * 60 * 1000;
+                if ((CsmConfig_l.m_ui32CycleTime == 0) || (CsmConfig_l.m_ui32CycleTime > (24 * 60 * 60 * 1000)))
+                {
+                    printf("\nERROR: invalid cycle time!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-a=' -> Async Events per Hour
+            if ( !strncasecmp("-a=", pszArg, sizeof("-a=")-1) )
+            {
+                pszArg += sizeof("-a=")-1;
+                CsmConfig_l.m_dAsyncEventsPerHour = atof(pszArg);
+                if (CsmConfig_l.m_dAsyncEventsPerHour < 0)
+                {
+                    printf("\nERROR: invalid rate of async events!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-q' -> Slotted Transmit Schedule
+            if ( !strncasecmp("-q", pszArg, sizeof("-q")-1) )
+            {
+                CsmConfig_l.m_fSlottedSchedule = true;
+                continue;
+            }
+
+            // argument '-b=' -> Bootup Spread
+            if ( !strncasecmp("-b=", pszArg, sizeof("-b=")-1) )
+            {
+                pszArg += sizeof("-b=")-1;
+                CsmConfig_l.m_ui32BootupSpread = (uint32_t)atoi(pszArg) * 1000;
+                if (CsmConfig_l.m_ui32BootupSpread > (24 * 60 * 60 * 1000))
+                {
+                    printf("\nERROR: invalid bootup spread!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-p=' -> Clock Drift
+            if ( !strncasecmp("-p=", pszArg, sizeof("-p=")-1) )
+            {
+                pszArg += sizeof("-p=")-1;
+                CsmConfig_l.m_dClockDriftPpm = atof(pszArg);
+                if ((CsmConfig_l.m_dClockDriftPpm < 0) || (CsmConfig_l.m_dClockDriftPpm > 1000))
+                {
+                    printf("\nERROR: invalid clock drift!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-g=' -> Generation Depth of Data Packets
+            if ( !strncasecmp("-g=", pszArg, sizeof("-g=")-1) )
+            {
+                pszArg += sizeof("-g=")-1;
+                CsmConfig_l.m_uiGenDepth = (uint)atoi(pszArg);
+                if (CsmConfig_l.m_uiGenDepth > LORA_DATA_GEN_DEPTH_MAX)
+                {
+                    printf("\nERROR: invalid generation depth!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-m=' -> Sensor Layout of Compact Data Packets
+            if ( !strncasecmp("-m=", pszArg, sizeof("-m=")-1) )
+            {
+                pszArg += sizeof("-m=")-1;
+                ulLayout = strtoul(pszArg, NULL, 0);
+                if (ulLayout > LORA_DATA_LAYOUT_SENSOR_MASK)
+                {
+                    printf("\nERROR: invalid sensor layout!\n");
+                    fRes = false;
+                    break;
+                }
+                CsmConfig_l.m_fCompactLayout  = true;
+                CsmConfig_l.m_ui8SensorLayout = (uint8_t)ulLayout;
+                continue;
+            }
+
+            // argument '-s=' -> Spreading Factor
+            if ( !strncasecmp("-s=", pszArg, sizeof("-s=")-1) )
+            {
+                pszArg += sizeof("-s=")-1;
+                CsmConfig_l.m_iSpreadingFactor = atoi(pszArg);
+                if ((CsmConfig_l.m_iSpreadingFactor < 6) || (CsmConfig_l.m_iSpreadingFactor > 12))
+                {
+                    printf("\nERROR: invalid spreading factor!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-l=' -> Duty Cycle Limit
+            if ( !strncasecmp("-l=", pszArg, sizeof("-l=")-1) )
+            {
+                pszArg += sizeof("-l=")-1;
+                CsmConfig_l.m_ui16DutyCycleLimit = (uint16_t)atoi(pszArg);
+                if (CsmConfig_l.m_ui16DutyCycleLimit > 1000)
+                {
+                    printf("\nERROR: invalid duty cycle limit!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-t=' -> Capture Threshold
+            if ( !strncasecmp("-t=", pszArg, sizeof("-t=")-1) )
+            {
+                pszArg += sizeof("-t=")-1;
+                CsmConfig_l.m_iCaptureThreshold = atoi(pszArg);
+                if (CsmConfig_l.m_iCaptureThreshold < 0)
+                {
+                    printf("\nERROR: invalid capture threshold!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-r=' -> Random Seed
+            if ( !strncasecmp("-r=", pszArg, sizeof("-r=")-1) )
+            {
+                pszArg += sizeof("-r=")-1;
+                CsmConfig_l.m_ui32Seed = (uint32_t)strtoul(pszArg, NULL, 0);
+                continue;
+            }
+
+            // argument '-j=' -> Worker Threads
+            if ( !strncasecmp("-j=", pszArg, sizeof("-j=")-1) )
+            {
+                pszArg += sizeof("-j=")-1;
+                uiThreads_l = (uint)atoi(pszArg);
+                if ((uiThreads_l == 0) || (uiThreads_l > 256))
+                {
+                    printf("\nERROR: invalid number of threads!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+        }
+
+        fRes = false;
+    }
+
+    return (fRes);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Show Help Screen
+//---------------------------------------------------------------------------
+
+static  void  AppPrintHelpScreen (
+    const char* pszArg0_p)
+{
+
+    //     |    10   |    20   |    30   |    40   |    50   |    60   |    70   |    80   |
+    printf("Usage:\n");
+    printf("   %s [OPTION]\n", pszArg0_p);
+    printf("   OPTION:\n");
+    printf("\n");
+    printf("       -n=<n1,n2,...>  List of fleet sizes to simulate, each one is run in its\n");
+    printf("                       own thread (default: 10,20,50,100,200,500,1000)\n");
+    printf("\n");
+    printf("       -d=<days>       Simulated time (default: %u days)\n", CsmConfig_l.m_uiSimDays);
+    printf("\n");
+    printf("       -c=<min>        Cycle time of Data Packets (default: %u min)\n", (uint)(CsmConfig_l.m_ui32CycleTime / (60 * 1000)));
+    printf("\n");
+    printf("       -a=<n>          Asynchronous transmit events per device and hour\n");
+    printf("                       (motion detection, default: 0 = off)\n");
+    printf("\n");
+    printf("       -q              Slotted Transmit Schedule (one slot per device) instead\n");
+    printf("                       of the random cycle time\n");
+    printf("\n");
+    printf("       -b=<sec>        Devices are switched on within this time\n");
+    printf("                       (default: one cycle time)\n");
+    printf("\n");
+    printf("       -p=<ppm>        Max. deviation of device clocks (default: 0)\n");
+    printf("\n");
+    printf("       -g=<depth>      Generation Depth of Data Packets: 0 = classic format\n");
+    printf("                       (Gen0/Gen1/Gen2), 1..%u = Delta format (default: 0)\n", LORA_DATA_GEN_DEPTH_MAX);
+    printf("\n");
+    printf("       -m=<layout>     Compact Data Packets with the given sensors only: Bit0 =\n");
+    printf("                       DHT, Bit1 = SR501, Bit2 = Light, Bit3 = CarBatt\n");
+    printf("                       (e.g. 0x07, default: off)\n");
+    printf("\n");
+    printf("       -s=<sf>         LoRa Spreading Factor 6..12 (default: %d)\n", CsmConfig_l.m_iSpreadingFactor);
+    printf("\n");
+    printf("       -l=<permille>   Duty Cycle Limit in [1/10 %%] (default: %u, 0 = off)\n", CsmConfig_l.m_ui16DutyCycleLimit);
+    printf("\n");
+    printf("       -t=<dB>         Capture Threshold, an overlapped packet is received if it\n");
+    printf("                       is stronger by at least <dB> (default: off)\n");
+    printf("\n");
+    printf("       -r=<seed>       Random Seed (default: %u)\n", CsmConfig_l.m_ui32Seed);
+    printf("\n");
+    printf("       -j=<threads>    Number of Worker Threads (default: number of cores)\n");
+    printf("\n");
+    printf("       --help          Shows this Help Screen\n");
+    printf("\n");
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Parse List of Fleet Sizes (option '-n=')
+//---------------------------------------------------------------------------
+
+static  bool  AppParseDeviceList (
+    const char* pszDeviceList_p)
+{
+
+const char*  pszPos;
+char*        pszEnd;
+ulong        ulDevices;
+
+
+    uiScenarioCount_l = 0;
+    pszPos = pszDeviceList_p;
+    while (*pszPos != '\0')
+    {
+        if (uiScenarioCount_l >= APP_MAX_SCENARIOS)
+        {
+            return (false);
+        }
+        ulDevices = strtoul(pszPos, &pszEnd, 10);
+        if ((pszEnd == pszPos) || (ulDevices == 0) || (ulDevices > CSM_MAX_DEVICES))
+        {
+            return (false);
+        }
+        auiDeviceList_l[uiScenarioCount_l++] = (uint)ulDevices;
+
+        pszPos = pszEnd;
+        if (*pszPos == ',')
+        {
+            pszPos++;
+        }
+        else if (*pszPos != '\0')
+        {
+            return (false);
+        }
+    }
+
+    return (uiScenarioCount_l > 0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Worker Thread: run Scenarios until all are done
+//---------------------------------------------------------------------------
+
+static  void  AppWorkerThread (void)
+{
+
+tCsmConfig  CsmConfig;
+uint        uiScenario;
+
+
+    while (true)
+    {
+        uiScenario = uiNextScenario_l++;
+        if (uiScenario >= uiScenarioCount_l)
+        {
+            break;
+        }
+
+        CsmConfig = CsmConfig_l;
+        CsmConfig.m_uiDevices = auiDeviceList_l[uiScenario];
+        aiSimRes_l[uiScenario] = CsmRunSimulation(&CsmConfig, &aCsmResult_l[uiScenario]);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get monotonic Time in [sec]
+//---------------------------------------------------------------------------
+
+static  double  AppGetTime (void)
+{
+
+struct timespec  TimeSpec;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &TimeSpec);
+
+    return ((double)TimeSpec.tv_sec + ((double)TimeSpec.tv_nsec / 1000000000.0));
+
+}
+
+
+
+// EOF
@@ -0,0 +1,456 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Channel Simulator
+  Description:  Host Test for the Over-the-Air Layout of the LoRa Packets:
+                captured Packets are decoded and re-encoded Byte by Byte
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+
+#include "Arduino.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stddef.h>
+#include "LoraPacket.h"
+#include "LoraPacketSchema.h"
+#include "LoraPayloadEncoder.h"
+#include "LoraPayloadDecoder.h"
+#include "TestCheck.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+const  uint8_t       TST_DEV_ID             = 0x0B;
+const  unsigned int  TST_NUM_DATA_REC       = 3;                // Gen0/Gen1/Gen2 of classic Data Packet
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+TST_DEFINE_COUNTERS()
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+//  Packets captured from a Device with Firmware V1.00 (Records as packed
+//  Bitfields of uint64_t, GCC little-endian). The Byte Array Records of the
+//  current Firmware must produce and accept exactly the same Bytes.
+
+static  const  uint8_t  abTstCapturedBootup_l[sizeof(tLoraDataPacket)] =
+{
+    0xB1, 0x01, 0x07, 0x08, 0x07, 0x2F, 0x14, 0x0C, 0xC7, 0xB4,     // tLoraBootupHeader
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,     // tLoraDataRec[3] = { 0 }
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+static  const  uint8_t  abTstCapturedData_l[sizeof(tLoraDataPacket)] =
+{
+    0xB2, 0x03, 0x00, 0x00, 0x27, 0x15, 0x00, 0x00, 0xDB, 0x43,     // tLoraDataHeader
+    0xD3, 0x21, 0x46, 0x80, 0x1A, 0xFF, 0x1F, 0xFF, 0x59, 0x57,     // tLoraDataRec Gen0
+    0x94, 0x16, 0xF7, 0xDB, 0x0C, 0x05, 0xCA, 0x00, 0x17, 0x85,     // tLoraDataRec Gen1
+    0x45, 0x0B, 0x2B, 0x26, 0x00, 0x03, 0x90, 0x7E, 0xC4, 0x78      // tLoraDataRec Gen2
+};
+
+//  Device Configuration and Sensor Data the Packets were encoded from
+static  const  LoraPayloadEncoder::tDeviceConfig  TstDeviceConfig_l =
+{
+    1, 7,                                               // FirmwareVersion, FirmwareRevision
+    1800,                                               // DataPackCycleTm
+    true, true, true, true, false, true, false, false,  // CfgOledDisplay .. CommissioningMode
+    20, 12                                              // LoraTxPower, LoraSpreadFactor
+};
+
+static  const  LoraPayloadEncoder::tSensorDataRec  aTstSensorData_l[TST_NUM_DATA_REC] =
+{   // Uptime  Temp    Humidity  Motion  Time  Count  Light  CarBatt
+    {  1805,   21.5f,  38.0f,    false,     0,     3,    72,  12.6f },   // -> Gen2
+    {  3610,   -4.5f,  91.0f,    true,    123,   517,   100,   0.0f },   // -> Gen1
+    {  5415,   35.0f,   0.0f,    true,    255,  1023,    14,  25.5f }    // -> Gen0
+};
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  void  TstRecordLayout (void);
+static  void  TstDecodeBootup (void);
+static  void  TstDecodeData (void);
+static  void  TstEncodeSensorData (void);
+static  void  TstReEncodeDecoded (void);
+static  void  TstCorruptedCrc (void);
+
+static  bool  TstIsPacketEqual (const void* pPacket_p, const uint8_t* pabCaptured_p);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Main function of this application
+//---------------------------------------------------------------------------
+//  The Test has to pass with every Compiler and Word Size ('make test',
+//  'make test_m32', 'make test_clang'), as the Records no longer depend on
+//  the Bitfield Layout of the Compiler.
+
+int  main (void)
+{
+
+    printf("Target: %u Bit, %s\n", (unsigned int)(sizeof(void*) * 8),
+#if defined(__clang__)
+           "clang"
+#elif defined(__GNUC__)
+           "gcc"
+#else
+           "unknown compiler"
+#endif
+          );
+
+    TstRecordLayout();
+    TstDecodeBootup();
+    TstDecodeData();
+    TstEncodeSensorData();
+    TstReEncodeDecoded();
+    TstCorruptedCrc();
+
+    return (TST_RESULT("LoraPacketTest"));
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Size and Offsets of the Records are the same on every Target
+//---------------------------------------------------------------------------
+
+static  void  TstRecordLayout (void)
+{
+
+    printf("Test: Record Layout\n");
+
+    TST_CHECK_EQUAL(sizeof(tLoraDataPacket), 40);
+    TST_CHECK_EQUAL(offsetof(tLoraDataPacket, m_aLoraDataRec), 10);
+    TST_CHECK_EQUAL(offsetof(tLoraDataHeader, m_abCRC16), 8);
+    TST_CHECK_EQUAL(offsetof(tLoraDataDeltaPacket, m_abDeltaCRC16), 20);
+    TST_CHECK_EQUAL(offsetof(tLoraDataDeltaPacket, m_aLoraDeltaRec), 22);
+    TST_CHECK_EQUAL(LORA_DATA_DELTA_PACKET_SIZE(LORA_DATA_GEN_DEPTH_MAX), 22 + (15 * 7));
+    TST_CHECK_EQUAL(offsetof(tLoraDataCompactPacket, m_abRecStream), 11);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Captured Bootup Packet is decoded into the expected Values
+//---------------------------------------------------------------------------
+
+static  void  TstDecodeBootup (void)
+{
+
+static LoraPayloadDecoder                       LoraPayloadDec;
+
+tLoraDataPacket                                 LoraPacket;
+LoraPayloadDecoder::tLoraStationBootup          StationBootup;
+
+
+    printf("Test: Decode captured Bootup Packet\n");
+
+    memcpy(&LoraPacket, abTstCapturedBootup_l, sizeof(LoraPacket));
+    TST_CHECK_EQUAL(LoraPayloadDec.GetRxPacketType(&LoraPacket), kLoraPacketBootup);
+    TST_CHECK_EQUAL(LoraPayloadDec.GetRxPacketDevID(&LoraPacket), TST_DEV_ID);
+
+    StationBootup = LoraPayloadDec.DecodeRxBootupPacket(&LoraPacket);
+    TST_CHECK_EQUAL(StationBootup.m_DataStatus, LoraPayloadDecoder::kStatusValid);
+    TST_CHECK_EQUAL(StationBootup.m_PacketType, kLoraPacketBootup);
+    TST_CHECK_EQUAL(StationBootup.m_ui8DevID, TST_DEV_ID);
+    TST_CHECK_EQUAL(StationBootup.m_ui8FirmwareVersion, 1);
+    TST_CHECK_EQUAL(StationBootup.m_ui8FirmwareRevision, 7);
+    TST_CHECK_EQUAL(StationBootup.m_ui16DataPackCycleTm, 1800);
+    TST_CHECK_EQUAL(StationBootup.m_fCfgOledDisplay, true);
+    TST_CHECK_EQUAL(StationBootup.m_fCfgDhtSensor, true);
+    TST_CHECK_EQUAL(StationBootup.m_fCfgSr501Sensor, true);
+    TST_CHECK_EQUAL(StationBootup.m_fCfgAdcLightSensor, true);
+    TST_CHECK_EQUAL(StationBootup.m_fCfgAdcCarBatAin, false);
+    TST_CHECK_EQUAL(StationBootup.m_fCfgAsyncLoraEvent, true);
+    TST_CHECK_EQUAL(StationBootup.m_fSr501PauseOnLoraTx, false);
+    TST_CHECK_EQUAL(StationBootup.m_fCommissioningMode, false);
+    TST_CHECK_EQUAL(StationBootup.m_ui8LoraTxPower, 20);
+    TST_CHECK_EQUAL(StationBootup.m_ui8LoraSpreadFactor, 12);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Captured Data Packet is decoded into the expected Values
+//---------------------------------------------------------------------------
+
+static  void  TstDecodeData (void)
+{
+
+static LoraPayloadDecoder                       LoraPayloadDec;
+
+tLoraDataPacket                                 LoraPacket;
+LoraPayloadDecoder::tLoraStationData            StationData;
+const LoraPayloadDecoder::tDataRec*             pDataRec;
+
+
+    printf("Test: Decode captured Data Packet\n");
+
+    memcpy(&LoraPacket, abTstCapturedData_l, sizeof(LoraPacket));
+    TST_CHECK_EQUAL(LoraPayloadDec.GetRxPacketType(&LoraPacket), kLoraPacketDataHeader);
+
+    StationData = LoraPayloadDec.DecodeRxDataPacket(&LoraPacket);
+    TST_CHECK_EQUAL(StationData.m_DataHeader.m_DataStatus, LoraPayloadDecoder::kStatusValid);
+    TST_CHECK_EQUAL(StationData.m_DataHeader.m_ui8DevID, TST_DEV_ID);
+    TST_CHECK_EQUAL(StationData.m_DataHeader.m_ui32SequNum, 3);
+    TST_CHECK_EQUAL(StationData.m_DataHeader.m_ui32Uptime, 5415);
+    TST_CHECK_EQUAL(StationData.m_uiNumDataRec, TST_NUM_DATA_REC);
+
+    // Gen0: limits of the value ranges
+    pDataRec = &StationData.m_aDataRec[0];
+    TST_CHECK_EQUAL(pDataRec->m_DataStatus, LoraPayloadDecoder::kStatusValid);
+    TST_CHECK_EQUAL(pDataRec->m_PacketType, kLoraPacketDataGen0);
+    TST_CHECK_EQUAL(pDataRec->m_ui12UptimeSnippet, 5410);            // [sec], 10 sec resolution
+    TST_CHECK(pDataRec->m_flTemperature == 35.0f);
+    TST_CHECK(pDataRec->m_flHumidity == 0.0f);
+    TST_CHECK_EQUAL(pDataRec->m_fMotionActive, true);
+    TST_CHECK_EQUAL(pDataRec->m_ui16MotionActiveTime, 260);
+    TST_CHECK_EQUAL(pDataRec->m_ui16MotionActiveCount, 1023);
+    TST_CHECK_EQUAL(pDataRec->m_ui8LightLevel, 14);
+    TST_CHECK(pDataRec->m_flCarBattLevel == 25.5f);
+
+    // Gen1: negative Temperature, field across Byte Boundary
+    pDataRec = &StationData.m_aDataRec[1];
+    TST_CHECK_EQUAL(pDataRec->m_DataStatus, LoraPayloadDecoder::kStatusValid);
+    TST_CHECK_EQUAL(pDataRec->m_PacketType, kLoraPacketDataGen1);
+    TST_CHECK_EQUAL(pDataRec->m_ui12UptimeSnippet, 3610);
+    TST_CHECK(pDataRec->m_flTemperature == -4.5f);
+    TST_CHECK(pDataRec->m_flHumidity == 91.0f);
+    TST_CHECK_EQUAL(pDataRec->m_fMotionActive, true);
+    TST_CHECK_EQUAL(pDataRec->m_ui16MotionActiveTime, 120);
+    TST_CHECK_EQUAL(pDataRec->m_ui16MotionActiveCount, 517);
+    TST_CHECK_EQUAL(pDataRec->m_ui8LightLevel, 100);
+    TST_CHECK(pDataRec->m_flCarBattLevel == 0.0f);
+
+    // Gen2
+    pDataRec = &StationData.m_aDataRec[2];
+    TST_CHECK_EQUAL(pDataRec->m_DataStatus, LoraPayloadDecoder::kStatusValid);
+    TST_CHECK_EQUAL(pDataRec->m_PacketType, kLoraPacketDataGen2);
+    TST_CHECK_EQUAL(pDataRec->m_ui12UptimeSnippet, 1800);
+    TST_CHECK(pDataRec->m_flTemperature == 21.5f);
+    TST_CHECK(pDataRec->m_flHumidity == 38.0f);
+    TST_CHECK_EQUAL(pDataRec->m_fMotionActive, false);
+    TST_CHECK_EQUAL(pDataRec->m_ui16MotionActiveTime, 0);
+    TST_CHECK_EQUAL(pDataRec->m_ui16MotionActiveCount, 3);
+    TST_CHECK_EQUAL(pDataRec->m_ui8LightLevel, 72);
+    TST_CHECK(pDataRec->m_flCarBattLevel == 12.6f);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Encoder produces the captured Bytes from the same Input
+//---------------------------------------------------------------------------
+
+static  void  TstEncodeSensorData (void)
+{
+
+static LoraPayloadEncoder   LoraPayloadEnc;
+
+unsigned int  uiRec;
+
+
+    printf("Test: Encode same Input as captured Packets\n");
+
+    LoraPayloadEnc.Setup(TST_DEV_ID);
+
+    LoraPayloadEnc.EncodeTxBootupPacket(&TstDeviceConfig_l);
+    TST_CHECK( TstIsPacketEqual(LoraPayloadEnc.GetTxBootupPacket(), abTstCapturedBootup_l) );
+
+    for (uiRec=0; uiRec<TST_NUM_DATA_REC; uiRec++)
+    {
+        LoraPayloadEnc.EncodeTxDataPacket(&aTstSensorData_l[uiRec]);
+    }
+    TST_CHECK( TstIsPacketEqual(LoraPayloadEnc.GetTxDataPacket(), abTstCapturedData_l) );
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Decoded Values re-encoded result in the captured Bytes
+//---------------------------------------------------------------------------
+
+static  void  TstReEncodeDecoded (void)
+{
+
+static LoraPayloadDecoder   LoraPayloadDec;
+static LoraPayloadEncoder   LoraPayloadEnc;
+
+tLoraDataPacket                         LoraPacket;
+LoraPayloadDecoder::tLoraStationBootup  StationBootup;
+LoraPayloadDecoder::tLoraStationData    StationData;
+LoraPayloadEncoder::tDeviceConfig       DeviceConfig;
+LoraPayloadEncoder::tSensorDataRec      SensorDataRec;
+const LoraPayloadDecoder::tDataRec*     pDataRec;
+int                                     iGen;
+
+
+    printf("Test: Re-encode decoded Values\n");
+
+    memcpy(&LoraPacket, abTstCapturedBootup_l, sizeof(LoraPacket));
+    StationBootup = LoraPayloadDec.DecodeRxBootupPacket(&LoraPacket);
+
+    LoraPayloadEnc.Setup(StationBootup.m_ui8DevID);
+    DeviceConfig.m_ui8FirmwareVersion  = StationBootup.m_ui8FirmwareVersion;
+    DeviceConfig.m_ui8FirmwareRevision = StationBootup.m_ui8FirmwareRevision;
+    DeviceConfig.m_ui16DataPackCycleTm = StationBootup.m_ui16DataPackCycleTm;
+    DeviceConfig.m_fCfgOledDisplay     = StationBootup.m_fCfgOledDisplay;
+    DeviceConfig.m_fCfgDhtSensor       = StationBootup.m_fCfgDhtSensor;
+    DeviceConfig.m_fCfgSr501Sensor     = StationBootup.m_fCfgSr501Sensor;
+    DeviceConfig.m_fCfgAdcLightSensor  = StationBootup.m_fCfgAdcLightSensor;
+    DeviceConfig.m_fCfgAdcCarBatAin    = StationBootup.m_fCfgAdcCarBatAin;
+    DeviceConfig.m_fCfgAsyncLoraEvent  = StationBootup.m_fCfgAsyncLoraEvent;
+    DeviceConfig.m_fSr501PauseOnLoraTx = StationBootup.m_fSr501PauseOnLoraTx;
+    DeviceConfig.m_fCommissioningMode  = StationBootup.m_fCommissioningMode;
+    DeviceConfig.m_ui8LoraTxPower      = StationBootup.m_ui8LoraTxPower;
+    DeviceConfig.m_ui8LoraSpreadFactor = StationBootup.m_ui8LoraSpreadFactor;
+    LoraPayloadEnc.EncodeTxBootupPacket(&DeviceConfig);
+    TST_CHECK( TstIsPacketEqual(LoraPayloadEnc.GetTxBootupPacket(), abTstCapturedBootup_l) );
+
+    // oldest generation first, the Uptime of Gen1/Gen2 is only known with
+    // the resolution of the UptimeSnippet, the SequNum counts the Packets
+    memcpy(&LoraPacket, abTstCapturedData_l, sizeof(LoraPacket));
+    StationData = LoraPayloadDec.DecodeRxDataPacket(&LoraPacket);
+    for (iGen=(int)TST_NUM_DATA_REC-1; iGen>=0; iGen--)
+    {
+        pDataRec = &StationData.m_aDataRec[iGen];
+        SensorDataRec.m_ui32Uptime            = (iGen == 0) ? StationData.m_DataHeader.m_ui32Uptime : pDataRec->m_ui12UptimeSnippet;
+        SensorDataRec.m_flTemperature         = pDataRec->m_flTemperature;
+        SensorDataRec.m_flHumidity            = pDataRec->m_flHumidity;
+        SensorDataRec.m_fMotionActive         = pDataRec->m_fMotionActive;
+        SensorDataRec.m_ui16MotionActiveTime  = pDataRec->m_ui16MotionActiveTime;
+        SensorDataRec.m_ui16MotionActiveCount = pDataRec->m_ui16MotionActiveCount;
+        SensorDataRec.m_ui8LightLevel         = pDataRec->m_ui8LightLevel;
+        SensorDataRec.m_flCarBattLevel        = pDataRec->m_flCarBattLevel;
+        LoraPayloadEnc.EncodeTxDataPacket(&SensorDataRec);
+    }
+    TST_CHECK_EQUAL(StationData.m_DataHeader.m_ui32SequNum, TST_NUM_DATA_REC);
+    TST_CHECK( TstIsPacketEqual(LoraPayloadEnc.GetTxDataPacket(), abTstCapturedData_l) );
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  A single flipped Bit is detected by the CRC16 of the Record
+//---------------------------------------------------------------------------
+
+static  void  TstCorruptedCrc (void)
+{
+
+static LoraPayloadDecoder   LoraPayloadDec;
+
+tLoraDataPacket                         LoraPacket;
+LoraPayloadDecoder::tLoraStationData    StationData;
+
+
+    printf("Test: Corrupted Record\n");
+
+    memcpy(&LoraPacket, abTstCapturedData_l, sizeof(LoraPacket));
+    LoraPacket.m_aLoraDataRec[1].m_abFields[3] ^= 0x10;
+    StationData = LoraPayloadDec.DecodeRxDataPacket(&LoraPacket);
+    TST_CHECK_EQUAL(StationData.m_DataHeader.m_DataStatus, LoraPayloadDecoder::kStatusValid);
+    TST_CHECK_EQUAL(StationData.m_aDataRec[0].m_DataStatus, LoraPayloadDecoder::kStatusValid);
+    TST_CHECK_EQUAL(StationData.m_aDataRec[1].m_DataStatus, LoraPayloadDecoder::kStatusCrcError);
+    TST_CHECK_EQUAL(StationData.m_aDataRec[2].m_DataStatus, LoraPayloadDecoder::kStatusValid);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Compare Packet with captured Bytes, print the first Difference
+//---------------------------------------------------------------------------
+
+static  bool  TstIsPacketEqual (const void* pPacket_p, const uint8_t* pabCaptured_p)
+{
+
+const uint8_t*  pabPacket;
+unsigned int    uiIdx;
+
+
+    pabPacket = (const uint8_t*)pPacket_p;
+    for (uiIdx=0; uiIdx<sizeof(tLoraDataPacket); uiIdx++)
+    {
+        if (pabPacket[uiIdx] != pabCaptured_p[uiIdx])
+        {
+            printf("  Byte %u: 0x%02X, captured 0x%02X\n", uiIdx, (unsigned int)pabPacket[uiIdx], (unsigned int)pabCaptured_p[uiIdx]);
+            return (false);
+        }
+    }
+
+    return (true);
+
+}
+
+
+
+// EOF
@@ -0,0 +1,641 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Channel Simulator
+  Description:  Host Test for Deep Sleep State Retention and Energy Model
+                of the Firmware (LowPowerState.cpp)
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+
+#include "Arduino.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <type_traits>
+#include "LoraPacket.h"
+#include "LoraPacketSchema.h"
+#include "LoraPayloadEncoder.h"
+#include "LoraTransmitter.h"
+#include "LowPowerState.h"
+#include "SimpleMovingAverage.hpp"
+#include "TestCheck.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+//  Timing and Power Model as configured in the Firmware (LoraAmbientMonitor.ino)
+const  uint32_t      TST_CYCLE_TIME         = (30 * 60 * 1000); // LoRa Transmit Cycle [ms]
+const  uint32_t      TST_INHIBIT_TIME       = (30 * 1000);      // LORA_PACKET_INHIBIT_TIME [ms]
+const  uint32_t      TST_SAMPLE_PERIOD      = (30 * 1000);      // LOW_POWER_SAMPLE_PERIOD [ms]
+const  uint32_t      TST_POLL_PERIOD        = 100;              // TASK_PERIOD_SEN_HC_SR501 [ms]
+const  uint32_t      TST_ACTIVE_TIME        = 20;               // CPU active per Wakeup (Sensors, Tasks) [ms]
+const  uint32_t      TST_BOOT_TIME          = 300;              // POWER_DEEP_SLEEP_BOOT_TIME [ms]
+const  uint32_t      TST_WAKEUP_TIME        = 2;                // POWER_LIGHT_SLEEP_WAKEUP_TIME [ms]
+const  uint32_t      TST_SLEEP_TIME         = (25 * 60 * 1000); // Deep Sleep between Packets 3 and 4 [ms]
+const  uint32_t      TST_RTC_OFFSET         = 123456789;        // arbitrary RTC Time at Power-On [ms]
+const  unsigned int  TST_PACKETS_BEFORE     = 3;                // Packets transmitted before Deep Sleep
+const  unsigned int  TST_PACKETS_AFTER      = 4;                // Packets transmitted after Wakeup
+const  float         TST_BATTERY_CAPACITY   = 2000.0f;          // Battery for Runtime Estimation [mAh]
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+typedef  FixedMovingAverage<float, 200, 10>     tTstMovingAverage;      // = tDhtMovingAverage of the Firmware
+
+typedef struct
+{
+    uint8_t         m_abPayload[TST_PACKETS_BEFORE + TST_PACKETS_AFTER][256];
+    unsigned int    m_auiPayloadLen[TST_PACKETS_BEFORE + TST_PACKETS_AFTER];
+    int32_t         m_i32RemainingTime;                 // [ms] after Wakeup
+    LoraTransmitter::tDutyCycleInfo  m_DutyCycleInfo;   // after last Packet
+
+} tTstRun;
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+TST_DEFINE_COUNTERS()
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+static  const LowPowerState::tPowerModel  TstPowerModel_l =
+{
+    50.0f,                                              // POWER_CURRENT_ACTIVE
+    130.0f,                                             // POWER_CURRENT_LORA_TX
+    1.0f,                                               // POWER_CURRENT_LIGHT_SLEEP
+    0.2f,                                               // POWER_CURRENT_DEEP_SLEEP
+    TST_WAKEUP_TIME,
+    TST_BOOT_TIME
+};
+
+static  tTstRun  RunContinuous_l;
+static  tTstRun  RunDeepSleep_l;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  void  TstDeepSleepContinuity (unsigned int uiGenDepth_p);
+static  void  TstRetainStateValidity (void);
+static  void  TstMovingAverageRetention (void);
+static  void  TstEnergyBudget (void);
+static  void  TstWakeupLatency (void);
+
+static  void  TstRunDevice (tTstRun* pRun_p, unsigned int uiGenDepth_p, bool fDeepSleep_p);
+static  void  TstSetupDevice (LoraPayloadEncoder* pLoraPayloadEnc_p, LoraTransmitter* pLoraTransmitter_p, unsigned int uiGenDepth_p);
+static  void  TstTransmitPacket (tTstRun* pRun_p, unsigned int uiPacket_p, LoraPayloadEncoder* pLoraPayloadEnc_p, LoraTransmitter* pLoraTransmitter_p);
+static  void  TstRunBenchmark (void);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Main function of this application
+//---------------------------------------------------------------------------
+//  Without arguments the functional checks are run ('make test'), option
+//  '-b' prints the Energy Budget and Wakeup Latency per Sleep Mode and
+//  Spreading Factor ('make bench').
+
+int  main (int iArgCnt_p, char* apszArg_p[])
+{
+
+    if ((iArgCnt_p > 1) && !strcmp(apszArg_p[1], "-b"))
+    {
+        TstRunBenchmark();
+        return (0);
+    }
+
+    TstDeepSleepContinuity(0);                          // classic Data Packet (Gen0/Gen1/Gen2)
+    TstDeepSleepContinuity(LORA_DATA_GEN_DEPTH_MAX);    // Delta Data Packet
+    TstRetainStateValidity();
+    TstMovingAverageRetention();
+    TstEnergyBudget();
+    TstWakeupLatency();
+
+    return (TST_RESULT("LowPowerTest"));
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  A Device with Deep Sleep transmits the same Packets as without Sleep
+//---------------------------------------------------------------------------
+//  SequNum and Generation History are contained in each Packet, so identical
+//  Packets after the Wakeup show that both continue seamlessly and the
+//  Receiver does not see a Reboot.
+
+static  void  TstDeepSleepContinuity (unsigned int uiGenDepth_p)
+{
+
+unsigned int  uiPacket;
+unsigned int  uiSame;
+
+
+    printf("Test: Deep Sleep Continuity (GenDepth=%u)\n", uiGenDepth_p);
+
+    TstRunDevice(&RunContinuous_l, uiGenDepth_p, false);
+    TstRunDevice(&RunDeepSleep_l, uiGenDepth_p, true);
+
+    uiSame = 0;
+    for (uiPacket=0; uiPacket<(TST_PACKETS_BEFORE + TST_PACKETS_AFTER); uiPacket++)
+    {
+        TST_CHECK_EQUAL(LoraDataHeaderField<kLoraHeaderSequNum>::GetInt(RunDeepSleep_l.m_abPayload[uiPacket]), uiPacket + 1);
+        if ((RunDeepSleep_l.m_auiPayloadLen[uiPacket] == RunContinuous_l.m_auiPayloadLen[uiPacket]) &&
+            (memcmp(RunDeepSleep_l.m_abPayload[uiPacket], RunContinuous_l.m_abPayload[uiPacket], RunContinuous_l.m_auiPayloadLen[uiPacket]) == 0))
+        {
+            uiSame++;
+        }
+    }
+    TST_CHECK_EQUAL(uiSame, TST_PACKETS_BEFORE + TST_PACKETS_AFTER);
+
+    // Transmit Cycle and Duty Cycle Window continue across the Deep Sleep
+    TST_CHECK_EQUAL(RunDeepSleep_l.m_i32RemainingTime, RunContinuous_l.m_i32RemainingTime);
+    TST_CHECK_EQUAL(RunDeepSleep_l.m_DutyCycleInfo.m_ui32UsedAirTime, RunContinuous_l.m_DutyCycleInfo.m_ui32UsedAirTime);
+    TST_CHECK_EQUAL(RunDeepSleep_l.m_DutyCycleInfo.m_ui32TransmitCount, TST_PACKETS_BEFORE + TST_PACKETS_AFTER);
+    TST_CHECK(RunDeepSleep_l.m_DutyCycleInfo.m_ui32UsedAirTime > 0);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Retained State is only valid once (consumed by RestoreState)
+//---------------------------------------------------------------------------
+
+static  void  TstRetainStateValidity (void)
+{
+
+static LowPowerState::tRetainState  RetainState;    // RTC Memory
+
+LoraPayloadEncoder  LoraPayloadEnc;
+LoraTransmitter     Transmitter;
+LowPowerState       LowPower;
+uint32_t            ui32SleepTime;
+
+
+    printf("Test: Retain State Validity\n");
+
+    // content of RTC Memory after Power-On is undefined
+    memset(&RetainState, 0xA5, sizeof(RetainState));
+    TST_CHECK( !LowPowerState::IsRetainStateValid(&RetainState) );
+
+    ArduinoSimSetTick(5000);
+    TstSetupDevice(&LoraPayloadEnc, &Transmitter, 0);
+    LowPower.Setup(&TstPowerModel_l);
+    LowPower.SaveState(&RetainState, TST_RTC_OFFSET, &LoraPayloadEnc, &Transmitter);
+    TST_CHECK( LowPowerState::IsRetainStateValid(&RetainState) );
+
+    // RTC Time before Save (e.g. clock reset) -> at least the Boot Time has elapsed
+    ArduinoSimSetTick(TST_BOOT_TIME);
+    ui32SleepTime = LowPower.RestoreState(&RetainState, TST_RTC_OFFSET - 1000, &LoraPayloadEnc, &Transmitter);
+    TST_CHECK_EQUAL(ui32SleepTime, 0);
+    TST_CHECK_EQUAL(LowPower.GetSysTick(), 5000 + TST_BOOT_TIME);
+    TST_CHECK( !LowPowerState::IsRetainStateValid(&RetainState) );
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Moving Average Filters are retained as Byte Copy
+//---------------------------------------------------------------------------
+
+static  void  TstMovingAverageRetention (void)
+{
+
+static tTstMovingAverage  MovAvgContinuous;
+static tTstMovingAverage  MovAvgRestored;
+static uint8_t            abRetained[sizeof(tTstMovingAverage)];    // RTC Memory
+
+unsigned int  uiIdx;
+unsigned int  uiSame;
+float         flValue;
+
+
+    printf("Test: Moving Average Retention\n");
+
+    // the Firmware copies the Filters with memcpy() into the RTC Memory
+    static_assert(std::is_trivially_copyable<tTstMovingAverage>::value, "Moving Average must be trivially copyable");
+
+    for (uiIdx=0; uiIdx<150; uiIdx++)
+    {
+        MovAvgContinuous.CalcMovingAverage(20.0f + (float)(uiIdx % 17) * 0.3f);
+    }
+
+    memcpy(abRetained, &MovAvgContinuous, sizeof(abRetained));
+    memset((void*)&MovAvgRestored, 0xA5, sizeof(MovAvgRestored));
+    memcpy((void*)&MovAvgRestored, abRetained, sizeof(abRetained));
+
+    uiSame = 0;
+    for (uiIdx=0; uiIdx<300; uiIdx++)
+    {
+        flValue = -5.0f + (float)(uiIdx % 23) * 0.7f;
+        MovAvgContinuous.CalcMovingAverage(flValue);
+        MovAvgRestored.CalcMovingAverage(flValue);
+        if (MovAvgContinuous.GetAverageFixed() == MovAvgRestored.GetAverageFixed())
+        {
+            uiSame++;
+        }
+    }
+    TST_CHECK_EQUAL(uiSame, 300);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Energy Budget: accounted Cycle matches Model and reference Values
+//---------------------------------------------------------------------------
+
+static  void  TstEnergyBudget (void)
+{
+
+static LowPowerState::tRetainState  RetainState;    // RTC Memory
+
+LoraPayloadEncoder              LoraPayloadEnc;
+LoraTransmitter                 Transmitter;
+LowPowerState                   LowPower;
+LowPowerState::tEnergyBudget    Measured;
+LowPowerState::tEnergyBudget    Estimated;
+uint32_t                        ui32Tick;
+uint32_t                        ui32Wakeup;
+uint32_t                        ui32RtcTick;
+
+
+    printf("Test: Energy Budget\n");
+
+    LowPower.Setup(&TstPowerModel_l);
+
+    // reference values: [mA] * [ms] / 3600 = [uAh]
+    LowPower.EstimateEnergyBudget(LowPowerState::SLEEP_MODE_NONE, TST_CYCLE_TIME, TST_SAMPLE_PERIOD, TST_ACTIVE_TIME, 1000, &Estimated);
+    TST_CHECK_EQUAL(Estimated.m_ui32ActiveTime, TST_CYCLE_TIME - 1000);
+    TST_CHECK_EQUAL(lroundf(Estimated.m_flCharge * 10.0f), 250222);                 // (50 * 1799000 + 130 * 1000) / 3600
+    TST_CHECK_EQUAL(lroundf(Estimated.m_flAvgCurrent * 1000.0f), 50044);
+
+    LowPower.EstimateEnergyBudget(LowPowerState::SLEEP_MODE_DEEP, TST_CYCLE_TIME, TST_SAMPLE_PERIOD, TST_ACTIVE_TIME, 1000, &Estimated);
+    TST_CHECK_EQUAL(Estimated.m_ui32WakeupCount, 60);
+    TST_CHECK_EQUAL(Estimated.m_ui32ActiveTime, 60 * (TST_BOOT_TIME + TST_ACTIVE_TIME));
+    TST_CHECK_EQUAL(Estimated.m_ui32DeepSleepTime, TST_CYCLE_TIME - 19200 - 1000);
+    TST_CHECK_EQUAL(lroundf(Estimated.m_flCharge * 10.0f), 4017);                   // (50 * 19200 + 130 * 1000 + 0.2 * 1779800) / 3600
+
+    // Light Sleep Cycle accounted as by the Firmware, the LoRa Transmission
+    // extends the Wake Phase of one Wakeup
+    ArduinoSimSetTick(0);
+    LowPower.StartCycle();
+    ui32Tick = 0;
+    for (ui32Wakeup=0; ui32Wakeup<(TST_CYCLE_TIME / TST_SAMPLE_PERIOD); ui32Wakeup++)
+    {
+        ui32Tick += TST_WAKEUP_TIME + TST_ACTIVE_TIME;
+        LowPower.AddLightSleepTime(TST_SAMPLE_PERIOD - TST_WAKEUP_TIME - TST_ACTIVE_TIME);
+        ui32Tick += TST_SAMPLE_PERIOD - TST_WAKEUP_TIME - TST_ACTIVE_TIME;
+    }
+    LowPower.AddLoraTxTime(1000);
+    ui32Tick += 1000;
+    ArduinoSimSetTick(ui32Tick);
+    LowPower.GetEnergyBudget(&Measured);
+    LowPower.EstimateEnergyBudget(LowPowerState::SLEEP_MODE_LIGHT, TST_CYCLE_TIME + 1000, TST_SAMPLE_PERIOD, TST_ACTIVE_TIME, 1000, &Estimated);
+    TST_CHECK_EQUAL(Measured.m_ui32CycleTime, TST_CYCLE_TIME + 1000);
+    TST_CHECK_EQUAL(Measured.m_ui32WakeupCount, Estimated.m_ui32WakeupCount);
+    TST_CHECK_EQUAL(Measured.m_ui32ActiveTime, Estimated.m_ui32ActiveTime);
+    TST_CHECK_EQUAL(Measured.m_ui32LightSleepTime, Estimated.m_ui32LightSleepTime);
+    TST_CHECK(fabsf(Measured.m_flCharge - Estimated.m_flCharge) < 0.01f);
+
+    // Deep Sleep Cycle: each Wakeup restarts the CPU, so the Objects are
+    // rebuilt and the Sleep Time is only known from the RTC; the Boot Time
+    // until RestoreState() counts as active
+    TstSetupDevice(&LoraPayloadEnc, &Transmitter, 0);
+    ui32RtcTick = TST_RTC_OFFSET;
+    for (ui32Wakeup=0; ui32Wakeup<=(TST_CYCLE_TIME / TST_SAMPLE_PERIOD); ui32Wakeup++)
+    {
+        LowPowerState  LowPowerWake;
+
+        ArduinoSimSetTick(TST_BOOT_TIME);
+        LowPowerWake.Setup(&TstPowerModel_l);
+        if (ui32Wakeup > 0)
+        {
+            ui32RtcTick += TST_SAMPLE_PERIOD - TST_ACTIVE_TIME;
+            TST_CHECK_EQUAL(LowPowerWake.RestoreState(&RetainState, ui32RtcTick, &LoraPayloadEnc, &Transmitter), TST_SAMPLE_PERIOD - TST_BOOT_TIME - TST_ACTIVE_TIME);
+        }
+        if (ui32Wakeup == (TST_CYCLE_TIME / TST_SAMPLE_PERIOD))
+        {
+            ArduinoSimSetTick(TST_BOOT_TIME + 1000);
+            LowPowerWake.AddLoraTxTime(1000);
+            LowPowerWake.GetEnergyBudget(&Measured);
+            break;
+        }
+        ArduinoSimSetTick(TST_BOOT_TIME + TST_ACTIVE_TIME);
+        ui32RtcTick += TST_ACTIVE_TIME;
+        LowPowerWake.SaveState(&RetainState, ui32RtcTick, &LoraPayloadEnc, &Transmitter);
+    }
+    LowPower.EstimateEnergyBudget(LowPowerState::SLEEP_MODE_DEEP, TST_CYCLE_TIME + 1000, TST_SAMPLE_PERIOD, TST_ACTIVE_TIME, 1000, &Estimated);
+    TST_CHECK_EQUAL(Measured.m_ui32CycleTime, TST_CYCLE_TIME + 1000);
+    TST_CHECK_EQUAL(Measured.m_ui32WakeupCount, Estimated.m_ui32WakeupCount);
+    TST_CHECK_EQUAL(Measured.m_ui32ActiveTime, Estimated.m_ui32ActiveTime);
+    TST_CHECK_EQUAL(Measured.m_ui32DeepSleepTime, Estimated.m_ui32DeepSleepTime);
+    TST_CHECK(fabsf(Measured.m_flCharge - Estimated.m_flCharge) < 0.01f);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Wakeup Latency: Poll Period / Wakeup Time / Boot Time + Time-on-Air
+//---------------------------------------------------------------------------
+
+static  void  TstWakeupLatency (void)
+{
+
+LowPowerState  LowPower;
+uint32_t       ui32TimeOnAir;
+
+
+    printf("Test: Wakeup Latency\n");
+
+    LowPower.Setup(&TstPowerModel_l);
+
+    // SF12/125kHz/4-5, 40 Byte Data Packet: (12.25 + 48) Symbols * 32.768ms
+    ui32TimeOnAir = LoraTransmitter::CalcTimeOnAir(12, 125E3, 5, LoraTransmitter::LORA_PREAMBLE_LENGTH,
+                                                   LoraTransmitter::LORA_CRC_ENABLED, false, sizeof(tLoraDataPacket)) / 1000;
+    TST_CHECK_EQUAL(ui32TimeOnAir, 1974);
+
+    TST_CHECK_EQUAL(LowPower.EstimateWakeupLatency(LowPowerState::SLEEP_MODE_NONE,  TST_POLL_PERIOD, ui32TimeOnAir), TST_POLL_PERIOD + 1974);
+    TST_CHECK_EQUAL(LowPower.EstimateWakeupLatency(LowPowerState::SLEEP_MODE_LIGHT, TST_POLL_PERIOD, ui32TimeOnAir), TST_WAKEUP_TIME + 1974);
+    TST_CHECK_EQUAL(LowPower.EstimateWakeupLatency(LowPowerState::SLEEP_MODE_DEEP,  TST_POLL_PERIOD, ui32TimeOnAir), TST_BOOT_TIME + 1974);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Run a Device for a few Transmit Cycles, optionally with Deep Sleep
+//---------------------------------------------------------------------------
+//  Without Deep Sleep the Device runs on a continuous Time Base. With Deep
+//  Sleep all Objects are rebuilt after the Wakeup as by setup() of the
+//  Firmware, millis() restarts and only the RTC Memory is kept.
+
+static  void  TstRunDevice (tTstRun* pRun_p, unsigned int uiGenDepth_p, bool fDeepSleep_p)
+{
+
+static LowPowerState::tRetainState  RetainState;    // RTC Memory
+
+uint32_t      ui32Tick;
+uint32_t      ui32SleepTime;
+unsigned int  uiPacket;
+
+
+    memset(pRun_p, 0x00, sizeof(*pRun_p));
+    memset(&RetainState, 0x00, sizeof(RetainState));
+
+    // ---- before Deep Sleep ----
+    {
+        LoraPayloadEncoder  LoraPayloadEnc;
+        LoraTransmitter     Transmitter;
+        LowPowerState       LowPower;
+
+        ArduinoSimSetTick(1000);
+        TstSetupDevice(&LoraPayloadEnc, &Transmitter, uiGenDepth_p);
+        LowPower.Setup(&TstPowerModel_l);
+
+        ui32Tick = 1000;
+        for (uiPacket=0; uiPacket<TST_PACKETS_BEFORE; uiPacket++)
+        {
+            ArduinoSimSetTick(ui32Tick);
+            TstTransmitPacket(pRun_p, uiPacket, &LoraPayloadEnc, &Transmitter);
+            ui32Tick += TST_CYCLE_TIME;
+        }
+
+        // enter Deep Sleep 5s after the last Packet
+        ui32Tick = ui32Tick - TST_CYCLE_TIME + 5000;
+        ArduinoSimSetTick(ui32Tick);
+        LowPower.SaveState(&RetainState, TST_RTC_OFFSET + ui32Tick, &LoraPayloadEnc, &Transmitter);
+
+        if ( !fDeepSleep_p )
+        {
+            // reference: continuous Time Base, the same Objects keep running
+            ui32Tick += TST_SLEEP_TIME + TST_BOOT_TIME;
+            ArduinoSimSetTick(ui32Tick);
+            pRun_p->m_i32RemainingTime = Transmitter.GetRemainingTransmitCycleTime();
+            for (uiPacket=TST_PACKETS_BEFORE; uiPacket<(TST_PACKETS_BEFORE + TST_PACKETS_AFTER); uiPacket++)
+            {
+                ArduinoSimSetTick(ui32Tick);
+                TstTransmitPacket(pRun_p, uiPacket, &LoraPayloadEnc, &Transmitter);
+                ui32Tick += TST_CYCLE_TIME;
+            }
+            Transmitter.GetDutyCycleInfo(&pRun_p->m_DutyCycleInfo);
+            return;
+        }
+    }
+
+    // ---- after Wakeup: new Objects, millis() restarts ----
+    {
+        LoraPayloadEncoder  LoraPayloadEnc;
+        LoraTransmitter     Transmitter;
+        LowPowerState       LowPower;
+
+        TST_CHECK( LowPowerState::IsRetainStateValid(&RetainState) );
+
+        ArduinoSimSetTick(TST_BOOT_TIME);
+        TstSetupDevice(&LoraPayloadEnc, &Transmitter, uiGenDepth_p);
+        LowPower.Setup(&TstPowerModel_l);
+        ui32SleepTime = LowPower.RestoreState(&RetainState, TST_RTC_OFFSET + ui32Tick + TST_SLEEP_TIME + TST_BOOT_TIME, &LoraPayloadEnc, &Transmitter);
+
+        TST_CHECK_EQUAL(ui32SleepTime, TST_SLEEP_TIME);
+        TST_CHECK_EQUAL(LowPower.GetSysTick(), ui32Tick + TST_SLEEP_TIME + TST_BOOT_TIME);
+        TST_CHECK( !LowPowerState::IsRetainStateValid(&RetainState) );
+
+        pRun_p->m_i32RemainingTime = Transmitter.GetRemainingTransmitCycleTime();
+        ui32Tick = TST_BOOT_TIME;
+        for (uiPacket=TST_PACKETS_BEFORE; uiPacket<(TST_PACKETS_BEFORE + TST_PACKETS_AFTER); uiPacket++)
+        {
+            ArduinoSimSetTick(ui32Tick);
+            TstTransmitPacket(pRun_p, uiPacket, &LoraPayloadEnc, &Transmitter);
+            ui32Tick += TST_CYCLE_TIME;
+        }
+        Transmitter.GetDutyCycleInfo(&pRun_p->m_DutyCycleInfo);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Setup Encoder and Transmitter as by setup() of the Firmware
+//---------------------------------------------------------------------------
+
+static  void  TstSetupDevice (LoraPayloadEncoder* pLoraPayloadEnc_p, LoraTransmitter* pLoraTransmitter_p, unsigned int uiGenDepth_p)
+{
+
+LoraTransmitter::tLoraTransmitterSettings  Settings;
+
+
+    memset(&Settings, 0x00, sizeof(Settings));
+    Settings.m_iLoraSpreadingFactor       = 12;
+    Settings.m_lLoraSignalBandwidth       = 125E3;
+    Settings.m_iLoraCodingRateDenominator = 5;
+    Settings.m_ui16DutyCycleLimit         = 10;                     // 1%
+    Settings.m_ui32DutyCycleWindow        = (60 * 60 * 1000);       // 1h
+
+    pLoraPayloadEnc_p->Setup(0x42);
+    pLoraPayloadEnc_p->SetupGenerationDepth(uiGenDepth_p);
+    pLoraTransmitter_p->Setup(&Settings, 4711);
+    pLoraTransmitter_p->CalcNextTransmitCycleTime(TST_INHIBIT_TIME, TST_CYCLE_TIME);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Encode and transmit a Data Packet with deterministic Sensor Data
+//---------------------------------------------------------------------------
+
+static  void  TstTransmitPacket (tTstRun* pRun_p, unsigned int uiPacket_p, LoraPayloadEncoder* pLoraPayloadEnc_p, LoraTransmitter* pLoraTransmitter_p)
+{
+
+LoraPayloadEncoder::tSensorDataRec  SensorDataRec;
+const void*                         pPayload;
+unsigned int                        uiPayloadLen;
+
+
+    memset(&SensorDataRec, 0x00, sizeof(SensorDataRec));
+    SensorDataRec.m_ui32Uptime            = uiPacket_p * (TST_CYCLE_TIME / 1000);
+    SensorDataRec.m_flTemperature         = 18.5f + (float)uiPacket_p * 0.7f;
+    SensorDataRec.m_flHumidity            = 60.0f - (float)uiPacket_p * 1.5f;
+    SensorDataRec.m_fMotionActive         = ((uiPacket_p % 2) != 0);
+    SensorDataRec.m_ui16MotionActiveTime  = (uint16_t)(uiPacket_p * 11);
+    SensorDataRec.m_ui16MotionActiveCount = (uint16_t)uiPacket_p;
+    SensorDataRec.m_ui8LightLevel         = (uint8_t)(uiPacket_p * 13);
+    SensorDataRec.m_flCarBattLevel        = 12.0f + (float)uiPacket_p * 0.1f;
+
+    pLoraPayloadEnc_p->EncodeTxDataPacket(&SensorDataRec);
+    pPayload = pLoraPayloadEnc_p->GetTxDataPayload(&uiPayloadLen);
+    pLoraTransmitter_p->TransmitPacket(pPayload, (uint8_t)uiPayloadLen);
+    pLoraTransmitter_p->CalcNextTransmitCycleTime(TST_INHIBIT_TIME, TST_CYCLE_TIME);
+
+    if (uiPayloadLen > sizeof(pRun_p->m_abPayload[uiPacket_p]))
+    {
+        uiPayloadLen = sizeof(pRun_p->m_abPayload[uiPacket_p]);
+    }
+    memcpy(pRun_p->m_abPayload[uiPacket_p], pPayload, uiPayloadLen);
+    pRun_p->m_auiPayloadLen[uiPacket_p] = uiPayloadLen;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Benchmark: Energy Budget per LoRa Cycle and Wakeup Latency
+//---------------------------------------------------------------------------
+
+static  void  TstRunBenchmark (void)
+{
+
+static const int         aiSpreadingFactor[] = { 7, 10, 12 };
+static const char*       apszSleepMode[]     = { "None", "Light", "Deep" };
+
+LowPowerState                 LowPower;
+LowPowerState::tEnergyBudget  EnergyBudget;
+unsigned int                  uiSF;
+int                           iSleepMode;
+uint32_t                      ui32TimeOnAir;
+uint32_t                      ui32Latency;
+
+
+    LowPower.Setup(&TstPowerModel_l);
+
+    printf("Energy Budget per LoRa Cycle (Cycle %u [min], Wakeup every %u [s] for %u [ms], %u Byte Data Packet)\n",
+           (unsigned int)(TST_CYCLE_TIME / 60000), (unsigned int)(TST_SAMPLE_PERIOD / 1000), (unsigned int)TST_ACTIVE_TIME,
+           (unsigned int)sizeof(tLoraDataPacket));
+    printf("  Sleep  SF  TimeOnAir   Latency     Active   LightSleep    DeepSleep     Charge   AvgCurrent  Runtime(%.0fmAh)\n", TST_BATTERY_CAPACITY);
+    printf("              [ms]        [ms]        [ms]        [ms]         [ms]       [uAh]       [mA]        [days]\n");
+
+    for (iSleepMode=LowPowerState::SLEEP_MODE_NONE; iSleepMode<=LowPowerState::SLEEP_MODE_DEEP; iSleepMode++)
+    {
+        for (uiSF=0; uiSF<sizeof(aiSpreadingFactor)/sizeof(aiSpreadingFactor[0]); uiSF++)
+        {
+            ui32TimeOnAir = LoraTransmitter::CalcTimeOnAir(aiSpreadingFactor[uiSF], 125E3, 5, LoraTransmitter::LORA_PREAMBLE_LENGTH,
+                                                           LoraTransmitter::LORA_CRC_ENABLED, false, sizeof(tLoraDataPacket)) / 1000;
+            ui32Latency = LowPower.EstimateWakeupLatency(iSleepMode, TST_POLL_PERIOD, ui32TimeOnAir);
+            LowPower.EstimateEnergyBudget(iSleepMode, TST_CYCLE_TIME, TST_SAMPLE_PERIOD, TST_ACTIVE_TIME, ui32TimeOnAir, &EnergyBudget);
+
+            printf("  %-5s  %2d  %8u  %8u  %9u  %11u  %11u  %9.1f  %10.3f  %10.1f\n",
+                   apszSleepMode[iSleepMode], aiSpreadingFactor[uiSF], (unsigned int)ui32TimeOnAir, (unsigned int)ui32Latency,
+                   (unsigned int)EnergyBudget.m_ui32ActiveTime, (unsigned int)EnergyBudget.m_ui32LightSleepTime,
+                   (unsigned int)EnergyBudget.m_ui32DeepSleepTime, EnergyBudget.m_flCharge, EnergyBudget.m_flAvgCurrent,
+                   TST_BATTERY_CAPACITY / EnergyBudget.m_flAvgCurrent / 24.0f);
+        }
+    }
+
+    return;
+
+}
+
+
+
+// EOF
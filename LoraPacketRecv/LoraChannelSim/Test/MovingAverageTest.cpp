@@ -0,0 +1,570 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Channel Simulator
+  Description:  Host Test and Benchmark for Moving Average Classes
+                of the Firmware (SimpleMovingAverage.hpp)
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "SimpleMovingAverage.hpp"
+#include "TestCheck.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+const  unsigned int  TST_DRIFT_SAMPLES      = 10000000; // samples of long-run drift test (~ 95 years at 5 min)
+const  unsigned int  TST_BENCH_SAMPLES      = 20000000; // samples per benchmark run
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+TST_DEFINE_COUNTERS()
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+static  uint32_t  ui32RandState_l = 0x12345678;
+
+// large windows as static objects (too big for the stack)
+static  FixedMovingAverage<float, 65536, 1>     FixedMovAvg65536_l;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  void  TstRounding (void);
+static  void  TstPow2ShiftPath (void);
+static  void  TstNegativeRounding (void);
+static  void  TstSaturation (void);
+static  void  TstExpSettling (void);
+template <int WINDOW_SIZE>  static  void  TstLongRunDrift (void);
+
+static  void  TstRunBenchmark (void);
+template <class C>  static  double  TstBenchMovAvg (C& MovAvg_p, const float* pflSamples_p, unsigned int uiCount_p);
+
+static  int16_t   TstGetRandomSample (void);
+static  double    TstGetTime (void);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Main function of this application
+//---------------------------------------------------------------------------
+//  Without arguments the functional checks are run ('make test'), option
+//  '-b' compares the cost per sample with <SimpleMovingAverage> ('make bench').
+
+int  main (int iArgCnt_p, char* apszArg_p[])
+{
+
+    if ((iArgCnt_p > 1) && !strcmp(apszArg_p[1], "-b"))
+    {
+        TstRunBenchmark();
+        return (0);
+    }
+
+    TstRounding();
+    TstPow2ShiftPath();
+    TstNegativeRounding();
+    TstSaturation();
+    TstExpSettling();
+    TstLongRunDrift<16>();                              // power-of-two window (shift path)
+    TstLongRunDrift<200>();                             // DHT window size of the firmware
+
+    return (TST_RESULT("MovingAverageTest"));
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Rounding Helpers against llround() (half away from zero)
+//---------------------------------------------------------------------------
+
+static  void  TstRounding (void)
+{
+
+static const int32_t  ai32Edges[] = { INT32_MIN, INT32_MIN + 1, -65536 * 32768 + 1, -1, 0, 1, 65535 * 32767, INT32_MAX - 65536 };
+
+int32_t   i32Value;
+int       iShift;
+unsigned  uiFailed;
+unsigned  uiIdx;
+
+
+    printf("Test: Rounding Helpers\n");
+
+    uiFailed = 0;
+    for (iShift=0; iShift<=16; iShift++)
+    {
+        for (i32Value=-200000; i32Value<=200000; i32Value++)
+        {
+            if ((MovAvgRoundShift(i32Value, iShift) != (int32_t)llround((double)i32Value / (double)(1 << iShift))) ||
+                (MovAvgRoundDiv(i32Value, 1U << iShift) != MovAvgRoundShift(i32Value, iShift)))
+            {
+                uiFailed++;
+            }
+        }
+        for (uiIdx=0; uiIdx<sizeof(ai32Edges)/sizeof(ai32Edges[0]); uiIdx++)
+        {
+            if ((iShift > 0) &&
+                (MovAvgRoundShift(ai32Edges[uiIdx], iShift) != (int32_t)llround((double)ai32Edges[uiIdx] / (double)(1 << iShift))))
+            {
+                uiFailed++;
+            }
+        }
+    }
+    TST_CHECK_EQUAL(uiFailed, 0);
+
+    uiFailed = 0;
+    for (uiIdx=3; uiIdx<=65536; uiIdx+=(uiIdx < 1000) ? 1 : 997)
+    {
+        for (i32Value=-50000; i32Value<=50000; i32Value+=7)
+        {
+            if (MovAvgRoundDiv(i32Value, uiIdx) != (int32_t)llround((double)i32Value / (double)uiIdx))
+            {
+                uiFailed++;
+            }
+        }
+    }
+    TST_CHECK_EQUAL(uiFailed, 0);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Power-of-Two Window: Shift Path gives the same Result as the Division
+//---------------------------------------------------------------------------
+
+static  void  TstPow2ShiftPath (void)
+{
+
+FixedMovingAverage<float, 8>  MovAvgPow2;
+FixedMovingAverage<float, 7>  MovAvgDiv;
+unsigned int  uiIdx;
+unsigned int  uiMismatch;
+int32_t       i32Sum;
+int16_t       ai16Window[8];
+int16_t       i16Sample;
+
+
+    printf("Test: Power-of-Two Shift Path\n");
+
+    // window of 8 -> sum of +4 / -4 is exactly +0.5 / -0.5
+    for (uiIdx=0; uiIdx<8; uiIdx++)
+    {
+        MovAvgPow2.CalcMovingAverage((uiIdx < 4) ? 0.1f : 0.0f);
+    }
+    TST_CHECK_EQUAL(MovAvgPow2.GetAverageFixed(), 1);
+    for (uiIdx=0; uiIdx<8; uiIdx++)
+    {
+        MovAvgPow2.CalcMovingAverage((uiIdx < 4) ? -0.1f : 0.0f);
+    }
+    TST_CHECK_EQUAL(MovAvgPow2.GetAverageFixed(), -1);
+    for (uiIdx=0; uiIdx<8; uiIdx++)
+    {
+        MovAvgPow2.CalcMovingAverage((uiIdx < 3) ? -0.1f : 0.0f);
+    }
+    TST_CHECK_EQUAL(MovAvgPow2.GetAverageFixed(), 0);
+
+    // random samples: shift path and reference on the exact sum
+    MovAvgPow2.Clean();
+    memset(ai16Window, 0, sizeof(ai16Window));
+    i32Sum = 0;
+    uiMismatch = 0;
+    for (uiIdx=0; uiIdx<100000; uiIdx++)
+    {
+        i16Sample = (int16_t)((int)TstGetRandomSample() - 400);
+        i32Sum += i16Sample - ai16Window[uiIdx % 8];
+        ai16Window[uiIdx % 8] = i16Sample;
+        MovAvgPow2.CalcMovingAverage((float)i16Sample / 10.0f);
+        if ((uiIdx >= 7) && (MovAvgPow2.GetAverageFixed() != (int32_t)llround((double)i32Sum / 8.0)))
+        {
+            uiMismatch++;
+        }
+    }
+    TST_CHECK_EQUAL(uiMismatch, 0);
+
+    // not yet settled -> arithmetic average of the samples received so far
+    MovAvgDiv.CalcMovingAverage(-0.1f);
+    MovAvgDiv.CalcMovingAverage(0.0f);
+    TST_CHECK_EQUAL(MovAvgDiv.GetAverageFixed(), -1);
+    MovAvgDiv.CalcMovingAverage(0.0f);
+    TST_CHECK_EQUAL(MovAvgDiv.GetAverageFixed(), 0);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Negative Values are rounded like positive ones (mirror Symmetry)
+//---------------------------------------------------------------------------
+
+static  void  TstNegativeRounding (void)
+{
+
+FixedMovingAverage<float, 16>  FixedPos;
+FixedMovingAverage<float, 16>  FixedNeg;
+FixedMovingAverage<float, 10>  FixedPos10;
+FixedMovingAverage<float, 10>  FixedNeg10;
+ExpMovingAverage<float, 3>     ExpPos;
+ExpMovingAverage<float, 3>     ExpNeg;
+unsigned int  uiIdx;
+unsigned int  uiMismatch;
+float         flSample;
+
+
+    printf("Test: Negative Rounding\n");
+
+    // ValueToFixed(): -0.05 -> -1 like +0.05 -> +1, -0.04 -> 0
+    FixedNeg.CalcMovingAverage(-0.05f);
+    TST_CHECK_EQUAL(FixedNeg.GetAverageFixed(), -1);
+    FixedNeg.Clean();
+    FixedNeg.CalcMovingAverage(-0.04f);
+    TST_CHECK_EQUAL(FixedNeg.GetAverageFixed(), 0);
+    FixedNeg.Clean();
+
+    uiMismatch = 0;
+    for (uiIdx=0; uiIdx<200000; uiIdx++)
+    {
+        flSample = (float)TstGetRandomSample() / 10.0f;
+        FixedPos.CalcMovingAverage(flSample);
+        FixedNeg.CalcMovingAverage(-flSample);
+        FixedPos10.CalcMovingAverage(flSample);
+        FixedNeg10.CalcMovingAverage(-flSample);
+        ExpPos.CalcMovingAverage(flSample);
+        ExpNeg.CalcMovingAverage(-flSample);
+        if ((FixedNeg.GetAverageFixed()   != -FixedPos.GetAverageFixed())   ||
+            (FixedNeg10.GetAverageFixed() != -FixedPos10.GetAverageFixed()) ||
+            (ExpNeg.GetAverageFixed()     != -ExpPos.GetAverageFixed())     ||
+            (ExpNeg.GetAverageValue()     != -ExpPos.GetAverageValue()))
+        {
+            uiMismatch++;
+        }
+    }
+    TST_CHECK_EQUAL(uiMismatch, 0);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Saturation at the int16 Limits of the Fixed-Point Samples
+//---------------------------------------------------------------------------
+
+static  void  TstSaturation (void)
+{
+
+FixedMovingAverage<float, 4>  MovAvg;
+ExpMovingAverage<float, 4>    ExpMovAvg;
+unsigned int  uiIdx;
+
+
+    printf("Test: Saturation\n");
+
+    // 3276.7 is the largest value representable with VALUE_SCALE=10
+    for (uiIdx=0; uiIdx<4; uiIdx++)
+    {
+        MovAvg.CalcMovingAverage(5000.0f);
+    }
+    TST_CHECK_EQUAL(MovAvg.GetAverageFixed(), INT16_MAX);
+    TST_CHECK(fabsf(MovAvg.GetAverageValue() - 3276.7f) < 0.01f);
+
+    for (uiIdx=0; uiIdx<4; uiIdx++)
+    {
+        MovAvg.CalcMovingAverage(-1.0e9f);
+    }
+    TST_CHECK_EQUAL(MovAvg.GetAverageFixed(), INT16_MIN);
+    TST_CHECK(fabsf(MovAvg.GetAverageValue() + 3276.8f) < 0.01f);
+
+    for (uiIdx=0; uiIdx<1000; uiIdx++)
+    {
+        ExpMovAvg.CalcMovingAverage((uiIdx & 1) ? 9999.0f : -9999.0f);
+    }
+    TST_CHECK((ExpMovAvg.GetAverageFixed() >= INT16_MIN) && (ExpMovAvg.GetAverageFixed() <= INT16_MAX));
+
+    // largest window: sum of 65536 x INT16_MIN is exactly INT32_MIN
+    for (uiIdx=0; uiIdx<65536; uiIdx++)
+    {
+        FixedMovAvg65536_l.CalcMovingAverage(-40000.0f);
+    }
+    TST_CHECK_EQUAL(FixedMovAvg65536_l.GetAverageFixed(), INT16_MIN);
+    for (uiIdx=0; uiIdx<65536; uiIdx++)
+    {
+        FixedMovAvg65536_l.CalcMovingAverage(40000.0f);
+    }
+    TST_CHECK_EQUAL(FixedMovAvg65536_l.GetAverageFixed(), INT16_MAX);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Exponential Average settles exactly to a constant Input
+//---------------------------------------------------------------------------
+
+static  void  TstExpSettling (void)
+{
+
+ExpMovingAverage<float, 3>   ExpMovAvg3;
+ExpMovingAverage<float, 15>  ExpMovAvg15;
+unsigned int  uiIdx;
+
+
+    printf("Test: Exponential Settling\n");
+
+    ExpMovAvg3.CalcMovingAverage(25.0f);
+    ExpMovAvg15.CalcMovingAverage(25.0f);
+    for (uiIdx=0; uiIdx<2000000; uiIdx++)
+    {
+        ExpMovAvg3.CalcMovingAverage(-12.3f);
+        ExpMovAvg15.CalcMovingAverage(-12.3f);
+    }
+    TST_CHECK_EQUAL(ExpMovAvg3.GetAverageFixed(), -123);
+    TST_CHECK_EQUAL(ExpMovAvg15.GetAverageFixed(), -123);
+    TST_CHECK(fabsf(ExpMovAvg3.GetAverageValue() + 12.3f) < 0.0501f);
+    TST_CHECK(fabsf(ExpMovAvg15.GetAverageValue() + 12.3f) < 0.0501f);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Long Run: Fixed-Point Sum stays exact, Float Sum drifts
+//---------------------------------------------------------------------------
+//  All samples have 0.1 resolution (like the DHT values). The reference is
+//  the exact integer sum of the last WINDOW_SIZE samples.
+
+template <int WINDOW_SIZE>  static  void  TstLongRunDrift (void)
+{
+
+SimpleMovingAverage<float>                  FloatMovAvg(WINDOW_SIZE);
+FixedMovingAverage<float, WINDOW_SIZE>      FixedMovAvg;
+int16_t       ai16Window[WINDOW_SIZE];
+int32_t       i32Sum;
+int16_t       i16Sample;
+double        dblRefAvg;
+double        dblErr;
+double        dblMaxErrFloat;
+double        dblMaxErrFixed;
+unsigned int  uiMismatch;
+unsigned int  uiIdx;
+
+
+    printf("Test: Long-Run Drift (Window %d, %u Samples)\n", WINDOW_SIZE, TST_DRIFT_SAMPLES);
+
+    memset(ai16Window, 0, sizeof(ai16Window));
+    i32Sum = 0;
+    uiMismatch = 0;
+    dblMaxErrFloat = 0;
+    dblMaxErrFixed = 0;
+    for (uiIdx=0; uiIdx<TST_DRIFT_SAMPLES; uiIdx++)
+    {
+        i16Sample = TstGetRandomSample();
+        i32Sum += i16Sample - ai16Window[uiIdx % WINDOW_SIZE];
+        ai16Window[uiIdx % WINDOW_SIZE] = i16Sample;
+
+        FloatMovAvg.CalcMovingAverage((float)i16Sample / 10.0f);
+        FixedMovAvg.CalcMovingAverage((float)i16Sample / 10.0f);
+        if (uiIdx < WINDOW_SIZE)
+        {
+            continue;
+        }
+
+        dblRefAvg = (double)i32Sum / (WINDOW_SIZE * 10.0);
+        dblErr = fabs(FloatMovAvg.GetAverageValue() - dblRefAvg);
+        if (dblErr > dblMaxErrFloat)
+        {
+            dblMaxErrFloat = dblErr;
+        }
+        dblErr = fabs(FixedMovAvg.GetAverageValue() - dblRefAvg);
+        if (dblErr > dblMaxErrFixed)
+        {
+            dblMaxErrFixed = dblErr;
+        }
+        if (FixedMovAvg.GetAverageFixed() != (int32_t)llround((double)i32Sum / WINDOW_SIZE))
+        {
+            uiMismatch++;
+        }
+    }
+
+    printf("  max. Error SimpleMovingAverage<float> = %.6f\n", dblMaxErrFloat);
+    printf("  max. Error FixedMovingAverage<float>  = %.6f\n", dblMaxErrFixed);
+
+    // only the float conversion of the (exact) average remains
+    TST_CHECK(dblMaxErrFixed < 0.0001);
+    TST_CHECK_EQUAL(uiMismatch, 0);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Benchmark: Cost per Sample compared with <SimpleMovingAverage>
+//---------------------------------------------------------------------------
+
+static  void  TstRunBenchmark (void)
+{
+
+SimpleMovingAverage<float>      SimpleMovAvg200(200);
+SimpleMovingAverage<float>      SimpleMovAvg256(256);
+FixedMovingAverage<float, 200>  FixedMovAvg200;
+FixedMovingAverage<float, 256>  FixedMovAvg256;
+ExpMovingAverage<float, 7>      ExpMovAvg7;
+float*        pflSamples;
+unsigned int  uiIdx;
+
+
+    pflSamples = (float*)malloc(TST_BENCH_SAMPLES * sizeof(float));
+    if (pflSamples == NULL)
+    {
+        printf("ERROR: Out of memory!\n");
+        return;
+    }
+    for (uiIdx=0; uiIdx<TST_BENCH_SAMPLES; uiIdx++)
+    {
+        pflSamples[uiIdx] = (float)TstGetRandomSample() / 10.0f;
+    }
+
+    printf("Moving Average Benchmark (%u samples per run):\n", TST_BENCH_SAMPLES);
+    printf("  SimpleMovingAverage<float>(200) : %6.2f [ns/sample]\n", TstBenchMovAvg(SimpleMovAvg200, pflSamples, TST_BENCH_SAMPLES));
+    printf("  FixedMovingAverage<float,200>   : %6.2f [ns/sample]\n", TstBenchMovAvg(FixedMovAvg200,  pflSamples, TST_BENCH_SAMPLES));
+    printf("  SimpleMovingAverage<float>(256) : %6.2f [ns/sample]\n", TstBenchMovAvg(SimpleMovAvg256, pflSamples, TST_BENCH_SAMPLES));
+    printf("  FixedMovingAverage<float,256>   : %6.2f [ns/sample]\n", TstBenchMovAvg(FixedMovAvg256,  pflSamples, TST_BENCH_SAMPLES));
+    printf("  ExpMovingAverage<float,7>       : %6.2f [ns/sample]\n", TstBenchMovAvg(ExpMovAvg7,      pflSamples, TST_BENCH_SAMPLES));
+    printf("\n");
+
+    free(pflSamples);
+
+    return;
+
+}
+
+
+template <class C>  static  double  TstBenchMovAvg (
+    C& MovAvg_p,                                        // [IN]     Moving Average Object
+    const float* pflSamples_p,                          // [IN]     Samples
+    unsigned int uiCount_p)                             // [IN]     Number of Samples
+{
+
+volatile float  flSink;
+double          dblStart;
+double          dblElapsed;
+unsigned int    uiIdx;
+
+
+    dblStart = TstGetTime();
+    for (uiIdx=0; uiIdx<uiCount_p; uiIdx++)
+    {
+        flSink = MovAvg_p.CalcMovingAverage(pflSamples_p[uiIdx]);
+    }
+    dblElapsed = TstGetTime() - dblStart;
+    (void)flSink;
+
+    return ((dblElapsed * 1.0e9) / uiCount_p);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Random Temperature Sample (-40.0 ... +85.0 in 0.1 Steps, DHT Range)
+//---------------------------------------------------------------------------
+
+static  int16_t  TstGetRandomSample (void)
+{
+
+    // xorshift32, deterministic and independent of the C library
+    ui32RandState_l ^= ui32RandState_l << 13;
+    ui32RandState_l ^= ui32RandState_l >> 17;
+    ui32RandState_l ^= ui32RandState_l << 5;
+
+    return ((int16_t)((int)(ui32RandState_l % 1251) - 400));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get monotonic Time in [sec]
+//---------------------------------------------------------------------------
+
+static  double  TstGetTime (void)
+{
+
+struct timespec  TimeSpec;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &TimeSpec);
+
+    return ((double)TimeSpec.tv_sec + ((double)TimeSpec.tv_nsec / 1000000000.0));
+
+}
+
+
+
+// EOF
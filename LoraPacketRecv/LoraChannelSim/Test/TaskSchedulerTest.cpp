@@ -0,0 +1,578 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Channel Simulator
+  Description:  Host Test and Jitter Measurement for the Firmware
+                Class <TaskScheduler>
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "TaskScheduler.h"
+#include "TestCheck.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+const  uint32_t  TST_BENCH_DURATION         = (24 * 60 * 60 * 1000);    // simulated time of jitter measurement [ms]
+const  uint32_t  TST_MAX_SLEEP_TIME         = 1000;                     // as TASK_SCHED_MAX_SLEEP_TIME of firmware [ms]
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+//  The Task Functions don't do anything but advance the simulated Tick by
+//  their Run Time, so Jitter and Idle Ratio only depend on the Scheduler.
+
+typedef struct
+{
+    uint32_t            m_ui32RunTime;              // simulated run time per call [ms]
+    uint32_t            m_ui32Period;               // same as registered at the scheduler [ms]
+    uint32_t            m_ui32LastStart;
+    uint32_t            m_ui32RunCount;
+    uint32_t            m_ui32MaxPeriodDev;         // max. deviation of start interval from period [ms]
+    uint64_t            m_ui64SumPeriodDev;
+
+} tTstTask;
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+TST_DEFINE_COUNTERS()
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+static  uint32_t            ui32FakeTick_l          = 0;
+static  uint32_t            ui32MaxWakeupDelay_l    = 0;        // sleep returns up to this time too late [ms]
+static  uint32_t            ui32RandState_l         = 0x2468ACE1;
+static  uint32_t            ui32ScheduleRuns_l      = 0;
+static  tTstTask            aTstTask_l[TaskScheduler::MAX_TASKS];
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  void  TstPeriodicNoLoad (void);
+static  void  TstLatenessUnderLoad (void);
+static  void  TstTickWrapAround (void);
+static  void  TstTriggerReschedule (void);
+static  void  TstOneRunPerSchedule (void);
+static  void  TstRunJitterMeasurement (void);
+
+static  void      TstSetupScheduler (TaskScheduler* pScheduler_p, uint32_t ui32StartTick_p);
+static  int       TstAddTask (TaskScheduler* pScheduler_p, const char* pszName_p, uint32_t ui32Period_p, uint32_t ui32FirstDelay_p, uint32_t ui32RunTime_p);
+static  void      TstRunFor (TaskScheduler* pScheduler_p, uint32_t ui32Duration_p);
+static  uint32_t  TstGetTick (void);
+static  void      TstSleep (uint32_t ui32SleepTime_p);
+static  void      TstTaskFunc (int iTask_p);
+
+template <int TASK>  static  void  TstTask (void)  { TstTaskFunc(TASK); }
+
+static  const  TaskScheduler::tTaskFunc  TST_TASK_FUNC_TAB[TaskScheduler::MAX_TASKS] =
+{
+    TstTask<0>, TstTask<1>, TstTask<2>, TstTask<3>, TstTask<4>,  TstTask<5>,
+    TstTask<6>, TstTask<7>, TstTask<8>, TstTask<9>, TstTask<10>, TstTask<11>
+};
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Main function of this application
+//---------------------------------------------------------------------------
+//  Without arguments the functional checks are run ('make test'), option
+//  '-b' simulates one day with the task set of the firmware and reports
+//  Scheduling Jitter and Idle Ratio ('make bench').
+
+int  main (int iArgCnt_p, char* apszArg_p[])
+{
+
+    if ((iArgCnt_p > 1) && !strcmp(apszArg_p[1], "-b"))
+    {
+        TstRunJitterMeasurement();
+        return (0);
+    }
+
+    TstPeriodicNoLoad();
+    TstLatenessUnderLoad();
+    TstTickWrapAround();
+    TstTriggerReschedule();
+    TstOneRunPerSchedule();
+
+    return (TST_RESULT("TaskSchedulerTest"));
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Idle System: Tasks start exactly on their Deadlines
+//---------------------------------------------------------------------------
+
+static  void  TstPeriodicNoLoad (void)
+{
+
+TaskScheduler  Scheduler;
+int            iTask100;
+int            iTask1000;
+
+
+    printf("Test: Periodic Tasks without Load\n");
+
+    TstSetupScheduler(&Scheduler, 1000);
+    iTask100  = TstAddTask(&Scheduler, "T100",  100,  0,   0);
+    iTask1000 = TstAddTask(&Scheduler, "T1000", 1000, 500, 0);
+
+    TstRunFor(&Scheduler, 60000);
+
+    TST_CHECK_EQUAL(Scheduler.GetTaskInfo(iTask100)->m_ui32RunCount,  600);
+    TST_CHECK_EQUAL(Scheduler.GetTaskInfo(iTask1000)->m_ui32RunCount, 60);
+    TST_CHECK_EQUAL(Scheduler.GetTaskInfo(iTask100)->m_ui32MaxLateness,  0);
+    TST_CHECK_EQUAL(Scheduler.GetTaskInfo(iTask1000)->m_ui32MaxLateness, 0);
+    TST_CHECK_EQUAL(aTstTask_l[iTask100].m_ui32MaxPeriodDev, 0);
+    TST_CHECK_EQUAL(Scheduler.GetIdleRatio(), 1000);
+
+    // the scheduler sleeps until the next deadline instead of polling
+    // (deadlines of T1000 coincide with the ones of T100)
+    TST_CHECK_EQUAL(ui32ScheduleRuns_l, 600);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Long-running Task: Lateness of the others, drift-free Period, Idle Ratio
+//---------------------------------------------------------------------------
+
+static  void  TstLatenessUnderLoad (void)
+{
+
+TaskScheduler  Scheduler;
+int            iTaskFast;
+int            iTaskSlow;
+
+
+    printf("Test: Lateness under Load\n");
+
+    // slow task runs 30 ms every second, in phase with the fast task
+    TstSetupScheduler(&Scheduler, 0);
+    iTaskSlow = TstAddTask(&Scheduler, "Slow", 1000, 0, 30);
+    iTaskFast = TstAddTask(&Scheduler, "Fast", 100,  0, 1);
+
+    TstRunFor(&Scheduler, 60000);
+
+    // fast task is delayed by the slow one only, without losing periods
+    TST_CHECK_EQUAL(Scheduler.GetTaskInfo(iTaskFast)->m_ui32MaxLateness, 30);
+    TST_CHECK_EQUAL(Scheduler.GetTaskInfo(iTaskFast)->m_ui32RunCount, 600);
+    TST_CHECK_EQUAL(Scheduler.GetTaskInfo(iTaskSlow)->m_ui32MaxLateness, 0);
+    TST_CHECK_EQUAL(Scheduler.GetTaskInfo(iTaskSlow)->m_ui32MaxRunTime, 30);
+
+    // busy: 30 ms + 10 x 1 ms per second -> idle 96.0 %
+    TST_CHECK_EQUAL(Scheduler.GetIdleRatio(), 960);
+
+    // overload: a task longer than the period of another one skips missed
+    // periods instead of running several times in a row
+    TstSetupScheduler(&Scheduler, 0);
+    iTaskSlow = TstAddTask(&Scheduler, "Slow", 1000, 0, 350);
+    iTaskFast = TstAddTask(&Scheduler, "Fast", 100,  0, 1);
+    TstRunFor(&Scheduler, 10000);
+    TST_CHECK(Scheduler.GetTaskInfo(iTaskFast)->m_ui32MaxLateness <= 350);
+    TST_CHECK(Scheduler.GetTaskInfo(iTaskFast)->m_ui32RunCount < 100);
+    TST_CHECK(aTstTask_l[iTaskFast].m_ui32MaxPeriodDev <= 350);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  32Bit Tick Wrap-Around (millis() wraps after 49.7 days)
+//---------------------------------------------------------------------------
+
+static  void  TstTickWrapAround (void)
+{
+
+TaskScheduler  Scheduler;
+int            iTask;
+
+
+    printf("Test: Tick Wrap-Around\n");
+
+    TstSetupScheduler(&Scheduler, 0xFFFFFFFF - 5000);
+    iTask = TstAddTask(&Scheduler, "T250", 250, 0, 2);
+
+    TstRunFor(&Scheduler, 20000);
+
+    TST_CHECK(ui32FakeTick_l < 20000);
+    TST_CHECK_EQUAL(Scheduler.GetTaskInfo(iTask)->m_ui32RunCount, 80);
+    TST_CHECK_EQUAL(Scheduler.GetTaskInfo(iTask)->m_ui32MaxLateness, 0);
+    TST_CHECK_EQUAL(aTstTask_l[iTask].m_ui32MaxPeriodDev, 0);
+    TST_CHECK_EQUAL(Scheduler.GetIdleRatio(), 992);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  One-Shot Task (Period 0) with TriggerTask() and RescheduleTask()
+//---------------------------------------------------------------------------
+
+static  void  TstTriggerReschedule (void)
+{
+
+TaskScheduler  Scheduler;
+int            iTaskEvent;
+int            iTaskTick;
+
+
+    printf("Test: Trigger and Reschedule\n");
+
+    TstSetupScheduler(&Scheduler, 0);
+    iTaskTick  = TstAddTask(&Scheduler, "Tick",  100, 0, 0);
+    iTaskEvent = TstAddTask(&Scheduler, "Event", 0,   0, 0);
+
+    TstRunFor(&Scheduler, 1000);
+    TST_CHECK_EQUAL(Scheduler.GetTaskInfo(iTaskEvent)->m_ui32RunCount, 0);
+
+    // an event between two deadlines is handled on the next Schedule() call
+    TST_CHECK_EQUAL(Scheduler.TriggerTask(iTaskEvent), 0);
+    TST_CHECK_EQUAL(Scheduler.GetTimeToNextDeadline(), 0);
+    Scheduler.Schedule();
+    TST_CHECK_EQUAL(Scheduler.GetTaskInfo(iTaskEvent)->m_ui32RunCount, 1);
+    TstRunFor(&Scheduler, 1000);
+    TST_CHECK_EQUAL(Scheduler.GetTaskInfo(iTaskEvent)->m_ui32RunCount, 1);
+
+    // rescheduled one-shot runs once after the given delay
+    TST_CHECK_EQUAL(Scheduler.RescheduleTask(iTaskEvent, 250), 0);
+    TstRunFor(&Scheduler, 249);
+    TST_CHECK_EQUAL(Scheduler.GetTaskInfo(iTaskEvent)->m_ui32RunCount, 1);
+    TstRunFor(&Scheduler, 1000);
+    TST_CHECK_EQUAL(Scheduler.GetTaskInfo(iTaskEvent)->m_ui32RunCount, 2);
+
+    TST_CHECK_EQUAL(Scheduler.TriggerTask(5), -1);
+    TST_CHECK_EQUAL(Scheduler.RescheduleTask(-1, 0), -1);
+    TST_CHECK(Scheduler.GetTaskInfo(iTaskTick) != NULL);
+    TST_CHECK(Scheduler.GetTaskInfo(iTaskTick + 2) == NULL);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  A Task that re-triggers itself can not starve the others
+//---------------------------------------------------------------------------
+
+static  void  TstOneRunPerSchedule (void)
+{
+
+TaskScheduler  Scheduler;
+int            iRunCount;
+
+
+    printf("Test: One Run per Task and Schedule() Call\n");
+
+    TstSetupScheduler(&Scheduler, 0);
+    TstAddTask(&Scheduler, "A", 10, 0, 25);
+    TstAddTask(&Scheduler, "B", 10, 0, 25);
+    TstAddTask(&Scheduler, "C", 10, 0, 25);
+
+    iRunCount = Scheduler.Schedule();
+    TST_CHECK_EQUAL(iRunCount, 3);
+    TST_CHECK_EQUAL(aTstTask_l[0].m_ui32RunCount, 1);
+    TST_CHECK_EQUAL(aTstTask_l[1].m_ui32RunCount, 1);
+    TST_CHECK_EQUAL(aTstTask_l[2].m_ui32RunCount, 1);
+
+    // all overdue again -> the most overdue runs first
+    iRunCount = Scheduler.Schedule();
+    TST_CHECK_EQUAL(iRunCount, 3);
+    TST_CHECK_EQUAL(Scheduler.GetTaskInfo(0)->m_ui32MaxLateness, 65);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Jitter Measurement with the Task Set of the Firmware
+//---------------------------------------------------------------------------
+//  Periods and first Delays as in SchedulerSetupTasks() of the firmware,
+//  Run Times are estimates for the sensor and display accesses. The Sleep
+//  Function returns up to 2 ms late (wakeup latency of Light Sleep).
+
+static  void  TstRunJitterMeasurement (void)
+{
+
+static const struct
+{
+    const char*  m_pszName;
+    uint32_t     m_ui32Period;
+    uint32_t     m_ui32FirstDelay;
+    uint32_t     m_ui32RunTime;
+
+} aTaskSet[] =
+{
+    { "MainInfo",   1000,   0,    1 },
+    { "DHT22",      5000,   5000, 25 },
+    { "HC-SR501",   100,    200,  0 },
+    { "Light",      1000,   300,  3 },
+    { "CarBatt",    1000,   400,  3 },
+    { "LoraTx",     1000,   800,  2 },
+    { "OLED",       1000,   900,  30 },
+    { "StatusLEDs", 100,    0,    0 }
+};
+
+TaskScheduler  Scheduler;
+uint32_t       ui32ExpectedIdle;
+unsigned int   uiIdx;
+int            iTask;
+
+
+    TstSetupScheduler(&Scheduler, 0);
+    ui32MaxWakeupDelay_l = 2;
+
+    ui32ExpectedIdle = 1000;
+    for (uiIdx=0; uiIdx<sizeof(aTaskSet)/sizeof(aTaskSet[0]); uiIdx++)
+    {
+        TstAddTask(&Scheduler, aTaskSet[uiIdx].m_pszName, aTaskSet[uiIdx].m_ui32Period,
+                   aTaskSet[uiIdx].m_ui32FirstDelay, aTaskSet[uiIdx].m_ui32RunTime);
+        ui32ExpectedIdle -= (aTaskSet[uiIdx].m_ui32RunTime * 1000) / aTaskSet[uiIdx].m_ui32Period;
+    }
+
+    TstRunFor(&Scheduler, TST_BENCH_DURATION);
+
+    printf("Scheduler Jitter Measurement (%lu [s] simulated, wakeup delay 0..%lu [ms]):\n",
+           (unsigned long)(TST_BENCH_DURATION / 1000), (unsigned long)ui32MaxWakeupDelay_l);
+    printf("%s", Scheduler.LogStatistics());
+    printf("  Task          Period Jitter (Start Interval - Period)\n");
+    printf("                  avg [ms]     max [ms]\n");
+    for (iTask=0; iTask<(int)(sizeof(aTaskSet)/sizeof(aTaskSet[0])); iTask++)
+    {
+        printf("  %-12s %9.2f %12lu\n", aTaskSet[iTask].m_pszName,
+               (aTstTask_l[iTask].m_ui32RunCount > 1) ? ((double)aTstTask_l[iTask].m_ui64SumPeriodDev / (aTstTask_l[iTask].m_ui32RunCount - 1)) : 0.0,
+               (unsigned long)aTstTask_l[iTask].m_ui32MaxPeriodDev);
+    }
+    printf("  Idle Ratio: measured %lu.%lu [%%], sum of task run times gives %lu.%lu [%%]\n",
+           (unsigned long)(Scheduler.GetIdleRatio() / 10), (unsigned long)(Scheduler.GetIdleRatio() % 10),
+           (unsigned long)(ui32ExpectedIdle / 10), (unsigned long)(ui32ExpectedIdle % 10));
+    printf("  Schedule() calls: %lu (%.1f per second)\n", (unsigned long)ui32ScheduleRuns_l,
+           (double)ui32ScheduleRuns_l * 1000.0 / TST_BENCH_DURATION);
+    printf("\n");
+
+    ui32MaxWakeupDelay_l = 0;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Setup Scheduler with simulated Time Base
+//---------------------------------------------------------------------------
+
+static  void  TstSetupScheduler (
+    TaskScheduler* pScheduler_p,                        // [IN]     Scheduler under Test
+    uint32_t ui32StartTick_p)                           // [IN]     Initial Tick [ms]
+{
+
+    ui32FakeTick_l = ui32StartTick_p;
+    ui32ScheduleRuns_l = 0;
+    memset(aTstTask_l, 0, sizeof(aTstTask_l));
+
+    pScheduler_p->Setup(TstGetTick, TstSleep, TST_MAX_SLEEP_TIME);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Register Task with simulated Run Time
+//---------------------------------------------------------------------------
+
+static  int  TstAddTask (
+    TaskScheduler* pScheduler_p,                        // [IN]     Scheduler under Test
+    const char* pszName_p,                              // [IN]     Task Name
+    uint32_t ui32Period_p,                              // [IN]     Period [ms]
+    uint32_t ui32FirstDelay_p,                          // [IN]     Delay of first Deadline [ms]
+    uint32_t ui32RunTime_p)                             // [IN]     simulated Run Time [ms]
+{
+
+int  iTask;
+
+
+    // task IDs are assigned in ascending order, the ID selects the function
+    iTask = 0;
+    while (pScheduler_p->GetTaskInfo(iTask) != NULL)
+    {
+        iTask++;
+    }
+    if (iTask >= TaskScheduler::MAX_TASKS)
+    {
+        return (-1);
+    }
+
+    aTstTask_l[iTask].m_ui32RunTime = ui32RunTime_p;
+    aTstTask_l[iTask].m_ui32Period  = ui32Period_p;
+
+    return (pScheduler_p->AddTask(pszName_p, TST_TASK_FUNC_TAB[iTask], ui32Period_p, ui32FirstDelay_p));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Run Scheduler for a simulated Duration
+//---------------------------------------------------------------------------
+
+static  void  TstRunFor (
+    TaskScheduler* pScheduler_p,                        // [IN]     Scheduler under Test
+    uint32_t ui32Duration_p)                            // [IN]     simulated Duration [ms]
+{
+
+uint32_t  ui32StartTick;
+
+
+    ui32StartTick = ui32FakeTick_l;
+    while ((ui32FakeTick_l - ui32StartTick) < ui32Duration_p)
+    {
+        pScheduler_p->Schedule();
+        ui32ScheduleRuns_l++;
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Simulated Time Base and Sleep Function
+//---------------------------------------------------------------------------
+
+static  uint32_t  TstGetTick (void)
+{
+
+    return (ui32FakeTick_l);
+
+}
+
+
+static  void  TstSleep (
+    uint32_t ui32SleepTime_p)                           // [IN]     Sleep Time [ms]
+{
+
+    ui32FakeTick_l += ui32SleepTime_p;
+
+    if (ui32MaxWakeupDelay_l > 0)
+    {
+        // xorshift32, deterministic wakeup latency
+        ui32RandState_l ^= ui32RandState_l << 13;
+        ui32RandState_l ^= ui32RandState_l >> 17;
+        ui32RandState_l ^= ui32RandState_l << 5;
+        ui32FakeTick_l += ui32RandState_l % (ui32MaxWakeupDelay_l + 1);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Common Task Function: record Start Interval, consume Run Time
+//---------------------------------------------------------------------------
+
+static  void  TstTaskFunc (
+    int iTask_p)                                        // [IN]     Task ID
+{
+
+tTstTask*  pTstTask;
+uint32_t   ui32Interval;
+uint32_t   ui32PeriodDev;
+
+
+    pTstTask = &aTstTask_l[iTask_p];
+
+    if ((pTstTask->m_ui32RunCount > 0) && (pTstTask->m_ui32Period > 0))
+    {
+        ui32Interval  = ui32FakeTick_l - pTstTask->m_ui32LastStart;
+        ui32PeriodDev = (ui32Interval > pTstTask->m_ui32Period) ? (ui32Interval - pTstTask->m_ui32Period)
+                                                                 : (pTstTask->m_ui32Period - ui32Interval);
+        pTstTask->m_ui64SumPeriodDev += ui32PeriodDev;
+        if (ui32PeriodDev > pTstTask->m_ui32MaxPeriodDev)
+        {
+            pTstTask->m_ui32MaxPeriodDev = ui32PeriodDev;
+        }
+    }
+    pTstTask->m_ui32LastStart = ui32FakeTick_l;
+    pTstTask->m_ui32RunCount++;
+
+    ui32FakeTick_l += pTstTask->m_ui32RunTime;
+
+    return;
+
+}
+
+
+
+// EOF
@@ -0,0 +1,625 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Channel Simulator
+  Description:  Host Test for Time-on-Air Calculation and Duty Cycle Budget
+                of the Firmware Class <LoraTransmitter>
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+
+#include "Arduino.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "LoraPacket.h"
+#include "LoraTransmitter.h"
+#include "TestCheck.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+//  Radio and Duty Cycle Settings as configured in the Firmware (LoraAmbientMonitor.ino)
+const  int           TST_SPREADING_FACTOR   = 12;
+const  long          TST_SIGNAL_BANDWIDTH   = 125E3;
+const  int           TST_CODING_RATE        = 5;
+const  uint16_t      TST_DUTY_CYCLE_LIMIT   = 10;               // [1/10 %] -> 1%
+const  uint32_t      TST_DUTY_CYCLE_WINDOW  = (60 * 60 * 1000); // [ms] -> 1h
+const  uint32_t      TST_INHIBIT_TIME       = 1000;             // [ms]
+const  uint32_t      TST_CYCLE_TIME         = (10 * 60 * 1000); // [ms]
+const  uint32_t      TST_START_TICK         = 1000;             // SysTick of Setup [ms]
+const  uint8_t       TST_PACKET_LEN         = 40;               // SF12/125kHz: 1974.272 [ms]
+const  uint32_t      TST_PACKET_AIR_TIME    = 1974272;          // [us]
+const  unsigned int  TST_PACKETS_PER_WINDOW = 18;               // 36 [s] / 1.974 [s]
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+typedef struct
+{
+    int             m_iSpreadingFactor;
+    long            m_lSignalBandwidth;
+    int             m_iCodingRateDenominator;
+    bool            m_fCrcEnabled;
+    uint8_t         m_ui8PayloadLen;
+    bool            m_fLowDataRateOpt;          // expected LDRO of LoRa library
+    uint32_t        m_ui32TimeOnAir;            // [us] Semtech LoRa Calculator
+
+} tTstReference;
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+TST_DEFINE_COUNTERS()
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+//  Reference Values of the Semtech LoRa Calculator / SX1276 Datasheet
+//  (Preamble 8 Symbols, explicit Header), CRC on = LoRaWAN Uplink
+static  const  tTstReference  aTstReference_l[] =
+{
+    //  SF  BW       CR  CRC    PL   LDRO   ToA [us]
+    {    7, 125000,  5,  true,   23, false,    61696 },     // TTN Airtime Calculator: 10 Byte App Payload
+    {    9, 125000,  5,  true,   51, false,   328704 },
+    {   12, 125000,  5,  true,   64, true,   2793472 },     // TTN Airtime Calculator: 51 Byte App Payload
+    {   12, 125000,  5,  false,  40, true,   1974272 },     // Data Packet of the Firmware
+    {   12, 125000,  8,  false, 255, true,  14032896 },
+    {   11, 125000,  5,  false,  40, false,   905216 },     // 16.384 [ms] Symbol, LoRa library leaves LDRO off
+    {   12, 250000,  5,  false,  40, false,   905216 },     // 16.384 [ms] Symbol, LoRa library leaves LDRO off
+    {   10, 125000,  8,  false,  20, false,   428032 },
+    {    8, 500000,  6,  false, 255, false,   206976 },
+    {   12, 500000,  7,  false,  40, false,   567296 },
+    {    7, 125000,  5,  false,   0, false,    20736 },     // Preamble + Header only
+};
+
+//  all Bandwidths supported by the SX1276 and <LoRaClass::setSignalBandwidth()>
+static  const  long  aTstBandwidth_l[] =
+{
+    7800, 10400, 15600, 20800, 31250, 41700, 62500, 125000, 250000, 500000
+};
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  void  TstReferenceValues (void);
+static  void  TstLowDataRateOptimize (void);
+static  void  TstAllSettings (void);
+static  void  TstInvalidSettings (void);
+static  void  TstBudgetDeferAndCoalesce (void);
+static  void  TstBudgetSlidingWindow (void);
+static  void  TstRunBenchmark (void);
+
+static  double  TstCalcTimeOnAir (int iSF_p, long lBW_p, int iCR_p, bool fCrc_p, bool fImplicitHeader_p, bool fLdro_p, uint8_t ui8PayloadLen_p);
+static  bool    TstGetLibraryLdro (int iSF_p, long lBW_p);
+static  void    TstSetupTransmitter (LoraTransmitter* pLoraTransmitter_p);
+static  void    TstTransmitPacket (LoraTransmitter* pLoraTransmitter_p);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Main function of this application
+//---------------------------------------------------------------------------
+//  Without arguments the functional checks are run ('make test'), option
+//  '-b' prints Time-on-Air and Packets per Duty Cycle Window for all
+//  Spreading Factors and Bandwidths ('make bench').
+
+int  main (int iArgCnt_p, char* apszArg_p[])
+{
+
+    if ((iArgCnt_p > 1) && !strcmp(apszArg_p[1], "-b"))
+    {
+        TstRunBenchmark();
+        return (0);
+    }
+
+    TstReferenceValues();
+    TstLowDataRateOptimize();
+    TstAllSettings();
+    TstInvalidSettings();
+    TstBudgetDeferAndCoalesce();
+    TstBudgetSlidingWindow();
+
+    return (TST_RESULT("TimeOnAirTest"));
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Time-on-Air matches the Semtech Reference Values
+//---------------------------------------------------------------------------
+
+static  void  TstReferenceValues (void)
+{
+
+const tTstReference*  pRef;
+unsigned int          uiIdx;
+
+
+    printf("Test: Semtech Reference Values\n");
+
+    for (uiIdx=0; uiIdx<sizeof(aTstReference_l)/sizeof(aTstReference_l[0]); uiIdx++)
+    {
+        pRef = &aTstReference_l[uiIdx];
+        TST_CHECK_EQUAL(TstGetLibraryLdro(pRef->m_iSpreadingFactor, pRef->m_lSignalBandwidth), pRef->m_fLowDataRateOpt);
+        TST_CHECK_EQUAL(LoraTransmitter::CalcTimeOnAir(pRef->m_iSpreadingFactor, pRef->m_lSignalBandwidth, pRef->m_iCodingRateDenominator,
+                                                       LoraTransmitter::LORA_PREAMBLE_LENGTH, pRef->m_fCrcEnabled, false,
+                                                       pRef->m_ui8PayloadLen),
+                        pRef->m_ui32TimeOnAir);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  LowDataRateOptimize changes the Time-on-Air as used by the Radio
+//---------------------------------------------------------------------------
+//  The LoRa library enables LDRO only if the integer Symbol Time exceeds
+//  16ms, so SF11/125kHz (16.384ms) is transmitted without LDRO although
+//  Semtech recommends it. The Budget has to follow the real Transmission.
+
+static  void  TstLowDataRateOptimize (void)
+{
+
+uint32_t  ui32TimeOnAir;
+
+
+    printf("Test: Low Data Rate Optimize\n");
+
+    // LDRO on: SF12/125kHz, 32.768ms Symbol
+    ui32TimeOnAir = LoraTransmitter::CalcTimeOnAir(12, 125E3, 5, 8, false, false, 40);
+    TST_CHECK_EQUAL(ui32TimeOnAir, lround(TstCalcTimeOnAir(12, 125E3, 5, false, false, true, 40)));
+    TST_CHECK(ui32TimeOnAir != lround(TstCalcTimeOnAir(12, 125E3, 5, false, false, false, 40)));
+
+    // LDRO off: SF11/125kHz and SF12/250kHz, 16.384ms Symbol
+    ui32TimeOnAir = LoraTransmitter::CalcTimeOnAir(11, 125E3, 5, 8, false, false, 40);
+    TST_CHECK_EQUAL(ui32TimeOnAir, lround(TstCalcTimeOnAir(11, 125E3, 5, false, false, false, 40)));
+    TST_CHECK_EQUAL(lround(TstCalcTimeOnAir(11, 125E3, 5, false, false, true, 40)), 1069056);
+    ui32TimeOnAir = LoraTransmitter::CalcTimeOnAir(12, 250E3, 5, 8, false, false, 40);
+    TST_CHECK_EQUAL(ui32TimeOnAir, lround(TstCalcTimeOnAir(12, 250E3, 5, false, false, false, 40)));
+    TST_CHECK_EQUAL(lround(TstCalcTimeOnAir(12, 250E3, 5, false, false, true, 40)), 987136);
+
+    // LDRO on: SF12/62.5kHz, 65.536ms Symbol
+    ui32TimeOnAir = LoraTransmitter::CalcTimeOnAir(12, 62.5E3, 5, 8, false, false, 40);
+    TST_CHECK_EQUAL(ui32TimeOnAir, lround(TstCalcTimeOnAir(12, 62.5E3, 5, false, false, true, 40)));
+    TST_CHECK_EQUAL(ui32TimeOnAir, 2 * 1974272);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  All SF, BW, CR, CRC, Header Modes and Payload Lengths match the Formula
+//---------------------------------------------------------------------------
+
+static  void  TstAllSettings (void)
+{
+
+unsigned int  uiBW;
+unsigned int  uiLen;
+unsigned int  uiMode;
+unsigned int  uiChecked;
+unsigned int  uiMismatch;
+unsigned int  uiLdroOn;
+int           iSF;
+int           iCR;
+bool          fCrc;
+bool          fImplicitHeader;
+bool          fLdro;
+double        dblExpected;
+uint32_t      ui32TimeOnAir;
+
+
+    printf("Test: All Radio Settings\n");
+
+    uiChecked  = 0;
+    uiMismatch = 0;
+    uiLdroOn   = 0;
+    for (iSF=7; iSF<=12; iSF++)
+    {
+        for (uiBW=0; uiBW<sizeof(aTstBandwidth_l)/sizeof(aTstBandwidth_l[0]); uiBW++)
+        {
+            fLdro = TstGetLibraryLdro(iSF, aTstBandwidth_l[uiBW]);
+            uiLdroOn += (fLdro ? 1 : 0);
+
+            for (iCR=5; iCR<=8; iCR++)
+            {
+                for (uiMode=0; uiMode<4; uiMode++)
+                {
+                    fCrc            = ((uiMode & 0x01) != 0);
+                    fImplicitHeader = ((uiMode & 0x02) != 0);
+                    for (uiLen=0; uiLen<=255; uiLen++)
+                    {
+                        dblExpected = TstCalcTimeOnAir(iSF, aTstBandwidth_l[uiBW], iCR, fCrc, fImplicitHeader, fLdro, (uint8_t)uiLen);
+                        ui32TimeOnAir = LoraTransmitter::CalcTimeOnAir(iSF, aTstBandwidth_l[uiBW], iCR, LoraTransmitter::LORA_PREAMBLE_LENGTH,
+                                                                       fCrc, fImplicitHeader, (uint8_t)uiLen);
+
+                        // CalcTimeOnAir truncates to [us], the 125/250/500kHz Bandwidths result in whole [us]
+                        if (fabs((double)ui32TimeOnAir - floor(dblExpected + 1e-6)) > 1.0)
+                        {
+                            if (uiMismatch < 5)
+                            {
+                                printf("  SF%d BW%ld CR4/%d CRC=%d IH=%d Len=%u: %u, expected %.1f [us]\n",
+                                       iSF, aTstBandwidth_l[uiBW], iCR, (int)fCrc, (int)fImplicitHeader, uiLen,
+                                       (unsigned int)ui32TimeOnAir, dblExpected);
+                            }
+                            uiMismatch++;
+                        }
+                        uiChecked++;
+                    }
+                }
+            }
+        }
+    }
+
+    TST_CHECK_EQUAL(uiMismatch, 0);
+    TST_CHECK_EQUAL(uiChecked, 6 * 10 * 4 * 4 * 256);
+    TST_CHECK(uiLdroOn > 0);
+    TST_CHECK(uiLdroOn < (6 * 10));
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Settings not supported by the Radio result in 0
+//---------------------------------------------------------------------------
+
+static  void  TstInvalidSettings (void)
+{
+
+    printf("Test: Invalid Radio Settings\n");
+
+    TST_CHECK_EQUAL(LoraTransmitter::CalcTimeOnAir(5,  125E3, 5, 8, false, false, 40), 0);
+    TST_CHECK_EQUAL(LoraTransmitter::CalcTimeOnAir(13, 125E3, 5, 8, false, false, 40), 0);
+    TST_CHECK_EQUAL(LoraTransmitter::CalcTimeOnAir(12, 4000,  5, 8, false, false, 40), 0);
+    TST_CHECK_EQUAL(LoraTransmitter::CalcTimeOnAir(12, 0,     5, 8, false, false, 40), 0);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Exhausted Budget defers Transmissions and coalesces pending Events
+//---------------------------------------------------------------------------
+//  All Packets of the Burst fall into the first Bucket, so the Budget is
+//  only released when this Bucket leaves the Window (Setup + 1h).
+
+static  void  TstBudgetDeferAndCoalesce (void)
+{
+
+LoraTransmitter                  Transmitter;
+LoraTransmitter::tDutyCycleInfo  DutyCycleInfo;
+bool                             fAsyncTransmitEvent;
+bool                             fNoEvent;
+uint32_t                         ui32Tick;
+unsigned int                     uiPacket;
+unsigned int                     uiEvent;
+unsigned int                     uiTransmitted;
+
+
+    printf("Test: Budget Defer and Coalesce\n");
+
+    ArduinoSimSetTick(TST_START_TICK);
+    TstSetupTransmitter(&Transmitter);
+    TST_CHECK_EQUAL(Transmitter.GetTimeOnAir(TST_PACKET_LEN), TST_PACKET_AIR_TIME);
+
+    // Burst of asynchronous Events (e.g. Motion), each one transmitted
+    // as long as the Budget allows it
+    ui32Tick = TST_START_TICK;
+    uiTransmitted = 0;
+    for (uiPacket=0; uiPacket<TST_PACKETS_PER_WINDOW; uiPacket++)
+    {
+        ArduinoSimSetTick(ui32Tick);
+        fAsyncTransmitEvent = true;
+        if (Transmitter.GetReasonToTransmitPacket(&fAsyncTransmitEvent, TST_PACKET_LEN) == 1)
+        {
+            TstTransmitPacket(&Transmitter);
+            uiTransmitted++;
+        }
+        ui32Tick += 2 * TST_INHIBIT_TIME;
+    }
+    TST_CHECK_EQUAL(uiTransmitted, TST_PACKETS_PER_WINDOW);
+
+    // next Event is deferred, the Event is kept pending
+    ArduinoSimSetTick(ui32Tick);
+    fAsyncTransmitEvent = true;
+    TST_CHECK_EQUAL(Transmitter.GetReasonToTransmitPacket(&fAsyncTransmitEvent, TST_PACKET_LEN), -2);
+    TST_CHECK( fAsyncTransmitEvent );
+    TST_CHECK_EQUAL(Transmitter.GetDutyCycleWaitTime(TST_PACKET_LEN), TST_START_TICK + TST_DUTY_CYCLE_WINDOW - ui32Tick);
+
+    // further Events while deferred are coalesced into the pending one
+    for (uiEvent=0; uiEvent<5; uiEvent++)
+    {
+        ui32Tick += 60 * 1000;
+        ArduinoSimSetTick(ui32Tick);
+        fAsyncTransmitEvent = true;
+        TST_CHECK_EQUAL(Transmitter.GetReasonToTransmitPacket(&fAsyncTransmitEvent, TST_PACKET_LEN), -2);
+    }
+
+    // expired Transmit Cycle is deferred as well
+    ui32Tick = TST_START_TICK + (TST_CYCLE_TIME * 2);
+    ArduinoSimSetTick(ui32Tick);
+    fNoEvent = false;
+    TST_CHECK_EQUAL(Transmitter.GetReasonToTransmitPacket(&fNoEvent, TST_PACKET_LEN), -2);
+
+    // 1ms before the first Bucket leaves the Window
+    ui32Tick = TST_START_TICK + TST_DUTY_CYCLE_WINDOW - 1;
+    ArduinoSimSetTick(ui32Tick);
+    TST_CHECK_EQUAL(Transmitter.GetDutyCycleWaitTime(TST_PACKET_LEN), 1);
+    TST_CHECK_EQUAL(Transmitter.GetReasonToTransmitPacket(&fAsyncTransmitEvent, TST_PACKET_LEN), -2);
+
+    // Budget released: all pending Events result in one Transmission
+    ui32Tick++;
+    ArduinoSimSetTick(ui32Tick);
+    TST_CHECK_EQUAL(Transmitter.GetDutyCycleWaitTime(TST_PACKET_LEN), 0);
+    TST_CHECK_EQUAL(Transmitter.GetReasonToTransmitPacket(&fAsyncTransmitEvent, TST_PACKET_LEN), 1);
+    TST_CHECK( !fAsyncTransmitEvent );
+    TstTransmitPacket(&Transmitter);
+
+    ArduinoSimSetTick(ui32Tick + (2 * TST_INHIBIT_TIME));
+    TST_CHECK_EQUAL(Transmitter.GetReasonToTransmitPacket(&fAsyncTransmitEvent, TST_PACKET_LEN), 0);
+
+    Transmitter.GetDutyCycleInfo(&DutyCycleInfo);
+    TST_CHECK_EQUAL(DutyCycleInfo.m_ui32MaxAirTime, TST_DUTY_CYCLE_WINDOW * TST_DUTY_CYCLE_LIMIT);
+    TST_CHECK_EQUAL(DutyCycleInfo.m_ui32UsedAirTime, TST_PACKET_AIR_TIME);
+    TST_CHECK_EQUAL(DutyCycleInfo.m_ui32TransmitCount, TST_PACKETS_PER_WINDOW + 1);
+    TST_CHECK_EQUAL(DutyCycleInfo.m_ui32DeferredCount, 1 + 5 + 1 + 1);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Budget is released Bucket by Bucket as the Window slides
+//---------------------------------------------------------------------------
+
+static  void  TstBudgetSlidingWindow (void)
+{
+
+LoraTransmitter                  Transmitter;
+LoraTransmitter::tDutyCycleInfo  DutyCycleInfo;
+bool                             fAsyncTransmitEvent;
+uint32_t                         ui32Tick;
+unsigned int                     uiPacket;
+unsigned int                     uiTransmitted;
+
+
+    printf("Test: Budget Sliding Window\n");
+
+    ArduinoSimSetTick(TST_START_TICK);
+    TstSetupTransmitter(&Transmitter);
+
+    // one Packet per Bucket (1 minute)
+    uiTransmitted = 0;
+    for (uiPacket=0; uiPacket<TST_PACKETS_PER_WINDOW; uiPacket++)
+    {
+        ArduinoSimSetTick(TST_START_TICK + (uiPacket * 60 * 1000) + 500);
+        fAsyncTransmitEvent = true;
+        if (Transmitter.GetReasonToTransmitPacket(&fAsyncTransmitEvent, TST_PACKET_LEN) == 1)
+        {
+            TstTransmitPacket(&Transmitter);
+            uiTransmitted++;
+        }
+    }
+    TST_CHECK_EQUAL(uiTransmitted, TST_PACKETS_PER_WINDOW);
+
+    // Budget exhausted until the Bucket of the first Packet leaves the Window
+    ui32Tick = TST_START_TICK + (TST_PACKETS_PER_WINDOW * 60 * 1000) + 500;
+    ArduinoSimSetTick(ui32Tick);
+    fAsyncTransmitEvent = true;
+    TST_CHECK_EQUAL(Transmitter.GetReasonToTransmitPacket(&fAsyncTransmitEvent, TST_PACKET_LEN), -2);
+    TST_CHECK_EQUAL(Transmitter.GetDutyCycleWaitTime(TST_PACKET_LEN), TST_START_TICK + TST_DUTY_CYCLE_WINDOW - ui32Tick);
+
+    ui32Tick = TST_START_TICK + TST_DUTY_CYCLE_WINDOW;
+    ArduinoSimSetTick(ui32Tick);
+    TST_CHECK_EQUAL(Transmitter.GetReasonToTransmitPacket(&fAsyncTransmitEvent, TST_PACKET_LEN), 1);
+    TstTransmitPacket(&Transmitter);
+
+    // only one Bucket released -> next Packet waits for the second one
+    ui32Tick += 2 * TST_INHIBIT_TIME;
+    ArduinoSimSetTick(ui32Tick);
+    fAsyncTransmitEvent = true;
+    TST_CHECK_EQUAL(Transmitter.GetReasonToTransmitPacket(&fAsyncTransmitEvent, TST_PACKET_LEN), -2);
+    TST_CHECK_EQUAL(Transmitter.GetDutyCycleWaitTime(TST_PACKET_LEN), TST_START_TICK + TST_DUTY_CYCLE_WINDOW + (60 * 1000) - ui32Tick);
+
+    Transmitter.GetDutyCycleInfo(&DutyCycleInfo);
+    TST_CHECK_EQUAL(DutyCycleInfo.m_ui32UsedAirTime, TST_PACKETS_PER_WINDOW * TST_PACKET_AIR_TIME);
+    TST_CHECK_EQUAL(DutyCycleInfo.m_ui32TransmitCount, TST_PACKETS_PER_WINDOW + 1);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Reference Formula (Semtech AN1200.13), LDRO as explicit Parameter
+//---------------------------------------------------------------------------
+
+static  double  TstCalcTimeOnAir (int iSF_p, long lBW_p, int iCR_p, bool fCrc_p, bool fImplicitHeader_p, bool fLdro_p, uint8_t ui8PayloadLen_p)
+{
+
+double  dblSymbolTime;
+double  dblPayloadSymbols;
+
+
+    dblSymbolTime = ldexp(1.0, iSF_p) / (double)lBW_p * 1e6;        // [us]
+    dblPayloadSymbols = ceil((8.0 * ui8PayloadLen_p - 4.0 * iSF_p + 28.0 + (fCrc_p ? 16.0 : 0.0) - (fImplicitHeader_p ? 20.0 : 0.0)) /
+                             (4.0 * (iSF_p - (fLdro_p ? 2 : 0))));
+    dblPayloadSymbols = 8.0 + fmax(dblPayloadSymbols * (double)iCR_p, 0.0);
+
+    return ((LoraTransmitter::LORA_PREAMBLE_LENGTH + 4.25 + dblPayloadSymbols) * dblSymbolTime);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  LDRO as set by the LoRa library (LoRaClass::setLdoFlag())
+//---------------------------------------------------------------------------
+
+static  bool  TstGetLibraryLdro (int iSF_p, long lBW_p)
+{
+
+long  lSymbolDuration;
+
+
+    lSymbolDuration = 1000 / (lBW_p / (1L << iSF_p));               // [ms], integer as in library
+
+    return (lSymbolDuration > 16);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Setup Transmitter as by setup() of the Firmware
+//---------------------------------------------------------------------------
+
+static  void  TstSetupTransmitter (LoraTransmitter* pLoraTransmitter_p)
+{
+
+LoraTransmitter::tLoraTransmitterSettings  Settings;
+
+
+    memset(&Settings, 0x00, sizeof(Settings));
+    Settings.m_iLoraSpreadingFactor       = TST_SPREADING_FACTOR;
+    Settings.m_lLoraSignalBandwidth       = TST_SIGNAL_BANDWIDTH;
+    Settings.m_iLoraCodingRateDenominator = TST_CODING_RATE;
+    Settings.m_ui16DutyCycleLimit         = TST_DUTY_CYCLE_LIMIT;
+    Settings.m_ui32DutyCycleWindow        = TST_DUTY_CYCLE_WINDOW;
+
+    pLoraTransmitter_p->Setup(&Settings, 4711);
+    pLoraTransmitter_p->CalcNextTransmitCycleTime(TST_INHIBIT_TIME, TST_CYCLE_TIME);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Transmit a Packet of TST_PACKET_LEN
+//---------------------------------------------------------------------------
+
+static  void  TstTransmitPacket (LoraTransmitter* pLoraTransmitter_p)
+{
+
+static const uint8_t  abPayload[TST_PACKET_LEN] = { 0 };
+
+
+    TST_CHECK_EQUAL(pLoraTransmitter_p->TransmitPacket(abPayload, sizeof(abPayload)), 0);
+    pLoraTransmitter_p->CalcNextTransmitCycleTime(TST_INHIBIT_TIME, TST_CYCLE_TIME);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Benchmark: Time-on-Air and Packets per Duty Cycle Window
+//---------------------------------------------------------------------------
+
+static  void  TstRunBenchmark (void)
+{
+
+static const long  alBandwidth[] = { 125000, 250000, 500000 };
+
+unsigned int  uiBW;
+int           iSF;
+uint32_t      ui32TimeOnAir;
+uint32_t      ui32MaxAirTime;
+
+
+    ui32MaxAirTime = TST_DUTY_CYCLE_WINDOW * TST_DUTY_CYCLE_LIMIT;
+
+    printf("Time-on-Air of Data Packet (%u Byte, CR4/%d, Preamble %d, CRC %s), Duty Cycle %u.%u%% per %u [min]\n",
+           (unsigned int)sizeof(tLoraDataPacket), TST_CODING_RATE, LoraTransmitter::LORA_PREAMBLE_LENGTH,
+           (LoraTransmitter::LORA_CRC_ENABLED ? "on" : "off"), (unsigned int)(TST_DUTY_CYCLE_LIMIT / 10),
+           (unsigned int)(TST_DUTY_CYCLE_LIMIT % 10), (unsigned int)(TST_DUTY_CYCLE_WINDOW / 60000));
+    printf("  SF    BW     LDRO   TimeOnAir   Packets\n");
+    printf("       [kHz]            [ms]     per Window\n");
+
+    for (iSF=7; iSF<=12; iSF++)
+    {
+        for (uiBW=0; uiBW<sizeof(alBandwidth)/sizeof(alBandwidth[0]); uiBW++)
+        {
+            ui32TimeOnAir = LoraTransmitter::CalcTimeOnAir(iSF, alBandwidth[uiBW], TST_CODING_RATE, LoraTransmitter::LORA_PREAMBLE_LENGTH,
+                                                           LoraTransmitter::LORA_CRC_ENABLED, false, sizeof(tLoraDataPacket));
+            printf("  %2d   %4ld    %-4s  %9.3f  %9u\n",
+                   iSF, alBandwidth[uiBW] / 1000, (TstGetLibraryLdro(iSF, alBandwidth[uiBW]) ? "on" : "off"),
+                   (double)ui32TimeOnAir / 1000.0, (unsigned int)(ui32MaxAirTime / ui32TimeOnAir));
+        }
+    }
+
+    return;
+
+}
+
+
+
+// EOF
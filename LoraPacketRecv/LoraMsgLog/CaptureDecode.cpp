@@ -0,0 +1,1240 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa MessageLog Tool
+  Description:  Implementation of Re-Decoding of Raw Frame Captures
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#include <RH_RF95.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+#include "LoraPacket.h"
+#include "LoraPacketSchema.h"
+#include "LoraPayloadEncoder.h"
+#include "LoraPayloadDecoder.h"
+#include "PacketProcessing.h"
+#include "MessageQualification.h"
+#include "RxQueue.h"
+#include "RadioDedup.h"
+#include "PcapWriter.h"
+#include "CaptureDecode.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+static  const  uint32_t     PCAP_MAGIC_NUMBER       = 0xA1B2C3D4;
+static  const  uint         PCAP_FILE_HDR_SIZE      = 24;
+static  const  uint         PCAP_REC_HDR_SIZE       = 16;
+
+static  const  uint8_t      CPD_NO_DEVID            = 0xFF;             // frame without (DevID, SequNum)
+
+static  const  uint32_t     CPD_SYNTH_START_TIME    = 1767225600;       // 2026/01/01 00:00:00 UTC
+static  const  uint32_t     CPD_SYNTH_FREQUENCY     = 868100000;        // [Hz]
+static  const  uint         CPD_SYNTH_BANDWIDTH     = 125;              // [kHz]
+static  const  uint         CPD_SYNTH_SPREAD_FACTOR = 7;
+static  const  uint         CPD_SYNTH_MAX_RADIOS    = 3;
+static  const  uint         CPD_SYNTH_BUFFER_SIZE   = 64 * 1024;
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+typedef struct
+{
+    uint64_t            m_ui64TimeUs;               // capture time (pcap Record Header)
+    uint64_t            m_ui64DataOffs;             // raw frame in <vecFrameData_l>
+    uint32_t            m_ui32Key;                  // SequNum (DataPacket) or CRC16 of Header (BootupPacket)
+    uint8_t             m_ui8DataLen;
+    uint8_t             m_ui8PacketType;
+    uint8_t             m_ui8DevID;                 // CPD_NO_DEVID = frame can't be decoded
+    int8_t              m_i8Rssi;
+
+} tCpdFrame;
+
+
+typedef struct
+{
+    uint8_t             m_ui8PacketType;
+    uint32_t            m_ui32Key;
+    uint64_t            m_ui64FirstRxUs;
+
+} tCpdRecentKey;
+
+
+typedef struct
+{
+    uint32_t            m_ui32Frame;                // frame that delivered the Json Message
+    tJsonMessage        m_JsonMessage;
+
+} tCpdResult;
+
+
+typedef struct
+{
+    std::vector<uint32_t>       m_vecFrames;                // frames of DevID in capture order
+    size_t                      m_nNextFrame;               // next frame to decode
+    size_t                      m_nMergePos;                // next result to merge
+    std::deque<tCpdRecentKey>   m_deqRecentKeys;            // packets forwarded within history time
+    uint32_t                    m_aui32SequNumHistList[SEQU_NUM_HIST_LIST];
+    std::vector<tCpdResult>     m_vecResults;               // Json Messages of current batch
+    uint64_t                    m_ui64Packets;
+    uint64_t                    m_ui64Copies;
+    uint64_t                    m_ui64BetterRssi;
+    uint64_t                    m_ui64LateCopies;
+    uint64_t                    m_ui64Unknown;
+    uint64_t                    m_ui64Ignored;
+
+} tCpdPartition;
+
+
+typedef struct
+{
+    LoraPayloadEncoder  m_LoraPayloadEnc;
+    uint8_t             m_ui8DevID;
+    uint32_t            m_ui32BootupTime;           // [sec] capture time of last Bootup
+    uint16_t            m_ui16MotionActiveCount;
+    int8_t              m_i8BaseRssi;
+
+} tCpdSynthDevice;
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+static  std::vector<tCpdFrame>      vecFrames_l;
+static  std::vector<uint8_t>        vecFrameData_l;
+static  std::vector<uint8_t>        vecFrameMerged_l;           // frame merged into earlier copy (only written by its partition)
+static  tCpdPartition               aPartition_l[LORA_DEVICES];
+static  std::vector<uint>           vecBatchPartitions_l;       // partitions with frames in current batch
+static  std::atomic<size_t>         nNextPartition_l;
+static  uint32_t                    ui32BatchEnd_l;
+static  uint64_t                    ui64HoldTimeUs_l;
+static  uint64_t                    ui64HistoryTimeUs_l;
+static  uint32_t                    ui32SynthRandom_l;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  int  CpdLoadFile (
+    const char* pszCapFile_p,
+    tCpdLoadStatistics* pStatistics_p);
+
+static  bool  CpdGetFrameKey (
+    const uint8_t* pabData_p,
+    uint uiDataLen_p,
+    uint8_t* pui8PacketType_p,
+    uint8_t* pui8DevID_p,
+    uint32_t* pui32Key_p);
+
+static  void  CpdWorkerThread (void);
+
+static  void  CpdDecodePartition (
+    tCpdPartition* pPartition_p);
+
+static  void  CpdDecodePacket (
+    tCpdPartition* pPartition_p,
+    uint32_t ui32Frame_p,
+    const tCpdFrame* pBestCopy_p);
+
+static  void  CpdSynthBootup (
+    tCpdSynthDevice* pDevice_p,
+    uint32_t ui32Time_p);
+
+static  void  CpdSynthTransmit (
+    const tCpdSynthDevice* pDevice_p,
+    uint64_t ui64TimeUs_p,
+    const void* pPayload_p,
+    uint uiPayloadLen_p,
+    std::vector<uint8_t>* pvecBuffer_p,
+    uint64_t* pui64Frames_p);
+
+static  void  CpdSynthPutFrame (
+    uint64_t ui64TimeUs_p,
+    int iRssi_p,
+    const void* pData_p,
+    uint uiDataLen_p,
+    std::vector<uint8_t>* pvecBuffer_p);
+
+static  uint32_t  CpdSynthRandom (
+    uint32_t ui32Range_p);
+
+static  bool  CpdFlushBuffer (
+    int iFd_p,
+    std::vector<uint8_t>* pvecBuffer_p);
+
+static  inline  uint16_t  CpdGetLe16 (const uint8_t* pabBuff_p);
+static  inline  uint32_t  CpdGetLe32 (const uint8_t* pabBuff_p);
+static  inline  uint16_t  CpdGetBe16 (const uint8_t* pabBuff_p);
+static  inline  void      CpdPutLe16 (std::vector<uint8_t>* pvecBuff_p, uint16_t ui16Value_p);
+static  inline  void      CpdPutLe32 (std::vector<uint8_t>* pvecBuff_p, uint32_t ui32Value_p);
+static  inline  void      CpdPutBe16 (std::vector<uint8_t>* pvecBuff_p, uint16_t ui16Value_p);
+static  inline  void      CpdPutBe32 (std::vector<uint8_t>* pvecBuff_p, uint32_t ui32Value_p);
+static  double  CpdGetTime (void);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Load CaptureFiles
+//---------------------------------------------------------------------------
+//  All frames are kept in memory. Torn records at the end of a file (e.g.
+//  gateway stopped while writing) are skipped and counted as damaged.
+
+int  CpdLoadCaptures (
+    const char* const* apszCapFiles_p,                  // [IN]     CaptureFiles (pcap with LoRaTap Header)
+    uint uiCapFiles_p,                                  // [IN]     Number of CaptureFiles
+    tCpdLoadStatistics* pStatistics_p)                  // [OUT]    Ptr to Statistics
+{
+
+double    dStartTime;
+uint32_t  ui32Frame;
+uint      uiFile;
+uint      uiDevID;
+int       iRes;
+
+
+    if ((apszCapFiles_p == NULL) || (uiCapFiles_p == 0) || (pStatistics_p == NULL))
+    {
+        return (-1);
+    }
+
+    CpdClose();
+    memset(pStatistics_p, 0, sizeof(tCpdLoadStatistics));
+    dStartTime = CpdGetTime();
+
+    for (uiFile=0; uiFile<uiCapFiles_p; uiFile++)
+    {
+        iRes = CpdLoadFile(apszCapFiles_p[uiFile], pStatistics_p);
+        if (iRes < 0)
+        {
+            CpdClose();
+            return (iRes);
+        }
+        pStatistics_p->m_uiFiles++;
+    }
+
+    // frames of several radios or files in order of capture time (stable -> same order for equal times)
+    std::stable_sort(vecFrames_l.begin(), vecFrames_l.end(),
+                     [](const tCpdFrame& Frame1_p, const tCpdFrame& Frame2_p)
+                     {
+                         return (Frame1_p.m_ui64TimeUs < Frame2_p.m_ui64TimeUs);
+                     });
+
+    for (ui32Frame=0; ui32Frame<(uint32_t)vecFrames_l.size(); ui32Frame++)
+    {
+        uiDevID = vecFrames_l[ui32Frame].m_ui8DevID;
+        if (uiDevID == CPD_NO_DEVID)
+        {
+            pStatistics_p->m_ui64NoDevID++;
+            continue;
+        }
+        if ( aPartition_l[uiDevID].m_vecFrames.empty() )
+        {
+            pStatistics_p->m_uiPartitions++;
+        }
+        aPartition_l[uiDevID].m_vecFrames.push_back(ui32Frame);
+    }
+
+    pStatistics_p->m_ui64Frames = vecFrames_l.size();
+    pStatistics_p->m_dLoadTime  = CpdGetTime() - dStartTime;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Decode loaded Frames
+//---------------------------------------------------------------------------
+//  The frames are processed in batches of CPD_BATCH_FRAMES. The partitions
+//  with frames in the batch are decoded by the worker threads, then the
+//  Json Messages are merged by frame number and passed to the output
+//  function (and the digest) in the calling thread.
+
+int  CpdDecode (
+    uint uiThreads_p,                                   // [IN]     Number of Worker Threads
+    tCpdOutputFunc pfnOutput_p,                         // [IN]     Output Function (NULL = Digest only)
+    void* pArg_p,                                       // [IN]     Argument of Output Function
+    tCpdDecodeStatistics* pStatistics_p)                // [OUT]    Ptr to Statistics
+{
+
+std::vector<std::thread>  vecThreads;
+tCpdPartition*  pPartition;
+tCpdPartition*  pMinPartition;
+tCpdResult*     pResult;
+uint32_t        ui32BatchStart;
+uint32_t        ui32MinFrame;
+uLong           ulDigest;
+double          dStartTime;
+uint            uiDevID;
+uint            uiThread;
+int             iRes;
+
+
+    if ((uiThreads_p == 0) || (pStatistics_p == NULL))
+    {
+        return (-1);
+    }
+
+    memset(pStatistics_p, 0, sizeof(tCpdDecodeStatistics));
+    pStatistics_p->m_uiThreads = uiThreads_p;
+
+    // same rules as RadioDedup with default Hold Time
+    ui64HoldTimeUs_l    = (uint64_t)RDD_DEF_HOLD_TIME_MS * 1000;
+    ui64HistoryTimeUs_l = ui64HoldTimeUs_l * 10;
+    if (ui64HistoryTimeUs_l < ((uint64_t)RDD_MIN_HISTORY_MS * 1000))
+    {
+        ui64HistoryTimeUs_l = (uint64_t)RDD_MIN_HISTORY_MS * 1000;
+    }
+
+    vecFrameMerged_l.assign(vecFrames_l.size(), 0);
+    for (uiDevID=0; uiDevID<LORA_DEVICES; uiDevID++)
+    {
+        pPartition = &aPartition_l[uiDevID];
+        pPartition->m_nNextFrame = 0;
+        pPartition->m_nMergePos  = 0;
+        pPartition->m_deqRecentKeys.clear();
+        memset(pPartition->m_aui32SequNumHistList, 0, sizeof(pPartition->m_aui32SequNumHistList));
+        pPartition->m_vecResults.clear();
+        pPartition->m_ui64Packets    = 0;
+        pPartition->m_ui64Copies     = 0;
+        pPartition->m_ui64BetterRssi = 0;
+        pPartition->m_ui64LateCopies = 0;
+        pPartition->m_ui64Unknown    = 0;
+        pPartition->m_ui64Ignored    = 0;
+    }
+
+    ulDigest = crc32(0L, Z_NULL, 0);
+    for (ui32BatchStart=0; ui32BatchStart<(uint32_t)vecFrames_l.size(); ui32BatchStart=ui32BatchEnd_l)
+    {
+        ui32BatchEnd_l = ui32BatchStart + CPD_BATCH_FRAMES;
+        if (ui32BatchEnd_l > (uint32_t)vecFrames_l.size())
+        {
+            ui32BatchEnd_l = (uint32_t)vecFrames_l.size();
+        }
+
+        // parallel part: decode partitions with frames in this batch
+        dStartTime = CpdGetTime();
+        vecBatchPartitions_l.clear();
+        for (uiDevID=0; uiDevID<LORA_DEVICES; uiDevID++)
+        {
+            pPartition = &aPartition_l[uiDevID];
+            if ((pPartition->m_nNextFrame < pPartition->m_vecFrames.size()) &&
+                (pPartition->m_vecFrames[pPartition->m_nNextFrame] < ui32BatchEnd_l))
+            {
+                vecBatchPartitions_l.push_back(uiDevID);
+            }
+        }
+
+        nNextPartition_l = 0;
+        vecThreads.clear();
+        for (uiThread=1; (uiThread<uiThreads_p) && (uiThread<vecBatchPartitions_l.size()); uiThread++)
+        {
+            vecThreads.push_back(std::thread(CpdWorkerThread));
+        }
+        CpdWorkerThread();
+        for (uiThread=0; uiThread<vecThreads.size(); uiThread++)
+        {
+            vecThreads[uiThread].join();
+        }
+        pStatistics_p->m_dDecodeTime += CpdGetTime() - dStartTime;
+
+        // sequential part: merge Json Messages by frame number
+        dStartTime = CpdGetTime();
+        while (true)
+        {
+            pMinPartition = NULL;
+            ui32MinFrame  = UINT32_MAX;
+            for (uint uiPartition : vecBatchPartitions_l)
+            {
+                pPartition = &aPartition_l[uiPartition];
+                if ((pPartition->m_nMergePos < pPartition->m_vecResults.size()) &&
+                    (pPartition->m_vecResults[pPartition->m_nMergePos].m_ui32Frame < ui32MinFrame))
+                {
+                    pMinPartition = pPartition;
+                    ui32MinFrame  = pPartition->m_vecResults[pPartition->m_nMergePos].m_ui32Frame;
+                }
+            }
+            if (pMinPartition == NULL)
+            {
+                break;
+            }
+
+            pResult = &pMinPartition->m_vecResults[pMinPartition->m_nMergePos++];
+            ulDigest = crc32(ulDigest, (const Bytef*)pResult->m_JsonMessage.m_strJsonRecord.c_str(), pResult->m_JsonMessage.m_strJsonRecord.length());
+            ulDigest = crc32(ulDigest, (const Bytef*)"\n", 1);
+            pStatistics_p->m_ui64Messages++;
+            if (pfnOutput_p != NULL)
+            {
+                iRes = pfnOutput_p(&pResult->m_JsonMessage, pArg_p);
+                if (iRes < 0)
+                {
+                    return (-2);
+                }
+            }
+        }
+        for (uint uiPartition : vecBatchPartitions_l)
+        {
+            aPartition_l[uiPartition].m_vecResults.clear();
+            aPartition_l[uiPartition].m_nMergePos = 0;
+        }
+        pStatistics_p->m_dMergeTime += CpdGetTime() - dStartTime;
+    }
+
+    for (uiDevID=0; uiDevID<LORA_DEVICES; uiDevID++)
+    {
+        pPartition = &aPartition_l[uiDevID];
+        pStatistics_p->m_ui64Packets    += pPartition->m_ui64Packets;
+        pStatistics_p->m_ui64Copies     += pPartition->m_ui64Copies;
+        pStatistics_p->m_ui64BetterRssi += pPartition->m_ui64BetterRssi;
+        pStatistics_p->m_ui64LateCopies += pPartition->m_ui64LateCopies;
+        pStatistics_p->m_ui64Unknown    += pPartition->m_ui64Unknown;
+        pStatistics_p->m_ui64Ignored    += pPartition->m_ui64Ignored;
+    }
+    pStatistics_p->m_ui32Digest = (uint32_t)ulDigest;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Release loaded Frames
+//---------------------------------------------------------------------------
+
+void  CpdClose (void)
+{
+
+uint  uiDevID;
+
+
+    std::vector<tCpdFrame>().swap(vecFrames_l);
+    std::vector<uint8_t>().swap(vecFrameData_l);
+    std::vector<uint8_t>().swap(vecFrameMerged_l);
+    for (uiDevID=0; uiDevID<LORA_DEVICES; uiDevID++)
+    {
+        std::vector<uint32_t>().swap(aPartition_l[uiDevID].m_vecFrames);
+        std::deque<tCpdRecentKey>().swap(aPartition_l[uiDevID].m_deqRecentKeys);
+        std::vector<tCpdResult>().swap(aPartition_l[uiDevID].m_vecResults);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Write synthetic CaptureFile
+//---------------------------------------------------------------------------
+//  The packets are built by the encoder of the firmware. DevID % 3 selects
+//  the format (Classic, Delta with 6 generations, Compact with all sensors),
+//  each device sends a Bootup and then a Data Packet every
+//  CPD_SYNTH_CYCLE_TIME. Some packets are lost (recovered from the older
+//  generations), some devices reboot, each packet is received by 1 to
+//  CPD_SYNTH_MAX_RADIOS radios, a few copies arrive late. The sequence is
+//  the same for each run.
+
+int  CpdWriteSynthCapture (
+    const char* pszCapFile_p,                           // [IN]     Path/Name of CaptureFile
+    uint uiDays_p,                                      // [IN]     Captured Time [days]
+    uint uiDevices_p,                                   // [IN]     Number of Devices (max. CPD_SYNTH_MAX_DEVICES)
+    uint64_t* pui64Frames_p)                            // [OUT]    Number of Frames written
+{
+
+std::vector<tCpdSynthDevice>  vecDevices;
+std::vector<uint8_t>  vecBuffer;
+LoraPayloadEncoder::tSensorDataRec  SensorDataRec;
+tCpdSynthDevice*  pDevice;
+const void*       pPayload;
+uint8_t           abNoise[4];
+uint              uiPayloadLen;
+uint              uiCycles;
+uint              uiCycle;
+uint              uiSlot;
+uint              uiDevice;
+uint32_t          ui32Time;
+uint64_t          ui64TimeUs;
+double            dDayPhase;
+int               iFd;
+
+
+    if ((pszCapFile_p == NULL) || (uiDays_p == 0) || (uiDevices_p == 0) ||
+        (uiDevices_p > CPD_SYNTH_MAX_DEVICES) || (pui64Frames_p == NULL))
+    {
+        return (-1);
+    }
+
+    iFd = open(pszCapFile_p, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (iFd < 0)
+    {
+        return (-2);
+    }
+
+    *pui64Frames_p = 0;
+    ui32SynthRandom_l = 0x4C6F5261;                     // 'LoRa'
+    vecBuffer.reserve(CPD_SYNTH_BUFFER_SIZE);
+
+    // pcap File Header
+    CpdPutLe32(&vecBuffer, PCAP_MAGIC_NUMBER);
+    CpdPutLe16(&vecBuffer, 2);
+    CpdPutLe16(&vecBuffer, 4);
+    CpdPutLe32(&vecBuffer, 0);                          // thiszone (GMT)
+    CpdPutLe32(&vecBuffer, 0);                          // sigfigs
+    CpdPutLe32(&vecBuffer, 65535);                      // snaplen
+    CpdPutLe32(&vecBuffer, PCW_LINKTYPE_LORATAP);
+
+    vecDevices.resize(uiDevices_p);
+    for (uiDevice=0; uiDevice<uiDevices_p; uiDevice++)
+    {
+        pDevice = &vecDevices[uiDevice];
+        pDevice->m_ui8DevID   = (uint8_t)uiDevice;
+        pDevice->m_i8BaseRssi = (int8_t)(-60 - (int)CpdSynthRandom(50));
+    }
+
+    uiCycles = (uiDays_p * 86400) / CPD_SYNTH_CYCLE_TIME;
+    uiSlot   = CPD_SYNTH_CYCLE_TIME / uiDevices_p;
+    for (uiCycle=0; uiCycle<uiCycles; uiCycle++)
+    {
+        for (uiDevice=0; uiDevice<uiDevices_p; uiDevice++)
+        {
+            pDevice = &vecDevices[uiDevice];
+            ui32Time   = CPD_SYNTH_START_TIME + (uiCycle * CPD_SYNTH_CYCLE_TIME) + (uiDevice * uiSlot) + CpdSynthRandom(3);
+            ui64TimeUs = ((uint64_t)ui32Time * 1000000) + CpdSynthRandom(1000000);
+
+            // Bootup after power-on and after rare resets
+            if ((uiCycle == 0) || (CpdSynthRandom(2000) == 0))
+            {
+                CpdSynthBootup(pDevice, ui32Time);
+                CpdSynthTransmit(pDevice, ui64TimeUs, pDevice->m_LoraPayloadEnc.GetTxBootupPacket(), sizeof(tLoraDataPacket), &vecBuffer, pui64Frames_p);
+                continue;
+            }
+
+            dDayPhase = (2.0 * M_PI * (double)(ui32Time % 86400)) / 86400.0;
+            memset(&SensorDataRec, 0x00, sizeof(SensorDataRec));
+            SensorDataRec.m_ui32Uptime     = ui32Time - pDevice->m_ui32BootupTime;
+            SensorDataRec.m_flTemperature  = (float)(20.0 - (4.0 * cos(dDayPhase)) + (0.5 * uiDevice) + (0.1 * (int)CpdSynthRandom(10)));
+            SensorDataRec.m_flHumidity     = (float)(55.0 + (10.0 * cos(dDayPhase)) + (int)CpdSynthRandom(5));
+            SensorDataRec.m_fMotionActive  = (CpdSynthRandom(10) == 0);
+            if ( SensorDataRec.m_fMotionActive )
+            {
+                pDevice->m_ui16MotionActiveCount++;
+                SensorDataRec.m_ui16MotionActiveTime = (uint16_t)(5 + CpdSynthRandom(120));
+            }
+            SensorDataRec.m_ui16MotionActiveCount = pDevice->m_ui16MotionActiveCount;
+            SensorDataRec.m_ui8LightLevel  = (uint8_t)((sin(dDayPhase - (M_PI / 2.0)) > 0) ? (90.0 * sin(dDayPhase - (M_PI / 2.0))) : 0);
+            SensorDataRec.m_flCarBattLevel = (float)(12.4 + (0.01 * (int)CpdSynthRandom(20)));
+            pDevice->m_LoraPayloadEnc.EncodeTxDataPacket(&SensorDataRec);
+
+            // lost packets (the record is recovered from the next packets)
+            if (CpdSynthRandom(100) < 5)
+            {
+                continue;
+            }
+
+            pPayload = pDevice->m_LoraPayloadEnc.GetTxDataPayload(&uiPayloadLen);
+            CpdSynthTransmit(pDevice, ui64TimeUs, pPayload, uiPayloadLen, &vecBuffer, pui64Frames_p);
+
+            // noise frame without (DevID, SequNum)
+            if (CpdSynthRandom(1000) == 0)
+            {
+                abNoise[0] = (uint8_t)CpdSynthRandom(256);
+                abNoise[1] = (uint8_t)CpdSynthRandom(256);
+                abNoise[2] = (uint8_t)CpdSynthRandom(256);
+                abNoise[3] = (uint8_t)CpdSynthRandom(256);
+                CpdSynthPutFrame(ui64TimeUs + 2000000, -120, abNoise, sizeof(abNoise), &vecBuffer);
+                (*pui64Frames_p)++;
+            }
+
+            if (vecBuffer.size() > (CPD_SYNTH_BUFFER_SIZE - 4096))
+            {
+                if ( !CpdFlushBuffer(iFd, &vecBuffer) )
+                {
+                    close(iFd);
+                    return (-3);
+                }
+            }
+        }
+    }
+
+    if ( !CpdFlushBuffer(iFd, &vecBuffer) )
+    {
+        close(iFd);
+        return (-3);
+    }
+    close(iFd);
+
+    return (0);
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Load one CaptureFile
+//---------------------------------------------------------------------------
+
+static  int  CpdLoadFile (
+    const char* pszCapFile_p,
+    tCpdLoadStatistics* pStatistics_p)
+{
+
+struct stat      FileStat;
+tCpdFrame        Frame;
+const uint8_t*   pabFile;
+const uint8_t*   pabRec;
+const uint8_t*   pabData;
+size_t           nFileSize;
+size_t           nPos;
+uint             uiInclLen;
+uint             uiTapHdrLen;
+uint             uiDataLen;
+int              iFd;
+
+
+    iFd = open(pszCapFile_p, O_RDONLY);
+    if (iFd < 0)
+    {
+        fprintf(stderr, "ERROR: can't open CaptureFile '%s'!\n", pszCapFile_p);
+        return (-2);
+    }
+    if ((fstat(iFd, &FileStat) != 0) || (FileStat.st_size < (off_t)PCAP_FILE_HDR_SIZE))
+    {
+        fprintf(stderr, "ERROR: '%s' is not a CaptureFile!\n", pszCapFile_p);
+        close(iFd);
+        return (-3);
+    }
+    nFileSize = (size_t)FileStat.st_size;
+    pabFile = (const uint8_t*)mmap(NULL, nFileSize, PROT_READ, MAP_PRIVATE, iFd, 0);
+    close(iFd);
+    if (pabFile == MAP_FAILED)
+    {
+        fprintf(stderr, "ERROR: can't map CaptureFile '%s'!\n", pszCapFile_p);
+        return (-2);
+    }
+    madvise((void*)pabFile, nFileSize, MADV_SEQUENTIAL);
+
+    if ((CpdGetLe32(&pabFile[0]) != PCAP_MAGIC_NUMBER) || (CpdGetLe32(&pabFile[20]) != PCW_LINKTYPE_LORATAP))
+    {
+        fprintf(stderr, "ERROR: '%s' is not a CaptureFile with LoRaTap Header!\n", pszCapFile_p);
+        munmap((void*)pabFile, nFileSize);
+        return (-3);
+    }
+
+    pStatistics_p->m_ui64Bytes += nFileSize;
+    for (nPos=PCAP_FILE_HDR_SIZE; (nPos + PCAP_REC_HDR_SIZE) <= nFileSize; nPos+=(PCAP_REC_HDR_SIZE + uiInclLen))
+    {
+        pabRec = &pabFile[nPos];
+        uiInclLen = CpdGetLe32(&pabRec[8]);
+        if ((nPos + PCAP_REC_HDR_SIZE + uiInclLen) > nFileSize)
+        {
+            pStatistics_p->m_ui64Damaged++;             // torn record
+            break;
+        }
+
+        // LoRaTap Header: Version, Padding, Length (BE16), Frequency, Bandwidth, SF, RSSI (Packet, Max, Current), SNR, SyncWord
+        uiTapHdrLen = (uiInclLen >= PCW_LORATAP_HDR_SIZE) ? CpdGetBe16(&pabRec[PCAP_REC_HDR_SIZE + 2]) : 0;
+        if ((uiTapHdrLen < PCW_LORATAP_HDR_SIZE) || (uiTapHdrLen > uiInclLen) ||
+            ((uiInclLen - uiTapHdrLen) > RH_RF95_MAX_PAYLOAD_LEN))
+        {
+            pStatistics_p->m_ui64Damaged++;
+            continue;
+        }
+        pabData   = &pabRec[PCAP_REC_HDR_SIZE + uiTapHdrLen];
+        uiDataLen = uiInclLen - uiTapHdrLen;
+
+        Frame.m_ui64TimeUs   = ((uint64_t)CpdGetLe32(&pabRec[0]) * 1000000) + CpdGetLe32(&pabRec[4]);
+        Frame.m_ui64DataOffs = vecFrameData_l.size();
+        Frame.m_ui8DataLen   = (uint8_t)uiDataLen;
+        Frame.m_i8Rssi       = (int8_t)((int)pabRec[PCAP_REC_HDR_SIZE + 10] - 139);
+        if ( !CpdGetFrameKey(pabData, uiDataLen, &Frame.m_ui8PacketType, &Frame.m_ui8DevID, &Frame.m_ui32Key) )
+        {
+            Frame.m_ui8DevID = CPD_NO_DEVID;
+        }
+        if (vecFrames_l.size() >= UINT32_MAX)
+        {
+            fprintf(stderr, "ERROR: too many frames!\n");
+            munmap((void*)pabFile, nFileSize);
+            return (-4);
+        }
+
+        vecFrameData_l.insert(vecFrameData_l.end(), pabData, pabData + uiDataLen);
+        vecFrames_l.push_back(Frame);
+    }
+
+    munmap((void*)pabFile, nFileSize);
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get identification of LoRa Packet (same as RadioDedup)
+//---------------------------------------------------------------------------
+
+static  bool  CpdGetFrameKey (
+    const uint8_t* pabData_p,
+    uint uiDataLen_p,
+    uint8_t* pui8PacketType_p,
+    uint8_t* pui8DevID_p,
+    uint32_t* pui32Key_p)
+{
+
+const tLoraDataHeader*  pLoraHeader;
+
+
+    *pui8PacketType_p = 0;
+    *pui8DevID_p      = 0;
+    *pui32Key_p       = 0;
+
+    if (uiDataLen_p < sizeof(tLoraDataHeader))
+    {
+        return (false);
+    }
+
+    pLoraHeader = (const tLoraDataHeader*)pabData_p;
+    *pui8PacketType_p = (uint8_t)LoraDataHeaderField<kLoraHeaderPacketType>::Get(pLoraHeader);
+    *pui8DevID_p      = (uint8_t)LoraDataHeaderField<kLoraHeaderDevID>::Get(pLoraHeader);
+
+    switch (*pui8PacketType_p)
+    {
+        case kLoraPacketDataHeader:
+        case kLoraPacketDataHeaderDelta:
+        case kLoraPacketDataHeaderCompact:
+        {
+            *pui32Key_p = LoraDataHeaderField<kLoraHeaderSequNum>::Get(pLoraHeader);
+            break;
+        }
+
+        case kLoraPacketBootup:
+        {
+            *pui32Key_p = (uint32_t)LoraGetCrc16(pLoraHeader->m_abCRC16);
+            break;
+        }
+
+        default:
+        {
+            return (false);
+        }
+    }
+
+    return ((uint)*pui8DevID_p < LORA_DEVICES);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Worker Thread: decode Partitions of current Batch until all are done
+//---------------------------------------------------------------------------
+
+static  void  CpdWorkerThread (void)
+{
+
+size_t  nItem;
+
+
+    while (true)
+    {
+        nItem = nNextPartition_l++;
+        if (nItem >= vecBatchPartitions_l.size())
+        {
+            break;
+        }
+
+        CpdDecodePartition(&aPartition_l[vecBatchPartitions_l[nItem]]);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Decode Frames of Partition up to end of current Batch
+//---------------------------------------------------------------------------
+//  Cross-Radio Deduplication as in RadioDedup: copies within the hold time
+//  after the first frame are merged into it (the one with the best RSSI is
+//  decoded, the Json Message keeps the position of the first frame), later
+//  copies within the history time are discarded. Copies are always looked
+//  up in the frames of the same partition, even behind the batch.
+
+static  void  CpdDecodePartition (
+    tCpdPartition* pPartition_p)
+{
+
+const tCpdFrame*  pFrame;
+const tCpdFrame*  pCopy;
+const tCpdFrame*  pBestCopy;
+tCpdRecentKey     RecentKey;
+uint32_t          ui32Frame;
+uint32_t          ui32Copy;
+size_t            nIdx;
+bool              fLateCopy;
+
+
+    while ((pPartition_p->m_nNextFrame < pPartition_p->m_vecFrames.size()) &&
+           (pPartition_p->m_vecFrames[pPartition_p->m_nNextFrame] < ui32BatchEnd_l))
+    {
+        ui32Frame = pPartition_p->m_vecFrames[pPartition_p->m_nNextFrame++];
+        if ( vecFrameMerged_l[ui32Frame] )
+        {
+            continue;
+        }
+        pFrame = &vecFrames_l[ui32Frame];
+
+        // late copy of a packet already forwarded?
+        while (!pPartition_p->m_deqRecentKeys.empty() &&
+               ((pPartition_p->m_deqRecentKeys.front().m_ui64FirstRxUs + ui64HistoryTimeUs_l) < pFrame->m_ui64TimeUs))
+        {
+            pPartition_p->m_deqRecentKeys.pop_front();
+        }
+        fLateCopy = false;
+        for (const tCpdRecentKey& Key : pPartition_p->m_deqRecentKeys)
+        {
+            if ((Key.m_ui8PacketType == pFrame->m_ui8PacketType) && (Key.m_ui32Key == pFrame->m_ui32Key))
+            {
+                fLateCopy = true;
+                break;
+            }
+        }
+        if ( fLateCopy )
+        {
+            pPartition_p->m_ui64LateCopies++;
+            continue;
+        }
+
+        // merge copies of further radios within hold time
+        pBestCopy = pFrame;
+        for (nIdx=pPartition_p->m_nNextFrame; nIdx<pPartition_p->m_vecFrames.size(); nIdx++)
+        {
+            ui32Copy = pPartition_p->m_vecFrames[nIdx];
+            pCopy = &vecFrames_l[ui32Copy];
+            if (pCopy->m_ui64TimeUs > (pFrame->m_ui64TimeUs + ui64HoldTimeUs_l))
+            {
+                break;
+            }
+            if ((pCopy->m_ui8PacketType != pFrame->m_ui8PacketType) || (pCopy->m_ui32Key != pFrame->m_ui32Key) ||
+                vecFrameMerged_l[ui32Copy])
+            {
+                continue;
+            }
+
+            vecFrameMerged_l[ui32Copy] = 1;
+            pPartition_p->m_ui64Copies++;
+            if (pCopy->m_i8Rssi > pBestCopy->m_i8Rssi)
+            {
+                pBestCopy = pCopy;
+                pPartition_p->m_ui64BetterRssi++;
+            }
+        }
+
+        RecentKey.m_ui8PacketType = pFrame->m_ui8PacketType;
+        RecentKey.m_ui32Key       = pFrame->m_ui32Key;
+        RecentKey.m_ui64FirstRxUs = pFrame->m_ui64TimeUs;
+        pPartition_p->m_deqRecentKeys.push_back(RecentKey);
+
+        pPartition_p->m_ui64Packets++;
+        CpdDecodePacket(pPartition_p, ui32Frame, pBestCopy);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Decode Packet and qualify Json Messages (same chain as in Gateway)
+//---------------------------------------------------------------------------
+
+static  void  CpdDecodePacket (
+    tCpdPartition* pPartition_p,
+    uint32_t ui32Frame_p,
+    const tCpdFrame* pBestCopy_p)
+{
+
+std::vector<tJsonMessage>  vecJsonMessages;
+tLoraMsgData   LoraMsgData;
+tCpdResult     Result;
+bool           fIsKnownLoraMsgFormat;
+int            iMessageToBeProcessed;
+int            iIdx;
+int            iRes;
+
+
+    iRes = PprGainLoraDataRecord(ui32Frame_p + 1, (time_t)(pBestCopy_p->m_ui64TimeUs / 1000000), pBestCopy_p->m_i8Rssi,
+                                 &vecFrameData_l[pBestCopy_p->m_ui64DataOffs], pBestCopy_p->m_ui8DataLen,
+                                 &LoraMsgData, &fIsKnownLoraMsgFormat);
+    if ((iRes != 0) || !fIsKnownLoraMsgFormat)
+    {
+        pPartition_p->m_ui64Unknown++;
+        return;
+    }
+
+    iRes = PprBuildJsonMessages(&LoraMsgData, &vecJsonMessages);
+    if (iRes < 0)
+    {
+        pPartition_p->m_ui64Unknown++;
+        return;
+    }
+
+    // from the last to the first element (Gen2/Gen1/Gen0) as in the Gateway
+    for (iIdx=vecJsonMessages.size()-1; iIdx>=0; iIdx--)
+    {
+        iMessageToBeProcessed = MquIsSequNumToBeProcessed(pPartition_p->m_aui32SequNumHistList,
+                                                          vecJsonMessages[iIdx].m_PacketType,
+                                                          vecJsonMessages[iIdx].m_ui32SequNum);
+        if (iMessageToBeProcessed < 1)
+        {
+            pPartition_p->m_ui64Ignored++;
+            continue;
+        }
+
+        Result.m_ui32Frame = ui32Frame_p;
+        Result.m_JsonMessage = std::move(vecJsonMessages[iIdx]);
+        pPartition_p->m_vecResults.push_back(std::move(Result));
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Synthetic Capture: (Re)Boot Device
+//---------------------------------------------------------------------------
+
+static  void  CpdSynthBootup (
+    tCpdSynthDevice* pDevice_p,
+    uint32_t ui32Time_p)
+{
+
+LoraPayloadEncoder::tDeviceConfig  DeviceConfig;
+
+
+    pDevice_p->m_LoraPayloadEnc = LoraPayloadEncoder();
+    pDevice_p->m_LoraPayloadEnc.Setup(pDevice_p->m_ui8DevID);
+    switch (pDevice_p->m_ui8DevID % 3)
+    {
+        case 1:
+        {
+            pDevice_p->m_LoraPayloadEnc.SetupGenerationDepth(6);
+            break;
+        }
+
+        case 2:
+        {
+            pDevice_p->m_LoraPayloadEnc.SetupGenerationDepth(4);
+            pDevice_p->m_LoraPayloadEnc.SetupCompactLayout(true, LORA_DATA_LAYOUT_SENSOR_MASK);
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+    pDevice_p->m_ui32BootupTime = ui32Time_p;
+    pDevice_p->m_ui16MotionActiveCount = 0;
+
+    memset(&DeviceConfig, 0x00, sizeof(DeviceConfig));
+    DeviceConfig.m_ui8FirmwareVersion  = 1;
+    DeviceConfig.m_ui8FirmwareRevision = 0;
+    DeviceConfig.m_ui16DataPackCycleTm = (uint16_t)(CPD_SYNTH_CYCLE_TIME / 60);
+    DeviceConfig.m_fCfgDhtSensor       = true;
+    DeviceConfig.m_fCfgSr501Sensor     = true;
+    DeviceConfig.m_fCfgAdcLightSensor  = true;
+    DeviceConfig.m_fCfgAdcCarBatAin    = true;
+    DeviceConfig.m_ui8LoraTxPower      = 14;
+    DeviceConfig.m_ui8LoraSpreadFactor = (uint8_t)CPD_SYNTH_SPREAD_FACTOR;
+    pDevice_p->m_LoraPayloadEnc.EncodeTxBootupPacket(&DeviceConfig);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Synthetic Capture: Frames of all Radios receiving a Packet
+//---------------------------------------------------------------------------
+
+static  void  CpdSynthTransmit (
+    const tCpdSynthDevice* pDevice_p,
+    uint64_t ui64TimeUs_p,
+    const void* pPayload_p,
+    uint uiPayloadLen_p,
+    std::vector<uint8_t>* pvecBuffer_p,
+    uint64_t* pui64Frames_p)
+{
+
+uint64_t  ui64TimeUs;
+uint      uiRadios;
+uint      uiRadio;
+
+
+    ui64TimeUs = ui64TimeUs_p;
+    uiRadios = 1 + CpdSynthRandom(CPD_SYNTH_MAX_RADIOS);
+    for (uiRadio=0; uiRadio<uiRadios; uiRadio++)
+    {
+        CpdSynthPutFrame(ui64TimeUs, (int)pDevice_p->m_i8BaseRssi - (int)CpdSynthRandom(20), pPayload_p, uiPayloadLen_p, pvecBuffer_p);
+        (*pui64Frames_p)++;
+        ui64TimeUs += CpdSynthRandom(30000);            // read latency of next radio
+    }
+
+    // copy delayed beyond hold time (e.g. radio with overrun queue)
+    if (CpdSynthRandom(500) == 0)
+    {
+        ui64TimeUs += 500000 + CpdSynthRandom(1000000);
+        CpdSynthPutFrame(ui64TimeUs, (int)pDevice_p->m_i8BaseRssi, pPayload_p, uiPayloadLen_p, pvecBuffer_p);
+        (*pui64Frames_p)++;
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Synthetic Capture: append pcap Record (same format as PcapWriter)
+//---------------------------------------------------------------------------
+
+static  void  CpdSynthPutFrame (
+    uint64_t ui64TimeUs_p,
+    int iRssi_p,
+    const void* pData_p,
+    uint uiDataLen_p,
+    std::vector<uint8_t>* pvecBuffer_p)
+{
+
+int  iRssi;
+
+
+    iRssi = iRssi_p + 139;
+    iRssi = (iRssi < 0) ? 0 : ((iRssi > 255) ? 255 : iRssi);
+
+    // pcap Record Header
+    CpdPutLe32(pvecBuffer_p, (uint32_t)(ui64TimeUs_p / 1000000));
+    CpdPutLe32(pvecBuffer_p, (uint32_t)(ui64TimeUs_p % 1000000));
+    CpdPutLe32(pvecBuffer_p, PCW_LORATAP_HDR_SIZE + uiDataLen_p);
+    CpdPutLe32(pvecBuffer_p, PCW_LORATAP_HDR_SIZE + uiDataLen_p);
+
+    // LoRaTap Header
+    pvecBuffer_p->push_back(0);
+    pvecBuffer_p->push_back(0);
+    CpdPutBe16(pvecBuffer_p, PCW_LORATAP_HDR_SIZE);
+    CpdPutBe32(pvecBuffer_p, CPD_SYNTH_FREQUENCY);
+    pvecBuffer_p->push_back((uint8_t)(CPD_SYNTH_BANDWIDTH / 125));
+    pvecBuffer_p->push_back((uint8_t)CPD_SYNTH_SPREAD_FACTOR);
+    pvecBuffer_p->push_back((uint8_t)iRssi);
+    pvecBuffer_p->push_back((uint8_t)iRssi);
+    pvecBuffer_p->push_back((uint8_t)iRssi);
+    pvecBuffer_p->push_back((uint8_t)(int8_t)((iRssi_p + 130) / 4));
+    pvecBuffer_p->push_back((uint8_t)PCW_LORA_SYNC_WORD);
+
+    // raw LoRa frame
+    pvecBuffer_p->insert(pvecBuffer_p->end(), (const uint8_t*)pData_p, (const uint8_t*)pData_p + uiDataLen_p);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Synthetic Capture: Random Number (0 .. Range-1, same sequence each run)
+//---------------------------------------------------------------------------
+
+static  uint32_t  CpdSynthRandom (
+    uint32_t ui32Range_p)
+{
+
+    ui32SynthRandom_l = (ui32SynthRandom_l * 1664525) + 1013904223;
+
+    return ((uint32_t)(((uint64_t)(ui32SynthRandom_l >> 8) * ui32Range_p) >> 24));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Synthetic Capture: write Buffer to File
+//---------------------------------------------------------------------------
+
+static  bool  CpdFlushBuffer (
+    int iFd_p,
+    std::vector<uint8_t>* pvecBuffer_p)
+{
+
+ssize_t  iRes;
+
+
+    if ( pvecBuffer_p->empty() )
+    {
+        return (true);
+    }
+
+    iRes = write(iFd_p, pvecBuffer_p->data(), pvecBuffer_p->size());
+    if (iRes != (ssize_t)pvecBuffer_p->size())
+    {
+        return (false);
+    }
+    pvecBuffer_p->clear();
+
+    return (true);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Byte Order Helpers (pcap: Little Endian, LoRaTap: Big Endian)
+//---------------------------------------------------------------------------
+
+static  inline  uint16_t  CpdGetLe16 (const uint8_t* pabBuff_p)
+{
+
+    return ((uint16_t)(pabBuff_p[0] | (pabBuff_p[1] << 8)));
+
+}
+
+static  inline  uint32_t  CpdGetLe32 (const uint8_t* pabBuff_p)
+{
+
+    return ((uint32_t)pabBuff_p[0] | ((uint32_t)pabBuff_p[1] << 8) | ((uint32_t)pabBuff_p[2] << 16) | ((uint32_t)pabBuff_p[3] << 24));
+
+}
+
+static  inline  uint16_t  CpdGetBe16 (const uint8_t* pabBuff_p)
+{
+
+    return ((uint16_t)((pabBuff_p[0] << 8) | pabBuff_p[1]));
+
+}
+
+static  inline  void  CpdPutLe16 (std::vector<uint8_t>* pvecBuff_p, uint16_t ui16Value_p)
+{
+
+    pvecBuff_p->push_back((uint8_t)(ui16Value_p));
+    pvecBuff_p->push_back((uint8_t)(ui16Value_p >> 8));
+
+}
+
+static  inline  void  CpdPutLe32 (std::vector<uint8_t>* pvecBuff_p, uint32_t ui32Value_p)
+{
+
+    CpdPutLe16(pvecBuff_p, (uint16_t)(ui32Value_p));
+    CpdPutLe16(pvecBuff_p, (uint16_t)(ui32Value_p >> 16));
+
+}
+
+static  inline  void  CpdPutBe16 (std::vector<uint8_t>* pvecBuff_p, uint16_t ui16Value_p)
+{
+
+    pvecBuff_p->push_back((uint8_t)(ui16Value_p >> 8));
+    pvecBuff_p->push_back((uint8_t)(ui16Value_p));
+
+}
+
+static  inline  void  CpdPutBe32 (std::vector<uint8_t>* pvecBuff_p, uint32_t ui32Value_p)
+{
+
+    CpdPutBe16(pvecBuff_p, (uint16_t)(ui32Value_p >> 16));
+    CpdPutBe16(pvecBuff_p, (uint16_t)(ui32Value_p));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Monotonic Time [sec]
+//---------------------------------------------------------------------------
+
+static  double  CpdGetTime (void)
+{
+
+struct timespec  TimeSpec;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &TimeSpec);
+
+    return ((double)TimeSpec.tv_sec + ((double)TimeSpec.tv_nsec / 1000000000.0));
+
+}
+
+
+
+// EOF
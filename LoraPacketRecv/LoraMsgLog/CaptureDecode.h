@@ -0,0 +1,115 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa MessageLog Tool
+  Description:  Declarations for Re-Decoding of Raw Frame Captures
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _CAPTUREDECODE_H_
+#define _CAPTUREDECODE_H_
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+// Notice:  The raw frames of the CaptureFiles (pcap of 'LoraPacketRecv -c')
+//          are processed by the same chain as in the Gateway: Cross-Radio
+//          Deduplication (rules of RadioDedup), PprGainLoraDataRecord(),
+//          PprBuildJsonMessages() and MquIsSequNumToBeProcessed(). All steps
+//          only depend on the frames of the same DevID, so the frames are
+//          partitioned by DevID and the partitions are decoded in parallel.
+//          Each partition keeps its own state and processes its frames in
+//          capture order, the Json Messages of all partitions are merged by
+//          the position of their frame in the capture. The output therefore
+//          is identical for any number of threads.
+//
+//          The frames of all files are sorted by their capture time (frames
+//          with the same time keep their order). The MsgID of a Json Message
+//          is the number of its frame in this order (starting with 1), so
+//          every record can be traced back to its raw frame.
+//---------------------------------------------------------------------------
+
+const  uint  CPD_BATCH_FRAMES           = 65536;        // frames decoded in parallel before the output is merged
+const  uint  CPD_SYNTH_CYCLE_TIME       = 300;          // [sec] data packet cycle of synthetic capture
+const  uint  CPD_SYNTH_MAX_DEVICES      = 16;           // DevID is 4 bit
+
+
+
+//---------------------------------------------------------------------------
+//  Type definitions
+//---------------------------------------------------------------------------
+
+typedef int  (*tCpdOutputFunc) (
+    const tJsonMessage* pJsonMessage_p,                 // [IN]     Json Message (in capture order)
+    void* pArg_p);                                      // [IN]     Argument of CpdDecode()
+
+
+typedef struct
+{
+    uint                m_uiFiles;
+    uint64_t            m_ui64Bytes;
+    uint64_t            m_ui64Frames;               // read from CaptureFiles
+    uint64_t            m_ui64Damaged;              // records skipped (torn, wrong link type or length)
+    uint64_t            m_ui64NoDevID;              // frames without (DevID, SequNum), can't be decoded
+    uint                m_uiPartitions;             // DevIDs with frames
+    double              m_dLoadTime;                // [sec]
+
+} tCpdLoadStatistics;
+
+
+typedef struct
+{
+    uint                m_uiThreads;
+    uint64_t            m_ui64Packets;              // frames left after Cross-Radio Deduplication
+    uint64_t            m_ui64Copies;               // copies of other radios merged
+    uint64_t            m_ui64BetterRssi;           // copies which replaced the first one
+    uint64_t            m_ui64LateCopies;           // copies after hold time (discarded)
+    uint64_t            m_ui64Unknown;              // packets with unknown format
+    uint64_t            m_ui64Messages;             // Json Messages passed to output function
+    uint64_t            m_ui64Ignored;              // Json Messages already processed (older generation)
+    uint32_t            m_ui32Digest;               // CRC32 of all Json Records
+    double              m_dDecodeTime;              // [sec] parallel part (decode and deduplication)
+    double              m_dMergeTime;               // [sec] sequential part (merge and output function)
+
+} tCpdDecodeStatistics;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of public functions
+//---------------------------------------------------------------------------
+
+int  CpdLoadCaptures (
+    const char* const* apszCapFiles_p,                  // [IN]     CaptureFiles (pcap with LoRaTap Header)
+    uint uiCapFiles_p,                                  // [IN]     Number of CaptureFiles
+    tCpdLoadStatistics* pStatistics_p);                 // [OUT]    Ptr to Statistics
+
+int  CpdDecode (
+    uint uiThreads_p,                                   // [IN]     Number of Worker Threads
+    tCpdOutputFunc pfnOutput_p,                         // [IN]     Output Function (NULL = Digest only)
+    void* pArg_p,                                       // [IN]     Argument of Output Function
+    tCpdDecodeStatistics* pStatistics_p);               // [OUT]    Ptr to Statistics
+
+void  CpdClose (void);
+
+int  CpdWriteSynthCapture (
+    const char* pszCapFile_p,                           // [IN]     Path/Name of CaptureFile
+    uint uiDays_p,                                      // [IN]     Captured Time [days]
+    uint uiDevices_p,                                   // [IN]     Number of Devices (max. CPD_SYNTH_MAX_DEVICES)
+    uint64_t* pui64Frames_p);                           // [OUT]    Number of Frames written
+
+
+
+#endif  // #ifndef _CAPTUREDECODE_H_
+
+
+// EOF
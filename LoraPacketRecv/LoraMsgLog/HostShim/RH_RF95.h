@@ -0,0 +1,30 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa MessageLog Tool
+  Description:  Host Replacement of RadioHead Header (only the definitions
+                used by the shared modules of LoraPacketRecv)
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _RH_RF95_H_
+#define _RH_RF95_H_
+
+#include <stdint.h>
+#include <sys/types.h>                                  // uint
+
+#define RH_RF95_MAX_PAYLOAD_LEN     255
+
+
+
+#endif  // _RH_RF95_H_
+
+
+// EOF
@@ -0,0 +1,3717 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa MessageLog Tool
+  Description:  Implementation of Main Module
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Range Queries by Time/DevID using the Index,
+                          parallel scanning of several MessageFiles,
+                          Json MessageFiles as input, synthetic Logs
+  2026/10/18 -rs:   V1.02 Benchmark of MessageFile Rotation/Compression
+  2026/10/18 -rs:   V1.03 Import/Query of Time Series Store, Benchmark
+  2026/10/18 -rs:   V1.04 Benchmark of HTTP Query API (Last Value Cache)
+  2026/10/18 -rs:   V1.05 Follow/Benchmark of Shared Memory Ring
+  2026/10/18 -rs:   V1.06 Parallel Re-Decoding of Raw Frame Captures
+  2026/10/18 -rs:   V1.07 Benchmark of Queries with/without Index and
+                          Worker Threads
+
+****************************************************************************/
+
+
+#include <RH_RF95.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <signal.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <zlib.h>
+#include "LoraPacket.h"
+#include "LoraPacketSchema.h"
+#include "LoraPayloadDecoder.h"
+#include "PacketProcessing.h"
+#include "MessageFileWriter.h"
+#include "MessageLogReader.h"
+#include "MessageIndex.h"
+#include "TimeSeriesStore.h"
+#include "LastValueCache.h"
+#include "ShmRingWriter.h"
+#include "ShmRingReader.h"
+#include "CaptureDecode.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+#define APP_VER_MAIN            1                       // Version 1.xx
+#define APP_VER_REL             7                       // Version x.07
+
+#define APP_DEF_BENCH_RECORDS   10000
+#define APP_DEF_BENCH_FILE      "LoraMsgLogBench"
+#define APP_DEF_ROT_RECORDS     20000
+#define APP_ROT_SEGMENTS        8                       // approx. rotations per run of rotation benchmark
+#define APP_DEF_TSS_RECORDS     1000000
+#define APP_DEF_LVC_CLIENTS     100
+#define APP_LVC_BENCH_TIME      3                       // [sec] per run
+#define APP_LVC_BENCH_MESSAGES  1024                    // synthetic messages cycled by ingest thread
+#define APP_DEF_SRG_READERS     4
+#define APP_SRG_BENCH_SLOTS     4096
+#define APP_SRG_BENCH_MESSAGES  1024                    // synthetic messages cycled by writer
+#define APP_SRG_BENCH_RECORDS   1000000                 // records of full rate runs
+#define APP_SRG_PACED_RECORDS   10000                   // records of paced run
+#define APP_SRG_PACED_INTERVAL  100                     // [us] between records of paced run
+#define APP_FOLLOW_WAIT_TIME    1000                    // [ms] max. wait time in follow mode
+
+#define APP_SYNTH_DEVICES       16                      // fleet size of synthetic logs
+#define APP_SYNTH_CYCLE_TIME    300                     // [sec]
+#define APP_SYNTH_START_TIME    1792353657
+
+#define APP_SCAN_CHUNK_SIZE     (4 * 1024 * 1024)       // unindexed ranges are split into chunks of this size
+#define APP_SCAN_BATCH_ITEMS    64                      // items scanned in parallel before the output is written
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+static  const  char             JSON_KEY_DEVID[]        = "\"DevID\": ";
+static  const  char             JSON_KEY_TIMESTAMP[]    = "\"TimeStamp\": ";
+static  const  char             JSON_REC_DELIMITER[]    = "\n\n";
+static  const  char             JSON_KEY_DATA_REC[]     = "\"MsgType\": \"StationData";
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+typedef enum
+{
+    kAppOutputJson      = 0,
+    kAppOutputLine      = 1,
+    kAppOutputCsv       = 2
+
+} tAppOutputFormat;
+
+
+//  MessageFile opened for scanning (Json or binary, mapped read-only)
+typedef struct
+{
+    const char*         m_pszFileName;
+    bool                m_fBinary;
+    tMlrLog             m_MlrLog;                   // binary MessageLog
+    int                 m_iFd;                      // -\ Json MessageFile
+    const uint8_t*      m_pabMapAddr;               //  |
+    size_t              m_nMapSize;                 // -/
+
+} tAppMsgFile;
+
+
+//  Range of a MessageFile scanned by one worker thread
+typedef struct
+{
+    uint                m_uiFile;
+    uint64_t            m_ui64Offset;
+    uint64_t            m_ui64Length;
+    bool                m_fAtRecStart;              // <m_ui64Offset> is known as start of a record
+    std::string         m_strOutput;
+    uint                m_uiRecords;
+    uint                m_uiMatches;
+    uint                m_uiDamaged;
+
+} tAppScanItem;
+
+
+typedef struct
+{
+    uint                m_uiFiles;
+    uint                m_uiIndexEntries;
+    uint                m_uiIndexMatches;
+    uint                m_uiScanItems;
+    uint64_t            m_ui64BytesTotal;
+    uint64_t            m_ui64BytesScanned;
+    uint64_t            m_ui64Records;
+    uint64_t            m_ui64Matches;
+    uint64_t            m_ui64Damaged;
+    uint32_t            m_ui32Digest;               // CRC32 of the output
+    double              m_dRuntime;                 // [sec]
+
+} tAppQueryStat;
+
+
+//  Results of one client of the Query API Benchmark
+typedef struct
+{
+    uint64_t            m_ui64Requests;
+    uint64_t            m_ui64Status304;
+    uint                m_uiErrors;
+    std::vector<float>  m_vecLatency;               // [us]
+
+} tAppClientStat;
+
+
+//  Results of one reader of the Shared Memory Ring Benchmark
+typedef struct
+{
+    uint64_t            m_ui64Received;
+    uint64_t            m_ui64Lost;
+    uint                m_uiTorn;                   // released as valid, but CRC wrong
+    uint                m_uiErrors;
+    std::vector<float>  m_vecLatency;               // [us] from publishing to reading
+
+} tAppReaderStat;
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+static  std::vector<const char*>  vecMsgLogFiles_l;
+static  const char*             pszOutputFile_l         = NULL;
+static  tAppOutputFormat        OutputFormat_l          = kAppOutputJson;
+static  uint                    uiBenchRecords_l        = 0;        // 0 = no benchmark
+static  uint                    uiRotBenchRecords_l     = 0;        // 0 = no rotation benchmark
+static  tMfwFormat              RotBenchFormat_l        = kMfwFormatJson;
+static  uint                    uiSynthSizeMB_l         = 0;        // 0 = no synthetic log
+static  tMfwFormat              SynthFormat_l           = kMfwFormatBinary;
+static  int                     iQueryDevID_l           = -1;       // -1 = any
+static  int64_t                 i64QueryFromTime_l      = INT64_MIN;
+static  int64_t                 i64QueryToTime_l        = INT64_MAX;
+static  bool                    fUseIndex_l             = true;
+static  bool                    fVerbose_l              = false;
+static  uint                    uiThreads_l             = 0;
+static  const char*             pszStoreFile_l          = NULL;
+static  int                     iStoreField_l           = -1;       // -1 = all
+static  tTssLevel               StoreLevel_l            = kTssLevelHour;
+static  uint                    uiTssBenchRecords_l     = 0;        // 0 = no store benchmark
+static  uint                    uiLvcBenchClients_l     = 0;        // 0 = no query API benchmark
+static  const char*             pszShmRingName_l        = NULL;     // NULL = no follow mode
+static  uint                    uiSrgBenchReaders_l     = 0;        // 0 = no shared memory ring benchmark
+static  const char*             pszCapOutputFile_l      = NULL;     // NULL = no re-decoding of CaptureFiles
+static  tMfwFormat              CapOutputFormat_l       = kMfwFormatJson;
+static  bool                    fCapBench_l             = false;
+static  uint                    uiSynthCapDays_l        = 0;        // 0 = no synthetic capture
+static  uint                    uiSynthCapDevices_l     = CPD_SYNTH_MAX_DEVICES;
+static  bool                    fQueryBench_l           = false;
+static  volatile bool           fRunFollow_l            = false;
+
+static  std::vector<tAppMsgFile>   vecMsgFiles_l;
+static  std::vector<tAppScanItem>  vecScanItems_l;
+static  std::atomic<size_t>     nNextScanItem_l;
+static  size_t                  nBatchEnd_l;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  bool  AppEvalCmdlnArgs (int iArgCnt_p, char* apszArg_p[]);
+static  void  AppPrintHelpScreen  (const char* pszArg0_p);
+static  bool  AppParseTime (const char* pszTime_p, bool fEndOfDay_p, int64_t* pi64Time_p);
+
+static  int   AppRunQuery (tAppQueryStat* pQueryStat_p);
+static  int   AppRunQueryBench (void);
+static  int   AppOpenMsgFile (const char* pszFileName_p, tAppMsgFile* pMsgFile_p);
+static  void  AppCloseMsgFile (tAppMsgFile* pMsgFile_p);
+static  void  AppAddScanRange (uint uiFile_p, uint64_t ui64Start_p, uint64_t ui64End_p);
+static  void  AppAddScanItem (uint uiFile_p, uint64_t ui64Offset_p, uint64_t ui64Length_p, bool fAtRecStart_p);
+static  void  AppWorkerThread (void);
+static  void  AppScanBinary (tAppScanItem* pScanItem_p);
+static  void  AppScanJson (tAppScanItem* pScanItem_p);
+static  void  AppFormatRecord (const tPprRecordFields* pRecordFields_p, std::string* pstrOutput_p);
+
+static  int   AppWriteSynthLog (void);
+static  void  AppBuildSynthMessage (uint uiRec_p, bool fWithJsonRecord_p, tJsonMessage* pJsonMessage_p);
+
+static  int   AppRunBenchmark (void);
+static  int   AppBenchWriteLog (const char* pszFileName_p, tMfwFormat MsgFileFormat_p, uint uiIndexBlockRecords_p, uint uiRecords_p);
+static  int   AppBenchScanJson (const char* pszFileName_p, uint* puiRecords_p, double* pdTempSum_p);
+static  int   AppBenchScanBinary (const char* pszFileName_p, uint* puiRecords_p, double* pdTempSum_p);
+
+static  int   AppRunRotationBench (void);
+static  int   AppRotBenchWriteLog (const char* pszFileName_p, const tMfwRotationCfg* pRotationCfg_p, double* pdWriteTime_p, double* pdIdleTime_p, tMfwStatistics* pStatistics_p);
+static  void  AppRemoveDir (const char* pszDirName_p);
+
+static  int   AppImportStore (void);
+static  int   AppImportJsonFile (const tAppMsgFile* pMsgFile_p, uint64_t* pui64Records_p, uint64_t* pui64Damaged_p);
+static  int   AppQueryStore (void);
+static  int   AppRunStoreBench (void);
+static  void  AppFormatTime (int64_t i64Time_p, char* pszBuffer_p, size_t nBuffSize_p);
+
+static  int   AppRunCacheBench (void);
+static  void  AppCacheBenchClient (uint16_t ui16Port_p, uint uiClient_p, std::atomic<bool>* pfStop_p, tAppClientStat* pClientStat_p);
+
+static  int   AppFollowRing (void);
+static  int   AppRunRingBench (void);
+static  void  AppRingBenchReader (const char* pszName_p, bool fStall_p, std::atomic<uint>* puiReady_p, std::atomic<bool>* pfStop_p, tAppReaderStat* pReaderStat_p);
+static  void  AppSigHandler (int iSignalNum_p);
+
+static  int   AppDecodeCaptures (void);
+static  int   AppCaptureWriteMessage (const tJsonMessage* pJsonMessage_p, void* pArg_p);
+static  int   AppRunCaptureBench (void);
+static  int   AppLoadCaptures (void);
+static  int   AppWriteSynthCapture (void);
+
+static  void      AppPrintBanner (void);
+static  uint64_t  AppGetFileSize (const char* pszFileName_p);
+static  double    AppGetTime (void);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Main function of this application
+//---------------------------------------------------------------------------
+
+int  main (int iArgCnt_p, char* apszArg_p[])
+{
+
+int   iRes;
+bool  fRes;
+
+
+    // evaluate Command Line Arguments
+    uiThreads_l = std::thread::hardware_concurrency();
+    fRes = AppEvalCmdlnArgs(iArgCnt_p, apszArg_p);
+    if ( !fRes )
+    {
+        AppPrintHelpScreen(apszArg_p[0]);
+        return (-1);
+    }
+    if (uiThreads_l == 0)
+    {
+        uiThreads_l = 1;
+    }
+
+    if (uiBenchRecords_l > 0)
+    {
+        iRes = AppRunBenchmark();
+    }
+    else if (uiRotBenchRecords_l > 0)
+    {
+        iRes = AppRunRotationBench();
+    }
+    else if (uiTssBenchRecords_l > 0)
+    {
+        iRes = AppRunStoreBench();
+    }
+    else if (uiLvcBenchClients_l > 0)
+    {
+        iRes = AppRunCacheBench();
+    }
+    else if (uiSrgBenchReaders_l > 0)
+    {
+        iRes = AppRunRingBench();
+    }
+    else if (pszShmRingName_l != NULL)
+    {
+        iRes = AppFollowRing();
+    }
+    else if (uiSynthSizeMB_l > 0)
+    {
+        iRes = AppWriteSynthLog();
+    }
+    else if (uiSynthCapDays_l > 0)
+    {
+        iRes = AppWriteSynthCapture();
+    }
+    else if ( fCapBench_l )
+    {
+        iRes = AppRunCaptureBench();
+    }
+    else if (pszCapOutputFile_l != NULL)
+    {
+        iRes = AppDecodeCaptures();
+    }
+    else if ((pszStoreFile_l != NULL) && vecMsgLogFiles_l.empty())
+    {
+        iRes = AppQueryStore();
+    }
+    else if (pszStoreFile_l != NULL)
+    {
+        iRes = AppImportStore();
+    }
+    else if ( fQueryBench_l )
+    {
+        iRes = AppRunQueryBench();
+    }
+    else
+    {
+        iRes = AppRunQuery(NULL);
+    }
+
+    return ((iRes < 0) ? -1 : 0);
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Evaluate command line arguments
+//---------------------------------------------------------------------------
+
+static  bool  AppEvalCmdlnArgs (
+    int iArgCnt_p,
+    char* apszArg_p[])
+{
+
+tTssField  Field;
+char*      pszArg;
+char*      pszSubArg;
+int        iIdx;
+bool       fRes;
+
+
+    fRes = true;
+
+    for (iIdx=1; iIdx<iArgCnt_p; iIdx++)
+    {
+        pszArg = apszArg_p[iIdx];
+        if (pszArg != NULL)
+        {
+            // argument '-f=' -> Output Format
+            if ( !strncasecmp("-f=", pszArg, sizeof("-f=")-1) )
+            {
+                pszArg += sizeof("-f=")-1;
+                if ( !strcasecmp("json", pszArg) )
+                {
+                    OutputFormat_l = kAppOutputJson;
+                }
+                else if ( !strcasecmp("line", pszArg) )
+                {
+                    OutputFormat_l = kAppOutputLine;
+                }
+                else if ( !strcasecmp("csv", pszArg) )
+                {
+                    OutputFormat_l = kAppOutputCsv;
+                }
+                else
+                {
+                    printf("\nERROR: invalid output format!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-o=' -> Output File
+            if ( !strncasecmp("-o=", pszArg, sizeof("-o=")-1) )
+            {
+                pszArg += sizeof("-o=")-1;
+                pszOutputFile_l = pszArg;
+                continue;
+            }
+
+            // argument '-d=' -> Query: DevID
+            if ( !strncasecmp("-d=", pszArg, sizeof("-d=")-1) )
+            {
+                pszArg += sizeof("-d=")-1;
+                iQueryDevID_l = atoi(pszArg);
+                if ((iQueryDevID_l < 0) || (iQueryDevID_l > 255))
+                {
+                    printf("\nERROR: invalid DevID!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-t=' -> Query: Time Range ('from[,to]')
+            if ( !strncasecmp("-t=", pszArg, sizeof("-t=")-1) )
+            {
+                pszArg += sizeof("-t=")-1;
+                pszSubArg = strchr(pszArg, ',');
+                if (pszSubArg != NULL)
+                {
+                    *pszSubArg++ = '\0';
+                    fRes = AppParseTime(pszSubArg, true, &i64QueryToTime_l);
+                }
+                if ( fRes )
+                {
+                    fRes = AppParseTime(pszArg, false, &i64QueryFromTime_l);
+                }
+                if ( !fRes || (i64QueryFromTime_l > i64QueryToTime_l) )
+                {
+                    printf("\nERROR: invalid time range!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-n' -> don't use Index
+            if ( !strcasecmp("-n", pszArg) )
+            {
+                fUseIndex_l = false;
+                continue;
+            }
+
+            // argument '-j=' -> Worker Threads
+            if ( !strncasecmp("-j=", pszArg, sizeof("-j=")-1) )
+            {
+                pszArg += sizeof("-j=")-1;
+                uiThreads_l = (uint)atoi(pszArg);
+                if ((uiThreads_l == 0) || (uiThreads_l > 256))
+                {
+                    printf("\nERROR: invalid number of threads!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-v' -> Verbose (Query Statistics)
+            if ( !strcasecmp("-v", pszArg) )
+            {
+                fVerbose_l = true;
+                continue;
+            }
+
+            // argument '-g=' -> write synthetic Log ('size_mb[,json]')
+            if ( !strncasecmp("-g=", pszArg, sizeof("-g=")-1) )
+            {
+                pszArg += sizeof("-g=")-1;
+                pszSubArg = strchr(pszArg, ',');
+                if (pszSubArg != NULL)
+                {
+                    *pszSubArg++ = '\0';
+                    if ( !strcasecmp("json", pszSubArg) )
+                    {
+                        SynthFormat_l = kMfwFormatJson;
+                    }
+                    else if ( strcasecmp("bin", pszSubArg) )
+                    {
+                        printf("\nERROR: invalid log format!\n");
+                        fRes = false;
+                        break;
+                    }
+                }
+                uiSynthSizeMB_l = (uint)atoi(pszArg);
+                if (uiSynthSizeMB_l == 0)
+                {
+                    printf("\nERROR: invalid log size!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-b=' -> Benchmark
+            if ( !strncasecmp("-b", pszArg, sizeof("-b")-1) )
+            {
+                pszArg += sizeof("-b")-1;
+                uiBenchRecords_l = APP_DEF_BENCH_RECORDS;
+                if (*pszArg == '=')
+                {
+                    uiBenchRecords_l = (uint)atoi(pszArg+1);
+                }
+                if (uiBenchRecords_l == 0)
+                {
+                    printf("\nERROR: invalid number of records!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-r=' -> Rotation Benchmark ('records[,bin]')
+            if ( !strncasecmp("-r", pszArg, sizeof("-r")-1) )
+            {
+                pszArg += sizeof("-r")-1;
+                uiRotBenchRecords_l = APP_DEF_ROT_RECORDS;
+                if (*pszArg == '=')
+                {
+                    pszArg++;
+                    pszSubArg = strchr(pszArg, ',');
+                    if (pszSubArg != NULL)
+                    {
+                        *pszSubArg++ = '\0';
+                        if ( !strcasecmp("bin", pszSubArg) )
+                        {
+                            RotBenchFormat_l = kMfwFormatBinary;
+                        }
+                        else if ( strcasecmp("json", pszSubArg) )
+                        {
+                            printf("\nERROR: invalid log format!\n");
+                            fRes = false;
+                            break;
+                        }
+                    }
+                    if (*pszArg != '\0')
+                    {
+                        uiRotBenchRecords_l = (uint)atoi(pszArg);
+                    }
+                }
+                if (uiRotBenchRecords_l < APP_ROT_SEGMENTS)
+                {
+                    printf("\nERROR: invalid number of records!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-y=' -> Time Series Store (import MessageFiles or query)
+            if ( !strncasecmp("-y=", pszArg, sizeof("-y=")-1) )
+            {
+                pszArg += sizeof("-y=")-1;
+                pszStoreFile_l = pszArg;
+                continue;
+            }
+
+            // argument '-e=' -> Field of Time Series Store
+            if ( !strncasecmp("-e=", pszArg, sizeof("-e=")-1) )
+            {
+                pszArg += sizeof("-e=")-1;
+                if ( !TssGetFieldByName(pszArg, &Field) )
+                {
+                    printf("\nERROR: invalid field!\n");
+                    fRes = false;
+                    break;
+                }
+                iStoreField_l = (int)Field;
+                continue;
+            }
+
+            // argument '-a=' -> Aggregation Level of Time Series Store
+            if ( !strncasecmp("-a=", pszArg, sizeof("-a=")-1) )
+            {
+                pszArg += sizeof("-a=")-1;
+                if ( !strcasecmp("raw", pszArg) )
+                {
+                    StoreLevel_l = kTssLevelRaw;
+                }
+                else if ( !strcasecmp("min", pszArg) )
+                {
+                    StoreLevel_l = kTssLevelMinute;
+                }
+                else if ( !strcasecmp("hour", pszArg) )
+                {
+                    StoreLevel_l = kTssLevelHour;
+                }
+                else if ( !strcasecmp("day", pszArg) )
+                {
+                    StoreLevel_l = kTssLevelDay;
+                }
+                else
+                {
+                    printf("\nERROR: invalid aggregation level!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-x=' -> Time Series Store Benchmark
+            if ( !strncasecmp("-x", pszArg, sizeof("-x")-1) )
+            {
+                pszArg += sizeof("-x")-1;
+                uiTssBenchRecords_l = APP_DEF_TSS_RECORDS;
+                if (*pszArg == '=')
+                {
+                    uiTssBenchRecords_l = (uint)atoi(pszArg+1);
+                }
+                if (uiTssBenchRecords_l <= APP_SYNTH_DEVICES)
+                {
+                    printf("\nERROR: invalid number of records!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-u=' -> Query API Benchmark
+            if ( !strncasecmp("-u", pszArg, sizeof("-u")-1) )
+            {
+                pszArg += sizeof("-u")-1;
+                uiLvcBenchClients_l = APP_DEF_LVC_CLIENTS;
+                if (*pszArg == '=')
+                {
+                    uiLvcBenchClients_l = (uint)atoi(pszArg+1);
+                }
+                if ((uiLvcBenchClients_l == 0) || (uiLvcBenchClients_l > LVC_MAX_CONNECTIONS))
+                {
+                    printf("\nERROR: invalid number of clients!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-s' -> follow Shared Memory Ring ('[name]')
+            if ( !strncasecmp("-s", pszArg, sizeof("-s")-1) )
+            {
+                pszArg += sizeof("-s")-1;
+                pszShmRingName_l = SRF_DEF_NAME;
+                if (*pszArg == '=')
+                {
+                    pszShmRingName_l = pszArg + 1;
+                }
+                if (pszShmRingName_l[0] != '/')
+                {
+                    printf("\nERROR: invalid name of shared memory ring!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-w=' -> Shared Memory Ring Benchmark
+            if ( !strncasecmp("-w", pszArg, sizeof("-w")-1) )
+            {
+                pszArg += sizeof("-w")-1;
+                uiSrgBenchReaders_l = APP_DEF_SRG_READERS;
+                if (*pszArg == '=')
+                {
+                    uiSrgBenchReaders_l = (uint)atoi(pszArg+1);
+                }
+                if ((uiSrgBenchReaders_l == 0) || (uiSrgBenchReaders_l > 64))
+                {
+                    printf("\nERROR: invalid number of readers!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-c=' -> re-decode CaptureFiles into MessageFile ('msg_file[,bin]')
+            if ( !strncasecmp("-c=", pszArg, sizeof("-c=")-1) )
+            {
+                pszArg += sizeof("-c=")-1;
+                pszSubArg = strchr(pszArg, ',');
+                if (pszSubArg != NULL)
+                {
+                    *pszSubArg++ = '\0';
+                    if ( !strcasecmp("bin", pszSubArg) )
+                    {
+                        CapOutputFormat_l = kMfwFormatBinary;
+                    }
+                    else if ( strcasecmp("json", pszSubArg) )
+                    {
+                        printf("\nERROR: invalid log format!\n");
+                        fRes = false;
+                        break;
+                    }
+                }
+                if (*pszArg == '\0')
+                {
+                    printf("\nERROR: invalid MessageFile!\n");
+                    fRes = false;
+                    break;
+                }
+                pszCapOutputFile_l = pszArg;
+                continue;
+            }
+
+            // argument '-p' -> Scaling of Re-Decoding of CaptureFiles
+            if ( !strcasecmp("-p", pszArg) )
+            {
+                fCapBench_l = true;
+                continue;
+            }
+
+            // argument '-q' -> Query Benchmark
+            if ( !strcasecmp("-q", pszArg) )
+            {
+                fQueryBench_l = true;
+                continue;
+            }
+
+            // argument '-k=' -> write synthetic CaptureFile ('days[,devices]')
+            if ( !strncasecmp("-k=", pszArg, sizeof("-k=")-1) )
+            {
+                pszArg += sizeof("-k=")-1;
+                pszSubArg = strchr(pszArg, ',');
+                if (pszSubArg != NULL)
+                {
+                    *pszSubArg++ = '\0';
+                    uiSynthCapDevices_l = (uint)atoi(pszSubArg);
+                }
+                uiSynthCapDays_l = (uint)atoi(pszArg);
+                if ((uiSynthCapDays_l == 0) || (uiSynthCapDays_l > 3660) ||
+                    (uiSynthCapDevices_l == 0) || (uiSynthCapDevices_l > CPD_SYNTH_MAX_DEVICES))
+                {
+                    printf("\nERROR: invalid capture size!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // arguments without '-' -> MessageFiles (CaptureFiles for '-c', '-p', '-k')
+            if (*pszArg != '-')
+            {
+                vecMsgLogFiles_l.push_back(pszArg);
+                continue;
+            }
+        }
+
+        fRes = false;
+    }
+
+    if ((uiBenchRecords_l == 0) && (uiRotBenchRecords_l == 0) && (uiTssBenchRecords_l == 0) &&
+        (uiLvcBenchClients_l == 0) && (uiSrgBenchReaders_l == 0) && (pszShmRingName_l == NULL) &&
+        (pszStoreFile_l == NULL) && vecMsgLogFiles_l.empty())
+    {
+        fRes = false;
+    }
+    if (((uiSynthSizeMB_l > 0) || (uiSynthCapDays_l > 0)) && (vecMsgLogFiles_l.size() != 1))
+    {
+        fRes = false;
+    }
+
+    return (fRes);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Show Help Screen
+//---------------------------------------------------------------------------
+
+static  void  AppPrintHelpScreen (
+    const char* pszArg0_p)
+{
+
+    AppPrintBanner();
+
+    //     |    10   |    20   |    30   |    40   |    50   |    60   |    70   |    80   |
+    printf("Usage:\n");
+    printf("   %s [OPTION] <msg_file> [<msg_file> ...]\n", pszArg0_p);
+    printf("   %s -g=<size_mb>[,json] <msg_file>\n", pszArg0_p);
+    printf("   %s -b[=<records>] [<bench_file>]\n", pszArg0_p);
+    printf("   %s -r[=<records>][,bin] [<bench_file>]\n", pszArg0_p);
+    printf("   %s -y=<store_file> [-d=..] [-t=..] <msg_file> [<msg_file> ...]\n", pszArg0_p);
+    printf("   %s -y=<store_file> [-e=<field>] [-a=<level>] [-d=..] [-t=..] [-o=..]\n", pszArg0_p);
+    printf("   %s -x[=<records>] [<bench_file>]\n", pszArg0_p);
+    printf("   %s -u[=<clients>]\n", pszArg0_p);
+    printf("   %s -s[=<shm_name>] [-f=..] [-d=..] [-v]\n", pszArg0_p);
+    printf("   %s -w[=<readers>]\n", pszArg0_p);
+    printf("   %s -c=<msg_file>[,bin] [-j=..] <cap_file> [<cap_file> ...]\n", pszArg0_p);
+    printf("   %s -p [-j=..] <cap_file> [<cap_file> ...]\n", pszArg0_p);
+    printf("   %s -k=<days>[,<devices>] <cap_file>\n", pszArg0_p);
+    printf("   %s -q [-d=..] [-t=..] [-j=..] <msg_file> [<msg_file> ...]\n", pszArg0_p);
+    printf("   OPTION:\n");
+    printf("\n");
+    printf("       <msg_file>      MessageFile written by 'LoraPacketRecv -l=<file>[,bin]', several\n");
+    printf("                       files (e.g. rotated ones) are scanned in parallel and\n");
+    printf("                       output in the given order\n");
+    printf("\n");
+    printf("       -f=<format>     Output Format: 'json' (same as the Json MessageFile),\n");
+    printf("                       'line' (InfluxDB Line Protocol) or 'csv' (default: json),\n");
+    printf("                       Json MessageFiles can only be output as 'json'\n");
+    printf("\n");
+    printf("       -o=<file>       Output File (default: stdout)\n");
+    printf("\n");
+    printf("       -d=<dev_id>     Output only the records of this DevID\n");
+    printf("\n");
+    printf("       -t=<from>[,<to>]  Output only the records of this time range (local time,\n");
+    printf("                       'YYYY/MM/DD[-hh:mm[:ss]]' or seconds since 1970, a date\n");
+    printf("                       without time as <to> includes the whole day)\n");
+    printf("\n");
+    printf("       -n              Don't use the Index '<msg_file>%s' (scan all records)\n", MIX_FILE_EXTENSION);
+    printf("\n");
+    printf("       -j=<threads>    Number of Worker Threads (default: number of cores)\n");
+    printf("\n");
+    printf("       -v              Print Query Statistics to stderr\n");
+    printf("\n");
+    printf("       -g=<size_mb>[,json]  Append synthetic records (%u devices) with Index to\n", APP_SYNTH_DEVICES);
+    printf("                       <msg_file> until it has the given size (default: binary)\n");
+    printf("\n");
+    printf("       -b[=<records>]  Compare writing and scanning of Json MessageFile and binary\n");
+    printf("                       MessageLog with synthetic records (default: %u), the\n", APP_DEF_BENCH_RECORDS);
+    printf("                       files '<bench_file>.json/.bin' are created and removed\n");
+    printf("                       again (default: '%s')\n", APP_DEF_BENCH_FILE);
+    printf("\n");
+    printf("       -r[=<records>][,bin]  Measure write rate and rotation time of the MessageFile\n");
+    printf("                       (default: %u records, json) without rotation, with %u\n", APP_DEF_ROT_RECORDS, APP_ROT_SEGMENTS);
+    printf("                       rotations and with rotations plus background compression,\n");
+    printf("                       in the directory '<bench_file>_rot' (removed again)\n");
+    printf("\n");
+    printf("       -y=<store_file> Time Series Store: add the Data Records of the MessageFiles\n");
+    printf("                       (rebuild of the store of 'LoraPacketRecv -y=<file>'), or\n");
+    printf("                       without MessageFiles output its points/rollups as CSV\n");
+    printf("\n");
+    printf("       -e=<field>      Output only this field (e.g. 'Temperature', default: all)\n");
+    printf("\n");
+    printf("       -a=<level>      Output Level: 'raw' (points), 'min', 'hour' or 'day'\n");
+    printf("                       (buckets with min/max/mean/count, default: hour)\n");
+    printf("\n");
+    printf("       -x[=<records>]  Measure ingest rate, size and range queries of the Time\n");
+    printf("                       Series Store with synthetic records (default: %u),\n", APP_DEF_TSS_RECORDS);
+    printf("                       the file '<bench_file>.tss' is created and removed again\n");
+    printf("\n");
+    printf("       -u[=<clients>]  Measure request rate and latency of the HTTP Query API of\n");
+    printf("                       'LoraPacketRecv -q' with polling clients (default: %u),\n", APP_DEF_LVC_CLIENTS);
+    printf("                       without and with ingest at full rate\n");
+    printf("\n");
+    printf("       -s[=<shm_name>] Output the records of the Shared Memory Ring of\n");
+    printf("                       'LoraPacketRecv -x' as they arrive (default: '%s'),\n", SRF_DEF_NAME);
+    printf("                       until Ctrl+C\n");
+    printf("\n");
+    printf("       -w[=<readers>]  Measure latency and losses of the Shared Memory Ring with\n");
+    printf("                       reader threads (default: %u), paced and at full rate\n", APP_DEF_SRG_READERS);
+    printf("\n");
+    printf("       -c=<msg_file>[,bin]  Re-decode the raw frames of CaptureFiles written by\n");
+    printf("                       'LoraPacketRecv -c=<file>' into a new MessageFile (same\n");
+    printf("                       deduplication and decoding as the gateway, partitioned by\n");
+    printf("                       DevID and decoded in parallel, MsgID = frame number)\n");
+    printf("\n");
+    printf("       -p              Measure scaling of re-decoding the CaptureFiles with 1, 2,\n");
+    printf("                       4, ... up to <threads> (option '-j=') worker threads and\n");
+    printf("                       check that all runs give identical output\n");
+    printf("\n");
+    printf("       -k=<days>[,<devices>]  Write synthetic CaptureFile with raw frames of\n");
+    printf("                       several radios (default: %u devices)\n", CPD_SYNTH_MAX_DEVICES);
+    printf("\n");
+    printf("       -q              Measure speed-up of the query (options '-d=' and '-t=')\n");
+    printf("                       by the Index and by 1, 2, 4, ... up to <threads> (option\n");
+    printf("                       '-j=') worker threads and check that all runs give\n");
+    printf("                       identical output\n");
+    printf("\n");
+    printf("       --help          Shows this Help Screen\n");
+    printf("\n");
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Parse Time of Query (option '-t=')
+//---------------------------------------------------------------------------
+
+static  bool  AppParseTime (
+    const char* pszTime_p,
+    bool fEndOfDay_p,
+    int64_t* pi64Time_p)
+{
+
+struct tm    TimeInfo;
+const char*  pszEnd;
+char*        pszNumEnd;
+long long    llSeconds;
+
+
+    if (*pszTime_p == '\0')
+    {
+        return (false);
+    }
+
+    // seconds since 1970
+    if (strchr(pszTime_p, '/') == NULL)
+    {
+        llSeconds = strtoll(pszTime_p, &pszNumEnd, 10);
+        if (*pszNumEnd != '\0')
+        {
+            return (false);
+        }
+        *pi64Time_p = (int64_t)llSeconds;
+        return (true);
+    }
+
+    // 'YYYY/MM/DD[-hh:mm[:ss]]' in local time
+    memset(&TimeInfo, 0, sizeof(TimeInfo));
+    pszEnd = strptime(pszTime_p, "%Y/%m/%d", &TimeInfo);
+    if (pszEnd == NULL)
+    {
+        return (false);
+    }
+    if (*pszEnd == '\0')
+    {
+        if ( fEndOfDay_p )
+        {
+            TimeInfo.tm_hour = 23;
+            TimeInfo.tm_min  = 59;
+            TimeInfo.tm_sec  = 59;
+        }
+    }
+    else
+    {
+        pszEnd = strptime(pszEnd, "-%H:%M", &TimeInfo);
+        if ((pszEnd != NULL) && (*pszEnd == ':'))
+        {
+            pszEnd = strptime(pszEnd, ":%S", &TimeInfo);
+        }
+        if ((pszEnd == NULL) || (*pszEnd != '\0'))
+        {
+            return (false);
+        }
+    }
+
+    TimeInfo.tm_isdst = -1;
+    *pi64Time_p = (int64_t)mktime(&TimeInfo);
+
+    return (true);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Query/Convert MessageFiles
+//---------------------------------------------------------------------------
+//  For each file only the blocks whose index entry matches the query are
+//  scanned, ranges not covered by the index are scanned completely. All
+//  ranges of all files are distributed to the worker threads in batches,
+//  the results of each batch are written in file order. Damaged records
+//  (e.g. torn by a power failure) are skipped and only counted.
+//  With <pQueryStat_p> the output isn't written, but only its digest is
+//  returned together with the statistics (Query Benchmark).
+
+static  int  AppRunQuery (
+    tAppQueryStat* pQueryStat_p)
+{
+
+std::vector<std::thread>  vecThreads;
+std::vector<tMixEntry>    vecMixEntries;
+tAppQueryStat  QueryStat;
+FILE*          pOutputFile;
+tAppMsgFile*   pMsgFile;
+tAppScanItem*  pScanItem;
+std::string    strCsvHeader;
+uLong          ulDigest;
+uint64_t       ui64DataStart;
+uint64_t       ui64DataEnd;
+uint64_t       ui64Pos;
+double         dStartTime;
+size_t         nBatchStart;
+size_t         nIdx;
+uint           uiFile;
+uint           uiThread;
+int            iRes;
+
+
+    dStartTime = AppGetTime();
+    memset(&QueryStat, 0, sizeof(QueryStat));
+    vecScanItems_l.clear();
+
+    // open all files
+    vecMsgFiles_l.resize(vecMsgLogFiles_l.size());
+    for (uiFile=0; uiFile<vecMsgLogFiles_l.size(); uiFile++)
+    {
+        iRes = AppOpenMsgFile(vecMsgLogFiles_l[uiFile], &vecMsgFiles_l[uiFile]);
+        if (iRes < 0)
+        {
+            fprintf(stderr, "ERROR: can't open MessageFile '%s' (iRes=%d)!\n", vecMsgLogFiles_l[uiFile], iRes);
+            for (nIdx=0; nIdx<uiFile; nIdx++)
+            {
+                AppCloseMsgFile(&vecMsgFiles_l[nIdx]);
+            }
+            return (-1);
+        }
+        if ( !vecMsgFiles_l[uiFile].m_fBinary && (OutputFormat_l != kAppOutputJson) )
+        {
+            fprintf(stderr, "ERROR: Json MessageFile '%s' can only be output as 'json'!\n", vecMsgLogFiles_l[uiFile]);
+            for (nIdx=0; nIdx<=uiFile; nIdx++)
+            {
+                AppCloseMsgFile(&vecMsgFiles_l[nIdx]);
+            }
+            return (-2);
+        }
+    }
+
+    // select the ranges to scan
+    for (uiFile=0; uiFile<vecMsgFiles_l.size(); uiFile++)
+    {
+        pMsgFile = &vecMsgFiles_l[uiFile];
+        if ( pMsgFile->m_fBinary )
+        {
+            ui64DataStart = MLF_HEADER_SIZE;
+            ui64DataEnd   = MLF_HEADER_SIZE + (MlrGetNumRecords(&pMsgFile->m_MlrLog) * MLF_RECORD_SIZE);
+        }
+        else
+        {
+            ui64DataStart = 0;
+            ui64DataEnd   = pMsgFile->m_nMapSize;
+        }
+        QueryStat.m_ui64BytesTotal += ui64DataEnd - ui64DataStart;
+
+        vecMixEntries.clear();
+        if ( fUseIndex_l )
+        {
+            MixLoad(MixGetIndexFileName(pMsgFile->m_pszFileName).c_str(), ui64DataEnd, &vecMixEntries);
+        }
+
+        ui64Pos = ui64DataStart;
+        for (nIdx=0; nIdx<vecMixEntries.size(); nIdx++)
+        {
+            if ( (vecMixEntries[nIdx].m_ui64Offset < ui64Pos) ||
+                 (pMsgFile->m_fBinary && (((vecMixEntries[nIdx].m_ui64Offset - MLF_HEADER_SIZE) % MLF_RECORD_SIZE) != 0)) ||
+                 (pMsgFile->m_fBinary && ((vecMixEntries[nIdx].m_ui32Length % MLF_RECORD_SIZE) != 0)) )
+            {
+                continue;                               // doesn't fit to this file, covered by full scan
+            }
+            QueryStat.m_uiIndexEntries++;
+            AppAddScanRange(uiFile, ui64Pos, vecMixEntries[nIdx].m_ui64Offset);
+            if ( MixEntryMatches(&vecMixEntries[nIdx], iQueryDevID_l, i64QueryFromTime_l, i64QueryToTime_l) )
+            {
+                QueryStat.m_uiIndexMatches++;
+                AppAddScanItem(uiFile, vecMixEntries[nIdx].m_ui64Offset, vecMixEntries[nIdx].m_ui32Length, true);
+            }
+            ui64Pos = vecMixEntries[nIdx].m_ui64Offset + vecMixEntries[nIdx].m_ui32Length;
+        }
+        AppAddScanRange(uiFile, ui64Pos, ui64DataEnd);
+    }
+
+    // scan the ranges and write the result
+    pOutputFile = stdout;
+    if (pQueryStat_p != NULL)
+    {
+        pOutputFile = NULL;
+    }
+    else if (pszOutputFile_l != NULL)
+    {
+        pOutputFile = fopen(pszOutputFile_l, "w");
+        if (pOutputFile == NULL)
+        {
+            fprintf(stderr, "ERROR: can't create output file '%s'!\n", pszOutputFile_l);
+            for (uiFile=0; uiFile<vecMsgFiles_l.size(); uiFile++)
+            {
+                AppCloseMsgFile(&vecMsgFiles_l[uiFile]);
+            }
+            return (-3);
+        }
+    }
+
+    ulDigest = crc32(0L, Z_NULL, 0);
+    if (OutputFormat_l == kAppOutputCsv)
+    {
+        strCsvHeader = PprBuildCsvHeader() + "\n";
+        if (pOutputFile != NULL)
+        {
+            fwrite(strCsvHeader.c_str(), 1, strCsvHeader.length(), pOutputFile);
+        }
+        ulDigest = crc32(ulDigest, (const Bytef*)strCsvHeader.c_str(), strCsvHeader.length());
+    }
+
+    QueryStat.m_uiFiles     = (uint)vecMsgFiles_l.size();
+    QueryStat.m_uiScanItems = (uint)vecScanItems_l.size();
+    for (nBatchStart=0; nBatchStart<vecScanItems_l.size(); nBatchStart=nBatchEnd_l)
+    {
+        nBatchEnd_l = nBatchStart + (APP_SCAN_BATCH_ITEMS * uiThreads_l);
+        if (nBatchEnd_l > vecScanItems_l.size())
+        {
+            nBatchEnd_l = vecScanItems_l.size();
+        }
+
+        nNextScanItem_l = nBatchStart;
+        vecThreads.clear();
+        for (uiThread=1; uiThread<uiThreads_l; uiThread++)
+        {
+            vecThreads.push_back(std::thread(AppWorkerThread));
+        }
+        AppWorkerThread();
+        for (uiThread=0; uiThread<vecThreads.size(); uiThread++)
+        {
+            vecThreads[uiThread].join();
+        }
+
+        for (nIdx=nBatchStart; nIdx<nBatchEnd_l; nIdx++)
+        {
+            pScanItem = &vecScanItems_l[nIdx];
+            if (pOutputFile != NULL)
+            {
+                fwrite(pScanItem->m_strOutput.c_str(), 1, pScanItem->m_strOutput.length(), pOutputFile);
+            }
+            else
+            {
+                ulDigest = crc32(ulDigest, (const Bytef*)pScanItem->m_strOutput.c_str(), pScanItem->m_strOutput.length());
+            }
+            std::string().swap(pScanItem->m_strOutput);
+
+            QueryStat.m_ui64BytesScanned += pScanItem->m_ui64Length;
+            QueryStat.m_ui64Records      += pScanItem->m_uiRecords;
+            QueryStat.m_ui64Matches      += pScanItem->m_uiMatches;
+            QueryStat.m_ui64Damaged      += pScanItem->m_uiDamaged;
+        }
+    }
+
+    if ((pOutputFile != NULL) && (pOutputFile != stdout))
+    {
+        fclose(pOutputFile);
+    }
+    for (uiFile=0; uiFile<vecMsgFiles_l.size(); uiFile++)
+    {
+        AppCloseMsgFile(&vecMsgFiles_l[uiFile]);
+    }
+    QueryStat.m_ui32Digest = (uint32_t)ulDigest;
+    QueryStat.m_dRuntime   = AppGetTime() - dStartTime;
+
+    if (QueryStat.m_ui64Damaged > 0)
+    {
+        fprintf(stderr, "WARNING: %llu of %llu records damaged and skipped!\n", (unsigned long long)QueryStat.m_ui64Damaged, (unsigned long long)QueryStat.m_ui64Records);
+    }
+
+    if ( fVerbose_l )
+    {
+        fprintf(stderr, "Query Statistics:\n");
+        fprintf(stderr, "  Files:           %u (%.1f MB)\n", QueryStat.m_uiFiles, (double)QueryStat.m_ui64BytesTotal / (1024.0 * 1024.0));
+        fprintf(stderr, "  Index Entries:   %u, matching: %u\n", QueryStat.m_uiIndexEntries, QueryStat.m_uiIndexMatches);
+        fprintf(stderr, "  Scanned:         %.1f MB in %u ranges (%u threads)\n", (double)QueryStat.m_ui64BytesScanned / (1024.0 * 1024.0), QueryStat.m_uiScanItems, uiThreads_l);
+        fprintf(stderr, "  Records:         %llu scanned, %llu matching\n", (unsigned long long)QueryStat.m_ui64Records, (unsigned long long)QueryStat.m_ui64Matches);
+        fprintf(stderr, "  Runtime:         %.3f [sec]\n", QueryStat.m_dRuntime);
+    }
+
+    if (pQueryStat_p != NULL)
+    {
+        *pQueryStat_p = QueryStat;
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Speed-up of Queries by Index and Worker Threads (option '-q')
+//---------------------------------------------------------------------------
+//  The query is run without and with Index, each with 1, 2, 4, ... worker
+//  threads (up to '-j='). The output isn't written, but each run has to
+//  give the same digest as the full scan with one thread. A first run that
+//  is not measured loads the files into the page cache, so that the runs
+//  compare the scanning and not the disk.
+
+static  int  AppRunQueryBench (void)
+{
+
+tAppQueryStat      QueryStat;
+std::vector<uint>  vecThreads;
+char         szFromTime[32];
+char         szToTime[32];
+uint32_t     ui32RefDigest;
+double       dRefTime;
+uint         uiIdx;
+uint         uiRun;
+bool         fMismatch;
+int          iRes;
+
+
+    AppPrintBanner();
+
+    if ( vecMsgLogFiles_l.empty() )
+    {
+        printf("ERROR: no MessageFile given!\n");
+        return (-1);
+    }
+
+    for (uiRun=1; uiRun<uiThreads_l; uiRun*=2)
+    {
+        vecThreads.push_back(uiRun);
+    }
+    vecThreads.push_back(uiThreads_l);
+
+    strcpy(szFromTime, "any");
+    strcpy(szToTime, "any");
+    if (i64QueryFromTime_l != INT64_MIN)
+    {
+        AppFormatTime(i64QueryFromTime_l, szFromTime, sizeof(szFromTime));
+    }
+    if (i64QueryToTime_l != INT64_MAX)
+    {
+        AppFormatTime(i64QueryToTime_l, szToTime, sizeof(szToTime));
+    }
+    printf("Query: DevID=%d, Time=%s .. %s, %u MessageFile(s)\n\n", iQueryDevID_l,
+           szFromTime, szToTime, (uint)vecMsgLogFiles_l.size());
+
+    fUseIndex_l = false;
+    iRes = AppRunQuery(&QueryStat);
+    if (iRes < 0)
+    {
+        return (-2);
+    }
+
+    printf("Index  Threads  Runtime [sec]  Scanned [MB]  Scan [MB/s]  Matches    Speedup  Digest\n");
+    printf("-----  -------  -------------  ------------  -----------  ---------  -------  -------------\n");
+    ui32RefDigest = 0;
+    dRefTime  = 0;
+    fMismatch = false;
+    // uiIdx=0: without Index (full scan), uiIdx=1: with Index
+    for (uiIdx=0; uiIdx<2; uiIdx++)
+    {
+        fUseIndex_l = (uiIdx > 0);
+        for (uiRun=0; uiRun<vecThreads.size(); uiRun++)
+        {
+            uiThreads_l = vecThreads[uiRun];
+            iRes = AppRunQuery(&QueryStat);
+            if (iRes < 0)
+            {
+                return (-2);
+            }
+
+            if ((uiIdx == 0) && (uiRun == 0))
+            {
+                ui32RefDigest = QueryStat.m_ui32Digest;
+                dRefTime = QueryStat.m_dRuntime;
+            }
+            if (QueryStat.m_ui32Digest != ui32RefDigest)
+            {
+                fMismatch = true;
+            }
+            printf("%-5s  %7u  %13.3f  %12.1f  %11.1f  %9llu  %6.1fx  %08X %s\n",
+                   (fUseIndex_l ? "yes" : "no"), uiThreads_l, QueryStat.m_dRuntime,
+                   (double)QueryStat.m_ui64BytesScanned / (1024.0 * 1024.0),
+                   ((double)QueryStat.m_ui64BytesScanned / (1024.0 * 1024.0)) / QueryStat.m_dRuntime,
+                   (unsigned long long)QueryStat.m_ui64Matches, dRefTime / QueryStat.m_dRuntime,
+                   QueryStat.m_ui32Digest, ((QueryStat.m_ui32Digest == ui32RefDigest) ? "ok" : "ERR"));
+        }
+    }
+
+    printf("\n");
+    printf("%.1f MB in %u file(s), Index Entries: %u, matching: %u\n",
+           (double)QueryStat.m_ui64BytesTotal / (1024.0 * 1024.0), QueryStat.m_uiFiles,
+           QueryStat.m_uiIndexEntries, QueryStat.m_uiIndexMatches);
+    printf("Cores: %u, Output: %s\n", std::thread::hardware_concurrency(), (fMismatch ? "DIFFERENT for some runs!" : "identical for all runs"));
+    printf("\n");
+
+    return (fMismatch ? -3 : 0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Open MessageFile for scanning
+//---------------------------------------------------------------------------
+//  A file starting with the MessageLog magic is read as binary MessageLog,
+//  all others as Json MessageFile.
+
+static  int  AppOpenMsgFile (
+    const char* pszFileName_p,
+    tAppMsgFile* pMsgFile_p)
+{
+
+char         achMagic[sizeof(MLF_FILE_MAGIC)];
+struct stat  FileStat;
+void*        pMapAddr;
+int          iRes;
+
+
+    pMsgFile_p->m_pszFileName = pszFileName_p;
+    pMsgFile_p->m_fBinary     = false;
+    pMsgFile_p->m_iFd         = -1;
+    pMsgFile_p->m_pabMapAddr  = NULL;
+    pMsgFile_p->m_nMapSize    = 0;
+    memset(&pMsgFile_p->m_MlrLog, 0, sizeof(pMsgFile_p->m_MlrLog));
+    pMsgFile_p->m_MlrLog.m_iFd = -1;
+
+    pMsgFile_p->m_iFd = open(pszFileName_p, O_RDONLY);
+    if (pMsgFile_p->m_iFd < 0)
+    {
+        return (-1);
+    }
+    if (fstat(pMsgFile_p->m_iFd, &FileStat) != 0)
+    {
+        AppCloseMsgFile(pMsgFile_p);
+        return (-2);
+    }
+
+    if ( (read(pMsgFile_p->m_iFd, achMagic, sizeof(achMagic)) == (ssize_t)sizeof(achMagic)) &&
+         (memcmp(achMagic, MLF_FILE_MAGIC, sizeof(achMagic)) == 0) )
+    {
+        close(pMsgFile_p->m_iFd);
+        pMsgFile_p->m_iFd = -1;
+        pMsgFile_p->m_fBinary = true;
+        iRes = MlrOpen(pszFileName_p, &pMsgFile_p->m_MlrLog);
+        return ((iRes < 0) ? (iRes - 10) : 0);
+    }
+
+    if (FileStat.st_size == 0)
+    {
+        return (0);                                     // empty Json MessageFile
+    }
+    pMapAddr = mmap(NULL, (size_t)FileStat.st_size, PROT_READ, MAP_SHARED, pMsgFile_p->m_iFd, 0);
+    if (pMapAddr == MAP_FAILED)
+    {
+        AppCloseMsgFile(pMsgFile_p);
+        return (-3);
+    }
+    madvise(pMapAddr, (size_t)FileStat.st_size, MADV_SEQUENTIAL);
+    pMsgFile_p->m_pabMapAddr = (const uint8_t*)pMapAddr;
+    pMsgFile_p->m_nMapSize   = (size_t)FileStat.st_size;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Close MessageFile
+//---------------------------------------------------------------------------
+
+static  void  AppCloseMsgFile (
+    tAppMsgFile* pMsgFile_p)
+{
+
+    if ( pMsgFile_p->m_fBinary )
+    {
+        MlrClose(&pMsgFile_p->m_MlrLog);
+        return;
+    }
+
+    if (pMsgFile_p->m_pabMapAddr != NULL)
+    {
+        munmap((void*)pMsgFile_p->m_pabMapAddr, pMsgFile_p->m_nMapSize);
+        pMsgFile_p->m_pabMapAddr = NULL;
+    }
+    if (pMsgFile_p->m_iFd >= 0)
+    {
+        close(pMsgFile_p->m_iFd);
+        pMsgFile_p->m_iFd = -1;
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Add unindexed Range (split into Chunks for parallel scanning)
+//---------------------------------------------------------------------------
+//  <ui64Start_p> and <ui64End_p> are record boundaries. Chunks of a binary
+//  MessageLog are aligned to records, chunks of a Json MessageFile start at
+//  any byte and the worker looks for the first record starting in it.
+
+static  void  AppAddScanRange (
+    uint uiFile_p,
+    uint64_t ui64Start_p,
+    uint64_t ui64End_p)
+{
+
+uint64_t  ui64ChunkSize;
+uint64_t  ui64Pos;
+
+
+    ui64ChunkSize = APP_SCAN_CHUNK_SIZE;
+    if ( vecMsgFiles_l[uiFile_p].m_fBinary )
+    {
+        ui64ChunkSize -= ui64ChunkSize % MLF_RECORD_SIZE;
+    }
+
+    for (ui64Pos=ui64Start_p; ui64Pos<ui64End_p; ui64Pos+=ui64ChunkSize)
+    {
+        AppAddScanItem(uiFile_p, ui64Pos,
+                       ((ui64End_p - ui64Pos) < ui64ChunkSize) ? (ui64End_p - ui64Pos) : ui64ChunkSize,
+                       (ui64Pos == ui64Start_p));
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Add Range to scan
+//---------------------------------------------------------------------------
+
+static  void  AppAddScanItem (
+    uint uiFile_p,
+    uint64_t ui64Offset_p,
+    uint64_t ui64Length_p,
+    bool fAtRecStart_p)
+{
+
+tAppScanItem  ScanItem;
+
+
+    ScanItem.m_uiFile      = uiFile_p;
+    ScanItem.m_ui64Offset  = ui64Offset_p;
+    ScanItem.m_ui64Length  = ui64Length_p;
+    ScanItem.m_fAtRecStart = fAtRecStart_p;
+    ScanItem.m_uiRecords   = 0;
+    ScanItem.m_uiMatches   = 0;
+    ScanItem.m_uiDamaged   = 0;
+    vecScanItems_l.push_back(ScanItem);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Worker Thread: scan Items of current Batch until all are done
+//---------------------------------------------------------------------------
+
+static  void  AppWorkerThread (void)
+{
+
+size_t  nItem;
+
+
+    while (true)
+    {
+        nItem = nNextScanItem_l++;
+        if (nItem >= nBatchEnd_l)
+        {
+            break;
+        }
+
+        if ( vecMsgFiles_l[vecScanItems_l[nItem].m_uiFile].m_fBinary )
+        {
+            AppScanBinary(&vecScanItems_l[nItem]);
+        }
+        else
+        {
+            AppScanJson(&vecScanItems_l[nItem]);
+        }
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Scan Range of binary MessageLog
+//---------------------------------------------------------------------------
+
+static  void  AppScanBinary (
+    tAppScanItem* pScanItem_p)
+{
+
+const tMlrLog*     pMlrLog;
+const tMlfRecord*  pMlfRecord;
+tPprRecordFields   RecordFields;
+size_t             nRecIdx;
+size_t             nRecEnd;
+
+
+    pMlrLog = &vecMsgFiles_l[pScanItem_p->m_uiFile].m_MlrLog;
+    nRecIdx = (size_t)((pScanItem_p->m_ui64Offset - MLF_HEADER_SIZE) / MLF_RECORD_SIZE);
+    nRecEnd = nRecIdx + (size_t)(pScanItem_p->m_ui64Length / MLF_RECORD_SIZE);
+
+    for (; nRecIdx<nRecEnd; nRecIdx++)
+    {
+        pScanItem_p->m_uiRecords++;
+        pMlfRecord = MlrGetRecord(pMlrLog, nRecIdx);
+        if ( !MlrCheckRecord(pMlfRecord) )
+        {
+            pScanItem_p->m_uiDamaged++;
+            continue;
+        }
+        if ( ((iQueryDevID_l >= 0) && (pMlfRecord->m_ui8DevID != iQueryDevID_l)) ||
+             (pMlfRecord->m_i64TimeStamp < i64QueryFromTime_l) ||
+             (pMlfRecord->m_i64TimeStamp > i64QueryToTime_l) )
+        {
+            continue;
+        }
+        if (MlrGetRecordFields(pMlfRecord, &RecordFields) < 0)
+        {
+            pScanItem_p->m_uiDamaged++;
+            continue;
+        }
+        pScanItem_p->m_uiMatches++;
+
+        AppFormatRecord(&RecordFields, &pScanItem_p->m_strOutput);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Append Record in selected Output Format
+//---------------------------------------------------------------------------
+
+static  void  AppFormatRecord (
+    const tPprRecordFields* pRecordFields_p,
+    std::string* pstrOutput_p)
+{
+
+std::string  strRecord;
+
+
+    switch (OutputFormat_l)
+    {
+        case kAppOutputLine:
+        {
+            PprBuildLineRecord(pRecordFields_p, &strRecord);
+            *pstrOutput_p += strRecord;
+            *pstrOutput_p += "\n";
+            break;
+        }
+
+        case kAppOutputCsv:
+        {
+            PprBuildCsvRecord(pRecordFields_p, &strRecord);
+            *pstrOutput_p += strRecord;
+            *pstrOutput_p += "\n";
+            break;
+        }
+
+        default:
+        {
+            // same layout as written by MfwWriteMessage() for the Json MessageFile
+            PprBuildJsonRecord(pRecordFields_p, &strRecord);
+            strRecord.erase(0, strRecord.find_first_not_of(" \n\r\t"));
+            strRecord.erase(strRecord.find_last_not_of(" \n\r\t")+1);
+            *pstrOutput_p += strRecord;
+            *pstrOutput_p += JSON_REC_DELIMITER;
+            break;
+        }
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Scan Range of Json MessageFile
+//---------------------------------------------------------------------------
+//  Records are separated by an empty line, so a record starts at the
+//  beginning of the file or behind "\n\n". Each record belongs to the range
+//  it starts in and is copied unchanged. Only "DevID" and "TimeStamp" are
+//  extracted, a record without them or without the closing brace (torn by a
+//  power failure) counts as damaged.
+
+static  void  AppScanJson (
+    tAppScanItem* pScanItem_p)
+{
+
+const tAppMsgFile*  pMsgFile;
+const char*  pszFileEnd;
+const char*  pszRangeEnd;
+const char*  pszRec;
+const char*  pszRecEnd;
+const char*  pszKey;
+const char*  pszLast;
+char*        pszNumEnd;
+long         lDevID;
+long long    llTimeStamp;
+
+
+    pMsgFile    = &vecMsgFiles_l[pScanItem_p->m_uiFile];
+    pszFileEnd  = (const char*)pMsgFile->m_pabMapAddr + pMsgFile->m_nMapSize;
+    pszRec      = (const char*)pMsgFile->m_pabMapAddr + pScanItem_p->m_ui64Offset;
+    pszRangeEnd = pszRec + pScanItem_p->m_ui64Length;
+
+    if ( !pScanItem_p->m_fAtRecStart )
+    {
+        while ((pszRec < pszRangeEnd) && !((pszRec[-1] == '\n') && (pszRec[-2] == '\n') && (*pszRec != '\n')))
+        {
+            pszRec++;
+        }
+    }
+
+    while (pszRec < pszRangeEnd)
+    {
+        // skip additional empty lines
+        if ((*pszRec == '\n') || (*pszRec == '\r'))
+        {
+            pszRec++;
+            continue;
+        }
+
+        pszRecEnd = (const char*)memmem(pszRec, (size_t)(pszFileEnd - pszRec), JSON_REC_DELIMITER, sizeof(JSON_REC_DELIMITER)-1);
+        if (pszRecEnd == NULL)
+        {
+            pszRecEnd = pszFileEnd;
+        }
+        pScanItem_p->m_uiRecords++;
+
+        lDevID = -1;
+        pszKey = (const char*)memmem(pszRec, (size_t)(pszRecEnd - pszRec), JSON_KEY_DEVID, sizeof(JSON_KEY_DEVID)-1);
+        if (pszKey != NULL)
+        {
+            lDevID = strtol(pszKey + sizeof(JSON_KEY_DEVID)-1, &pszNumEnd, 10);
+        }
+        llTimeStamp = 0;
+        pszKey = (const char*)memmem(pszRec, (size_t)(pszRecEnd - pszRec), JSON_KEY_TIMESTAMP, sizeof(JSON_KEY_TIMESTAMP)-1);
+        if (pszKey != NULL)
+        {
+            llTimeStamp = strtoll(pszKey + sizeof(JSON_KEY_TIMESTAMP)-1, &pszNumEnd, 10);
+        }
+
+        pszLast = pszRecEnd - 1;
+        while ((pszLast > pszRec) && ((*pszLast == '\n') || (*pszLast == '\r') || (*pszLast == ' ')))
+        {
+            pszLast--;
+        }
+
+        if ((lDevID < 0) || (pszKey == NULL) || (*pszLast != '}'))
+        {
+            pScanItem_p->m_uiDamaged++;
+        }
+        else if ( ((iQueryDevID_l < 0) || (lDevID == iQueryDevID_l)) &&
+                  (llTimeStamp >= i64QueryFromTime_l) && (llTimeStamp <= i64QueryToTime_l) )
+        {
+            pScanItem_p->m_uiMatches++;
+            pScanItem_p->m_strOutput.append(pszRec, (size_t)(pszRecEnd - pszRec));
+            pScanItem_p->m_strOutput += JSON_REC_DELIMITER;
+        }
+
+        pszRec = pszRecEnd;
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Write synthetic Log (option '-g=')
+//---------------------------------------------------------------------------
+//  The records are written through MfwWriteMessage() including the Index,
+//  but without O_SYNC, so that logs of several GB can be generated in a
+//  reasonable time.
+
+static  int  AppWriteSynthLog (void)
+{
+
+tJsonMessage  JsonMessage;
+const char*   pszFileName;
+uint64_t      ui64MaxSize;
+uint64_t      ui64Size;
+double        dStartTime;
+double        dRuntime;
+uint          uiRec;
+int           iRes;
+
+
+    AppPrintBanner();
+
+    pszFileName = vecMsgLogFiles_l[0];
+    ui64MaxSize = (uint64_t)uiSynthSizeMB_l * 1024 * 1024;
+    ui64Size    = AppGetFileSize(pszFileName);
+
+    printf("Append synthetic records to '%s' (%s) up to %u MB...\n", pszFileName, ((SynthFormat_l == kMfwFormatJson) ? "json" : "binary"), uiSynthSizeMB_l);
+
+    iRes = MfwOpen(pszFileName, SynthFormat_l, MIX_DEF_BLOCK_RECORDS, false, NULL);
+    if (iRes < 0)
+    {
+        printf("ERROR: can't open MessageFile (iRes=%d)!\n", iRes);
+        return (-1);
+    }
+
+    dStartTime = AppGetTime();
+    uiRec = 0;
+    if (ui64Size > MLF_HEADER_SIZE)
+    {
+        // continue after the records of a previous run (same size per record)
+        uiRec = (uint)(ui64Size / ((SynthFormat_l == kMfwFormatJson) ? 400 : MLF_RECORD_SIZE));
+    }
+    while (ui64Size < ui64MaxSize)
+    {
+        AppBuildSynthMessage(uiRec, (SynthFormat_l == kMfwFormatJson), &JsonMessage);
+        iRes = MfwWriteMessage(&JsonMessage);
+        if (iRes < 0)
+        {
+            printf("ERROR: MfwWriteMessage() failed (iRes=%d)!\n", iRes);
+            break;
+        }
+        ui64Size += (SynthFormat_l == kMfwFormatJson) ? (JsonMessage.m_strJsonRecord.length() + 2) : MLF_RECORD_SIZE;
+        uiRec++;
+    }
+    MfwClose();
+    dRuntime = AppGetTime() - dStartTime;
+
+    printf("done: %u records, %.1f MB, %.0f [Rec/s], covering %s",
+           uiRec, (double)AppGetFileSize(pszFileName) / (1024.0 * 1024.0), uiRec / dRuntime,
+           ctime(&JsonMessage.m_RecordFields.m_tmTimeStamp));
+    printf("\n");
+
+    return ((iRes < 0) ? -2 : 0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Build synthetic Message
+//---------------------------------------------------------------------------
+//  One Bootup Message per device followed by Gen0 Data Records with
+//  plausible sensor values. The content only depends on <uiRec_p>, so all
+//  formats get the same messages. The devices transmit one after the other
+//  within each cycle, so the TimeStamps are ascending.
+
+static  void  AppBuildSynthMessage (
+    uint uiRec_p,
+    bool fWithJsonRecord_p,
+    tJsonMessage* pJsonMessage_p)
+{
+
+tPprRecordFields*  pRecordFields;
+
+
+    pRecordFields = &pJsonMessage_p->m_RecordFields;
+
+    memset(pRecordFields, 0, sizeof(tPprRecordFields));
+    pRecordFields->m_uiMsgID     = uiRec_p + 1;
+    pRecordFields->m_tmTimeStamp = APP_SYNTH_START_TIME + ((time_t)uiRec_p * APP_SYNTH_CYCLE_TIME / APP_SYNTH_DEVICES);
+    pRecordFields->m_i8Rssi      = (int8_t)(-60 - (int)(uiRec_p % 40));
+    pRecordFields->m_ui8DevID    = (uint8_t)(uiRec_p % APP_SYNTH_DEVICES);
+    if (uiRec_p < APP_SYNTH_DEVICES)
+    {
+        pRecordFields->m_PacketType          = kLoraPacketBootup;
+        pRecordFields->m_ui8FirmwareVersion  = 1;
+        pRecordFields->m_ui8FirmwareRevision = 7;
+        LoraBootupHeaderField<kLoraBootupPacketType>::Put(&pRecordFields->m_SchemaRec.m_LoraBootupHeader, kLoraPacketBootup);
+        LoraBootupHeaderField<kLoraBootupDevID>::Put(&pRecordFields->m_SchemaRec.m_LoraBootupHeader, pRecordFields->m_ui8DevID);
+        LoraBootupHeaderField<kLoraBootupFirmwareVersion>::Put(&pRecordFields->m_SchemaRec.m_LoraBootupHeader, 1);
+        LoraBootupHeaderField<kLoraBootupFirmwareRevision>::Put(&pRecordFields->m_SchemaRec.m_LoraBootupHeader, 7);
+        LoraBootupHeaderField<kLoraBootupDataPackCycleTm>::SetInt(&pRecordFields->m_SchemaRec.m_LoraBootupHeader, APP_SYNTH_CYCLE_TIME);
+        LoraBootupHeaderField<kLoraBootupCfgDhtSensor>::SetInt(&pRecordFields->m_SchemaRec.m_LoraBootupHeader, 1);
+    }
+    else
+    {
+        pRecordFields->m_PacketType  = kLoraPacketDataGen0;
+        pRecordFields->m_uiDataGen   = 0;
+        pRecordFields->m_ui32SequNum = uiRec_p / APP_SYNTH_DEVICES;
+        pRecordFields->m_ui32Uptime  = (uiRec_p / APP_SYNTH_DEVICES) * APP_SYNTH_CYCLE_TIME;
+        LoraDataRecField<kLoraDataRecPacketType>::Put(&pRecordFields->m_SchemaRec.m_LoraDataRec, kLoraPacketDataGen0);
+        LoraDataRecField<kLoraDataRecTemperature>::SetFloat(&pRecordFields->m_SchemaRec.m_LoraDataRec, 15.0f + (float)(uiRec_p % 21) * 0.5f);
+        LoraDataRecField<kLoraDataRecHumidity>::SetInt(&pRecordFields->m_SchemaRec.m_LoraDataRec, 40 + (uiRec_p % 30));
+        LoraDataRecField<kLoraDataRecLightLevel>::SetInt(&pRecordFields->m_SchemaRec.m_LoraDataRec, (uiRec_p % 50) * 2);
+        LoraDataRecField<kLoraDataRecCarBattLevel>::SetFloat(&pRecordFields->m_SchemaRec.m_LoraDataRec, 12.6f);
+    }
+
+    pJsonMessage_p->m_uiMsgID     = pRecordFields->m_uiMsgID;
+    pJsonMessage_p->m_PacketType  = pRecordFields->m_PacketType;
+    pJsonMessage_p->m_ui8DevID    = pRecordFields->m_ui8DevID;
+    pJsonMessage_p->m_ui32SequNum = pRecordFields->m_ui32SequNum;
+    pJsonMessage_p->m_i8Rssi      = pRecordFields->m_i8Rssi;
+    pJsonMessage_p->m_tmTimeStamp = pRecordFields->m_tmTimeStamp;
+    pJsonMessage_p->m_strJsonRecord.clear();
+    if ( fWithJsonRecord_p )
+    {
+        PprBuildJsonRecord(pRecordFields, &pJsonMessage_p->m_strJsonRecord);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Benchmark: Json MessageFile vs. binary MessageLog
+//---------------------------------------------------------------------------
+//  Both files are written through MfwWriteMessage() exactly as by the
+//  Gateway (one synchronous write per message), without and with Index.
+//  Scanning extracts the Temperature of all Data Records: the Json scan
+//  only searches the key and converts the value (far less work than a real
+//  Json parser, so the result is in favor of Json), the binary scan checks
+//  the CRC of every record and decodes the field from the mapped file.
+
+static  int  AppRunBenchmark (void)
+{
+
+static const char*  apszFormatName[2] = { "Json", "Binary" };
+static const tMfwFormat  aMsgFileFormat[2] = { kMfwFormatJson, kMfwFormatBinary };
+std::string  strFileBase;
+std::string  astrFileName[2];
+double       adWriteTime[2][2];
+double       adScanTime[2];
+double       adTempSum[2];
+uint         auiRecords[2];
+uint64_t     aui64FileSize[2];
+uint64_t     aui64IndexSize[2];
+double       dStartTime;
+uint         uiFmt;
+uint         uiIdx;
+int          iRes;
+
+
+    AppPrintBanner();
+
+    strFileBase = (!vecMsgLogFiles_l.empty()) ? vecMsgLogFiles_l[0] : APP_DEF_BENCH_FILE;
+    astrFileName[0] = strFileBase + ".json";
+    astrFileName[1] = strFileBase + ".bin";
+
+    printf("Benchmark: %u synthetic Messages\n\n", uiBenchRecords_l);
+
+    for (uiFmt=0; uiFmt<2; uiFmt++)
+    {
+        // uiIdx=0: without Index (scanned afterwards), uiIdx=1: with Index
+        for (uiIdx=0; uiIdx<2; uiIdx++)
+        {
+            unlink(astrFileName[uiFmt].c_str());
+            unlink(MixGetIndexFileName(astrFileName[uiFmt].c_str()).c_str());
+
+            dStartTime = AppGetTime();
+            iRes = AppBenchWriteLog(astrFileName[uiFmt].c_str(), aMsgFileFormat[uiFmt], (uiIdx ? MIX_DEF_BLOCK_RECORDS : 0), uiBenchRecords_l);
+            adWriteTime[uiFmt][uiIdx] = AppGetTime() - dStartTime;
+            if (iRes < 0)
+            {
+                printf("ERROR: writing of '%s' failed (iRes=%d)!\n", astrFileName[uiFmt].c_str(), iRes);
+                return (-1);
+            }
+            aui64FileSize[uiFmt]  = AppGetFileSize(astrFileName[uiFmt].c_str());
+            aui64IndexSize[uiFmt] = AppGetFileSize(MixGetIndexFileName(astrFileName[uiFmt].c_str()).c_str());
+            if (uiIdx > 0)
+            {
+                continue;
+            }
+
+            dStartTime = AppGetTime();
+            if (aMsgFileFormat[uiFmt] == kMfwFormatJson)
+            {
+                iRes = AppBenchScanJson(astrFileName[uiFmt].c_str(), &auiRecords[uiFmt], &adTempSum[uiFmt]);
+            }
+            else
+            {
+                iRes = AppBenchScanBinary(astrFileName[uiFmt].c_str(), &auiRecords[uiFmt], &adTempSum[uiFmt]);
+            }
+            adScanTime[uiFmt] = AppGetTime() - dStartTime;
+            if (iRes < 0)
+            {
+                printf("ERROR: scanning of '%s' failed (iRes=%d)!\n", astrFileName[uiFmt].c_str(), iRes);
+                return (-2);
+            }
+        }
+    }
+
+    printf("Format    FileSize [Bytes]  Bytes/Rec  Write [Rec/s]  Scan [Rec/s]  Scan [MB/s]\n");
+    printf("--------  ----------------  ---------  -------------  ------------  -----------\n");
+    for (uiFmt=0; uiFmt<2; uiFmt++)
+    {
+        printf("%-8s  %16llu  %9.1f  %13.0f  %12.0f  %11.1f\n",
+               apszFormatName[uiFmt], (unsigned long long)aui64FileSize[uiFmt],
+               (double)aui64FileSize[uiFmt] / uiBenchRecords_l,
+               uiBenchRecords_l / adWriteTime[uiFmt][0],
+               auiRecords[uiFmt] / adScanTime[uiFmt],
+               ((double)aui64FileSize[uiFmt] / (1024.0 * 1024.0)) / adScanTime[uiFmt]);
+    }
+    printf("\n");
+    printf("Records found: Json=%u, Binary=%u\n", auiRecords[0], auiRecords[1]);
+    printf("Temperature Sum: Json=%.1f, Binary=%.1f (%s)\n", adTempSum[0], adTempSum[1],
+           ((auiRecords[0] == auiRecords[1]) && ((long)(adTempSum[0] * 10) == (long)(adTempSum[1] * 10))) ? "ok" : "MISMATCH");
+    printf("Scan Speedup: %.1fx, Size Ratio: %.2f\n", adScanTime[0] / adScanTime[1], (double)aui64FileSize[1] / aui64FileSize[0]);
+    printf("\n");
+
+    printf("Index (every %u records)  IndexSize [Bytes]  Write with Index [Rec/s]  Overhead\n", MIX_DEF_BLOCK_RECORDS);
+    printf("-------------------------  -----------------  ------------------------  --------\n");
+    for (uiFmt=0; uiFmt<2; uiFmt++)
+    {
+        printf("%-25s  %17llu  %24.0f  %7.1f%%\n",
+               apszFormatName[uiFmt], (unsigned long long)aui64IndexSize[uiFmt],
+               uiBenchRecords_l / adWriteTime[uiFmt][1],
+               ((adWriteTime[uiFmt][1] / adWriteTime[uiFmt][0]) - 1.0) * 100.0);
+    }
+    printf("\n");
+
+    for (uiFmt=0; uiFmt<2; uiFmt++)
+    {
+        unlink(astrFileName[uiFmt].c_str());
+        unlink(MixGetIndexFileName(astrFileName[uiFmt].c_str()).c_str());
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Benchmark: write synthetic Messages
+//---------------------------------------------------------------------------
+
+static  int  AppBenchWriteLog (
+    const char* pszFileName_p,
+    tMfwFormat MsgFileFormat_p,
+    uint uiIndexBlockRecords_p,
+    uint uiRecords_p)
+{
+
+tJsonMessage  JsonMessage;
+uint          uiRec;
+int           iRes;
+
+
+    iRes = MfwOpen(pszFileName_p, MsgFileFormat_p, uiIndexBlockRecords_p, true, NULL);
+    if (iRes < 0)
+    {
+        return (-1);
+    }
+
+    for (uiRec=0; uiRec<uiRecords_p; uiRec++)
+    {
+        AppBuildSynthMessage(uiRec, true, &JsonMessage);
+        iRes = MfwWriteMessage(&JsonMessage);
+        if (iRes < 0)
+        {
+            MfwClose();
+            return (-2);
+        }
+    }
+
+    MfwClose();
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Benchmark: scan Json MessageFile
+//---------------------------------------------------------------------------
+
+static  int  AppBenchScanJson (
+    const char* pszFileName_p,
+    uint* puiRecords_p,
+    double* pdTempSum_p)
+{
+
+static const char  szKeyMsgID[] = "\"MsgID\":";
+static const char  szKeyTemp[]   = "\"Temperature\":";
+std::string  strFileData;
+char         abReadBuff[64 * 1024];
+const char*  pszPos;
+ssize_t      iRes;
+int          iFd;
+
+
+    *puiRecords_p = 0;
+    *pdTempSum_p  = 0;
+
+    iFd = open(pszFileName_p, O_RDONLY);
+    if (iFd < 0)
+    {
+        return (-1);
+    }
+    while ((iRes = read(iFd, abReadBuff, sizeof(abReadBuff))) > 0)
+    {
+        strFileData.append(abReadBuff, (size_t)iRes);
+    }
+    close(iFd);
+
+    pszPos = strFileData.c_str();
+    while ((pszPos = strstr(pszPos, szKeyMsgID)) != NULL)
+    {
+        pszPos += sizeof(szKeyMsgID)-1;
+        (*puiRecords_p)++;
+    }
+
+    pszPos = strFileData.c_str();
+    while ((pszPos = strstr(pszPos, szKeyTemp)) != NULL)
+    {
+        pszPos += sizeof(szKeyTemp)-1;
+        *pdTempSum_p += strtod(pszPos, NULL);
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Benchmark: scan binary MessageLog
+//---------------------------------------------------------------------------
+
+static  int  AppBenchScanBinary (
+    const char* pszFileName_p,
+    uint* puiRecords_p,
+    double* pdTempSum_p)
+{
+
+tMlrLog            MlrLog;
+const tMlfRecord*  pMlfRecord;
+size_t             nNumRecords;
+size_t             nRecIdx;
+int                iRes;
+
+
+    *puiRecords_p = 0;
+    *pdTempSum_p  = 0;
+
+    iRes = MlrOpen(pszFileName_p, &MlrLog);
+    if (iRes < 0)
+    {
+        return (-1);
+    }
+
+    nNumRecords = MlrGetNumRecords(&MlrLog);
+    for (nRecIdx=0; nRecIdx<nNumRecords; nRecIdx++)
+    {
+        pMlfRecord = MlrGetRecord(&MlrLog, nRecIdx);
+        if ( !MlrCheckRecord(pMlfRecord) )
+        {
+            continue;
+        }
+        (*puiRecords_p)++;
+        if (pMlfRecord->m_ui8PacketType != kLoraPacketBootup)
+        {
+            *pdTempSum_p += LoraDataRecField<kLoraDataRecTemperature>::GetFloat(pMlfRecord->m_abSchemaRec);
+        }
+    }
+
+    MlrClose(&MlrLog);
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Benchmark: Rotation and background Compression of MessageFile
+//---------------------------------------------------------------------------
+//  The same synthetic messages are written three times through
+//  MfwWriteMessage() as by the Gateway (one synchronous write per message):
+//  without rotation, with about APP_ROT_SEGMENTS rotations by size and with the
+//  same rotations plus gzip compression of each segment in the background.
+//  The write rate of the last run is measured while segments are compressed,
+//  the time until the last compression is finished is reported separately.
+
+static  int  AppRunRotationBench (void)
+{
+
+static const char*  apszVariant[3] = { "No Rotation", "Rotation", "Rotation + gzip" };
+tMfwRotationCfg  RotationCfg;
+tMfwStatistics   aStatistics[3];
+std::string      strDirName;
+std::string      strFileName;
+double           adWriteTime[3];
+double           adIdleTime[3];
+uint64_t         ui64FileSize;
+uint             uiVariant;
+int              iRes;
+
+
+    AppPrintBanner();
+
+    strDirName  = std::string((!vecMsgLogFiles_l.empty()) ? vecMsgLogFiles_l[0] : APP_DEF_BENCH_FILE) + "_rot";
+    strFileName = strDirName + ((RotBenchFormat_l == kMfwFormatJson) ? "/LoraPacketLog.json" : "/LoraPacketLog.bin");
+
+    printf("Rotation Benchmark: %u synthetic Messages (%s)\n\n", uiRotBenchRecords_l, ((RotBenchFormat_l == kMfwFormatJson) ? "json" : "binary"));
+
+    memset(&RotationCfg, 0, sizeof(RotationCfg));
+    ui64FileSize = 0;
+    for (uiVariant=0; uiVariant<3; uiVariant++)
+    {
+        AppRemoveDir(strDirName.c_str());
+        if (mkdir(strDirName.c_str(), 0777) != 0)
+        {
+            printf("ERROR: can't create directory '%s'!\n", strDirName.c_str());
+            return (-1);
+        }
+
+        // segment size derived from the file size of the run without rotation
+        if (uiVariant > 0)
+        {
+            RotationCfg.m_ui64MaxFileSize = (ui64FileSize + APP_ROT_SEGMENTS) / (APP_ROT_SEGMENTS + 1);
+            RotationCfg.m_fCompress = (uiVariant == 2);
+        }
+
+        iRes = AppRotBenchWriteLog(strFileName.c_str(), ((uiVariant > 0) ? &RotationCfg : NULL),
+                                   &adWriteTime[uiVariant], &adIdleTime[uiVariant], &aStatistics[uiVariant]);
+        if (iRes < 0)
+        {
+            printf("ERROR: writing of '%s' failed (iRes=%d)!\n", strFileName.c_str(), iRes);
+            AppRemoveDir(strDirName.c_str());
+            return (-2);
+        }
+        if (uiVariant == 0)
+        {
+            ui64FileSize = AppGetFileSize(strFileName.c_str());
+        }
+    }
+    AppRemoveDir(strDirName.c_str());
+
+    printf("Segment Size: %llu [Bytes]\n\n", (unsigned long long)RotationCfg.m_ui64MaxFileSize);
+    printf("Variant          Write [Rec/s]  Rotations  Rotation avg [us]  Rotation max [us]\n");
+    printf("---------------  -------------  ---------  -----------------  -----------------\n");
+    for (uiVariant=0; uiVariant<3; uiVariant++)
+    {
+        printf("%-15s  %13.0f  %9u  %17u  %17u\n",
+               apszVariant[uiVariant], uiRotBenchRecords_l / adWriteTime[uiVariant],
+               aStatistics[uiVariant].m_uiRotations,
+               (aStatistics[uiVariant].m_uiRotations > 0) ? (uint)(aStatistics[uiVariant].m_ui64RotationSumUs / aStatistics[uiVariant].m_uiRotations) : 0,
+               (uint)aStatistics[uiVariant].m_ui32RotationMaxUs);
+    }
+    printf("\n");
+    printf("Compression: %u segments (errors: %u), ratio %.2f, finished %.3f [sec] after last write\n",
+           aStatistics[2].m_uiFilesCompressed, aStatistics[2].m_uiCompressErrors,
+           (aStatistics[2].m_ui64BytesUncompressed > 0) ? ((double)aStatistics[2].m_ui64BytesCompressed / (double)aStatistics[2].m_ui64BytesUncompressed) : 0.0,
+           adIdleTime[2]);
+    printf("Write Rate during Compression: %.1f%% of Rotation without Compression\n",
+           (adWriteTime[1] / adWriteTime[2]) * 100.0);
+    printf("\n");
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Rotation Benchmark: write synthetic Messages
+//---------------------------------------------------------------------------
+
+static  int  AppRotBenchWriteLog (
+    const char* pszFileName_p,
+    const tMfwRotationCfg* pRotationCfg_p,
+    double* pdWriteTime_p,
+    double* pdIdleTime_p,
+    tMfwStatistics* pStatistics_p)
+{
+
+tJsonMessage  JsonMessage;
+double        dStartTime;
+uint          uiRec;
+int           iRes;
+
+
+    iRes = MfwOpen(pszFileName_p, RotBenchFormat_l, MIX_DEF_BLOCK_RECORDS, true, pRotationCfg_p);
+    if (iRes < 0)
+    {
+        return (-1);
+    }
+
+    dStartTime = AppGetTime();
+    for (uiRec=0; uiRec<uiRotBenchRecords_l; uiRec++)
+    {
+        AppBuildSynthMessage(uiRec, (RotBenchFormat_l == kMfwFormatJson), &JsonMessage);
+        iRes = MfwWriteMessage(&JsonMessage);
+        if (iRes < 0)
+        {
+            MfwClose();
+            return (-2);
+        }
+    }
+    *pdWriteTime_p = AppGetTime() - dStartTime;
+
+    // MfwClose() would abort a running compression
+    dStartTime = AppGetTime();
+    while ( !MfwIsBackgroundIdle() )
+    {
+        usleep(1000);
+    }
+    *pdIdleTime_p = AppGetTime() - dStartTime;
+
+    MfwGetStatistics(pStatistics_p);
+    MfwClose();
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Remove Directory with all Files
+//---------------------------------------------------------------------------
+
+static  void  AppRemoveDir (
+    const char* pszDirName_p)
+{
+
+struct dirent*  pDirEntry;
+std::string     strFileName;
+DIR*            pDir;
+
+
+    pDir = opendir(pszDirName_p);
+    if (pDir == NULL)
+    {
+        return;
+    }
+    while ((pDirEntry = readdir(pDir)) != NULL)
+    {
+        if ( !strcmp(pDirEntry->d_name, ".") || !strcmp(pDirEntry->d_name, "..") )
+        {
+            continue;
+        }
+        strFileName = std::string(pszDirName_p) + "/" + pDirEntry->d_name;
+        unlink(strFileName.c_str());
+    }
+    closedir(pDir);
+    rmdir(pszDirName_p);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Import MessageFiles into Time Series Store (option '-y=' with MessageFiles)
+//---------------------------------------------------------------------------
+//  The Data Records of all files (restricted by '-d'/'-t') are added in the
+//  given order. Importing the same records twice stores them twice, so a
+//  store is rebuilt by importing into a new StoreFile.
+
+static  int  AppImportStore (void)
+{
+
+tAppMsgFile        MsgFile;
+tJsonMessage       JsonMessage;
+tTssStatistics     Statistics;
+const tMlfRecord*  pMlfRecord;
+uint64_t           ui64Records;
+uint64_t           ui64Damaged;
+double             dStartTime;
+size_t             nRecIdx;
+uint               uiFile;
+int                iRes;
+
+
+    dStartTime = AppGetTime();
+
+    iRes = TssOpen(pszStoreFile_l, false);
+    if (iRes < 0)
+    {
+        fprintf(stderr, "ERROR: can't open Time Series Store '%s' (iRes=%d)!\n", pszStoreFile_l, iRes);
+        return (-1);
+    }
+
+    ui64Records = 0;
+    ui64Damaged = 0;
+    for (uiFile=0; uiFile<vecMsgLogFiles_l.size(); uiFile++)
+    {
+        iRes = AppOpenMsgFile(vecMsgLogFiles_l[uiFile], &MsgFile);
+        if (iRes < 0)
+        {
+            fprintf(stderr, "ERROR: can't open MessageFile '%s' (iRes=%d)!\n", vecMsgLogFiles_l[uiFile], iRes);
+            TssClose();
+            return (-2);
+        }
+
+        if ( MsgFile.m_fBinary )
+        {
+            for (nRecIdx=0; nRecIdx<MlrGetNumRecords(&MsgFile.m_MlrLog); nRecIdx++)
+            {
+                pMlfRecord = MlrGetRecord(&MsgFile.m_MlrLog, nRecIdx);
+                if ( !MlrCheckRecord(pMlfRecord) || (MlrGetRecordFields(pMlfRecord, &JsonMessage.m_RecordFields) < 0) )
+                {
+                    ui64Damaged++;
+                    continue;
+                }
+                if ( ((iQueryDevID_l >= 0) && (JsonMessage.m_RecordFields.m_ui8DevID != iQueryDevID_l)) ||
+                     ((int64_t)JsonMessage.m_RecordFields.m_tmTimeStamp < i64QueryFromTime_l) ||
+                     ((int64_t)JsonMessage.m_RecordFields.m_tmTimeStamp > i64QueryToTime_l) )
+                {
+                    continue;
+                }
+                iRes = TssAddMessage(&JsonMessage);
+                if (iRes > 0)
+                {
+                    ui64Records++;
+                }
+            }
+        }
+        else
+        {
+            AppImportJsonFile(&MsgFile, &ui64Records, &ui64Damaged);
+        }
+
+        AppCloseMsgFile(&MsgFile);
+    }
+
+    TssGetStatistics(&Statistics);
+    TssClose();
+
+    if (ui64Damaged > 0)
+    {
+        fprintf(stderr, "WARNING: %llu damaged records skipped!\n", (unsigned long long)ui64Damaged);
+    }
+    fprintf(stderr, "%llu Data Records (%llu Points) added to '%s' in %.3f [sec]\n",
+            (unsigned long long)ui64Records, (unsigned long long)Statistics.m_ui64PointsAdded,
+            pszStoreFile_l, AppGetTime() - dStartTime);
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Import Json MessageFile into Time Series Store
+//---------------------------------------------------------------------------
+//  The values are taken from the items named like the fields of the store,
+//  they have the same value as the decoded raw record (see TssAddMessage()).
+
+static  int  AppImportJsonFile (
+    const tAppMsgFile* pMsgFile_p,
+    uint64_t* pui64Records_p,
+    uint64_t* pui64Damaged_p)
+{
+
+double       adValue[kTssNumFields];
+std::string  astrKey[kTssNumFields];
+const char*  pszFileEnd;
+const char*  pszRec;
+const char*  pszRecEnd;
+const char*  pszKey;
+const char*  pszLast;
+char*        pszNumEnd;
+long         lDevID;
+long long    llTimeStamp;
+uint         uiField;
+bool         fComplete;
+
+
+    for (uiField=0; uiField<kTssNumFields; uiField++)
+    {
+        astrKey[uiField] = std::string("\"") + TssGetFieldName((tTssField)uiField) + "\": ";
+    }
+
+    pszRec     = (const char*)pMsgFile_p->m_pabMapAddr;
+    pszFileEnd = pszRec + pMsgFile_p->m_nMapSize;
+    while (pszRec < pszFileEnd)
+    {
+        // skip additional empty lines
+        if ((*pszRec == '\n') || (*pszRec == '\r'))
+        {
+            pszRec++;
+            continue;
+        }
+
+        pszRecEnd = (const char*)memmem(pszRec, (size_t)(pszFileEnd - pszRec), JSON_REC_DELIMITER, sizeof(JSON_REC_DELIMITER)-1);
+        if (pszRecEnd == NULL)
+        {
+            pszRecEnd = pszFileEnd;
+        }
+
+        // Bootup Records are not stored
+        if (memmem(pszRec, (size_t)(pszRecEnd - pszRec), JSON_KEY_DATA_REC, sizeof(JSON_KEY_DATA_REC)-1) == NULL)
+        {
+            pszRec = pszRecEnd;
+            continue;
+        }
+
+        lDevID = -1;
+        pszKey = (const char*)memmem(pszRec, (size_t)(pszRecEnd - pszRec), JSON_KEY_DEVID, sizeof(JSON_KEY_DEVID)-1);
+        if (pszKey != NULL)
+        {
+            lDevID = strtol(pszKey + sizeof(JSON_KEY_DEVID)-1, &pszNumEnd, 10);
+        }
+        llTimeStamp = 0;
+        pszKey = (const char*)memmem(pszRec, (size_t)(pszRecEnd - pszRec), JSON_KEY_TIMESTAMP, sizeof(JSON_KEY_TIMESTAMP)-1);
+        if (pszKey != NULL)
+        {
+            llTimeStamp = strtoll(pszKey + sizeof(JSON_KEY_TIMESTAMP)-1, &pszNumEnd, 10);
+        }
+        fComplete = ((lDevID >= 0) && (lDevID <= 255) && (pszKey != NULL));
+        for (uiField=0; (uiField<kTssNumFields) && fComplete; uiField++)
+        {
+            pszKey = (const char*)memmem(pszRec, (size_t)(pszRecEnd - pszRec), astrKey[uiField].c_str(), astrKey[uiField].length());
+            if (pszKey == NULL)
+            {
+                fComplete = false;
+                break;
+            }
+            adValue[uiField] = strtod(pszKey + astrKey[uiField].length(), &pszNumEnd);
+            fComplete = (pszNumEnd != (pszKey + astrKey[uiField].length()));
+        }
+
+        pszLast = pszRecEnd - 1;
+        while ((pszLast > pszRec) && ((*pszLast == '\n') || (*pszLast == '\r') || (*pszLast == ' ')))
+        {
+            pszLast--;
+        }
+
+        if ( !fComplete || (*pszLast != '}') )
+        {
+            (*pui64Damaged_p)++;
+        }
+        else if ( ((iQueryDevID_l < 0) || (lDevID == iQueryDevID_l)) &&
+                  (llTimeStamp >= i64QueryFromTime_l) && (llTimeStamp <= i64QueryToTime_l) )
+        {
+            for (uiField=0; uiField<kTssNumFields; uiField++)
+            {
+                TssAddPoint((uint8_t)lDevID, (tTssField)uiField, (int64_t)llTimeStamp, adValue[uiField]);
+            }
+            (*pui64Records_p)++;
+        }
+
+        pszRec = pszRecEnd;
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Query Time Series Store (option '-y=' without MessageFiles)
+//---------------------------------------------------------------------------
+//  The store is opened read-only, so the StoreFile of a running Gateway can
+//  be queried (blocks written after the open are not seen). One CSV line is
+//  output per point or bucket, ordered by DevID, field and time.
+
+static  int  AppQueryStore (void)
+{
+
+std::vector<tTssPoint>      vecPoints;
+std::vector<tTssAggregate>  vecAggregates;
+tTssStatistics  Statistics;
+FILE*           pOutputFile;
+char            szTimeStamp[64];
+uint64_t        ui64Rows;
+double          dStartTime;
+double          dOpenTime;
+uint            uiDecimals;
+uint            uiDevID;
+uint            uiField;
+int             iRes;
+
+
+    dStartTime = AppGetTime();
+
+    iRes = TssOpen(pszStoreFile_l, true);
+    if (iRes < 0)
+    {
+        fprintf(stderr, "ERROR: can't open Time Series Store '%s' (iRes=%d)!\n", pszStoreFile_l, iRes);
+        return (-1);
+    }
+    dOpenTime = AppGetTime() - dStartTime;
+
+    pOutputFile = stdout;
+    if (pszOutputFile_l != NULL)
+    {
+        pOutputFile = fopen(pszOutputFile_l, "w");
+        if (pOutputFile == NULL)
+        {
+            fprintf(stderr, "ERROR: can't create output file '%s'!\n", pszOutputFile_l);
+            TssClose();
+            return (-2);
+        }
+    }
+
+    if (StoreLevel_l == kTssLevelRaw)
+    {
+        fprintf(pOutputFile, "DevID,Field,TimeStamp,TimeStampFmt,Value\n");
+    }
+    else
+    {
+        fprintf(pOutputFile, "DevID,Field,TimeStamp,TimeStampFmt,Min,Max,Mean,Count\n");
+    }
+
+    ui64Rows = 0;
+    for (uiDevID=0; uiDevID<TSS_MAX_DEVICES; uiDevID++)
+    {
+        if ((iQueryDevID_l >= 0) && (uiDevID != (uint)iQueryDevID_l))
+        {
+            continue;
+        }
+        for (uiField=0; uiField<kTssNumFields; uiField++)
+        {
+            if ( ((iStoreField_l >= 0) && (uiField != (uint)iStoreField_l)) ||
+                 !TssHasSeries((uint8_t)uiDevID, (tTssField)uiField) )
+            {
+                continue;
+            }
+            uiDecimals = TssGetFieldDecimals((tTssField)uiField);
+
+            if (StoreLevel_l == kTssLevelRaw)
+            {
+                TssQueryRaw((uint8_t)uiDevID, (tTssField)uiField, i64QueryFromTime_l, i64QueryToTime_l, &vecPoints);
+                for (const tTssPoint& Point : vecPoints)
+                {
+                    AppFormatTime(Point.m_i64Time, szTimeStamp, sizeof(szTimeStamp));
+                    fprintf(pOutputFile, "%u,%s,%lld,%s,%.*f\n", uiDevID, TssGetFieldName((tTssField)uiField),
+                            (long long)Point.m_i64Time, szTimeStamp, (int)uiDecimals, Point.m_dValue);
+                }
+                ui64Rows += vecPoints.size();
+            }
+            else
+            {
+                TssQueryAggregate((uint8_t)uiDevID, (tTssField)uiField, StoreLevel_l, i64QueryFromTime_l, i64QueryToTime_l, &vecAggregates);
+                for (const tTssAggregate& Aggregate : vecAggregates)
+                {
+                    AppFormatTime(Aggregate.m_i64Time, szTimeStamp, sizeof(szTimeStamp));
+                    fprintf(pOutputFile, "%u,%s,%lld,%s,%.*f,%.*f,%.*f,%u\n", uiDevID, TssGetFieldName((tTssField)uiField),
+                            (long long)Aggregate.m_i64Time, szTimeStamp,
+                            (int)uiDecimals, Aggregate.m_dMin, (int)uiDecimals, Aggregate.m_dMax,
+                            (int)uiDecimals + 2, Aggregate.m_dMean, (uint)Aggregate.m_ui32Count);
+                }
+                ui64Rows += vecAggregates.size();
+            }
+        }
+    }
+
+    if (pOutputFile != stdout)
+    {
+        fclose(pOutputFile);
+    }
+    TssGetStatistics(&Statistics);
+    TssClose();
+
+    if (Statistics.m_uiBlocksDamaged > 0)
+    {
+        fprintf(stderr, "WARNING: %u damaged blocks skipped!\n", Statistics.m_uiBlocksDamaged);
+    }
+
+    if ( fVerbose_l )
+    {
+        fprintf(stderr, "Query Statistics:\n");
+        fprintf(stderr, "  Store:           %u series, %u blocks (%.1f MB), %llu points\n", Statistics.m_uiSeries, Statistics.m_uiBlocks,
+                (double)Statistics.m_ui64BytesStored / (1024.0 * 1024.0), (unsigned long long)Statistics.m_ui64PointsLoaded);
+        fprintf(stderr, "  Open:            %.3f [sec]\n", dOpenTime);
+        fprintf(stderr, "  Rows:            %llu\n", (unsigned long long)ui64Rows);
+        fprintf(stderr, "  Runtime:         %.3f [sec]\n", AppGetTime() - dStartTime);
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Benchmark: Time Series Store
+//---------------------------------------------------------------------------
+//  The synthetic messages are added through TssAddMessage() as by the
+//  Gateway. After reopening the StoreFile (replay of all blocks) the range
+//  scans and aggregate queries are measured for a single series each, the
+//  queries cycle through the devices. The synthetic values change with
+//  every record, so the compression is lower than with real sensor data.
+
+static  int  AppRunStoreBench (void)
+{
+
+static const uint  uiQueries = 256;
+static const struct
+{
+    const char*  m_pszName;
+    tTssLevel    m_Level;
+    int64_t      m_i64Range;                            // [sec] ending at newest point, < 0: starting at oldest point
+}  aQuery[] =
+{
+    { "raw,  1 day",                kTssLevelRaw,       86400        },
+    { "raw,  30 days",              kTssLevelRaw,       30 * 86400   },
+    { "min,  1 day",                kTssLevelMinute,    86400        },
+    { "hour, 30 days",              kTssLevelHour,      30 * 86400   },
+    { "hour, 30 days (blocks)",     kTssLevelHour,      -30 * 86400  },
+    { "day,  all",                  kTssLevelDay,       INT64_MAX    }
+};
+std::vector<tTssPoint>      vecPoints;
+std::vector<tTssAggregate>  vecAggregates;
+tTssStatistics  Statistics;
+tJsonMessage    JsonMessage;
+std::string     strFileName;
+uint64_t        ui64FileSize;
+uint64_t        ui64Points;
+uint64_t        ui64Results;
+int64_t         i64FirstTime;
+int64_t         i64LastTime;
+int64_t         i64FromTime;
+int64_t         i64ToTime;
+double          dStartTime;
+double          dIngestTime;
+double          dCloseTime;
+double          dOpenTime;
+double          dScanTime;
+double          dQueryTime;
+uint            uiRec;
+uint            uiQuery;
+uint            uiIdx;
+uint            uiDevID;
+uint            uiField;
+int             iRes;
+
+
+    AppPrintBanner();
+
+    strFileName  = std::string((!vecMsgLogFiles_l.empty()) ? vecMsgLogFiles_l[0] : APP_DEF_BENCH_FILE) + ".tss";
+    i64FirstTime = APP_SYNTH_START_TIME + ((int64_t)APP_SYNTH_DEVICES * APP_SYNTH_CYCLE_TIME / APP_SYNTH_DEVICES);
+    i64LastTime  = APP_SYNTH_START_TIME + ((int64_t)(uiTssBenchRecords_l - 1) * APP_SYNTH_CYCLE_TIME / APP_SYNTH_DEVICES);
+
+    printf("Time Series Store Benchmark: %u synthetic Messages (%u devices, %.0f days)\n\n", uiTssBenchRecords_l,
+           APP_SYNTH_DEVICES, (double)(i64LastTime - i64FirstTime) / 86400.0);
+    unlink(strFileName.c_str());
+
+    // ingest
+    iRes = TssOpen(strFileName.c_str(), false);
+    if (iRes < 0)
+    {
+        printf("ERROR: can't create '%s' (iRes=%d)!\n", strFileName.c_str(), iRes);
+        return (-1);
+    }
+    dStartTime = AppGetTime();
+    for (uiRec=0; uiRec<uiTssBenchRecords_l; uiRec++)
+    {
+        AppBuildSynthMessage(uiRec, false, &JsonMessage);
+        TssAddMessage(&JsonMessage);
+    }
+    dIngestTime = AppGetTime() - dStartTime;
+    TssGetStatistics(&Statistics);
+    dStartTime = AppGetTime();
+    TssClose();
+    dCloseTime = AppGetTime() - dStartTime;
+    ui64Points = Statistics.m_ui64PointsAdded;
+    ui64FileSize = AppGetFileSize(strFileName.c_str());
+
+    printf("Ingest:       %llu Points in %.3f [sec] -> %.1f M Points/s\n", (unsigned long long)ui64Points,
+           dIngestTime, (double)ui64Points / dIngestTime / 1000000.0);
+    printf("Rollups:      %u min, %u hour, %u day (in memory)\n", Statistics.m_uiRollups[kTssLevelMinute],
+           Statistics.m_uiRollups[kTssLevelHour], Statistics.m_uiRollups[kTssLevelDay]);
+    printf("Close:        %.3f [sec] (write of open blocks)\n", dCloseTime);
+    printf("StoreFile:    %.2f MB -> %.2f Bytes/Point (uncompressed: 16, binary MessageLog: %.1f)\n",
+           (double)ui64FileSize / (1024.0 * 1024.0), (double)ui64FileSize / (double)ui64Points,
+           (double)MLF_RECORD_SIZE / (double)kTssNumFields);
+
+    // reopen (replay of all blocks)
+    dStartTime = AppGetTime();
+    iRes = TssOpen(strFileName.c_str(), true);
+    dOpenTime = AppGetTime() - dStartTime;
+    if (iRes < 0)
+    {
+        printf("ERROR: can't open '%s' (iRes=%d)!\n", strFileName.c_str(), iRes);
+        unlink(strFileName.c_str());
+        return (-2);
+    }
+    TssGetStatistics(&Statistics);
+    printf("Open:         %u Blocks replayed in %.3f [sec] -> %.1f M Points/s\n", Statistics.m_uiBlocks,
+           dOpenTime, (double)Statistics.m_ui64PointsLoaded / dOpenTime / 1000000.0);
+
+    // full range scan of all series
+    ui64Results = 0;
+    dStartTime = AppGetTime();
+    for (uiDevID=0; uiDevID<APP_SYNTH_DEVICES; uiDevID++)
+    {
+        for (uiField=0; uiField<kTssNumFields; uiField++)
+        {
+            TssQueryRaw((uint8_t)uiDevID, (tTssField)uiField, INT64_MIN, INT64_MAX, &vecPoints);
+            ui64Results += vecPoints.size();
+        }
+    }
+    dScanTime = AppGetTime() - dStartTime;
+    printf("Full Scan:    %llu Points in %.3f [sec] -> %.1f M Points/s\n", (unsigned long long)ui64Results,
+           dScanTime, (double)ui64Results / dScanTime / 1000000.0);
+    printf("\n");
+
+    // queries of single series
+    printf("Query (Temperature)      Results  Time/Query [us]\n");
+    printf("----------------------  --------  ---------------\n");
+    for (uiQuery=0; uiQuery<(sizeof(aQuery)/sizeof(aQuery[0])); uiQuery++)
+    {
+        if (aQuery[uiQuery].m_i64Range == INT64_MAX)
+        {
+            i64FromTime = INT64_MIN;
+            i64ToTime   = INT64_MAX;
+        }
+        else if (aQuery[uiQuery].m_i64Range < 0)
+        {
+            i64FromTime = i64FirstTime;
+            i64ToTime   = i64FirstTime - aQuery[uiQuery].m_i64Range;
+        }
+        else
+        {
+            i64FromTime = i64LastTime - aQuery[uiQuery].m_i64Range;
+            i64ToTime   = i64LastTime;
+        }
+        if ((i64FromTime < i64FirstTime - 86400) || (i64ToTime > i64LastTime + 86400))
+        {
+            if (aQuery[uiQuery].m_i64Range != INT64_MAX)
+            {
+                printf("%-22s  %8s  %15s\n", aQuery[uiQuery].m_pszName, "-", "(too few data)");
+                continue;
+            }
+        }
+
+        ui64Results = 0;
+        dStartTime = AppGetTime();
+        for (uiIdx=0; uiIdx<uiQueries; uiIdx++)
+        {
+            uiDevID = uiIdx % APP_SYNTH_DEVICES;
+            if (aQuery[uiQuery].m_Level == kTssLevelRaw)
+            {
+                TssQueryRaw((uint8_t)uiDevID, kTssFieldTemperature, i64FromTime, i64ToTime, &vecPoints);
+                ui64Results += vecPoints.size();
+            }
+            else
+            {
+                TssQueryAggregate((uint8_t)uiDevID, kTssFieldTemperature, aQuery[uiQuery].m_Level, i64FromTime, i64ToTime, &vecAggregates);
+                ui64Results += vecAggregates.size();
+            }
+        }
+        dQueryTime = AppGetTime() - dStartTime;
+        printf("%-22s  %8llu  %15.1f\n", aQuery[uiQuery].m_pszName, (unsigned long long)(ui64Results / uiQueries),
+               dQueryTime * 1000000.0 / uiQueries);
+    }
+    printf("\n");
+
+    TssClose();
+    unlink(strFileName.c_str());
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Benchmark: HTTP Query API of Last Value Cache
+//---------------------------------------------------------------------------
+//  The clients poll like dashboards: each one keeps a connection open and
+//  requests '/devices' and '/devices/<dev_id>' in turn, with the ETag of
+//  its last response in 'If-None-Match'. The first run is done without
+//  ingest (mostly '304 Not Modified'), during the second run a thread
+//  updates the cache as fast as it can, so nearly every request gets a new
+//  body. Latency is measured from sending the request to the complete
+//  response.
+
+static  int  AppRunCacheBench (void)
+{
+
+static const char*  apszPhase[2] = { "no ingest", "full rate ingest" };
+std::vector<tJsonMessage>  vecMessages;
+std::vector<std::thread>   vecClients;
+std::vector<tAppClientStat>  vecClientStat;
+std::vector<float>         vecLatency;
+std::atomic<bool>          fStop;
+std::atomic<uint64_t>      ui64Ingested;
+std::thread                IngestThread;
+tLvcStatistics             Statistics;
+tAppClientStat             Total;
+uint16_t                   ui16Port;
+double                     dStartTime;
+double                     dRunTime;
+uint                       uiPhase;
+uint                       uiClient;
+uint                       uiRec;
+int                        iRes;
+
+
+    AppPrintBanner();
+
+    iRes = LvcOpen("127.0.0.1", 0);
+    if (iRes < 0)
+    {
+        printf("ERROR: can't start HTTP server (iRes=%d)!\n", iRes);
+        return (-1);
+    }
+    ui16Port = LvcGetPort();
+
+    // Bootup and first Data Record of all devices, then the messages cycled by the ingest thread
+    vecMessages.resize(APP_LVC_BENCH_MESSAGES);
+    for (uiRec=0; uiRec<APP_LVC_BENCH_MESSAGES; uiRec++)
+    {
+        AppBuildSynthMessage(uiRec, true, &vecMessages[uiRec]);
+        if (uiRec < (2 * APP_SYNTH_DEVICES))
+        {
+            LvcUpdate(&vecMessages[uiRec]);
+        }
+    }
+
+    printf("Query API Benchmark: %u clients, %u devices, %u sec per run (port %u)\n\n",
+           uiLvcBenchClients_l, APP_SYNTH_DEVICES, APP_LVC_BENCH_TIME, (uint)ui16Port);
+    printf("Run                Ingest [Rec/s]  Requests/s   304   p50 [us]   p99 [us]  p99.9 [us]  max [us]  Errors\n");
+    printf("----------------  ---------------  ----------  ----  ---------  ---------  ----------  --------  ------\n");
+
+    for (uiPhase=0; uiPhase<2; uiPhase++)
+    {
+        fStop = false;
+        ui64Ingested = 0;
+        vecClientStat.assign(uiLvcBenchClients_l, tAppClientStat());
+        vecClients.clear();
+
+        for (uiClient=0; uiClient<uiLvcBenchClients_l; uiClient++)
+        {
+            vecClients.push_back(std::thread(AppCacheBenchClient, ui16Port, uiClient, &fStop, &vecClientStat[uiClient]));
+        }
+        if (uiPhase == 1)
+        {
+            IngestThread = std::thread([&]()
+            {
+                uint  uiIdx;
+                uint  uiRound;
+                for (uiRound=1; !fStop.load(std::memory_order_relaxed); uiRound++)
+                {
+                    // Data Records only, each round with newer TimeStamps
+                    for (uiIdx=(2 * APP_SYNTH_DEVICES); uiIdx<vecMessages.size(); uiIdx++)
+                    {
+                        vecMessages[uiIdx].m_tmTimeStamp += (time_t)APP_LVC_BENCH_MESSAGES * APP_SYNTH_CYCLE_TIME;
+                        LvcUpdate(&vecMessages[uiIdx]);
+                    }
+                    ui64Ingested.fetch_add(vecMessages.size() - (2 * APP_SYNTH_DEVICES), std::memory_order_relaxed);
+                }
+            });
+        }
+
+        dStartTime = AppGetTime();
+        usleep(APP_LVC_BENCH_TIME * 1000000);
+        fStop = true;
+        dRunTime = AppGetTime() - dStartTime;
+        for (std::thread& Client : vecClients)
+        {
+            Client.join();
+        }
+        if (uiPhase == 1)
+        {
+            IngestThread.join();
+        }
+
+        Total = tAppClientStat();
+        vecLatency.clear();
+        for (const tAppClientStat& ClientStat : vecClientStat)
+        {
+            Total.m_ui64Requests  += ClientStat.m_ui64Requests;
+            Total.m_ui64Status304 += ClientStat.m_ui64Status304;
+            Total.m_uiErrors      += ClientStat.m_uiErrors;
+            vecLatency.insert(vecLatency.end(), ClientStat.m_vecLatency.begin(), ClientStat.m_vecLatency.end());
+        }
+        std::sort(vecLatency.begin(), vecLatency.end());
+        if ( vecLatency.empty() )
+        {
+            vecLatency.push_back(0);
+        }
+
+        printf("%-16s  %15.0f  %10.0f  %3.0f%%  %9.1f  %9.1f  %10.1f  %8.0f  %6u\n",
+               apszPhase[uiPhase], (double)ui64Ingested / dRunTime, (double)Total.m_ui64Requests / dRunTime,
+               (Total.m_ui64Requests > 0) ? ((double)Total.m_ui64Status304 * 100.0 / (double)Total.m_ui64Requests) : 0.0,
+               vecLatency[vecLatency.size() / 2], vecLatency[(vecLatency.size() * 99) / 100],
+               vecLatency[(vecLatency.size() * 999) / 1000], vecLatency.back(), Total.m_uiErrors);
+    }
+    printf("\n");
+
+    LvcGetStatistics(&Statistics);
+    LvcClose();
+
+    printf("Server: %llu requests, %llu bodies of '/devices' built, %u connections max\n",
+           (unsigned long long)Statistics.m_ui64Requests, (unsigned long long)Statistics.m_ui64Renders, Statistics.m_uiMaxConnections);
+    printf("\n");
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Query API Benchmark: Client Thread
+//---------------------------------------------------------------------------
+//  A response is counted as error if the connection fails, the status is
+//  neither 200 nor 304 or the body is no complete Json object.
+
+static  void  AppCacheBenchClient (
+    uint16_t ui16Port_p,
+    uint uiClient_p,
+    std::atomic<bool>* pfStop_p,
+    tAppClientStat* pClientStat_p)
+{
+
+std::string         astrETag[APP_SYNTH_DEVICES + 1];
+std::string         strResponse;
+struct sockaddr_in  SockAddr;
+char                szRequest[256];
+char                abBuffer[16384];
+const char*         pszValue;
+size_t              nHeaderEnd;
+size_t              nContentLen;
+ssize_t             nLen;
+double              dStartTime;
+uint                uiPath;
+uint                uiStatus;
+int                 iSocket;
+int                 iOptVal;
+
+
+    memset(&SockAddr, 0, sizeof(SockAddr));
+    SockAddr.sin_family      = AF_INET;
+    SockAddr.sin_port        = htons(ui16Port_p);
+    SockAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    iSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if ((iSocket < 0) || (connect(iSocket, (struct sockaddr*)&SockAddr, sizeof(SockAddr)) != 0))
+    {
+        pClientStat_p->m_uiErrors++;
+        if (iSocket >= 0)
+        {
+            close(iSocket);
+        }
+        return;
+    }
+    iOptVal = 1;
+    setsockopt(iSocket, IPPROTO_TCP, TCP_NODELAY, &iOptVal, sizeof(iOptVal));
+
+    for (uiPath=uiClient_p; !pfStop_p->load(std::memory_order_relaxed); uiPath++)
+    {
+        uiPath %= (APP_SYNTH_DEVICES + 1);
+        if (uiPath == 0)
+        {
+            nLen = snprintf(szRequest, sizeof(szRequest), "GET /devices HTTP/1.1\r\nHost: localhost\r\n");
+        }
+        else
+        {
+            nLen = snprintf(szRequest, sizeof(szRequest), "GET /devices/%u HTTP/1.1\r\nHost: localhost\r\n", uiPath - 1);
+        }
+        if ( !astrETag[uiPath].empty() )
+        {
+            nLen += snprintf(szRequest + nLen, sizeof(szRequest) - nLen, "If-None-Match: %s\r\n", astrETag[uiPath].c_str());
+        }
+        nLen += snprintf(szRequest + nLen, sizeof(szRequest) - nLen, "\r\n");
+
+        dStartTime = AppGetTime();
+        if (send(iSocket, szRequest, (size_t)nLen, MSG_NOSIGNAL) != nLen)
+        {
+            pClientStat_p->m_uiErrors++;
+            break;
+        }
+
+        // receive header, then body of given length
+        strResponse.clear();
+        nHeaderEnd = std::string::npos;
+        nContentLen = 0;
+        while ((nHeaderEnd == std::string::npos) || (strResponse.length() < (nHeaderEnd + 4 + nContentLen)))
+        {
+            nLen = recv(iSocket, abBuffer, sizeof(abBuffer), 0);
+            if (nLen <= 0)
+            {
+                break;
+            }
+            strResponse.append(abBuffer, (size_t)nLen);
+            if (nHeaderEnd == std::string::npos)
+            {
+                nHeaderEnd = strResponse.find("\r\n\r\n");
+                if (nHeaderEnd != std::string::npos)
+                {
+                    pszValue = strstr(strResponse.c_str(), "Content-Length: ");
+                    nContentLen = ((pszValue != NULL) && (pszValue < strResponse.c_str() + nHeaderEnd)) ?
+                                  (size_t)atoi(pszValue + sizeof("Content-Length: ")-1) : 0;
+                }
+            }
+        }
+        if ((nHeaderEnd == std::string::npos) || (strResponse.length() != (nHeaderEnd + 4 + nContentLen)))
+        {
+            pClientStat_p->m_uiErrors++;
+            break;
+        }
+        pClientStat_p->m_vecLatency.push_back((float)((AppGetTime() - dStartTime) * 1000000.0));
+        pClientStat_p->m_ui64Requests++;
+
+        uiStatus = (uint)atoi(strResponse.c_str() + sizeof("HTTP/1.1 ")-1);
+        pszValue = strstr(strResponse.c_str(), "ETag: ");
+        if ((pszValue != NULL) && (pszValue < strResponse.c_str() + nHeaderEnd))
+        {
+            pszValue += sizeof("ETag: ")-1;
+            astrETag[uiPath].assign(pszValue, strcspn(pszValue, "\r"));
+        }
+        if (uiStatus == 304)
+        {
+            pClientStat_p->m_ui64Status304++;
+        }
+        else if ( (uiStatus != 200) || (nContentLen < 3) ||
+                  (strResponse[nHeaderEnd + 4] != '{') || (strResponse.compare(strResponse.length() - 2, 2, "}\n") != 0) )
+        {
+            pClientStat_p->m_uiErrors++;
+        }
+    }
+
+    close(iSocket);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Follow Shared Memory Ring of LoraPacketRecv
+//---------------------------------------------------------------------------
+//  Outputs the records published by 'LoraPacketRecv -x' as they arrive, in
+//  the same format as a query of a binary MessageLog (also an example for
+//  the use of the reader library). If the gateway isn't running or is
+//  restarted, the ring is (re)attached as soon as it exists again and all
+//  records of the new ring are output.
+
+static  int  AppFollowRing (void)
+{
+
+tSrrReader         Reader;
+const tMlfRecord*  pMlfRecord;
+tPprRecordFields   RecordFields;
+std::string        strOutput;
+uint64_t           ui64Lost;
+bool               fAttached;
+bool               fFromOldest;
+bool               fValid;
+int                iRes;
+
+
+    signal(SIGINT,  AppSigHandler);
+    signal(SIGTERM, AppSigHandler);
+    fRunFollow_l = true;
+    fAttached   = false;
+    fFromOldest = false;
+    ui64Lost    = 0;
+
+    if (OutputFormat_l == kAppOutputCsv)
+    {
+        printf("%s\n", PprBuildCsvHeader().c_str());
+        fflush(stdout);
+    }
+
+    while ( fRunFollow_l )
+    {
+        if ( !fAttached )
+        {
+            iRes = SrrOpen(pszShmRingName_l, fFromOldest, &Reader);
+            if (iRes < 0)
+            {
+                fFromOldest = true;
+                sleep(1);
+                continue;
+            }
+            fAttached = true;
+            if ( fVerbose_l )
+            {
+                fprintf(stderr, "Attached to Shared Memory Ring '%s' (%u slots)\n", pszShmRingName_l, Reader.m_pHeader->m_ui32Slots);
+            }
+        }
+
+        iRes = SrrWait(&Reader, APP_FOLLOW_WAIT_TIME);
+        if (iRes < 0)
+        {
+            // writer has closed the ring or is gone
+            ui64Lost += Reader.m_ui64Lost;
+            SrrClose(&Reader);
+            fAttached   = false;
+            fFromOldest = true;
+            if ( fVerbose_l )
+            {
+                fprintf(stderr, "Shared Memory Ring '%s' closed (writer stopped)\n", pszShmRingName_l);
+            }
+            continue;
+        }
+
+        while ((pMlfRecord = SrrPeek(&Reader, NULL)) != NULL)
+        {
+            // the record is used in place, the output is only written if
+            // it wasn't overwritten meanwhile
+            strOutput.clear();
+            fValid = ( (iQueryDevID_l < 0) || (pMlfRecord->m_ui8DevID == iQueryDevID_l) ) &&
+                     ( MlrGetRecordFields(pMlfRecord, &RecordFields) >= 0 );
+            if ( fValid )
+            {
+                AppFormatRecord(&RecordFields, &strOutput);
+            }
+            if ( SrrRelease(&Reader) )
+            {
+                fwrite(strOutput.c_str(), 1, strOutput.length(), stdout);
+            }
+        }
+        fflush(stdout);
+    }
+
+    if ( fAttached )
+    {
+        ui64Lost += Reader.m_ui64Lost;
+        SrrClose(&Reader);
+    }
+    if (ui64Lost > 0)
+    {
+        fprintf(stderr, "WARNING: %llu records lost (overwritten before they were read)!\n", (unsigned long long)ui64Lost);
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Benchmark: Shared Memory Ring
+//---------------------------------------------------------------------------
+//  The readers are threads, but each one attaches to the ring by its name
+//  and uses its own read-only mapping, exactly like a separate process.
+//  The first run publishes records paced (far above LoRa rate, but leaving
+//  time to the readers), so the latency shows the wakeup of a waiting
+//  reader. The second run publishes at full rate, in the third one an
+//  additional reader stalls during the whole run, which must not slow down
+//  the writer (it only loses the overwritten records). Each record is
+//  checked in place by its CRC, a record that passed SrrRelease() but has
+//  an invalid CRC would be a torn read.
+
+static  int  AppRunRingBench (void)
+{
+
+static const char*  apszRun[3] = { "paced", "full rate", "full rate+stall" };
+char                        szName[64];
+std::vector<tJsonMessage>   vecMessages;
+std::vector<std::thread>    vecReaders;
+std::vector<tAppReaderStat> vecReaderStat;
+std::vector<float>          vecLatency;
+std::atomic<uint>           uiReady;
+std::atomic<bool>           fStop;
+tAppReaderStat              Total;
+tSrwStatistics              Statistics;
+double                      dStartTime;
+double                      dRunTime;
+uint                        uiRecords;
+uint                        uiReaders;
+uint                        uiReader;
+uint                        uiRun;
+uint                        uiRec;
+int                         iRes;
+
+
+    AppPrintBanner();
+
+    snprintf(szName, sizeof(szName), "/LoraMsgLogBench.%d", (int)getpid());
+    iRes = SrwOpen(szName, APP_SRG_BENCH_SLOTS);
+    if (iRes < 0)
+    {
+        printf("ERROR: can't create shared memory ring '%s' (iRes=%d)!\n", szName, iRes);
+        return (-1);
+    }
+
+    vecMessages.resize(APP_SRG_BENCH_MESSAGES);
+    for (uiRec=0; uiRec<APP_SRG_BENCH_MESSAGES; uiRec++)
+    {
+        AppBuildSynthMessage(uiRec, false, &vecMessages[uiRec]);
+    }
+
+    printf("Shared Memory Ring Benchmark: %u readers, %u slots\n\n", uiSrgBenchReaders_l, APP_SRG_BENCH_SLOTS);
+    printf("Run               Records  Writer [Rec/s]   Received       Lost  p50 [us]  p99 [us]   max [us]  Torn\n");
+    printf("---------------  --------  --------------  ---------  ---------  --------  --------  ---------  ----\n");
+
+    for (uiRun=0; uiRun<3; uiRun++)
+    {
+        uiRecords = (uiRun == 0) ? APP_SRG_PACED_RECORDS : APP_SRG_BENCH_RECORDS;
+        uiReaders = (uiRun == 2) ? (uiSrgBenchReaders_l + 1) : uiSrgBenchReaders_l;
+        uiReady = 0;
+        fStop = false;
+        vecReaderStat.assign(uiReaders, tAppReaderStat());
+        vecReaders.clear();
+        for (uiReader=0; uiReader<uiReaders; uiReader++)
+        {
+            vecReaders.push_back(std::thread(AppRingBenchReader, szName, (uiReader == uiSrgBenchReaders_l), &uiReady, &fStop, &vecReaderStat[uiReader]));
+        }
+        while (uiReady.load() < uiReaders)
+        {
+            usleep(1000);
+        }
+
+        dStartTime = AppGetTime();
+        for (uiRec=0; uiRec<uiRecords; uiRec++)
+        {
+            SrwPublish(&vecMessages[uiRec % APP_SRG_BENCH_MESSAGES]);
+            if (uiRun == 0)
+            {
+                usleep(APP_SRG_PACED_INTERVAL);
+            }
+        }
+        dRunTime = AppGetTime() - dStartTime;
+        fStop = true;
+        for (std::thread& ReaderThread : vecReaders)
+        {
+            ReaderThread.join();
+        }
+
+        Total = tAppReaderStat();
+        vecLatency.clear();
+        for (const tAppReaderStat& ReaderStat : vecReaderStat)
+        {
+            Total.m_ui64Received += ReaderStat.m_ui64Received;
+            Total.m_ui64Lost     += ReaderStat.m_ui64Lost;
+            Total.m_uiTorn       += ReaderStat.m_uiTorn;
+            Total.m_uiErrors     += ReaderStat.m_uiErrors;
+            vecLatency.insert(vecLatency.end(), ReaderStat.m_vecLatency.begin(), ReaderStat.m_vecLatency.end());
+        }
+        std::sort(vecLatency.begin(), vecLatency.end());
+        if ( vecLatency.empty() )
+        {
+            vecLatency.push_back(0);
+        }
+
+        printf("%-15s  %8u  %14.0f  %9llu  %9llu  %8.1f  %8.1f  %9.0f  %4u\n",
+               apszRun[uiRun], uiRecords, (double)uiRecords / dRunTime,
+               (unsigned long long)Total.m_ui64Received, (unsigned long long)Total.m_ui64Lost,
+               vecLatency[vecLatency.size() / 2], vecLatency[(vecLatency.size() * 99) / 100],
+               vecLatency.back(), Total.m_uiTorn + Total.m_uiErrors);
+        if (uiRun == 2)
+        {
+            printf("%-15s  %8s  %14s  %9llu  %9llu\n", "  stalled", "", "",
+                   (unsigned long long)vecReaderStat[uiSrgBenchReaders_l].m_ui64Received,
+                   (unsigned long long)vecReaderStat[uiSrgBenchReaders_l].m_ui64Lost);
+        }
+    }
+    printf("\n");
+
+    SrwGetStatistics(&Statistics);
+    SrwClose();
+
+    printf("Writer: %llu records published\n", (unsigned long long)Statistics.m_ui64Published);
+    printf("\n");
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Shared Memory Ring Benchmark: Reader Thread
+//---------------------------------------------------------------------------
+//  A stalled reader attaches like the others, but only reads after the
+//  writer has finished.
+
+static  void  AppRingBenchReader (
+    const char* pszName_p,
+    bool fStall_p,
+    std::atomic<uint>* puiReady_p,
+    std::atomic<bool>* pfStop_p,
+    tAppReaderStat* pReaderStat_p)
+{
+
+tSrrReader         Reader;
+const tMlfRecord*  pMlfRecord;
+int64_t            i64PublishTime;
+int64_t            i64Now;
+bool               fCrcOk;
+bool               fDone;
+int                iRes;
+
+
+    iRes = SrrOpen(pszName_p, false, &Reader);
+    puiReady_p->fetch_add(1);
+    if (iRes < 0)
+    {
+        pReaderStat_p->m_uiErrors++;
+        return;
+    }
+
+    do
+    {
+        if ( fStall_p )
+        {
+            while ( !pfStop_p->load() )
+            {
+                usleep(1000);
+            }
+        }
+        else
+        {
+            SrrWait(&Reader, 10);
+        }
+        fDone = pfStop_p->load();
+
+        while ((pMlfRecord = SrrPeek(&Reader, &i64PublishTime)) != NULL)
+        {
+            fCrcOk = MlrCheckRecord(pMlfRecord);
+            i64Now = SrfGetTime();
+            if ( SrrRelease(&Reader) )
+            {
+                if ( !fCrcOk )
+                {
+                    pReaderStat_p->m_uiTorn++;
+                }
+                pReaderStat_p->m_vecLatency.push_back((float)(i64Now - i64PublishTime) / 1000.0f);
+            }
+        }
+    }
+    while ( !fDone );
+
+    pReaderStat_p->m_ui64Received = Reader.m_ui64Received;
+    pReaderStat_p->m_ui64Lost     = Reader.m_ui64Lost;
+    SrrClose(&Reader);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Re-Decode CaptureFiles into MessageFile (option '-c=')
+//---------------------------------------------------------------------------
+//  The MessageFile is created new (an existing one and its Index are
+//  replaced), so the result is the same for each run and thread count.
+
+static  int  AppDecodeCaptures (void)
+{
+
+tCpdDecodeStatistics  DecodeStat;
+std::string  strIndexFile;
+int          iRes;
+
+
+    AppPrintBanner();
+
+    iRes = AppLoadCaptures();
+    if (iRes < 0)
+    {
+        return (-1);
+    }
+
+    strIndexFile = std::string(pszCapOutputFile_l) + MIX_FILE_EXTENSION;
+    unlink(pszCapOutputFile_l);
+    unlink(strIndexFile.c_str());
+    iRes = MfwOpen(pszCapOutputFile_l, CapOutputFormat_l, MIX_DEF_BLOCK_RECORDS, false, NULL);
+    if (iRes < 0)
+    {
+        printf("ERROR: can't open MessageFile (iRes=%d)!\n", iRes);
+        CpdClose();
+        return (-2);
+    }
+
+    printf("Decode into '%s' (%s) with %u threads...\n", pszCapOutputFile_l, ((CapOutputFormat_l == kMfwFormatJson) ? "json" : "binary"), uiThreads_l);
+    iRes = CpdDecode(uiThreads_l, AppCaptureWriteMessage, NULL, &DecodeStat);
+    MfwClose();
+    CpdClose();
+    if (iRes < 0)
+    {
+        printf("ERROR: CpdDecode() failed (iRes=%d)!\n", iRes);
+        return (-3);
+    }
+
+    printf("done: %llu packets (copies merged: %llu, better RSSI: %llu, late copies: %llu, unknown format: %llu)\n",
+           (unsigned long long)DecodeStat.m_ui64Packets, (unsigned long long)DecodeStat.m_ui64Copies,
+           (unsigned long long)DecodeStat.m_ui64BetterRssi, (unsigned long long)DecodeStat.m_ui64LateCopies,
+           (unsigned long long)DecodeStat.m_ui64Unknown);
+    printf("      %llu messages (ignored: %llu), digest 0x%08X, decode %.3f [sec], merge/write %.3f [sec]\n",
+           (unsigned long long)DecodeStat.m_ui64Messages, (unsigned long long)DecodeStat.m_ui64Ignored,
+           DecodeStat.m_ui32Digest, DecodeStat.m_dDecodeTime, DecodeStat.m_dMergeTime);
+    printf("\n");
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Output Function of Re-Decoding: write Json Message to MessageFile
+//---------------------------------------------------------------------------
+
+static  int  AppCaptureWriteMessage (
+    const tJsonMessage* pJsonMessage_p,
+    void* pArg_p)
+{
+
+int  iRes;
+
+
+    iRes = MfwWriteMessage(pJsonMessage_p);
+    if (iRes < 0)
+    {
+        printf("ERROR: MfwWriteMessage() failed (iRes=%d)!\n", iRes);
+        return (-1);
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Scaling of Re-Decoding CaptureFiles (option '-p')
+//---------------------------------------------------------------------------
+//  The decoding is repeated with 1, 2, 4, ... worker threads (up to '-j=').
+//  The output isn't written, but each run has to give the same digest of
+//  all Json Records as the run with one thread. The partitions are the
+//  DevIDs, so more threads than devices can't speed up any further.
+
+static  int  AppRunCaptureBench (void)
+{
+
+tCpdDecodeStatistics  DecodeStat;
+std::vector<uint>  vecThreads;
+uint32_t     ui32RefDigest;
+double       dRefTime;
+double       dTime;
+double       dSpeedup;
+uint         uiThreads;
+uint         uiRun;
+bool         fMismatch;
+int          iRes;
+
+
+    AppPrintBanner();
+
+    iRes = AppLoadCaptures();
+    if (iRes < 0)
+    {
+        return (-1);
+    }
+
+    for (uiThreads=1; uiThreads<uiThreads_l; uiThreads*=2)
+    {
+        vecThreads.push_back(uiThreads);
+    }
+    vecThreads.push_back(uiThreads_l);
+
+    printf("Threads  Decode [sec]  Merge [sec]  Total [sec]  Packets/s  Speedup  Efficiency  Digest\n");
+    printf("-------  ------------  -----------  -----------  ---------  -------  ----------  -------------\n");
+    ui32RefDigest = 0;
+    dRefTime  = 0;
+    fMismatch = false;
+    for (uiRun=0; uiRun<vecThreads.size(); uiRun++)
+    {
+        iRes = CpdDecode(vecThreads[uiRun], NULL, NULL, &DecodeStat);
+        if (iRes < 0)
+        {
+            printf("ERROR: CpdDecode() failed (iRes=%d)!\n", iRes);
+            CpdClose();
+            return (-2);
+        }
+
+        dTime = DecodeStat.m_dDecodeTime + DecodeStat.m_dMergeTime;
+        if (uiRun == 0)
+        {
+            ui32RefDigest = DecodeStat.m_ui32Digest;
+            dRefTime = dTime;
+        }
+        dSpeedup = dRefTime / dTime;
+        if (DecodeStat.m_ui32Digest != ui32RefDigest)
+        {
+            fMismatch = true;
+        }
+        printf("%7u  %12.3f  %11.3f  %11.3f  %9.0f  %7.2f  %9.0f%%  %08X %s\n",
+               vecThreads[uiRun], DecodeStat.m_dDecodeTime, DecodeStat.m_dMergeTime, dTime,
+               DecodeStat.m_ui64Packets / dTime, dSpeedup, (dSpeedup / vecThreads[uiRun]) * 100.0,
+               DecodeStat.m_ui32Digest, ((DecodeStat.m_ui32Digest == ui32RefDigest) ? "ok" : "ERR"));
+    }
+    CpdClose();
+
+    printf("\n");
+    printf("%llu messages (ignored: %llu) from %llu packets (copies merged: %llu, late copies: %llu)\n",
+           (unsigned long long)DecodeStat.m_ui64Messages, (unsigned long long)DecodeStat.m_ui64Ignored,
+           (unsigned long long)DecodeStat.m_ui64Packets, (unsigned long long)DecodeStat.m_ui64Copies,
+           (unsigned long long)DecodeStat.m_ui64LateCopies);
+    printf("Cores: %u, Output: %s\n", std::thread::hardware_concurrency(), (fMismatch ? "DIFFERENT for some thread counts!" : "identical for all thread counts"));
+    printf("\n");
+
+    return (fMismatch ? -3 : 0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Load CaptureFiles (options '-c=' and '-p')
+//---------------------------------------------------------------------------
+
+static  int  AppLoadCaptures (void)
+{
+
+tCpdLoadStatistics  LoadStat;
+int  iRes;
+
+
+    printf("Load %u CaptureFile(s)...\n", (uint)vecMsgLogFiles_l.size());
+    iRes = CpdLoadCaptures(vecMsgLogFiles_l.data(), (uint)vecMsgLogFiles_l.size(), &LoadStat);
+    if (iRes < 0)
+    {
+        printf("ERROR: CpdLoadCaptures() failed (iRes=%d)!\n", iRes);
+        return (-1);
+    }
+
+    printf("done: %llu frames (damaged: %llu, without DevID: %llu), %.1f MB, %u devices, %.3f [sec]\n",
+           (unsigned long long)LoadStat.m_ui64Frames, (unsigned long long)LoadStat.m_ui64Damaged,
+           (unsigned long long)LoadStat.m_ui64NoDevID, (double)LoadStat.m_ui64Bytes / (1024.0 * 1024.0),
+           LoadStat.m_uiPartitions, LoadStat.m_dLoadTime);
+    printf("\n");
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Write synthetic CaptureFile (option '-k=')
+//---------------------------------------------------------------------------
+
+static  int  AppWriteSynthCapture (void)
+{
+
+uint64_t  ui64Frames;
+double    dStartTime;
+int       iRes;
+
+
+    AppPrintBanner();
+
+    printf("Write synthetic capture of %u days (%u devices) to '%s'...\n", uiSynthCapDays_l, uiSynthCapDevices_l, vecMsgLogFiles_l[0]);
+
+    dStartTime = AppGetTime();
+    iRes = CpdWriteSynthCapture(vecMsgLogFiles_l[0], uiSynthCapDays_l, uiSynthCapDevices_l, &ui64Frames);
+    if (iRes < 0)
+    {
+        printf("ERROR: CpdWriteSynthCapture() failed (iRes=%d)!\n", iRes);
+        return (-1);
+    }
+
+    printf("done: %llu frames, %.1f MB, %.3f [sec]\n",
+           (unsigned long long)ui64Frames, (double)AppGetFileSize(vecMsgLogFiles_l[0]) / (1024.0 * 1024.0),
+           AppGetTime() - dStartTime);
+    printf("\n");
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Signal Handler (follow mode)
+//---------------------------------------------------------------------------
+
+static  void  AppSigHandler (
+    int iSignalNum_p)
+{
+
+    fRunFollow_l = false;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Format TimeStamp in local time
+//---------------------------------------------------------------------------
+
+static  void  AppFormatTime (
+    int64_t i64Time_p,
+    char* pszBuffer_p,
+    size_t nBuffSize_p)
+{
+
+struct tm  TimeInfo;
+time_t     tmTime;
+
+
+    tmTime = (time_t)i64Time_p;
+    localtime_r(&tmTime, &TimeInfo);
+    strftime(pszBuffer_p, nBuffSize_p, "%Y/%m/%d - %H:%M:%S", &TimeInfo);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Print Program Banner
+//---------------------------------------------------------------------------
+
+static  void  AppPrintBanner (void)
+{
+
+    printf("\n");
+    printf("********************************************************************\n");
+    printf("  LoRa MessageLog Tool\n");
+    printf("  Version: %u.%02u\n", APP_VER_MAIN, APP_VER_REL);
+    printf("  (c) 2026 Ronald Sieber\n");
+    printf("********************************************************************\n");
+    printf("\n");
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Size of File
+//---------------------------------------------------------------------------
+
+static  uint64_t  AppGetFileSize (
+    const char* pszFileName_p)
+{
+
+struct stat  FileStat;
+
+
+    if (stat(pszFileName_p, &FileStat) != 0)
+    {
+        return (0);
+    }
+
+    return ((uint64_t)FileStat.st_size);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get monotonic Time in [sec]
+//---------------------------------------------------------------------------
+
+static  double  AppGetTime (void)
+{
+
+struct timespec  TimeSpec;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &TimeSpec);
+
+    return ((double)TimeSpec.tv_sec + ((double)TimeSpec.tv_nsec / 1000000000.0));
+
+}
+
+
+
+// EOF
+
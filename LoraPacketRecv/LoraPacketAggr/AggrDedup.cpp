@@ -0,0 +1,804 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Aggregator
+  Description:  Implementation of Cross-Gateway Record Deduplication
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "AggrDedup.h"
+#include "Trace.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+static  const  uint8_t  AGD_GEN_BOOTUP          = 0xFF;     // pseudo generation of StationBootup records
+static  const  int      AGD_RSSI_UNKNOWN        = -1000;
+static  const  uint32_t AGD_HASH_SLOT_FREE      = 0;
+
+
+
+//---------------------------------------------------------------------------
+//  Macro definitions
+//---------------------------------------------------------------------------
+
+#define AGD_MAKE_KEY(DevID, Gen, SequNum)   (((uint64_t)(DevID) << 40) | ((uint64_t)(Gen) << 32) | (uint64_t)(SequNum))
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+//  All records are kept in a ring in order of arrival of their first copy.
+//  Since every record has the same hold and history time, the ring is
+//  split by two cursors, no per-entry state is necessary:
+//
+//      [Head .. Fwd)   forwarded records, remembered to reject late copies
+//      [Fwd  .. Tail)  pending records, waiting for further copies
+//
+//  The sequence numbers are never wrapped, the ring index is (Seq % Capacity).
+//  An open addressing hash table (linear probing, load factor <= 0.5) maps the
+//  key of a record to its ring index, so a lookup costs O(1) regardless of the
+//  number of records in the window.
+static  tAgdRecord*     paRecord_l          = NULL;
+static  uint            uiCapacity_l        = 0;
+static  uint64_t        ui64HeadSeq_l       = 0;
+static  uint64_t        ui64FwdSeq_l        = 0;
+static  uint64_t        ui64TailSeq_l       = 0;
+
+static  uint32_t*       pui32HashSlot_l     = NULL;     // ring index + 1, 0 = free slot
+static  uint            uiHashBits_l        = 0;
+static  uint32_t        ui32HashMask_l      = 0;
+
+static  uint64_t        ui64HoldTimeUs_l    = 0;
+static  uint64_t        ui64HistoryTimeUs_l = 0;
+static  tAgdStatistics  AgdStatistics_l;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  bool  AgdGetRecordKey (
+    const char* pabRecord_p,
+    uint uiRecordLen_p,
+    uint64_t* pui64Key_p,
+    int* piRssi_p);
+
+static  const char*  AgdFindJsonValue (
+    const char* pabRecord_p,
+    uint uiRecordLen_p,
+    const char* pszKey_p);
+
+static  bool  AgdParseInt (
+    const char* pszValue_p,
+    const char* pRecordEnd_p,
+    long* plValue_p);
+
+static  void  AgdExpireRecords (
+    uint64_t ui64NowUs_p);
+
+static  void  AgdRemoveHead (void);
+
+static  uint32_t  AgdHash (
+    uint64_t ui64Key_p);
+
+static  int   AgdHashLookup (
+    uint64_t ui64Key_p);
+
+static  void  AgdHashInsert (
+    uint64_t ui64Key_p,
+    uint uiRecordIdx_p);
+
+static  void  AgdHashRemove (
+    uint64_t ui64Key_p,
+    uint uiRecordIdx_p);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Initialize Deduplication
+//---------------------------------------------------------------------------
+//  All memory is allocated here, the table never grows at runtime.
+
+int  AgdInitialize (
+    uint uiMaxEntries_p,                                // [IN]     Capacity of Table (bounds the memory usage)
+    uint uiHoldTimeMs_p)                                // [IN]     Hold Time for pending Records [ms]
+{
+
+uint  uiHashSize;
+
+
+    AgdShutdown();
+
+    if (uiMaxEntries_p == 0)
+    {
+        return (-1);
+    }
+
+    // hash table with at least twice as many slots as records
+    uiHashBits_l = 1;
+    while ((1u << uiHashBits_l) < (uiMaxEntries_p * 2))
+    {
+        uiHashBits_l++;
+    }
+    uiHashSize     = (1u << uiHashBits_l);
+    ui32HashMask_l = (uint32_t)(uiHashSize - 1);
+
+    paRecord_l      = (tAgdRecord*)calloc(uiMaxEntries_p, sizeof(tAgdRecord));
+    pui32HashSlot_l = (uint32_t*)calloc(uiHashSize, sizeof(uint32_t));
+    if ((paRecord_l == NULL) || (pui32HashSlot_l == NULL))
+    {
+        AgdShutdown();
+        return (-2);
+    }
+
+    uiCapacity_l  = uiMaxEntries_p;
+    ui64HeadSeq_l = 0;
+    ui64FwdSeq_l  = 0;
+    ui64TailSeq_l = 0;
+    memset(&AgdStatistics_l, 0, sizeof(AgdStatistics_l));
+
+    ui64HoldTimeUs_l    = (uint64_t)uiHoldTimeMs_p * 1000;
+    ui64HistoryTimeUs_l = (uint64_t)uiHoldTimeMs_p * 1000 * 10;
+    if (ui64HistoryTimeUs_l < ((uint64_t)AGD_MIN_HISTORY_MS * 1000))
+    {
+        ui64HistoryTimeUs_l = (uint64_t)AGD_MIN_HISTORY_MS * 1000;
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Shutdown Deduplication
+//---------------------------------------------------------------------------
+
+void  AgdShutdown (void)
+{
+
+    free(paRecord_l);
+    free(pui32HashSlot_l);
+    paRecord_l      = NULL;
+    pui32HashSlot_l = NULL;
+    uiCapacity_l    = 0;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Add received Record
+//---------------------------------------------------------------------------
+//  Return:  0 = new record, held back until hold time is elapsed
+//           1 = copy of pending record (merged, best RSSI is kept)
+//           2 = late copy of already forwarded record (discarded)
+//          -1 = invalid record (no key or too long)
+//          -2 = table full of pending records, the caller has to fetch the
+//               ready records first (AgdGetReadyRecord() returns the oldest
+//               pending record early in this case)
+
+int  AgdAddRecord (
+    uint uiGateway_p,                                   // [IN]     Index of receiving Gateway
+    const char* pszTopic_p,                             // [IN]     Topic of MQTT Message
+    uint uiTopicLen_p,                                  // [IN]     Length of Topic
+    const char* pabRecord_p,                            // [IN]     JSON Record (not zero terminated)
+    uint uiRecordLen_p,                                 // [IN]     Length of JSON Record
+    uint64_t ui64NowUs_p)                               // [IN]     Current Time [us]
+{
+
+tAgdRecord*  pRecord;
+uint64_t     ui64Key;
+int          iRssi;
+int          iRecordIdx;
+uint         uiRecordIdx;
+uint         uiUsedEntries;
+
+
+    if ((paRecord_l == NULL) || (uiGateway_p >= AGD_MAX_GATEWAYS))
+    {
+        return (-1);
+    }
+
+    AgdStatistics_l.m_uiRecordsIn++;
+
+    if ((uiRecordLen_p > AGD_MAX_RECORD_LEN) || (uiTopicLen_p >= AGD_MAX_TOPIC_LEN) ||
+        !AgdGetRecordKey(pabRecord_p, uiRecordLen_p, &ui64Key, &iRssi))
+    {
+        AgdStatistics_l.m_uiInvalid++;
+        return (-1);
+    }
+
+    AgdExpireRecords(ui64NowUs_p);
+
+    iRecordIdx = AgdHashLookup(ui64Key);
+    if (iRecordIdx >= 0)
+    {
+        pRecord = &paRecord_l[iRecordIdx];
+
+        // position in ring before forward cursor -> already forwarded
+        if ((uint64_t)(((uint)iRecordIdx + uiCapacity_l - (uint)(ui64HeadSeq_l % uiCapacity_l)) % uiCapacity_l) < (ui64FwdSeq_l - ui64HeadSeq_l))
+        {
+            TRACE3("AgdAddRecord: late copy Key=0x%010llX (Gateway %u, %u us) discarded\n",
+                   (unsigned long long)ui64Key, uiGateway_p, (uint)(ui64NowUs_p - pRecord->m_ui64FirstRxUs));
+            AgdStatistics_l.m_uiLateDuplicates++;
+            return (2);
+        }
+
+        // copy of pending record -> keep the one with best RSSI
+        AgdStatistics_l.m_uiDuplicates++;
+        pRecord->m_ui32GatewayMask |= (1u << uiGateway_p);
+        if (iRssi > pRecord->m_iRssi)
+        {
+            memcpy(pRecord->m_szTopic, pszTopic_p, uiTopicLen_p);
+            pRecord->m_szTopic[uiTopicLen_p] = '\0';
+            memcpy(pRecord->m_szRecord, pabRecord_p, uiRecordLen_p);
+            pRecord->m_szRecord[uiRecordLen_p] = '\0';
+            pRecord->m_uiRecordLen   = uiRecordLen_p;
+            pRecord->m_iRssi         = iRssi;
+            pRecord->m_uiBestGateway = uiGateway_p;
+            AgdStatistics_l.m_uiBetterRssi++;
+        }
+        return (1);
+    }
+
+    // first copy of record -> make room if the ring is full
+    if ((ui64TailSeq_l - ui64HeadSeq_l) >= uiCapacity_l)
+    {
+        if (ui64FwdSeq_l == ui64HeadSeq_l)
+        {
+            AgdStatistics_l.m_uiRecordsIn--;
+            return (-2);
+        }
+        AgdRemoveHead();
+        AgdStatistics_l.m_uiEarlyExpires++;
+    }
+
+    uiRecordIdx = (uint)(ui64TailSeq_l % uiCapacity_l);
+    pRecord = &paRecord_l[uiRecordIdx];
+    pRecord->m_ui64Key         = ui64Key;
+    pRecord->m_ui64FirstRxUs   = ui64NowUs_p;
+    pRecord->m_ui32GatewayMask = (1u << uiGateway_p);
+    pRecord->m_uiBestGateway   = uiGateway_p;
+    pRecord->m_iRssi           = iRssi;
+    pRecord->m_uiRecordLen     = uiRecordLen_p;
+    memcpy(pRecord->m_szTopic, pszTopic_p, uiTopicLen_p);
+    pRecord->m_szTopic[uiTopicLen_p] = '\0';
+    memcpy(pRecord->m_szRecord, pabRecord_p, uiRecordLen_p);
+    pRecord->m_szRecord[uiRecordLen_p] = '\0';
+
+    AgdHashInsert(ui64Key, uiRecordIdx);
+    ui64TailSeq_l++;
+
+    uiUsedEntries = (uint)(ui64TailSeq_l - ui64HeadSeq_l);
+    if (uiUsedEntries > AgdStatistics_l.m_uiMaxEntries)
+    {
+        AgdStatistics_l.m_uiMaxEntries = uiUsedEntries;
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get next Record whose Hold Time has elapsed
+//---------------------------------------------------------------------------
+//  Records are returned in order of arrival of their first copy. The returned
+//  pointer is valid until the next call of AgdAddRecord().
+//  If the table is completely filled with pending records, the oldest one is
+//  returned before its hold time to keep the memory usage bounded.
+
+const tAgdRecord*  AgdGetReadyRecord (
+    uint64_t ui64NowUs_p)                               // [IN]     Current Time [us]
+{
+
+tAgdRecord*  pRecord;
+
+
+    if ((paRecord_l == NULL) || (ui64FwdSeq_l == ui64TailSeq_l))
+    {
+        return (NULL);
+    }
+
+    pRecord = &paRecord_l[ui64FwdSeq_l % uiCapacity_l];
+    if ((pRecord->m_ui64FirstRxUs + ui64HoldTimeUs_l) > ui64NowUs_p)
+    {
+        if ((ui64FwdSeq_l != ui64HeadSeq_l) || ((ui64TailSeq_l - ui64HeadSeq_l) < uiCapacity_l))
+        {
+            return (NULL);
+        }
+        AgdStatistics_l.m_uiEarlyForwards++;
+    }
+
+    ui64FwdSeq_l++;
+    AgdStatistics_l.m_uiRecordsOut++;
+
+    return (pRecord);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Timeout until next pending Record gets ready (for poll())
+//---------------------------------------------------------------------------
+
+int  AgdGetTimeout (
+    uint64_t ui64NowUs_p,                               // [IN]     Current Time [us]
+    int iMaxTimeoutMs_p)                                // [IN]     Timeout if no Record is pending [ms]
+{
+
+uint64_t  ui64ReadyUs;
+int       iTimeoutMs;
+
+
+    if ((paRecord_l == NULL) || (ui64FwdSeq_l == ui64TailSeq_l))
+    {
+        return (iMaxTimeoutMs_p);
+    }
+
+    // the oldest pending record is always the next one to get ready
+    ui64ReadyUs = paRecord_l[ui64FwdSeq_l % uiCapacity_l].m_ui64FirstRxUs + ui64HoldTimeUs_l;
+    if (ui64ReadyUs <= ui64NowUs_p)
+    {
+        return (0);
+    }
+
+    iTimeoutMs = (int)((ui64ReadyUs - ui64NowUs_p + 999) / 1000);
+    if (iTimeoutMs > iMaxTimeoutMs_p)
+    {
+        iTimeoutMs = iMaxTimeoutMs_p;
+    }
+
+    return (iTimeoutMs);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Size of allocated Memory
+//---------------------------------------------------------------------------
+
+size_t  AgdGetMemorySize (void)
+{
+
+    if (paRecord_l == NULL)
+    {
+        return (0);
+    }
+
+    return (((size_t)uiCapacity_l * sizeof(tAgdRecord)) + (((size_t)1 << uiHashBits_l) * sizeof(uint32_t)));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Statistics
+//---------------------------------------------------------------------------
+
+void  AgdGetStatistics (
+    tAgdStatistics* pStatistics_p)                      // [OUT]    Ptr to Statistics
+{
+
+    memcpy(pStatistics_p, &AgdStatistics_l, sizeof(tAgdStatistics));
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Print Statistics
+//---------------------------------------------------------------------------
+
+void  AgdPrintStatistics (void)
+{
+
+    printf("Cross-Gateway Deduplication:\n");
+    printf("  Records received  = %u\n", AgdStatistics_l.m_uiRecordsIn);
+    printf("  Records forwarded = %u\n", AgdStatistics_l.m_uiRecordsOut);
+    printf("  Copies merged     = %u (better RSSI: %u)\n", AgdStatistics_l.m_uiDuplicates, AgdStatistics_l.m_uiBetterRssi);
+    printf("  Late copies       = %u\n", AgdStatistics_l.m_uiLateDuplicates);
+    printf("  Invalid records   = %u\n", AgdStatistics_l.m_uiInvalid);
+    printf("  Early forwards    = %u\n", AgdStatistics_l.m_uiEarlyForwards);
+    printf("  Early expires     = %u\n", AgdStatistics_l.m_uiEarlyExpires);
+    printf("  Max used entries  = %u of %u (%u kByte)\n", AgdStatistics_l.m_uiMaxEntries, uiCapacity_l, (uint)(AgdGetMemorySize() / 1024));
+
+    return;
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Get identification of JSON Record
+//---------------------------------------------------------------------------
+//  StationData records are identified by (DevID, Generation, SequNum).
+//  StationBootup records have no SequNum, here a hash over the part of the
+//  record starting with 'DevID' is used instead - all fields in front of it
+//  (MsgID, TimeStamp, RSSI) are gateway specific, the rest is identical in
+//  all copies of the same transmission.
+
+static  bool  AgdGetRecordKey (
+    const char* pabRecord_p,
+    uint uiRecordLen_p,
+    uint64_t* pui64Key_p,
+    int* piRssi_p)
+{
+
+const char*  pRecordEnd;
+const char*  pszDevID;
+const char*  pszValue;
+const char*  pszData;
+long         lDevID;
+long         lGeneration;
+long         lSequNum;
+long         lRssi;
+uint32_t     ui32Hash;
+
+
+    pRecordEnd = pabRecord_p + uiRecordLen_p;
+
+    pszDevID = AgdFindJsonValue(pabRecord_p, uiRecordLen_p, "\"DevID\":");
+    if ((pszDevID == NULL) || !AgdParseInt(pszDevID, pRecordEnd, &lDevID) || (lDevID < 0) || (lDevID > 0xFFFF))
+    {
+        return (false);
+    }
+
+    pszValue = AgdFindJsonValue(pabRecord_p, uiRecordLen_p, "\"RSSI\":");
+    if ((pszValue == NULL) || !AgdParseInt(pszValue, pRecordEnd, &lRssi))
+    {
+        lRssi = AGD_RSSI_UNKNOWN;
+    }
+    *piRssi_p = (int)lRssi;
+
+    pszValue = AgdFindJsonValue(pabRecord_p, uiRecordLen_p, "\"MsgType\": \"StationDataGen");
+    if (pszValue != NULL)
+    {
+        if ( !AgdParseInt(pszValue, pRecordEnd, &lGeneration) || (lGeneration < 0) || (lGeneration >= AGD_GEN_BOOTUP) )
+        {
+            return (false);
+        }
+        pszValue = AgdFindJsonValue(pabRecord_p, uiRecordLen_p, "\"SequNum\":");
+        if ((pszValue == NULL) || !AgdParseInt(pszValue, pRecordEnd, &lSequNum) || (lSequNum < 0))
+        {
+            return (false);
+        }
+        *pui64Key_p = AGD_MAKE_KEY(lDevID, lGeneration, (uint32_t)lSequNum);
+        return (true);
+    }
+
+    pszValue = AgdFindJsonValue(pabRecord_p, uiRecordLen_p, "\"MsgType\": \"StationBootup\"");
+    if (pszValue != NULL)
+    {
+        // FNV-1a
+        ui32Hash = 2166136261u;
+        for (pszData=pszDevID; pszData<pRecordEnd; pszData++)
+        {
+            ui32Hash = (ui32Hash ^ (uint8_t)*pszData) * 16777619u;
+        }
+        *pui64Key_p = AGD_MAKE_KEY(lDevID, AGD_GEN_BOOTUP, ui32Hash);
+        return (true);
+    }
+
+    return (false);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Find Value of JSON Item (returns pointer behind the given key)
+//---------------------------------------------------------------------------
+
+static  const char*  AgdFindJsonValue (
+    const char* pabRecord_p,
+    uint uiRecordLen_p,
+    const char* pszKey_p)
+{
+
+const char*  pszKey;
+size_t       nKeyLen;
+
+
+    nKeyLen = strlen(pszKey_p);
+    pszKey  = (const char*)memmem(pabRecord_p, uiRecordLen_p, pszKey_p, nKeyLen);
+    if (pszKey == NULL)
+    {
+        return (NULL);
+    }
+
+    return (pszKey + nKeyLen);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Parse decimal Integer (bounded by end of record, not zero terminated)
+//---------------------------------------------------------------------------
+
+static  bool  AgdParseInt (
+    const char* pszValue_p,
+    const char* pRecordEnd_p,
+    long* plValue_p)
+{
+
+const char*  pszValue;
+bool         fNegative;
+long         lValue;
+
+
+    pszValue = pszValue_p;
+    while ((pszValue < pRecordEnd_p) && (*pszValue == ' '))
+    {
+        pszValue++;
+    }
+
+    fNegative = false;
+    if ((pszValue < pRecordEnd_p) && (*pszValue == '-'))
+    {
+        fNegative = true;
+        pszValue++;
+    }
+
+    if ((pszValue >= pRecordEnd_p) || (*pszValue < '0') || (*pszValue > '9'))
+    {
+        return (false);
+    }
+
+    lValue = 0;
+    while ((pszValue < pRecordEnd_p) && (*pszValue >= '0') && (*pszValue <= '9') && (lValue < 0x7FFFFFFF))
+    {
+        lValue = (lValue * 10) + (*pszValue - '0');
+        pszValue++;
+    }
+
+    *plValue_p = (fNegative) ? -lValue : lValue;
+
+    return (true);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Forget forwarded Records after History Time
+//---------------------------------------------------------------------------
+
+static  void  AgdExpireRecords (
+    uint64_t ui64NowUs_p)
+{
+
+    while (ui64HeadSeq_l != ui64FwdSeq_l)
+    {
+        if ((paRecord_l[ui64HeadSeq_l % uiCapacity_l].m_ui64FirstRxUs + ui64HistoryTimeUs_l) > ui64NowUs_p)
+        {
+            break;
+        }
+        AgdRemoveHead();
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Remove oldest Record from Ring
+//---------------------------------------------------------------------------
+
+static  void  AgdRemoveHead (void)
+{
+
+uint  uiRecordIdx;
+
+
+    uiRecordIdx = (uint)(ui64HeadSeq_l % uiCapacity_l);
+    AgdHashRemove(paRecord_l[uiRecordIdx].m_ui64Key, uiRecordIdx);
+    ui64HeadSeq_l++;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Hash Function (Fibonacci Hashing)
+//---------------------------------------------------------------------------
+
+static  uint32_t  AgdHash (
+    uint64_t ui64Key_p)
+{
+
+    return ((uint32_t)((ui64Key_p * 0x9E3779B97F4A7C15ull) >> (64 - uiHashBits_l)));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Lookup Key in Hash Table (returns Ring Index or -1)
+//---------------------------------------------------------------------------
+
+static  int  AgdHashLookup (
+    uint64_t ui64Key_p)
+{
+
+uint32_t  ui32Slot;
+uint32_t  ui32Entry;
+
+
+    ui32Slot = AgdHash(ui64Key_p);
+    for (;;)
+    {
+        ui32Entry = pui32HashSlot_l[ui32Slot];
+        if (ui32Entry == AGD_HASH_SLOT_FREE)
+        {
+            return (-1);
+        }
+        if (paRecord_l[ui32Entry - 1].m_ui64Key == ui64Key_p)
+        {
+            return ((int)(ui32Entry - 1));
+        }
+        ui32Slot = (ui32Slot + 1) & ui32HashMask_l;
+    }
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Insert Key into Hash Table
+//---------------------------------------------------------------------------
+
+static  void  AgdHashInsert (
+    uint64_t ui64Key_p,
+    uint uiRecordIdx_p)
+{
+
+uint32_t  ui32Slot;
+
+
+    // load factor <= 0.5, so there is always a free slot
+    ui32Slot = AgdHash(ui64Key_p);
+    while (pui32HashSlot_l[ui32Slot] != AGD_HASH_SLOT_FREE)
+    {
+        ui32Slot = (ui32Slot + 1) & ui32HashMask_l;
+    }
+    pui32HashSlot_l[ui32Slot] = (uint32_t)(uiRecordIdx_p + 1);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Remove Key from Hash Table
+//---------------------------------------------------------------------------
+//  Backward shift deletion: entries following the removed one in the same
+//  probe sequence are moved up, so no tombstones are left behind and the
+//  lookup time doesn't degrade over time.
+
+static  void  AgdHashRemove (
+    uint64_t ui64Key_p,
+    uint uiRecordIdx_p)
+{
+
+uint32_t  ui32FreeSlot;
+uint32_t  ui32Slot;
+uint32_t  ui32HomeSlot;
+uint32_t  ui32Entry;
+
+
+    ui32FreeSlot = AgdHash(ui64Key_p);
+    while (pui32HashSlot_l[ui32FreeSlot] != (uint32_t)(uiRecordIdx_p + 1))
+    {
+        if (pui32HashSlot_l[ui32FreeSlot] == AGD_HASH_SLOT_FREE)
+        {
+            return;
+        }
+        ui32FreeSlot = (ui32FreeSlot + 1) & ui32HashMask_l;
+    }
+
+    ui32Slot = ui32FreeSlot;
+    for (;;)
+    {
+        ui32Slot  = (ui32Slot + 1) & ui32HashMask_l;
+        ui32Entry = pui32HashSlot_l[ui32Slot];
+        if (ui32Entry == AGD_HASH_SLOT_FREE)
+        {
+            break;
+        }
+
+        // entry can only be moved if its home slot is not between the free slot and its current slot
+        ui32HomeSlot = AgdHash(paRecord_l[ui32Entry - 1].m_ui64Key);
+        if (((ui32Slot - ui32HomeSlot) & ui32HashMask_l) >= ((ui32Slot - ui32FreeSlot) & ui32HashMask_l))
+        {
+            pui32HashSlot_l[ui32FreeSlot] = ui32Entry;
+            ui32FreeSlot = ui32Slot;
+        }
+    }
+
+    pui32HashSlot_l[ui32FreeSlot] = AGD_HASH_SLOT_FREE;
+
+    return;
+
+}
+
+
+
+// EOF
+
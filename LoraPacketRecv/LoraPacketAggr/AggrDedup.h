@@ -0,0 +1,106 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Aggregator
+  Description:  Declarations for Cross-Gateway Record Deduplication
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _AGGRDEDUP_H_
+#define _AGGRDEDUP_H_
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+const  uint  AGD_MAX_GATEWAYS       = 32;       // number of bits in tAgdRecord::m_uiGatewayMask
+const  uint  AGD_DEF_HOLD_TIME_MS   = 500;      // time to wait for copies of a record from further gateways [ms]
+const  uint  AGD_MIN_HISTORY_MS     = 10000;    // time to remember forwarded records to reject late copies [ms]
+const  uint  AGD_DEF_MAX_ENTRIES    = 4096;     // default capacity (pending + remembered records)
+const  uint  AGD_MAX_TOPIC_LEN      = 96;
+const  uint  AGD_MAX_RECORD_LEN     = 1024;     // JSON record as published by LoraPacketRecv
+
+
+
+//---------------------------------------------------------------------------
+//  Type definitions
+//---------------------------------------------------------------------------
+
+typedef struct
+{
+    uint64_t            m_ui64Key;                  // (DevID, Generation, SequNum)
+    uint64_t            m_ui64FirstRxUs;            // arrival of first copy
+    uint32_t            m_ui32GatewayMask;          // gateways which have received the record
+    uint                m_uiBestGateway;            // gateway which has received the copy with best RSSI
+    int                 m_iRssi;                    // best RSSI
+    uint                m_uiRecordLen;
+    char                m_szTopic[AGD_MAX_TOPIC_LEN];
+    char                m_szRecord[AGD_MAX_RECORD_LEN + 1];
+
+} tAgdRecord;
+
+
+typedef struct
+{
+    uint                m_uiRecordsIn;              // records passed to AgdAddRecord()
+    uint                m_uiRecordsOut;             // records returned by AgdGetReadyRecord()
+    uint                m_uiDuplicates;             // copies merged into a pending record
+    uint                m_uiBetterRssi;             // copies which replaced the pending record because of a better RSSI
+    uint                m_uiLateDuplicates;         // copies received after the record was already forwarded
+    uint                m_uiInvalid;                // records without (DevID, SequNum) or exceeding buffer size
+    uint                m_uiEarlyForwards;          // records forwarded before hold time because of a full table
+    uint                m_uiEarlyExpires;           // records forgotten before history time because of a full table
+    uint                m_uiMaxEntries;             // high-water mark of used entries
+
+} tAgdStatistics;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of public functions
+//---------------------------------------------------------------------------
+
+int   AgdInitialize (
+    uint uiMaxEntries_p,                                // [IN]     Capacity of Table (bounds the memory usage)
+    uint uiHoldTimeMs_p);                               // [IN]     Hold Time for pending Records [ms]
+
+void  AgdShutdown (void);
+
+int   AgdAddRecord (
+    uint uiGateway_p,                                   // [IN]     Index of receiving Gateway
+    const char* pszTopic_p,                             // [IN]     Topic of MQTT Message
+    uint uiTopicLen_p,                                  // [IN]     Length of Topic
+    const char* pabRecord_p,                            // [IN]     JSON Record (not zero terminated)
+    uint uiRecordLen_p,                                 // [IN]     Length of JSON Record
+    uint64_t ui64NowUs_p);                              // [IN]     Current Time [us]
+
+const tAgdRecord*  AgdGetReadyRecord (
+    uint64_t ui64NowUs_p);                              // [IN]     Current Time [us]
+
+int   AgdGetTimeout (
+    uint64_t ui64NowUs_p,                               // [IN]     Current Time [us]
+    int iMaxTimeoutMs_p);                               // [IN]     Timeout if no Record is pending [ms]
+
+size_t  AgdGetMemorySize (void);
+
+void  AgdGetStatistics (
+    tAgdStatistics* pStatistics_p);                     // [OUT]    Ptr to Statistics
+
+void  AgdPrintStatistics (void);
+
+
+
+#endif  // #ifndef _AGGRDEDUP_H_
+
+
+// EOF
+
@@ -0,0 +1,1143 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Aggregator
+  Description:  Implementation of Main Module
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+#include "AggrDedup.h"
+#include "MqttClient.h"
+#include "MqttBroker.h"
+#include "Trace.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+#define APP_VER_MAIN            1                       // Version 1.xx
+#define APP_VER_REL             0                       // Version x.00
+
+#define APP_RECONNECT_INTERVAL  10                      // Retry Interval for lost Connections [sec]
+
+
+static  const  char*            MQTT_DEF_HOST_URL       = "127.0.0.1";
+static  const  int              MQTT_DEF_HOST_PORTNUM   = 1883;
+
+static  const  char*            MQTT_CLIENT_NAME        = "LoraPacketAggr";
+static  const  unsigned int     MQTT_KEEPALIVE_INTERVAL = 30;
+
+static  const  char*            MQTT_TOPIC_IN_FILTER    = "LoraAmbMon/Data/#";
+static  const  char*            MQTT_TOPIC_IN_PREFIX    = "LoraAmbMon/Data/";
+static  const  char*            MQTT_TOPIC_OUT_PREFIX   = "LoraAmbMon/Aggr/";
+
+static  const  uint             BENCH_GATEWAYS          = 3;
+static  const  uint             BENCH_DEVICES           = 200;
+static  const  uint             BENCH_RECORDS           = 2000000;
+static  const  uint             BENCH_RECORD_PERIOD_US  = 2500;    // virtual time between two transmissions
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+typedef struct
+{
+    char                m_szName[32];
+    char                m_szHostUrl[128];
+    int                 m_iPortNum;
+    char                m_szClientName[64];
+    tMqcConnection      m_MqttConn;
+    time_t              m_tmNextReconnect;
+    uint                m_uiRecvCount;
+
+} tAppGateway;
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+static  char                    szServerUrl_l[128];
+static  int                     iPortNum_l;             // = MQTT_DEF_HOST_PORTNUM
+static  tAppGateway             aGateway_l[AGD_MAX_GATEWAYS];
+static  uint                    uiGatewayCount_l        = 0;
+static  uint                    uiHoldTimeMs_l          = AGD_DEF_HOLD_TIME_MS;
+static  uint                    uiMaxEntries_l          = AGD_DEF_MAX_ENTRIES;
+static  int                     fOffline_l              = false;
+static  bool                    fVerbose_l              = false;
+static  bool                    fBenchmark_l            = false;
+static  uint                    uiBrokerPort_l          = 0;        // 0 = no broker stand-in
+
+static  volatile bool           fRunMainLoop_l          = false;
+static  tMqcConnection          MqttOutConn_l;
+static  time_t                  tmNextOutReconnect_l    = 0;
+static  uint                    uiForwardCount_l        = 0;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  void  AppSigHandler (int iSignalNum_p);
+
+static  bool  AppEvalCmdlnArgs (int iArgCnt_p, char* apszArg_p[]);
+static  void  AppPrintHelpScreen  (const char* pszArg0_p);
+static  bool  AppParseGatewayCfg (const char* pszGatewayCfg_p);
+
+static  void  AppConnectGateway (
+    uint uiGateway_p);
+
+static  void  AppOnRecvMessage (
+    void* pvArg_p,
+    const char* pszTopic_p,
+    uint uiTopicLen_p,
+    const uint8_t* pabPayload_p,
+    uint uiPayloadLen_p);
+
+static  void  AppForwardReadyRecords (
+    uint64_t ui64NowUs_p);
+
+static  int  AppBuildOutMessage (
+    const tAgdRecord* pRecord_p,
+    char* pszTopicBuffer_p,
+    int iTopicBuffSize_p,
+    char* pszMsgBuffer_p,
+    int iMsgBuffSize_p);
+
+static  void  AppServiceConnections (void);
+
+static  void  AppRunBenchmark (void);
+
+static  uint64_t  AppGetTimeUs (void);
+
+static  int  FormatTimeStamp (
+    time_t tmTimeStamp_p,
+    char* pszBuffer_p,
+    int iBuffSize_p);
+
+static  bool  SplitupUrlString (
+    const char* pszUrlString_p,
+    char* pszHostBuffer_p,
+    int iHostBuffSize_p,
+    int* piPortNum_p);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Main function of this application
+//---------------------------------------------------------------------------
+
+int  main (int iArgCnt_p, char* apszArg_p[])
+{
+
+struct pollfd  FdSet[AGD_MAX_GATEWAYS + 1];
+int            aiFdGateway[AGD_MAX_GATEWAYS + 1];   // -1 = output connection
+uint           uiFdCount;
+uint           uiGateway;
+uint           uiIdx;
+time_t         tmTimeStamp;
+char           szTimeStamp[64];
+int            iRes;
+bool           fRes;
+
+
+    //-------------------------------------------------------------------
+    // Step(1): Setup
+    //-------------------------------------------------------------------
+    printf("\n");
+    printf("********************************************************************\n");
+    printf("  LoRa Packet Aggregator\n");
+    printf("  Version: %u.%02u\n", APP_VER_MAIN, APP_VER_REL);
+    printf("  (c) 2026 Ronald Sieber\n");
+    printf("********************************************************************\n");
+    printf("\n");
+
+
+    // setup Workspace
+    fRunMainLoop_l   = true;
+    strncpy(szServerUrl_l, MQTT_DEF_HOST_URL, sizeof(szServerUrl_l));
+    iPortNum_l       = MQTT_DEF_HOST_PORTNUM;
+    uiGatewayCount_l = 0;
+    uiHoldTimeMs_l   = AGD_DEF_HOLD_TIME_MS;
+    uiMaxEntries_l   = AGD_DEF_MAX_ENTRIES;
+    fOffline_l       = false;
+    fVerbose_l       = false;
+    fBenchmark_l     = false;
+    uiBrokerPort_l   = 0;
+    uiForwardCount_l = 0;
+
+
+    // evaluate Command Line Arguments
+    fRes = AppEvalCmdlnArgs(iArgCnt_p, apszArg_p);
+    if ( !fRes )
+    {
+        AppPrintHelpScreen(apszArg_p[0]);
+        return (-1);
+    }
+
+    // register Ctrl+C Handler
+    signal(SIGINT, AppSigHandler);
+    signal(SIGTERM, AppSigHandler);
+
+
+    // run as MQTT broker stand-in (for end-to-end tests without external broker)
+    if (uiBrokerPort_l > 0)
+    {
+        printf("Running as MQTT Broker Stand-In on Port %u...\n", uiBrokerPort_l);
+        fflush(stdout);
+        iRes = MqbRun(uiBrokerPort_l, &fRunMainLoop_l, fVerbose_l);
+        if (iRes != 0)
+        {
+            printf("\nERROR: MqbRun() failed (iRes=%d)!\n\n", iRes);
+            return (-6);
+        }
+        return (0);
+    }
+
+    // run benchmark of deduplication (doesn't need any MQTT connection)
+    if ( fBenchmark_l )
+    {
+        AppRunBenchmark();
+        return (0);
+    }
+
+    if (uiGatewayCount_l == 0)
+    {
+        printf("\nERROR: no gateway given (option '-i')!\n\n");
+        AppPrintHelpScreen(apszArg_p[0]);
+        return (-1);
+    }
+
+
+    // show sytem start time and runtime configuration
+    tmTimeStamp = time(NULL);
+    FormatTimeStamp(tmTimeStamp, szTimeStamp, sizeof(szTimeStamp));
+    printf("Systen Start Time: %s\n", szTimeStamp);
+    printf("\n");
+    printf("Runtime Configuration:\n");
+    for (uiGateway=0; uiGateway<uiGatewayCount_l; uiGateway++)
+    {
+        printf("  '-i' Gateway[%u]   = '%s' @ %s:%d\n", uiGateway, aGateway_l[uiGateway].m_szName,
+               aGateway_l[uiGateway].m_szHostUrl, aGateway_l[uiGateway].m_iPortNum);
+    }
+    printf("  '-w' HoldTime     = %u [ms]\n", uiHoldTimeMs_l);
+    printf("  '-n' MaxEntries   = %u\n", uiMaxEntries_l);
+    printf("  '-o' Offline      = %s\n", (fOffline_l ? "yes" : "no"));
+    printf("  '-v' Verbose      = %s\n", (fVerbose_l ? "yes" : "no"));
+    printf("\n");
+
+
+    // initialize Deduplication (all memory is allocated here)
+    iRes = AgdInitialize(uiMaxEntries_l, uiHoldTimeMs_l);
+    if (iRes != 0)
+    {
+        printf("\nERROR: AgdInitialize() failed (iRes=%d)!\n\n", iRes);
+        return (-2);
+    }
+    printf("Deduplication Table: %u entries, %u kByte\n", uiMaxEntries_l, (uint)(AgdGetMemorySize() / 1024));
+
+
+    // connect to output MQTT Broker
+    MqcInitConnection(&MqttOutConn_l, szServerUrl_l, iPortNum_l, MQTT_CLIENT_NAME, MQTT_KEEPALIVE_INTERVAL);
+    if ( !fOffline_l )
+    {
+        printf("Connect to MQTT Broker...\n");
+        printf("  HostUrl     = '%s'\n",     szServerUrl_l);
+        printf("  HostPortNum = %u\n",       iPortNum_l);
+        printf("  ClientName  = '%s'\n",     MQTT_CLIENT_NAME);
+        printf("  KeepAlive   = %u [sec]\n", MQTT_KEEPALIVE_INTERVAL);
+        iRes = MqcConnect(&MqttOutConn_l);
+        if (iRes != 0)
+        {
+            printf("\nERROR: MqcConnect() failed (iRes=%d)!\n\n", iRes);
+            AgdShutdown();
+            return (-4);
+        }
+        printf("done.\n");
+    }
+    else
+    {
+        printf("Running in Offline Mode, without MQTT output connection.\n");
+    }
+
+
+    // connect to MQTT Brokers of Gateways (a gateway which is not
+    // reachable yet is retried later, it must not stop the others)
+    for (uiGateway=0; uiGateway<uiGatewayCount_l; uiGateway++)
+    {
+        MqcInitConnection(&aGateway_l[uiGateway].m_MqttConn, aGateway_l[uiGateway].m_szHostUrl, aGateway_l[uiGateway].m_iPortNum,
+                          aGateway_l[uiGateway].m_szClientName, MQTT_KEEPALIVE_INTERVAL);
+        AppConnectGateway(uiGateway);
+    }
+
+
+    //-------------------------------------------------------------------
+    // Step(2): Main Loop
+    //-------------------------------------------------------------------
+    printf("\n\n---- Entering Main Loop ----\n");
+    fflush(stdout);
+
+    while ( fRunMainLoop_l )
+    {
+        uiFdCount = 0;
+        for (uiGateway=0; uiGateway<uiGatewayCount_l; uiGateway++)
+        {
+            if ( MqcIsConnected(&aGateway_l[uiGateway].m_MqttConn) )
+            {
+                FdSet[uiFdCount].fd      = aGateway_l[uiGateway].m_MqttConn.m_iSocket;
+                FdSet[uiFdCount].events  = POLLIN;
+                FdSet[uiFdCount].revents = 0;
+                aiFdGateway[uiFdCount]   = (int)uiGateway;
+                uiFdCount++;
+            }
+        }
+        if ( MqcIsConnected(&MqttOutConn_l) )
+        {
+            // only PINGRESP is expected here, but it has to be consumed
+            FdSet[uiFdCount].fd      = MqttOutConn_l.m_iSocket;
+            FdSet[uiFdCount].events  = POLLIN;
+            FdSet[uiFdCount].revents = 0;
+            aiFdGateway[uiFdCount]   = -1;
+            uiFdCount++;
+        }
+
+        // wake up in time to forward records whose hold time for further copies has elapsed
+        iRes = poll(FdSet, uiFdCount, AgdGetTimeout(AppGetTimeUs(), 1000));
+        if (iRes > 0)
+        {
+            for (uiIdx=0; uiIdx<uiFdCount; uiIdx++)
+            {
+                if ( !(FdSet[uiIdx].revents & (POLLIN | POLLHUP | POLLERR)) )
+                {
+                    continue;
+                }
+                if (aiFdGateway[uiIdx] < 0)
+                {
+                    iRes = MqcProcessRxData(&MqttOutConn_l, NULL, NULL);
+                    if (iRes < 0)
+                    {
+                        printf("\nERROR: Connection to MQTT Broker lost!\n");
+                        tmNextOutReconnect_l = time(NULL);
+                    }
+                    continue;
+                }
+
+                uiGateway = (uint)aiFdGateway[uiIdx];
+                iRes = MqcProcessRxData(&aGateway_l[uiGateway].m_MqttConn, AppOnRecvMessage, (void*)(uintptr_t)uiGateway);
+                if (iRes < 0)
+                {
+                    printf("\nERROR: Connection to Gateway '%s' lost!\n", aGateway_l[uiGateway].m_szName);
+                    aGateway_l[uiGateway].m_tmNextReconnect = time(NULL) + APP_RECONNECT_INTERVAL;
+                }
+            }
+        }
+        else if ((iRes == 0) && fVerbose_l)
+        {
+            printf(".");
+            fflush(stdout);
+        }
+
+        // forward best copy of each record after its hold time
+        AppForwardReadyRecords(AppGetTimeUs());
+
+        AppServiceConnections();
+    }
+
+    // forward all records which are still pending
+    AppForwardReadyRecords(UINT64_MAX);
+
+    printf("\n");
+    for (uiGateway=0; uiGateway<uiGatewayCount_l; uiGateway++)
+    {
+        printf("Gateway '%s': %u messages received\n", aGateway_l[uiGateway].m_szName, aGateway_l[uiGateway].m_uiRecvCount);
+    }
+    printf("Records forwarded: %u\n", uiForwardCount_l);
+    printf("\n");
+    AgdPrintStatistics();
+    printf("\n");
+
+
+    // disconnect from MQTT Brokers
+    for (uiGateway=0; uiGateway<uiGatewayCount_l; uiGateway++)
+    {
+        MqcDisconnect(&aGateway_l[uiGateway].m_MqttConn);
+    }
+    if ( !fOffline_l )
+    {
+        printf("Disconnect from MQTT Broker...\n");
+        MqcDisconnect(&MqttOutConn_l);
+        printf("done.\n");
+    }
+
+    AgdShutdown();
+
+
+    return (0);
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Application signal handler
+//---------------------------------------------------------------------------
+
+static  void  AppSigHandler (
+    int iSignalNum_p)
+{
+
+    printf("\n\nTerminate Application\n\n");
+    fRunMainLoop_l = false;
+
+    return;
+
+}
+
+
+//---------------------------------------------------------------------------
+//  Evaluate command line arguments
+//---------------------------------------------------------------------------
+
+static  bool  AppEvalCmdlnArgs (
+    int iArgCnt_p,
+    char* apszArg_p[])
+{
+
+char*  pszArg;
+int    iIdx;
+bool   fRes;
+
+
+    fRes = true;
+
+    for (iIdx=1; iIdx<iArgCnt_p; iIdx++)
+    {
+        pszArg = apszArg_p[iIdx];
+        if (pszArg != NULL)
+        {
+            // argument '-i=' -> Input Gateway ('name@url:port')
+            if ( !strncasecmp("-i=", pszArg, sizeof("-i=")-1) )
+            {
+                pszArg += sizeof("-i=")-1;
+                fRes = AppParseGatewayCfg(pszArg);
+                if ( !fRes )
+                {
+                    printf("\nERROR: invalid gateway configuration!\n");
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-h=' -> Host ('url:port')
+            if ( !strncasecmp("-h=", pszArg, sizeof("-h=")-1) )
+            {
+                pszArg += sizeof("-h=")-1;
+                fRes = SplitupUrlString(pszArg, szServerUrl_l, sizeof(szServerUrl_l), &iPortNum_l);
+                if ( !fRes )
+                {
+                    printf("\nERROR: invalid host address!\n");
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-w=' -> Hold Time
+            if ( !strncasecmp("-w=", pszArg, sizeof("-w=")-1) )
+            {
+                pszArg += sizeof("-w=")-1;
+                uiHoldTimeMs_l = (uint)atoi(pszArg);
+                continue;
+            }
+
+            // argument '-n=' -> Max Entries
+            if ( !strncasecmp("-n=", pszArg, sizeof("-n=")-1) )
+            {
+                pszArg += sizeof("-n=")-1;
+                uiMaxEntries_l = (uint)atoi(pszArg);
+                if ((uiMaxEntries_l < 16) || (uiMaxEntries_l > 0x1000000))
+                {
+                    printf("\nERROR: invalid number of entries!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-o' -> Offline
+            if ( !strncasecmp("-o", pszArg, sizeof("-o")-1) )
+            {
+                fOffline_l = true;
+                continue;
+            }
+
+            // argument '-v' -> Verbose
+            if ( !strncasecmp("-v", pszArg, sizeof("-v")-1) )
+            {
+                fVerbose_l = true;
+                continue;
+            }
+
+            // argument '-x=' -> MQTT Broker Stand-In
+            if ( !strncasecmp("-x=", pszArg, sizeof("-x=")-1) )
+            {
+                pszArg += sizeof("-x=")-1;
+                uiBrokerPort_l = (uint)atoi(pszArg);
+                if ((uiBrokerPort_l == 0) || (uiBrokerPort_l > 0xFFFF))
+                {
+                    printf("\nERROR: invalid port number!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-b' -> Benchmark of Deduplication
+            if ( !strncasecmp("-b", pszArg, sizeof("-b")-1) )
+            {
+                fBenchmark_l = true;
+                continue;
+            }
+        }
+
+        fRes = false;
+    }
+
+    return (fRes);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Show Help Screen
+//---------------------------------------------------------------------------
+
+static  void  AppPrintHelpScreen (
+    const char* pszArg0_p)
+{
+
+    //     |    10   |    20   |    30   |    40   |    50   |    60   |    70   |    80   |
+    printf("Usage:\n");
+    printf("   %s [OPTION]\n", pszArg0_p);
+    printf("   OPTION:\n");
+    printf("\n");
+    printf("       -i=<name>@<host_url>  Gateway whose MQTT Broker is subscribed for\n");
+    printf("                       '%s', Host URL in format URL[:Port],\n", MQTT_TOPIC_IN_FILTER);
+    printf("                       can be given up to %u times\n", AGD_MAX_GATEWAYS);
+    printf("\n");
+    printf("       -h=<host_url>   Host URL of MQTT Broker for aggregated records in format\n");
+    printf("                       URL[:Port] (default: %s:%d), topic prefix '%s'\n", MQTT_DEF_HOST_URL, MQTT_DEF_HOST_PORTNUM, MQTT_TOPIC_OUT_PREFIX);
+    printf("\n");
+    printf("       -w=<ms>         Hold Time to wait for copies from further gateways\n");
+    printf("                       (default: %u ms)\n", AGD_DEF_HOLD_TIME_MS);
+    printf("\n");
+    printf("       -n=<entries>    Capacity of Deduplication Table, bounds the memory usage\n");
+    printf("                       (default: %u entries, %u kByte)\n", AGD_DEF_MAX_ENTRIES,
+           (uint)(((size_t)AGD_DEF_MAX_ENTRIES * sizeof(tAgdRecord)) / 1024));
+    printf("\n");
+    printf("       -o              Run in Offline Mode, without MQTT output connection\n");
+    printf("\n");
+    printf("       -v              Run in Verbose Mode\n");
+    printf("\n");
+    printf("       -x=<port>       Run as minimal MQTT Broker Stand-In on <port> instead\n");
+    printf("                       (for end-to-end tests without external broker)\n");
+    printf("\n");
+    printf("       -b              Run Benchmark of Deduplication and exit\n");
+    printf("\n");
+    printf("       --help          Shows this Help Screen\n");
+    printf("\n");
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Parse configuration of Gateway (option '-i=')
+//---------------------------------------------------------------------------
+
+static  bool  AppParseGatewayCfg (
+    const char* pszGatewayCfg_p)
+{
+
+tAppGateway*  pGateway;
+const char*   pszSeparator;
+char          szClientName[sizeof(pGateway->m_szClientName)];
+size_t        nNameLen;
+uint          uiGateway;
+int           iLen;
+bool          fRes;
+
+
+    if (uiGatewayCount_l >= AGD_MAX_GATEWAYS)
+    {
+        return (false);
+    }
+
+    pszSeparator = strchr(pszGatewayCfg_p, '@');
+    if (pszSeparator == NULL)
+    {
+        return (false);
+    }
+    nNameLen = pszSeparator - pszGatewayCfg_p;
+
+    pGateway = &aGateway_l[uiGatewayCount_l];
+    memset(pGateway, 0, sizeof(tAppGateway));
+    if ((nNameLen == 0) || (nNameLen >= sizeof(pGateway->m_szName)))
+    {
+        return (false);
+    }
+    memcpy(pGateway->m_szName, pszGatewayCfg_p, nNameLen);
+    pGateway->m_szName[nNameLen] = '\0';
+
+    fRes = SplitupUrlString(pszSeparator + 1, pGateway->m_szHostUrl, sizeof(pGateway->m_szHostUrl), &pGateway->m_iPortNum);
+    if ( !fRes )
+    {
+        return (false);
+    }
+
+    // the client name must be unique, several gateways can share one broker
+    // (a truncated name could collide with the one of another gateway)
+    iLen = snprintf(szClientName, sizeof(szClientName), "%s-%s", MQTT_CLIENT_NAME, pGateway->m_szName);
+    if ((iLen < 0) || ((size_t)iLen >= sizeof(pGateway->m_szClientName)))
+    {
+        return (false);
+    }
+    for (uiGateway=0; uiGateway<uiGatewayCount_l; uiGateway++)
+    {
+        if ( !strcmp(aGateway_l[uiGateway].m_szClientName, szClientName) )
+        {
+            return (false);
+        }
+    }
+    memcpy(pGateway->m_szClientName, szClientName, (size_t)iLen + 1);
+    uiGatewayCount_l++;
+
+    return (true);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Connect to MQTT Broker of Gateway and subscribe its Records
+//---------------------------------------------------------------------------
+
+static  void  AppConnectGateway (
+    uint uiGateway_p)
+{
+
+tAppGateway*  pGateway;
+int           iRes;
+
+
+    pGateway = &aGateway_l[uiGateway_p];
+
+    printf("Connect to Gateway '%s' (%s:%d)... ", pGateway->m_szName, pGateway->m_szHostUrl, pGateway->m_iPortNum);
+    iRes = MqcConnect(&pGateway->m_MqttConn);
+    if (iRes == 0)
+    {
+        iRes = MqcSubscribe(&pGateway->m_MqttConn, MQTT_TOPIC_IN_FILTER);
+    }
+    if (iRes != 0)
+    {
+        printf("failed (iRes=%d), retry in %u sec\n", iRes, APP_RECONNECT_INTERVAL);
+        MqcClose(&pGateway->m_MqttConn);
+        pGateway->m_tmNextReconnect = time(NULL) + APP_RECONNECT_INTERVAL;
+        return;
+    }
+    printf("done.\n");
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Callback for received MQTT Messages of Gateways
+//---------------------------------------------------------------------------
+
+static  void  AppOnRecvMessage (
+    void* pvArg_p,
+    const char* pszTopic_p,
+    uint uiTopicLen_p,
+    const uint8_t* pabPayload_p,
+    uint uiPayloadLen_p)
+{
+
+static  const char*  apszResult[] = { "new", "merged", "late" };
+uint64_t  ui64NowUs;
+uint      uiGateway;
+int       iRes;
+
+
+    uiGateway = (uint)(uintptr_t)pvArg_p;
+    aGateway_l[uiGateway].m_uiRecvCount++;
+
+    // records in front of this one may be due (and a full table gets room again)
+    ui64NowUs = AppGetTimeUs();
+    AppForwardReadyRecords(ui64NowUs);
+
+    iRes = AgdAddRecord(uiGateway, pszTopic_p, uiTopicLen_p, (const char*)pabPayload_p, uiPayloadLen_p, ui64NowUs);
+    if (iRes < 0)
+    {
+        printf("\nWARNING: Record '%.*s' from Gateway '%s' ignored (iRes=%d)\n",
+               (int)uiTopicLen_p, pszTopic_p, aGateway_l[uiGateway].m_szName, iRes);
+        return;
+    }
+
+    if ( fVerbose_l )
+    {
+        printf("\n[%s] %.*s -> %s\n", aGateway_l[uiGateway].m_szName, (int)uiTopicLen_p, pszTopic_p, apszResult[iRes]);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Forward all Records whose Hold Time has elapsed
+//---------------------------------------------------------------------------
+
+static  void  AppForwardReadyRecords (
+    uint64_t ui64NowUs_p)
+{
+
+const tAgdRecord*  pRecord;
+char               szTopic[AGD_MAX_TOPIC_LEN + 32];
+char               szMsg[AGD_MAX_RECORD_LEN + 64 + (AGD_MAX_GATEWAYS * 36)];
+int                iMsgLen;
+int                iRes;
+
+
+    while ((pRecord = AgdGetReadyRecord(ui64NowUs_p)) != NULL)
+    {
+        uiForwardCount_l++;
+        iMsgLen = AppBuildOutMessage(pRecord, szTopic, sizeof(szTopic), szMsg, sizeof(szMsg));
+
+        if ( fVerbose_l || fOffline_l )
+        {
+            printf("\n%s\n%s\n", szTopic, szMsg);
+        }
+
+        if ( MqcIsConnected(&MqttOutConn_l) )
+        {
+            iRes = MqcPublish(&MqttOutConn_l, szTopic, (const uint8_t*)szMsg, (uint)iMsgLen, true);
+            if (iRes != 0)
+            {
+                printf("\nERROR: MqcPublish() failed (iRes=%d)!\n", iRes);
+                tmNextOutReconnect_l = time(NULL);
+            }
+        }
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Build canonical Record (best copy plus list of receiving Gateways)
+//---------------------------------------------------------------------------
+
+static  int  AppBuildOutMessage (
+    const tAgdRecord* pRecord_p,
+    char* pszTopicBuffer_p,
+    int iTopicBuffSize_p,
+    char* pszMsgBuffer_p,
+    int iMsgBuffSize_p)
+{
+
+const char*  pszTopic;
+int          iMsgLen;
+uint         uiGateway;
+bool         fFirst;
+
+
+    // 'LoraAmbMon/Data/DevIDxxx/...' -> 'LoraAmbMon/Aggr/DevIDxxx/...'
+    pszTopic = pRecord_p->m_szTopic;
+    if ( !strncmp(pszTopic, MQTT_TOPIC_IN_PREFIX, strlen(MQTT_TOPIC_IN_PREFIX)) )
+    {
+        pszTopic += strlen(MQTT_TOPIC_IN_PREFIX);
+    }
+    snprintf(pszTopicBuffer_p, iTopicBuffSize_p, "%s%s", MQTT_TOPIC_OUT_PREFIX, pszTopic);
+
+    // remove closing brace of JSON record to append the gateway list
+    iMsgLen = (int)pRecord_p->m_uiRecordLen;
+    while ((iMsgLen > 0) && ((pRecord_p->m_szRecord[iMsgLen-1] == '\n') || (pRecord_p->m_szRecord[iMsgLen-1] == '\r') ||
+                             (pRecord_p->m_szRecord[iMsgLen-1] == ' ')))
+    {
+        iMsgLen--;
+    }
+    if ((iMsgLen == 0) || (pRecord_p->m_szRecord[iMsgLen-1] != '}'))
+    {
+        // not the expected JSON format -> forward unchanged
+        iMsgLen = snprintf(pszMsgBuffer_p, iMsgBuffSize_p, "%s", pRecord_p->m_szRecord);
+        return (iMsgLen);
+    }
+    iMsgLen--;
+    while ((iMsgLen > 0) && ((pRecord_p->m_szRecord[iMsgLen-1] == '\n') || (pRecord_p->m_szRecord[iMsgLen-1] == '\r') ||
+                             (pRecord_p->m_szRecord[iMsgLen-1] == ' ')))
+    {
+        iMsgLen--;
+    }
+    memcpy(pszMsgBuffer_p, pRecord_p->m_szRecord, iMsgLen);
+
+    iMsgLen += snprintf(&pszMsgBuffer_p[iMsgLen], iMsgBuffSize_p - iMsgLen, ",\n  \"Gateways\": [");
+    fFirst = true;
+    for (uiGateway=0; uiGateway<uiGatewayCount_l; uiGateway++)
+    {
+        if (pRecord_p->m_ui32GatewayMask & (1u << uiGateway))
+        {
+            iMsgLen += snprintf(&pszMsgBuffer_p[iMsgLen], iMsgBuffSize_p - iMsgLen, "%s\"%s\"",
+                                (fFirst ? "" : ", "), aGateway_l[uiGateway].m_szName);
+            fFirst = false;
+        }
+    }
+    iMsgLen += snprintf(&pszMsgBuffer_p[iMsgLen], iMsgBuffSize_p - iMsgLen, "],\n  \"BestGateway\": \"%s\"\n}",
+                        aGateway_l[pRecord_p->m_uiBestGateway].m_szName);
+
+    return (iMsgLen);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Service MQTT Connections (KeepAlive and Reconnect)
+//---------------------------------------------------------------------------
+
+static  void  AppServiceConnections (void)
+{
+
+tAppGateway*  pGateway;
+time_t        tmNow;
+uint          uiGateway;
+int           iRes;
+
+
+    tmNow = time(NULL);
+
+    for (uiGateway=0; uiGateway<uiGatewayCount_l; uiGateway++)
+    {
+        pGateway = &aGateway_l[uiGateway];
+        if ( MqcIsConnected(&pGateway->m_MqttConn) )
+        {
+            MqcKeepAlive(&pGateway->m_MqttConn);
+        }
+        else if (tmNow >= pGateway->m_tmNextReconnect)
+        {
+            AppConnectGateway(uiGateway);
+        }
+    }
+
+    if ( fOffline_l )
+    {
+        return;
+    }
+    if ( MqcIsConnected(&MqttOutConn_l) )
+    {
+        MqcKeepAlive(&MqttOutConn_l);
+    }
+    else if (tmNow >= tmNextOutReconnect_l)
+    {
+        printf("Reconnect to MQTT Broker... ");
+        iRes = MqcConnect(&MqttOutConn_l);
+        if (iRes == 0)
+        {
+            printf("done.\n");
+        }
+        else
+        {
+            printf("failed (iRes=%d), retry in %u sec\n", iRes, APP_RECONNECT_INTERVAL);
+            tmNextOutReconnect_l = tmNow + APP_RECONNECT_INTERVAL;
+        }
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Run Benchmark of Deduplication
+//---------------------------------------------------------------------------
+//  Feeds synthetic StationData records of BENCH_DEVICES nodes as received by
+//  BENCH_GATEWAYS gateways (each gateway misses ~10% of the records, the
+//  copies of further gateways arrive one and two transmissions later) and
+//  measures the throughput of AgdAddRecord() + AgdGetReadyRecord() +
+//  AppBuildOutMessage(). The virtual time advances by BENCH_RECORD_PERIOD_US
+//  per transmission, so the table is filled up to the hold time as in a real
+//  high-rate scenario.
+
+static  void  AppRunBenchmark (void)
+{
+
+static  const int  aiRssi[] = { -70, -60, -80 };     // GW1 receives best, but not always first
+static  char  aszRecord[BENCH_GATEWAYS][AGD_MAX_RECORD_LEN];
+uint          auiRecordLen[BENCH_GATEWAYS];
+char*         apszSequNum[BENCH_GATEWAYS];
+char*         apszDevID[BENCH_GATEWAYS];
+char          szTopic[AGD_MAX_TOPIC_LEN + 32];
+char          szMsg[AGD_MAX_RECORD_LEN + 64 + (AGD_MAX_GATEWAYS * 36)];
+char          szNum[16];
+const tAgdRecord*  pRecord;
+tAgdStatistics  AgdStatistics;
+uint64_t      ui64VirtTimeUs;
+uint64_t      ui64StartUs;
+uint64_t      ui64ElapsedUs;
+uint32_t      ui32Random;
+uint          uiRecordsIn;
+uint          uiTransmission;
+uint          uiSequNum;
+uint          uiDevID;
+uint          uiGateway;
+int           iRes;
+
+
+    printf("Benchmark of Cross-Gateway Deduplication:\n");
+    printf("  Gateways = %u, Devices = %u, Table = %u entries, HoldTime = %u ms\n",
+           BENCH_GATEWAYS, BENCH_DEVICES, uiMaxEntries_l, uiHoldTimeMs_l);
+
+    iRes = AgdInitialize(uiMaxEntries_l, uiHoldTimeMs_l);
+    if (iRes != 0)
+    {
+        printf("\nERROR: AgdInitialize() failed (iRes=%d)!\n\n", iRes);
+        return;
+    }
+
+    uiGatewayCount_l = BENCH_GATEWAYS;
+    for (uiGateway=0; uiGateway<BENCH_GATEWAYS; uiGateway++)
+    {
+        snprintf(aGateway_l[uiGateway].m_szName, sizeof(aGateway_l[uiGateway].m_szName), "GW%u", uiGateway);
+
+        // same layout as generated by LoraPacketRecv, DevID and SequNum with
+        // fixed width to be patched in place for each record
+        auiRecordLen[uiGateway] = (uint)snprintf(aszRecord[uiGateway], AGD_MAX_RECORD_LEN,
+            "{\n  \"MsgID\": 1,\n  \"MsgType\": \"StationDataGen0\",\n  \"TimeStamp\": 1700000000,\n"
+            "  \"TimeStampFmt\": \"2023/11/14 - 22:13:20\",\n  \"RSSI\": %d,\n  \"DevID\":      ,\n"
+            "  \"SequNum\":         ,\n  \"Uptime\": 12345,\n  \"UptimeFmt\": \"0d/03:25:45\",\n"
+            "  \"Temperature\": 21.5,\n  \"Humidity\": 45.0,\n  \"MotionActive\": 0,\n  \"MotionActiveTime\": 0,\n"
+            "  \"MotionActiveCount\": 0,\n  \"LightLevel\": 12,\n  \"CarBattLevel\": 0.0\n}",
+            aiRssi[uiGateway % 3]);
+        apszDevID[uiGateway]   = strstr(aszRecord[uiGateway], "\"DevID\":") + sizeof("\"DevID\":");
+        apszSequNum[uiGateway] = strstr(aszRecord[uiGateway], "\"SequNum\":") + sizeof("\"SequNum\":");
+    }
+
+    ui32Random     = 12345;
+    uiRecordsIn    = 0;
+    ui64VirtTimeUs = 0;
+    ui64StartUs    = AppGetTimeUs();
+    for (uiTransmission=0; uiRecordsIn<BENCH_RECORDS; uiTransmission++)
+    {
+        ui64VirtTimeUs += BENCH_RECORD_PERIOD_US;
+
+        // gateway N receives transmission (T - N) at time T
+        for (uiGateway=0; (uiGateway<BENCH_GATEWAYS) && (uiGateway<=uiTransmission); uiGateway++)
+        {
+            ui32Random = (ui32Random * 1103515245u) + 12345u;
+            if (((ui32Random >> 16) % 100) < 10)
+            {
+                continue;
+            }
+            uiDevID   = (uiTransmission - uiGateway) % BENCH_DEVICES;
+            uiSequNum = (uiTransmission - uiGateway) / BENCH_DEVICES;
+            snprintf(szNum, sizeof(szNum), "%5u", uiDevID);
+            memcpy(apszDevID[uiGateway], szNum, 5);
+            snprintf(szNum, sizeof(szNum), "%8u", uiSequNum);
+            memcpy(apszSequNum[uiGateway], szNum, 8);
+
+            while ((pRecord = AgdGetReadyRecord(ui64VirtTimeUs)) != NULL)
+            {
+                AppBuildOutMessage(pRecord, szTopic, sizeof(szTopic), szMsg, sizeof(szMsg));
+            }
+            AgdAddRecord(uiGateway, "LoraAmbMon/Data/DevID001/StData", sizeof("LoraAmbMon/Data/DevID001/StData")-1,
+                         aszRecord[uiGateway], auiRecordLen[uiGateway], ui64VirtTimeUs);
+            uiRecordsIn++;
+        }
+    }
+    while ((pRecord = AgdGetReadyRecord(UINT64_MAX)) != NULL)
+    {
+        AppBuildOutMessage(pRecord, szTopic, sizeof(szTopic), szMsg, sizeof(szMsg));
+    }
+    ui64ElapsedUs = AppGetTimeUs() - ui64StartUs;
+
+    AgdGetStatistics(&AgdStatistics);
+    printf("  %u records in %.3f sec -> %.0f records/sec (%.2f us/record)\n",
+           uiRecordsIn, (double)ui64ElapsedUs / 1000000.0,
+           (double)uiRecordsIn * 1000000.0 / (double)ui64ElapsedUs,
+           (double)ui64ElapsedUs / (double)uiRecordsIn);
+    printf("\n");
+    AgdPrintStatistics();
+    printf("\n");
+
+    AgdShutdown();
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get monotonic Time in [us]
+//---------------------------------------------------------------------------
+
+static  uint64_t  AppGetTimeUs (void)
+{
+
+struct timespec  TimeSpec;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &TimeSpec);
+
+    return (((uint64_t)TimeSpec.tv_sec * 1000000) + ((uint64_t)TimeSpec.tv_nsec / 1000));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Format TimeStamp
+//---------------------------------------------------------------------------
+
+static  int  FormatTimeStamp (
+    time_t tmTimeStamp_p,
+    char* pszBuffer_p,
+    int iBuffSize_p)
+{
+
+struct tm*  LocTime;
+int         iStrLen;
+
+
+    LocTime = localtime(&tmTimeStamp_p);
+
+    snprintf(pszBuffer_p, iBuffSize_p, "%04d/%02d/%02d - %02d:%02d:%02d",
+             LocTime->tm_year + 1900, LocTime->tm_mon + 1, LocTime->tm_mday,
+             LocTime->tm_hour, LocTime->tm_min, LocTime->tm_sec);
+
+    iStrLen = strlen(pszBuffer_p);
+
+    return (iStrLen);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Split up URL String into Host and Port
+//---------------------------------------------------------------------------
+
+static  bool  SplitupUrlString (
+    const char* pszUrlString_p,
+    char* pszHostBuffer_p,
+    int iHostBuffSize_p,
+    int* piPortNum_p)
+{
+
+char*  pszSeparator;
+int    iPortNum;
+int    iRes;
+
+
+    if ((int)strlen(pszUrlString_p) >= iHostBuffSize_p)
+    {
+        return (false);
+    }
+
+    strncpy(pszHostBuffer_p, pszUrlString_p, iHostBuffSize_p);
+
+    pszSeparator = strstr(pszHostBuffer_p, ":");
+    if (pszSeparator != NULL)
+    {
+        *pszSeparator = '\0';
+
+        pszSeparator++;
+        iRes = sscanf(pszSeparator, "%d", &iPortNum);
+        if (iRes != 1)
+        {
+            return (false);
+        }
+    }
+    else
+    {
+        iPortNum = MQTT_DEF_HOST_PORTNUM;
+    }
+
+    *piPortNum_p = iPortNum;
+
+    return (true);
+
+}
+
+
+
+// EOF
+
@@ -0,0 +1,660 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Aggregator
+  Description:  Implementation of minimal MQTT Broker (local Stand-In)
+
+  -------------------------------------------------------------------------
+
+  This broker only implements what LoraPacketRecv and LoraPacketAggr need
+  to be tested end-to-end without any external software: MQTT 3.1.1 with
+  CONNECT, SUBSCRIBE/UNSUBSCRIBE (wildcards '+' and '#'), PUBLISH with
+  QoS 0/1 (forwarded with QoS 0), PINGREQ and DISCONNECT.
+  There is no authentication, no persistence and no retained messages.
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <poll.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include "MQTTPacket.h"
+#include "MqttClient.h"
+#include "MqttBroker.h"
+#include "Trace.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Macro definitions
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+typedef struct
+{
+    int                 m_iSocket;                  // -1 = slot free
+    bool                m_fConnected;               // CONNECT received
+    char                m_szClientID[64];
+    uint                m_uiSubscrCount;
+    char                m_aszFilter[MQB_MAX_SUBSCRIPTIONS][MQB_MAX_FILTER_LEN];
+    uint                m_uiRxDataLen;
+    uint8_t             m_abRxBuff[MQC_RX_BUFF_SIZE];
+
+} tMqbClient;
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+static  tMqbClient      aMqbClient_l[MQB_MAX_CLIENTS];
+static  bool            fVerbose_l          = false;
+static  uint            uiMsgCount_l        = 0;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  void  MqbAcceptClient (
+    int iListenSocket_p);
+
+static  void  MqbCloseClient (
+    tMqbClient* pClient_p);
+
+static  void  MqbProcessRxData (
+    tMqbClient* pClient_p);
+
+static  bool  MqbProcessPacket (
+    tMqbClient* pClient_p,
+    uint8_t* pabPacket_p,
+    int iPacketLen_p);
+
+static  void  MqbForwardPublish (
+    const MQTTString* pTopicName_p,
+    uint8_t* pabPayload_p,
+    int iPayloadLen_p);
+
+static  bool  MqbTopicMatch (
+    const char* pszFilter_p,
+    const char* pszTopic_p,
+    uint uiTopicLen_p);
+
+static  bool  MqbSendPacket (
+    tMqbClient* pClient_p,
+    const uint8_t* pabPacket_p,
+    int iPacketLen_p);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Run Broker until *pfRun_p gets false
+//---------------------------------------------------------------------------
+
+int  MqbRun (
+    uint uiPortNum_p,                                   // [IN]     TCP Port to listen on
+    volatile bool* pfRun_p,                             // [IN]     Broker runs as long as *pfRun_p is true
+    bool fVerbose_p)                                    // [IN]     Print connections and messages
+{
+
+struct sockaddr_in  SockAddr;
+struct pollfd       FdSet[1 + MQB_MAX_CLIENTS];
+tMqbClient*         apClient[1 + MQB_MAX_CLIENTS];
+int                 iListenSocket;
+int                 iOptVal;
+uint                uiFdCount;
+uint                uiIdx;
+int                 iRes;
+
+
+    fVerbose_l   = fVerbose_p;
+    uiMsgCount_l = 0;
+    for (uiIdx=0; uiIdx<MQB_MAX_CLIENTS; uiIdx++)
+    {
+        memset(&aMqbClient_l[uiIdx], 0, sizeof(tMqbClient));
+        aMqbClient_l[uiIdx].m_iSocket = -1;
+    }
+
+    // a client which has gone away must not terminate the broker
+    signal(SIGPIPE, SIG_IGN);
+
+    iListenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (iListenSocket < 0)
+    {
+        return (-1);
+    }
+    iOptVal = 1;
+    setsockopt(iListenSocket, SOL_SOCKET, SO_REUSEADDR, &iOptVal, sizeof(iOptVal));
+
+    memset(&SockAddr, 0, sizeof(SockAddr));
+    SockAddr.sin_family      = AF_INET;
+    SockAddr.sin_addr.s_addr = htonl(INADDR_ANY);
+    SockAddr.sin_port        = htons((uint16_t)uiPortNum_p);
+    iRes = bind(iListenSocket, (struct sockaddr*)&SockAddr, sizeof(SockAddr));
+    if (iRes != 0)
+    {
+        close(iListenSocket);
+        return (-2);
+    }
+    iRes = listen(iListenSocket, MQB_MAX_CLIENTS);
+    if (iRes != 0)
+    {
+        close(iListenSocket);
+        return (-3);
+    }
+
+    while ( *pfRun_p )
+    {
+        FdSet[0].fd      = iListenSocket;
+        FdSet[0].events  = POLLIN;
+        FdSet[0].revents = 0;
+        apClient[0]      = NULL;
+        uiFdCount = 1;
+        for (uiIdx=0; uiIdx<MQB_MAX_CLIENTS; uiIdx++)
+        {
+            if (aMqbClient_l[uiIdx].m_iSocket >= 0)
+            {
+                FdSet[uiFdCount].fd      = aMqbClient_l[uiIdx].m_iSocket;
+                FdSet[uiFdCount].events  = POLLIN;
+                FdSet[uiFdCount].revents = 0;
+                apClient[uiFdCount]      = &aMqbClient_l[uiIdx];
+                uiFdCount++;
+            }
+        }
+
+        iRes = poll(FdSet, uiFdCount, 1000);
+        if (iRes <= 0)
+        {
+            continue;
+        }
+
+        for (uiIdx=1; uiIdx<uiFdCount; uiIdx++)
+        {
+            if (FdSet[uiIdx].revents & (POLLIN | POLLHUP | POLLERR))
+            {
+                MqbProcessRxData(apClient[uiIdx]);
+            }
+        }
+
+        if (FdSet[0].revents & POLLIN)
+        {
+            MqbAcceptClient(iListenSocket);
+        }
+    }
+
+    for (uiIdx=0; uiIdx<MQB_MAX_CLIENTS; uiIdx++)
+    {
+        MqbCloseClient(&aMqbClient_l[uiIdx]);
+    }
+    close(iListenSocket);
+
+    printf("MQTT Broker Stand-In: %u messages forwarded\n", uiMsgCount_l);
+
+    return (0);
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Accept new Client Connection
+//---------------------------------------------------------------------------
+
+static  void  MqbAcceptClient (
+    int iListenSocket_p)
+{
+
+int   iSocket;
+uint  uiIdx;
+
+
+    iSocket = accept(iListenSocket_p, NULL, NULL);
+    if (iSocket < 0)
+    {
+        return;
+    }
+
+    for (uiIdx=0; uiIdx<MQB_MAX_CLIENTS; uiIdx++)
+    {
+        if (aMqbClient_l[uiIdx].m_iSocket < 0)
+        {
+            memset(&aMqbClient_l[uiIdx], 0, sizeof(tMqbClient));
+            aMqbClient_l[uiIdx].m_iSocket = iSocket;
+            return;
+        }
+    }
+
+    // no free slot
+    printf("MQTT Broker Stand-In: too many clients, connection refused\n");
+    close(iSocket);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Close Client Connection
+//---------------------------------------------------------------------------
+
+static  void  MqbCloseClient (
+    tMqbClient* pClient_p)
+{
+
+    if (pClient_p->m_iSocket < 0)
+    {
+        return;
+    }
+
+    if ( fVerbose_l )
+    {
+        printf("MQTT Broker Stand-In: '%s' disconnected\n", pClient_p->m_szClientID);
+    }
+
+    close(pClient_p->m_iSocket);
+    pClient_p->m_iSocket       = -1;
+    pClient_p->m_fConnected    = false;
+    pClient_p->m_uiSubscrCount = 0;
+    pClient_p->m_uiRxDataLen   = 0;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Process received Data of Client
+//---------------------------------------------------------------------------
+
+static  void  MqbProcessRxData (
+    tMqbClient* pClient_p)
+{
+
+ssize_t  iRecvLen;
+uint     uiOffset;
+int      iPacketLen;
+
+
+    iRecvLen = recv(pClient_p->m_iSocket, &pClient_p->m_abRxBuff[pClient_p->m_uiRxDataLen],
+                    MQC_RX_BUFF_SIZE - pClient_p->m_uiRxDataLen, MSG_DONTWAIT);
+    if (iRecvLen <= 0)
+    {
+        if ((iRecvLen < 0) && ((errno == EAGAIN) || (errno == EINTR)))
+        {
+            return;
+        }
+        MqbCloseClient(pClient_p);
+        return;
+    }
+    pClient_p->m_uiRxDataLen += (uint)iRecvLen;
+
+    uiOffset = 0;
+    for (;;)
+    {
+        iPacketLen = MqcGetPacketLength(&pClient_p->m_abRxBuff[uiOffset], pClient_p->m_uiRxDataLen - uiOffset);
+        if (iPacketLen == 0)
+        {
+            break;
+        }
+        if ((iPacketLen < 0) || (iPacketLen > (int)MQC_RX_BUFF_SIZE) ||
+            !MqbProcessPacket(pClient_p, &pClient_p->m_abRxBuff[uiOffset], iPacketLen))
+        {
+            MqbCloseClient(pClient_p);
+            return;
+        }
+        uiOffset += (uint)iPacketLen;
+    }
+
+    if (uiOffset > 0)
+    {
+        memmove(pClient_p->m_abRxBuff, &pClient_p->m_abRxBuff[uiOffset], pClient_p->m_uiRxDataLen - uiOffset);
+        pClient_p->m_uiRxDataLen -= uiOffset;
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Process MQTT Packet of Client (returns false to close the connection)
+//---------------------------------------------------------------------------
+
+static  bool  MqbProcessPacket (
+    tMqbClient* pClient_p,
+    uint8_t* pabPacket_p,
+    int iPacketLen_p)
+{
+
+MQTTPacket_connectData  MqttConnectionData = MQTTPacket_connectData_initializer;
+MQTTString      aMqttTopicFilter[MQB_MAX_SUBSCRIPTIONS];
+int             aiGrantedQoS[MQB_MAX_SUBSCRIPTIONS];
+MQTTString      MqttTopicName;
+uint8_t         abMqttRawDataPacketBuff[64];
+unsigned char   bDupFlag;
+unsigned char   bRetainedFlag;
+unsigned short  usPacketId;
+uint8_t*        pabPayload;
+int             iPayloadLen;
+int             iQos;
+int             iCount;
+int             iLen;
+int             iIdx;
+uint            uiSubscr;
+
+
+    if ( !pClient_p->m_fConnected && ((pabPacket_p[0] >> 4) != CONNECT) )
+    {
+        return (false);
+    }
+
+    switch (pabPacket_p[0] >> 4)
+    {
+        case CONNECT:
+        {
+            if (MQTTDeserialize_connect(&MqttConnectionData, pabPacket_p, iPacketLen_p) != 1)
+            {
+                return (false);
+            }
+            iLen = MqttConnectionData.clientID.lenstring.len;
+            if (iLen >= (int)sizeof(pClient_p->m_szClientID))
+            {
+                iLen = sizeof(pClient_p->m_szClientID) - 1;
+            }
+            memcpy(pClient_p->m_szClientID, MqttConnectionData.clientID.lenstring.data, iLen);
+            pClient_p->m_szClientID[iLen] = '\0';
+            pClient_p->m_fConnected = true;
+            if ( fVerbose_l )
+            {
+                printf("MQTT Broker Stand-In: '%s' connected\n", pClient_p->m_szClientID);
+            }
+            iLen = MQTTSerialize_connack(abMqttRawDataPacketBuff, sizeof(abMqttRawDataPacketBuff), 0, 0);
+            return (MqbSendPacket(pClient_p, abMqttRawDataPacketBuff, iLen));
+        }
+
+        case SUBSCRIBE:
+        {
+            if (MQTTDeserialize_subscribe(&bDupFlag, &usPacketId, MQB_MAX_SUBSCRIPTIONS, &iCount,
+                                          aMqttTopicFilter, aiGrantedQoS, pabPacket_p, iPacketLen_p) != 1)
+            {
+                return (false);
+            }
+            for (iIdx=0; iIdx<iCount; iIdx++)
+            {
+                aiGrantedQoS[iIdx] = 0x80;                  // failure
+                if ((pClient_p->m_uiSubscrCount < MQB_MAX_SUBSCRIPTIONS) &&
+                    (aMqttTopicFilter[iIdx].lenstring.len < (int)MQB_MAX_FILTER_LEN))
+                {
+                    uiSubscr = pClient_p->m_uiSubscrCount++;
+                    memcpy(pClient_p->m_aszFilter[uiSubscr], aMqttTopicFilter[iIdx].lenstring.data, aMqttTopicFilter[iIdx].lenstring.len);
+                    pClient_p->m_aszFilter[uiSubscr][aMqttTopicFilter[iIdx].lenstring.len] = '\0';
+                    aiGrantedQoS[iIdx] = 0;
+                    if ( fVerbose_l )
+                    {
+                        printf("MQTT Broker Stand-In: '%s' subscribed '%s'\n", pClient_p->m_szClientID, pClient_p->m_aszFilter[uiSubscr]);
+                    }
+                }
+            }
+            iLen = MQTTSerialize_suback(abMqttRawDataPacketBuff, sizeof(abMqttRawDataPacketBuff), usPacketId, iCount, aiGrantedQoS);
+            return (MqbSendPacket(pClient_p, abMqttRawDataPacketBuff, iLen));
+        }
+
+        case UNSUBSCRIBE:
+        {
+            if (MQTTDeserialize_unsubscribe(&bDupFlag, &usPacketId, MQB_MAX_SUBSCRIPTIONS, &iCount,
+                                            aMqttTopicFilter, pabPacket_p, iPacketLen_p) != 1)
+            {
+                return (false);
+            }
+            for (iIdx=0; iIdx<iCount; iIdx++)
+            {
+                for (uiSubscr=0; uiSubscr<pClient_p->m_uiSubscrCount; uiSubscr++)
+                {
+                    if ((strlen(pClient_p->m_aszFilter[uiSubscr]) == (size_t)aMqttTopicFilter[iIdx].lenstring.len) &&
+                        !memcmp(pClient_p->m_aszFilter[uiSubscr], aMqttTopicFilter[iIdx].lenstring.data, aMqttTopicFilter[iIdx].lenstring.len))
+                    {
+                        pClient_p->m_uiSubscrCount--;
+                        strcpy(pClient_p->m_aszFilter[uiSubscr], pClient_p->m_aszFilter[pClient_p->m_uiSubscrCount]);
+                        break;
+                    }
+                }
+            }
+            iLen = MQTTSerialize_unsuback(abMqttRawDataPacketBuff, sizeof(abMqttRawDataPacketBuff), usPacketId);
+            return (MqbSendPacket(pClient_p, abMqttRawDataPacketBuff, iLen));
+        }
+
+        case PUBLISH:
+        {
+            if (MQTTDeserialize_publish(&bDupFlag, &iQos, &bRetainedFlag, &usPacketId, &MqttTopicName,
+                                        &pabPayload, &iPayloadLen, pabPacket_p, iPacketLen_p) != 1)
+            {
+                return (false);
+            }
+            if (iQos > 1)
+            {
+                return (false);                             // QoS 2 is not supported
+            }
+            MqbForwardPublish(&MqttTopicName, pabPayload, iPayloadLen);
+            if (iQos == 1)
+            {
+                iLen = MQTTSerialize_puback(abMqttRawDataPacketBuff, sizeof(abMqttRawDataPacketBuff), usPacketId);
+                return (MqbSendPacket(pClient_p, abMqttRawDataPacketBuff, iLen));
+            }
+            return (true);
+        }
+
+        case PINGREQ:
+        {
+            abMqttRawDataPacketBuff[0] = (uint8_t)(PINGRESP << 4);
+            abMqttRawDataPacketBuff[1] = 0;
+            return (MqbSendPacket(pClient_p, abMqttRawDataPacketBuff, 2));
+        }
+
+        case DISCONNECT:
+        {
+            return (false);
+        }
+
+        default:
+        {
+            // PUBACK etc. are never expected, since all messages are sent with QoS 0
+            return (true);
+        }
+    }
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Forward PUBLISH Message to all Clients with matching Subscription
+//---------------------------------------------------------------------------
+
+static  void  MqbForwardPublish (
+    const MQTTString* pTopicName_p,
+    uint8_t* pabPayload_p,
+    int iPayloadLen_p)
+{
+
+uint8_t     abMqttRawDataPacketBuff[MQC_RX_BUFF_SIZE];
+tMqbClient* pClient;
+int         iLen;
+uint        uiIdx;
+uint        uiSubscr;
+
+
+    if ( fVerbose_l )
+    {
+        printf("MQTT Broker Stand-In: PUBLISH '%.*s' (%d bytes)\n", pTopicName_p->lenstring.len, pTopicName_p->lenstring.data, iPayloadLen_p);
+    }
+
+    // serialized once for all subscribers (QoS 0, not retained)
+    iLen = MQTTSerialize_publish(abMqttRawDataPacketBuff, sizeof(abMqttRawDataPacketBuff), 0, 0, 0, 0,
+                                 *pTopicName_p, pabPayload_p, iPayloadLen_p);
+    if (iLen <= 0)
+    {
+        return;
+    }
+
+    for (uiIdx=0; uiIdx<MQB_MAX_CLIENTS; uiIdx++)
+    {
+        pClient = &aMqbClient_l[uiIdx];
+        if ((pClient->m_iSocket < 0) || !pClient->m_fConnected)
+        {
+            continue;
+        }
+        for (uiSubscr=0; uiSubscr<pClient->m_uiSubscrCount; uiSubscr++)
+        {
+            if ( MqbTopicMatch(pClient->m_aszFilter[uiSubscr], pTopicName_p->lenstring.data, (uint)pTopicName_p->lenstring.len) )
+            {
+                if ( !MqbSendPacket(pClient, abMqttRawDataPacketBuff, iLen) )
+                {
+                    MqbCloseClient(pClient);
+                }
+                uiMsgCount_l++;
+                break;
+            }
+        }
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Check if Topic matches Topic Filter (wildcards '+' and '#')
+//---------------------------------------------------------------------------
+
+static  bool  MqbTopicMatch (
+    const char* pszFilter_p,
+    const char* pszTopic_p,
+    uint uiTopicLen_p)
+{
+
+const char*  pszFilter;
+uint         uiPos;
+
+
+    pszFilter = pszFilter_p;
+    uiPos = 0;
+    while (*pszFilter != '\0')
+    {
+        if (*pszFilter == '#')
+        {
+            return (true);
+        }
+        if (*pszFilter == '+')
+        {
+            while ((uiPos < uiTopicLen_p) && (pszTopic_p[uiPos] != '/'))
+            {
+                uiPos++;
+            }
+            pszFilter++;
+            continue;
+        }
+        if ((uiPos >= uiTopicLen_p) || (*pszFilter != pszTopic_p[uiPos]))
+        {
+            return (false);
+        }
+        pszFilter++;
+        uiPos++;
+    }
+
+    return (uiPos == uiTopicLen_p);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Send MQTT Packet to Client
+//---------------------------------------------------------------------------
+
+static  bool  MqbSendPacket (
+    tMqbClient* pClient_p,
+    const uint8_t* pabPacket_p,
+    int iPacketLen_p)
+{
+
+ssize_t  iRes;
+
+
+    iRes = send(pClient_p->m_iSocket, pabPacket_p, iPacketLen_p, 0);
+
+    return (iRes == iPacketLen_p);
+
+}
+
+
+
+// EOF
+
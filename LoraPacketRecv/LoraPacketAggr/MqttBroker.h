@@ -0,0 +1,46 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Aggregator
+  Description:  Declarations for minimal MQTT Broker (local Stand-In)
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _MQTTBROKER_H_
+#define _MQTTBROKER_H_
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+const  uint  MQB_MAX_CLIENTS        = 16;
+const  uint  MQB_MAX_SUBSCRIPTIONS  = 8;        // per client
+const  uint  MQB_MAX_FILTER_LEN     = 128;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of public functions
+//---------------------------------------------------------------------------
+
+int   MqbRun (
+    uint uiPortNum_p,                                   // [IN]     TCP Port to listen on
+    volatile bool* pfRun_p,                             // [IN]     Broker runs as long as *pfRun_p is true
+    bool fVerbose_p);                                   // [IN]     Print connections and messages
+
+
+
+#endif  // #ifndef _MQTTBROKER_H_
+
+
+// EOF
+
@@ -0,0 +1,581 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Aggregator
+  Description:  Implementation of MQTT Client with multiple Connections
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <poll.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include "MQTTPacket.h"
+#include "MqttTransport.h"
+#include "MqttClient.h"
+#include "Trace.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+static  const  int      MQC_CONNACK_TIMEOUT_MS  = 5000;
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Macro definitions
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  int  MqcSendPacket (
+    tMqcConnection* pConn_p,
+    uint8_t* pabPacket_p,
+    int iPacketLen_p);
+
+static  uint16_t  MqcGetPacketId (
+    tMqcConnection* pConn_p);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Initialize Connection
+//---------------------------------------------------------------------------
+//  All strings are referenced, not copied - they must stay valid as long
+//  as the connection is used (needed for reconnect).
+
+void  MqcInitConnection (
+    tMqcConnection* pConn_p,                            // [OUT]    Connection to initialize
+    const char* pszHostUrl_p,                           // [IN]     Host URL
+    uint uiHostPortNum_p,                               // [IN]     Host PortNumber
+    const char* pszClientName_p,                        // [IN]     Client Name
+    uint uiKeepAliveInterval_p)                         // [IN]     KeepAlive Interval in [sec]
+{
+
+    memset(pConn_p, 0, sizeof(tMqcConnection));
+    pConn_p->m_iSocket             = -1;
+    pConn_p->m_pszHostUrl          = pszHostUrl_p;
+    pConn_p->m_uiHostPortNum       = uiHostPortNum_p;
+    pConn_p->m_pszClientName       = pszClientName_p;
+    pConn_p->m_uiKeepAliveInterval = uiKeepAliveInterval_p;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Connect to MQTT Broker
+//---------------------------------------------------------------------------
+
+int  MqcConnect (
+    tMqcConnection* pConn_p)                            // [IN]     Connection
+{
+
+MQTTPacket_connectData  MqttConnectionData = MQTTPacket_connectData_initializer;
+uint8_t        abMqttRawDataPacketBuff[256];
+struct pollfd  FdSet;
+int            iUsedBuffLen;
+int            iSocket;
+int            iOldSocket;
+unsigned char  bSessionPresentFlag;
+unsigned char  bConnAckRes;
+int            iRes;
+
+
+    TRACE3("MqcConnect: '%s:%u' as '%s'\n", pConn_p->m_pszHostUrl, pConn_p->m_uiHostPortNum, pConn_p->m_pszClientName);
+
+    MqcClose(pConn_p);
+
+    // open connection to host (broker)
+    iSocket = MqttTransport_Open((char*)pConn_p->m_pszHostUrl, (int)pConn_p->m_uiHostPortNum);
+    if (iSocket < 0)
+    {
+        return (-2);
+    }
+    pConn_p->m_iSocket      = iSocket;
+    pConn_p->m_uiRxDataLen  = 0;
+    pConn_p->m_ui16PacketId = 0;
+
+    // send connection request to host
+    MqttConnectionData.MQTTVersion       = 4;
+    MqttConnectionData.clientID.cstring  = (char*)pConn_p->m_pszClientName;
+    MqttConnectionData.keepAliveInterval = pConn_p->m_uiKeepAliveInterval;
+    MqttConnectionData.cleansession      = 1;
+    iUsedBuffLen = MQTTSerialize_connect(abMqttRawDataPacketBuff, sizeof(abMqttRawDataPacketBuff), &MqttConnectionData);
+    iRes = MqcSendPacket(pConn_p, abMqttRawDataPacketBuff, iUsedBuffLen);
+    if (iRes != 0)
+    {
+        return (-3);
+    }
+
+    // wait for connection acknowledge from host (unlike LibMqtt with timeout,
+    // a hanging broker must not block the other connections forever)
+    FdSet.fd      = iSocket;
+    FdSet.events  = POLLIN;
+    FdSet.revents = 0;
+    iRes = poll(&FdSet, 1, MQC_CONNACK_TIMEOUT_MS);
+    if (iRes <= 0)
+    {
+        MqcClose(pConn_p);
+        return (-5);
+    }
+
+    iOldSocket = MqttTransport_SetGetDataSocket(iSocket);
+    iRes = MQTTPacket_read(abMqttRawDataPacketBuff, sizeof(abMqttRawDataPacketBuff), MqttTransport_GetData);
+    MqttTransport_SetGetDataSocket(iOldSocket);
+    if (iRes != CONNACK)
+    {
+        MqcClose(pConn_p);
+        return (-5);
+    }
+
+    iRes = MQTTDeserialize_connack(&bSessionPresentFlag, &bConnAckRes, abMqttRawDataPacketBuff, sizeof(abMqttRawDataPacketBuff));
+    if ((iRes != 1) || (bConnAckRes != 0))
+    {
+        MqcClose(pConn_p);
+        return (-4);
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Disconnect from MQTT Broker
+//---------------------------------------------------------------------------
+
+int  MqcDisconnect (
+    tMqcConnection* pConn_p)                            // [IN]     Connection
+{
+
+uint8_t  abMqttRawDataPacketBuff[16];
+int      iUsedBuffLen;
+int      iRes;
+
+
+    if (pConn_p->m_iSocket < 0)
+    {
+        return (-1);
+    }
+
+    iUsedBuffLen = MQTTSerialize_disconnect(abMqttRawDataPacketBuff, sizeof(abMqttRawDataPacketBuff));
+    iRes = MqcSendPacket(pConn_p, abMqttRawDataPacketBuff, iUsedBuffLen);
+
+    MqcClose(pConn_p);
+
+    return (iRes);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Close Connection (without DISCONNECT Message)
+//---------------------------------------------------------------------------
+
+void  MqcClose (
+    tMqcConnection* pConn_p)                            // [IN]     Connection
+{
+
+    if (pConn_p->m_iSocket >= 0)
+    {
+        MqttTransport_Close(pConn_p->m_iSocket);
+        pConn_p->m_iSocket = -1;
+    }
+    pConn_p->m_uiRxDataLen = 0;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Subscribe Topic Filter
+//---------------------------------------------------------------------------
+//  The SUBACK is consumed by MqcProcessRxData() later, so subscribing
+//  several filters doesn't need a round trip per filter.
+
+int  MqcSubscribe (
+    tMqcConnection* pConn_p,                            // [IN]     Connection
+    const char* pszTopicFilter_p)                       // [IN]     Topic Filter (wildcards '+' and '#')
+{
+
+MQTTString  aMqttTopicFilter[1] = { MQTTString_initializer };
+int         aiRequestedQoS[1]   = { 0 };
+uint8_t     abMqttRawDataPacketBuff[256];
+int         iUsedBuffLen;
+
+
+    if (pConn_p->m_iSocket < 0)
+    {
+        return (-1);
+    }
+
+    aMqttTopicFilter[0].cstring = (char*)pszTopicFilter_p;
+    iUsedBuffLen = MQTTSerialize_subscribe(abMqttRawDataPacketBuff, sizeof(abMqttRawDataPacketBuff),
+                                           0, MqcGetPacketId(pConn_p), 1, aMqttTopicFilter, aiRequestedQoS);
+    if (iUsedBuffLen <= 0)
+    {
+        return (-2);
+    }
+
+    return (MqcSendPacket(pConn_p, abMqttRawDataPacketBuff, iUsedBuffLen));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Publish Message (QoS 0)
+//---------------------------------------------------------------------------
+
+int  MqcPublish (
+    tMqcConnection* pConn_p,                            // [IN]     Connection
+    const char* pszTopic_p,                             // [IN]     Topic string
+    const uint8_t* pabPayload_p,                        // [IN]     Payload
+    uint uiPayloadLen_p,                                // [IN]     Length of Payload
+    bool fRetained_p)                                   // [IN]     MQTT retained flag
+{
+
+MQTTString  MqttTopicString = MQTTString_initializer;
+uint8_t     abMqttRawDataPacketBuff[MQC_TX_BUFF_SIZE];
+int         iUsedBuffLen;
+
+
+    if (pConn_p->m_iSocket < 0)
+    {
+        return (-1);
+    }
+
+    MqttTopicString.cstring = (char*)pszTopic_p;
+    iUsedBuffLen = MQTTSerialize_publish(abMqttRawDataPacketBuff, sizeof(abMqttRawDataPacketBuff),
+                                         0, 0, (unsigned char)fRetained_p, 0,
+                                         MqttTopicString, (unsigned char*)pabPayload_p, (int)uiPayloadLen_p);
+    if (iUsedBuffLen <= 0)
+    {
+        return (-2);
+    }
+
+    return (MqcSendPacket(pConn_p, abMqttRawDataPacketBuff, iUsedBuffLen));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Process received Data (call if socket is readable)
+//---------------------------------------------------------------------------
+//  Reads all data available without blocking and passes each complete PUBLISH
+//  Message to the callback. Incomplete packets are kept in the receive buffer
+//  until the rest arrives.
+//  Return: >=0 = number of PUBLISH Messages, <0 = connection lost (closed)
+
+int  MqcProcessRxData (
+    tMqcConnection* pConn_p,                            // [IN]     Connection
+    tMqcRecvCallback pfnRecvCallback_p,                 // [IN]     Callback for PUBLISH Messages (or NULL)
+    void* pvArg_p)                                      // [IN]     Argument for Callback
+{
+
+MQTTString      MqttTopicString;
+unsigned char   bDupFlag;
+int             iQos;
+unsigned char   bRetainedFlag;
+unsigned short  usPacketId;
+unsigned char*  pabPayload;
+int             iPayloadLen;
+uint            uiOffset;
+int             iPacketLen;
+int             iMsgCount;
+ssize_t         iRecvLen;
+int             iRes;
+
+
+    if (pConn_p->m_iSocket < 0)
+    {
+        return (-1);
+    }
+
+    iMsgCount = 0;
+    for (;;)
+    {
+        iRecvLen = recv(pConn_p->m_iSocket, &pConn_p->m_abRxBuff[pConn_p->m_uiRxDataLen],
+                        MQC_RX_BUFF_SIZE - pConn_p->m_uiRxDataLen, MSG_DONTWAIT);
+        if (iRecvLen == 0)
+        {
+            TRACE1("MqcProcessRxData: '%s' closed by broker\n", pConn_p->m_pszHostUrl);
+            MqcClose(pConn_p);
+            return (-2);
+        }
+        if (iRecvLen < 0)
+        {
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR))
+            {
+                break;
+            }
+            MqcClose(pConn_p);
+            return (-3);
+        }
+        pConn_p->m_uiRxDataLen += (uint)iRecvLen;
+
+        // split received data into MQTT packets
+        uiOffset = 0;
+        for (;;)
+        {
+            iPacketLen = MqcGetPacketLength(&pConn_p->m_abRxBuff[uiOffset], pConn_p->m_uiRxDataLen - uiOffset);
+            if (iPacketLen == 0)
+            {
+                break;
+            }
+            if ((iPacketLen < 0) || (iPacketLen > (int)MQC_RX_BUFF_SIZE))
+            {
+                TRACE1("MqcProcessRxData: invalid packet length (%d)\n", iPacketLen);
+                MqcClose(pConn_p);
+                return (-4);
+            }
+
+            if ((pConn_p->m_abRxBuff[uiOffset] >> 4) == PUBLISH)
+            {
+                iRes = MQTTDeserialize_publish(&bDupFlag, &iQos, &bRetainedFlag, &usPacketId, &MqttTopicString,
+                                               &pabPayload, &iPayloadLen, &pConn_p->m_abRxBuff[uiOffset], iPacketLen);
+                if ((iRes == 1) && (pfnRecvCallback_p != NULL))
+                {
+                    pfnRecvCallback_p(pvArg_p, MqttTopicString.lenstring.data, (uint)MqttTopicString.lenstring.len,
+                                      pabPayload, (uint)iPayloadLen);
+                }
+                iMsgCount++;
+            }
+            // CONNACK, SUBACK and PINGRESP need no further processing
+
+            uiOffset += (uint)iPacketLen;
+        }
+
+        if (uiOffset > 0)
+        {
+            memmove(pConn_p->m_abRxBuff, &pConn_p->m_abRxBuff[uiOffset], pConn_p->m_uiRxDataLen - uiOffset);
+            pConn_p->m_uiRxDataLen -= uiOffset;
+        }
+    }
+
+    return (iMsgCount);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Send PINGREQ if nothing was sent within KeepAlive Interval
+//---------------------------------------------------------------------------
+
+int  MqcKeepAlive (
+    tMqcConnection* pConn_p)                            // [IN]     Connection
+{
+
+uint8_t  abMqttRawDataPacketBuff[16];
+int      iUsedBuffLen;
+
+
+    if (pConn_p->m_iSocket < 0)
+    {
+        return (-1);
+    }
+
+    if ((time(NULL) - pConn_p->m_tmLastTxTime) < (time_t)pConn_p->m_uiKeepAliveInterval)
+    {
+        return (0);
+    }
+
+    iUsedBuffLen = MQTTSerialize_pingreq(abMqttRawDataPacketBuff, sizeof(abMqttRawDataPacketBuff));
+
+    return (MqcSendPacket(pConn_p, abMqttRawDataPacketBuff, iUsedBuffLen));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Check if Connection is established
+//---------------------------------------------------------------------------
+
+bool  MqcIsConnected (
+    const tMqcConnection* pConn_p)                      // [IN]     Connection
+{
+
+    return (pConn_p->m_iSocket >= 0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get total Length of MQTT Packet from its Fixed Header
+//---------------------------------------------------------------------------
+//  Return: >0 = packet length, 0 = header incomplete, <0 = invalid header
+
+int  MqcGetPacketLength (
+    const uint8_t* pabData_p,                           // [IN]     Received Data
+    uint uiDataLen_p)                                   // [IN]     Length of received Data
+{
+
+uint  uiRemainLen;
+uint  uiMultiplier;
+uint  uiIdx;
+
+
+    uiRemainLen  = 0;
+    uiMultiplier = 1;
+    for (uiIdx=1; ; uiIdx++)
+    {
+        if (uiIdx > 4)
+        {
+            return (-1);
+        }
+        if (uiIdx >= uiDataLen_p)
+        {
+            return (0);
+        }
+        uiRemainLen  += (pabData_p[uiIdx] & 0x7F) * uiMultiplier;
+        uiMultiplier *= 128;
+        if ((pabData_p[uiIdx] & 0x80) == 0)
+        {
+            break;
+        }
+    }
+
+    if ((1 + uiIdx + uiRemainLen) > uiDataLen_p)
+    {
+        return (0);
+    }
+
+    return ((int)(1 + uiIdx + uiRemainLen));
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Send MQTT Packet
+//---------------------------------------------------------------------------
+
+static  int  MqcSendPacket (
+    tMqcConnection* pConn_p,
+    uint8_t* pabPacket_p,
+    int iPacketLen_p)
+{
+
+int  iRes;
+
+
+    iRes = MqttTransport_SendPacketBuffer(pConn_p->m_iSocket, pabPacket_p, iPacketLen_p);
+    if (iRes != iPacketLen_p)
+    {
+        TRACE2("MqcSendPacket: send() to '%s' failed (iRes=%d)\n", pConn_p->m_pszHostUrl, iRes);
+        MqcClose(pConn_p);
+        return (-3);
+    }
+
+    pConn_p->m_tmLastTxTime = time(NULL);
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get next Packet ID
+//---------------------------------------------------------------------------
+
+static  uint16_t  MqcGetPacketId (
+    tMqcConnection* pConn_p)
+{
+
+    if ((pConn_p->m_ui16PacketId == 0) || (pConn_p->m_ui16PacketId >= 0xFFFE))
+    {
+        pConn_p->m_ui16PacketId = 1;
+    }
+    else
+    {
+        pConn_p->m_ui16PacketId++;
+    }
+
+    return (pConn_p->m_ui16PacketId);
+
+}
+
+
+
+// EOF
+
@@ -0,0 +1,112 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Aggregator
+  Description:  Declarations for MQTT Client with multiple Connections
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _MQTTCLIENT_H_
+#define _MQTTCLIENT_H_
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+const  uint  MQC_RX_BUFF_SIZE       = 4096;     // must hold at least one complete MQTT packet
+const  uint  MQC_TX_BUFF_SIZE       = 2048;
+
+
+
+//---------------------------------------------------------------------------
+//  Type definitions
+//---------------------------------------------------------------------------
+
+// Callback for received PUBLISH Messages
+typedef void (*tMqcRecvCallback) (
+    void* pvArg_p,                                      // [IN]     Argument given to MqcProcessRxData()
+    const char* pszTopic_p,                             // [IN]     Topic (not zero terminated)
+    uint uiTopicLen_p,                                  // [IN]     Length of Topic
+    const uint8_t* pabPayload_p,                        // [IN]     Payload
+    uint uiPayloadLen_p);                               // [IN]     Length of Payload
+
+
+// Connection to one MQTT Broker (unlike LibMqtt, any number of them can be used in parallel)
+typedef struct
+{
+    int                 m_iSocket;                  // -1 = not connected
+    const char*         m_pszHostUrl;
+    uint                m_uiHostPortNum;
+    const char*         m_pszClientName;
+    uint                m_uiKeepAliveInterval;      // [sec]
+    time_t              m_tmLastTxTime;             // for PINGREQ
+    uint16_t            m_ui16PacketId;
+    uint                m_uiRxDataLen;
+    uint8_t             m_abRxBuff[MQC_RX_BUFF_SIZE];
+
+} tMqcConnection;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of public functions
+//---------------------------------------------------------------------------
+
+void  MqcInitConnection (
+    tMqcConnection* pConn_p,                            // [OUT]    Connection to initialize
+    const char* pszHostUrl_p,                           // [IN]     Host URL
+    uint uiHostPortNum_p,                               // [IN]     Host PortNumber
+    const char* pszClientName_p,                        // [IN]     Client Name
+    uint uiKeepAliveInterval_p);                        // [IN]     KeepAlive Interval in [sec]
+
+int   MqcConnect (
+    tMqcConnection* pConn_p);                           // [IN]     Connection
+
+int   MqcDisconnect (
+    tMqcConnection* pConn_p);                           // [IN]     Connection
+
+void  MqcClose (
+    tMqcConnection* pConn_p);                           // [IN]     Connection
+
+int   MqcSubscribe (
+    tMqcConnection* pConn_p,                            // [IN]     Connection
+    const char* pszTopicFilter_p);                      // [IN]     Topic Filter (wildcards '+' and '#')
+
+int   MqcPublish (
+    tMqcConnection* pConn_p,                            // [IN]     Connection
+    const char* pszTopic_p,                             // [IN]     Topic string
+    const uint8_t* pabPayload_p,                        // [IN]     Payload
+    uint uiPayloadLen_p,                                // [IN]     Length of Payload
+    bool fRetained_p);                                  // [IN]     MQTT retained flag
+
+int   MqcProcessRxData (
+    tMqcConnection* pConn_p,                            // [IN]     Connection
+    tMqcRecvCallback pfnRecvCallback_p,                 // [IN]     Callback for PUBLISH Messages (or NULL)
+    void* pvArg_p);                                     // [IN]     Argument for Callback
+
+int   MqcKeepAlive (
+    tMqcConnection* pConn_p);                           // [IN]     Connection
+
+bool  MqcIsConnected (
+    const tMqcConnection* pConn_p);                     // [IN]     Connection
+
+int   MqcGetPacketLength (
+    const uint8_t* pabData_p,                           // [IN]     Received Data
+    uint uiDataLen_p);                                  // [IN]     Length of received Data
+
+
+
+#endif  // #ifndef _MQTTCLIENT_H_
+
+
+// EOF
+
@@ -0,0 +1,1109 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Implementation of Binary Ring Buffer Logger
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include "BinaryLogger.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+const  unsigned int  BLG_MIN_RING_SIZE       = (4 * 1024);  // min. size of a per-thread ring [Bytes]
+const  unsigned int  BLG_IDLE_SLEEP_MIN      = 1;           // min. sleep time of idle consumer [ms]
+const  unsigned int  BLG_IDLE_SLEEP_MAX      = 50;          // max. sleep time of idle consumer [ms]
+const  unsigned int  BLG_FLUSH_TIMEOUT       = 1000;        // max. time BlgFlush() waits for the consumer [ms]
+const  unsigned int  BLG_BENCH_BATCH_SIZE    = 256;         // log calls per timed batch (must fit into one ring)
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Macro definitions
+//---------------------------------------------------------------------------
+
+#define BLG_ALIGN8(n)           (((n) + 7) & ~((size_t)7))
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+typedef struct
+{
+    uint32_t            m_ui32RecSize;              // total size incl. header [Bytes], 0 = wrap marker
+    uint8_t             m_ui8Level;
+    uint8_t             m_ui8ArgCnt;
+    uint16_t            m_ui16Reserved;
+    const char*         m_pszFmt;                   // address of format string = message ID
+    uint64_t            m_ui64TimeStamp;            // monotonic time [ns], used to merge the rings in order
+
+} tBlgRecHeader;
+
+
+typedef struct tBlgRing
+{
+    alignas(64) std::atomic<uint64_t>   m_ui64Head; // written by producer only
+    alignas(64) std::atomic<uint64_t>   m_ui64Tail; // written by consumer only
+    alignas(64) uint64_t                m_ui64PendingHead;
+    std::atomic<uint64_t>               m_ui64Dropped;
+    uint8_t*                            m_pabBuffer;
+    size_t                              m_nSize;    // power of two
+    struct tBlgRing*                    m_pNext;
+
+} tBlgRing;
+
+
+typedef struct
+{
+    uint8_t             m_ui8Type;                  // <tBlgArgType> | size of original type
+    uint64_t            m_ui64Val;
+    double              m_dblVal;
+    const char*         m_pszStr;
+
+} tBlgArg;
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+std::atomic<int>    iBlgLogLevel_g (kBlgLevelInfo);
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+static  std::atomic<bool>       fRunning_l (false);
+static  std::atomic<bool>       fStopConsumer_l (false);
+static  std::atomic<unsigned>   uiGeneration_l (0);
+static  std::atomic<tBlgRing*>  pRingList_l (NULL);
+static  std::mutex              RingListMutex_l;
+static  std::thread             ConsumerThread_l;
+static  FILE*                   pOutStream_l            = NULL;
+static  size_t                  nRingSize_l             = BLG_DEF_RING_SIZE;
+static  std::atomic<uint64_t>   ui64DroppedTotal_l (0);
+
+static  std::mutex              SyncMutex_l;            // fallback if logger is not running
+static  std::vector<uint8_t>    vecSyncRecord_l;
+
+static  thread_local  tBlgRing*     pThreadRing_l       = NULL;
+static  thread_local  unsigned      uiThreadRingGen_l   = 0;
+static  thread_local  bool          fThreadSyncRecord_l = false;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  tBlgRing*  BlgGetThreadRing (void);
+static  void       BlgConsumerThread (void);
+static  bool       BlgProcessOldestRecord (void);
+static  bool       BlgPeekRecord (tBlgRing* pRing_p, const tBlgRecHeader** ppRecHeader_p);
+static  bool       BlgAreRingsEmpty (void);
+static  void       BlgFreeRings (void);
+static  void       BlgFormatRecord (FILE* pOutStream_p, const tBlgRecHeader* pRecHeader_p);
+static  const uint8_t*  BlgGetArg (const uint8_t* pabSrc_p, tBlgArg* pArg_p);
+static  int64_t    BlgArgAsSigned (const tBlgArg* pArg_p);
+static  uint64_t   BlgArgAsUnsigned (const tBlgArg* pArg_p);
+static  uint64_t   BlgGetTimeStamp (void);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Initialize Logger and start Consumer Thread
+//---------------------------------------------------------------------------
+
+int  BlgInitialize (
+    unsigned int uiRingSize_p,                          // [IN]     Size of each per-thread Ring [Bytes] (0 = default)
+    int iLogLevel_p,                                    // [IN]     Initial Log Level (<tBlgLogLevel>)
+    FILE* pOutStream_p)                                 // [IN]     Output Stream for formatted Records (NULL = stdout)
+{
+
+size_t  nRingSize;
+
+
+    if ( fRunning_l.load() )
+    {
+        return (-1);
+    }
+
+    // round up ring size to the next power of two (required for index masking)
+    if (uiRingSize_p == 0)
+    {
+        uiRingSize_p = BLG_DEF_RING_SIZE;
+    }
+    nRingSize = BLG_MIN_RING_SIZE;
+    while (nRingSize < uiRingSize_p)
+    {
+        nRingSize <<= 1;
+    }
+
+    nRingSize_l  = nRingSize;
+    pOutStream_l = (pOutStream_p != NULL) ? pOutStream_p : stdout;
+    BlgSetLogLevel(iLogLevel_p);
+
+    // rings of a previous session are invalidated by incrementing the generation
+    uiGeneration_l++;
+    fStopConsumer_l = false;
+    fRunning_l = true;
+    ConsumerThread_l = std::thread(BlgConsumerThread);
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Drain all Rings, stop Consumer Thread and release Rings
+//---------------------------------------------------------------------------
+//  Other threads must not log concurrently while the logger is shut down.
+
+int  BlgShutdown (void)
+{
+
+    if ( !fRunning_l.load() )
+    {
+        return (-1);
+    }
+
+    // from now on new records are formatted synchronously by the caller
+    fRunning_l = false;
+
+    fStopConsumer_l = true;
+    if ( ConsumerThread_l.joinable() )
+    {
+        ConsumerThread_l.join();
+    }
+
+    BlgFreeRings();
+    fflush(pOutStream_l);
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Set / Get Log Level
+//---------------------------------------------------------------------------
+
+void  BlgSetLogLevel (
+    int iLogLevel_p)                                    // [IN]     New Log Level (<tBlgLogLevel>)
+{
+
+    if (iLogLevel_p < kBlgLevelError)
+    {
+        iLogLevel_p = kBlgLevelError;
+    }
+    if (iLogLevel_p > kBlgLevelTrace)
+    {
+        iLogLevel_p = kBlgLevelTrace;
+    }
+
+    iBlgLogLevel_g.store(iLogLevel_p, std::memory_order_relaxed);
+
+    return;
+
+}
+
+int  BlgGetLogLevel (void)
+{
+
+    return (iBlgLogLevel_g.load(std::memory_order_relaxed));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Wait until all pending Records are written to the Output Stream
+//---------------------------------------------------------------------------
+//  Used before output is written directly to the stream (e.g. multi-line
+//  dumps in verbose mode), so that both kinds of output stay in order.
+
+int  BlgFlush (void)
+{
+
+std::chrono::steady_clock::time_point  tpTimeout;
+int  iRes;
+
+
+    iRes = 0;
+
+    if ( fRunning_l.load() )
+    {
+        tpTimeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(BLG_FLUSH_TIMEOUT);
+        while ( !BlgAreRingsEmpty() )
+        {
+            if (std::chrono::steady_clock::now() > tpTimeout)
+            {
+                iRes = -1;
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    if (pOutStream_l != NULL)
+    {
+        fflush(pOutStream_l);
+    }
+
+    return (iRes);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Allocate the Ring of the calling Thread in advance
+//---------------------------------------------------------------------------
+//  Normally the ring is created by the first log call of a thread. Threads
+//  that must not allocate memory in their hot path (e.g. the real-time
+//  radio thread) call this function once at startup instead.
+
+int  BlgRegisterThread (void)
+{
+
+    if ( !fRunning_l.load() )
+    {
+        return (-1);
+    }
+
+    if (BlgGetThreadRing() == NULL)
+    {
+        return (-2);
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get number of Records dropped because of a full Ring
+//---------------------------------------------------------------------------
+
+uint64_t  BlgGetDropCount (void)
+{
+
+tBlgRing*  pRing;
+uint64_t   ui64Dropped;
+
+
+    ui64Dropped = ui64DroppedTotal_l.load();
+
+    std::lock_guard<std::mutex> Lock(RingListMutex_l);
+    for (pRing=pRingList_l.load(); pRing!=NULL; pRing=pRing->m_pNext)
+    {
+        ui64Dropped += pRing->m_ui64Dropped.load(std::memory_order_relaxed);
+    }
+
+    return (ui64Dropped);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Compare Hot-Path Cost of BLG_LOG() with printf()
+//---------------------------------------------------------------------------
+//  Both variants write the same message as the main loop does for each
+//  received packet. Formatted output goes to '/dev/null', so only the cost
+//  for the calling thread is measured (the consumer thread of the logger
+//  runs concurrently, like in normal operation).
+
+int  BlgRunBenchmark (
+    unsigned int uiIterations_p)                        // [IN]     Number of Log Calls per measured Run
+{
+
+static const char*  pszBenchFmt = "\n%s : LoRa Message received (LoRaPacket: %04u, RSSI: %d [dB])\n";
+
+FILE*     pNullStream;
+char      szTimeStamp[64];
+double    adblNsPerCall[4];
+uint64_t  ui64Dropped;
+unsigned  uiRun;
+unsigned  uiBatch;
+unsigned  uiIdx;
+std::chrono::steady_clock::time_point  tpStart;
+std::chrono::steady_clock::duration    Elapsed;
+
+
+    if ( fRunning_l.load() )
+    {
+        printf("\nERROR: Logger benchmark requires a stopped logger!\n");
+        return (-1);
+    }
+
+    pNullStream = fopen("/dev/null", "w");
+    if (pNullStream == NULL)
+    {
+        printf("\nERROR: Can't open '/dev/null'!\n");
+        return (-2);
+    }
+
+    if (uiIterations_p == 0)
+    {
+        uiIterations_p = 100000;
+    }
+    snprintf(szTimeStamp, sizeof(szTimeStamp), "%04d/%02d/%02d - %02d:%02d:%02d", 2023, 3, 25, 12, 34, 56);
+
+    BlgInitialize(0, kBlgLevelInfo, pNullStream);
+
+    for (uiRun=0; uiRun<4; uiRun++)
+    {
+        Elapsed = std::chrono::steady_clock::duration::zero();
+        for (uiBatch=0; uiBatch<uiIterations_p; uiBatch+=BLG_BENCH_BATCH_SIZE)
+        {
+            tpStart = std::chrono::steady_clock::now();
+            for (uiIdx=uiBatch; (uiIdx<uiIterations_p) && (uiIdx<uiBatch+BLG_BENCH_BATCH_SIZE); uiIdx++)
+            {
+                switch (uiRun)
+                {
+                    // Run(0): binary logger, enabled level
+                    case 0:
+                    {
+                        BLG_INFO(pszBenchFmt, szTimeStamp, uiIdx, -87);
+                        break;
+                    }
+
+                    // Run(1): binary logger, suppressed level
+                    case 1:
+                    {
+                        BLG_TRACE(pszBenchFmt, szTimeStamp, uiIdx, -87);
+                        break;
+                    }
+
+                    // Run(2): fprintf() into stream buffer
+                    case 2:
+                    {
+                        fprintf(pNullStream, pszBenchFmt, szTimeStamp, uiIdx, -87);
+                        break;
+                    }
+
+                    // Run(3): fprintf() + fflush(), as done by the main loop for a pipe to journald
+                    case 3:
+                    {
+                        fprintf(pNullStream, pszBenchFmt, szTimeStamp, uiIdx, -87);
+                        fflush(pNullStream);
+                        break;
+                    }
+                }
+            }
+            Elapsed += std::chrono::steady_clock::now() - tpStart;
+
+            // give the consumer time to drain the ring (not measured)
+            BlgFlush();
+        }
+        adblNsPerCall[uiRun] = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Elapsed).count() / uiIterations_p;
+    }
+
+    ui64Dropped = BlgGetDropCount();
+    BlgShutdown();
+    fclose(pNullStream);
+    pOutStream_l = NULL;
+
+    printf("Logger Benchmark (%u calls per run):\n", uiIterations_p);
+    printf("  BLG_LOG (enabled)    : %8.1f [ns/call]\n", adblNsPerCall[0]);
+    printf("  BLG_LOG (suppressed) : %8.1f [ns/call]\n", adblNsPerCall[1]);
+    printf("  printf               : %8.1f [ns/call]\n", adblNsPerCall[2]);
+    printf("  printf + fflush      : %8.1f [ns/call]\n", adblNsPerCall[3]);
+    printf("  Dropped Records      : %llu\n", (unsigned long long)ui64Dropped);
+    printf("\n");
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Reserve space for a Record in the Ring of the calling Thread
+//---------------------------------------------------------------------------
+//  Returns a pointer to the argument area of the record, or NULL if the
+//  record has to be dropped. Each successful call must be followed by
+//  BlgCommitRecord().
+
+uint8_t*  BlgReserveRecord (
+    int iLevel_p,                                       // [IN]     Log Level of Record
+    const char* pszFmt_p,                               // [IN]     Format String (static lifetime!)
+    unsigned int uiArgCnt_p,                            // [IN]     Number of Arguments
+    size_t nArgsSize_p)                                 // [IN]     Size of serialized Arguments [Bytes]
+{
+
+tBlgRing*       pRing;
+tBlgRecHeader*  pRecHeader;
+size_t          nRecSize;
+size_t          nOffset;
+size_t          nContiguous;
+size_t          nNeeded;
+uint64_t        ui64Head;
+uint64_t        ui64Tail;
+
+
+    nRecSize = BLG_ALIGN8(sizeof(tBlgRecHeader) + nArgsSize_p);
+
+    // logger not running -> build record in a local buffer and format it synchronously
+    if ( !fRunning_l.load(std::memory_order_acquire) )
+    {
+        SyncMutex_l.lock();
+        if (vecSyncRecord_l.size() < nRecSize)
+        {
+            vecSyncRecord_l.resize(nRecSize);
+        }
+        pRecHeader = (tBlgRecHeader*)vecSyncRecord_l.data();
+        fThreadSyncRecord_l = true;
+    }
+    else
+    {
+        pRing = BlgGetThreadRing();
+        if ((pRing == NULL) || (nRecSize > (pRing->m_nSize / 2)))
+        {
+            ui64DroppedTotal_l.fetch_add(1, std::memory_order_relaxed);
+            return (NULL);
+        }
+
+        ui64Head = pRing->m_ui64Head.load(std::memory_order_relaxed);
+        ui64Tail = pRing->m_ui64Tail.load(std::memory_order_acquire);
+        nOffset  = (size_t)(ui64Head & (pRing->m_nSize - 1));
+        nContiguous = pRing->m_nSize - nOffset;
+
+        // a record never wraps around the end of the buffer; the remaining
+        // space is skipped by a wrap marker instead
+        nNeeded = (nRecSize <= nContiguous) ? nRecSize : (nContiguous + nRecSize);
+        if ((pRing->m_nSize - (size_t)(ui64Head - ui64Tail)) < nNeeded)
+        {
+            pRing->m_ui64Dropped.fetch_add(1, std::memory_order_relaxed);
+            return (NULL);
+        }
+
+        if (nRecSize > nContiguous)
+        {
+            ((tBlgRecHeader*)(pRing->m_pabBuffer + nOffset))->m_ui32RecSize = 0;
+            nOffset = 0;
+        }
+
+        pRecHeader = (tBlgRecHeader*)(pRing->m_pabBuffer + nOffset);
+        pRing->m_ui64PendingHead = ui64Head + nNeeded;
+        fThreadSyncRecord_l = false;
+    }
+
+    pRecHeader->m_ui32RecSize   = (uint32_t)nRecSize;
+    pRecHeader->m_ui8Level      = (uint8_t)iLevel_p;
+    pRecHeader->m_ui8ArgCnt     = (uint8_t)uiArgCnt_p;
+    pRecHeader->m_ui16Reserved  = 0;
+    pRecHeader->m_pszFmt        = pszFmt_p;
+    pRecHeader->m_ui64TimeStamp = BlgGetTimeStamp();
+
+    return ((uint8_t*)(pRecHeader + 1));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Publish the Record reserved by BlgReserveRecord() to the Consumer
+//---------------------------------------------------------------------------
+
+void  BlgCommitRecord (void)
+{
+
+    if ( fThreadSyncRecord_l )
+    {
+        BlgFormatRecord(((pOutStream_l != NULL) ? pOutStream_l : stdout), (const tBlgRecHeader*)vecSyncRecord_l.data());
+        fThreadSyncRecord_l = false;
+        SyncMutex_l.unlock();
+        return;
+    }
+
+    pThreadRing_l->m_ui64Head.store(pThreadRing_l->m_ui64PendingHead, std::memory_order_release);
+
+    return;
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Get (or create on first use) the Ring of the calling Thread
+//---------------------------------------------------------------------------
+
+static  tBlgRing*  BlgGetThreadRing (void)
+{
+
+tBlgRing*  pRing;
+
+
+    if ((pThreadRing_l != NULL) && (uiThreadRingGen_l == uiGeneration_l.load(std::memory_order_relaxed)))
+    {
+        return (pThreadRing_l);
+    }
+
+    pRing = new tBlgRing;
+    pRing->m_pabBuffer = (uint8_t*)calloc(1, nRingSize_l);
+    if (pRing->m_pabBuffer == NULL)
+    {
+        delete pRing;
+        return (NULL);
+    }
+    pRing->m_nSize           = nRingSize_l;
+    pRing->m_ui64Head        = 0;
+    pRing->m_ui64Tail        = 0;
+    pRing->m_ui64PendingHead = 0;
+    pRing->m_ui64Dropped     = 0;
+
+    // registration is the only place where a producer takes a lock
+    {
+        std::lock_guard<std::mutex> Lock(RingListMutex_l);
+        pRing->m_pNext = pRingList_l.load();
+        pRingList_l.store(pRing, std::memory_order_release);
+    }
+
+    pThreadRing_l     = pRing;
+    uiThreadRingGen_l = uiGeneration_l.load(std::memory_order_relaxed);
+
+    return (pRing);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Consumer Thread: format Records of all Rings in TimeStamp order
+//---------------------------------------------------------------------------
+
+static  void  BlgConsumerThread (void)
+{
+
+unsigned int  uiSleepTime;
+bool          fStop;
+
+
+    uiSleepTime = BLG_IDLE_SLEEP_MIN;
+
+    do
+    {
+        // sample the stop request before draining, so that all records
+        // committed before BlgShutdown() are still written
+        fStop = fStopConsumer_l.load();
+
+        if ( BlgProcessOldestRecord() )
+        {
+            while ( BlgProcessOldestRecord() )
+            {
+            }
+
+            // one flush per drained batch instead of one per line
+            fflush(pOutStream_l);
+            uiSleepTime = BLG_IDLE_SLEEP_MIN;
+        }
+        else if ( !fStop )
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(uiSleepTime));
+            uiSleepTime = (uiSleepTime * 2 > BLG_IDLE_SLEEP_MAX) ? BLG_IDLE_SLEEP_MAX : (uiSleepTime * 2);
+        }
+    }
+    while ( !fStop );
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Format the oldest pending Record of all Rings
+//---------------------------------------------------------------------------
+
+static  bool  BlgProcessOldestRecord (void)
+{
+
+tBlgRing*             pRing;
+tBlgRing*             pOldestRing;
+const tBlgRecHeader*  pRecHeader;
+const tBlgRecHeader*  pOldestRecHeader;
+
+
+    pOldestRing = NULL;
+    pOldestRecHeader = NULL;
+
+    for (pRing=pRingList_l.load(std::memory_order_acquire); pRing!=NULL; pRing=pRing->m_pNext)
+    {
+        if ( BlgPeekRecord(pRing, &pRecHeader) )
+        {
+            if ((pOldestRecHeader == NULL) || (pRecHeader->m_ui64TimeStamp < pOldestRecHeader->m_ui64TimeStamp))
+            {
+                pOldestRing = pRing;
+                pOldestRecHeader = pRecHeader;
+            }
+        }
+    }
+
+    if (pOldestRing == NULL)
+    {
+        return (false);
+    }
+
+    BlgFormatRecord(pOutStream_l, pOldestRecHeader);
+    pOldestRing->m_ui64Tail.store(pOldestRing->m_ui64Tail.load(std::memory_order_relaxed) + pOldestRecHeader->m_ui32RecSize,
+                                  std::memory_order_release);
+
+    return (true);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get the next pending Record of a Ring (skipping wrap markers)
+//---------------------------------------------------------------------------
+
+static  bool  BlgPeekRecord (
+    tBlgRing* pRing_p,                                  // [IN]     Ring to examine
+    const tBlgRecHeader** ppRecHeader_p)                // [OUT]    Ptr to next pending Record
+{
+
+const tBlgRecHeader*  pRecHeader;
+uint64_t  ui64Head;
+uint64_t  ui64Tail;
+size_t    nOffset;
+
+
+    ui64Tail = pRing_p->m_ui64Tail.load(std::memory_order_relaxed);
+    ui64Head = pRing_p->m_ui64Head.load(std::memory_order_acquire);
+
+    while (ui64Tail != ui64Head)
+    {
+        nOffset = (size_t)(ui64Tail & (pRing_p->m_nSize - 1));
+        pRecHeader = (const tBlgRecHeader*)(pRing_p->m_pabBuffer + nOffset);
+        if (pRecHeader->m_ui32RecSize != 0)
+        {
+            *ppRecHeader_p = pRecHeader;
+            return (true);
+        }
+
+        // wrap marker -> continue at start of buffer
+        ui64Tail += pRing_p->m_nSize - nOffset;
+        pRing_p->m_ui64Tail.store(ui64Tail, std::memory_order_release);
+    }
+
+    return (false);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Check if all Rings are drained
+//---------------------------------------------------------------------------
+
+static  bool  BlgAreRingsEmpty (void)
+{
+
+tBlgRing*  pRing;
+
+
+    for (pRing=pRingList_l.load(std::memory_order_acquire); pRing!=NULL; pRing=pRing->m_pNext)
+    {
+        if (pRing->m_ui64Tail.load(std::memory_order_acquire) != pRing->m_ui64Head.load(std::memory_order_acquire))
+        {
+            return (false);
+        }
+    }
+
+    return (true);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Release all Rings
+//---------------------------------------------------------------------------
+
+static  void  BlgFreeRings (void)
+{
+
+tBlgRing*  pRing;
+tBlgRing*  pNextRing;
+
+
+    std::lock_guard<std::mutex> Lock(RingListMutex_l);
+
+    pRing = pRingList_l.exchange(NULL);
+    while (pRing != NULL)
+    {
+        pNextRing = pRing->m_pNext;
+        ui64DroppedTotal_l += pRing->m_ui64Dropped.load();
+        free(pRing->m_pabBuffer);
+        delete pRing;
+        pRing = pNextRing;
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Format a Record with its original Format String
+//---------------------------------------------------------------------------
+//  The format string is processed conversion by conversion, each one is
+//  passed to fprintf() together with the matching argument. Length
+//  modifiers of the original format are replaced by the ones matching the
+//  stored 64-bit values, the result is the same as for the original call.
+
+static  void  BlgFormatRecord (
+    FILE* pOutStream_p,                                 // [IN]     Output Stream
+    const tBlgRecHeader* pRecHeader_p)                  // [IN]     Record to format
+{
+
+const uint8_t*  pabArg;
+const char*     pszFmt;
+const char*     pszPercent;
+char            szSpec[32];
+size_t          nSpecLen;
+unsigned int    uiArgsLeft;
+tBlgArg         Arg;
+char            chConv;
+
+
+    pabArg = (const uint8_t*)(pRecHeader_p + 1);
+    uiArgsLeft = pRecHeader_p->m_ui8ArgCnt;
+    pszFmt = pRecHeader_p->m_pszFmt;
+    if (pszFmt == NULL)
+    {
+        return;
+    }
+
+    while (*pszFmt != '\0')
+    {
+        // copy literal text up to next conversion
+        pszPercent = strchr(pszFmt, '%');
+        if (pszPercent == NULL)
+        {
+            fputs(pszFmt, pOutStream_p);
+            break;
+        }
+        if (pszPercent > pszFmt)
+        {
+            fwrite(pszFmt, 1, (size_t)(pszPercent - pszFmt), pOutStream_p);
+        }
+        pszFmt = pszPercent + 1;
+        if (*pszFmt == '%')
+        {
+            fputc('%', pOutStream_p);
+            pszFmt++;
+            continue;
+        }
+
+        // collect flags, width and precision ('*' is replaced by its argument)
+        nSpecLen = 0;
+        szSpec[nSpecLen++] = '%';
+        while ((*pszFmt != '\0') && (strchr("-+ #0123456789.*", *pszFmt) != NULL))
+        {
+            if (*pszFmt == '*')
+            {
+                if (uiArgsLeft > 0)
+                {
+                    pabArg = BlgGetArg(pabArg, &Arg);
+                    uiArgsLeft--;
+                    nSpecLen += snprintf(&szSpec[nSpecLen], sizeof(szSpec) - nSpecLen - 4, "%d", (int)BlgArgAsSigned(&Arg));
+                }
+            }
+            else if (nSpecLen < sizeof(szSpec) - 5)
+            {
+                szSpec[nSpecLen++] = *pszFmt;
+            }
+            pszFmt++;
+        }
+
+        // skip length modifiers of the original format
+        while ((*pszFmt != '\0') && (strchr("hlLqjzt", *pszFmt) != NULL))
+        {
+            pszFmt++;
+        }
+
+        chConv = *pszFmt;
+        if (chConv == '\0')
+        {
+            break;
+        }
+        pszFmt++;
+
+        if (uiArgsLeft == 0)
+        {
+            fputs("<?>", pOutStream_p);
+            continue;
+        }
+        pabArg = BlgGetArg(pabArg, &Arg);
+        uiArgsLeft--;
+
+        switch (chConv)
+        {
+            case 'd':
+            case 'i':
+            {
+                szSpec[nSpecLen++] = 'l';
+                szSpec[nSpecLen++] = 'l';
+                szSpec[nSpecLen++] = chConv;
+                szSpec[nSpecLen]   = '\0';
+                fprintf(pOutStream_p, szSpec, (long long)BlgArgAsSigned(&Arg));
+                break;
+            }
+
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+            {
+                szSpec[nSpecLen++] = 'l';
+                szSpec[nSpecLen++] = 'l';
+                szSpec[nSpecLen++] = chConv;
+                szSpec[nSpecLen]   = '\0';
+                fprintf(pOutStream_p, szSpec, (unsigned long long)BlgArgAsUnsigned(&Arg));
+                break;
+            }
+
+            case 'c':
+            {
+                szSpec[nSpecLen++] = chConv;
+                szSpec[nSpecLen]   = '\0';
+                fprintf(pOutStream_p, szSpec, (int)BlgArgAsSigned(&Arg));
+                break;
+            }
+
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+            {
+                szSpec[nSpecLen++] = chConv;
+                szSpec[nSpecLen]   = '\0';
+                fprintf(pOutStream_p, szSpec, (((Arg.m_ui8Type & 0xF0) == kBlgArgDouble) ? Arg.m_dblVal : (double)BlgArgAsSigned(&Arg)));
+                break;
+            }
+
+            case 's':
+            {
+                szSpec[nSpecLen++] = chConv;
+                szSpec[nSpecLen]   = '\0';
+                fprintf(pOutStream_p, szSpec, (((Arg.m_ui8Type & 0xF0) == kBlgArgString) ? Arg.m_pszStr : "(?)"));
+                break;
+            }
+
+            case 'p':
+            {
+                szSpec[nSpecLen++] = chConv;
+                szSpec[nSpecLen]   = '\0';
+                fprintf(pOutStream_p, szSpec, (void*)(uintptr_t)Arg.m_ui64Val);
+                break;
+            }
+
+            default:
+            {
+                // unsupported conversion (e.g. '%n') -> argument is consumed but not printed
+                break;
+            }
+        }
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Deserialize one Argument
+//---------------------------------------------------------------------------
+
+static  const uint8_t*  BlgGetArg (
+    const uint8_t* pabSrc_p,                            // [IN]     Ptr to serialized Argument
+    tBlgArg* pArg_p)                                    // [OUT]    Deserialized Argument
+{
+
+uint16_t  ui16Len;
+
+
+    pArg_p->m_ui8Type = *pabSrc_p++;
+    pArg_p->m_ui64Val = 0;
+    pArg_p->m_dblVal  = 0.0;
+    pArg_p->m_pszStr  = NULL;
+
+    switch (pArg_p->m_ui8Type & 0xF0)
+    {
+        case kBlgArgString:
+        {
+            memcpy(&ui16Len, pabSrc_p, sizeof(ui16Len));
+            pabSrc_p += sizeof(ui16Len);
+            pArg_p->m_pszStr = (const char*)pabSrc_p;
+            pabSrc_p += ui16Len + 1;
+            break;
+        }
+
+        case kBlgArgDouble:
+        {
+            memcpy(&pArg_p->m_dblVal, pabSrc_p, sizeof(double));
+            pabSrc_p += sizeof(double);
+            break;
+        }
+
+        default:
+        {
+            memcpy(&pArg_p->m_ui64Val, pabSrc_p, sizeof(uint64_t));
+            pabSrc_p += sizeof(uint64_t);
+            break;
+        }
+    }
+
+    return (pabSrc_p);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Convert Argument like printf() does for signed/unsigned Conversions
+//---------------------------------------------------------------------------
+//  Types smaller than 'int' are promoted to 'int' (value preserving), all
+//  others are reinterpreted with the size of the original type.
+
+static  int64_t  BlgArgAsSigned (
+    const tBlgArg* pArg_p)                              // [IN]     Argument
+{
+
+unsigned int  uiSize;
+unsigned int  uiShift;
+
+
+    if ((pArg_p->m_ui8Type & 0xF0) == kBlgArgDouble)
+    {
+        return ((int64_t)pArg_p->m_dblVal);
+    }
+
+    uiSize = pArg_p->m_ui8Type & 0x0F;
+    if (uiSize < sizeof(int))
+    {
+        return ((int64_t)pArg_p->m_ui64Val);
+    }
+    if (uiSize >= sizeof(int64_t))
+    {
+        return ((int64_t)pArg_p->m_ui64Val);
+    }
+
+    uiShift = 64 - (uiSize * 8);
+    return ((int64_t)(pArg_p->m_ui64Val << uiShift) >> uiShift);
+
+}
+
+static  uint64_t  BlgArgAsUnsigned (
+    const tBlgArg* pArg_p)                              // [IN]     Argument
+{
+
+unsigned int  uiSize;
+
+
+    if ((pArg_p->m_ui8Type & 0xF0) == kBlgArgDouble)
+    {
+        return ((uint64_t)pArg_p->m_dblVal);
+    }
+
+    uiSize = pArg_p->m_ui8Type & 0x0F;
+    if (uiSize < sizeof(int))
+    {
+        uiSize = sizeof(int);
+    }
+    if (uiSize >= sizeof(uint64_t))
+    {
+        return (pArg_p->m_ui64Val);
+    }
+
+    return (pArg_p->m_ui64Val & ((1ULL << (uiSize * 8)) - 1));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get monotonic TimeStamp [ns]
+//---------------------------------------------------------------------------
+
+static  uint64_t  BlgGetTimeStamp (void)
+{
+
+    return ((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+
+}
+
+
+
+// EOF
+
@@ -0,0 +1,299 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Declarations for Binary Ring Buffer Logger
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _BINARYLOGGER_H_
+#define _BINARYLOGGER_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+
+
+//---------------------------------------------------------------------------
+//  Overview
+//---------------------------------------------------------------------------
+//
+//  The hot path of a log call (BLG_LOG) does not format anything. It only
+//  stores the address of the format string (which serves as message ID)
+//  together with the raw argument values into a lock-free ring buffer that
+//  is owned by the calling thread (single producer / single consumer).
+//  A background thread collects the records of all rings in timestamp order,
+//  formats them with the original format string and writes them to the
+//  output stream. The output stream is flushed once per drained batch
+//  instead of once per line.
+//
+//  Restrictions:
+//  - The format string MUST be a string literal (or any other string with
+//    static lifetime), because only its address is stored in the ring.
+//  - String arguments ('%s') are copied into the ring (truncated to
+//    BLG_MAX_STR_LEN), all other arguments are stored by value.
+//  - If a ring is full, the record is dropped (the caller is never blocked).
+//    The number of dropped records is reported by BlgGetDropCount().
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+const  unsigned int  BLG_DEF_RING_SIZE  = (64 * 1024);  // default size of a per-thread ring [Bytes]
+const  unsigned int  BLG_MAX_STR_LEN    = 2048;         // max. length of a single string argument
+
+
+
+//---------------------------------------------------------------------------
+//  Type definitions
+//---------------------------------------------------------------------------
+
+typedef enum
+{
+    kBlgLevelError      = 0,
+    kBlgLevelWarning    = 1,
+    kBlgLevelInfo       = 2,
+    kBlgLevelDebug      = 3,
+    kBlgLevelTrace      = 4
+
+} tBlgLogLevel;
+
+
+typedef enum
+{
+    kBlgArgSInt         = 0x10,                             // low nibble = size of original type [Bytes]
+    kBlgArgUInt         = 0x20,
+    kBlgArgDouble       = 0x30,
+    kBlgArgString       = 0x40,
+    kBlgArgPointer      = 0x50
+
+} tBlgArgType;
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+extern  std::atomic<int>    iBlgLogLevel_g;             // evaluated inline by BLG_LOG() (no function call for suppressed levels)
+
+
+
+//---------------------------------------------------------------------------
+//  Macro definitions
+//---------------------------------------------------------------------------
+
+#define BLG_LOG(iLevel_p, pszFmt_p, ...)                                                    \
+    do                                                                                      \
+    {                                                                                       \
+        if ((int)(iLevel_p) <= iBlgLogLevel_g.load(std::memory_order_relaxed))              \
+        {                                                                                   \
+            BlgLogWrite((int)(iLevel_p), pszFmt_p, ##__VA_ARGS__);                          \
+        }                                                                                   \
+    } while (0)
+
+#define BLG_ERROR(pszFmt_p, ...)        BLG_LOG(kBlgLevelError,   pszFmt_p, ##__VA_ARGS__)
+#define BLG_WARNING(pszFmt_p, ...)      BLG_LOG(kBlgLevelWarning, pszFmt_p, ##__VA_ARGS__)
+#define BLG_INFO(pszFmt_p, ...)         BLG_LOG(kBlgLevelInfo,    pszFmt_p, ##__VA_ARGS__)
+#define BLG_DEBUG(pszFmt_p, ...)        BLG_LOG(kBlgLevelDebug,   pszFmt_p, ##__VA_ARGS__)
+#define BLG_TRACE(pszFmt_p, ...)        BLG_LOG(kBlgLevelTrace,   pszFmt_p, ##__VA_ARGS__)
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of public functions
+//---------------------------------------------------------------------------
+
+int   BlgInitialize (
+    unsigned int uiRingSize_p,                          // [IN]     Size of each per-thread Ring [Bytes] (0 = default)
+    int iLogLevel_p,                                    // [IN]     Initial Log Level (<tBlgLogLevel>)
+    FILE* pOutStream_p);                                // [IN]     Output Stream for formatted Records (NULL = stdout)
+
+int   BlgShutdown (void);
+
+void  BlgSetLogLevel (
+    int iLogLevel_p);                                   // [IN]     New Log Level (<tBlgLogLevel>)
+
+int   BlgGetLogLevel (void);
+
+int   BlgFlush (void);
+
+int   BlgRegisterThread (void);
+
+uint64_t  BlgGetDropCount (void);
+
+int   BlgRunBenchmark (
+    unsigned int uiIterations_p);                       // [IN]     Number of Log Calls per measured Run
+
+
+
+//---------------------------------------------------------------------------
+//  Internal functions used by the inline part of BLG_LOG()
+//---------------------------------------------------------------------------
+
+uint8_t*  BlgReserveRecord (
+    int iLevel_p,                                       // [IN]     Log Level of Record
+    const char* pszFmt_p,                               // [IN]     Format String (static lifetime!)
+    unsigned int uiArgCnt_p,                            // [IN]     Number of Arguments
+    size_t nArgsSize_p);                                // [IN]     Size of serialized Arguments [Bytes]
+
+void  BlgCommitRecord (void);
+
+
+
+//---------------------------------------------------------------------------
+//  Inline argument serialization
+//---------------------------------------------------------------------------
+
+// ---- integral types (incl. bool and enums) ----
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, size_t>::type
+BlgArgSize (T)
+{
+    return (1 + sizeof(uint64_t));
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, uint8_t*>::type
+BlgArgPut (uint8_t* pabDst_p, T Arg_p)
+{
+    uint64_t  ui64Val;
+    if ( std::is_signed<T>::value )
+    {
+        int64_t i64Val = (int64_t)Arg_p;
+        memcpy(&ui64Val, &i64Val, sizeof(ui64Val));
+        *pabDst_p++ = (uint8_t)(kBlgArgSInt | sizeof(T));
+    }
+    else
+    {
+        ui64Val = (uint64_t)Arg_p;
+        *pabDst_p++ = (uint8_t)(kBlgArgUInt | sizeof(T));
+    }
+    memcpy(pabDst_p, &ui64Val, sizeof(ui64Val));
+    return (pabDst_p + sizeof(ui64Val));
+}
+
+
+// ---- floating point types ----
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, size_t>::type
+BlgArgSize (T)
+{
+    return (1 + sizeof(double));
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, uint8_t*>::type
+BlgArgPut (uint8_t* pabDst_p, T Arg_p)
+{
+    double  dblVal = (double)Arg_p;
+    *pabDst_p++ = (uint8_t)(kBlgArgDouble | sizeof(double));
+    memcpy(pabDst_p, &dblVal, sizeof(dblVal));
+    return (pabDst_p + sizeof(dblVal));
+}
+
+
+// ---- generic pointers (char pointers are handled as strings below) ----
+template <typename T>
+inline typename std::enable_if<std::is_pointer<T>::value &&
+                               !std::is_same<typename std::remove_cv<typename std::remove_pointer<T>::type>::type, char>::value, size_t>::type
+BlgArgSize (T)
+{
+    return (1 + sizeof(uint64_t));
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_pointer<T>::value &&
+                               !std::is_same<typename std::remove_cv<typename std::remove_pointer<T>::type>::type, char>::value, uint8_t*>::type
+BlgArgPut (uint8_t* pabDst_p, T Arg_p)
+{
+    uint64_t  ui64Val = (uint64_t)(uintptr_t)Arg_p;
+    *pabDst_p++ = (uint8_t)(kBlgArgPointer | sizeof(void*));
+    memcpy(pabDst_p, &ui64Val, sizeof(ui64Val));
+    return (pabDst_p + sizeof(ui64Val));
+}
+
+
+// ---- strings (copied into the ring, incl. terminating zero) ----
+inline size_t  BlgStrLen (const char* pszArg_p)
+{
+    size_t  nLen = (pszArg_p != NULL) ? strlen(pszArg_p) : 0;
+    return ((nLen > BLG_MAX_STR_LEN) ? BLG_MAX_STR_LEN : nLen);
+}
+
+inline size_t  BlgArgSize (const char* pszArg_p)
+{
+    return (1 + sizeof(uint16_t) + BlgStrLen(pszArg_p) + 1);
+}
+
+inline uint8_t*  BlgArgPut (uint8_t* pabDst_p, const char* pszArg_p)
+{
+    uint16_t  ui16Len = (uint16_t)BlgStrLen(pszArg_p);
+    *pabDst_p++ = (uint8_t)kBlgArgString;
+    memcpy(pabDst_p, &ui16Len, sizeof(ui16Len));
+    pabDst_p += sizeof(ui16Len);
+    if (ui16Len > 0)
+    {
+        memcpy(pabDst_p, pszArg_p, ui16Len);
+        pabDst_p += ui16Len;
+    }
+    *pabDst_p++ = '\0';
+    return (pabDst_p);
+}
+
+
+// ---- variadic argument lists ----
+inline size_t  BlgArgsSize (void)
+{
+    return (0);
+}
+
+template <typename T, typename... R>
+inline size_t  BlgArgsSize (T Arg_p, R... Rest_p)
+{
+    return (BlgArgSize(Arg_p) + BlgArgsSize(Rest_p...));
+}
+
+inline uint8_t*  BlgArgsPut (uint8_t* pabDst_p)
+{
+    return (pabDst_p);
+}
+
+template <typename T, typename... R>
+inline uint8_t*  BlgArgsPut (uint8_t* pabDst_p, T Arg_p, R... Rest_p)
+{
+    return (BlgArgsPut(BlgArgPut(pabDst_p, Arg_p), Rest_p...));
+}
+
+
+// ---- log record writer (called by BLG_LOG() after level check) ----
+template <typename... A>
+inline void  BlgLogWrite (int iLevel_p, const char* pszFmt_p, A... Args_p)
+{
+    uint8_t*  pabArgs = BlgReserveRecord(iLevel_p, pszFmt_p, sizeof...(Args_p), BlgArgsSize(Args_p...));
+    if (pabArgs != NULL)
+    {
+        BlgArgsPut(pabArgs, Args_p...);
+        BlgCommitRecord();
+    }
+}
+
+
+
+#endif  // #ifndef _BINARYLOGGER_H_
+
+
+// EOF
+
@@ -0,0 +1,1284 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Implementation of Last Value Cache with HTTP/JSON Query API
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+
+#include <sys/socket.h>                                 // before <RH_RF95.h>, which defines htons() and
+#include <netinet/in.h>                                 // friends as macros
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <RH_RF95.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <time.h>
+#include <errno.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <sys/eventfd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include "LoraPacket.h"
+#include "LoraPacketSchema.h"
+#include "LoraPayloadDecoder.h"
+#include "PacketProcessing.h"
+#include "LastValueCache.h"
+#include "Trace.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+#define LVC_RECORD_WORDS        (LVC_MAX_RECORD_SIZE / sizeof(uint64_t))
+#define LVC_RECV_CHUNK_SIZE     4096
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+typedef enum
+{
+    kLvcRecData                 = 0,
+    kLvcRecBootup               = 1,
+    kLvcNumRecs
+
+} tLvcRecType;
+
+
+//  Cache entry of one DevID. Written by the main loop only, read by the
+//  server thread under the sequence lock <m_ui32Sequence> (odd while an
+//  update is in progress). All members are atomics, so the copy of a
+//  reader overlapping with an update is defined and detected by the
+//  changed sequence.
+typedef struct
+{
+    std::atomic<uint32_t>   m_ui32Sequence;
+    std::atomic<uint32_t>   m_aui32RecLen[kLvcNumRecs];                     // 0 = not received yet
+    std::atomic<uint64_t>   m_aaui64Record[kLvcNumRecs][LVC_RECORD_WORDS];
+    int64_t                 m_i64DataTime;                                  // main loop only
+
+} tLvcDevice;
+
+
+//  Consistent copy of a cache entry (server thread)
+typedef struct
+{
+    uint32_t                m_ui32Version;
+    uint32_t                m_aui32RecLen[kLvcNumRecs];
+    uint64_t                m_aaui64Record[kLvcNumRecs][LVC_RECORD_WORDS];
+
+} tLvcSnapshot;
+
+
+typedef struct
+{
+    int                     m_iSocket;
+    std::string             m_strInput;
+    std::string             m_strOutput;
+    size_t                  m_nOutputPos;
+    bool                    m_fCloseAfterOutput;
+    time_t                  m_tmLastActivity;
+
+} tLvcConnection;
+
+
+typedef struct
+{
+    const char*             m_pszReason;
+    bool                    m_fHead;
+    bool                    m_fClose;
+    const char*             m_pszIfNoneMatch;
+    size_t                  m_nIfNoneMatchLen;
+
+} tLvcRequest;
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+static  tLvcDevice              aDevice_l[LVC_MAX_DEVICES];
+static  std::atomic<uint64_t>   ui64Generation_l (0);           // incremented with every update
+static  uint32_t                ui32Epoch_l         = 0;        // start time of server, part of ETag
+static  int                     iListenSocket_l     = -1;
+static  int                     iStopEventFd_l      = -1;
+static  uint16_t                ui16Port_l          = 0;
+static  std::thread             ServerThread_l;
+
+//  Body of '/devices' (server thread only)
+static  std::string             strDevicesBody_l;
+static  uint64_t                ui64DevicesBodyGen_l = UINT64_MAX;
+
+//  Statistics (main loop: updates, server thread: connections and requests)
+static  uint64_t                ui64Updates_l       = 0;
+static  uint64_t                ui64Ignored_l       = 0;
+static  uint                    uiOversized_l       = 0;
+static  uint                    uiDevices_l         = 0;
+static  std::atomic<uint64_t>   ui64Accepted_l (0);
+static  std::atomic<uint>       uiRejected_l (0);
+static  std::atomic<uint>       uiConnections_l (0);
+static  std::atomic<uint>       uiMaxConnections_l (0);
+static  std::atomic<uint64_t>   ui64Requests_l (0);
+static  std::atomic<uint64_t>   ui64Status200_l (0);
+static  std::atomic<uint64_t>   ui64Status304_l (0);
+static  std::atomic<uint64_t>   ui64StatusError_l (0);
+static  std::atomic<uint64_t>   ui64Renders_l (0);
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  void  LvcServerThread (void);
+
+static  void  LvcAcceptConnections (
+    std::vector<tLvcConnection>* pvecConnections_p);
+
+static  bool  LvcReceive (
+    tLvcConnection* pConnection_p);
+
+static  bool  LvcSend (
+    tLvcConnection* pConnection_p);
+
+static  void  LvcHandleRequest (
+    tLvcConnection* pConnection_p,
+    const char* pszHeader_p,
+    size_t nHeaderLen_p);
+
+static  void  LvcRespond (
+    tLvcConnection* pConnection_p,
+    const tLvcRequest* pRequest_p,
+    const char* pszPath_p);
+
+static  void  LvcAppendResponse (
+    tLvcConnection* pConnection_p,
+    const tLvcRequest* pRequest_p,
+    uint uiStatus_p,
+    const char* pszETag_p,
+    const std::string* pstrBody_p);
+
+static  uint32_t  LvcReadDevice (
+    uint uiDevID_p,
+    tLvcSnapshot* pSnapshot_p);
+
+static  uint32_t  LvcGetDeviceVersion (
+    uint uiDevID_p);
+
+static  void  LvcAppendDevice (
+    std::string* pstrBody_p,
+    uint uiDevID_p,
+    const tLvcSnapshot* pSnapshot_p,
+    const char* pszIndent_p);
+
+static  void  LvcAppendRecord (
+    std::string* pstrBody_p,
+    const tLvcSnapshot* pSnapshot_p,
+    tLvcRecType RecType_p,
+    const char* pszIndent_p);
+
+static  bool  LvcETagMatches (
+    const tLvcRequest* pRequest_p,
+    const char* pszETag_p);
+
+static  const char*  LvcFindHeader (
+    const char* pszHeader_p,
+    size_t nHeaderLen_p,
+    const char* pszName_p,
+    size_t* pnValueLen_p);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Open Cache and start HTTP Server
+//---------------------------------------------------------------------------
+
+int  LvcOpen (
+    const char* pszBindAddr_p,                          // [IN]     IPv4 Address to listen on (NULL = LVC_DEF_BIND_ADDR)
+    uint16_t ui16Port_p)                                // [IN]     TCP Port (0 = any free port, see LvcGetPort())
+{
+
+struct sockaddr_in  SockAddr;
+socklen_t           SockAddrLen;
+uint                uiDevID;
+uint                uiRec;
+uint                uiWord;
+int                 iOptVal;
+
+
+    if (iListenSocket_l >= 0)
+    {
+        return (-1);
+    }
+
+    for (uiDevID=0; uiDevID<LVC_MAX_DEVICES; uiDevID++)
+    {
+        aDevice_l[uiDevID].m_ui32Sequence.store(0, std::memory_order_relaxed);
+        for (uiRec=0; uiRec<kLvcNumRecs; uiRec++)
+        {
+            aDevice_l[uiDevID].m_aui32RecLen[uiRec].store(0, std::memory_order_relaxed);
+            for (uiWord=0; uiWord<LVC_RECORD_WORDS; uiWord++)
+            {
+                aDevice_l[uiDevID].m_aaui64Record[uiRec][uiWord].store(0, std::memory_order_relaxed);
+            }
+        }
+        aDevice_l[uiDevID].m_i64DataTime = INT64_MIN;
+    }
+    ui64Generation_l     = 0;
+    ui32Epoch_l          = (uint32_t)time(NULL);
+    strDevicesBody_l.clear();
+    ui64DevicesBodyGen_l = UINT64_MAX;
+
+    ui64Updates_l      = 0;
+    ui64Ignored_l      = 0;
+    uiOversized_l      = 0;
+    uiDevices_l        = 0;
+    ui64Accepted_l     = 0;
+    uiRejected_l       = 0;
+    uiConnections_l    = 0;
+    uiMaxConnections_l = 0;
+    ui64Requests_l     = 0;
+    ui64Status200_l    = 0;
+    ui64Status304_l    = 0;
+    ui64StatusError_l  = 0;
+    ui64Renders_l      = 0;
+
+    memset(&SockAddr, 0, sizeof(SockAddr));
+    SockAddr.sin_family = AF_INET;
+    SockAddr.sin_port   = htons(ui16Port_p);
+    if (inet_pton(AF_INET, ((pszBindAddr_p != NULL) ? pszBindAddr_p : LVC_DEF_BIND_ADDR), &SockAddr.sin_addr) != 1)
+    {
+        TRACE0("ERROR: invalid bind address!\n");
+        return (-2);
+    }
+
+    iListenSocket_l = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (iListenSocket_l < 0)
+    {
+        TRACE0("ERROR: socket() failed!\n");
+        return (-3);
+    }
+    iOptVal = 1;
+    setsockopt(iListenSocket_l, SOL_SOCKET, SO_REUSEADDR, &iOptVal, sizeof(iOptVal));
+    if ( (bind(iListenSocket_l, (struct sockaddr*)&SockAddr, sizeof(SockAddr)) != 0) ||
+         (listen(iListenSocket_l, SOMAXCONN) != 0) )
+    {
+        TRACE0("ERROR: bind()/listen() failed!\n");
+        close(iListenSocket_l);
+        iListenSocket_l = -1;
+        return (-4);
+    }
+    SockAddrLen = sizeof(SockAddr);
+    getsockname(iListenSocket_l, (struct sockaddr*)&SockAddr, &SockAddrLen);
+    ui16Port_l = ntohs(SockAddr.sin_port);
+
+    iStopEventFd_l = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (iStopEventFd_l < 0)
+    {
+        TRACE0("ERROR: eventfd() failed!\n");
+        close(iListenSocket_l);
+        iListenSocket_l = -1;
+        return (-5);
+    }
+
+    ServerThread_l = std::thread(LvcServerThread);
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Stop HTTP Server and close Cache
+//---------------------------------------------------------------------------
+
+int  LvcClose (void)
+{
+
+uint64_t  ui64Event;
+
+
+    if (iListenSocket_l < 0)
+    {
+        return (-1);
+    }
+
+    ui64Event = 1;
+    if (write(iStopEventFd_l, &ui64Event, sizeof(ui64Event)) != sizeof(ui64Event))
+    {
+        TRACE0("ERROR: can't signal server thread!\n");
+    }
+    if ( ServerThread_l.joinable() )
+    {
+        ServerThread_l.join();
+    }
+
+    close(iStopEventFd_l);
+    iStopEventFd_l = -1;
+    close(iListenSocket_l);
+    iListenSocket_l = -1;
+    ui16Port_l = 0;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Update Cache with Json Message
+//---------------------------------------------------------------------------
+//  Called by the main loop only (single writer). A Data Record replaces the
+//  cached one only if it is not older, so the Gen1/Gen2 copies of a packet
+//  never hide the newest values.
+
+int  LvcUpdate (
+    const tJsonMessage* pJsonMessage_p)                 // [IN]     Json Message (Bootup or Data Record)
+{
+
+tLvcDevice*  pDevice;
+tLvcRecType  RecType;
+uint64_t     ui64Word;
+uint32_t     ui32Sequence;
+size_t       nRecLen;
+size_t       nOffs;
+size_t       nChunk;
+uint         uiWord;
+
+
+    if ((pJsonMessage_p == NULL) || (iListenSocket_l < 0))
+    {
+        return (-1);
+    }
+
+    pDevice = &aDevice_l[pJsonMessage_p->m_ui8DevID];
+    if (pJsonMessage_p->m_PacketType == kLoraPacketBootup)
+    {
+        RecType = kLvcRecBootup;
+    }
+    else
+    {
+        RecType = kLvcRecData;
+        if ((int64_t)pJsonMessage_p->m_tmTimeStamp < pDevice->m_i64DataTime)
+        {
+            ui64Ignored_l++;
+            return (0);
+        }
+    }
+
+    nRecLen = pJsonMessage_p->m_strJsonRecord.length();
+    if ((nRecLen == 0) || (nRecLen > LVC_MAX_RECORD_SIZE))
+    {
+        uiOversized_l++;
+        return (-2);
+    }
+    if ((pDevice->m_aui32RecLen[kLvcRecData].load(std::memory_order_relaxed) == 0) &&
+        (pDevice->m_aui32RecLen[kLvcRecBootup].load(std::memory_order_relaxed) == 0))
+    {
+        uiDevices_l++;
+    }
+
+    // sequence lock: odd while the record is written
+    ui32Sequence = pDevice->m_ui32Sequence.load(std::memory_order_relaxed);
+    pDevice->m_ui32Sequence.store(ui32Sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (uiWord=0, nOffs=0; nOffs<nRecLen; uiWord++, nOffs+=sizeof(uint64_t))
+    {
+        ui64Word = 0;
+        nChunk = std::min(sizeof(uint64_t), nRecLen - nOffs);
+        memcpy(&ui64Word, pJsonMessage_p->m_strJsonRecord.data() + nOffs, nChunk);
+        pDevice->m_aaui64Record[RecType][uiWord].store(ui64Word, std::memory_order_relaxed);
+    }
+    pDevice->m_aui32RecLen[RecType].store((uint32_t)nRecLen, std::memory_order_relaxed);
+
+    pDevice->m_ui32Sequence.store(ui32Sequence + 2, std::memory_order_release);
+    ui64Generation_l.fetch_add(1, std::memory_order_release);
+
+    if (RecType == kLvcRecData)
+    {
+        pDevice->m_i64DataTime = (int64_t)pJsonMessage_p->m_tmTimeStamp;
+    }
+    ui64Updates_l++;
+
+    return (1);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get TCP Port of HTTP Server
+//---------------------------------------------------------------------------
+
+uint16_t  LvcGetPort (void)
+{
+
+    return (ui16Port_l);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Statistics
+//---------------------------------------------------------------------------
+
+void  LvcGetStatistics (
+    tLvcStatistics* pStatistics_p)                      // [OUT]    Ptr to Statistics
+{
+
+    if (pStatistics_p == NULL)
+    {
+        return;
+    }
+
+    memset(pStatistics_p, 0, sizeof(tLvcStatistics));
+    pStatistics_p->m_ui64Updates      = ui64Updates_l;
+    pStatistics_p->m_ui64Ignored      = ui64Ignored_l;
+    pStatistics_p->m_uiOversized      = uiOversized_l;
+    pStatistics_p->m_uiDevices        = uiDevices_l;
+    pStatistics_p->m_ui64Accepted     = ui64Accepted_l.load();
+    pStatistics_p->m_uiRejected       = uiRejected_l.load();
+    pStatistics_p->m_uiConnections    = uiConnections_l.load();
+    pStatistics_p->m_uiMaxConnections = uiMaxConnections_l.load();
+    pStatistics_p->m_ui64Requests     = ui64Requests_l.load();
+    pStatistics_p->m_ui64Status200    = ui64Status200_l.load();
+    pStatistics_p->m_ui64Status304    = ui64Status304_l.load();
+    pStatistics_p->m_ui64StatusError  = ui64StatusError_l.load();
+    pStatistics_p->m_ui64Renders      = ui64Renders_l.load();
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Print Statistics
+//---------------------------------------------------------------------------
+
+void  LvcPrintStatistics (void)
+{
+
+tLvcStatistics  Statistics;
+
+
+    LvcGetStatistics(&Statistics);
+
+    printf("Last Value Cache:\n");
+    printf("  Devices           = %u\n", Statistics.m_uiDevices);
+    printf("  Records cached    = %llu (older ignored: %llu, oversized: %u)\n",
+           (unsigned long long)Statistics.m_ui64Updates, (unsigned long long)Statistics.m_ui64Ignored, Statistics.m_uiOversized);
+    printf("  Connections       = %u open, %u max (accepted: %llu, rejected: %u)\n",
+           Statistics.m_uiConnections, Statistics.m_uiMaxConnections,
+           (unsigned long long)Statistics.m_ui64Accepted, Statistics.m_uiRejected);
+    printf("  Requests          = %llu (200: %llu, 304: %llu, 4xx: %llu)\n",
+           (unsigned long long)Statistics.m_ui64Requests, (unsigned long long)Statistics.m_ui64Status200,
+           (unsigned long long)Statistics.m_ui64Status304, (unsigned long long)Statistics.m_ui64StatusError);
+
+    return;
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  HTTP Server Thread
+//---------------------------------------------------------------------------
+//  All sockets are non-blocking. A connection with pending output is only
+//  polled for POLLOUT, so a client not reading its responses can't make the
+//  server buffer more than one batch of (pipelined) requests.
+
+static  void  LvcServerThread (void)
+{
+
+std::vector<tLvcConnection>  vecConnections;
+std::vector<struct pollfd>   vecPollFds;
+tLvcConnection*              pConnection;
+time_t                       tmNow;
+size_t                       nIdx;
+bool                         fKeep;
+int                          iRes;
+
+
+    for (;;)
+    {
+        vecPollFds.resize(2 + vecConnections.size());
+        vecPollFds[0].fd     = iStopEventFd_l;
+        vecPollFds[0].events = POLLIN;
+        vecPollFds[1].fd     = iListenSocket_l;
+        vecPollFds[1].events = (vecConnections.size() < LVC_MAX_CONNECTIONS) ? POLLIN : 0;
+        for (nIdx=0; nIdx<vecConnections.size(); nIdx++)
+        {
+            vecPollFds[2+nIdx].fd     = vecConnections[nIdx].m_iSocket;
+            vecPollFds[2+nIdx].events = (vecConnections[nIdx].m_strOutput.empty()) ? POLLIN : POLLOUT;
+        }
+        for (nIdx=0; nIdx<vecPollFds.size(); nIdx++)
+        {
+            vecPollFds[nIdx].revents = 0;
+        }
+
+        iRes = poll(vecPollFds.data(), vecPollFds.size(), 1000);
+        if ((iRes < 0) && (errno != EINTR))
+        {
+            TRACE0("ERROR: poll() failed!\n");
+            break;
+        }
+        if (vecPollFds[0].revents & POLLIN)
+        {
+            break;
+        }
+
+        // serve existing connections (in reverse order for removal)
+        tmNow = time(NULL);
+        for (nIdx=vecConnections.size(); nIdx>0; nIdx--)
+        {
+            pConnection = &vecConnections[nIdx-1];
+            fKeep = true;
+            if (vecPollFds[2+nIdx-1].revents & (POLLERR | POLLHUP | POLLNVAL))
+            {
+                fKeep = (vecPollFds[2+nIdx-1].revents & POLLIN) ? LvcReceive(pConnection) : false;
+            }
+            else if (vecPollFds[2+nIdx-1].revents & POLLIN)
+            {
+                fKeep = LvcReceive(pConnection);
+            }
+            else if (vecPollFds[2+nIdx-1].revents & POLLOUT)
+            {
+                fKeep = LvcSend(pConnection);
+            }
+            else if ((tmNow - pConnection->m_tmLastActivity) > (time_t)LVC_IDLE_TIMEOUT)
+            {
+                fKeep = false;
+            }
+            if ( !fKeep )
+            {
+                close(pConnection->m_iSocket);
+                vecConnections[nIdx-1] = std::move(vecConnections.back());
+                vecConnections.pop_back();
+            }
+        }
+
+        if (vecPollFds[1].revents & POLLIN)
+        {
+            LvcAcceptConnections(&vecConnections);
+        }
+        uiConnections_l.store((uint)vecConnections.size(), std::memory_order_relaxed);
+    }
+
+    for (nIdx=0; nIdx<vecConnections.size(); nIdx++)
+    {
+        close(vecConnections[nIdx].m_iSocket);
+    }
+    uiConnections_l = 0;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Accept new Connections
+//---------------------------------------------------------------------------
+
+static  void  LvcAcceptConnections (
+    std::vector<tLvcConnection>* pvecConnections_p)
+{
+
+tLvcConnection  Connection;
+int             iSocket;
+int             iOptVal;
+
+
+    for (;;)
+    {
+        iSocket = accept4(iListenSocket_l, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (iSocket < 0)
+        {
+            return;
+        }
+        if (pvecConnections_p->size() >= LVC_MAX_CONNECTIONS)
+        {
+            close(iSocket);
+            uiRejected_l++;
+            continue;
+        }
+
+        iOptVal = 1;
+        setsockopt(iSocket, IPPROTO_TCP, TCP_NODELAY, &iOptVal, sizeof(iOptVal));
+
+        Connection.m_iSocket           = iSocket;
+        Connection.m_nOutputPos        = 0;
+        Connection.m_fCloseAfterOutput = false;
+        Connection.m_tmLastActivity    = time(NULL);
+        pvecConnections_p->push_back(Connection);
+
+        ui64Accepted_l++;
+        if (pvecConnections_p->size() > uiMaxConnections_l.load(std::memory_order_relaxed))
+        {
+            uiMaxConnections_l.store((uint)pvecConnections_p->size(), std::memory_order_relaxed);
+        }
+    }
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Receive Requests of Connection
+//---------------------------------------------------------------------------
+//  Returns false if the connection is to be closed.
+
+static  bool  LvcReceive (
+    tLvcConnection* pConnection_p)
+{
+
+static const tLvcRequest  RequestTooLarge = { "431 Request Header Fields Too Large", false, true, NULL, 0 };
+char     abBuffer[LVC_RECV_CHUNK_SIZE];
+ssize_t  nRecvLen;
+size_t   nHeaderEnd;
+
+
+    nRecvLen = recv(pConnection_p->m_iSocket, abBuffer, sizeof(abBuffer), 0);
+    if (nRecvLen <= 0)
+    {
+        return ((nRecvLen < 0) && ((errno == EAGAIN) || (errno == EINTR)));
+    }
+    pConnection_p->m_tmLastActivity = time(NULL);
+    pConnection_p->m_strInput.append(abBuffer, (size_t)nRecvLen);
+
+    // process all complete requests (pipelining)
+    while ( !pConnection_p->m_fCloseAfterOutput )
+    {
+        nHeaderEnd = pConnection_p->m_strInput.find("\r\n\r\n");
+        if (nHeaderEnd == std::string::npos)
+        {
+            if (pConnection_p->m_strInput.length() > LVC_MAX_REQUEST_SIZE)
+            {
+                LvcAppendResponse(pConnection_p, &RequestTooLarge, 431, NULL, NULL);
+            }
+            break;
+        }
+        LvcHandleRequest(pConnection_p, pConnection_p->m_strInput.c_str(), nHeaderEnd + 2);
+        pConnection_p->m_strInput.erase(0, nHeaderEnd + 4);
+    }
+
+    if ( pConnection_p->m_strOutput.empty() )
+    {
+        return (true);
+    }
+
+    return (LvcSend(pConnection_p));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Send pending Output of Connection
+//---------------------------------------------------------------------------
+//  Returns false if the connection is to be closed.
+
+static  bool  LvcSend (
+    tLvcConnection* pConnection_p)
+{
+
+ssize_t  nSentLen;
+
+
+    while (pConnection_p->m_nOutputPos < pConnection_p->m_strOutput.length())
+    {
+        nSentLen = send(pConnection_p->m_iSocket, pConnection_p->m_strOutput.data() + pConnection_p->m_nOutputPos,
+                        pConnection_p->m_strOutput.length() - pConnection_p->m_nOutputPos, MSG_NOSIGNAL);
+        if (nSentLen < 0)
+        {
+            return ((errno == EAGAIN) || (errno == EINTR));
+        }
+        pConnection_p->m_nOutputPos += (size_t)nSentLen;
+        pConnection_p->m_tmLastActivity = time(NULL);
+    }
+
+    pConnection_p->m_strOutput.clear();
+    pConnection_p->m_nOutputPos = 0;
+
+    return ( !pConnection_p->m_fCloseAfterOutput );
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Handle one Request
+//---------------------------------------------------------------------------
+
+static  void  LvcHandleRequest (
+    tLvcConnection* pConnection_p,
+    const char* pszHeader_p,                            // request line and header lines, each ending with CRLF
+    size_t nHeaderLen_p)
+{
+
+tLvcRequest  Request;
+std::string  strPath;
+const char*  pszLineEnd;
+const char*  pszPath;
+const char*  pszVersion;
+const char*  pszValue;
+size_t       nValueLen;
+
+
+    ui64Requests_l.fetch_add(1, std::memory_order_relaxed);
+
+    memset(&Request, 0, sizeof(Request));
+    pszLineEnd = (const char*)memchr(pszHeader_p, '\r', nHeaderLen_p);
+    pszPath    = (const char*)memchr(pszHeader_p, ' ', (size_t)(pszLineEnd - pszHeader_p));
+    pszVersion = (pszPath != NULL) ? (const char*)memchr(pszPath + 1, ' ', (size_t)(pszLineEnd - pszPath - 1)) : NULL;
+    if ((pszPath == NULL) || (pszVersion == NULL) || strncmp(pszVersion + 1, "HTTP/1.", sizeof("HTTP/1.")-1))
+    {
+        Request.m_pszReason = "400 Bad Request";
+        Request.m_fClose    = true;
+        LvcAppendResponse(pConnection_p, &Request, 400, NULL, NULL);
+        return;
+    }
+
+    // HTTP/1.0 closes after the response unless keep-alive is requested
+    Request.m_fClose = (pszVersion[sizeof(" HTTP/1.")-1] == '0');
+    pszValue = LvcFindHeader(pszLineEnd + 2, nHeaderLen_p - (size_t)(pszLineEnd + 2 - pszHeader_p), "Connection", &nValueLen);
+    if (pszValue != NULL)
+    {
+        if ((nValueLen == 5) && !strncasecmp(pszValue, "close", 5))
+        {
+            Request.m_fClose = true;
+        }
+        else if ((nValueLen == 10) && !strncasecmp(pszValue, "keep-alive", 10))
+        {
+            Request.m_fClose = false;
+        }
+    }
+    Request.m_pszIfNoneMatch = LvcFindHeader(pszLineEnd + 2, nHeaderLen_p - (size_t)(pszLineEnd + 2 - pszHeader_p),
+                                             "If-None-Match", &Request.m_nIfNoneMatchLen);
+
+    if (((pszPath - pszHeader_p) == 3) && !strncmp(pszHeader_p, "GET", 3))
+    {
+        Request.m_fHead = false;
+    }
+    else if (((pszPath - pszHeader_p) == 4) && !strncmp(pszHeader_p, "HEAD", 4))
+    {
+        Request.m_fHead = true;
+    }
+    else
+    {
+        Request.m_pszReason = "405 Method Not Allowed";
+        LvcAppendResponse(pConnection_p, &Request, 405, NULL, NULL);
+        return;
+    }
+
+    // path without query
+    strPath.assign(pszPath + 1, (size_t)(pszVersion - pszPath - 1));
+    strPath = strPath.substr(0, strPath.find('?'));
+    LvcRespond(pConnection_p, &Request, strPath.c_str());
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Build Response for Path
+//---------------------------------------------------------------------------
+
+static  void  LvcRespond (
+    tLvcConnection* pConnection_p,
+    const tLvcRequest* pRequest_p,
+    const char* pszPath_p)
+{
+
+tLvcSnapshot  Snapshot;
+tLvcRequest   Request;
+std::string   strBody;
+char          szETag[48];
+const char*   pszSubPath;
+char*         pszNumEnd;
+uint64_t      ui64Generation;
+uint32_t      ui32Version;
+uint          uiDevID;
+tLvcRecType   RecType;
+
+
+    Request = *pRequest_p;
+
+    // all DevIDs: body is only built again after an update
+    if ( !strcmp(pszPath_p, "/devices") || !strcmp(pszPath_p, "/devices/") || !strcmp(pszPath_p, "/") )
+    {
+        ui64Generation = ui64Generation_l.load(std::memory_order_acquire);
+        snprintf(szETag, sizeof(szETag), "\"%08x-%llx\"", ui32Epoch_l, (unsigned long long)ui64Generation);
+        if ( LvcETagMatches(&Request, szETag) )
+        {
+            Request.m_pszReason = "304 Not Modified";
+            LvcAppendResponse(pConnection_p, &Request, 304, szETag, NULL);
+            return;
+        }
+        if (ui64Generation != ui64DevicesBodyGen_l)
+        {
+            strDevicesBody_l = "{\n  \"Devices\": [";
+            pszSubPath = "\n";
+            for (uiDevID=0; uiDevID<LVC_MAX_DEVICES; uiDevID++)
+            {
+                LvcReadDevice(uiDevID, &Snapshot);
+                if ((Snapshot.m_aui32RecLen[kLvcRecData] == 0) && (Snapshot.m_aui32RecLen[kLvcRecBootup] == 0))
+                {
+                    continue;
+                }
+                strDevicesBody_l += pszSubPath;
+                LvcAppendDevice(&strDevicesBody_l, uiDevID, &Snapshot, "    ");
+                pszSubPath = ",\n";
+            }
+            strDevicesBody_l += "\n  ]\n}\n";
+            ui64DevicesBodyGen_l = ui64Generation;
+            ui64Renders_l.fetch_add(1, std::memory_order_relaxed);
+        }
+        Request.m_pszReason = "200 OK";
+        LvcAppendResponse(pConnection_p, &Request, 200, szETag, &strDevicesBody_l);
+        return;
+    }
+
+    // single DevID: '/devices/<dev_id>[/data|/bootup]'
+    uiDevID = LVC_MAX_DEVICES;
+    pszSubPath = "";
+    if ( !strncmp(pszPath_p, "/devices/", sizeof("/devices/")-1) && isdigit((unsigned char)pszPath_p[sizeof("/devices/")-1]) )
+    {
+        uiDevID = (uint)strtoul(pszPath_p + sizeof("/devices/")-1, &pszNumEnd, 10);
+        pszSubPath = pszNumEnd;
+    }
+    RecType = kLvcNumRecs;
+    if ( !strcmp(pszSubPath, "/data") )
+    {
+        RecType = kLvcRecData;
+    }
+    else if ( !strcmp(pszSubPath, "/bootup") )
+    {
+        RecType = kLvcRecBootup;
+    }
+    else if ((*pszSubPath != '\0') && strcmp(pszSubPath, "/"))
+    {
+        uiDevID = LVC_MAX_DEVICES;
+    }
+
+    if (uiDevID < LVC_MAX_DEVICES)
+    {
+        // ETag check without copying the records
+        ui32Version = LvcGetDeviceVersion(uiDevID);
+        snprintf(szETag, sizeof(szETag), "\"%08x-d%x\"", ui32Epoch_l, ui32Version);
+        if ( (ui32Version > 0) && LvcETagMatches(&Request, szETag) )
+        {
+            Request.m_pszReason = "304 Not Modified";
+            LvcAppendResponse(pConnection_p, &Request, 304, szETag, NULL);
+            return;
+        }
+
+        ui32Version = LvcReadDevice(uiDevID, &Snapshot);
+        snprintf(szETag, sizeof(szETag), "\"%08x-d%x\"", ui32Epoch_l, ui32Version);
+        if (RecType == kLvcNumRecs)
+        {
+            if ((Snapshot.m_aui32RecLen[kLvcRecData] > 0) || (Snapshot.m_aui32RecLen[kLvcRecBootup] > 0))
+            {
+                LvcAppendDevice(&strBody, uiDevID, &Snapshot, "");
+                strBody += "\n";
+                Request.m_pszReason = "200 OK";
+                LvcAppendResponse(pConnection_p, &Request, 200, szETag, &strBody);
+                return;
+            }
+        }
+        else if (Snapshot.m_aui32RecLen[RecType] > 0)
+        {
+            LvcAppendRecord(&strBody, &Snapshot, RecType, "");
+            strBody += "\n";
+            Request.m_pszReason = "200 OK";
+            LvcAppendResponse(pConnection_p, &Request, 200, szETag, &strBody);
+            return;
+        }
+    }
+
+    Request.m_pszReason = "404 Not Found";
+    LvcAppendResponse(pConnection_p, &Request, 404, NULL, NULL);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Append Response to Output of Connection
+//---------------------------------------------------------------------------
+
+static  void  LvcAppendResponse (
+    tLvcConnection* pConnection_p,
+    const tLvcRequest* pRequest_p,
+    uint uiStatus_p,
+    const char* pszETag_p,                              // NULL = no ETag
+    const std::string* pstrBody_p)                      // NULL = no body
+{
+
+char  szHeader[320];
+int   iLen;
+
+
+    iLen = snprintf(szHeader, sizeof(szHeader), "HTTP/1.1 %s\r\n", pRequest_p->m_pszReason);
+    if (pszETag_p != NULL)
+    {
+        iLen += snprintf(szHeader + iLen, sizeof(szHeader) - iLen, "ETag: %s\r\nCache-Control: no-cache\r\n", pszETag_p);
+    }
+    if (uiStatus_p == 405)
+    {
+        iLen += snprintf(szHeader + iLen, sizeof(szHeader) - iLen, "Allow: GET, HEAD\r\n");
+    }
+    if (pstrBody_p != NULL)
+    {
+        iLen += snprintf(szHeader + iLen, sizeof(szHeader) - iLen, "Content-Type: application/json\r\nContent-Length: %u\r\n",
+                         (uint)pstrBody_p->length());
+    }
+    else if (uiStatus_p != 304)
+    {
+        iLen += snprintf(szHeader + iLen, sizeof(szHeader) - iLen, "Content-Length: 0\r\n");
+    }
+    if ( pRequest_p->m_fClose )
+    {
+        iLen += snprintf(szHeader + iLen, sizeof(szHeader) - iLen, "Connection: close\r\n");
+    }
+    iLen += snprintf(szHeader + iLen, sizeof(szHeader) - iLen, "\r\n");
+
+    pConnection_p->m_strOutput.append(szHeader, (size_t)iLen);
+    if ((pstrBody_p != NULL) && !pRequest_p->m_fHead)
+    {
+        pConnection_p->m_strOutput += *pstrBody_p;
+    }
+    pConnection_p->m_fCloseAfterOutput = pRequest_p->m_fClose;
+
+    if (uiStatus_p == 200)
+    {
+        ui64Status200_l.fetch_add(1, std::memory_order_relaxed);
+    }
+    else if (uiStatus_p == 304)
+    {
+        ui64Status304_l.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        ui64StatusError_l.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Read consistent Copy of Cache Entry (sequence lock)
+//---------------------------------------------------------------------------
+//  Returns the version of the entry (number of updates, 0 = empty).
+
+static  uint32_t  LvcReadDevice (
+    uint uiDevID_p,
+    tLvcSnapshot* pSnapshot_p)
+{
+
+const tLvcDevice*  pDevice;
+uint32_t           ui32SeqStart;
+uint32_t           ui32SeqEnd;
+uint               uiRec;
+uint               uiWords;
+uint               uiWord;
+
+
+    pDevice = &aDevice_l[uiDevID_p];
+    do
+    {
+        ui32SeqStart = pDevice->m_ui32Sequence.load(std::memory_order_acquire);
+        while (ui32SeqStart & 1)
+        {
+            // update in progress (only a few hundred bytes are copied)
+            std::this_thread::yield();
+            ui32SeqStart = pDevice->m_ui32Sequence.load(std::memory_order_acquire);
+        }
+
+        for (uiRec=0; uiRec<kLvcNumRecs; uiRec++)
+        {
+            pSnapshot_p->m_aui32RecLen[uiRec] = pDevice->m_aui32RecLen[uiRec].load(std::memory_order_relaxed);
+            if (pSnapshot_p->m_aui32RecLen[uiRec] > LVC_MAX_RECORD_SIZE)
+            {
+                pSnapshot_p->m_aui32RecLen[uiRec] = 0;      // torn read, repeated below
+            }
+            uiWords = (uint)((pSnapshot_p->m_aui32RecLen[uiRec] + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+            for (uiWord=0; uiWord<uiWords; uiWord++)
+            {
+                pSnapshot_p->m_aaui64Record[uiRec][uiWord] = pDevice->m_aaui64Record[uiRec][uiWord].load(std::memory_order_relaxed);
+            }
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        ui32SeqEnd = pDevice->m_ui32Sequence.load(std::memory_order_relaxed);
+    }
+    while (ui32SeqStart != ui32SeqEnd);
+
+    pSnapshot_p->m_ui32Version = ui32SeqStart / 2;
+
+    return (pSnapshot_p->m_ui32Version);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Version of Cache Entry (without copy)
+//---------------------------------------------------------------------------
+//  While an update is in progress the version after the update is returned,
+//  so a client is never told that its older copy is still current.
+
+static  uint32_t  LvcGetDeviceVersion (
+    uint uiDevID_p)
+{
+
+uint32_t  ui32Sequence;
+
+
+    ui32Sequence = aDevice_l[uiDevID_p].m_ui32Sequence.load(std::memory_order_acquire);
+
+    return ((ui32Sequence + 1) / 2);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Append Json Object of one DevID
+//---------------------------------------------------------------------------
+
+static  void  LvcAppendDevice (
+    std::string* pstrBody_p,
+    uint uiDevID_p,
+    const tLvcSnapshot* pSnapshot_p,
+    const char* pszIndent_p)
+{
+
+std::string  strIndent;
+char         szItem[64];
+
+
+    strIndent = std::string(pszIndent_p) + "  ";
+
+    snprintf(szItem, sizeof(szItem), "{\n%s\"DevID\": %u,\n", strIndent.c_str(), uiDevID_p);
+    *pstrBody_p += pszIndent_p;
+    *pstrBody_p += szItem;
+    *pstrBody_p += strIndent + "\"Data\": ";
+    LvcAppendRecord(pstrBody_p, pSnapshot_p, kLvcRecData, strIndent.c_str());
+    *pstrBody_p += ",\n" + strIndent + "\"Bootup\": ";
+    LvcAppendRecord(pstrBody_p, pSnapshot_p, kLvcRecBootup, strIndent.c_str());
+    *pstrBody_p += "\n";
+    *pstrBody_p += pszIndent_p;
+    *pstrBody_p += "}";
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Append cached Json Record (indented, without trailing line break)
+//---------------------------------------------------------------------------
+
+static  void  LvcAppendRecord (
+    std::string* pstrBody_p,
+    const tLvcSnapshot* pSnapshot_p,
+    tLvcRecType RecType_p,
+    const char* pszIndent_p)
+{
+
+const char*  pszRecord;
+size_t       nRecLen;
+size_t       nPos;
+size_t       nLineEnd;
+
+
+    pszRecord = (const char*)pSnapshot_p->m_aaui64Record[RecType_p];
+    nRecLen   = pSnapshot_p->m_aui32RecLen[RecType_p];
+    while ((nRecLen > 0) && ((pszRecord[nRecLen-1] == '\n') || (pszRecord[nRecLen-1] == '\r')))
+    {
+        nRecLen--;
+    }
+    if (nRecLen == 0)
+    {
+        *pstrBody_p += "null";
+        return;
+    }
+
+    for (nPos=0; nPos<nRecLen; nPos=nLineEnd+1)
+    {
+        nLineEnd = nPos;
+        while ((nLineEnd < nRecLen) && (pszRecord[nLineEnd] != '\n'))
+        {
+            nLineEnd++;
+        }
+        if (nPos > 0)
+        {
+            *pstrBody_p += "\n";
+            *pstrBody_p += pszIndent_p;
+        }
+        pstrBody_p->append(pszRecord + nPos, nLineEnd - nPos);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Check 'If-None-Match' of Request
+//---------------------------------------------------------------------------
+//  The header may contain a list of (weak) ETags or '*'.
+
+static  bool  LvcETagMatches (
+    const tLvcRequest* pRequest_p,
+    const char* pszETag_p)
+{
+
+size_t  nETagLen;
+size_t  nPos;
+
+
+    if (pRequest_p->m_pszIfNoneMatch == NULL)
+    {
+        return (false);
+    }
+    if ((pRequest_p->m_nIfNoneMatchLen == 1) && (pRequest_p->m_pszIfNoneMatch[0] == '*'))
+    {
+        return (true);
+    }
+
+    nETagLen = strlen(pszETag_p);
+    for (nPos=0; (nPos + nETagLen) <= pRequest_p->m_nIfNoneMatchLen; nPos++)
+    {
+        if ( !memcmp(pRequest_p->m_pszIfNoneMatch + nPos, pszETag_p, nETagLen) )
+        {
+            return (true);
+        }
+    }
+
+    return (false);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Find Value of Header Line (name case insensitive)
+//---------------------------------------------------------------------------
+
+static  const char*  LvcFindHeader (
+    const char* pszHeader_p,                            // header lines, each ending with CRLF
+    size_t nHeaderLen_p,
+    const char* pszName_p,
+    size_t* pnValueLen_p)
+{
+
+const char*  pszLine;
+const char*  pszLineEnd;
+const char*  pszHeaderEnd;
+const char*  pszValue;
+size_t       nNameLen;
+
+
+    nNameLen = strlen(pszName_p);
+    pszHeaderEnd = pszHeader_p + nHeaderLen_p;
+    for (pszLine=pszHeader_p; pszLine<pszHeaderEnd; pszLine=pszLineEnd+2)
+    {
+        pszLineEnd = (const char*)memchr(pszLine, '\r', (size_t)(pszHeaderEnd - pszLine));
+        if (pszLineEnd == NULL)
+        {
+            break;
+        }
+        if ( ((size_t)(pszLineEnd - pszLine) > nNameLen) && (pszLine[nNameLen] == ':') &&
+             !strncasecmp(pszLine, pszName_p, nNameLen) )
+        {
+            pszValue = pszLine + nNameLen + 1;
+            while ((pszValue < pszLineEnd) && ((*pszValue == ' ') || (*pszValue == '\t')))
+            {
+                pszValue++;
+            }
+            while ((pszLineEnd > pszValue) && ((pszLineEnd[-1] == ' ') || (pszLineEnd[-1] == '\t')))
+            {
+                pszLineEnd--;
+            }
+            *pnValueLen_p = (size_t)(pszLineEnd - pszValue);
+            return (pszValue);
+        }
+    }
+
+    return (NULL);
+
+}
+
+
+
+// EOF
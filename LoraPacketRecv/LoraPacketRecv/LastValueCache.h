@@ -0,0 +1,105 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Declarations for Last Value Cache with HTTP/JSON Query API
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _LASTVALUECACHE_H_
+#define _LASTVALUECACHE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+// Notice:  The cache keeps the Json Record of the newest Data Record and of
+//          the last Bootup per DevID, as published to the MQTT Broker. It is
+//          written by the main loop only and read by the HTTP server thread
+//          without locks (one sequence lock per DevID), so a slow client
+//          never delays the processing of received packets.
+//
+//          The HTTP server handles all connections in a single thread using
+//          poll() (HTTP/1.1 with keep-alive, GET and HEAD only):
+//
+//            /devices                  all DevIDs with Data and Bootup Record
+//            /devices/<dev_id>         Data and Bootup Record of one DevID
+//            /devices/<dev_id>/data    Data Record (same as MQTT message)
+//            /devices/<dev_id>/bootup  Bootup Record (same as MQTT message)
+//
+//          Each response carries an ETag (start time of the server and
+//          version of the content), a request with matching 'If-None-Match'
+//          is answered with '304 Not Modified' without building the body.
+//---------------------------------------------------------------------------
+
+const  char      LVC_DEF_BIND_ADDR[]    = "127.0.0.1";
+const  uint16_t  LVC_DEF_PORT           = 8090;
+const  size_t    LVC_MAX_RECORD_SIZE    = 1024;         // larger Json Records are not cached
+const  uint      LVC_MAX_DEVICES        = 256;
+const  uint      LVC_MAX_CONNECTIONS    = 1000;
+const  size_t    LVC_MAX_REQUEST_SIZE   = 4096;         // request line + header
+const  uint      LVC_IDLE_TIMEOUT       = 60;           // [sec] idle connections are closed
+
+
+
+//---------------------------------------------------------------------------
+//  Type definitions
+//---------------------------------------------------------------------------
+
+typedef struct
+{
+    uint64_t            m_ui64Updates;              // Json Records cached
+    uint64_t            m_ui64Ignored;              // older Data Records (e.g. Gen1/Gen2)
+    uint                m_uiOversized;              // Json Records > LVC_MAX_RECORD_SIZE
+    uint                m_uiDevices;
+    uint64_t            m_ui64Accepted;             // connections accepted
+    uint                m_uiRejected;               // connections beyond LVC_MAX_CONNECTIONS
+    uint                m_uiConnections;            // currently open
+    uint                m_uiMaxConnections;
+    uint64_t            m_ui64Requests;
+    uint64_t            m_ui64Status200;
+    uint64_t            m_ui64Status304;
+    uint64_t            m_ui64StatusError;          // 4xx
+    uint64_t            m_ui64Renders;              // body of '/devices' built
+
+} tLvcStatistics;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of public functions
+//---------------------------------------------------------------------------
+
+int  LvcOpen (
+    const char* pszBindAddr_p,                          // [IN]     IPv4 Address to listen on (NULL = LVC_DEF_BIND_ADDR)
+    uint16_t ui16Port_p);                               // [IN]     TCP Port (0 = any free port, see LvcGetPort())
+
+int  LvcClose (void);
+
+int  LvcUpdate (
+    const tJsonMessage* pJsonMessage_p);                // [IN]     Json Message (Bootup or Data Record)
+
+uint16_t  LvcGetPort (void);
+
+void  LvcGetStatistics (
+    tLvcStatistics* pStatistics_p);                     // [OUT]    Ptr to Statistics
+
+void  LvcPrintStatistics (void);
+
+
+
+#endif  // #ifndef _LASTVALUECACHE_H_
+
+
+// EOF
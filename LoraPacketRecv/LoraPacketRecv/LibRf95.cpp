@@ -10,14 +10,24 @@
   Revision History:
 
   2023/03/25 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Support for multiple (and simulated) RF95 Modules
+  2026/10/18 -rs:   V1.02 Optional SNR of received Packet
+  2026/10/18 -rs:   V1.03 Selectable SPI transport and clock, SPI benchmark
 
 ****************************************************************************/
 
 
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <mutex>
 #include <RH_RF95.h>
 #include "LibRf95.h"
+#include "GpioIrq.h"
 #include "Trace.h"
 
 
@@ -54,6 +64,33 @@
 //  Local types
 //---------------------------------------------------------------------------
 
+typedef struct
+{
+    uint8_t             m_abData[RH_RF95_MAX_PAYLOAD_LEN];
+    uint8_t             m_ui8DataLen;
+    int8_t              m_i8Rssi;
+
+} tRf95SimPacket;
+
+
+typedef struct
+{
+    RH_RF95*            m_pRF95;                        // runtime instance of RF95 driver (NULL for simulated radio)
+    uint8_t             m_ui8GpioPinCS;
+    uint8_t             m_ui8GpioPinIRQ;
+    uint8_t             m_ui8GpioPinRST;
+
+    // simulated radio: packets injected by RF95SimInjectPacket() are buffered
+    // like in the RF95 FIFO, the eventfd takes the role of the DIO0 interrupt
+    bool                m_fSimulated;
+    int                 m_iSimEventFd;
+    std::mutex          m_SimMutex;
+    tRf95SimPacket      m_aSimPacket[RF95_SIM_QUEUE_SIZE];
+    uint                m_uiSimHead;
+    uint                m_uiSimTail;
+
+} tRf95Radio;
+
 
 
 //---------------------------------------------------------------------------
@@ -66,10 +103,7 @@
 //  Local variables
 //---------------------------------------------------------------------------
 
-static  RH_RF95*    m_pRF95         = NULL;             // runtime instance of RF95 driver
-static  uint8_t     m_ui8GpioPinCS  = (uint8_t)-1;
-static  uint8_t     m_ui8GpioPinIRQ = (uint8_t)-1;
-static  uint8_t     m_ui8GpioPinRST = (uint8_t)-1;
+static  tRf95Radio  m_aRadio[RF95_MAX_RADIOS];
 
 
 
@@ -77,6 +111,8 @@ static  uint8_t     m_ui8GpioPinRST = (uint8_t)-1;
 //  Prototypes of internal functions
 //---------------------------------------------------------------------------
 
+static  uint  RF95BenchReadFrame (RH_RF95* pRF95_p, uint8_t* pabRxDataBuff_p, uint8_t ui8RxDataPackLen_p);
+static  bool  RF95BenchCheckLoopback (void);
 
 
 
@@ -91,16 +127,27 @@ static  uint8_t     m_ui8GpioPinRST = (uint8_t)-1;
 //  RF95Setup
 //---------------------------------------------------------------------------
 
-void  RF95Setup (uint8_t ui8GpioPinCS_p, uint8_t ui8GpioPinIRQ_p, uint8_t ui8GpioPinRST_p)
+void  RF95Setup (uint uiRadio_p, uint8_t ui8GpioPinCS_p, uint8_t ui8GpioPinIRQ_p, uint8_t ui8GpioPinRST_p)
 {
 
+tRf95Radio*  pRadio;
+
+
+    if (uiRadio_p >= RF95_MAX_RADIOS)
+    {
+        return;
+    }
+    pRadio = &m_aRadio[uiRadio_p];
+
     // save GPIO pin configuration
-    m_ui8GpioPinCS  = ui8GpioPinCS_p;
-    m_ui8GpioPinIRQ = ui8GpioPinIRQ_p;
-    m_ui8GpioPinRST = ui8GpioPinRST_p;
+    pRadio->m_ui8GpioPinCS  = ui8GpioPinCS_p;
+    pRadio->m_ui8GpioPinIRQ = ui8GpioPinIRQ_p;
+    pRadio->m_ui8GpioPinRST = ui8GpioPinRST_p;
+    pRadio->m_fSimulated    = false;
+    pRadio->m_iSimEventFd   = -1;
 
     // create runtime instance of RF95 driver
-    m_pRF95 = new RH_RF95(m_ui8GpioPinCS, m_ui8GpioPinIRQ);
+    pRadio->m_pRF95 = new RH_RF95(pRadio->m_ui8GpioPinCS, pRadio->m_ui8GpioPinIRQ);
 
     return;
 
@@ -108,23 +155,118 @@ void  RF95Setup (uint8_t ui8GpioPinCS_p, uint8_t ui8GpioPinIRQ_p, uint8_t ui8Gpi
 
 
 
+//---------------------------------------------------------------------------
+//  RF95SetupSpi
+//---------------------------------------------------------------------------
+//  Selects the SPI transport and clock for all RF95 Modules (they share the
+//  same bus), has to be called before RF95InitModule(). RadioHead does each
+//  register access (address and data bytes) as one full-duplex transfer,
+//  either by the bcm2835 library (<pszSpiDev_p> = NULL), the Linux spidev
+//  driver ('/dev/spidevX.Y') or the loopback device RF95_SPI_DEV_LOOPBACK.
+//  The CS lines are always driven as GPIOs by the bcm2835 library.
+
+int  RF95SetupSpi (const char* pszSpiDev_p, uint32_t ui32ClockHz_p)
+{
+
+    if ( !SPI.setDevice(pszSpiDev_p) )
+    {
+        return (-1);
+    }
+
+    // 0 = clock divider of RadioHead (RHGenericSPI::Frequency1MHz)
+    SPI.setClockHz(ui32ClockHz_p);
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  RF95SetupSimulated
+//---------------------------------------------------------------------------
+
+int  RF95SetupSimulated (uint uiRadio_p)
+{
+
+tRf95Radio*  pRadio;
+
+
+    if (uiRadio_p >= RF95_MAX_RADIOS)
+    {
+        return (-1);
+    }
+    pRadio = &m_aRadio[uiRadio_p];
+
+    pRadio->m_pRF95         = NULL;
+    pRadio->m_ui8GpioPinCS  = (uint8_t)-1;
+    pRadio->m_ui8GpioPinIRQ = (uint8_t)-1;
+    pRadio->m_ui8GpioPinRST = (uint8_t)-1;
+    pRadio->m_uiSimHead     = 0;
+    pRadio->m_uiSimTail     = 0;
+
+    pRadio->m_iSimEventFd = eventfd(0, (EFD_NONBLOCK | EFD_SEMAPHORE));
+    if (pRadio->m_iSimEventFd < 0)
+    {
+        return (-2);
+    }
+    pRadio->m_fSimulated = true;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  RF95IsSimulated
+//---------------------------------------------------------------------------
+
+bool  RF95IsSimulated (uint uiRadio_p)
+{
+
+    if (uiRadio_p >= RF95_MAX_RADIOS)
+    {
+        return (false);
+    }
+
+    return (m_aRadio[uiRadio_p].m_fSimulated);
+
+}
+
+
+
 //---------------------------------------------------------------------------
 //  RF95ResetModule
 //---------------------------------------------------------------------------
 
-int  RF95ResetModule ()
+int  RF95ResetModule (uint uiRadio_p)
 {
 
-    if (m_ui8GpioPinRST == (uint8_t)-1)
+tRf95Radio*  pRadio;
+
+
+    if (uiRadio_p >= RF95_MAX_RADIOS)
+    {
+        return (-1);
+    }
+    pRadio = &m_aRadio[uiRadio_p];
+
+    if ( pRadio->m_fSimulated )
+    {
+        return (0);
+    }
+
+    if (pRadio->m_ui8GpioPinRST == (uint8_t)-1)
     {
         return (-1);
     }
 
     // Pulse a reset on module
-    pinMode(m_ui8GpioPinRST, OUTPUT);
-    digitalWrite(m_ui8GpioPinRST, LOW);
+    pinMode(pRadio->m_ui8GpioPinRST, OUTPUT);
+    digitalWrite(pRadio->m_ui8GpioPinRST, LOW);
     bcm2835_delay(150);
-    digitalWrite(m_ui8GpioPinRST, HIGH);
+    digitalWrite(pRadio->m_ui8GpioPinRST, HIGH);
     bcm2835_delay(100);
 
     return (0);
@@ -137,23 +279,35 @@ int  RF95ResetModule ()
 //  RF95InitModule
 //---------------------------------------------------------------------------
 
-int  RF95InitModule (int8_t i8TxPower_p, float flCentreFrequ_p)
+int  RF95InitModule (uint uiRadio_p, int8_t i8TxPower_p, float flCentreFrequ_p, uint8_t ui8SpreadFactor_p)
 {
 
-bool  fRes;
+RH_RF95*  pRF95;
+uint8_t   ui8RegData;
+bool      fRes;
 
 
-    TRACE0("RF95InitModule:\n");
+    TRACE1("RF95InitModule(%u):\n", uiRadio_p);
 
-    if (m_pRF95 == NULL)
+    if (uiRadio_p >= RF95_MAX_RADIOS)
     {
-        TRACE0("FAILED (m_pRF95 == NULL)!\n");
+        return (-1);
+    }
+    if ( m_aRadio[uiRadio_p].m_fSimulated )
+    {
+        return (0);
+    }
+
+    pRF95 = m_aRadio[uiRadio_p].m_pRF95;
+    if (pRF95 == NULL)
+    {
+        TRACE0("FAILED (pRF95 == NULL)!\n");
         return (-1);
     }
 
     // initialize RF95 board driver
-    TRACE0("m_pRF95->init()...\n");
-    fRes = m_pRF95->init();
+    TRACE0("pRF95->init()...\n");
+    fRes = pRF95->init();
     if ( !fRes )
     {
         TRACE0("FAILED!\n");
@@ -161,20 +315,35 @@ bool  fRes;
     }
 
     // set transmitter power output level
-    TRACE0("m_pRF95->setTxPower()...\n");
-    m_pRF95->setTxPower(i8TxPower_p, false);
+    TRACE0("pRF95->setTxPower()...\n");
+    pRF95->setTxPower(i8TxPower_p, false);
 
     // set transmitter and receiver centre frequency
-    TRACE0("m_pRF95->setFrequency()...\n");
-    m_pRF95->setFrequency(flCentreFrequ_p);
+    TRACE0("pRF95->setFrequency()...\n");
+    pRF95->setFrequency(flCentreFrequ_p);
+
+    // set spreading factor (SF7..SF12, 0 = keep default of RadioHead driver)
+    // (this RadioHead version has no setSpreadingFactor(), so write register directly)
+    if (ui8SpreadFactor_p != 0)
+    {
+        if ((ui8SpreadFactor_p < 7) || (ui8SpreadFactor_p > 12))
+        {
+            TRACE1("FAILED (invalid SpreadFactor %u)!\n", (uint)ui8SpreadFactor_p);
+            return (-3);
+        }
+        TRACE1("pRF95->spiWrite(RH_RF95_REG_1E_MODEM_CONFIG2) -> SF%u...\n", (uint)ui8SpreadFactor_p);
+        ui8RegData = pRF95->spiRead(RH_RF95_REG_1E_MODEM_CONFIG2);
+        ui8RegData = (ui8RegData & ~RH_RF95_SPREADING_FACTOR) | ((ui8SpreadFactor_p << 4) & RH_RF95_SPREADING_FACTOR);
+        pRF95->spiWrite(RH_RF95_REG_1E_MODEM_CONFIG2, ui8RegData);
+    }
 
     // grab all packets received by this node
-    TRACE0("m_pRF95->setPromiscuous()...\n");
-    m_pRF95->setPromiscuous(true);
+    TRACE0("pRF95->setPromiscuous()...\n");
+    pRF95->setPromiscuous(true);
 
     // enabele listening for for all incoming messages
-    TRACE0("m_pRF95->setModeRx()...\n");
-    m_pRF95->setModeRx();
+    TRACE0("pRF95->setModeRx()...\n");
+    pRF95->setModeRx();
 
     return (0);
 
@@ -183,50 +352,173 @@ bool  fRes;
 
 
 //---------------------------------------------------------------------------
-//  RF95GetRecvDataPacket
+//  RF95GetIrqFD
 //---------------------------------------------------------------------------
 
-bool  RF95GetRecvDataPacket (uint8_t* pabRxDataBuff_p, uint* puiRxDataBuffLen_p, int8_t* pi8LastRssi_p)
+int  RF95GetIrqFD (uint uiRadio_p)
 {
 
-uint8_t  abRxDataBuff[RH_RF95_MAX_PAYLOAD_LEN];
-uint8_t  ui8RxDataPackLen;
-uint8_t  ui8IrqFlags;
-int8_t   i8LastRssi;
-uint     uiRxDataBuffLen;
-bool     fRxValid;
+    if (uiRadio_p >= RF95_MAX_RADIOS)
+    {
+        return (-1);
+    }
 
+    if ( m_aRadio[uiRadio_p].m_fSimulated )
+    {
+        return (m_aRadio[uiRadio_p].m_iSimEventFd);
+    }
 
-    TRACE0("RF95GetRecvDataPacket:\n");
+    return (GpioGetFD(m_aRadio[uiRadio_p].m_ui8GpioPinIRQ));
 
-    // read interrupt register
-    ui8IrqFlags = m_pRF95->spiRead(RH_RF95_REG_12_IRQ_FLAGS);
-    fRxValid = (ui8IrqFlags & RH_RF95_RX_DONE) ? true : false;
-    TRACE1("fRxValid = %d\n", (int)fRxValid);
+}
 
-    // get received data from RF95
-    if ( fRxValid )
+
+
+//---------------------------------------------------------------------------
+//  RF95GetIrqEvents
+//---------------------------------------------------------------------------
+
+short  RF95GetIrqEvents (uint uiRadio_p)
+{
+
+    // sysfs GPIO signals edges as exceptional condition,
+    // eventfd of simulated radio signals as readable
+    if ((uiRadio_p < RF95_MAX_RADIOS) && m_aRadio[uiRadio_p].m_fSimulated)
     {
-        // packet successfully received
-        ui8RxDataPackLen = m_pRF95->spiRead(RH_RF95_REG_13_RX_NB_BYTES);
-        if (ui8RxDataPackLen > sizeof(abRxDataBuff))
+        return (POLLIN);
+    }
+
+    return (POLLPRI);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  RF95AckIrq
+//---------------------------------------------------------------------------
+
+int  RF95AckIrq (uint uiRadio_p)
+{
+
+uint64_t      ui64Event;
+volatile int  iGpioState;
+
+
+    if (uiRadio_p >= RF95_MAX_RADIOS)
+    {
+        return (-1);
+    }
+
+    if ( m_aRadio[uiRadio_p].m_fSimulated )
+    {
+        if (read(m_aRadio[uiRadio_p].m_iSimEventFd, &ui64Event, sizeof(ui64Event)) != sizeof(ui64Event))
         {
-            // limt copy size to max. buffer size
-            ui8RxDataPackLen = sizeof(abRxDataBuff);
+            return (0);
         }
+        return ((int)ui64Event);
+    }
+
+    // Reading the GPIO (with an implicitly lssek()) is necessary after an interrupt has been
+    // occured to clear the interrupt event of the file descriptor. Without reading the GPIO
+    // the generated event will be signaled forever. As a result the poll() function returns
+    // immediately on every call without waiting for the next event.
+    //
+    // see: https://stackoverflow.com/questions/37620578/poll-not-blocking-returns-immediately
+    // "After poll(2) returns, either lseek(2) to the beginning of the sysfs file and
+    // read the new value or close the file and re-open it to read the value."
+    iGpioState = GpioRead(m_aRadio[uiRadio_p].m_ui8GpioPinIRQ);
+    TRACE2("\nGPIO BCM.%d interrupt occurred -> GpioState=%d\n", (int)m_aRadio[uiRadio_p].m_ui8GpioPinIRQ, iGpioState);
+
+    return (1);
+
+}
 
-        // reset FIFO read ptr to beginning of packet
-        m_pRF95->spiWrite(RH_RF95_REG_0D_FIFO_ADDR_PTR, m_pRF95->spiRead(RH_RF95_REG_10_FIFO_RX_CURRENT_ADDR));
-        m_pRF95->spiBurstRead(RH_RF95_REG_00_FIFO, abRxDataBuff, ui8RxDataPackLen);
 
-        // clear all IRQ flags
-        m_pRF95->spiWrite(RH_RF95_REG_12_IRQ_FLAGS, 0xFF);
 
-        // remember the RSSI of this packet
-        // this is according to the doc, but is it really correct?
-        // weakest receiveable signals are reported RSSI at about -66
-        i8LastRssi = m_pRF95->spiRead(RH_RF95_REG_1A_PKT_RSSI_VALUE) - 137;
+//---------------------------------------------------------------------------
+//  RF95GetRecvDataPacket
+//---------------------------------------------------------------------------
+//  The SNR costs an additional SPI transfer, so it is only read if
+//  <pi8LastSnr_p> is not NULL. It is returned in steps of 0.25 dB as
+//  provided by the SX1276 (simulated radios always report 0).
+
+bool  RF95GetRecvDataPacket (uint uiRadio_p, uint8_t* pabRxDataBuff_p, uint* puiRxDataBuffLen_p, int8_t* pi8LastRssi_p, int8_t* pi8LastSnr_p)
+{
+
+tRf95Radio*      pRadio;
+RH_RF95*         pRF95;
+tRf95SimPacket*  pSimPacket;
+uint8_t          abRxDataBuff[RH_RF95_MAX_PAYLOAD_LEN];
+uint8_t          ui8RxDataPackLen;
+uint8_t          ui8IrqFlags;
+int8_t           i8LastRssi;
+int8_t           i8LastSnr;
+uint             uiRxDataBuffLen;
+bool             fRxValid;
+
+
+    TRACE1("RF95GetRecvDataPacket(%u):\n", uiRadio_p);
+
+    if (uiRadio_p >= RF95_MAX_RADIOS)
+    {
+        return (false);
+    }
+    pRadio = &m_aRadio[uiRadio_p];
+    pRF95  = pRadio->m_pRF95;
+    i8LastSnr = 0;
+
+    if ( pRadio->m_fSimulated )
+    {
+        // get next injected packet from simulated FIFO
+        std::lock_guard<std::mutex> Lock(pRadio->m_SimMutex);
+        fRxValid = (pRadio->m_uiSimHead != pRadio->m_uiSimTail);
+        if ( fRxValid )
+        {
+            pSimPacket = &pRadio->m_aSimPacket[pRadio->m_uiSimTail % RF95_SIM_QUEUE_SIZE];
+            ui8RxDataPackLen = pSimPacket->m_ui8DataLen;
+            memcpy(abRxDataBuff, pSimPacket->m_abData, ui8RxDataPackLen);
+            i8LastRssi = pSimPacket->m_i8Rssi;
+            pRadio->m_uiSimTail++;
+        }
     }
+    else
+    {
+        // read interrupt register
+        ui8IrqFlags = pRF95->spiRead(RH_RF95_REG_12_IRQ_FLAGS);
+        fRxValid = (ui8IrqFlags & RH_RF95_RX_DONE) ? true : false;
+
+        // get received data from RF95
+        if ( fRxValid )
+        {
+            // packet successfully received
+            ui8RxDataPackLen = pRF95->spiRead(RH_RF95_REG_13_RX_NB_BYTES);
+            if (ui8RxDataPackLen > sizeof(abRxDataBuff))
+            {
+                // limt copy size to max. buffer size
+                ui8RxDataPackLen = sizeof(abRxDataBuff);
+            }
+
+            // reset FIFO read ptr to beginning of packet
+            pRF95->spiWrite(RH_RF95_REG_0D_FIFO_ADDR_PTR, pRF95->spiRead(RH_RF95_REG_10_FIFO_RX_CURRENT_ADDR));
+            pRF95->spiBurstRead(RH_RF95_REG_00_FIFO, abRxDataBuff, ui8RxDataPackLen);
+
+            // clear all IRQ flags
+            pRF95->spiWrite(RH_RF95_REG_12_IRQ_FLAGS, 0xFF);
+
+            // remember the RSSI of this packet
+            // this is according to the doc, but is it really correct?
+            // weakest receiveable signals are reported RSSI at about -66
+            i8LastRssi = pRF95->spiRead(RH_RF95_REG_1A_PKT_RSSI_VALUE) - 137;
+
+            // SNR is a signed value in steps of 0.25 dB
+            if (pi8LastSnr_p != NULL)
+            {
+                i8LastSnr = (int8_t)pRF95->spiRead(RH_RF95_REG_19_PKT_SNR_VALUE);
+            }
+        }
+    }
+    TRACE1("fRxValid = %d\n", (int)fRxValid);
 
     // copy received data to application
     if ( fRxValid )
@@ -251,6 +543,12 @@ bool     fRxValid;
 
         // return RSSI level
         *pi8LastRssi_p = i8LastRssi;
+
+        // return SNR level (if requested)
+        if (pi8LastSnr_p != NULL)
+        {
+            *pi8LastSnr_p = i8LastSnr;
+        }
     }
 
     return (fRxValid);
@@ -259,18 +557,75 @@ bool     fRxValid;
 
 
 
+//---------------------------------------------------------------------------
+//  RF95SimInjectPacket
+//---------------------------------------------------------------------------
+//  Simulates the reception of a packet by a simulated radio (called by the
+//  radio simulation, see RadioSim.cpp). If the FIFO is full the packet is
+//  lost, as it would be on a real module that is not read out in time.
+
+int  RF95SimInjectPacket (uint uiRadio_p, const uint8_t* pabData_p, uint uiDataLen_p, int8_t i8Rssi_p)
+{
+
+tRf95Radio*      pRadio;
+tRf95SimPacket*  pSimPacket;
+uint64_t         ui64Event;
+
+
+    if ((uiRadio_p >= RF95_MAX_RADIOS) || !m_aRadio[uiRadio_p].m_fSimulated)
+    {
+        return (-1);
+    }
+    if (uiDataLen_p > RH_RF95_MAX_PAYLOAD_LEN)
+    {
+        return (-2);
+    }
+    pRadio = &m_aRadio[uiRadio_p];
+
+    {
+        std::lock_guard<std::mutex> Lock(pRadio->m_SimMutex);
+        if ((pRadio->m_uiSimHead - pRadio->m_uiSimTail) >= RF95_SIM_QUEUE_SIZE)
+        {
+            return (-3);
+        }
+        pSimPacket = &pRadio->m_aSimPacket[pRadio->m_uiSimHead % RF95_SIM_QUEUE_SIZE];
+        memcpy(pSimPacket->m_abData, pabData_p, uiDataLen_p);
+        pSimPacket->m_ui8DataLen = (uint8_t)uiDataLen_p;
+        pSimPacket->m_i8Rssi = i8Rssi_p;
+        pRadio->m_uiSimHead++;
+    }
+
+    // signal "DIO0 interrupt"
+    ui64Event = 1;
+    if (write(pRadio->m_iSimEventFd, &ui64Event, sizeof(ui64Event)) != sizeof(ui64Event))
+    {
+        return (-4);
+    }
+
+    return (0);
+
+}
+
+
+
 //---------------------------------------------------------------------------
 //  RF95DiagDumpRegs
 //---------------------------------------------------------------------------
 
-int  RF95DiagDumpRegs ()
+int  RF95DiagDumpRegs (uint uiRadio_p)
 {
 
-uint8_t  aui8RegData[0x65];
-int      iIdx;
+RH_RF95*  pRF95;
+uint8_t   aui8RegData[0x65];
+int       iIdx;
 
 
-    if (m_pRF95 == NULL)
+    if (uiRadio_p >= RF95_MAX_RADIOS)
+    {
+        return (-1);
+    }
+    pRF95 = m_aRadio[uiRadio_p].m_pRF95;
+    if (pRF95 == NULL)
     {
         return (-1);
     }
@@ -280,7 +635,7 @@ int      iIdx;
     printf("Reg.  :  Data\r\n");
     printf("-------------\r\n");
 
-    m_pRF95->spiBurstRead(RH_RF95_REG_00_FIFO, aui8RegData, sizeof(aui8RegData));
+    pRF95->spiBurstRead(RH_RF95_REG_00_FIFO, aui8RegData, sizeof(aui8RegData));
     for (iIdx=0; iIdx<sizeof(aui8RegData); iIdx++)
     {
         printf("0x%02X  :  0x%02X\r\n", iIdx, (uint)aui8RegData[iIdx]);
@@ -297,9 +652,10 @@ int      iIdx;
 //  RF95DiagPrintConfig
 //---------------------------------------------------------------------------
 
-int  RF95DiagPrintConfig ()
+int  RF95DiagPrintConfig (uint uiRadio_p)
 {
 
+RH_RF95*  pRF95;
 uint8_t   ui8RegAddr;
 uint8_t   ui8RegData;
 uint      uiCfgData;
@@ -314,7 +670,12 @@ float     flPmax;
 float     flPout;
 
 
-    if (m_pRF95 == NULL)
+    if (uiRadio_p >= RF95_MAX_RADIOS)
+    {
+        return (-1);
+    }
+    pRF95 = m_aRadio[uiRadio_p].m_pRF95;
+    if (pRF95 == NULL)
     {
         return (-1);
     }
@@ -327,7 +688,7 @@ float     flPout;
 
     // ---- RH_RF95_REG_01_OP_MODE ----
     ui8RegAddr = RH_RF95_REG_01_OP_MODE;
-    ui8RegData = m_pRF95->spiRead(ui8RegAddr);
+    ui8RegData = pRF95->spiRead(ui8RegAddr);
     printf("0x%02X  :  0x%02X  ->  %s\r\n", (uint)ui8RegAddr, (uint)ui8RegData, "RH_RF95_REG_01_OP_MODE");
     printf("                       [.7]   LONG_RANGE_MODE    = %d\r\n", ((ui8RegData & RH_RF95_LONG_RANGE_MODE)    ? 1 : 0));
     printf("                       [.6]   ACCESS_SHARED_REG  = %d\r\n", ((ui8RegData & RH_RF95_ACCESS_SHARED_REG)  ? 1 : 0));
@@ -349,11 +710,11 @@ float     flPout;
 
     // ---- RH_RF95_REG_02_RESERVED / RH_RF95_REG_03_RESERVED (RH_RF95_REG_02_BITRATE_MSB / RH_RF95_REG_03_BITRATE_LSB) ----
     ui8RegAddr = RH_RF95_REG_02_RESERVED;       // = RH_RF95_REG_02_BITRATE_MSB
-    ui8RegData = m_pRF95->spiRead(ui8RegAddr);
+    ui8RegData = pRF95->spiRead(ui8RegAddr);
     printf("0x%02X  :  0x%02X  ->  %s\r\n", (uint)ui8RegAddr, (uint)ui8RegData, "RH_RF95_REG_02_BITRATE_MSB");
     ui32Bitrate = (uint32_t)ui8RegData << 8;
     ui8RegAddr = RH_RF95_REG_03_RESERVED;       // = RH_RF95_REG_03_BITRATE_LSB
-    ui8RegData = m_pRF95->spiRead(ui8RegAddr);
+    ui8RegData = pRF95->spiRead(ui8RegAddr);
     printf("0x%02X  :  0x%02X  ->  %s\r\n", (uint)ui8RegAddr, (uint)ui8RegData, "RH_RF95_REG_03_BITRATE_LSB");
     ui32Bitrate |= (uint32_t)ui8RegData;
     flBitrate = RH_RF95_FXOSC / (float)ui32Bitrate;
@@ -363,11 +724,11 @@ float     flPout;
 
     // ---- RH_RF95_REG_04_RESERVED / RH_RF95_REG_05_RESERVED (RH_RF95_REG_04_FDEV_MSB / RH_RF95_REG_05_FDEV_LSB) ----
     ui8RegAddr = RH_RF95_REG_04_RESERVED;       // = RH_RF95_REG_04_FDEV_MSB
-    ui8RegData = m_pRF95->spiRead(ui8RegAddr);
+    ui8RegData = pRF95->spiRead(ui8RegAddr);
     printf("0x%02X  :  0x%02X  ->  %s\r\n", (uint)ui8RegAddr, (uint)ui8RegData, "RH_RF95_REG_04_FDEV_MSB");
     ui32Fdev = (uint32_t)ui8RegData << 8;
     ui8RegAddr = RH_RF95_REG_05_RESERVED;       // = RH_RF95_REG_05_FDEV_LSB
-    ui8RegData = m_pRF95->spiRead(ui8RegAddr);
+    ui8RegData = pRF95->spiRead(ui8RegAddr);
     printf("0x%02X  :  0x%02X  ->  %s\r\n", (uint)ui8RegAddr, (uint)ui8RegData, "RH_RF95_REG_05_FDEV_LSB");
     ui32Fdev |= (uint32_t)ui8RegData;
     flFdev = RH_RF95_FSTEP * (float)ui32Fdev;
@@ -376,15 +737,15 @@ float     flPout;
 
     // ---- RH_RF95_REG_06_FRF_MSB / RH_RF95_REG_07_FRF_MID / RH_RF95_REG_08_FRF_LSB ----
     ui8RegAddr = RH_RF95_REG_06_FRF_MSB;
-    ui8RegData = m_pRF95->spiRead(ui8RegAddr);
+    ui8RegData = pRF95->spiRead(ui8RegAddr);
     printf("0x%02X  :  0x%02X  ->  %s\r\n", (uint)ui8RegAddr, (uint)ui8RegData, "RH_RF95_REG_06_FRF_MSB");
     ui32Frequency = (uint32_t)ui8RegData << 16;
     ui8RegAddr = RH_RF95_REG_07_FRF_MID;
-    ui8RegData = m_pRF95->spiRead(ui8RegAddr);
+    ui8RegData = pRF95->spiRead(ui8RegAddr);
     printf("0x%02X  :  0x%02X  ->  %s\r\n", (uint)ui8RegAddr, (uint)ui8RegData, "RH_RF95_REG_07_FRF_MID");
     ui32Frequency |= (uint32_t)ui8RegData << 8;
     ui8RegAddr = RH_RF95_REG_08_FRF_LSB;
-    ui8RegData = m_pRF95->spiRead(ui8RegAddr);
+    ui8RegData = pRF95->spiRead(ui8RegAddr);
     printf("0x%02X  :  0x%02X  ->  %s\r\n", (uint)ui8RegAddr, (uint)ui8RegData, "RH_RF95_REG_08_FRF_LSB");
     ui32Frequency |= (uint32_t)ui8RegData;
     flFrequency = ((float)ui32Frequency * RH_RF95_FSTEP) / 1000000.0;
@@ -393,7 +754,7 @@ float     flPout;
 
     // ---- RH_RF95_REG_09_PA_CONFIG ----
     ui8RegAddr = RH_RF95_REG_09_PA_CONFIG;
-    ui8RegData = m_pRF95->spiRead(ui8RegAddr);
+    ui8RegData = pRF95->spiRead(ui8RegAddr);
     printf("0x%02X  :  0x%02X  ->  %s\r\n", (uint)ui8RegAddr, (uint)ui8RegData, "RH_RF95_REG_09_PA_CONFIG");
     uiPaSelect = (ui8RegData & RH_RF95_PA_SELECT) ? 1 : 0;
     printf("                       [.7]   RH_RF95_PA_SELECT    = %d -> %s\r\n", uiPaSelect, (uiPaSelect == 0) ? "RFO pin. Maximum power of +14 dBm" : "PA_BOOST pin. Maximum power of +20 dBm");
@@ -407,7 +768,7 @@ float     flPout;
 
     // ---- RH_RF95_REG_1D_MODEM_CONFIG1 ----
     ui8RegAddr = RH_RF95_REG_1D_MODEM_CONFIG1;
-    ui8RegData = m_pRF95->spiRead(ui8RegAddr);
+    ui8RegData = pRF95->spiRead(ui8RegAddr);
     printf("0x%02X  :  0x%02X  ->  %s\r\n", (uint)ui8RegAddr, (uint)ui8RegData, "RH_RF95_REG_1D_MODEM_CONFIG1");
     printf("                       [.7-4] SIGNAL_BANDWIDTH        = ");
     switch (ui8RegData & RH_RF95_BW)
@@ -438,7 +799,7 @@ float     flPout;
 
     // ---- RH_RF95_REG_1E_MODEM_CONFIG2 ----
     ui8RegAddr = RH_RF95_REG_1E_MODEM_CONFIG2;
-    ui8RegData = m_pRF95->spiRead(ui8RegAddr);
+    ui8RegData = pRF95->spiRead(ui8RegAddr);
     printf("0x%02X  :  0x%02X  ->  %s\r\n", (uint)ui8RegAddr, (uint)ui8RegData, "RH_RF95_REG_1E_MODEM_CONFIG2");
     printf("                       [.7-4] SPREADING_FACTOR   = ");
     switch (ui8RegData & RH_RF95_SPREADING_FACTOR)
@@ -464,6 +825,142 @@ float     flPout;
 
 
 
+//---------------------------------------------------------------------------
+//  RF95RunSpiBenchmark
+//---------------------------------------------------------------------------
+//  Measures the SPI time to read out a received frame with the register
+//  accesses of RF95GetRecvDataPacket() (incl. RSSI and SNR), once with one
+//  SPI transfer per byte (as up to V1.02) and once with one transfer per
+//  register access. The module is not initialized (and not switched to Rx
+//  mode), so it also runs with the loopback device or with MOSI connected
+//  to MISO instead of a module. In this case the loopback check verifies
+//  that each transferred byte is read back as sent.
+
+int  RF95RunSpiBenchmark (uint uiRadio_p, uint uiFrames_p, uint uiFrameLen_p)
+{
+
+static const char*  apszPassName[] = { "per byte", "bulk" };
+
+RH_RF95*         pRF95;
+uint8_t          abRxDataBuff[RH_RF95_MAX_PAYLOAD_LEN];
+struct timespec  tsStart;
+struct timespec  tsEnd;
+double           dRunTime;
+uint             uiTransfers;
+uint             uiFrame;
+int              iPass;
+
+
+    if ((uiRadio_p >= RF95_MAX_RADIOS) || (uiFrames_p == 0) || (uiFrameLen_p > RH_RF95_MAX_PAYLOAD_LEN))
+    {
+        return (-1);
+    }
+    pRF95 = m_aRadio[uiRadio_p].m_pRF95;
+    if (pRF95 == NULL)
+    {
+        return (-1);
+    }
+
+    // start SPI and CS line like RHSPIDriver::init()
+    hardware_spi.begin();
+    pinMode(m_aRadio[uiRadio_p].m_ui8GpioPinCS, OUTPUT);
+    digitalWrite(m_aRadio[uiRadio_p].m_ui8GpioPinCS, HIGH);
+
+    printf("SPI Benchmark: %u Frames of %u Bytes, SPI Clock %.3f MHz\n",
+           uiFrames_p, uiFrameLen_p, (double)SPI.getClockHz() / 1000000.0);
+
+    for (iPass=0; iPass<2; iPass++)
+    {
+        SPI.setBulkTransfers(iPass == 1);
+
+        clock_gettime(CLOCK_MONOTONIC, &tsStart);
+        uiTransfers = 0;
+        for (uiFrame=0; uiFrame<uiFrames_p; uiFrame++)
+        {
+            uiTransfers = RF95BenchReadFrame(pRF95, abRxDataBuff, (uint8_t)uiFrameLen_p);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &tsEnd);
+        dRunTime = (double)(tsEnd.tv_sec - tsStart.tv_sec) + ((double)(tsEnd.tv_nsec - tsStart.tv_nsec) / 1000000000.0);
+
+        // per byte: one transfer for each byte of the register accesses
+        // (address and data byte, address and data bytes of burst read)
+        if (iPass == 0)
+        {
+            uiTransfers = (uiTransfers - 1) * 2 + 1 + uiFrameLen_p;
+        }
+
+        printf("  %-8s:  %3u Transfers/Frame,  %8.2f us/Frame,  Loopback Check: %s\n",
+               apszPassName[iPass], uiTransfers, (dRunTime * 1000000.0) / uiFrames_p,
+               (RF95BenchCheckLoopback() ? "passed" : "failed (expected with RF95 Module)"));
+    }
+
+    SPI.setBulkTransfers(true);
+
+    return (0);
+
+}
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Read out a frame for RF95RunSpiBenchmark()
+//---------------------------------------------------------------------------
+//  Same register accesses as RF95GetRecvDataPacket(), returns the number of
+//  register accesses.
+
+static  uint  RF95BenchReadFrame (RH_RF95* pRF95_p, uint8_t* pabRxDataBuff_p, uint8_t ui8RxDataPackLen_p)
+{
+
+    pRF95_p->spiRead(RH_RF95_REG_12_IRQ_FLAGS);
+    pRF95_p->spiRead(RH_RF95_REG_13_RX_NB_BYTES);
+    pRF95_p->spiWrite(RH_RF95_REG_0D_FIFO_ADDR_PTR, pRF95_p->spiRead(RH_RF95_REG_10_FIFO_RX_CURRENT_ADDR));
+    pRF95_p->spiBurstRead(RH_RF95_REG_00_FIFO, pabRxDataBuff_p, ui8RxDataPackLen_p);
+    pRF95_p->spiWrite(RH_RF95_REG_12_IRQ_FLAGS, 0xFF);
+    pRF95_p->spiRead(RH_RF95_REG_1A_PKT_RSSI_VALUE);
+    pRF95_p->spiRead(RH_RF95_REG_19_PKT_SNR_VALUE);
+
+    return (8);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Check loopback for RF95RunSpiBenchmark()
+//---------------------------------------------------------------------------
+//  Without a module every byte is read back as sent (MOSI connected to MISO
+//  or loopback device). All values 0x00..0xFF are transferred with the mode
+//  currently set by SPIClass::setBulkTransfers().
+
+static  bool  RF95BenchCheckLoopback (void)
+{
+
+uint8_t  abTxData[256];
+uint8_t  abRxData[256];
+uint     uiIdx;
+
+
+    for (uiIdx=0; uiIdx<sizeof(abTxData); uiIdx++)
+    {
+        abTxData[uiIdx] = (uint8_t)uiIdx;
+    }
+    memcpy(abRxData, abTxData, sizeof(abRxData));
+
+    hardware_spi.transfern(abRxData, sizeof(abRxData));
+
+    return (memcmp(abRxData, abTxData, sizeof(abRxData)) == 0);
+
+}
+
+
+
 
 // EOF
 
@@ -10,6 +10,9 @@
   Revision History:
 
   2023/03/25 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Support for multiple (and simulated) RF95 Modules
+  2026/10/18 -rs:   V1.02 Optional SNR of received Packet
+  2026/10/18 -rs:   V1.03 Selectable SPI transport and clock, SPI benchmark
 
 ****************************************************************************/
 
@@ -22,18 +25,36 @@
 //  Constant definitions
 //---------------------------------------------------------------------------
 
+const  uint  RF95_MAX_RADIOS        = 3;        // RadioHead supports max. 3 RH_RF95 instances (RH_RF95_NUM_INTERRUPTS)
+const  uint  RF95_SIM_QUEUE_SIZE    = 8;        // receive FIFO depth of a simulated radio [packets]
+
+const  uint  RF95_DEF_SPREAD_FACTOR = 7;        // SF of RadioHead default modem config (Bw125Cr45Sf128)
+const  uint  RF95_DEF_BANDWIDTH_KHZ = 125;      // bandwidth of RadioHead default modem config [kHz]
+
+const  uint  RF95_SPI_MAX_CLOCK_KHZ = 10000;    // max. SPI clock of SX1276 [kHz]
+const  uint  RF95_SPI_BENCH_FRAMES  = 10000;    // default number of frames read by RF95RunSpiBenchmark()
+const  char  RF95_SPI_DEV_LOOPBACK[] = "loopback";    // SPI device without hardware access, reads back the sent bytes (RASPI_SPI_DEV_LOOPBACK)
+
 
 
 //---------------------------------------------------------------------------
 //  Prototypes of public functions
 //---------------------------------------------------------------------------
 
-void  RF95Setup (uint8_t ui8GpioPinCS_p, uint8_t ui8GpioPinIRQ_p, uint8_t ui8GpioPinRST_p);
-int   RF95ResetModule ();
-int   RF95InitModule (int8_t i8TxPower_p, float flCentreFrequ_p);
-bool  RF95GetRecvDataPacket (uint8_t* pabRxDataBuff_p, uint* puiRxDataBuffLen_p, int8_t* pi8LastRssi_p);
-int   RF95DiagDumpRegs ();
-int   RF95DiagPrintConfig ();
+void  RF95Setup (uint uiRadio_p, uint8_t ui8GpioPinCS_p, uint8_t ui8GpioPinIRQ_p, uint8_t ui8GpioPinRST_p);
+int   RF95SetupSpi (const char* pszSpiDev_p, uint32_t ui32ClockHz_p);
+int   RF95SetupSimulated (uint uiRadio_p);
+bool  RF95IsSimulated (uint uiRadio_p);
+int   RF95ResetModule (uint uiRadio_p);
+int   RF95InitModule (uint uiRadio_p, int8_t i8TxPower_p, float flCentreFrequ_p, uint8_t ui8SpreadFactor_p);
+int   RF95GetIrqFD (uint uiRadio_p);
+short RF95GetIrqEvents (uint uiRadio_p);
+int   RF95AckIrq (uint uiRadio_p);
+bool  RF95GetRecvDataPacket (uint uiRadio_p, uint8_t* pabRxDataBuff_p, uint* puiRxDataBuffLen_p, int8_t* pi8LastRssi_p, int8_t* pi8LastSnr_p);
+int   RF95SimInjectPacket (uint uiRadio_p, const uint8_t* pabData_p, uint uiDataLen_p, int8_t i8Rssi_p);
+int   RF95DiagDumpRegs (uint uiRadio_p);
+int   RF95DiagPrintConfig (uint uiRadio_p);
+int   RF95RunSpiBenchmark (uint uiRadio_p, uint uiFrames_p, uint uiFrameLen_p);
 
 
 
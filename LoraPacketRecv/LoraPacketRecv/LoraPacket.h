@@ -10,6 +10,11 @@
   Revision History:
 
   2023/03/25 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Delta Data Packet with configurable Generation Depth
+  2026/10/18 -rs:   V1.02 Compact Data Packet with Record Layout derived from
+                          Sensor Configuration
+  2026/10/18 -rs:   V1.03 Records as Byte Arrays instead of Bitfields (Layout
+                          independent of Compiler and Target)
 
 ****************************************************************************/
 
@@ -27,38 +32,71 @@ typedef enum
     kLoraPacketDataHeader                   =  2,
     kLoraPacketDataGen0                     =  3,
     kLoraPacketDataGen1                     =  4,
-    kLoraPacketDataGen2                     =  5
+    kLoraPacketDataGen2                     =  5,
+    kLoraPacketDataHeaderDelta              =  6,
+    kLoraPacketDataGenN                     =  7,       // Gen3..GenN of Delta Data Packet (Receiver only, not used Over-the-Air)
+    kLoraPacketDataHeaderCompact            =  8
 
 } tLoraPacketType;
 
 
 
+//---------------------------------------------------------------------------
+//  Definitions for Delta Data Packets
+//---------------------------------------------------------------------------
+
+const unsigned int  LORA_DATA_GEN_DEPTH_MAX     = 16;   // max. number of generations in a Delta Data Packet (Gen0..Gen15)
+
+
+
+//---------------------------------------------------------------------------
+//  Definitions for Compact Data Packets
+//---------------------------------------------------------------------------
+
+// [Layout Byte of Compact Data Packet]
+//   Bit0..3: Sensors present in the DataRecords (same as CfgXxx in <tLoraBootupHeader>)
+//   Bit4..7: Generation Depth - 1
+const uint8_t       LORA_DATA_LAYOUT_DHT_SENSOR     = 0x01;     // Temperature, Humidity
+const uint8_t       LORA_DATA_LAYOUT_SR501_SENSOR   = 0x02;     // MotionActive, MotionActiveTime, MotionActiveCount
+const uint8_t       LORA_DATA_LAYOUT_ADC_LIGHT      = 0x04;     // LightLevel
+const uint8_t       LORA_DATA_LAYOUT_ADC_CAR_BATT   = 0x08;     // CarBattLevel
+const uint8_t       LORA_DATA_LAYOUT_SENSOR_MASK    = 0x0F;
+
+
+
 //---------------------------------------------------------------------------
 //  Definitions for LoRa Packets
 //---------------------------------------------------------------------------
+// Notice:  All records are defined as Byte Arrays, so their size and layout do not
+//          depend on Compiler, Word Size or Byte Order of the Target (no Bitfields,
+//          no multi-Byte members, alignment 1). The fields are accessed only via
+//          <LoraField<>> from <LoraPacketSchema.h>, the CRC16 via LoraGetCrc16()
+//          and LoraPutCrc16().
+//---------------------------------------------------------------------------
 
 // [Substructure Header of LoRa Bootup Packet]
 #pragma pack(push, 1)
 typedef struct
-{                                                       // ------------------+-----------+---------------------+-----------------
-                                                        // Value             | Size[Bit] | Data Range          | Value Range
-                                                        // ------------------+-----------+---------------------+-----------------
-    uint64_t        m_ui4PacketType         :  4;       // PacketType           4          <tLoraPacketType>     <kLoraPacketBootup>
-    uint64_t        m_ui4DevID              :  4;       // DevID                4          0..15                 0..15
-    uint64_t        m_ui8FirmwareVersion    :  8;       // FirmwareVersion      8          0..255                0..255
-    uint64_t        m_ui8FirmwareRevision   :  8;       // FirmwareRevision     8          0..255                0..255
-    uint64_t        m_ui16DataPackCycleTm   : 16;       // DataPacketCycleTm   16          0..65535              0..1092 [min]
-    uint64_t        m_ui1CfgOledDisplay     :  1;       // CfgOledDisplay       1          true | false          true | false
-    uint64_t        m_ui1CfgDhtSensor       :  1;       // CfgDhtSensor         1          true | false          true | false
-    uint64_t        m_ui1CfgSr501Sensor     :  1;       // CfgSr501Sensor       1          true | false          true | false
-    uint64_t        m_ui1CfgAdcLightSensor  :  1;       // CfgAdcLightSensor    1          true | false          true | false
-    uint64_t        m_ui1CfgAdcCarBatAin    :  1;       // CfgAdcCarBatAin      1          true | false          true | false
-    uint64_t        m_ui1CfgAsyncLoraEvent  :  1;       // CfgAsyncLoraEvent    1          true | false          true | false
-    uint64_t        m_ui1Sr501PauseOnLoraTx :  1;       // Sr501PauseOnLoraTx   1          true | false          true | false
-    uint64_t        m_ui1CommissioningMode  :  1;       // CommissioningMode    1          true | false          true | false
-    uint64_t        m_ui8LoraTxPower        :  8;       // LoRaTxPower          8          0..255                2..20 [dB]
-    uint64_t        m_ui8LoraSpreadFactor   :  8;       // LoRaSpreadingFactor  8          0..255                6..12
-    uint16_t        m_ui16CRC16;                        // CRC16               16
+{                                                       // ------+-------------------+-----------+---------------------+-----------------
+                                                        // Bit   | Value             | Size[Bit] | Data Range          | Value Range
+                                                        // ------+-------------------+-----------+---------------------+-----------------
+                                                        //  0.. 3  PacketType           4          <tLoraPacketType>     <kLoraPacketBootup>
+                                                        //  4.. 7  DevID                4          0..15                 0..15
+                                                        //  8..15  FirmwareVersion      8          0..255                0..255
+                                                        // 16..23  FirmwareRevision     8          0..255                0..255
+                                                        // 24..39  DataPacketCycleTm   16          0..65535              0..1092 [min]
+                                                        // 40..40  CfgOledDisplay       1          true | false          true | false
+                                                        // 41..41  CfgDhtSensor         1          true | false          true | false
+                                                        // 42..42  CfgSr501Sensor       1          true | false          true | false
+                                                        // 43..43  CfgAdcLightSensor    1          true | false          true | false
+                                                        // 44..44  CfgAdcCarBatAin      1          true | false          true | false
+                                                        // 45..45  CfgAsyncLoraEvent    1          true | false          true | false
+                                                        // 46..46  Sr501PauseOnLoraTx   1          true | false          true | false
+                                                        // 47..47  CommissioningMode    1          true | false          true | false
+                                                        // 48..55  LoRaTxPower          8          0..255                2..20 [dB]
+                                                        // 56..63  LoRaSpreadingFactor  8          0..255                6..12
+    uint8_t         m_abFields[8];                      // Fields above, little-endian Bit Stream (see <LoraPacketSchema.h>)
+    uint8_t         m_abCRC16[2];                       // CRC16 over <m_abFields>, little-endian
 
 } tLoraBootupHeader;
 #pragma pack(pop)
@@ -67,14 +105,15 @@ typedef struct
 // [Substructure Header of LoRa Data Packet]
 #pragma pack(push, 1)
 typedef struct
-{                                                       // ------------------+-----------+---------------------+-----------------
-                                                        // Value             | Size[Bit] | Data Range          | Value Range
-                                                        // ------------------+-----------+---------------------+-----------------
-    uint64_t        m_ui4PacketType         :  4;       // PacketType           4          <tLoraPacketType>     <kLoraPacketDataHeader>
-    uint64_t        m_ui4DevID              :  4;       // DevID                4          0..15                 0..15
-    uint64_t        m_ui24SequNum           : 24;       // SequNum             24          0..16777216           0..16777216
-    uint64_t        m_ui32Uptime            : 32;       // Uptime              32          0..4294967296 [sec]   0..136 [year]
-    uint16_t        m_ui16CRC16;                        // CRC16               16
+{                                                       // ------+-------------------+-----------+---------------------+-----------------
+                                                        // Bit   | Value             | Size[Bit] | Data Range          | Value Range
+                                                        // ------+-------------------+-----------+---------------------+-----------------
+                                                        //  0.. 3  PacketType           4          <tLoraPacketType>     <kLoraPacketDataHeader>
+                                                        //  4.. 7  DevID                4          0..15                 0..15
+                                                        //  8..31  SequNum             24          0..16777216           0..16777216
+                                                        // 32..63  Uptime              32          0..4294967296 [sec]   0..136 [year]
+    uint8_t         m_abFields[8];                      // Fields above, little-endian Bit Stream (see <LoraPacketSchema.h>)
+    uint8_t         m_abCRC16[2];                       // CRC16 over <m_abFields>, little-endian
 
 } tLoraDataHeader;
 #pragma pack(pop)
@@ -83,24 +122,56 @@ typedef struct
 // [Substructure Measurement Data of LoRa Data Packet]
 #pragma pack(push, 1)
 typedef struct
-{                                                       // ------------------+-----------+---------------------+-----------------
-                                                        // Value             | Size[Bit] | Data Range          | Value Range
-                                                        // ------------------+-----------+---------------------+-----------------
-    uint64_t        m_ui4PacketType         :  4;       // PacketType           4          <tLoraPacketType>     <kLoraPacketDataGen0/1/2>
-    uint64_t        m_ui12UptimeSnippet     : 12;       // UptimeSnippet       12          0..4095 [10 sec]      0..11 [h]
-    uint64_t        m_i8Temperature         :  8;       // Temperature          8          -128..127 [0.5 C]    -64.0..63.5 [C]
-    uint64_t        m_ui7Humidity           :  7;       // Humidity             7          0..127 [%]            0..100 [%]
-    uint64_t        m_ui1MotionActive       :  1;       // MotionActive         1          true | false          true | false
-    uint64_t        m_ui8MotionActiveTime   :  8;       // MotionActiveTime     8          0..255 [10 sec]       0..42 [min]
-    uint64_t        m_ui10MotionActiveCount : 10;       // MotionActiveCount   10          0..1023               0..1023
-    uint64_t        m_ui6LightLevel         :  6;       // LightLevel           6          0..63 [2 %]           0..100 [%]
-    uint64_t        m_ui8CarBattLevel       :  8;       // CarBattLevel         8          0..255 [0.1 V]        0..25.5 [V]
-    uint16_t        m_ui16CRC16;                        // CRC16               16
+{                                                       // ------+-------------------+-----------+---------------------+-----------------
+                                                        // Bit   | Value             | Size[Bit] | Data Range          | Value Range
+                                                        // ------+-------------------+-----------+---------------------+-----------------
+                                                        //  0.. 3  PacketType           4          <tLoraPacketType>     <kLoraPacketDataGen0/1/2>
+                                                        //  4..15  UptimeSnippet       12          0..4095 [10 sec]      0..11 [h]
+                                                        // 16..23  Temperature          8          -128..127 [0.5 C]    -64.0..63.5 [C]
+                                                        // 24..30  Humidity             7          0..127 [%]            0..100 [%]
+                                                        // 31..31  MotionActive         1          true | false          true | false
+                                                        // 32..39  MotionActiveTime     8          0..255 [10 sec]       0..42 [min]
+                                                        // 40..49  MotionActiveCount   10          0..1023               0..1023
+                                                        // 50..55  LightLevel           6          0..63 [2 %]           0..100 [%]
+                                                        // 56..63  CarBattLevel         8          0..255 [0.1 V]        0..25.5 [V]
+    uint8_t         m_abFields[8];                      // Fields above, little-endian Bit Stream (see <LoraPacketSchema.h>)
+    uint8_t         m_abCRC16[2];                       // CRC16 over <m_abFields>, little-endian
 
 } tLoraDataRec;
 #pragma pack(pop)
 
 
+// [Substructure Delta Measurement Data of LoRa Delta Data Packet]
+// Older generations Gen1..GenN are encoded relative to Gen0 of the same packet. Slowly
+// changing values (Temperature, Humidity) are transmitted as difference to Gen0, the
+// cumulative MotionActiveCount as increment since GenN, all other values as absolute
+// values. If a difference exceeds its value range, it is limited and <Clipped> is set.
+#pragma pack(push, 1)
+typedef struct
+{                                                       // ------+-------------------+-----------+---------------------+-----------------
+                                                        // Bit   | Value             | Size[Bit] | Data Range          | Value Range
+                                                        // ------+-------------------+-----------+---------------------+-----------------
+                                                        //  0..11  UptimeAge           12          0..4095 [10 sec]      0..11 [h]         (Gen0 - GenN)
+                                                        // 12..17  TemperatureDelta     6          -32..31 [0.5 C]      -16.0..15.5 [C]  (GenN - Gen0)
+                                                        // 18..23  HumidityDelta        6          -32..31 [%]           -32..31 [%]       (GenN - Gen0)
+                                                        // 24..24  MotionActive         1          true | false          true | false
+                                                        // 25..32  MotionActiveTime     8          0..255 [10 sec]       0..42 [min]
+                                                        // 33..40  MotionCountDelta     8          0..255                0..255            (Gen0 - GenN)
+                                                        // 41..46  LightLevel           6          0..63 [2 %]           0..100 [%]
+                                                        // 47..54  CarBattLevel         8          0..255 [0.1 V]        0..25.5 [V]
+                                                        // 55..55  Clipped              1          true | false          true | false
+    uint8_t         m_abFields[7];                      // Fields above, little-endian Bit Stream (see <LoraPacketSchema.h>)
+
+} tLoraDataDeltaRec;
+#pragma pack(pop)
+
+
+static_assert(sizeof(tLoraBootupHeader) == 10, "unexpected size of <tLoraBootupHeader>");
+static_assert(sizeof(tLoraDataHeader)   == 10, "unexpected size of <tLoraDataHeader>");
+static_assert(sizeof(tLoraDataRec)      == 10, "unexpected size of <tLoraDataRec>");
+static_assert(sizeof(tLoraDataDeltaRec) ==  7, "unexpected size of <tLoraDataDeltaRec>");
+
+
 
 
 
@@ -130,6 +201,98 @@ typedef struct
 } tLoraDataPacket;
 #pragma pack(pop)
 
+static_assert(sizeof(tLoraDataPacket) == 40, "unexpected size of <tLoraDataPacket>");
+
+
+
+
+
+//---------------------------------------------------------------------------
+// LoRa Delta Data Packet (Over-the-Air Data Packet with variable Length)
+//---------------------------------------------------------------------------
+// Notice:  The Delta Data Packet carries Gen0 as complete <tLoraDataRec>, followed by
+//          up to (LORA_DATA_GEN_DEPTH_MAX-1) older generations as <tLoraDataDeltaRec>.
+//          Only the used DeltaRecords are transmitted, so the generation depth is
+//          derived from the packet length (see LORA_DATA_DELTA_PACKET_SIZE).
+//          The packet type <kLoraPacketDataHeaderDelta> in the header distinguishes
+//          the Delta Data Packet from the classic <tLoraDataPacket>, whose length of
+//          40 Bytes is never reached by a Delta Data Packet (22 + n*7).
+//
+//          DataPacket:     Header   -> tLoraDataHeader (kLoraPacketDataHeaderDelta)
+//                          DataRec  -> tLoraDataRec (Gen0)
+//                          CRC16    -> CRC16 over all transmitted DeltaRecords
+//                          DeltaRec -> tLoraDataDeltaRec[0..15] (Gen1..GenN)
+//---------------------------------------------------------------------------
+#pragma pack(push, 1)
+typedef struct
+{                                                       // -------------------------+-----------+--------------------------------
+                                                        // Element                  | Size[Bit] | Content
+                                                        // -------------------------+-----------+--------------------------------
+    tLoraDataHeader     m_LoraHeader;                   // tLoraDataHeader                80      kLoraPacketDataHeaderDelta
+    tLoraDataRec        m_LoraDataRecGen0;              // tLoraDataRec                   80      kLoraPacketDataGen0
+    uint8_t             m_abDeltaCRC16[2];              // CRC16                          16      CRC16 over DeltaRec[0..n-1], little-endian
+    tLoraDataDeltaRec   m_aLoraDeltaRec[LORA_DATA_GEN_DEPTH_MAX-1];     // n*56           Gen1..GenN
+
+} tLoraDataDeltaPacket;
+#pragma pack(pop)
+
+#define LORA_DATA_DELTA_PACKET_SIZE(GenDepth)   ((sizeof(tLoraDataHeader) + sizeof(tLoraDataRec) + 2) + (((GenDepth) - 1) * sizeof(tLoraDataDeltaRec)))
+
+
+
+
+
+//---------------------------------------------------------------------------
+// LoRa Compact Data Packet (Over-the-Air Data Packet with Sensor dependent Length)
+//---------------------------------------------------------------------------
+// Notice:  The Compact Data Packet carries the same generations as the Delta Data
+//          Packet, but only the values of the sensors present in the device. The
+//          values are written without gaps as a little-endian Bit Stream (LSB first)
+//          in the order of the fields of <tLoraDataRec> / <tLoraDataDeltaRec>, the
+//          PacketType of the DataRecords and the CRC16 of Gen0 are omitted:
+//
+//          Gen0:      UptimeSnippet(12) [Temperature(8) Humidity(7)]
+//                     [MotionActive(1) MotionActiveTime(8) MotionActiveCount(10)]
+//                     [LightLevel(6)] [CarBattLevel(8)]
+//          Gen1..GenN: UptimeAge(12) [TemperatureDelta(6) HumidityDelta(6)]
+//                     [MotionActive(1) MotionActiveTime(8) MotionCountDelta(8)]
+//                     [LightLevel(6)] [CarBattLevel(8)] Clipped(1)
+//
+//          The Layout Byte makes the packet self-describing, so the receiver does
+//          not depend on a previously received Bootup Packet. The Bit Stream is
+//          padded to whole Bytes and followed by a CRC16 (little-endian) over the
+//          Layout Byte and the Bit Stream.
+//
+//          DataPacket:     Header    -> tLoraDataHeader (kLoraPacketDataHeaderCompact)
+//                          Layout    -> Sensors and Generation Depth
+//                          RecStream -> Gen0, Gen1..GenN, CRC16
+//---------------------------------------------------------------------------
+
+#define LORA_DATA_COMPACT_GEN0_BITS(Layout)     (12 + (((Layout) & LORA_DATA_LAYOUT_DHT_SENSOR)   ? (8 + 7)      : 0) + \
+                                                      (((Layout) & LORA_DATA_LAYOUT_SR501_SENSOR) ? (1 + 8 + 10) : 0) + \
+                                                      (((Layout) & LORA_DATA_LAYOUT_ADC_LIGHT)    ? 6            : 0) + \
+                                                      (((Layout) & LORA_DATA_LAYOUT_ADC_CAR_BATT) ? 8            : 0))
+
+#define LORA_DATA_COMPACT_DELTA_BITS(Layout)    (12 + (((Layout) & LORA_DATA_LAYOUT_DHT_SENSOR)   ? (6 + 6)      : 0) + \
+                                                      (((Layout) & LORA_DATA_LAYOUT_SR501_SENSOR) ? (1 + 8 + 8)  : 0) + \
+                                                      (((Layout) & LORA_DATA_LAYOUT_ADC_LIGHT)    ? 6            : 0) + \
+                                                      (((Layout) & LORA_DATA_LAYOUT_ADC_CAR_BATT) ? 8            : 0) + 1)
+
+#define LORA_DATA_COMPACT_STREAM_SIZE(Layout, GenDepth)     ((LORA_DATA_COMPACT_GEN0_BITS(Layout) + (((GenDepth) - 1) * LORA_DATA_COMPACT_DELTA_BITS(Layout)) + 7) / 8)
+#define LORA_DATA_COMPACT_PACKET_SIZE(Layout, GenDepth)     (sizeof(tLoraDataHeader) + sizeof(uint8_t) + LORA_DATA_COMPACT_STREAM_SIZE(Layout, GenDepth) + sizeof(uint16_t))
+
+#pragma pack(push, 1)
+typedef struct
+{                                                       // -------------------------+-----------+--------------------------------
+                                                        // Element                  | Size[Bit] | Content
+                                                        // -------------------------+-----------+--------------------------------
+    tLoraDataHeader     m_LoraHeader;                   // tLoraDataHeader                80      kLoraPacketDataHeaderCompact
+    uint8_t             m_ui8Layout;                    // Layout                          8      Sensors | (GenDepth-1) << 4
+    uint8_t             m_abRecStream[LORA_DATA_COMPACT_STREAM_SIZE(LORA_DATA_LAYOUT_SENSOR_MASK, LORA_DATA_GEN_DEPTH_MAX) + sizeof(uint16_t)];  // Gen0..GenN, CRC16
+
+} tLoraDataCompactPacket;
+#pragma pack(pop)
+
 
 
 
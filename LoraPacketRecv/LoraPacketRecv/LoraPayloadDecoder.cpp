@@ -10,6 +10,10 @@
   Revision History:
 
   2023/03/25 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Decoding of Delta Data Packet with variable Generation Depth
+  2026/10/18 -rs:   V1.02 Decoding of Compact Data Packet with Sensor dependent Layout
+  2026/10/18 -rs:   V1.03 Field access and scaling generated from <LoraPacketSchema.h>
+  2026/10/18 -rs:   V1.04 CRC16 read byte-wise (independent of Byte Order)
 
 ****************************************************************************/
 
@@ -23,6 +27,7 @@
 #endif
 
 #include "LoraPacket.h"
+#include "LoraPacketSchema.h"
 #include "LoraPayloadDecoder.h"
 #include <string.h>
 #include <stdarg.h>
@@ -108,7 +113,7 @@ tLoraPacketType  PacketType;
         return (kLoraPacketUnused);
     }
 
-    PacketType = (tLoraPacketType)(pLoraPacket_p->m_LoraHeader.m_ui4PacketType & 0x0F);
+    PacketType = (tLoraPacketType)LoraDataHeaderField<kLoraHeaderPacketType>::Get(&pLoraPacket_p->m_LoraHeader);
 
     return (PacketType);
 
@@ -131,7 +136,7 @@ int  iLoraDevID;
         return (-1);
     }
 
-    iLoraDevID = (int)(pLoraPacket_p->m_LoraHeader.m_ui4DevID & 0x0F);
+    iLoraDevID = (int)LoraDataHeaderField<kLoraHeaderDevID>::Get(&pLoraPacket_p->m_LoraHeader);
 
     return (iLoraDevID);
 
@@ -163,7 +168,7 @@ uint16_t            ui16CrcSum;
 
     // decode Bootup
     ui16CrcSum = CalcCrc16(pLoraBootupHeader, (64/8));
-    if (ui16CrcSum == pLoraBootupHeader->m_ui16CRC16)
+    if (ui16CrcSum == LoraGetCrc16(pLoraBootupHeader->m_abCRC16))
     {
         m_LoraStationBootup.m_DataStatus = kStatusValid;
     }
@@ -171,21 +176,22 @@ uint16_t            ui16CrcSum;
     {
         m_LoraStationBootup.m_DataStatus = kStatusCrcError;
     }
-    m_LoraStationBootup.m_PacketType          = (tLoraPacketType)(pLoraBootupHeader->m_ui4PacketType & 0x0F);
-    m_LoraStationBootup.m_ui8DevID            = (pLoraBootupHeader->m_ui4DevID & 0x0F);
-    m_LoraStationBootup.m_ui8FirmwareVersion  = pLoraBootupHeader->m_ui8FirmwareVersion;
-    m_LoraStationBootup.m_ui8FirmwareRevision = pLoraBootupHeader->m_ui8FirmwareRevision;
-    m_LoraStationBootup.m_ui16DataPackCycleTm = pLoraBootupHeader->m_ui16DataPackCycleTm;
-    m_LoraStationBootup.m_fCfgOledDisplay     = (bool)pLoraBootupHeader->m_ui1CfgOledDisplay;
-    m_LoraStationBootup.m_fCfgDhtSensor       = (bool)pLoraBootupHeader->m_ui1CfgDhtSensor;
-    m_LoraStationBootup.m_fCfgSr501Sensor     = (bool)pLoraBootupHeader->m_ui1CfgSr501Sensor;
-    m_LoraStationBootup.m_fCfgAdcLightSensor  = (bool)pLoraBootupHeader->m_ui1CfgAdcLightSensor;
-    m_LoraStationBootup.m_fCfgAdcCarBatAin    = (bool)pLoraBootupHeader->m_ui1CfgAdcCarBatAin;
-    m_LoraStationBootup.m_fCfgAsyncLoraEvent  = (bool)pLoraBootupHeader->m_ui1CfgAsyncLoraEvent;
-    m_LoraStationBootup.m_fSr501PauseOnLoraTx = (bool)pLoraBootupHeader->m_ui1Sr501PauseOnLoraTx;
-    m_LoraStationBootup.m_fCommissioningMode  = (bool)pLoraBootupHeader->m_ui1CommissioningMode;
-    m_LoraStationBootup.m_ui8LoraTxPower      = pLoraBootupHeader->m_ui8LoraTxPower;
-    m_LoraStationBootup.m_ui8LoraSpreadFactor = pLoraBootupHeader->m_ui8LoraSpreadFactor;
+    m_LoraStationBootup.m_LoraBootupHeader    = *pLoraBootupHeader;
+    m_LoraStationBootup.m_PacketType          = (tLoraPacketType)LoraBootupHeaderField<kLoraBootupPacketType>::Get(pLoraBootupHeader);
+    m_LoraStationBootup.m_ui8DevID            = (uint8_t) LoraBootupHeaderField<kLoraBootupDevID             >::GetInt(pLoraBootupHeader);
+    m_LoraStationBootup.m_ui8FirmwareVersion  = (uint8_t) LoraBootupHeaderField<kLoraBootupFirmwareVersion   >::GetInt(pLoraBootupHeader);
+    m_LoraStationBootup.m_ui8FirmwareRevision = (uint8_t) LoraBootupHeaderField<kLoraBootupFirmwareRevision  >::GetInt(pLoraBootupHeader);
+    m_LoraStationBootup.m_ui16DataPackCycleTm = (uint16_t)LoraBootupHeaderField<kLoraBootupDataPackCycleTm   >::GetInt(pLoraBootupHeader);
+    m_LoraStationBootup.m_fCfgOledDisplay     = (bool)    LoraBootupHeaderField<kLoraBootupCfgOledDisplay    >::GetInt(pLoraBootupHeader);
+    m_LoraStationBootup.m_fCfgDhtSensor       = (bool)    LoraBootupHeaderField<kLoraBootupCfgDhtSensor      >::GetInt(pLoraBootupHeader);
+    m_LoraStationBootup.m_fCfgSr501Sensor     = (bool)    LoraBootupHeaderField<kLoraBootupCfgSr501Sensor    >::GetInt(pLoraBootupHeader);
+    m_LoraStationBootup.m_fCfgAdcLightSensor  = (bool)    LoraBootupHeaderField<kLoraBootupCfgAdcLightSensor >::GetInt(pLoraBootupHeader);
+    m_LoraStationBootup.m_fCfgAdcCarBatAin    = (bool)    LoraBootupHeaderField<kLoraBootupCfgAdcCarBatAin   >::GetInt(pLoraBootupHeader);
+    m_LoraStationBootup.m_fCfgAsyncLoraEvent  = (bool)    LoraBootupHeaderField<kLoraBootupCfgAsyncLoraEvent >::GetInt(pLoraBootupHeader);
+    m_LoraStationBootup.m_fSr501PauseOnLoraTx = (bool)    LoraBootupHeaderField<kLoraBootupSr501PauseOnLoraTx>::GetInt(pLoraBootupHeader);
+    m_LoraStationBootup.m_fCommissioningMode  = (bool)    LoraBootupHeaderField<kLoraBootupCommissioningMode >::GetInt(pLoraBootupHeader);
+    m_LoraStationBootup.m_ui8LoraTxPower      = (uint8_t) LoraBootupHeaderField<kLoraBootupLoraTxPower       >::GetInt(pLoraBootupHeader);
+    m_LoraStationBootup.m_ui8LoraSpreadFactor = (uint8_t) LoraBootupHeaderField<kLoraBootupLoraSpreadFactor  >::GetInt(pLoraBootupHeader);
 
     return (m_LoraStationBootup);
 
@@ -200,8 +206,7 @@ uint16_t            ui16CrcSum;
 LoraPayloadDecoder::tLoraStationData  LoraPayloadDecoder::DecodeRxDataPacket (const tLoraDataPacket* pLoraPacket_p)
 {
 
-uint16_t  ui16CrcSum;
-int       nIdx;
+int  nIdx;
 
 
     // clear data packet
@@ -213,48 +218,204 @@ int       nIdx;
     }
 
     // decode Header
-    ui16CrcSum = CalcCrc16(&(pLoraPacket_p->m_LoraHeader), (64/8));
-    if (ui16CrcSum == pLoraPacket_p->m_LoraHeader.m_ui16CRC16)
+    DecodeDataHeader(&(pLoraPacket_p->m_LoraHeader), &m_LoraStationData.m_DataHeader);
+
+    // decode DataRecords
+    m_LoraStationData.m_uiNumDataRec = (sizeof(pLoraPacket_p->m_aLoraDataRec)/sizeof(tLoraDataRec));
+    m_LoraStationData.m_ui8SensorLayout = LORA_DATA_LAYOUT_SENSOR_MASK;
+    for (nIdx=0; nIdx<(int)m_LoraStationData.m_uiNumDataRec; nIdx++)
     {
-        m_LoraStationData.m_DataHeader.m_DataStatus = kStatusValid;
+        DecodeDataRec(&(pLoraPacket_p->m_aLoraDataRec[nIdx]), &m_LoraStationData.m_aDataRec[nIdx]);
     }
-    else
+
+    return (m_LoraStationData);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  DecodeRxDataDeltaPacket
+//---------------------------------------------------------------------------
+
+LoraPayloadDecoder::tLoraStationData  LoraPayloadDecoder::DecodeRxDataDeltaPacket (const tLoraDataDeltaPacket* pLoraPacket_p, unsigned int uiPacketSize_p)
+{
+
+const tLoraDataRec*       pGen0;
+const tLoraDataDeltaRec*  pDeltaRec;
+tDataStatus               DeltaStatus;
+uint16_t                  ui16CrcSum;
+unsigned int              uiNumDeltaRec;
+unsigned int              uiIdx;
+
+
+    // clear data packet
+    memset(&m_LoraStationData, 0x00, sizeof(m_LoraStationData));
+
+    if ( (pLoraPacket_p == NULL) ||
+         (uiPacketSize_p < LORA_DATA_DELTA_PACKET_SIZE(1)) ||
+         (uiPacketSize_p > LORA_DATA_DELTA_PACKET_SIZE(LORA_DATA_GEN_DEPTH_MAX)) ||
+         (((uiPacketSize_p - LORA_DATA_DELTA_PACKET_SIZE(1)) % sizeof(tLoraDataDeltaRec)) != 0) )
     {
+        // the generation depth is derived from the packet length, so a length that
+        // does not match a whole number of DeltaRecords means a corrupt packet
         m_LoraStationData.m_DataHeader.m_DataStatus = kStatusCrcError;
+        return (m_LoraStationData);
     }
-    m_LoraStationData.m_DataHeader.m_PacketType  = (tLoraPacketType)(pLoraPacket_p->m_LoraHeader.m_ui4PacketType & 0x0F);
-    m_LoraStationData.m_DataHeader.m_ui8DevID    = (pLoraPacket_p->m_LoraHeader.m_ui4DevID & 0x0F);
-    m_LoraStationData.m_DataHeader.m_ui32SequNum = (pLoraPacket_p->m_LoraHeader.m_ui24SequNum & 0x00FFFFFF);
-    m_LoraStationData.m_DataHeader.m_ui32Uptime  = (pLoraPacket_p->m_LoraHeader.m_ui32Uptime & 0xFFFFFFFF);
+    uiNumDeltaRec = (uiPacketSize_p - LORA_DATA_DELTA_PACKET_SIZE(1)) / sizeof(tLoraDataDeltaRec);
 
-    // decode DataRecords
-    for (nIdx=0; nIdx<(sizeof(m_LoraStationData.m_aDataRec)/sizeof(tDataRec)); nIdx++)
+    // decode Header
+    DecodeDataHeader(&(pLoraPacket_p->m_LoraHeader), &m_LoraStationData.m_DataHeader);
+
+    // decode Gen0 (complete DataRecord)
+    pGen0 = &(pLoraPacket_p->m_LoraDataRecGen0);
+    m_LoraStationData.m_uiNumDataRec = 1 + uiNumDeltaRec;
+    m_LoraStationData.m_ui8SensorLayout = LORA_DATA_LAYOUT_SENSOR_MASK;
+    DecodeDataRec(pGen0, &m_LoraStationData.m_aDataRec[0]);
+
+    // DeltaRecords can only be reconstructed with an intact Gen0
+    DeltaStatus = kStatusValid;
+    ui16CrcSum = CalcCrc16(pLoraPacket_p->m_aLoraDeltaRec, (uiNumDeltaRec * sizeof(tLoraDataDeltaRec)));
+    if ( (ui16CrcSum != LoraGetCrc16(pLoraPacket_p->m_abDeltaCRC16)) ||
+         (m_LoraStationData.m_aDataRec[0].m_DataStatus != kStatusValid) )
     {
-        if ( IsCleared(&(pLoraPacket_p->m_aLoraDataRec[nIdx]), (64/8)) )
+        DeltaStatus = kStatusCrcError;
+    }
+
+    // decode Gen1..GenN (DeltaRecords relative to Gen0)
+    for (uiIdx=1; uiIdx<=uiNumDeltaRec; uiIdx++)
+    {
+        pDeltaRec = &(pLoraPacket_p->m_aLoraDeltaRec[uiIdx-1]);
+
+        m_LoraStationData.m_aDataRec[uiIdx].m_DataStatus = DeltaStatus;
+        if ((DeltaStatus == kStatusValid) && LoraDeltaRecField<kLoraDeltaRecClipped>::Get(pDeltaRec))
         {
-            m_LoraStationData.m_aDataRec[nIdx].m_DataStatus = kStatusUnused;
+            m_LoraStationData.m_aDataRec[uiIdx].m_DataStatus = kStatusClipped;
         }
-        else
+        DecodeDeltaRec(pGen0, pDeltaRec, uiIdx, &m_LoraStationData.m_aDataRec[uiIdx]);
+    }
+
+    return (m_LoraStationData);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  DecodeRxDataCompactPacket
+//---------------------------------------------------------------------------
+
+LoraPayloadDecoder::tLoraStationData  LoraPayloadDecoder::DecodeRxDataCompactPacket (const tLoraDataCompactPacket* pLoraPacket_p, unsigned int uiPacketSize_p)
+{
+
+const uint8_t*     pabStream;
+tLoraDataRec       LoraGen0;
+tLoraDataDeltaRec  LoraDeltaRec;
+tDataStatus        StreamStatus;
+uint8_t            ui8SensorLayout;
+uint16_t           ui16CrcSum;
+unsigned int       uiNumGen;
+unsigned int       uiStreamSize;
+unsigned int       uiBitPos;
+unsigned int       uiIdx;
+
+
+    // clear data packet
+    memset(&m_LoraStationData, 0x00, sizeof(m_LoraStationData));
+
+    // the Layout Byte determines the packet length, a different length means a corrupt packet
+    if ( (pLoraPacket_p == NULL) ||
+         (uiPacketSize_p < LORA_DATA_COMPACT_PACKET_SIZE(0, 1)) )
+    {
+        m_LoraStationData.m_DataHeader.m_DataStatus = kStatusCrcError;
+        return (m_LoraStationData);
+    }
+    ui8SensorLayout = (pLoraPacket_p->m_ui8Layout & LORA_DATA_LAYOUT_SENSOR_MASK);
+    uiNumGen        = (pLoraPacket_p->m_ui8Layout >> 4) + 1;
+    if (uiPacketSize_p != LORA_DATA_COMPACT_PACKET_SIZE(ui8SensorLayout, uiNumGen))
+    {
+        m_LoraStationData.m_DataHeader.m_DataStatus = kStatusCrcError;
+        return (m_LoraStationData);
+    }
+    uiStreamSize = LORA_DATA_COMPACT_STREAM_SIZE(ui8SensorLayout, uiNumGen);
+
+    // decode Header
+    DecodeDataHeader(&(pLoraPacket_p->m_LoraHeader), &m_LoraStationData.m_DataHeader);
+
+    // one CRC16 protects Layout Byte and all DataRecords
+    pabStream = pLoraPacket_p->m_abRecStream;
+    ui16CrcSum = CalcCrc16(&(pLoraPacket_p->m_ui8Layout), (sizeof(uint8_t) + uiStreamSize));
+    if (ui16CrcSum == LoraGetCrc16(&pabStream[uiStreamSize]))
+    {
+        StreamStatus = kStatusValid;
+    }
+    else
+    {
+        StreamStatus = kStatusCrcError;
+    }
+
+    m_LoraStationData.m_uiNumDataRec = uiNumGen;
+    m_LoraStationData.m_ui8SensorLayout = ui8SensorLayout;
+
+    // decode Gen0 (values of missing sensors remain 0)
+    uiBitPos = 0;
+    memset(&LoraGen0, 0x00, sizeof(LoraGen0));
+    LoraDataRecField<kLoraDataRecPacketType>::Put(&LoraGen0, kLoraPacketDataGen0);
+    GetField< LoraDataRecField<kLoraDataRecUptimeSnippet> >(pabStream, &uiBitPos, &LoraGen0);
+    if (ui8SensorLayout & LORA_DATA_LAYOUT_DHT_SENSOR)
+    {
+        GetField< LoraDataRecField<kLoraDataRecTemperature      > >(pabStream, &uiBitPos, &LoraGen0);
+        GetField< LoraDataRecField<kLoraDataRecHumidity         > >(pabStream, &uiBitPos, &LoraGen0);
+    }
+    if (ui8SensorLayout & LORA_DATA_LAYOUT_SR501_SENSOR)
+    {
+        GetField< LoraDataRecField<kLoraDataRecMotionActive     > >(pabStream, &uiBitPos, &LoraGen0);
+        GetField< LoraDataRecField<kLoraDataRecMotionActiveTime > >(pabStream, &uiBitPos, &LoraGen0);
+        GetField< LoraDataRecField<kLoraDataRecMotionActiveCount> >(pabStream, &uiBitPos, &LoraGen0);
+    }
+    if (ui8SensorLayout & LORA_DATA_LAYOUT_ADC_LIGHT)
+    {
+        GetField< LoraDataRecField<kLoraDataRecLightLevel       > >(pabStream, &uiBitPos, &LoraGen0);
+    }
+    if (ui8SensorLayout & LORA_DATA_LAYOUT_ADC_CAR_BATT)
+    {
+        GetField< LoraDataRecField<kLoraDataRecCarBattLevel     > >(pabStream, &uiBitPos, &LoraGen0);
+    }
+    m_LoraStationData.m_aDataRec[0].m_DataStatus = StreamStatus;
+    DecodeDataRecValues(&LoraGen0, &m_LoraStationData.m_aDataRec[0]);
+
+    // decode Gen1..GenN (DeltaRecords relative to Gen0)
+    for (uiIdx=1; uiIdx<uiNumGen; uiIdx++)
+    {
+        memset(&LoraDeltaRec, 0x00, sizeof(LoraDeltaRec));
+        GetField< LoraDeltaRecField<kLoraDeltaRecUptimeAge> >(pabStream, &uiBitPos, &LoraDeltaRec);
+        if (ui8SensorLayout & LORA_DATA_LAYOUT_DHT_SENSOR)
         {
-            ui16CrcSum = CalcCrc16(&(pLoraPacket_p->m_aLoraDataRec[nIdx]), (64/8));
-            if (ui16CrcSum == pLoraPacket_p->m_aLoraDataRec[nIdx].m_ui16CRC16)
-            {
-                m_LoraStationData.m_aDataRec[nIdx].m_DataStatus = kStatusValid;
-            }
-            else
-            {
-                m_LoraStationData.m_aDataRec[nIdx].m_DataStatus = kStatusCrcError;
-            }
-            m_LoraStationData.m_aDataRec[nIdx].m_PacketType            = (tLoraPacketType)(pLoraPacket_p->m_aLoraDataRec[nIdx].m_ui4PacketType & 0x0F);
-            m_LoraStationData.m_aDataRec[nIdx].m_ui12UptimeSnippet     = (pLoraPacket_p->m_aLoraDataRec[nIdx].m_ui12UptimeSnippet & 0x0FFF) * 10;
-            m_LoraStationData.m_aDataRec[nIdx].m_flTemperature         = I8ToFloat(pLoraPacket_p->m_aLoraDataRec[nIdx].m_i8Temperature & 0xFF) / 2;
-            m_LoraStationData.m_aDataRec[nIdx].m_flHumidity            = UI7ToFloat(pLoraPacket_p->m_aLoraDataRec[nIdx].m_ui7Humidity & 0x7F);
-            m_LoraStationData.m_aDataRec[nIdx].m_fMotionActive         = (pLoraPacket_p->m_aLoraDataRec[nIdx].m_ui1MotionActive ? true : false);
-            m_LoraStationData.m_aDataRec[nIdx].m_ui16MotionActiveTime  = (pLoraPacket_p->m_aLoraDataRec[nIdx].m_ui8MotionActiveTime & 0xFF) * 10;
-            m_LoraStationData.m_aDataRec[nIdx].m_ui16MotionActiveCount = (pLoraPacket_p->m_aLoraDataRec[nIdx].m_ui10MotionActiveCount & 0x03FF);
-            m_LoraStationData.m_aDataRec[nIdx].m_ui8LightLevel         = (pLoraPacket_p->m_aLoraDataRec[nIdx].m_ui6LightLevel & 0x3F) * 2;
-            m_LoraStationData.m_aDataRec[nIdx].m_flCarBattLevel        = UI8ToFloat(pLoraPacket_p->m_aLoraDataRec[nIdx].m_ui8CarBattLevel & 0xFF) / 10.0f;
+            GetField< LoraDeltaRecField<kLoraDeltaRecTemperatureDelta> >(pabStream, &uiBitPos, &LoraDeltaRec);
+            GetField< LoraDeltaRecField<kLoraDeltaRecHumidityDelta   > >(pabStream, &uiBitPos, &LoraDeltaRec);
+        }
+        if (ui8SensorLayout & LORA_DATA_LAYOUT_SR501_SENSOR)
+        {
+            GetField< LoraDeltaRecField<kLoraDeltaRecMotionActive    > >(pabStream, &uiBitPos, &LoraDeltaRec);
+            GetField< LoraDeltaRecField<kLoraDeltaRecMotionActiveTime> >(pabStream, &uiBitPos, &LoraDeltaRec);
+            GetField< LoraDeltaRecField<kLoraDeltaRecMotionCountDelta> >(pabStream, &uiBitPos, &LoraDeltaRec);
+        }
+        if (ui8SensorLayout & LORA_DATA_LAYOUT_ADC_LIGHT)
+        {
+            GetField< LoraDeltaRecField<kLoraDeltaRecLightLevel      > >(pabStream, &uiBitPos, &LoraDeltaRec);
+        }
+        if (ui8SensorLayout & LORA_DATA_LAYOUT_ADC_CAR_BATT)
+        {
+            GetField< LoraDeltaRecField<kLoraDeltaRecCarBattLevel    > >(pabStream, &uiBitPos, &LoraDeltaRec);
+        }
+        GetField< LoraDeltaRecField<kLoraDeltaRecClipped> >(pabStream, &uiBitPos, &LoraDeltaRec);
+
+        m_LoraStationData.m_aDataRec[uiIdx].m_DataStatus = StreamStatus;
+        if ((StreamStatus == kStatusValid) && LoraDeltaRecField<kLoraDeltaRecClipped>::Get(&LoraDeltaRec))
+        {
+            m_LoraStationData.m_aDataRec[uiIdx].m_DataStatus = kStatusClipped;
         }
+        DecodeDeltaRec(&LoraGen0, &LoraDeltaRec, uiIdx, &m_LoraStationData.m_aDataRec[uiIdx]);
     }
 
     return (m_LoraStationData);
@@ -367,6 +528,8 @@ int     nIdx;
         case kLoraPacketDataGen0:       LogStr(szLogBuff, sizeof(szLogBuff), "kLoraPacketDataGen0");        break;
         case kLoraPacketDataGen1:       LogStr(szLogBuff, sizeof(szLogBuff), "kLoraPacketDataGen1");        break;
         case kLoraPacketDataGen2:       LogStr(szLogBuff, sizeof(szLogBuff), "kLoraPacketDataGen2");        break;
+        case kLoraPacketDataHeaderDelta:    LogStr(szLogBuff, sizeof(szLogBuff), "kLoraPacketDataHeaderDelta"); break;
+        case kLoraPacketDataHeaderCompact:  LogStr(szLogBuff, sizeof(szLogBuff), "kLoraPacketDataHeaderCompact"); break;
         default:                        LogStr(szLogBuff, sizeof(szLogBuff), "???");                        break;
     }
     LogStr(szLogBuff, sizeof(szLogBuff), "\n");
@@ -376,10 +539,14 @@ int     nIdx;
     nUsedBuffLen = strlen(szLogBuff);
     FormatUptime(pLoraStationData_p->m_DataHeader.m_ui32Uptime, (szLogBuff + nUsedBuffLen), (sizeof(szLogBuff) - nUsedBuffLen), true, true);
     LogStr(szLogBuff, sizeof(szLogBuff), "\n");
+    if (pLoraStationData_p->m_DataHeader.m_PacketType == kLoraPacketDataHeaderCompact)
+    {
+        LogStr(szLogBuff, sizeof(szLogBuff), "  Sensor Layout:          0x%02X\n", (unsigned int)pLoraStationData_p->m_ui8SensorLayout);
+    }
 
     // decode DataRecords
     LogStr(szLogBuff, sizeof(szLogBuff), " *DataRecords*\n");
-    for (nIdx=0; nIdx<(sizeof(pLoraStationData_p->m_aDataRec)/sizeof(tDataRec)); nIdx++)
+    for (nIdx=0; nIdx<(int)pLoraStationData_p->m_uiNumDataRec; nIdx++)
     {
         LogStr(szLogBuff, sizeof(szLogBuff), "  DataRecord[%d]:\n",                   nIdx);
         LogStr(szLogBuff, sizeof(szLogBuff), "   DataStatus:            ");
@@ -388,6 +555,7 @@ int     nIdx;
             case kStatusUnused:             LogStr(szLogBuff, sizeof(szLogBuff), "kStatusUnused");          break;
             case kStatusCrcError:           LogStr(szLogBuff, sizeof(szLogBuff), "kStatusCrcError");        break;
             case kStatusValid:              LogStr(szLogBuff, sizeof(szLogBuff), "kStatusValid");           break;
+            case kStatusClipped:            LogStr(szLogBuff, sizeof(szLogBuff), "kStatusClipped");         break;
             default:                        LogStr(szLogBuff, sizeof(szLogBuff), "???");                    break;
         }
         LogStr(szLogBuff, sizeof(szLogBuff), "\n");
@@ -400,6 +568,7 @@ int     nIdx;
             case kLoraPacketDataGen0:       LogStr(szLogBuff, sizeof(szLogBuff), "kLoraPacketDataGen0");    break;
             case kLoraPacketDataGen1:       LogStr(szLogBuff, sizeof(szLogBuff), "kLoraPacketDataGen1");    break;
             case kLoraPacketDataGen2:       LogStr(szLogBuff, sizeof(szLogBuff), "kLoraPacketDataGen2");    break;
+            case kLoraPacketDataGenN:       LogStr(szLogBuff, sizeof(szLogBuff), "kLoraPacketDataGenN");    break;
             default:                        LogStr(szLogBuff, sizeof(szLogBuff), "???");                    break;
         }
         LogStr(szLogBuff, sizeof(szLogBuff), "\n");
@@ -430,134 +599,168 @@ int     nIdx;
 /////////////////////////////////////////////////////////////////////////////
 
 //---------------------------------------------------------------------------
-//  Private: I7ToFloat
+//  Private: DecodeDataHeader
 //---------------------------------------------------------------------------
 
-float  LoraPayloadDecoder::I7ToFloat (int8_t i8DataValue_p)
+void  LoraPayloadDecoder::DecodeDataHeader (const tLoraDataHeader* pLoraDataHeader_p, tDataHeader* pDataHeader_p)
 {
 
-int    iDataValue;
-float  flDataValue;
-
+uint16_t  ui16CrcSum;
 
-    //   B7  B6  B5  B4  B3  B2  B1  B0
-    // +---+---+---+---+---+---+---+---+
-    // | - | S |     -63 ... +63       |
-    // +---+---+---+---+---+---+---+---+
-    //
-    //       0   1   1   1   1   1   1      +63
-    //                ...
-    //       0   0   0   0   0   0   1       +1
-    //       0   0   0   0   0   0   0        0
-    //       1   1   1   1   1   1   1       -1
-    //                ...
-    //       1   0   0   0   0   0   1      -63
 
-    iDataValue = (int)(i8DataValue_p & 0x7F);       // mask B5..B0
-    if ( (iDataValue & 0x40) )                      // extend negative values
+    ui16CrcSum = CalcCrc16(pLoraDataHeader_p, (64/8));
+    if (ui16CrcSum == LoraGetCrc16(pLoraDataHeader_p->m_abCRC16))
     {
-        iDataValue |= 0xFFFFFF80;
+        pDataHeader_p->m_DataStatus = kStatusValid;
     }
-    flDataValue = (float)iDataValue;                // int -> float
+    else
+    {
+        pDataHeader_p->m_DataStatus = kStatusCrcError;
+    }
+    pDataHeader_p->m_PacketType  = (tLoraPacketType)LoraDataHeaderField<kLoraHeaderPacketType>::Get(pLoraDataHeader_p);
+    pDataHeader_p->m_ui8DevID    = (uint8_t) LoraDataHeaderField<kLoraHeaderDevID  >::GetInt(pLoraDataHeader_p);
+    pDataHeader_p->m_ui32SequNum = (uint32_t)LoraDataHeaderField<kLoraHeaderSequNum>::GetInt(pLoraDataHeader_p);
+    pDataHeader_p->m_ui32Uptime  = (uint32_t)LoraDataHeaderField<kLoraHeaderUptime >::GetInt(pLoraDataHeader_p);
 
-    return (flDataValue);
+    return;
 
 }
 
 
 
 //---------------------------------------------------------------------------
-//  Private: I8ToFloat
+//  Private: DecodeDataRec
 //---------------------------------------------------------------------------
 
-float  LoraPayloadDecoder::I8ToFloat (int8_t i8DataValue_p)
+void  LoraPayloadDecoder::DecodeDataRec (const tLoraDataRec* pLoraDataRec_p, tDataRec* pDataRec_p)
 {
 
-int    iDataValue;
-float  flDataValue;
+uint16_t  ui16CrcSum;
 
 
-    //   B7  B6  B5  B4  B3  B2  B1  B0
-    // +---+---+---+---+---+---+---+---+
-    // | S |       -127 ... +127       |
-    // +---+---+---+---+---+---+---+---+
-    //
-    //   0   1   1   1   1   1   1   1      +127
-    //                ...
-    //   0   0   0   0   0   0   0   1        +1
-    //   0   0   0   0   0   0   0   0         0
-    //   1   1   1   1   1   1   1   1        -1
-    //                ...
-    //   1   0   0   0   0   0   0   1      -127
+    if ( IsCleared(pLoraDataRec_p, (64/8)) )
+    {
+        pDataRec_p->m_DataStatus = kStatusUnused;
+        return;
+    }
 
-    iDataValue = (int)(i8DataValue_p & 0xFF);       // mask B6..B0
-    if ( (iDataValue & 0x80) )                      // extend negative values
+    ui16CrcSum = CalcCrc16(pLoraDataRec_p, (64/8));
+    if (ui16CrcSum == LoraGetCrc16(pLoraDataRec_p->m_abCRC16))
+    {
+        pDataRec_p->m_DataStatus = kStatusValid;
+    }
+    else
     {
-        iDataValue |= 0xFFFFFF00;
+        pDataRec_p->m_DataStatus = kStatusCrcError;
     }
-    flDataValue = (float)iDataValue;                // int -> float
+    DecodeDataRecValues(pLoraDataRec_p, pDataRec_p);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Private: DecodeDataRecValues
+//---------------------------------------------------------------------------
+
+void  LoraPayloadDecoder::DecodeDataRecValues (const tLoraDataRec* pLoraDataRec_p, tDataRec* pDataRec_p)
+{
+
+    // scaling and value ranges see <LORA_SCHEMA_DATA_REC>
+    pDataRec_p->m_LoraDataRec           = *pLoraDataRec_p;
+    pDataRec_p->m_PacketType            = (tLoraPacketType)LoraDataRecField<kLoraDataRecPacketType>::Get(pLoraDataRec_p);
+    pDataRec_p->m_ui12UptimeSnippet     = (uint16_t)LoraDataRecField<kLoraDataRecUptimeSnippet    >::GetInt  (pLoraDataRec_p);
+    pDataRec_p->m_flTemperature         =           LoraDataRecField<kLoraDataRecTemperature      >::GetFloat(pLoraDataRec_p);
+    pDataRec_p->m_flHumidity            =           LoraDataRecField<kLoraDataRecHumidity         >::GetFloat(pLoraDataRec_p);
+    pDataRec_p->m_fMotionActive         = (bool)    LoraDataRecField<kLoraDataRecMotionActive     >::GetInt  (pLoraDataRec_p);
+    pDataRec_p->m_ui16MotionActiveTime  = (uint16_t)LoraDataRecField<kLoraDataRecMotionActiveTime >::GetInt  (pLoraDataRec_p);
+    pDataRec_p->m_ui16MotionActiveCount = (uint16_t)LoraDataRecField<kLoraDataRecMotionActiveCount>::GetInt  (pLoraDataRec_p);
+    pDataRec_p->m_ui8LightLevel         = (uint8_t) LoraDataRecField<kLoraDataRecLightLevel       >::GetInt  (pLoraDataRec_p);
+    pDataRec_p->m_flCarBattLevel        =           LoraDataRecField<kLoraDataRecCarBattLevel     >::GetFloat(pLoraDataRec_p);
 
-    return (flDataValue);
+    return;
 
 }
 
 
 
 //---------------------------------------------------------------------------
-//  Private: UI7ToFloat
+//  Private: DecodeDeltaRec
 //---------------------------------------------------------------------------
 
-float  LoraPayloadDecoder::UI7ToFloat (uint8_t ui8DataValue_p)
+void  LoraPayloadDecoder::DecodeDeltaRec (const tLoraDataRec* pGen0_p, const tLoraDataDeltaRec* pDeltaRec_p, unsigned int uiGen_p, tDataRec* pDataRec_p)
 {
 
-uint   uiDataValue;
-float  flDataValue;
+tLoraDataRec     LoraDataRec;
+tLoraPacketType  PacketType;
+int64_t          i64Temperature;
+int64_t          i64Humidity;
+
+
+    switch (uiGen_p)
+    {
+        case 1:   PacketType = kLoraPacketDataGen1;      break;
+        case 2:   PacketType = kLoraPacketDataGen2;      break;
+        default:  PacketType = kLoraPacketDataGenN;      break;
+    }
 
+    i64Temperature = LoraDataRecField<kLoraDataRecTemperature>::RawToInt(LoraDataRecField<kLoraDataRecTemperature>::Get(pGen0_p)) +
+                     LoraDeltaRecField<kLoraDeltaRecTemperatureDelta>::RawToInt(LoraDeltaRecField<kLoraDeltaRecTemperatureDelta>::Get(pDeltaRec_p));
+    i64Humidity    = LoraDataRecField<kLoraDataRecHumidity>::RawToInt(LoraDataRecField<kLoraDataRecHumidity>::Get(pGen0_p)) +
+                     LoraDeltaRecField<kLoraDeltaRecHumidityDelta>::RawToInt(LoraDeltaRecField<kLoraDeltaRecHumidityDelta>::Get(pDeltaRec_p));
+    if (i64Humidity < 0)
+    {
+        i64Humidity = 0;
+    }
 
-    //   B7  B6  B5  B4  B3  B2  B1  B0
-    // +---+---+---+---+---+---+---+---+
-    // | - |        0 ... +127         |
-    // +---+---+---+---+---+---+---+---+
-    //
-    //       1   1   1   1   1   1   1      +127
-    //                ...
-    //       0   0   0   0   0   0   1        +1
-    //       0   0   0   0   0   0   0         0
+    // rebuild GenN as complete DataRecord, so that it is decoded the same way as Gen0
+    memset(&LoraDataRec, 0x00, sizeof(LoraDataRec));
+    LoraDataRecField<kLoraDataRecPacketType       >::Put(&LoraDataRec, PacketType);
+    LoraDataRecField<kLoraDataRecUptimeSnippet    >::Put(&LoraDataRec, LoraDataRecField<kLoraDataRecUptimeSnippet>::Get(pGen0_p) - LoraDeltaRecField<kLoraDeltaRecUptimeAge>::Get(pDeltaRec_p));
+    LoraDataRecField<kLoraDataRecTemperature      >::Put(&LoraDataRec, (uint32_t)i64Temperature);
+    LoraDataRecField<kLoraDataRecHumidity         >::Put(&LoraDataRec, (uint32_t)i64Humidity);
+    LoraDataRecField<kLoraDataRecMotionActive     >::Put(&LoraDataRec, LoraDeltaRecField<kLoraDeltaRecMotionActive    >::Get(pDeltaRec_p));
+    LoraDataRecField<kLoraDataRecMotionActiveTime >::Put(&LoraDataRec, LoraDeltaRecField<kLoraDeltaRecMotionActiveTime>::Get(pDeltaRec_p));
+    LoraDataRecField<kLoraDataRecMotionActiveCount>::Put(&LoraDataRec, LoraDataRecField<kLoraDataRecMotionActiveCount>::Get(pGen0_p) - LoraDeltaRecField<kLoraDeltaRecMotionCountDelta>::Get(pDeltaRec_p));
+    LoraDataRecField<kLoraDataRecLightLevel       >::Put(&LoraDataRec, LoraDeltaRecField<kLoraDeltaRecLightLevel      >::Get(pDeltaRec_p));
+    LoraDataRecField<kLoraDataRecCarBattLevel     >::Put(&LoraDataRec, LoraDeltaRecField<kLoraDeltaRecCarBattLevel    >::Get(pDeltaRec_p));
 
-    uiDataValue = (uint)(ui8DataValue_p & 0x7F);    // mask B6..B0
-    flDataValue = (float)(uiDataValue);             // int -> float
+    DecodeDataRecValues(&LoraDataRec, pDataRec_p);
 
-    return (flDataValue);
+    return;
 
 }
 
 
 
 //---------------------------------------------------------------------------
-//  Private: UI8ToFloat
+//  Private: GetBits
 //---------------------------------------------------------------------------
+//  Reads <uiBits_p> Bits from a little-endian Bit Stream (LSB first)
 
-float  LoraPayloadDecoder::UI8ToFloat (uint8_t ui8DataValue_p)
+uint32_t  LoraPayloadDecoder::GetBits (const uint8_t* pabStream_p, unsigned int* puiBitPos_p, unsigned int uiBits_p)
 {
 
-uint   uiDataValue;
-float  flDataValue;
-
+uint32_t      ui32Value;
+unsigned int  uiBit;
+unsigned int  uiBitPos;
 
-    //   B7  B6  B5  B4  B3  B2  B1  B0
-    // +---+---+---+---+---+---+---+---+
-    // |          0 ... +255           |
-    // +---+---+---+---+---+---+---+---+
-    //
-    //   1   1   1   1   1   1   1   1      +255
-    //                ...
-    //   0   0   0   0   0   0   0   1        +1
-    //   0   0   0   0   0   0   0   0         0
 
-    uiDataValue = (uint)(ui8DataValue_p & 0xFF);    // mask B7..B0
-    flDataValue = (float)(uiDataValue);             // int -> float
+    ui32Value = 0;
+    uiBitPos  = *puiBitPos_p;
+    for (uiBit=0; uiBit<uiBits_p; uiBit++)
+    {
+        if (pabStream_p[uiBitPos >> 3] & (1 << (uiBitPos & 0x07)))
+        {
+            ui32Value |= (1UL << uiBit);
+        }
+        uiBitPos++;
+    }
+    *puiBitPos_p = uiBitPos;
 
-    return (flDataValue);
+    return (ui32Value);
 
 }
 
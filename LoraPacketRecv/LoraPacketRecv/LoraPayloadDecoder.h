@@ -10,6 +10,9 @@
   Revision History:
 
   2023/03/25 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Decoding of Delta Data Packet with variable Generation Depth
+  2026/10/18 -rs:   V1.02 Decoding of Compact Data Packet with Sensor dependent Layout
+  2026/10/18 -rs:   V1.03 Field access and scaling generated from <LoraPacketSchema.h>
 
 ****************************************************************************/
 
@@ -52,7 +55,8 @@ class  LoraPayloadDecoder
         {
             kStatusUnused,
             kStatusCrcError,
-            kStatusValid
+            kStatusValid,
+            kStatusClipped                                      // DeltaRecord exceeds value range, content not reliable
 
         } tDataStatus;
 
@@ -78,6 +82,7 @@ class  LoraPayloadDecoder
             bool            m_fCommissioningMode;               // CommissioningMode    1          true | false          true | false
             uint8_t         m_ui8LoraTxPower;                   // LoRaTxPower          8          0..255                2..20 [dB]
             uint8_t         m_ui8LoraSpreadFactor;              // LoRaSpreadingFactor  8          0..255                6..12
+            tLoraBootupHeader m_LoraBootupHeader;               // raw BootupHeader, source for JSON / Line Protocol
 
         } tLoraStationBootup;
 
@@ -110,6 +115,7 @@ class  LoraPayloadDecoder
             uint16_t        m_ui16MotionActiveCount;            // MotionActiveCount    10         0..1023               0..1023
             uint8_t         m_ui8LightLevel;                    // LightLevel           6          0..63 [2 %]           0..100 [%]
             float           m_flCarBattLevel;                   // CarBattLevel         8          0..255 [0.1 V]        0..25.5 [V]
+            tLoraDataRec    m_LoraDataRec;                      // raw DataRecord (Gen1..GenN rebuilt from Gen0 and DeltaRecord), source for JSON / Line Protocol
 
         } tDataRec;
 
@@ -118,7 +124,9 @@ class  LoraPayloadDecoder
         typedef struct
         {
             tDataHeader     m_DataHeader;
-            tDataRec        m_aDataRec[3];
+            unsigned int    m_uiNumDataRec;                     // 3 for classic Data Packet, 1..LORA_DATA_GEN_DEPTH_MAX for Delta/Compact Data Packet
+            uint8_t         m_ui8SensorLayout;                  // LORA_DATA_LAYOUT_xxx, values of missing sensors are 0
+            tDataRec        m_aDataRec[LORA_DATA_GEN_DEPTH_MAX];
 
         } tLoraStationData;
 
@@ -135,7 +143,7 @@ class  LoraPayloadDecoder
         tLoraStationBootup  m_LoraStationBootup;
         tLoraStationData    m_LoraStationData;
         char                m_szLogStationBootup[1024];
-        char                m_szLogStationData[4096];
+        char                m_szLogStationData[16384];
 
 
 
@@ -152,6 +160,8 @@ class  LoraPayloadDecoder
         int                 GetRxPacketDevID(const tLoraDataPacket* pLoraPacket_p);
         tLoraStationBootup  DecodeRxBootupPacket(const tLoraDataPacket* pLoraPacket_p);
         tLoraStationData    DecodeRxDataPacket(const tLoraDataPacket* pLoraPacket_p);
+        tLoraStationData    DecodeRxDataDeltaPacket(const tLoraDataDeltaPacket* pLoraPacket_p, unsigned int uiPacketSize_p);
+        tLoraStationData    DecodeRxDataCompactPacket(const tLoraDataCompactPacket* pLoraPacket_p, unsigned int uiPacketSize_p);
 
         const char*         LogStationBootup(const tLoraStationBootup* pLoraStationBootup_p);
         const char*         LogStationData(const tLoraStationData* pLoraStationData_p);
@@ -164,15 +174,23 @@ class  LoraPayloadDecoder
 
     private:
 
-        float     I7ToFloat(int8_t i8DataValue_p);
-        float     I8ToFloat(int8_t i8DataValue_p);
-        float     UI7ToFloat(uint8_t ui8DataValue_p);
-        float     UI8ToFloat(uint8_t ui8DataValue_p);
+        void      DecodeDataHeader(const tLoraDataHeader* pLoraDataHeader_p, tDataHeader* pDataHeader_p);
+        void      DecodeDataRec(const tLoraDataRec* pLoraDataRec_p, tDataRec* pDataRec_p);
+        void      DecodeDataRecValues(const tLoraDataRec* pLoraDataRec_p, tDataRec* pDataRec_p);
+        void      DecodeDeltaRec(const tLoraDataRec* pGen0_p, const tLoraDataDeltaRec* pDeltaRec_p, unsigned int uiGen_p, tDataRec* pDataRec_p);
+        uint32_t  GetBits(const uint8_t* pabStream_p, unsigned int* puiBitPos_p, unsigned int uiBits_p);
         bool      IsCleared(const void* pDataBlock_p, unsigned int uiDataBlockSize_p);
         uint16_t  CalcCrc16(const void* pDataBlock_p, unsigned int uiDataBlockSize_p);
         size_t    LogStr(char* pszLogBuff_p, size_t nLogBuffSize_p, const char* pszFmt_p, ...);
         size_t    FormatUptime (uint32_t ui32Uptime_p, char* pszLogBuff_p, size_t nLogBuffSize_p, bool fForceDay_p = true, bool fForceTwoDigitsHours_p = true);
 
+        // reads the field <tField> (LoraField<>) of record <pRec_p> from the Bit Stream
+        template <class tField>
+        void      GetField(const uint8_t* pabStream_p, unsigned int* puiBitPos_p, void* pRec_p)
+        {
+            tField::Put(pRec_p, GetBits(pabStream_p, puiBitPos_p, tField::BITS));
+        }
+
 };
 
 
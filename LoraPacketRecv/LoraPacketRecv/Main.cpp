@@ -10,11 +10,28 @@
   Revision History:
 
   2023/03/25 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Console output of main loop via BinaryLogger
+  2026/10/18 -rs:   V1.02 Optional real-time mode for radio servicing
+  2026/10/18 -rs:   V1.03 Multiple RF95 Modules with cross-radio deduplication
+  2026/10/18 -rs:   V1.04 Optional publishing in InfluxDB Line Protocol
+  2026/10/18 -rs:   V1.05 Optional raw frame capture (pcap with LoRaTap header)
+  2026/10/18 -rs:   V1.06 Optional binary MessageLog
+  2026/10/18 -rs:   V1.07 Time/DevID Index of MessageFile
+  2026/10/18 -rs:   V1.08 Rotation, Compression and Retention of MessageFile
+  2026/10/18 -rs:   V1.09 Optional embedded Time Series Store
+  2026/10/18 -rs:   V1.10 Optional Last Value Cache with HTTP/JSON Query API
+  2026/10/18 -rs:   V1.11 Optional Shared Memory Ring for local consumers
+  2026/10/18 -rs:   V1.12 MessageFile, Time Series Store and MQTT as Message Sinks
+                          with own queue and worker thread each
+  2026/10/18 -rs:   V1.13 Optional re-publishing of archived MessageFiles
+                          (rate-controlled, resumable, lower priority than live)
+  2026/10/18 -rs:   V1.14 Selectable SPI transport and clock, SPI benchmark
 
 ****************************************************************************/
 
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <iostream>
 #include <vector>
 #include <string.h>
@@ -22,15 +39,29 @@
 #include <signal.h>
 #include <time.h>
 #include <poll.h>
+#include <unistd.h>
+#include <thread>
 #include <RH_RF95.h>
 #include "LoraPacket.h"
 #include "LoraPayloadDecoder.h"
 #include "PacketProcessing.h"
 #include "MessageQualification.h"
 #include "MessageFileWriter.h"
+#include "MessageIndex.h"
+#include "TimeSeriesStore.h"
+#include "LastValueCache.h"
+#include "ShmRingWriter.h"
+#include "MessageSink.h"
+#include "MessageReplay.h"
 #include "LibRf95.h"
 #include "LibMqtt.h"
 #include "GpioIrq.h"
+#include "RxQueue.h"
+#include "RealTime.h"
+#include "RadioDedup.h"
+#include "RadioSim.h"
+#include "PcapWriter.h"
+#include "BinaryLogger.h"
 #include "Trace.h"
 
 // Define type of RF95 HAT
@@ -74,6 +105,8 @@ static  const  char*            MQTT_PASSWORD           = "{empty}";
 
 static  const  char*            MQTT_TOPIC_TMPL_BOOTUP  = "LoraAmbMon/Data/DevID%03u/Bootup";
 static  const  char*            MQTT_TOPIC_TMPL_ST_DATA = "LoraAmbMon/Data/DevID%03u/StData";
+static  const  char*            MQTT_TOPIC_TMPL_LN_BOOT = "LoraAmbMon/Line/DevID%03u/Bootup";
+static  const  char*            MQTT_TOPIC_TMPL_LN_DATA = "LoraAmbMon/Line/DevID%03u/StData";
 static  const  char*            MQTT_TOPIC_TELEMETRY    = "LoraAmbMon/Status/Telemetry";
 static  const  char*            MQTT_TOPIC_KEEPALVIE    = "LoraAmbMon/Status/KeepAlive";
 
@@ -83,12 +116,37 @@ static  const  char*            MQTT_TOPIC_KEEPALVIE    = "LoraAmbMon/Status/Kee
 //  Constant definitions
 //---------------------------------------------------------------------------
 
+//  Message Sinks (see MessageSink.h): the MessageFile slows down the main loop
+//  for a limited time rather than losing records, the MQTT Broker gets the
+//  newest records first after a longer outage
+const  uint  APP_FILE_SINK_QUEUE_SIZE       = 4096;         // [messages]
+const  uint  APP_FILE_SINK_BLOCK_TIME       = 200;          // [ms] max. backpressure on main loop per message
+const  uint  APP_STORE_SINK_QUEUE_SIZE      = 4096;         // [messages]
+const  uint  APP_MQTT_SINK_QUEUE_SIZE       = 4096;         // [messages] about 2 hours of a large fleet
+const  uint  APP_MQTT_SINK_MAX_BATCH        = 16;           // [messages]
+const  uint  APP_MQTT_SERVICE_INTERVAL      = 1000;         // [ms] KeepAlive and Reconnect
+const  uint  APP_MQTT_RETRY_DELAY           = 1000;         // [ms] Broker not reachable
+
+//  Re-publishing of archived MessageFiles (see MessageReplay.h)
+const  char  APP_REPLAY_DEF_SINK[]          = "MQTT";
+const  uint  APP_REPLAY_PROGRESS_INTERVAL   = 10;           // [sec] progress in log
+
 
 
 //---------------------------------------------------------------------------
 //  Local types
 //---------------------------------------------------------------------------
 
+typedef struct
+{
+    uint8_t             m_ui8GpioPinCS;
+    uint8_t             m_ui8GpioPinIRQ;
+    uint8_t             m_ui8GpioPinRST;
+    float               m_flFrequency;
+    uint8_t             m_ui8SpreadFactor;              // 0 = default of RadioHead driver
+
+} tAppRadioCfg;
+
 
 
 //---------------------------------------------------------------------------
@@ -105,12 +163,43 @@ static  char                    szServerUrl_l[128];
 static  const char*             pszHostAddr_l;          // = MQTT_DEF_HOST_URL
 static  int                     iPortNum_l;             // = MQTT_DEF_HOST_PORTNUM
 static  const char*             pszMsgFileName_l        = NULL;
+static  tMfwFormat              MsgFileFormat_l         = kMfwFormatJson;
+static  tMfwRotationCfg         MsgFileRotation_l;                  // all 0 = no rotation
+static  const char*             pszStoreFileName_l      = NULL;
+static  const char*             pszQueryBindAddr_l      = NULL;
+static  uint16_t                ui16QueryPort_l         = 0;        // 0 = no HTTP Query API
+static  const char*             pszShmRingName_l        = NULL;     // NULL = no Shared Memory Ring
+static  const char*             pszCaptureFileName_l    = NULL;
+static  uint                    uiCaptureMaxSizeMB_l    = 0;        // 0 = no rotation
+static  std::vector<const char*>  vecReplayFiles_l;                 // empty = no re-publishing
+static  const char*             pszReplaySink_l         = APP_REPLAY_DEF_SINK;
+static  uint                    uiReplayRate_l          = MRP_DEF_RATE;
+static  uint                    uiReplayBurst_l         = MRP_DEF_BURST;
+static  int64_t                 i64ReplayFromTime_l     = INT64_MIN;
+static  int64_t                 i64ReplayToTime_l       = INT64_MAX;
+static  time_t                  tmReplayProgress_l      = 0;
 static  int                     fProcAllMsg_l           = false;
 static  int                     fTelemetryMsg_l         = false;
 static  int                     fOffline_l              = false;
+static  int                     fLineProtocol_l         = false;
 static  bool                    fVerbose_l              = false;
-
-static  bool                    fRunMainLoop_l          = false;
+static  int                     iLogLevel_l             = kBlgLevelInfo;
+static  bool                    fLogBenchmark_l         = false;
+static  int                     iRtCpuCore_l            = -1;       // -1 = real-time mode off
+static  int                     iRtPriority_l           = RTM_DEF_PRIORITY;
+static  uint                    uiJitterTestTm_l        = 0;
+static  tAppRadioCfg            aRadioCfg_l[RF95_MAX_RADIOS];
+static  uint                    uiRadioCount_l          = 0;
+static  uint                    uiSimRadios_l           = 0;
+static  const char*             pszSpiDev_l             = NULL;     // NULL = SPI0 by bcm2835 library
+static  uint                    uiSpiClockKHz_l         = 0;        // 0 = RadioHead default
+static  uint                    uiSpiBenchFrames_l      = 0;
+
+static  volatile bool           fRunMainLoop_l          = false;
+static  uint                    uiRxPacketCntr_l        = 0;
+static  uint                    uiMsgID_l               = 1;
+static  bool                    fMqttReconnect_l        = false;    // MQTT Sink worker only
+static  tRtmLatencyStat         RxReadDurStat_l;
 
 
 
@@ -122,9 +211,65 @@ static  void  AppSigHandler (int iSignalNum_p);
 
 static  bool  AppEvalCmdlnArgs (int iArgCnt_p, char* apszArg_p[]);
 static  void  AppPrintHelpScreen  (const char* pszArg0_p);
+static  bool  AppParseRadioCfg (const char* pszRadioCfg_p);
+
+static  bool  AppReadRxPacket (
+    uint uiRadio_p,
+    tRxqFrame* pRxFrame_p);
+
+static  void  AppCaptureRxPacket (
+    const tRxqFrame* pRxFrame_p);
+
+static  void  AppDedupRxPacket (
+    const tRxqFrame* pRxFrame_p);
+
+static  void  AppRadioThread (void);
+
+static  int  AppProcessRxPacket (
+    const tRxqFrame* pRxFrame_p);
+
+static  void  AppSetupSinks (void);
+
+static  void  AppSetupReplay (void);
+
+static  void  AppServiceReplay (void);
+
+static  uint  AppFileSinkWrite (
+    const tJsonMessage* const* apJsonMessage_p,
+    uint uiCount_p,
+    uint* puiFailed_p,
+    void* pArg_p);
+
+static  uint  AppStoreSinkWrite (
+    const tJsonMessage* const* apJsonMessage_p,
+    uint uiCount_p,
+    uint* puiFailed_p,
+    void* pArg_p);
+
+static  uint  AppMqttSinkWrite (
+    const tJsonMessage* const* apJsonMessage_p,
+    uint uiCount_p,
+    uint* puiFailed_p,
+    void* pArg_p);
+
+static  uint  AppMqttSinkWriteReplay (
+    const tJsonMessage* const* apJsonMessage_p,
+    uint uiCount_p,
+    uint* puiFailed_p,
+    void* pArg_p);
+
+static  void  AppMqttSinkService (
+    void* pArg_p);
+
+static  int  AppPublishMessage (
+    const tJsonMessage* pJsonMessage_p,
+    bool fReplay_p);
+
+static  void  AppServiceMqtt (void);
 
 static  int  BuildMqttPublishTopic (
     const tJsonMessage* pJsonMessage_p,
+    bool fLineProtocol_p,
     char* pszTopicBuffer_p,
     int iTopicBuffSize_p);
 
@@ -170,27 +315,15 @@ static  void  DumpDataBuffer (
 int  main (int iArgCnt_p, char* apszArg_p[])
 {
 
-std::vector<tJsonMessage>  vecJsonMessages;
-struct pollfd  FdSet[1];
-volatile int   iGpioState;
-uint8_t        abRxDataBuff[RH_RF95_MAX_PAYLOAD_LEN+1];
-uint           uiRxDataBuffLen;
-uint           uiRxPacketCntr;
+struct pollfd  FdSet[RF95_MAX_RADIOS];
+uint           uiFdCount;
+uint           uiRadio;
+uint           uiSink;
+tRxqFrame      RxFrame;
+std::thread    RadioThread;
+tMskStatistics SinkStatistics;
 time_t         tmTimeStamp;
 char           szTimeStamp[64];
-int8_t         i8LastRssi;
-tLoraMsgData   LoraMsgData;
-tJsonMessage   JsonMessage;
-uint           uiMsgID;
-bool           fIsKnownLoraMsgFormat;
-int            iMessageToBeProcessed;
-char           szMqttTopic[64];
-char           szMqttMsg[128];
-uint8_t*       pabMqttMsgBuff;
-uint           uiMqttMsgBuffLen;
-bool           fRxValid;
-bool           fMqttReconnect;
-int            iIdx;
 int            iRes;
 bool           fRes;
 
@@ -212,13 +345,39 @@ bool           fRes;
     pszHostAddr_l    = MQTT_DEF_HOST_URL;
     iPortNum_l       = MQTT_DEF_HOST_PORTNUM;
     pszMsgFileName_l = NULL;
+    MsgFileFormat_l  = kMfwFormatJson;
+    memset(&MsgFileRotation_l, 0, sizeof(MsgFileRotation_l));
+    pszStoreFileName_l = NULL;
+    pszQueryBindAddr_l = LVC_DEF_BIND_ADDR;
+    ui16QueryPort_l    = 0;
+    pszShmRingName_l   = NULL;
+    pszCaptureFileName_l = NULL;
+    uiCaptureMaxSizeMB_l = 0;
+    vecReplayFiles_l.clear();
+    pszReplaySink_l  = APP_REPLAY_DEF_SINK;
+    uiReplayRate_l   = MRP_DEF_RATE;
+    uiReplayBurst_l  = MRP_DEF_BURST;
+    i64ReplayFromTime_l = INT64_MIN;
+    i64ReplayToTime_l   = INT64_MAX;
     fProcAllMsg_l    = false;
     fTelemetryMsg_l  = false;
     fOffline_l       = false;
+    fLineProtocol_l  = false;
     fVerbose_l       = false;
-    uiRxPacketCntr   = 0;
-    uiMsgID          = 1;
-    fMqttReconnect   = false;
+    iLogLevel_l      = kBlgLevelInfo;
+    fLogBenchmark_l  = false;
+    iRtCpuCore_l     = -1;
+    iRtPriority_l    = RTM_DEF_PRIORITY;
+    uiJitterTestTm_l = 0;
+    uiRadioCount_l   = 0;
+    uiSimRadios_l    = 0;
+    pszSpiDev_l      = NULL;
+    uiSpiClockKHz_l  = 0;
+    uiSpiBenchFrames_l = 0;
+    uiRxPacketCntr_l = 0;
+    uiMsgID_l        = 1;
+    fMqttReconnect_l = false;
+    RtmLatencyReset(&RxReadDurStat_l);
 
 
     // evaluate Command Line Arguments
@@ -229,6 +388,44 @@ bool           fRes;
         return (-1);
     }
 
+    // without option '-m' only the radio of the RF95 HAT is used
+    if (uiSimRadios_l > 0)
+    {
+        uiRadioCount_l = uiSimRadios_l;
+    }
+    else if (uiRadioCount_l == 0)
+    {
+        aRadioCfg_l[0].m_ui8GpioPinCS    = GPIO_PIN_CS;
+        aRadioCfg_l[0].m_ui8GpioPinIRQ   = GPIO_PIN_IRQ;
+        aRadioCfg_l[0].m_ui8GpioPinRST   = GPIO_PIN_RST;
+        aRadioCfg_l[0].m_flFrequency     = RF_FREQUENCY;
+        aRadioCfg_l[0].m_ui8SpreadFactor = 0;
+        uiRadioCount_l = 1;
+    }
+
+    // run benchmark of BinaryLogger (doesn't need any hardware access)
+    if ( fLogBenchmark_l )
+    {
+        BlgRunBenchmark(0);
+        return (0);
+    }
+
+    // SPI benchmark runs on a real (or loopback) SPI device
+    if ((uiSpiBenchFrames_l > 0) && (uiSimRadios_l > 0))
+    {
+        printf("\nERROR: SPI benchmark is not possible with simulated radios!\n\n");
+        return (-1);
+    }
+
+    // run jitter measurement for real-time mode (doesn't need any hardware access)
+    if (uiJitterTestTm_l > 0)
+    {
+        RtmRunJitterTest(uiJitterTestTm_l,
+                         ((iRtCpuCore_l >= 0) ? iRtCpuCore_l : (int)(sysconf(_SC_NPROCESSORS_ONLN) - 1)),
+                         iRtPriority_l);
+        return (0);
+    }
+
 
     // show sytem start time and runtime configuration
     tmTimeStamp = time(NULL);
@@ -239,7 +436,98 @@ bool           fRes;
     printf("  '-a' ProcAllMsg   = %s\n", (fProcAllMsg_l   ? "yes" : "no"));
     printf("  '-t' TelemetryMsg = %s\n", (fTelemetryMsg_l ? "yes" : "no"));
     printf("  '-o' Offline      = %s\n", (fOffline_l      ? "yes" : "no"));
+    printf("  '-p' LineProtocol = %s\n", (fLineProtocol_l ? "yes" : "no"));
     printf("  '-v' Verbose      = %s\n", (fVerbose_l      ? "yes" : "no"));
+    printf("  '-d' LogLevel     = %d\n", iLogLevel_l);
+    if (iRtCpuCore_l >= 0)
+    {
+        printf("  '-r' RealTime     = CPU Core %d, SCHED_FIFO Priority %d\n", iRtCpuCore_l, iRtPriority_l);
+    }
+    else
+    {
+        printf("  '-r' RealTime     = no\n");
+    }
+    printf("  '-m' Radios       = %u\n", uiRadioCount_l);
+    printf("  '-s' Simulation   = %s\n", ((uiSimRadios_l > 0) ? "yes" : "no"));
+    if (uiSpiClockKHz_l > 0)
+    {
+        printf("  '-n' SPI          = '%s', %u kHz\n", ((pszSpiDev_l != NULL) ? pszSpiDev_l : "bcm2835"), uiSpiClockKHz_l);
+    }
+    else
+    {
+        printf("  '-n' SPI          = '%s', default clock\n", ((pszSpiDev_l != NULL) ? pszSpiDev_l : "bcm2835"));
+    }
+    if (pszMsgFileName_l == NULL)
+    {
+        printf("  '-l' MessageFile  = no\n");
+    }
+    else
+    {
+        printf("  '-l' MessageFile  = '%s' (%s)\n", pszMsgFileName_l, ((MsgFileFormat_l == kMfwFormatBinary) ? "binary" : "json"));
+    }
+    if ((MsgFileRotation_l.m_ui64MaxFileSize == 0) && (MsgFileRotation_l.m_uiRotationPeriod == 0))
+    {
+        printf("  '-w' Rotation     = no\n");
+    }
+    else
+    {
+        printf("  '-w' Rotation     = %u MB / %u h%s\n", (uint)(MsgFileRotation_l.m_ui64MaxFileSize / (1024 * 1024)),
+               MsgFileRotation_l.m_uiRotationPeriod / 3600, (MsgFileRotation_l.m_fCompress ? ", compressed" : ""));
+    }
+    if ((MsgFileRotation_l.m_uiRetainAge == 0) && (MsgFileRotation_l.m_ui64RetainBytes == 0))
+    {
+        printf("  '-k' Retention    = unlimited\n");
+    }
+    else
+    {
+        printf("  '-k' Retention    = %u days / %u MB\n", MsgFileRotation_l.m_uiRetainAge / 86400,
+               (uint)(MsgFileRotation_l.m_ui64RetainBytes / (1024 * 1024)));
+    }
+    if (pszStoreFileName_l == NULL)
+    {
+        printf("  '-y' TimeSeries   = no\n");
+    }
+    else
+    {
+        printf("  '-y' TimeSeries   = '%s'\n", pszStoreFileName_l);
+    }
+    if (ui16QueryPort_l == 0)
+    {
+        printf("  '-q' Query API    = no\n");
+    }
+    else
+    {
+        printf("  '-q' Query API    = http://%s:%u/devices\n", pszQueryBindAddr_l, (uint)ui16QueryPort_l);
+    }
+    if (pszShmRingName_l == NULL)
+    {
+        printf("  '-x' Shm Ring     = no\n");
+    }
+    else
+    {
+        printf("  '-x' Shm Ring     = '%s' (%u slots)\n", pszShmRingName_l, SRW_DEF_SLOTS);
+    }
+    if (pszCaptureFileName_l == NULL)
+    {
+        printf("  '-c' Capture      = no\n");
+    }
+    else if (uiCaptureMaxSizeMB_l > 0)
+    {
+        printf("  '-c' Capture      = '%s' (rotation at %u MB)\n", pszCaptureFileName_l, uiCaptureMaxSizeMB_l);
+    }
+    else
+    {
+        printf("  '-c' Capture      = '%s'\n", pszCaptureFileName_l);
+    }
+    if ( vecReplayFiles_l.empty() )
+    {
+        printf("  '-e' Replay       = no\n");
+    }
+    else
+    {
+        printf("  '-e' Replay       = %u file(s) to Sink '%s', %u messages/s (burst %u)\n",
+               (uint)vecReplayFiles_l.size(), pszReplaySink_l, uiReplayRate_l, uiReplayBurst_l);
+    }
     printf("\n");
 
 
@@ -247,72 +535,125 @@ bool           fRes;
     signal(SIGINT, AppSigHandler);
 
 
-    // init bcm2835 I/O Library
-    printf("Initialize bcm2835 Library... ");
-    iRes = bcm2835_init();
-    if ( !iRes )
+    // init bcm2835 I/O Library (not needed for simulated radios)
+    if (uiSimRadios_l == 0)
     {
-        printf("\nERROR: bcm2835_init() failed!\n\n");
-        return (-2);
+        printf("Initialize bcm2835 Library... ");
+        iRes = bcm2835_init();
+        if ( !iRes )
+        {
+            printf("\nERROR: bcm2835_init() failed!\n\n");
+            return (-2);
+        }
+        printf("done.\n");
+        GpioInit();
+
+        // select SPI transport and clock shared by all RF95 Modules
+        printf("Setup SPI Transport... ");
+        iRes = RF95SetupSpi(pszSpiDev_l, uiSpiClockKHz_l * 1000);
+        if (iRes != 0)
+        {
+            printf("\nERROR: RF95SetupSpi() failed, can't open SPI device '%s'!\n\n", pszSpiDev_l);
+            return (-2);
+        }
+        printf("done.\n");
     }
-    printf("done.\n");
 
 
     // setup RF95 Board Configuration
-    printf("Setup RF95 Board Configuration...\n");
-    printf("  CS  = BCM.%d\n", GPIO_PIN_CS);
-    printf("  IRQ = BCM.%d\n", GPIO_PIN_IRQ);
-    printf("  RST = BCM.%d\n", GPIO_PIN_RST);
-    RF95Setup(GPIO_PIN_CS, GPIO_PIN_IRQ, GPIO_PIN_RST);
-    printf("done.\n");
+    for (uiRadio=0; uiRadio<uiRadioCount_l; uiRadio++)
+    {
+        if (uiSimRadios_l > 0)
+        {
+            printf("Setup simulated RF95 Radio[%u]... ", uiRadio);
+            iRes = RF95SetupSimulated(uiRadio);
+            if (iRes != 0)
+            {
+                printf("\nERROR: RF95SetupSimulated() failed (iRes=%d)!\n\n", iRes);
+                return (-3);
+            }
+            printf("done.\n");
+            continue;
+        }
 
+        printf("Setup RF95 Board Configuration (Radio[%u])...\n", uiRadio);
+        printf("  CS  = BCM.%d\n", aRadioCfg_l[uiRadio].m_ui8GpioPinCS);
+        printf("  IRQ = BCM.%d\n", aRadioCfg_l[uiRadio].m_ui8GpioPinIRQ);
+        printf("  RST = BCM.%d\n", aRadioCfg_l[uiRadio].m_ui8GpioPinRST);
+        RF95Setup(uiRadio, aRadioCfg_l[uiRadio].m_ui8GpioPinCS, aRadioCfg_l[uiRadio].m_ui8GpioPinIRQ, aRadioCfg_l[uiRadio].m_ui8GpioPinRST);
+        printf("done.\n");
 
-    // configure GPIO Pin for IRQ handling
-    printf("Configure IRQ Pin BCM.%d... ", GPIO_PIN_IRQ);
-    GpioInit();
-    GpioOpen(GPIO_PIN_IRQ, GPIO_DIR_IN);
-    GpioSetEdge(GPIO_PIN_IRQ, GPIO_EDGE_RISING);
-    printf("done.\n");
+        // configure GPIO Pin for IRQ handling
+        printf("Configure IRQ Pin BCM.%d... ", aRadioCfg_l[uiRadio].m_ui8GpioPinIRQ);
+        GpioOpen(aRadioCfg_l[uiRadio].m_ui8GpioPinIRQ, GPIO_DIR_IN);
+        GpioSetEdge(aRadioCfg_l[uiRadio].m_ui8GpioPinIRQ, GPIO_EDGE_RISING);
+        printf("done.\n");
+    }
 
 
-    // pulse a reset on RF95 Module
-    printf("Reset RF95 Module... ");
-    RF95ResetModule();
-    printf("done.\n");
+    // run SPI benchmark with first RF95 Module (only reads out the FIFO, the
+    // module is not initialized, so it also runs with a loopback device)
+    if (uiSpiBenchFrames_l > 0)
+    {
+        printf("\n");
+        RF95RunSpiBenchmark(0, uiSpiBenchFrames_l, sizeof(tLoraDataPacket));
+        printf("\n");
+        return (0);
+    }
 
 
-    // initialize RF95 Module
-    printf("Initialize RF95 Module...\n");
-    printf("  Tx Power:  %d\n", RF_TX_POWER);
-    printf("  Frequency: %3.2fMHz\n", RF_FREQUENCY);
-    iRes = RF95InitModule(RF_TX_POWER, RF_FREQUENCY);
-    if (iRes != 0)
+    // pulse a reset on RF95 Modules (all modules before initializing
+    // any of them, since several modules can share the same reset line)
+    for (uiRadio=0; (uiRadio<uiRadioCount_l) && (uiSimRadios_l == 0); uiRadio++)
     {
-        printf("\nERROR: RF95InitModule() failed (iRes=%d)!\n\n", iRes);
-        return (-3);
+        printf("Reset RF95 Module[%u]... ", uiRadio);
+        RF95ResetModule(uiRadio);
+        printf("done.\n");
     }
-    printf("done.\n");
 
 
-    // print RF95 Module configuration settings
-    if ( fVerbose_l )
+    // initialize RF95 Modules
+    for (uiRadio=0; (uiRadio<uiRadioCount_l) && (uiSimRadios_l == 0); uiRadio++)
     {
-        printf("\n");
-        printf("RF95 Configuration Settings:\n");
-        RF95DiagPrintConfig();
-        printf("\n");
+        printf("Initialize RF95 Module[%u]...\n", uiRadio);
+        printf("  Tx Power:  %d\n", RF_TX_POWER);
+        printf("  Frequency: %3.2fMHz\n", aRadioCfg_l[uiRadio].m_flFrequency);
+        if (aRadioCfg_l[uiRadio].m_ui8SpreadFactor != 0)
+        {
+            printf("  SpreadFac: SF%u\n", (uint)aRadioCfg_l[uiRadio].m_ui8SpreadFactor);
+        }
+        iRes = RF95InitModule(uiRadio, RF_TX_POWER, aRadioCfg_l[uiRadio].m_flFrequency, aRadioCfg_l[uiRadio].m_ui8SpreadFactor);
+        if (iRes != 0)
+        {
+            printf("\nERROR: RF95InitModule() failed (iRes=%d)!\n\n", iRes);
+            return (-3);
+        }
+        printf("done.\n");
+
+        // print RF95 Module configuration settings
+        if ( fVerbose_l )
+        {
+            printf("\n");
+            printf("RF95 Configuration Settings (Radio[%u]):\n", uiRadio);
+            RF95DiagPrintConfig(uiRadio);
+            printf("\n");
+        }
     }
 
 
     // initialize LoRa Message Qualification
     MquInitialize();
 
+    // with several radios each packet is held back for a short time to
+    // collect the copies received by the other radios (best RSSI wins)
+    RddInitialize((uiRadioCount_l > 1) ? RDD_DEF_HOLD_TIME_MS : 0);
+
 
     // create/open MessageFile
     if (pszMsgFileName_l != NULL)
     {
         printf("Create/Open MessageFile ('%s')... ", pszMsgFileName_l);
-        iRes = MfwOpen(pszMsgFileName_l);
+        iRes = MfwOpen(pszMsgFileName_l, MsgFileFormat_l, MIX_DEF_BLOCK_RECORDS, true, &MsgFileRotation_l);
         if (iRes >= 0)
         {
             printf("done.\n");
@@ -325,6 +666,78 @@ bool           fRes;
     }
 
 
+    // create/open Time Series Store
+    if (pszStoreFileName_l != NULL)
+    {
+        printf("Create/Open Time Series Store ('%s')... ", pszStoreFileName_l);
+        iRes = TssOpen(pszStoreFileName_l, false);
+        if (iRes >= 0)
+        {
+            printf("done.\n");
+        }
+        else
+        {
+            printf("failed (iRes=%d)!\n\n", iRes);
+            pszStoreFileName_l = NULL;
+        }
+    }
+
+
+    // start HTTP Query API of Last Value Cache
+    if (ui16QueryPort_l != 0)
+    {
+        printf("Start HTTP Query API (%s:%u)... ", pszQueryBindAddr_l, (uint)ui16QueryPort_l);
+        iRes = LvcOpen(pszQueryBindAddr_l, ui16QueryPort_l);
+        if (iRes >= 0)
+        {
+            printf("done.\n");
+        }
+        else
+        {
+            printf("failed (iRes=%d)!\n\n", iRes);
+            ui16QueryPort_l = 0;
+        }
+    }
+
+
+    // create Shared Memory Ring for local consumers
+    if (pszShmRingName_l != NULL)
+    {
+        printf("Create Shared Memory Ring ('%s')... ", pszShmRingName_l);
+        iRes = SrwOpen(pszShmRingName_l, SRW_DEF_SLOTS);
+        if (iRes >= 0)
+        {
+            printf("done.\n");
+        }
+        else
+        {
+            printf("failed (iRes=%d)!\n\n", iRes);
+            pszShmRingName_l = NULL;
+        }
+    }
+
+
+    // create CaptureFile for raw frames
+    if (pszCaptureFileName_l != NULL)
+    {
+        printf("Create CaptureFile ('%s')... ", pszCaptureFileName_l);
+        iRes = PcwOpen(pszCaptureFileName_l, (uint64_t)uiCaptureMaxSizeMB_l * 1024 * 1024);
+        if (iRes >= 0)
+        {
+            printf("done.\n");
+            if (uiCaptureMaxSizeMB_l > 0)
+            {
+                printf("  First File = '%s'\n", PcwGetFileName());
+            }
+        }
+        else
+        {
+            printf("failed (iRes=%d)!\n\n", iRes);
+            pszCaptureFileName_l = NULL;
+        }
+    }
+
+
     // connect to MQTT Broker
     if ( !fOffline_l )
     {
@@ -347,7 +760,44 @@ bool           fRes;
     {
         printf("Running in Offline Mode, without MQTT connection.\n");
     }
-    fMqttReconnect = false;
+    fMqttReconnect_l = false;
+
+
+    // real-time mode: lock memory and reserve CPU core for radio thread
+    // (must be done before any other thread is created, all threads
+    // created afterwards inherit the reduced CPU affinity)
+    if (iRtCpuCore_l >= 0)
+    {
+        printf("Setup Real-Time Mode...\n");
+        iRes = RtmLockMemory(RTM_DEF_PREFAULT_HEAP);
+        if (iRes != 0)
+        {
+            printf("WARNING: RtmLockMemory() failed (iRes=%d)!\n", iRes);
+        }
+        iRes = RtmExcludeCpuCore(iRtCpuCore_l);
+        if (iRes != 0)
+        {
+            printf("WARNING: RtmExcludeCpuCore() failed (iRes=%d)!\n", iRes);
+        }
+        iRes = RxqInitialize(RXQ_DEF_QUEUE_SIZE);
+        if (iRes != 0)
+        {
+            printf("\nERROR: RxqInitialize() failed (iRes=%d)!\n\n", iRes);
+            return (-6);
+        }
+        printf("done.\n");
+    }
+
+
+    // setup Message Sinks (MessageFile, Time Series Store, MQTT Broker)
+    AppSetupSinks();
+
+
+    // open archived MessageFiles to re-publish
+    if ( !vecReplayFiles_l.empty() )
+    {
+        AppSetupReplay();
+    }
 
 
     //-------------------------------------------------------------------
@@ -355,19 +805,75 @@ bool           fRes;
     //-------------------------------------------------------------------
     // Main Loop
     printf("\n\n---- Entering Main Loop ----\n");
+    fflush(stdout);
+
+    // from here on console output is formatted by the background thread of the
+    // BinaryLogger, so that the receive path is not delayed by the stdout pipe
+    BlgInitialize(0, iLogLevel_l, stdout);
+
+    // each Message Sink is served by its own worker thread (created after
+    // RtmExcludeCpuCore(), so they avoid the core of the radio thread)
+    MskStart();
+
+    // archived MessageFiles are re-published through the backfill queue of
+    // the sink, so the live messages always go first
+    if ( !vecReplayFiles_l.empty() )
+    {
+        MrpStart();
+    }
+
+    // in real-time mode the radio is serviced by a separate thread, the main
+    // loop only processes the frames passed through the RxQueue
+    if (iRtCpuCore_l >= 0)
+    {
+        RadioThread = std::thread(AppRadioThread);
+    }
+
+    // simulated LoRa nodes transmitting to the simulated radios
+    if (uiSimRadios_l > 0)
+    {
+        RsmStart(uiSimRadios_l, RSM_DEF_DEVICES, RSM_DEF_CYCLE_TIME_MS);
+    }
+
     while ( fRunMainLoop_l )
     {
-        FdSet[0].fd = GpioGetFD(GPIO_PIN_IRQ);
-        FdSet[0].events = POLLPRI;
-        FdSet[0].revents = 0;
+        uiFdCount = 0;
+        if (iRtCpuCore_l >= 0)
+        {
+            FdSet[uiFdCount].fd = RxqGetEventFD();
+            FdSet[uiFdCount].events = POLLIN;
+            FdSet[uiFdCount].revents = 0;
+            uiFdCount++;
+        }
+        else
+        {
+            for (uiRadio=0; uiRadio<uiRadioCount_l; uiRadio++)
+            {
+                FdSet[uiFdCount].fd = RF95GetIrqFD(uiRadio);
+                FdSet[uiFdCount].events = RF95GetIrqEvents(uiRadio);
+                FdSet[uiFdCount].revents = 0;
+                uiFdCount++;
+            }
+        }
 
-        iRes = poll(FdSet, 1, 1000);
+        // wake up in time to forward packets whose hold time for further copies has elapsed
+        iRes = poll(FdSet, uiFdCount, RddGetTimeout(RtmGetTimeUs(), 1000));
         if (iRes < 0)
         {
             // ignore poll() errors if the application is to be terminated with Ctrl + C
             if ( fRunMainLoop_l )
             {
-                printf("\nERROR: poll() failed!\n");
+                BLG_ERROR("\nERROR: poll() failed!\n");
+                fRunMainLoop_l = false;
+                RsmStop();
+                if ( RadioThread.joinable() )
+                {
+                    RadioThread.join();
+                }
+                MrpStop();
+                MskStop(MSK_DEF_DRAIN_TIMEOUT);
+                MrpClose();
+                BlgShutdown();
                 return (-5);
             }
         }
@@ -375,211 +881,137 @@ bool           fRes;
         {
             if ( fVerbose_l )
             {
-                printf(".");
-                fflush(stdout);
+                BLG_INFO(".");
+            }
+        }
+        else if (iRtCpuCore_l >= 0)
+        {
+            // frames read by radio thread (real-time mode)
+            if (FdSet[0].revents & POLLIN)
+            {
+                RxqClearEvent();
+                while ( RxqPop(&RxFrame) )
+                {
+                    AppCaptureRxPacket(&RxFrame);
+                    AppDedupRxPacket(&RxFrame);
+                }
             }
         }
         else
         {
-            if (FdSet[0].revents & POLLPRI)
+            // DIO0 interrupt (normal mode)
+            for (uiRadio=0; uiRadio<uiRadioCount_l; uiRadio++)
             {
-                // catch receive TimeStamp
-                tmTimeStamp = time(NULL);
-                FormatTimeStamp(tmTimeStamp, szTimeStamp, sizeof(szTimeStamp));
-
-                // Reading the GPIO (with an implicitly lssek()) is necessary after an interrupt has been
-                // occured to clear the interrupt event of the file descriptor. Without reading the GPIO
-                // the generated event will be signaled forever. As a result the poll() function returns
-                // immediately on every call without waiting for the next event.
-                //
-                // see: https://stackoverflow.com/questions/37620578/poll-not-blocking-returns-immediately
-                // "After poll(2) returns, either lseek(2) to the beginning of the sysfs file and
-                // read the new value or close the file and re-open it to read the value."
-                iGpioState = GpioRead(GPIO_PIN_IRQ);
-                TRACE3("\n%s : GPIO BCM.%d interrupt occurred -> GpioState=%d\n", szTimeStamp, GPIO_PIN_IRQ, iGpioState);
-
-                // read received LoRa data package from RF95 Module
-                uiRxDataBuffLen = sizeof(abRxDataBuff) - 1;
-                fRxValid = RF95GetRecvDataPacket(abRxDataBuff, &uiRxDataBuffLen, &i8LastRssi);
-                if ( fRxValid )
+                if (FdSet[uiRadio].revents & FdSet[uiRadio].events)
                 {
-                    uiRxPacketCntr++;
-                    printf("\n%s : LoRa Message received (LoRaPacket: %04u, RSSI: %d [dB])\n", szTimeStamp, uiRxPacketCntr, (int)i8LastRssi);
-                    if ( fVerbose_l )
-                    {
-                        DumpDataBuffer(abRxDataBuff, uiRxDataBuffLen);
-                    }
-
-                    // decode and evaluate received LoRa message data package
-                    iRes = PprGainLoraDataRecord(uiMsgID, tmTimeStamp, i8LastRssi,
-                                                 abRxDataBuff, uiRxDataBuffLen,
-                                                 &LoraMsgData, &fIsKnownLoraMsgFormat);
-                    if (iRes != 0)
-                    {
-                        printf("\nERROR: PprGainLoraDataRecord() failed (iRes=%d)!\n\n", iRes);
-                        continue;
-                    }
-                    if ( !fIsKnownLoraMsgFormat )
-                    {
-                        printf("\nINVALID DATA: Unknown LoRa Message Format\n\n", iRes);
-                        continue;
-                    }
-                    printf("DevID: %02u, LoraPacketType: %s\n", (uint)LoraMsgData.m_iLoraDevID, GetLoraPacketTypeName(LoraMsgData.m_LoraPacketType));
-                    if ( fVerbose_l )
-                    {
-                        PprPrintLoraDataRecord(&LoraMsgData);
-                    }
-
-                    // build JSON Message List from received LoRa Packet
-                    iRes = PprBuildJsonMessages(&LoraMsgData, &vecJsonMessages);
-                    if (iRes < 0)
-                    {
-                        printf("\nERROR: PprBuildJsonMessages() failed (iRes=%d)!\n\n", iRes);
-                        continue;
-                    }
-
-                    if ( fVerbose_l )
-                    {
-                        printf("\n=== JSON Messages ===\n");
-                    }
-
-                    // evaluate Message by Messge from List, whether it is to be processed or not
-                    // (by passing the loop from the last to the first element, the messages are processed
-                    // in the order Gen2/Gen1/Gen0 from LoRa Packet, so that when publishing the MQTT messages
-                    // their historical order keeps preserved)
-                    for (iIdx=vecJsonMessages.size()-1; iIdx>=0; iIdx--)
+                    if ( AppReadRxPacket(uiRadio, &RxFrame) )
                     {
-                        JsonMessage = vecJsonMessages.at(iIdx);
-                        if ( !fProcAllMsg_l )
-                        {
-                            // check if Message is to be processed (ignore duplicates)
-                            iMessageToBeProcessed = MquIsMessageToBeProcessed(&JsonMessage);
-                            if (iMessageToBeProcessed < 1)
-                            {
-                                if ( fVerbose_l )
-                                {
-                                    printf(" Ignore JsonMessage[%d]\n", iIdx);
-                                }
-                                // skip Message to be ignored
-                                continue;
-                            }
-                        }
-
-                        // continue with Message to be processed
-                        if ( fVerbose_l )
-                        {
-                            printf(" Process JsonMessage[%d]:\n", iIdx);
-                            PprPrintJsonMessage(&JsonMessage);
-                            if ( !fProcAllMsg_l )
-                            {
-                                MquPrintSequNumHistList();
-                            }
-                            printf("\n");
-                        }
-                        // log Message to MessageFile
-                        if (pszMsgFileName_l != NULL)
-                        {
-                            MfwWriteMessage(&JsonMessage);
-                        }
-
-                        // send received LoRa Message to MQTT Broker
-                        if ( !fOffline_l )
-                        {
-                            // send Bootup or Data Message to MQTT Broker
-                            BuildMqttPublishTopic(&JsonMessage, szMqttTopic, sizeof(szMqttTopic));
-                            pabMqttMsgBuff = (uint8_t*)JsonMessage.m_strJsonRecord.c_str();
-                            uiMqttMsgBuffLen = (uint)JsonMessage.m_strJsonRecord.length();
-                            if ( fVerbose_l )
-                            {
-                                MqttPrintMessage(szMqttTopic, pabMqttMsgBuff, uiMqttMsgBuffLen);
-                            }
-                            printf("Send received LoRa Message to MQTT Broker (LoRaPacket[%04u])... ", uiRxPacketCntr);
-                            iRes = MqttPublishMessage(szMqttTopic, pabMqttMsgBuff, uiMqttMsgBuffLen, kMqttQoS0, 1);
-                            if (iRes != 0)
-                            {
-                                printf("\nERROR: MqttPublishMessage() failed (iRes=%d)!\n\n", iRes);
-                                fMqttReconnect = true;
-                            }
-                            else
-                            {
-                                printf("done.\n");
-                                if ( fVerbose_l )
-                                {
-                                    printf("\n");
-                                }
-                            }
-
-                            // send Telemetry Data Message to MQTT Broker
-                            if ( fTelemetryMsg_l )
-                            {
-                                PprBuildTelemetryMessage(&JsonMessage, (uint8_t*)szMqttMsg, sizeof(szMqttMsg));
-                                printf("Send Telemetry Data Message to MQTT Broker (LoRaPacket[%04u])... ", uiRxPacketCntr);
-                                iRes = MqttPublishMessage(MQTT_TOPIC_TELEMETRY, (uint8_t*)szMqttMsg, strlen(szMqttMsg), kMqttQoS0, 1);
-                                if (iRes != 0)
-                                {
-                                    printf("\nERROR: MqttPublishMessage() failed (iRes=%d)!\n\n", iRes);
-                                    fMqttReconnect = true;
-                                }
-                                else
-                                {
-                                    printf("done.\n");
-                                    if ( fVerbose_l )
-                                    {
-                                        printf("\n");
-                                    }
-                                }
-                            }
-                        }
+                        AppCaptureRxPacket(&RxFrame);
+                        AppDedupRxPacket(&RxFrame);
                     }
+                }
+            }
+        }
 
-                    uiMsgID++;
-                }   // if ( fRxValid )
-            }   // if (FdSet[0].revents & POLLPRI)
+        // process best copy of each packet after its hold time
+        while ( RddGetReadyFrame(&RxFrame, RtmGetTimeUs()) )
+        {
+            AppProcessRxPacket(&RxFrame);
         }
 
-        // send KeepAlive
-        if ( !fOffline_l )
+        // write captured frames to file if they are waiting too long
+        if (pszCaptureFileName_l != NULL)
         {
-            iRes = MqttKeepAlive(MQTT_TOPIC_KEEPALVIE);
-            if (iRes < 0)
-            {
-                printf("\nERROR: MqttKeepAlive() failed (iRes=%d)!\n\n", iRes);
-                fMqttReconnect = true;
-            }
-            if (iRes > 0)
-            {
-                if ( fVerbose_l )
-                {
-                    printf("[KA]");
-                }
-            }
+            PcwService(RtmGetTimeUs());
         }
 
-        // ErrorHandling: reconnet to MQTT Broker if necessary
-        if ( !fOffline_l )
+        // log progress of re-publishing
+        if ( !vecReplayFiles_l.empty() )
         {
-            if ( fMqttReconnect )
-            {
-                printf("\nReanimation: Reconnect to MQTT Broker... ");
-                iRes = MqttReconnect();
-                if (iRes != 0)
-                {
-                    printf("\nERROR: MqttReconnect() failed (iRes=%d)!\n\n", iRes);
-                    fMqttReconnect = true;
-                }
-                else
-                {
-                    printf("done.\n");
-                    if ( fVerbose_l )
-                    {
-                        printf("\n");
-                    }
-                    fMqttReconnect = false;
-                }
-            }
+            AppServiceReplay();
         }
+    }
+
+    RsmStop();
+    if ( RadioThread.joinable() )
+    {
+        RadioThread.join();
+    }
 
-        fflush(stdout);
+    // write pending messages to the sinks and stop their worker threads
+    // (before the BinaryLogger, the sinks log their errors), the checkpoint
+    // of the re-publishing is written after the sink has stopped
+    MrpStop();
+    MskStop(MSK_DEF_DRAIN_TIMEOUT);
+    MrpClose();
+
+    // write all pending log records and stop the BinaryLogger thread
+    BlgShutdown();
+
+    // show duration of FIFO read after DIO0 wakeup (the wakeup delay itself
+    // isn't contained, sysfs GPIO provides no timestamp of the edge, see '-j')
+    if ((iRtCpuCore_l >= 0) || fVerbose_l)
+    {
+        printf("\n");
+        RtmLatencyPrint("Rx Read Duration", &RxReadDurStat_l);
+        printf("\n");
+    }
+    if (iRtCpuCore_l >= 0)
+    {
+        if (RxqGetDropCount() > 0)
+        {
+            printf("WARNING: %u LoRa Packets dropped because of RxQueue overflow!\n\n", RxqGetDropCount());
+        }
+        RxqClose();
+    }
+    if ((uiRadioCount_l > 1) || fVerbose_l)
+    {
+        RddPrintStatistics();
+        printf("\n");
+    }
+    if ((pszCaptureFileName_l != NULL) && fVerbose_l)
+    {
+        PcwPrintStatistics();
+        printf("\n");
+    }
+    if ((pszMsgFileName_l != NULL) && fVerbose_l)
+    {
+        MfwPrintStatistics();
+        printf("\n");
+    }
+    if ((pszStoreFileName_l != NULL) && fVerbose_l)
+    {
+        TssPrintStatistics();
+        printf("\n");
+    }
+    if ((ui16QueryPort_l != 0) && fVerbose_l)
+    {
+        LvcPrintStatistics();
+        printf("\n");
+    }
+    if ((pszShmRingName_l != NULL) && fVerbose_l)
+    {
+        SrwPrintStatistics();
+        printf("\n");
+    }
+    if ((MskGetSinkCount() > 0) && fVerbose_l)
+    {
+        MskPrintStatistics();
+        printf("\n");
+    }
+    if ( !vecReplayFiles_l.empty() )
+    {
+        MrpPrintStatistics();
+        printf("\n");
+    }
+    for (uiSink=0; uiSink<MskGetSinkCount(); uiSink++)
+    {
+        MskGetStatistics(uiSink, &SinkStatistics);
+        if (SinkStatistics.m_ui64Dropped > 0)
+        {
+            printf("WARNING: %llu Messages dropped by Message Sink '%s'!\n\n",
+                   (unsigned long long)SinkStatistics.m_ui64Dropped, SinkStatistics.m_pszName);
+        }
     }
 
 
@@ -606,10 +1038,45 @@ bool           fRes;
         printf("done.\n");
     }
 
+    // close Time Series Store (writes the open blocks)
+    if (pszStoreFileName_l != NULL)
+    {
+        printf("Close Time Series Store... ");
+        TssClose();
+        printf("done.\n");
+    }
+
+    // stop HTTP Query API
+    if (ui16QueryPort_l != 0)
+    {
+        printf("Stop HTTP Query API... ");
+        LvcClose();
+        printf("done.\n");
+    }
+
+    // close Shared Memory Ring (readers are woken up and detach)
+    if (pszShmRingName_l != NULL)
+    {
+        printf("Close Shared Memory Ring... ");
+        SrwClose();
+        printf("done.\n");
+    }
+
+    // close CaptureFile
+    if (pszCaptureFileName_l != NULL)
+    {
+        printf("Close CaptureFile... ");
+        PcwClose();
+        printf("done.\n");
+    }
+
     // close bcm2835 I/O Library
-    printf("Close bcm2835 Library... ");
-    bcm2835_close();
-    printf("done.\n");
+    if (uiSimRadios_l == 0)
+    {
+        printf("Close bcm2835 Library... ");
+        bcm2835_close();
+        printf("done.\n");
+    }
 
 
     return (0);
@@ -652,6 +1119,9 @@ static  bool  AppEvalCmdlnArgs (
 {
 
 char*  pszArg;
+char*  pszSizeArg;
+char*  pszFmtArg;
+char*  pszNumEnd;
 int    iIdx;
 bool   fRes;
 
@@ -676,11 +1146,220 @@ bool   fRes;
                 continue;
             }
 
-            // argument '-l=' -> MessageFile
+            // argument '-l=' -> MessageFile ('file[,bin]')
             if ( !strncasecmp("-l=", pszArg, sizeof("-l=")-1) )
             {
                 pszArg += sizeof("-l=")-1;
                 pszMsgFileName_l = pszArg;
+                pszFmtArg = strrchr(pszArg, ',');
+                if (pszFmtArg != NULL)
+                {
+                    *pszFmtArg++ = '\0';
+                    if ( !strcasecmp("bin", pszFmtArg) )
+                    {
+                        MsgFileFormat_l = kMfwFormatBinary;
+                    }
+                    else if ( !strcasecmp("json", pszFmtArg) )
+                    {
+                        MsgFileFormat_l = kMfwFormatJson;
+                    }
+                    else
+                    {
+                        printf("\nERROR: invalid message file format!\n");
+                        fRes = false;
+                        break;
+                    }
+                }
+                continue;
+            }
+
+            // argument '-w=' -> Rotation of MessageFile ('max_mb[,hours[,z]]')
+            if ( !strncasecmp("-w=", pszArg, sizeof("-w=")-1) )
+            {
+                pszArg += sizeof("-w=")-1;
+                MsgFileRotation_l.m_ui64MaxFileSize = (uint64_t)strtoul(pszArg, &pszNumEnd, 10) * 1024 * 1024;
+                if (*pszNumEnd == ',')
+                {
+                    MsgFileRotation_l.m_uiRotationPeriod = (uint)strtoul(pszNumEnd+1, &pszNumEnd, 10) * 3600;
+                }
+                if ((*pszNumEnd == ',') && !strcasecmp("z", pszNumEnd+1))
+                {
+                    MsgFileRotation_l.m_fCompress = true;
+                    pszNumEnd += 2;
+                }
+                if ( (*pszNumEnd != '\0') || (pszNumEnd == pszArg) ||
+                     ((MsgFileRotation_l.m_ui64MaxFileSize == 0) && (MsgFileRotation_l.m_uiRotationPeriod == 0)) )
+                {
+                    printf("\nERROR: invalid message file rotation!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-k=' -> Retention of rotated MessageFiles ('days[,max_mb]')
+            if ( !strncasecmp("-k=", pszArg, sizeof("-k=")-1) )
+            {
+                pszArg += sizeof("-k=")-1;
+                MsgFileRotation_l.m_uiRetainAge = (uint)strtoul(pszArg, &pszNumEnd, 10) * 86400;
+                if (*pszNumEnd == ',')
+                {
+                    MsgFileRotation_l.m_ui64RetainBytes = (uint64_t)strtoul(pszNumEnd+1, &pszNumEnd, 10) * 1024 * 1024;
+                }
+                if ( (*pszNumEnd != '\0') || (pszNumEnd == pszArg) ||
+                     ((MsgFileRotation_l.m_uiRetainAge == 0) && (MsgFileRotation_l.m_ui64RetainBytes == 0)) )
+                {
+                    printf("\nERROR: invalid message file retention!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-y=' -> Time Series Store
+            if ( !strncasecmp("-y=", pszArg, sizeof("-y=")-1) )
+            {
+                pszArg += sizeof("-y=")-1;
+                pszStoreFileName_l = pszArg;
+                continue;
+            }
+
+            // argument '-q' -> HTTP Query API ('[bind_addr:]port')
+            if ( !strncasecmp("-q", pszArg, sizeof("-q")-1) )
+            {
+                pszArg += sizeof("-q")-1;
+                ui16QueryPort_l = LVC_DEF_PORT;
+                if (*pszArg == '=')
+                {
+                    pszArg++;
+                    pszSizeArg = strrchr(pszArg, ':');
+                    if (pszSizeArg != NULL)
+                    {
+                        *pszSizeArg++ = '\0';
+                        pszQueryBindAddr_l = pszArg;
+                        pszArg = pszSizeArg;
+                    }
+                    ui16QueryPort_l = (uint16_t)strtoul(pszArg, &pszNumEnd, 10);
+                    if ((*pszNumEnd != '\0') || (pszNumEnd == pszArg))
+                    {
+                        ui16QueryPort_l = 0;
+                    }
+                }
+                if (ui16QueryPort_l == 0)
+                {
+                    printf("\nERROR: invalid query port!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-x' -> Shared Memory Ring ('[name]')
+            if ( !strncasecmp("-x", pszArg, sizeof("-x")-1) )
+            {
+                pszArg += sizeof("-x")-1;
+                pszShmRingName_l = SRF_DEF_NAME;
+                if (*pszArg == '=')
+                {
+                    pszShmRingName_l = pszArg + 1;
+                }
+                if ((pszShmRingName_l[0] != '/') || (strchr(pszShmRingName_l+1, '/') != NULL))
+                {
+                    printf("\nERROR: invalid name of shared memory ring!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-c=' -> CaptureFile ('file[,max_mb]')
+            if ( !strncasecmp("-c=", pszArg, sizeof("-c=")-1) )
+            {
+                pszArg += sizeof("-c=")-1;
+                pszCaptureFileName_l = pszArg;
+                pszSizeArg = strrchr(pszArg, ',');
+                if (pszSizeArg != NULL)
+                {
+                    *pszSizeArg++ = '\0';
+                    uiCaptureMaxSizeMB_l = (uint)atoi(pszSizeArg);
+                    if (uiCaptureMaxSizeMB_l == 0)
+                    {
+                        printf("\nERROR: invalid capture file size!\n");
+                        fRes = false;
+                        break;
+                    }
+                }
+                if (*pszCaptureFileName_l == '\0')
+                {
+                    printf("\nERROR: invalid capture file name!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-e=' -> Re-publish MessageFiles ('file[,file...]', can be given several times)
+            if ( !strncasecmp("-e=", pszArg, sizeof("-e=")-1) )
+            {
+                pszArg += sizeof("-e=")-1;
+                for (pszArg=strtok(pszArg, ","); pszArg!=NULL; pszArg=strtok(NULL, ","))
+                {
+                    vecReplayFiles_l.push_back(pszArg);
+                }
+                if ( vecReplayFiles_l.empty() )
+                {
+                    printf("\nERROR: invalid replay file name!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-g=' -> Rate of re-publishing ('rate[,burst]')
+            if ( !strncasecmp("-g=", pszArg, sizeof("-g=")-1) )
+            {
+                pszArg += sizeof("-g=")-1;
+                uiReplayRate_l = (uint)strtoul(pszArg, &pszNumEnd, 10);
+                if (*pszNumEnd == ',')
+                {
+                    uiReplayBurst_l = (uint)strtoul(pszNumEnd+1, &pszNumEnd, 10);
+                }
+                if ((*pszNumEnd != '\0') || (pszNumEnd == pszArg) || (uiReplayBurst_l == 0))
+                {
+                    printf("\nERROR: invalid replay rate!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-i=' -> Time range of re-publishing ('from[,to]')
+            if ( !strncasecmp("-i=", pszArg, sizeof("-i=")-1) )
+            {
+                pszArg += sizeof("-i=")-1;
+                pszSizeArg = strchr(pszArg, ',');
+                if (pszSizeArg != NULL)
+                {
+                    *pszSizeArg++ = '\0';
+                    fRes = MrpParseTime(pszSizeArg, true, &i64ReplayToTime_l);
+                }
+                if ( fRes && (*pszArg != '\0') )
+                {
+                    fRes = MrpParseTime(pszArg, false, &i64ReplayFromTime_l);
+                }
+                if ( !fRes || (i64ReplayFromTime_l > i64ReplayToTime_l) )
+                {
+                    printf("\nERROR: invalid replay time range!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-u=' -> Message Sink of re-publishing
+            if ( !strncasecmp("-u=", pszArg, sizeof("-u=")-1) )
+            {
+                pszReplaySink_l = pszArg + sizeof("-u=")-1;
                 continue;
             }
 
@@ -705,12 +1384,138 @@ bool   fRes;
                 continue;
             }
 
+            // argument '-p' -> Line Protocol
+            if ( !strncasecmp("-p", pszArg, sizeof("-p")-1) )
+            {
+                fLineProtocol_l = true;
+                continue;
+            }
+
             // argument '-v' -> Verbose
             if ( !strncasecmp("-v", pszArg, sizeof("-v")-1) )
             {
                 fVerbose_l = true;
                 continue;
             }
+
+            // argument '-d=' -> LogLevel
+            if ( !strncasecmp("-d=", pszArg, sizeof("-d=")-1) )
+            {
+                pszArg += sizeof("-d=")-1;
+                iLogLevel_l = atoi(pszArg);
+                if ((iLogLevel_l < kBlgLevelError) || (iLogLevel_l > kBlgLevelTrace))
+                {
+                    printf("\nERROR: invalid log level!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-r=' -> RealTime Mode ('core[,prio]')
+            if ( !strncasecmp("-r=", pszArg, sizeof("-r=")-1) )
+            {
+                pszArg += sizeof("-r=")-1;
+                iRtPriority_l = RTM_DEF_PRIORITY;
+                if ((sscanf(pszArg, "%d,%d", &iRtCpuCore_l, &iRtPriority_l) < 1) ||
+                    (iRtCpuCore_l < 0) || (iRtPriority_l < 1) || (iRtPriority_l > 99))
+                {
+                    printf("\nERROR: invalid real-time settings!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-j=' -> Jitter Test
+            if ( !strncasecmp("-j=", pszArg, sizeof("-j=")-1) )
+            {
+                pszArg += sizeof("-j=")-1;
+                uiJitterTestTm_l = (uint)atoi(pszArg);
+                if (uiJitterTestTm_l == 0)
+                {
+                    printf("\nERROR: invalid jitter test time!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-m=' -> additional RF95 Module ('cs,irq,rst,frequ[,sf]')
+            if ( !strncasecmp("-m=", pszArg, sizeof("-m=")-1) )
+            {
+                pszArg += sizeof("-m=")-1;
+                fRes = AppParseRadioCfg(pszArg);
+                if ( !fRes )
+                {
+                    printf("\nERROR: invalid radio configuration!\n");
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-s=' -> Simulated Radios
+            if ( !strncasecmp("-s=", pszArg, sizeof("-s=")-1) )
+            {
+                pszArg += sizeof("-s=")-1;
+                uiSimRadios_l = (uint)atoi(pszArg);
+                if ((uiSimRadios_l == 0) || (uiSimRadios_l > RF95_MAX_RADIOS))
+                {
+                    printf("\nERROR: invalid number of simulated radios!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-n=' -> SPI clock and transport ('clock_khz[,spi_dev]')
+            if ( !strncasecmp("-n=", pszArg, sizeof("-n=")-1) )
+            {
+                pszArg += sizeof("-n=")-1;
+                uiSpiClockKHz_l = (uint)strtoul(pszArg, &pszNumEnd, 10);
+                if ((*pszNumEnd == ',') && (pszNumEnd[1] != '\0'))
+                {
+                    pszSpiDev_l = pszNumEnd + 1;
+                    pszNumEnd += strlen(pszNumEnd);
+                }
+                if ((*pszNumEnd != '\0') || (pszNumEnd == pszArg) || (uiSpiClockKHz_l > RF95_SPI_MAX_CLOCK_KHZ))
+                {
+                    printf("\nERROR: invalid SPI configuration!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-z' -> SPI Benchmark ('[=frames]')
+            if ( !strncasecmp("-z", pszArg, sizeof("-z")-1) )
+            {
+                pszArg += sizeof("-z")-1;
+                uiSpiBenchFrames_l = RF95_SPI_BENCH_FRAMES;
+                if (*pszArg == '=')
+                {
+                    pszArg++;
+                    uiSpiBenchFrames_l = (uint)strtoul(pszArg, &pszNumEnd, 10);
+                    if ((*pszNumEnd != '\0') || (pszNumEnd == pszArg))
+                    {
+                        uiSpiBenchFrames_l = 0;
+                    }
+                }
+                if (uiSpiBenchFrames_l == 0)
+                {
+                    printf("\nERROR: invalid number of SPI benchmark frames!\n");
+                    fRes = false;
+                    break;
+                }
+                continue;
+            }
+
+            // argument '-b' -> Benchmark of BinaryLogger
+            if ( !strncasecmp("-b", pszArg, sizeof("-b")-1) )
+            {
+                fLogBenchmark_l = true;
+                continue;
+            }
         }
 
         fRes = false;
@@ -738,8 +1543,55 @@ static  void  AppPrintHelpScreen (
     printf("       -h=<host_url>   Host URL of MQTT Broker in format URL[:Port]\n");
     printf("                       (default: %s:%d)\n", MQTT_DEF_HOST_URL, MQTT_DEF_HOST_PORTNUM);
     printf("\n");
-    printf("       -l=<msg_file>   Logs all Messages sent via MQTT to the specified file\n");
-    printf("                       (the file is opened always in APPEND mode)\n");
+    printf("       -l=<msg_file>[,bin]\n");
+    printf("                       Logs all Messages sent via MQTT to the specified file\n");
+    printf("                       (the file is opened always in APPEND mode), with 'bin'\n");
+    printf("                       as compact binary MessageLog (see tool 'LoraMsgLog')\n");
+    printf("\n");
+    printf("       -w=<max_mb>[,<hours>[,z]]\n");
+    printf("                       Rotate MessageFile before it exceeds <max_mb> MB and/or\n");
+    printf("                       every <hours> (0 = no limit), rotated files are renamed\n");
+    printf("                       to '<msg_file>_YYYYMMDD-hhmmss', with 'z' they are\n");
+    printf("                       compressed with gzip in the background\n");
+    printf("\n");
+    printf("       -k=<days>[,<max_mb>]\n");
+    printf("                       Delete rotated MessageFiles older than <days> and/or the\n");
+    printf("                       oldest ones while all MessageFiles need more than\n");
+    printf("                       <max_mb> MB (0 = no limit)\n");
+    printf("\n");
+    printf("       -y=<store_file> Store the values of all Data Records per DevID and field\n");
+    printf("                       in a compressed Time Series Store with min/hour/day\n");
+    printf("                       rollups (query and rebuild with tool 'LoraMsgLog')\n");
+    printf("\n");
+    printf("       -q[=[<bind_addr>:]<port>]\n");
+    printf("                       Serve the last Data and Bootup Record of each DevID as\n");
+    printf("                       Json via HTTP (default: %s:%u), e.g. '/devices'\n", LVC_DEF_BIND_ADDR, (uint)LVC_DEF_PORT);
+    printf("\n");
+    printf("       -x[=<shm_name>] Publish all Messages as binary records into a Shared\n");
+    printf("                       Memory Ring for local consumers (default: '%s',\n", SRF_DEF_NAME);
+    printf("                       reader library 'ShmRingReader', see 'LoraMsgLog -s')\n");
+    printf("\n");
+    printf("       -c=<cap_file>[,<max_mb>]\n");
+    printf("                       Capture all received raw frames (before decoding and\n");
+    printf("                       deduplication) in pcap format with LoRaTap header,\n");
+    printf("                       optionally rotated to a new file after <max_mb> MB\n");
+    printf("\n");
+    printf("       -e=<msg_file>[,<msg_file>...]\n");
+    printf("                       Re-publish archived MessageFiles (Json or binary, e.g.\n");
+    printf("                       rotated files in chronological order) besides the live\n");
+    printf("                       Messages, which always go first; the position is kept in\n");
+    printf("                       '<first msg_file>%s', a new start continues from there\n", MRP_CHECKPOINT_EXTENSION);
+    printf("\n");
+    printf("       -g=<rate>[,<burst>]\n");
+    printf("                       Max. Messages/s re-published (0 = unlimited) and burst\n");
+    printf("                       (default: %u/s, burst %u)\n", MRP_DEF_RATE, MRP_DEF_BURST);
+    printf("\n");
+    printf("       -i=[<from>][,<to>]\n");
+    printf("                       Re-publish only records of this time range, either\n");
+    printf("                       seconds since 1970 or 'YYYY/MM/DD[-hh:mm[:ss]]'\n");
+    printf("\n");
+    printf("       -u=<sink>       Message Sink to re-publish to: 'MQTT', 'Store' or 'File'\n");
+    printf("                       (default: '%s', others only from binary MessageLogs)\n", APP_REPLAY_DEF_SINK);
     printf("\n");
     printf("       -a              Process all received LoRa Packets, including duplicates\n");
     printf("\n");
@@ -747,13 +1599,897 @@ static  void  AppPrintHelpScreen (
     printf("\n");
     printf("       -o              Run in Offline Mode, without MQTT connection\n");
     printf("\n");
+    printf("       -p              Additionally send Messages in InfluxDB Line Protocol\n");
+    printf("                       (Topic 'LoraAmbMon/Line/DevID<nnn>/...')\n");
+    printf("\n");
     printf("       -v              Run in Verbose Mode\n");
     printf("\n");
-    printf("       --help          Shows this Help Screen\n");
+    printf("       -d=<level>      Log Level for Console Output (default: %d)\n", kBlgLevelInfo);
+    printf("                       (0=Error, 1=Warning, 2=Info, 3=Debug, 4=Trace)\n");
     printf("\n");
-    printf("       Known Bugs:     Running without 'sudo' leads to a segmentation fault in\n");
-    printf("                       lib 'RadioHead' (github.com/idreamsi/RadioHead)\n");
+    printf("       -b              Run Benchmark of BinaryLogger vs. printf and exit\n");
+    printf("\n");
+    printf("       -r=<core>[,<prio>]  Real-Time Mode: service the radio in a separate thread\n");
+    printf("                       pinned to <core> with SCHED_FIFO <prio> (default: %d),\n", RTM_DEF_PRIORITY);
+    printf("                       memory is locked, other threads avoid <core>\n");
+    printf("\n");
+    printf("       -j=<sec>        Measure wakeup jitter under synthetic CPU load with\n");
+    printf("                       default and real-time scheduling and exit\n");
+    printf("\n");
+    printf("       -m=<cs>,<irq>,<rst>,<frequ>[,<sf>]\n");
+    printf("                       Use RF95 Module with the given BCM pins, frequency [MHz]\n");
+    printf("                       and spreading factor (7..12), can be given up to %u times,\n", RF95_MAX_RADIOS);
+    printf("                       copies of a packet received by several modules are merged\n");
+    printf("                       (default: RF95 HAT, CS=%d, IRQ=%d, RST=%d, %3.2fMHz)\n", GPIO_PIN_CS, GPIO_PIN_IRQ, GPIO_PIN_RST, RF_FREQUENCY);
     printf("\n");
+    printf("       -s=<radios>     Use simulated radios and LoRa nodes instead of RF95 Modules\n");
+    printf("                       (no hardware access, for test and commissioning purposes)\n");
+    printf("\n");
+    printf("       -n=<clock_khz>[,<spi_dev>]\n");
+    printf("                       SPI clock of RF95 Modules (max. %u kHz, 0 = default of RadioHead)\n", RF95_SPI_MAX_CLOCK_KHZ);
+    printf("                       and SPI device: '/dev/spidevX.Y' or '%s' (no hardware,\n", RF95_SPI_DEV_LOOPBACK);
+    printf("                       reads back sent bytes), default: SPI0 by bcm2835 library\n");
+    printf("\n");
+    printf("       -z[=<frames>]   Measure SPI read time per frame (per byte vs. bulk transfers)\n");
+    printf("                       with first RF95 Module and exit (default: %u frames)\n", RF95_SPI_BENCH_FRAMES);
+    printf("\n");
+    printf("       --help          Shows this Help Screen\n");
+    printf("\n");
+    printf("       Known Bugs:     Running without 'sudo' leads to a segmentation fault in\n");
+    printf("                       lib 'RadioHead' (github.com/idreamsi/RadioHead)\n");
+    printf("\n");
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Parse configuration of RF95 Module (option '-m=')
+//---------------------------------------------------------------------------
+
+static  bool  AppParseRadioCfg (
+    const char* pszRadioCfg_p)
+{
+
+tAppRadioCfg*  pRadioCfg;
+int            iGpioPinCS;
+int            iGpioPinIRQ;
+int            iGpioPinRST;
+float          flFrequency;
+int            iSpreadFactor;
+int            iRes;
+
+
+    if (uiRadioCount_l >= RF95_MAX_RADIOS)
+    {
+        return (false);
+    }
+
+    iSpreadFactor = 0;
+    iRes = sscanf(pszRadioCfg_p, "%d,%d,%d,%f,%d", &iGpioPinCS, &iGpioPinIRQ, &iGpioPinRST, &flFrequency, &iSpreadFactor);
+    if (iRes < 4)
+    {
+        return (false);
+    }
+    if ((iGpioPinCS  < 0) || (iGpioPinCS  > 31) ||
+        (iGpioPinIRQ < 0) || (iGpioPinIRQ > 31) ||
+        (iGpioPinRST < 0) || (iGpioPinRST > 31))
+    {
+        return (false);
+    }
+    if ((iSpreadFactor != 0) && ((iSpreadFactor < 7) || (iSpreadFactor > 12)))
+    {
+        return (false);
+    }
+
+    pRadioCfg = &aRadioCfg_l[uiRadioCount_l];
+    pRadioCfg->m_ui8GpioPinCS    = (uint8_t)iGpioPinCS;
+    pRadioCfg->m_ui8GpioPinIRQ   = (uint8_t)iGpioPinIRQ;
+    pRadioCfg->m_ui8GpioPinRST   = (uint8_t)iGpioPinRST;
+    pRadioCfg->m_flFrequency     = flFrequency;
+    pRadioCfg->m_ui8SpreadFactor = (uint8_t)iSpreadFactor;
+    uiRadioCount_l++;
+
+    return (true);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Read received LoRa Packet from RF95 Module after DIO0 Interrupt
+//---------------------------------------------------------------------------
+
+static  bool  AppReadRxPacket (
+    uint uiRadio_p,                                     // [IN]     Index of Radio
+    tRxqFrame* pRxFrame_p)                              // [OUT]    Ptr to Frame Buffer
+{
+
+bool  fRxValid;
+
+
+    // catch receive TimeStamp (return of poll(), not the DIO0 edge itself)
+    pRxFrame_p->m_ui64WakeTimeUs = RtmGetTimeUs();
+    pRxFrame_p->m_tmTimeStamp = time(NULL);
+
+    // clear interrupt event of the file descriptor
+    RF95AckIrq(uiRadio_p);
+
+    // read received LoRa data package from RF95 Module
+    // (SNR costs an additional SPI transfer and is only needed for the CaptureFile)
+    pRxFrame_p->m_uiDataLen = sizeof(pRxFrame_p->m_abData) - 1;
+    pRxFrame_p->m_i8Snr = 0;
+    fRxValid = RF95GetRecvDataPacket(uiRadio_p, pRxFrame_p->m_abData, &pRxFrame_p->m_uiDataLen, &pRxFrame_p->m_i8Rssi,
+                                     ((pszCaptureFileName_l != NULL) ? &pRxFrame_p->m_i8Snr : NULL));
+    pRxFrame_p->m_ui64ReadTimeUs = RtmGetTimeUs();
+    if ( fRxValid )
+    {
+        pRxFrame_p->m_uiRxPacketCntr = ++uiRxPacketCntr_l;
+        pRxFrame_p->m_uiRadio        = uiRadio_p;
+        pRxFrame_p->m_uiRadioMask    = (1u << uiRadio_p);
+        RtmLatencyAdd(&RxReadDurStat_l, (uint32_t)(pRxFrame_p->m_ui64ReadTimeUs - pRxFrame_p->m_ui64WakeTimeUs));
+    }
+
+    return (fRxValid);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Radio Thread (real-time mode)
+//---------------------------------------------------------------------------
+//  Only waits for the DIO0 interrupt, reads the FIFO and passes the frame
+//  to the main loop. Decoding, file and MQTT I/O and console formatting
+//  stay on the non-realtime threads.
+
+static  void  AppRadioThread (void)
+{
+
+struct pollfd  FdSet[RF95_MAX_RADIOS];
+tRxqFrame      RxFrame;
+uint           uiRadio;
+int            iRes;
+
+
+    iRes = RtmSetupRealtimeThread(iRtCpuCore_l, iRtPriority_l);
+    BlgRegisterThread();
+    if (iRes != 0)
+    {
+        BLG_WARNING("\nWARNING: RtmSetupRealtimeThread() failed (iRes=%d), radio thread runs with default scheduling!\n", iRes);
+    }
+    else
+    {
+        BLG_INFO("\nRadio thread running on CPU Core %d (SCHED_FIFO, Priority %d)\n", iRtCpuCore_l, iRtPriority_l);
+    }
+
+    while ( fRunMainLoop_l )
+    {
+        for (uiRadio=0; uiRadio<uiRadioCount_l; uiRadio++)
+        {
+            FdSet[uiRadio].fd = RF95GetIrqFD(uiRadio);
+            FdSet[uiRadio].events = RF95GetIrqEvents(uiRadio);
+            FdSet[uiRadio].revents = 0;
+        }
+
+        // timeout is only used to check the termination flag
+        iRes = poll(FdSet, uiRadioCount_l, 1000);
+        if (iRes <= 0)
+        {
+            continue;
+        }
+
+        for (uiRadio=0; uiRadio<uiRadioCount_l; uiRadio++)
+        {
+            if ((FdSet[uiRadio].revents & FdSet[uiRadio].events) == 0)
+            {
+                continue;
+            }
+            if ( AppReadRxPacket(uiRadio, &RxFrame) )
+            {
+                if ( !RxqPush(&RxFrame) )
+                {
+                    BLG_ERROR("\nERROR: RxQueue overflow, LoRaPacket[%04u] dropped!\n", RxFrame.m_uiRxPacketCntr);
+                }
+            }
+        }
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Write received LoRa Packet to CaptureFile
+//---------------------------------------------------------------------------
+//  Called by the main loop for each frame as read from the RF95 Module,
+//  also for copies and frames that can't be decoded. The frame is only
+//  copied into the write buffer of the PcapWriter.
+
+static  void  AppCaptureRxPacket (
+    const tRxqFrame* pRxFrame_p)                        // [IN]     Ptr to received Frame
+{
+
+const tAppRadioCfg*  pRadioCfg;
+float                flFrequency;
+uint                 uiSpreadFactor;
+int                  iRes;
+
+
+    if (pszCaptureFileName_l == NULL)
+    {
+        return;
+    }
+
+    // simulated radios have no configuration, they run with the default settings
+    pRadioCfg = &aRadioCfg_l[pRxFrame_p->m_uiRadio];
+    flFrequency    = (pRadioCfg->m_flFrequency > 0) ? pRadioCfg->m_flFrequency : RF_FREQUENCY;
+    uiSpreadFactor = (pRadioCfg->m_ui8SpreadFactor != 0) ? (uint)pRadioCfg->m_ui8SpreadFactor : RF95_DEF_SPREAD_FACTOR;
+
+    iRes = PcwWriteFrame(pRxFrame_p, (uint32_t)(flFrequency * 1000000.0 + 0.5), RF95_DEF_BANDWIDTH_KHZ, uiSpreadFactor);
+    if (iRes < 0)
+    {
+        BLG_ERROR("\nERROR: PcwWriteFrame() failed (iRes=%d), LoRaPacket[%04u] not captured!\n", iRes, pRxFrame_p->m_uiRxPacketCntr);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Pass received LoRa Packet to Cross-Radio Deduplication
+//---------------------------------------------------------------------------
+
+static  void  AppDedupRxPacket (
+    const tRxqFrame* pRxFrame_p)                        // [IN]     Ptr to received Frame
+{
+
+int  iRes;
+
+
+    iRes = RddAddFrame(pRxFrame_p, RtmGetTimeUs());
+    if (iRes < 0)
+    {
+        // deduplication table full -> don't wait for further copies
+        BLG_WARNING("\nWARNING: RddAddFrame() failed (iRes=%d), LoRaPacket[%04u] processed without deduplication!\n", iRes, pRxFrame_p->m_uiRxPacketCntr);
+        AppProcessRxPacket(pRxFrame_p);
+    }
+    else if (iRes > 0)
+    {
+        BLG_DEBUG("\nLoRaPacket[%04u] (Radio %u, RSSI: %d [dB]) is a copy of a packet received by another radio\n",
+                  pRxFrame_p->m_uiRxPacketCntr, pRxFrame_p->m_uiRadio, (int)pRxFrame_p->m_i8Rssi);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Decode received LoRa Packet and forward resulting Messages
+//---------------------------------------------------------------------------
+
+static  int  AppProcessRxPacket (
+    const tRxqFrame* pRxFrame_p)                        // [IN]     Ptr to received Frame
+{
+
+std::vector<tJsonMessage>  vecJsonMessages;
+tLoraMsgData   LoraMsgData;
+tJsonMessage   JsonMessage;
+char           szTimeStamp[64];
+bool           fIsKnownLoraMsgFormat;
+int            iMessageToBeProcessed;
+int            iIdx;
+int            iRes;
+
+
+    FormatTimeStamp(pRxFrame_p->m_tmTimeStamp, szTimeStamp, sizeof(szTimeStamp));
+    if (uiRadioCount_l > 1)
+    {
+        BLG_INFO("\n%s : LoRa Message received (LoRaPacket: %04u, RSSI: %d [dB], Radio: %u, RadioMask: 0x%02X)\n",
+                 szTimeStamp, pRxFrame_p->m_uiRxPacketCntr, (int)pRxFrame_p->m_i8Rssi, pRxFrame_p->m_uiRadio, pRxFrame_p->m_uiRadioMask);
+    }
+    else
+    {
+        BLG_INFO("\n%s : LoRa Message received (LoRaPacket: %04u, RSSI: %d [dB])\n", szTimeStamp, pRxFrame_p->m_uiRxPacketCntr, (int)pRxFrame_p->m_i8Rssi);
+    }
+    if ( fVerbose_l )
+    {
+        BlgFlush();
+        DumpDataBuffer(pRxFrame_p->m_abData, pRxFrame_p->m_uiDataLen);
+    }
+
+    // decode and evaluate received LoRa message data package
+    iRes = PprGainLoraDataRecord(uiMsgID_l, pRxFrame_p->m_tmTimeStamp, pRxFrame_p->m_i8Rssi,
+                                 pRxFrame_p->m_abData, pRxFrame_p->m_uiDataLen,
+                                 &LoraMsgData, &fIsKnownLoraMsgFormat);
+    if (iRes != 0)
+    {
+        BLG_ERROR("\nERROR: PprGainLoraDataRecord() failed (iRes=%d)!\n\n", iRes);
+        return (-1);
+    }
+    if ( !fIsKnownLoraMsgFormat )
+    {
+        BLG_WARNING("\nINVALID DATA: Unknown LoRa Message Format\n\n");
+        return (-2);
+    }
+    BLG_INFO("DevID: %02u, LoraPacketType: %s\n", (uint)LoraMsgData.m_iLoraDevID, GetLoraPacketTypeName(LoraMsgData.m_LoraPacketType));
+    if ( fVerbose_l )
+    {
+        BlgFlush();
+        PprPrintLoraDataRecord(&LoraMsgData);
+    }
+
+    // build JSON Message List from received LoRa Packet
+    iRes = PprBuildJsonMessages(&LoraMsgData, &vecJsonMessages);
+    if (iRes < 0)
+    {
+        BLG_ERROR("\nERROR: PprBuildJsonMessages() failed (iRes=%d)!\n\n", iRes);
+        return (-3);
+    }
+
+    if ( fVerbose_l )
+    {
+        BLG_INFO("\n=== JSON Messages ===\n");
+    }
+
+    // evaluate Message by Messge from List, whether it is to be processed or not
+    // (by passing the loop from the last to the first element, the messages are processed
+    // in the order Gen2/Gen1/Gen0 from LoRa Packet, so that when publishing the MQTT messages
+    // their historical order keeps preserved)
+    for (iIdx=vecJsonMessages.size()-1; iIdx>=0; iIdx--)
+    {
+        JsonMessage = vecJsonMessages.at(iIdx);
+        if ( !fProcAllMsg_l )
+        {
+            // check if Message is to be processed (ignore duplicates)
+            iMessageToBeProcessed = MquIsMessageToBeProcessed(&JsonMessage);
+            if (iMessageToBeProcessed < 1)
+            {
+                if ( fVerbose_l )
+                {
+                    BLG_INFO(" Ignore JsonMessage[%d]\n", iIdx);
+                }
+                // skip Message to be ignored
+                continue;
+            }
+        }
+
+        // continue with Message to be processed, local consumers get it
+        // first (publishing to Shared Memory Ring never blocks)
+        if (pszShmRingName_l != NULL)
+        {
+            SrwPublish(&JsonMessage);
+        }
+        if ( fVerbose_l )
+        {
+            BLG_INFO(" Process JsonMessage[%d]:\n", iIdx);
+            BlgFlush();
+            PprPrintJsonMessage(&JsonMessage);
+            if ( !fProcAllMsg_l )
+            {
+                MquPrintSequNumHistList();
+            }
+            BLG_INFO("\n");
+        }
+        // update Last Value Cache of HTTP Query API (lock-free, never blocks)
+        if (ui16QueryPort_l != 0)
+        {
+            LvcUpdate(&JsonMessage);
+        }
+
+        // hand over Message to MessageFile, Time Series Store and MQTT Broker,
+        // each of them is written by its own worker thread
+        MskDispatch(&JsonMessage);
+    }
+
+
+    uiMsgID_l++;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Setup Message Sinks
+//---------------------------------------------------------------------------
+
+static  void  AppSetupSinks (void)
+{
+
+tMskSinkCfg  SinkCfg;
+int          iRes;
+
+
+    printf("Setup Message Sinks...\n");
+
+    // MessageFile: backpressure instead of losing records (SD card busy)
+    if (pszMsgFileName_l != NULL)
+    {
+        memset(&SinkCfg, 0, sizeof(SinkCfg));
+        SinkCfg.m_pszName           = "File";
+        SinkCfg.m_pfnWrite          = AppFileSinkWrite;
+        SinkCfg.m_uiQueueSize       = APP_FILE_SINK_QUEUE_SIZE;
+        SinkCfg.m_uiMaxBatch        = MSK_DEF_MAX_BATCH;
+        SinkCfg.m_OverflowPolicy    = kMskOverflowBlock;
+        SinkCfg.m_uiBlockTimeout    = APP_FILE_SINK_BLOCK_TIME;
+        iRes = MskAddSink(&SinkCfg);
+        printf("  File      = queue %u, block %u ms (iRes=%d)\n", SinkCfg.m_uiQueueSize, SinkCfg.m_uiBlockTimeout, iRes);
+    }
+
+    // Time Series Store: can be rebuilt from the MessageFile, never blocks
+    if (pszStoreFileName_l != NULL)
+    {
+        memset(&SinkCfg, 0, sizeof(SinkCfg));
+        SinkCfg.m_pszName           = "Store";
+        SinkCfg.m_pfnWrite          = AppStoreSinkWrite;
+        SinkCfg.m_uiQueueSize       = APP_STORE_SINK_QUEUE_SIZE;
+        SinkCfg.m_uiMaxBatch        = MSK_DEF_MAX_BATCH;
+        SinkCfg.m_OverflowPolicy    = kMskOverflowDropNewest;
+        iRes = MskAddSink(&SinkCfg);
+        printf("  Store     = queue %u, drop newest (iRes=%d)\n", SinkCfg.m_uiQueueSize, iRes);
+    }
+
+    // MQTT Broker: messages are kept while the Broker isn't reachable
+    if ( !fOffline_l )
+    {
+        memset(&SinkCfg, 0, sizeof(SinkCfg));
+        SinkCfg.m_pszName           = "MQTT";
+        SinkCfg.m_pfnWrite          = AppMqttSinkWrite;
+        SinkCfg.m_pfnWriteBackfill  = AppMqttSinkWriteReplay;
+        SinkCfg.m_pfnService        = AppMqttSinkService;
+        SinkCfg.m_uiQueueSize       = APP_MQTT_SINK_QUEUE_SIZE;
+        SinkCfg.m_uiMaxBatch        = APP_MQTT_SINK_MAX_BATCH;
+        SinkCfg.m_OverflowPolicy    = kMskOverflowDropOldest;
+        SinkCfg.m_uiServiceInterval = APP_MQTT_SERVICE_INTERVAL;
+        SinkCfg.m_uiRetryDelay      = APP_MQTT_RETRY_DELAY;
+        iRes = MskAddSink(&SinkCfg);
+        printf("  MQTT      = queue %u, drop oldest, retry %u ms (iRes=%d)\n", SinkCfg.m_uiQueueSize, SinkCfg.m_uiRetryDelay, iRes);
+    }
+
+    printf("done.\n");
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Setup Re-Publishing of archived MessageFiles (option '-e=')
+//---------------------------------------------------------------------------
+
+static  void  AppSetupReplay (void)
+{
+
+tMrpConfig      ReplayCfg;
+tMrpStatistics  ReplayStatistics;
+int             iSink;
+int             iRes;
+
+
+    printf("Open MessageFiles to re-publish (%u file(s))... ", (uint)vecReplayFiles_l.size());
+
+    iSink = MskFindSink(pszReplaySink_l);
+    if (iSink < 0)
+    {
+        printf("failed (no Message Sink '%s')!\n\n", pszReplaySink_l);
+        vecReplayFiles_l.clear();
+        return;
+    }
+
+    memset(&ReplayCfg, 0, sizeof(ReplayCfg));
+    ReplayCfg.m_apszMsgFiles      = vecReplayFiles_l.data();
+    ReplayCfg.m_uiMsgFiles        = (uint)vecReplayFiles_l.size();
+    ReplayCfg.m_i64FromTime       = i64ReplayFromTime_l;
+    ReplayCfg.m_i64ToTime         = i64ReplayToTime_l;
+    ReplayCfg.m_uiRate            = uiReplayRate_l;
+    ReplayCfg.m_uiBurst           = uiReplayBurst_l;
+    ReplayCfg.m_uiSink            = (uint)iSink;
+    ReplayCfg.m_fBinaryOnly       = (strcasecmp(pszReplaySink_l, "MQTT") != 0);    // Json Record only is enough for MQTT
+    iRes = MrpOpen(&ReplayCfg);
+    if (iRes < 0)
+    {
+        printf("failed (iRes=%d)!\n\n", iRes);
+        vecReplayFiles_l.clear();
+        return;
+    }
+    printf("done.\n");
+
+    MrpGetStatistics(&ReplayStatistics);
+    if ( ReplayStatistics.m_fDone )
+    {
+        printf("  already complete (%llu Messages), delete '%s%s' to start over\n",
+               (unsigned long long)ReplayStatistics.m_ui64PublishedTotal, vecReplayFiles_l[0], MRP_CHECKPOINT_EXTENSION);
+    }
+    else
+    {
+        printf("  %u chunks (%.1f MB), %llu Messages published by previous runs\n", ReplayStatistics.m_uiChunks,
+               (double)ReplayStatistics.m_ui64BytesTotal / (1024.0 * 1024.0), (unsigned long long)ReplayStatistics.m_ui64PublishedTotal);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Log Progress of Re-Publishing (Main Loop)
+//---------------------------------------------------------------------------
+
+static  void  AppServiceReplay (void)
+{
+
+tMrpStatistics  ReplayStatistics;
+time_t          tmNow;
+
+
+    if (tmReplayProgress_l < 0)
+    {
+        return;                                         // completion already logged
+    }
+
+    tmNow = time(NULL);
+    if ( !MrpIsDone() && (tmNow < tmReplayProgress_l + (time_t)APP_REPLAY_PROGRESS_INTERVAL) )
+    {
+        return;
+    }
+    tmReplayProgress_l = tmNow;
+
+    MrpGetStatistics(&ReplayStatistics);
+    BLG_INFO("Re-Publishing: %llu Messages, %u/%u chunks, %.1f messages/s%s\n",
+             (unsigned long long)ReplayStatistics.m_ui64Published, ReplayStatistics.m_uiChunksDone,
+             ReplayStatistics.m_uiChunks, ReplayStatistics.m_dThroughput,
+             (ReplayStatistics.m_fDone ? " -> complete" : ""));
+    if ( ReplayStatistics.m_fDone )
+    {
+        tmReplayProgress_l = -1;
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Message Sink: write Messages to MessageFile (Worker Thread)
+//---------------------------------------------------------------------------
+
+static  uint  AppFileSinkWrite (
+    const tJsonMessage* const* apJsonMessage_p,
+    uint uiCount_p,
+    uint* puiFailed_p,
+    void* pArg_p)
+{
+
+uint  uiIdx;
+int   iRes;
+
+
+    (void)pArg_p;                                       // no Context needed
+
+    for (uiIdx=0; uiIdx<uiCount_p; uiIdx++)
+    {
+        iRes = MfwWriteMessage(apJsonMessage_p[uiIdx]);
+        if (iRes < 0)
+        {
+            BLG_ERROR("\nERROR: MfwWriteMessage() failed (iRes=%d)!\n\n", iRes);
+            (*puiFailed_p)++;
+        }
+    }
+
+    return (uiCount_p);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Message Sink: add Data Records to Time Series Store (Worker Thread)
+//---------------------------------------------------------------------------
+
+static  uint  AppStoreSinkWrite (
+    const tJsonMessage* const* apJsonMessage_p,
+    uint uiCount_p,
+    uint* puiFailed_p,
+    void* pArg_p)
+{
+
+uint  uiIdx;
+int   iRes;
+
+
+    (void)pArg_p;                                       // no Context needed
+
+    for (uiIdx=0; uiIdx<uiCount_p; uiIdx++)
+    {
+        iRes = TssAddMessage(apJsonMessage_p[uiIdx]);
+        if (iRes < 0)
+        {
+            BLG_ERROR("\nERROR: TssAddMessage() failed (iRes=%d)!\n\n", iRes);
+            (*puiFailed_p)++;
+        }
+    }
+
+    return (uiCount_p);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Message Sink: publish Messages to MQTT Broker (Worker Thread)
+//---------------------------------------------------------------------------
+//  Stops at the first message the Broker didn't accept, this and all
+//  following messages are passed again after the reconnect. A message whose
+//  Line Protocol record was lost counts as handled, but failed.
+
+static  uint  AppMqttSinkWrite (
+    const tJsonMessage* const* apJsonMessage_p,
+    uint uiCount_p,
+    uint* puiFailed_p,
+    void* pArg_p)
+{
+
+uint  uiIdx;
+int   iRes;
+
+
+    (void)pArg_p;                                       // no Context needed
+
+    for (uiIdx=0; uiIdx<uiCount_p; uiIdx++)
+    {
+        if ( fMqttReconnect_l )
+        {
+            break;
+        }
+        iRes = AppPublishMessage(apJsonMessage_p[uiIdx], false);
+        if (iRes < 0)
+        {
+            break;
+        }
+        if (iRes > 0)
+        {
+            (*puiFailed_p)++;                           // Line Protocol record lost
+        }
+    }
+
+    return (uiIdx);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Message Sink: publish re-published Messages to MQTT Broker (Worker Thread)
+//---------------------------------------------------------------------------
+
+static  uint  AppMqttSinkWriteReplay (
+    const tJsonMessage* const* apJsonMessage_p,
+    uint uiCount_p,
+    uint* puiFailed_p,
+    void* pArg_p)
+{
+
+uint  uiIdx;
+int   iRes;
+
+
+    (void)pArg_p;                                       // no Context needed
+
+    for (uiIdx=0; uiIdx<uiCount_p; uiIdx++)
+    {
+        if ( fMqttReconnect_l )
+        {
+            break;
+        }
+        iRes = AppPublishMessage(apJsonMessage_p[uiIdx], true);
+        if (iRes < 0)
+        {
+            break;
+        }
+        if (iRes > 0)
+        {
+            (*puiFailed_p)++;                           // Line Protocol record lost
+        }
+    }
+
+    return (uiIdx);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Message Sink: MQTT KeepAlive and Reconnect (Worker Thread)
+//---------------------------------------------------------------------------
+
+static  void  AppMqttSinkService (
+    void* pArg_p)
+{
+
+    (void)pArg_p;                                       // no Context needed
+
+    AppServiceMqtt();
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Publish Json Message to MQTT Broker
+//---------------------------------------------------------------------------
+//  Returns -1 if the Bootup or Data Message itself couldn't be published
+//  (it is passed again after the reconnect) and 1 if only its Line Protocol
+//  record couldn't be published (it is lost and counted as failed by the
+//  Sink). A failed Telemetry Message only triggers a reconnect.
+//  Re-published Messages aren't logged one by one and don't count as
+//  Telemetry, the Line Protocol is only sent if the record carries it
+//  (not re-published from a Json MessageFile).
+
+static  int  AppPublishMessage (
+    const tJsonMessage* pJsonMessage_p,
+    bool fReplay_p)
+{
+
+char      szMqttTopic[64];
+char      szMqttMsg[128];
+uint8_t*  pabMqttMsgBuff;
+uint      uiMqttMsgBuffLen;
+int       iLineRes;
+int       iRes;
+
+
+    iLineRes = 0;
+
+    // send Bootup or Data Message to MQTT Broker
+    BuildMqttPublishTopic(pJsonMessage_p, false, szMqttTopic, sizeof(szMqttTopic));
+    pabMqttMsgBuff = (uint8_t*)pJsonMessage_p->m_strJsonRecord.c_str();
+    uiMqttMsgBuffLen = (uint)pJsonMessage_p->m_strJsonRecord.length();
+    if ( fVerbose_l )
+    {
+        BlgFlush();
+        MqttPrintMessage(szMqttTopic, pabMqttMsgBuff, uiMqttMsgBuffLen);
+    }
+    if ( !fReplay_p )
+    {
+        BLG_INFO("Send received LoRa Message to MQTT Broker (MsgID[%04u])... ", pJsonMessage_p->m_uiMsgID);
+    }
+    iRes = MqttPublishMessage(szMqttTopic, pabMqttMsgBuff, uiMqttMsgBuffLen, kMqttQoS0, 1);
+    if (iRes != 0)
+    {
+        BLG_ERROR("\nERROR: MqttPublishMessage() failed (iRes=%d)!\n\n", iRes);
+        fMqttReconnect_l = true;
+        return (-1);
+    }
+    if ( !fReplay_p )
+    {
+        BLG_INFO("done.\n");
+        if ( fVerbose_l )
+        {
+            BLG_INFO("\n");
+        }
+    }
+
+    // send same Message in Line Protocol to MQTT Broker
+    if ( fLineProtocol_l && !pJsonMessage_p->m_strLineRecord.empty() )
+    {
+        BuildMqttPublishTopic(pJsonMessage_p, true, szMqttTopic, sizeof(szMqttTopic));
+        pabMqttMsgBuff = (uint8_t*)pJsonMessage_p->m_strLineRecord.c_str();
+        uiMqttMsgBuffLen = (uint)pJsonMessage_p->m_strLineRecord.length();
+        if ( fVerbose_l )
+        {
+            BlgFlush();
+            MqttPrintMessage(szMqttTopic, pabMqttMsgBuff, uiMqttMsgBuffLen);
+        }
+        if ( !fReplay_p )
+        {
+            BLG_INFO("Send Line Protocol Message to MQTT Broker (MsgID[%04u])... ", pJsonMessage_p->m_uiMsgID);
+        }
+        iRes = MqttPublishMessage(szMqttTopic, pabMqttMsgBuff, uiMqttMsgBuffLen, kMqttQoS0, 1);
+        if (iRes != 0)
+        {
+            BLG_ERROR("\nERROR: MqttPublishMessage() failed (iRes=%d)!\n\n", iRes);
+            fMqttReconnect_l = true;
+            iLineRes = 1;
+        }
+        else if ( !fReplay_p )
+        {
+            BLG_INFO("done.\n");
+        }
+    }
+
+    // send Telemetry Data Message to MQTT Broker
+    if ( fTelemetryMsg_l && !fReplay_p )
+    {
+        PprBuildTelemetryMessage(pJsonMessage_p, (uint8_t*)szMqttMsg, sizeof(szMqttMsg));
+        BLG_INFO("Send Telemetry Data Message to MQTT Broker (MsgID[%04u])... ", pJsonMessage_p->m_uiMsgID);
+        iRes = MqttPublishMessage(MQTT_TOPIC_TELEMETRY, (uint8_t*)szMqttMsg, strlen(szMqttMsg), kMqttQoS0, 1);
+        if (iRes != 0)
+        {
+            BLG_ERROR("\nERROR: MqttPublishMessage() failed (iRes=%d)!\n\n", iRes);
+            fMqttReconnect_l = true;
+        }
+        else
+        {
+            BLG_INFO("done.\n");
+            if ( fVerbose_l )
+            {
+                BLG_INFO("\n");
+            }
+        }
+    }
+
+    return (iLineRes);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Send MQTT KeepAlive and reconnect to Broker if necessary
+//---------------------------------------------------------------------------
+
+static  void  AppServiceMqtt (void)
+{
+
+int  iRes;
+
+
+    // send KeepAlive
+    if ( !fOffline_l )
+    {
+        iRes = MqttKeepAlive(MQTT_TOPIC_KEEPALVIE);
+        if (iRes < 0)
+        {
+            BLG_ERROR("\nERROR: MqttKeepAlive() failed (iRes=%d)!\n\n", iRes);
+            fMqttReconnect_l = true;
+        }
+        if (iRes > 0)
+        {
+            if ( fVerbose_l )
+            {
+                BLG_INFO("[KA]");
+            }
+        }
+    }
+
+    // ErrorHandling: reconnet to MQTT Broker if necessary
+    if ( !fOffline_l )
+    {
+        if ( fMqttReconnect_l )
+        {
+            BLG_INFO("\nReanimation: Reconnect to MQTT Broker... ");
+            iRes = MqttReconnect();
+            if (iRes != 0)
+            {
+                BLG_ERROR("\nERROR: MqttReconnect() failed (iRes=%d)!\n\n", iRes);
+                fMqttReconnect_l = true;
+            }
+            else
+            {
+                BLG_INFO("done.\n");
+                if ( fVerbose_l )
+                {
+                    BLG_INFO("\n");
+                }
+                fMqttReconnect_l = false;
+            }
+        }
+    }
 
     return;
 
@@ -767,6 +2503,7 @@ static  void  AppPrintHelpScreen (
 
 static  int  BuildMqttPublishTopic (
     const tJsonMessage* pJsonMessage_p,
+    bool fLineProtocol_p,
     char* pszTopicBuffer_p,
     int iTopicBuffSize_p)
 {
@@ -796,15 +2533,16 @@ const char*      pszTopicTemplate;
     {
         case kLoraPacketBootup:
         {
-            pszTopicTemplate = MQTT_TOPIC_TMPL_BOOTUP;
+            pszTopicTemplate = (fLineProtocol_p ? MQTT_TOPIC_TMPL_LN_BOOT : MQTT_TOPIC_TMPL_BOOTUP);
             break;
         }
 
         case kLoraPacketDataGen0:
         case kLoraPacketDataGen1:
         case kLoraPacketDataGen2:
+        case kLoraPacketDataGenN:
         {
-            pszTopicTemplate = MQTT_TOPIC_TMPL_ST_DATA;
+            pszTopicTemplate = (fLineProtocol_p ? MQTT_TOPIC_TMPL_LN_DATA : MQTT_TOPIC_TMPL_ST_DATA);
             break;
         }
 
@@ -852,8 +2590,9 @@ static const char*  pszPacketTypeName;
         case kLoraPacketDataGen0:
         case kLoraPacketDataGen1:
         case kLoraPacketDataGen2:
+        case kLoraPacketDataGenN:
         {
-            pszPacketTypeName = "{DataGen0/1/2}";
+            pszPacketTypeName = "{DataGen0..N}";
             break;
         }
 
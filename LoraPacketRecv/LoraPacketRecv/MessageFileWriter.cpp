@@ -10,6 +10,12 @@
   Revision History:
 
   2023/03/25 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Optional binary MessageLog
+  2026/10/18 -rs:   V1.02 Sparse Time/DevID Index
+  2026/10/18 -rs:   V1.03 Rotation, Compression and Retention of MessageFiles
+  2026/10/18 -rs:   V1.04 Build of binary Record is public (Shared Memory Ring)
+  2026/10/18 -rs:   V1.05 MfwWriteMessage() takes const Json Message (Message Sinks)
+  2026/10/18 -rs:   V1.06 Time of Segment Name built by strftime()
 
 ****************************************************************************/
 
@@ -24,15 +30,35 @@
 #include <stdio.h>
 #include <iostream>
 #include <vector>
+#include <deque>
+#include <string>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
 #include <string.h>
+#include <errno.h>
 #include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <stddef.h>
+#include <zlib.h>
 #include "LoraPacket.h"
+#include "LoraPacketSchema.h"
 #include "LoraPayloadDecoder.h"
 #include "PacketProcessing.h"
 #include "MessageQualification.h"
 #include "MessageFileWriter.h"
+#include "MessageLogFormat.h"
+#include "MessageIndex.h"
 #include "Trace.h"
 
 
@@ -59,6 +85,15 @@
 
 static  const char*     JSON_REC_DELIMITER  = "\n\n";
 
+static  const char*     COMPRESS_EXTENSION  = ".gz";
+static  const char*     TEMP_EXTENSION      = ".tmp";
+static  const size_t    SEGMENT_TIME_LEN    = 15;               // 'YYYYMMDD-HHMMSS'
+
+//  I/O priority of background thread (see linux/ioprio.h)
+static  const int       IOPRIO_WHO_PROCESS  = 1;
+static  const int       IOPRIO_CLASS_IDLE   = 3;
+static  const int       IOPRIO_CLASS_SHIFT  = 13;
+
 
 
 //---------------------------------------------------------------------------
@@ -71,6 +106,18 @@ static  const char*     JSON_REC_DELIMITER  = "\n\n";
 //  Local types
 //---------------------------------------------------------------------------
 
+//  rotated MessageFile found in the directory of the MessageFile
+typedef struct
+{
+    std::string         m_strFileName;              // Path/Name incl. COMPRESS_EXTENSION
+    std::string         m_strIndexFileName;
+    bool                m_fCompressed;
+    bool                m_fTemporary;               // incomplete output of an interrupted compression
+    uint64_t            m_ui64Size;                 // incl. IndexFile [bytes]
+    time_t              m_tmModified;               // time of last record
+
+} tMfwSegment;
+
 
 
 //---------------------------------------------------------------------------
@@ -84,6 +131,26 @@ static  const char*     JSON_REC_DELIMITER  = "\n\n";
 //---------------------------------------------------------------------------
 
 static  int             iFdMessageFile_l    = -1;
+static  tMfwFormat      MsgFileFormat_l     = kMfwFormatJson;
+static  uint64_t        ui64FileOffset_l    = 0;        // offset of next record
+static  bool            fIndexActive_l      = false;
+static  std::string     strMsgFileName_l;
+static  uint            uiIndexBlockRecords_l = 0;
+static  bool            fSyncWrite_l        = false;
+static  tMfwRotationCfg RotationCfg_l;
+static  int64_t         i64RotationSlot_l   = 0;        // rotation period of current file
+
+//  The background thread compresses rotated segments and applies the
+//  retention rules, so that MfwWriteMessage() is never blocked by them.
+//  It only accesses segments, never the current MessageFile.
+static  std::thread             BackgroundThread_l;
+static  std::mutex              BackgroundMutex_l;      // protects all following variables
+static  std::condition_variable BackgroundCond_l;
+static  std::deque<std::string> deqCompressJobs_l;
+static  bool                    fRetentionPending_l = false;
+static  bool                    fBackgroundBusy_l   = false;
+static  std::atomic<bool>       fStopBackground_l (false);
+static  tMfwStatistics          MfwStatistics_l;
 
 
 
@@ -92,7 +159,43 @@ static  int             iFdMessageFile_l    = -1;
 //---------------------------------------------------------------------------
 
 static  std::string  BuildJsonRec (
-    tJsonMessage* pJsonMessage_p);                      // [IN] Ptr to Json Message
+    const tJsonMessage* pJsonMessage_p);                      // [IN] Ptr to Json Message
+
+static  int  MfwOpenFile (void);
+
+static  int  MfwPrepareBinaryFile (void);
+
+static  bool  MfwIsRotationDue (
+    uint uiRecLen_p);                                   // [IN] Size of next Record
+
+static  int  MfwRotate (void);
+
+static  int64_t  MfwGetRotationSlot (
+    time_t tmTime_p);                                   // [IN] Time to get Rotation Period for
+
+static  std::string  MfwBuildSegmentName (
+    time_t tmTime_p);                                   // [IN] Time of Rotation
+
+static  void  MfwSplitFileName (
+    std::string* pstrDir_p,                             // [OUT] Directory of MessageFile
+    std::string* pstrStem_p,                            // [OUT] File Name without Extension
+    std::string* pstrExt_p);                            // [OUT] Extension (incl. '.')
+
+static  void  MfwListSegments (
+    std::vector<tMfwSegment>* pvecSegments_p);          // [OUT] Ptr to Vector with Segments (oldest first)
+
+static  void  MfwBackgroundThread (void);
+
+static  int  MfwCompressSegment (
+    const std::string& strFileName_p);                  // [IN] Path/Name of Segment
+
+static  void  MfwApplyRetention (void);
+
+static  uint64_t  MfwGetTimeUs (void);
+
+static  void  MfwIndexRecord (
+    const tJsonMessage* pJsonMessage_p,                 // [IN] Ptr to Json Message
+    uint32_t ui32RecLen_p);                             // [IN] Size of written Record
 
 static  inline  std::string  Trim (
     std::string& strData_p);
@@ -110,26 +213,66 @@ static  inline  std::string  Trim (
 //---------------------------------------------------------------------------
 //  MfwOpen
 //---------------------------------------------------------------------------
+//  A binary MessageLog is continued if its header matches the current
+//  format and schema, otherwise it is rejected (it's never overwritten).
+//  Without an usable IndexFile ('<msg_file>.idx') the MessageFile is
+//  written nevertheless, the reader then scans the unindexed records.
+//  With compression or retention the background thread is started, it
+//  first completes the work left over by a previous run.
 
 int  MfwOpen (
-    const char* pszMsgFileName_p)                       // [IN] Path/Name of MessageFile
+    const char* pszMsgFileName_p,                       // [IN] Path/Name of MessageFile
+    tMfwFormat MsgFileFormat_p,                         // [IN] Format of MessageFile
+    uint uiIndexBlockRecords_p,                         // [IN] Records per Index Entry (0 = no Index)
+    bool fSyncWrite_p,                                  // [IN] Write each Message synchronously (O_SYNC)
+    const tMfwRotationCfg* pRotationCfg_p)              // [IN] Ptr to Rotation Configuration (NULL = no rotation)
 {
 
-mode_t  OpenMode;
+struct stat  FileStat;
+int          iRes;
 
 
     if (pszMsgFileName_p == NULL)
     {
         return (-1);
     }
+    if (iFdMessageFile_l >= 0)
+    {
+        return (-1);
+    }
 
-    OpenMode = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
+    strMsgFileName_l      = pszMsgFileName_p;
+    MsgFileFormat_l       = MsgFileFormat_p;
+    uiIndexBlockRecords_l = uiIndexBlockRecords_p;
+    fSyncWrite_l          = fSyncWrite_p;
+    memset(&RotationCfg_l, 0, sizeof(RotationCfg_l));
+    if (pRotationCfg_p != NULL)
+    {
+        RotationCfg_l = *pRotationCfg_p;
+    }
+    memset(&MfwStatistics_l, 0, sizeof(MfwStatistics_l));
 
-    iFdMessageFile_l = open(pszMsgFileName_p, (O_CREAT | O_WRONLY | O_APPEND | O_SYNC), OpenMode);
-    TRACE2("\nOpen MsgFile: pszMsgFileName_p='%s' -> iFdMessageFile_l=%d\n", pszMsgFileName_p, iFdMessageFile_l);
-    if (iFdMessageFile_l < 0)
+    iRes = MfwOpenFile();
+    if (iRes < 0)
     {
-        return (-2);
+        return (iRes);
+    }
+
+    // records of a previous run belong to the period of their last write
+    i64RotationSlot_l = MfwGetRotationSlot(time(NULL));
+    if ( (ui64FileOffset_l > ((MsgFileFormat_l == kMfwFormatBinary) ? MLF_HEADER_SIZE : 0)) &&
+         (stat(pszMsgFileName_p, &FileStat) == 0) )
+    {
+        i64RotationSlot_l = MfwGetRotationSlot(FileStat.st_mtime);
+    }
+
+    if ( RotationCfg_l.m_fCompress || (RotationCfg_l.m_uiRetainAge > 0) || (RotationCfg_l.m_ui64RetainBytes > 0) )
+    {
+        fStopBackground_l   = false;
+        fRetentionPending_l = false;
+        fBackgroundBusy_l   = true;                     // until the segments of a previous run are checked
+        deqCompressJobs_l.clear();
+        BackgroundThread_l  = std::thread(MfwBackgroundThread);
     }
 
     return (0);
@@ -141,6 +284,8 @@ mode_t  OpenMode;
 //---------------------------------------------------------------------------
 //  MfwClose
 //---------------------------------------------------------------------------
+//  A running compression is aborted, the segment stays uncompressed and is
+//  compressed after the next MfwOpen().
 
 int  MfwClose ()
 {
@@ -150,6 +295,22 @@ int  MfwClose ()
         return (-1);
     }
 
+    if ( BackgroundThread_l.joinable() )
+    {
+        {
+            std::lock_guard<std::mutex> Lock(BackgroundMutex_l);
+            fStopBackground_l = true;
+        }
+        BackgroundCond_l.notify_all();
+        BackgroundThread_l.join();
+    }
+
+    if ( fIndexActive_l )
+    {
+        MixClose();
+        fIndexActive_l = false;
+    }
+
     close(iFdMessageFile_l);
     iFdMessageFile_l = -1;
 
@@ -164,10 +325,11 @@ int  MfwClose ()
 //---------------------------------------------------------------------------
 
 int  MfwWriteMessage (
-    tJsonMessage* pJsonMessage_p)                       // [IN] Ptr to Json Message
+    const tJsonMessage* pJsonMessage_p)                       // [IN] Ptr to Json Message
 {
 
 std::string  strJsonRecord;
+tMlfRecord   MlfRecord;
 const char*  pszMsgData;
 size_t       nMsgDataLen;
 int          iRes;
@@ -182,16 +344,51 @@ int          iRes;
         return (-2);
     }
 
-    strJsonRecord = BuildJsonRec(pJsonMessage_p);
+    if (MsgFileFormat_l == kMfwFormatBinary)
+    {
+        MfwBuildBinaryRecord(pJsonMessage_p, &MlfRecord);
+        pszMsgData  = (const char*)&MlfRecord;
+        nMsgDataLen = sizeof(MlfRecord);
+    }
+    else
+    {
+        strJsonRecord = BuildJsonRec(pJsonMessage_p);
+        pszMsgData  = strJsonRecord.c_str();
+        nMsgDataLen = strJsonRecord.length();
+    }
 
-    pszMsgData  = strJsonRecord.c_str();
-    nMsgDataLen = strJsonRecord.length();
+    // rotation happens before the record is written, so that no record is
+    // split across two files and the record isn't lost if it fails
+    if ( MfwIsRotationDue((uint)nMsgDataLen) )
+    {
+        iRes = MfwRotate();
+        if (iRes < 0)
+        {
+            return (-5);
+        }
+    }
+
+    // a single write() of one complete record, so that a record is never interleaved
     iRes = write(iFdMessageFile_l, pszMsgData, nMsgDataLen);
-    TRACE3("\nWrite MsgFile: pszMsgData='%s', nMsgDataLen=%d -> iRes=%d\n", pszMsgData, nMsgDataLen, iRes);
+    if (MsgFileFormat_l == kMfwFormatBinary)
+    {
+        TRACE3("\nWrite MsgFile: MsgID=%u, nMsgDataLen=%u -> iRes=%d\n", pJsonMessage_p->m_uiMsgID, (uint)nMsgDataLen, iRes);
+    }
+    else
+    {
+        TRACE3("\nWrite MsgFile: pszMsgData='%s', nMsgDataLen=%d -> iRes=%d\n", pszMsgData, nMsgDataLen, iRes);
+    }
     if (iRes < 0)
     {
         return (-3);
     }
+    if (iRes != (int)nMsgDataLen)
+    {
+        // incomplete record isn't indexed, next block starts behind it
+        ui64FileOffset_l += (uint64_t)iRes;
+        return (-4);
+    }
+    MfwIndexRecord(pJsonMessage_p, (uint32_t)nMsgDataLen);
 
     return (0);
 
@@ -199,6 +396,109 @@ int          iRes;
 
 
 
+//---------------------------------------------------------------------------
+//  Build binary Record
+//---------------------------------------------------------------------------
+//  Also used for the records of the Shared Memory Ring (ShmRingWriter).
+
+void  MfwBuildBinaryRecord (
+    const tJsonMessage* pJsonMessage_p,                 // [IN] Ptr to Json Message
+    tMlfRecord* pMlfRecord_p)                           // [OUT] Ptr to binary Record
+{
+
+const tPprRecordFields*  pRecordFields;
+
+
+    static_assert(sizeof(pRecordFields->m_SchemaRec) <= MLF_SCHEMA_REC_SIZE, "raw record doesn't fit into <tMlfRecord>");
+
+    pRecordFields = &pJsonMessage_p->m_RecordFields;
+
+    memset(pMlfRecord_p, 0, sizeof(tMlfRecord));
+    pMlfRecord_p->m_ui16RecLen          = (uint16_t)sizeof(tMlfRecord);
+    pMlfRecord_p->m_ui8PacketType       = (uint8_t)pRecordFields->m_PacketType;
+    pMlfRecord_p->m_ui8DevID            = pRecordFields->m_ui8DevID;
+    pMlfRecord_p->m_ui32MsgID           = (uint32_t)pRecordFields->m_uiMsgID;
+    pMlfRecord_p->m_i64TimeStamp        = (int64_t)pRecordFields->m_tmTimeStamp;
+    pMlfRecord_p->m_i64RxTimeStamp      = (int64_t)pJsonMessage_p->m_tmTimeStamp;
+    pMlfRecord_p->m_ui32SequNum         = pRecordFields->m_ui32SequNum;
+    pMlfRecord_p->m_ui32Uptime          = pRecordFields->m_ui32Uptime;
+    pMlfRecord_p->m_i8Rssi              = pRecordFields->m_i8Rssi;
+    pMlfRecord_p->m_ui8DataGen          = (uint8_t)pRecordFields->m_uiDataGen;
+    pMlfRecord_p->m_ui8FirmwareVersion  = pRecordFields->m_ui8FirmwareVersion;
+    pMlfRecord_p->m_ui8FirmwareRevision = pRecordFields->m_ui8FirmwareRevision;
+    pMlfRecord_p->m_ui8SchemaRecLen     = (uint8_t)sizeof(pRecordFields->m_SchemaRec);
+    memcpy(pMlfRecord_p->m_abSchemaRec, &pRecordFields->m_SchemaRec, sizeof(pRecordFields->m_SchemaRec));
+    pMlfRecord_p->m_ui32CRC32           = MlfCrc32(pMlfRecord_p, offsetof(tMlfRecord, m_ui32CRC32));
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Check if Background Thread has nothing to do
+//---------------------------------------------------------------------------
+
+bool  MfwIsBackgroundIdle (void)
+{
+
+std::lock_guard<std::mutex>  Lock(BackgroundMutex_l);
+
+
+    return ( !fBackgroundBusy_l && deqCompressJobs_l.empty() && !fRetentionPending_l );
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Statistics
+//---------------------------------------------------------------------------
+
+void  MfwGetStatistics (
+    tMfwStatistics* pStatistics_p)                      // [OUT] Ptr to Statistics
+{
+
+std::lock_guard<std::mutex>  Lock(BackgroundMutex_l);
+
+
+    memcpy(pStatistics_p, &MfwStatistics_l, sizeof(tMfwStatistics));
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Print Statistics
+//---------------------------------------------------------------------------
+
+void  MfwPrintStatistics (void)
+{
+
+tMfwStatistics  Statistics;
+
+
+    MfwGetStatistics(&Statistics);
+
+    printf("MessageFile Rotation:\n");
+    printf("  Rotations         = %u (errors: %u)\n", Statistics.m_uiRotations, Statistics.m_uiRotationErrors);
+    printf("  Rotation time     = avg %u us, max %u us\n",
+           (Statistics.m_uiRotations > 0) ? (uint)(Statistics.m_ui64RotationSumUs / Statistics.m_uiRotations) : 0,
+           (uint)Statistics.m_ui32RotationMaxUs);
+    printf("  Files compressed  = %u (errors: %u)\n", Statistics.m_uiFilesCompressed, Statistics.m_uiCompressErrors);
+    printf("  Compression ratio = %.2f\n",
+           (Statistics.m_ui64BytesUncompressed > 0) ? ((double)Statistics.m_ui64BytesCompressed / (double)Statistics.m_ui64BytesUncompressed) : 0.0);
+    printf("  Files deleted     = %u (%llu bytes)\n", Statistics.m_uiFilesDeleted, (unsigned long long)Statistics.m_ui64BytesDeleted);
+
+    return;
+
+}
+
+
+
 
 
 //=========================================================================//
@@ -212,7 +512,7 @@ int          iRes;
 //---------------------------------------------------------------------------
 
 static  std::string  BuildJsonRec (
-    tJsonMessage* pJsonMessage_p)                       // [IN] Ptr to Json Message
+    const tJsonMessage* pJsonMessage_p)                       // [IN] Ptr to Json Message
 {
 
 std::string  strJsonRecord;
@@ -237,6 +537,820 @@ std::string  strJsonRecord;
 
 
 
+//---------------------------------------------------------------------------
+//  Open MessageFile and its IndexFile
+//---------------------------------------------------------------------------
+
+static  int  MfwOpenFile (void)
+{
+
+struct stat  FileStat;
+mode_t       OpenMode;
+int          iOpenFlags;
+bool         fNewFile;
+int          iRes;
+
+
+    OpenMode = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
+
+    iOpenFlags = O_CREAT | O_RDWR | O_APPEND;
+    if ( fSyncWrite_l )
+    {
+        iOpenFlags |= O_SYNC;
+    }
+
+    fIndexActive_l = false;
+    iFdMessageFile_l = open(strMsgFileName_l.c_str(), iOpenFlags, OpenMode);
+    TRACE2("\nOpen MsgFile: strMsgFileName_l='%s' -> iFdMessageFile_l=%d\n", strMsgFileName_l.c_str(), iFdMessageFile_l);
+    if (iFdMessageFile_l < 0)
+    {
+        return (-2);
+    }
+
+    fNewFile = ((fstat(iFdMessageFile_l, &FileStat) == 0) && (FileStat.st_size == 0));
+
+    if (MsgFileFormat_l == kMfwFormatBinary)
+    {
+        iRes = MfwPrepareBinaryFile();
+        if (iRes < 0)
+        {
+            close(iFdMessageFile_l);
+            iFdMessageFile_l = -1;
+            return (-3);
+        }
+    }
+
+    if (fstat(iFdMessageFile_l, &FileStat) != 0)
+    {
+        close(iFdMessageFile_l);
+        iFdMessageFile_l = -1;
+        return (-4);
+    }
+    ui64FileOffset_l = (uint64_t)FileStat.st_size;
+
+    // entries of an old index can't belong to a new MessageFile
+    if (uiIndexBlockRecords_l > 0)
+    {
+        iRes = MixOpen(MixGetIndexFileName(strMsgFileName_l.c_str()).c_str(), uiIndexBlockRecords_l, fNewFile);
+        TRACE1("\nOpen IndexFile -> iRes=%d\n", iRes);
+        fIndexActive_l = (iRes >= 0);
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Check/Write File Header of binary MessageLog
+//---------------------------------------------------------------------------
+//  A new (empty) file gets its header. For an existing file the header is
+//  checked, and an incomplete last record (e.g. after a power failure) is
+//  cut off, so that all following records are aligned again.
+
+static  int  MfwPrepareBinaryFile (void)
+{
+
+tMlfFileHeader  MlfFileHeader;
+struct stat     FileStat;
+off_t           nFileSize;
+ssize_t         iRes;
+
+
+    if (fstat(iFdMessageFile_l, &FileStat) != 0)
+    {
+        return (-1);
+    }
+
+    if (FileStat.st_size == 0)
+    {
+        memset(&MlfFileHeader, 0, sizeof(MlfFileHeader));
+        memcpy(MlfFileHeader.m_achMagic, MLF_FILE_MAGIC, sizeof(MlfFileHeader.m_achMagic));
+        MlfFileHeader.m_ui16FormatVersion = MLF_FORMAT_VERSION;
+        MlfFileHeader.m_ui16SchemaVersion = LORA_SCHEMA_VERSION;
+        MlfFileHeader.m_ui16HeaderSize    = MLF_HEADER_SIZE;
+        MlfFileHeader.m_ui16RecordSize    = MLF_RECORD_SIZE;
+        MlfFileHeader.m_i64CreateTime     = (int64_t)time(NULL);
+        MlfFileHeader.m_ui32CRC32         = MlfCrc32(&MlfFileHeader, offsetof(tMlfFileHeader, m_ui32CRC32));
+
+        iRes = write(iFdMessageFile_l, &MlfFileHeader, sizeof(MlfFileHeader));
+        if (iRes != (ssize_t)sizeof(MlfFileHeader))
+        {
+            return (-2);
+        }
+        return (0);
+    }
+
+    iRes = pread(iFdMessageFile_l, &MlfFileHeader, sizeof(MlfFileHeader), 0);
+    if ( (iRes != (ssize_t)sizeof(MlfFileHeader)) ||
+         (memcmp(MlfFileHeader.m_achMagic, MLF_FILE_MAGIC, sizeof(MlfFileHeader.m_achMagic)) != 0) ||
+         (MlfFileHeader.m_ui32CRC32 != MlfCrc32(&MlfFileHeader, offsetof(tMlfFileHeader, m_ui32CRC32))) )
+    {
+        TRACE0("\nOpen MsgFile: no binary MessageLog\n");
+        return (-3);
+    }
+    if ( (MlfFileHeader.m_ui16FormatVersion != MLF_FORMAT_VERSION)  ||
+         (MlfFileHeader.m_ui16SchemaVersion != LORA_SCHEMA_VERSION) ||
+         (MlfFileHeader.m_ui16HeaderSize    != MLF_HEADER_SIZE)     ||
+         (MlfFileHeader.m_ui16RecordSize    != MLF_RECORD_SIZE) )
+    {
+        TRACE2("\nOpen MsgFile: incompatible MessageLog (Format=%u, Schema=%u)\n", (uint)MlfFileHeader.m_ui16FormatVersion, (uint)MlfFileHeader.m_ui16SchemaVersion);
+        return (-4);
+    }
+
+    nFileSize = FileStat.st_size - ((FileStat.st_size - MLF_HEADER_SIZE) % MLF_RECORD_SIZE);
+    if (nFileSize != FileStat.st_size)
+    {
+        TRACE2("\nOpen MsgFile: cut off incomplete record (%ld -> %ld)\n", (long)FileStat.st_size, (long)nFileSize);
+        if (ftruncate(iFdMessageFile_l, nFileSize) != 0)
+        {
+            return (-5);
+        }
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Add written Record to Index
+//---------------------------------------------------------------------------
+
+static  void  MfwIndexRecord (
+    const tJsonMessage* pJsonMessage_p,                 // [IN] Ptr to Json Message
+    uint32_t ui32RecLen_p)                              // [IN] Size of written Record
+{
+
+    if ( fIndexActive_l )
+    {
+        MixAddRecord(ui64FileOffset_l, ui32RecLen_p,
+                     (int64_t)pJsonMessage_p->m_RecordFields.m_tmTimeStamp,
+                     pJsonMessage_p->m_RecordFields.m_ui8DevID);
+    }
+    ui64FileOffset_l += ui32RecLen_p;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Check if MessageFile has to be rotated before the next Record
+//---------------------------------------------------------------------------
+//  A file without records is never rotated, so each segment contains at
+//  least one record even if a single record exceeds the size limit.
+
+static  bool  MfwIsRotationDue (
+    uint uiRecLen_p)                                    // [IN] Size of next Record
+{
+
+    if (ui64FileOffset_l <= ((MsgFileFormat_l == kMfwFormatBinary) ? MLF_HEADER_SIZE : 0))
+    {
+        return (false);
+    }
+
+    if ( (RotationCfg_l.m_ui64MaxFileSize > 0) &&
+         ((ui64FileOffset_l + uiRecLen_p) > RotationCfg_l.m_ui64MaxFileSize) )
+    {
+        return (true);
+    }
+
+    if ( (RotationCfg_l.m_uiRotationPeriod > 0) &&
+         (MfwGetRotationSlot(time(NULL)) != i64RotationSlot_l) )
+    {
+        return (true);
+    }
+
+    return (false);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Rotate MessageFile
+//---------------------------------------------------------------------------
+//  The MessageFile is renamed to the segment name and reopened as a new file
+//  under its original name, so readers always find the current records at
+//  the same place. rename() is atomic: after a power failure either the old
+//  or the new name exists. If the rotation fails, writing continues in the
+//  current file (rename is undone if the new file can't be created).
+
+static  int  MfwRotate (void)
+{
+
+std::string  strSegment;
+std::string  strIndexFileName;
+uint64_t     ui64StartUs;
+uint32_t     ui32DurationUs;
+size_t       nPosName;
+time_t       tmNow;
+int          iFdDir;
+int          iRes;
+
+
+    ui64StartUs = MfwGetTimeUs();
+    tmNow = time(NULL);
+    strSegment = MfwBuildSegmentName(tmNow);
+    strIndexFileName = MixGetIndexFileName(strMsgFileName_l.c_str());
+
+    if ( fIndexActive_l )
+    {
+        MixClose();
+        fIndexActive_l = false;
+    }
+    close(iFdMessageFile_l);
+    iFdMessageFile_l = -1;
+
+    iRes = -1;
+    if ( !strSegment.empty() )
+    {
+        iRes = rename(strMsgFileName_l.c_str(), strSegment.c_str());
+    }
+    TRACE3("\nRotate MsgFile: '%s' -> '%s' (iRes=%d)\n", strMsgFileName_l.c_str(), strSegment.c_str(), iRes);
+    if (iRes == 0)
+    {
+        rename(strIndexFileName.c_str(), MixGetIndexFileName(strSegment.c_str()).c_str());
+        if ( fSyncWrite_l )
+        {
+            // make the new names persistent as the records themselves
+            nPosName = strSegment.rfind('/');
+            iFdDir = open(((nPosName == std::string::npos) ? std::string(".") : strSegment.substr(0, nPosName + 1)).c_str(), O_RDONLY | O_DIRECTORY);
+            if (iFdDir >= 0)
+            {
+                fsync(iFdDir);
+                close(iFdDir);
+            }
+        }
+
+        iRes = MfwOpenFile();
+        if (iRes < 0)
+        {
+            rename(strSegment.c_str(), strMsgFileName_l.c_str());
+            rename(MixGetIndexFileName(strSegment.c_str()).c_str(), strIndexFileName.c_str());
+            iRes = -1;
+        }
+    }
+
+    if (iRes < 0)
+    {
+        // continue in the current file
+        iRes = MfwOpenFile();
+        std::lock_guard<std::mutex> Lock(BackgroundMutex_l);
+        MfwStatistics_l.m_uiRotationErrors++;
+        return ((iRes < 0) ? -1 : 1);
+    }
+
+    i64RotationSlot_l = MfwGetRotationSlot(tmNow);
+    ui32DurationUs = (uint32_t)(MfwGetTimeUs() - ui64StartUs);
+
+    {
+        std::lock_guard<std::mutex> Lock(BackgroundMutex_l);
+        MfwStatistics_l.m_uiRotations++;
+        MfwStatistics_l.m_ui64RotationSumUs += ui32DurationUs;
+        if (ui32DurationUs > MfwStatistics_l.m_ui32RotationMaxUs)
+        {
+            MfwStatistics_l.m_ui32RotationMaxUs = ui32DurationUs;
+        }
+
+        if ( BackgroundThread_l.joinable() )
+        {
+            if ( RotationCfg_l.m_fCompress )
+            {
+                deqCompressJobs_l.push_back(strSegment);
+            }
+            fRetentionPending_l = true;
+        }
+    }
+    BackgroundCond_l.notify_all();
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Rotation Period of given Time
+//---------------------------------------------------------------------------
+//  Periods are counted in local time, so that e.g. a period of 24h rotates
+//  at midnight.
+
+static  int64_t  MfwGetRotationSlot (
+    time_t tmTime_p)                                    // [IN] Time to get Rotation Period for
+{
+
+struct tm  LocTime;
+
+
+    if (RotationCfg_l.m_uiRotationPeriod == 0)
+    {
+        return (0);
+    }
+
+    localtime_r(&tmTime_p, &LocTime);
+
+    return (((int64_t)tmTime_p + LocTime.tm_gmtoff) / RotationCfg_l.m_uiRotationPeriod);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Build Name of rotated Segment
+//---------------------------------------------------------------------------
+//  'dir/LoraPacketLog.json' -> 'dir/LoraPacketLog_20261018-211500.json',
+//  with several rotations within one second '..._20261018-211500_02.json'.
+//  Sorting the names sorts the segments by time.
+
+static  std::string  MfwBuildSegmentName (
+    time_t tmTime_p)                                    // [IN] Time of Rotation
+{
+
+std::string  strDir;
+std::string  strStem;
+std::string  strExt;
+std::string  strSegment;
+struct stat  FileStat;
+struct tm    LocTime;
+char         szTime[32];
+char         szSuffix[8];
+uint         uiSuffix;
+
+
+    MfwSplitFileName(&strDir, &strStem, &strExt);
+
+    localtime_r(&tmTime_p, &LocTime);
+    strftime(szTime, sizeof(szTime), "_%Y%m%d-%H%M%S", &LocTime);
+
+    for (uiSuffix=1; uiSuffix<=MFW_MAX_SEGMENT_SUFFIX; uiSuffix++)
+    {
+        strSegment = strDir + strStem + szTime;
+        if (uiSuffix > 1)
+        {
+            snprintf(szSuffix, sizeof(szSuffix), "_%02u", uiSuffix);
+            strSegment += szSuffix;
+        }
+        strSegment += strExt;
+
+        if ( (stat(strSegment.c_str(), &FileStat) != 0) &&
+             (stat((strSegment + COMPRESS_EXTENSION).c_str(), &FileStat) != 0) )
+        {
+            return (strSegment);
+        }
+    }
+
+    return (std::string());
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Split Name of MessageFile
+//---------------------------------------------------------------------------
+
+static  void  MfwSplitFileName (
+    std::string* pstrDir_p,                             // [OUT] Directory of MessageFile
+    std::string* pstrStem_p,                            // [OUT] File Name without Extension
+    std::string* pstrExt_p)                             // [OUT] Extension (incl. '.')
+{
+
+size_t  nPosName;
+size_t  nPosExt;
+
+
+    nPosName = strMsgFileName_l.rfind('/');
+    nPosName = (nPosName == std::string::npos) ? 0 : (nPosName + 1);
+    nPosExt  = strMsgFileName_l.rfind('.');
+    if ((nPosExt == std::string::npos) || (nPosExt <= nPosName))
+    {
+        nPosExt = strMsgFileName_l.length();
+    }
+
+    *pstrDir_p  = strMsgFileName_l.substr(0, nPosName);
+    *pstrStem_p = strMsgFileName_l.substr(nPosName, nPosExt - nPosName);
+    *pstrExt_p  = strMsgFileName_l.substr(nPosExt);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  List rotated Segments
+//---------------------------------------------------------------------------
+
+static  void  MfwListSegments (
+    std::vector<tMfwSegment>* pvecSegments_p)           // [OUT] Ptr to Vector with Segments (oldest first)
+{
+
+std::string     strDir;
+std::string     strStem;
+std::string     strExt;
+std::string     strName;
+std::string     strRest;
+tMfwSegment     Segment;
+struct stat     FileStat;
+struct dirent*  pDirEntry;
+DIR*            pDir;
+size_t          nPos;
+
+
+    pvecSegments_p->clear();
+    MfwSplitFileName(&strDir, &strStem, &strExt);
+
+    pDir = opendir(strDir.empty() ? "." : strDir.c_str());
+    if (pDir == NULL)
+    {
+        return;
+    }
+
+    while ((pDirEntry = readdir(pDir)) != NULL)
+    {
+        // '<stem>_YYYYMMDD-HHMMSS[_n]<ext>[.gz[.tmp]]'
+        strName = pDirEntry->d_name;
+        if ( (strName.length() < (strStem.length() + 1 + SEGMENT_TIME_LEN)) ||
+             (strName.compare(0, strStem.length() + 1, strStem + "_") != 0) )
+        {
+            continue;
+        }
+        nPos = strStem.length() + 1;
+        if ( (strName.find_first_not_of("0123456789", nPos) != (nPos + 8)) || (strName[nPos + 8] != '-') ||
+             (strName.find_first_not_of("0123456789", nPos + 9) != (nPos + SEGMENT_TIME_LEN)) )
+        {
+            continue;
+        }
+        nPos += SEGMENT_TIME_LEN;
+        if ((nPos < strName.length()) && (strName[nPos] == '_'))
+        {
+            nPos = strName.find_first_not_of("0123456789", nPos + 1);
+            if (nPos == std::string::npos)
+            {
+                nPos = strName.length();
+            }
+        }
+        strRest = strName.substr(nPos);
+
+        Segment.m_fCompressed = false;
+        Segment.m_fTemporary  = false;
+        if (strRest == strExt)
+        {
+        }
+        else if (strRest == (strExt + COMPRESS_EXTENSION))
+        {
+            Segment.m_fCompressed = true;
+        }
+        else if (strRest == (strExt + COMPRESS_EXTENSION + TEMP_EXTENSION))
+        {
+            Segment.m_fTemporary = true;
+        }
+        else
+        {
+            continue;                                   // e.g. IndexFile
+        }
+
+        Segment.m_strFileName = strDir + strName;
+        Segment.m_strIndexFileName = MixGetIndexFileName(strName.substr(0, nPos).append(strExt).insert(0, strDir).c_str());
+        if (stat(Segment.m_strFileName.c_str(), &FileStat) != 0)
+        {
+            continue;
+        }
+        Segment.m_ui64Size   = (uint64_t)FileStat.st_size;
+        Segment.m_tmModified = FileStat.st_mtime;
+        if ( !Segment.m_fTemporary && (stat(Segment.m_strIndexFileName.c_str(), &FileStat) == 0) )
+        {
+            Segment.m_ui64Size += (uint64_t)FileStat.st_size;
+        }
+
+        pvecSegments_p->push_back(Segment);
+    }
+    closedir(pDir);
+
+    std::sort(pvecSegments_p->begin(), pvecSegments_p->end(),
+              [](const tMfwSegment& SegA_p, const tMfwSegment& SegB_p) { return (SegA_p.m_strFileName < SegB_p.m_strFileName); });
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Background Thread: Compression and Retention
+//---------------------------------------------------------------------------
+//  Runs with the lowest CPU and I/O priority, so that neither the main loop
+//  nor the synchronous writes of MfwWriteMessage() are delayed by it. At
+//  start the output of an interrupted compression is removed and segments
+//  left uncompressed by a previous run are queued.
+
+static  void  MfwBackgroundThread (void)
+{
+
+std::vector<tMfwSegment>  vecSegments;
+struct sched_param        SchedParam;
+std::string               strFileName;
+size_t                    nIdx;
+
+
+    memset(&SchedParam, 0, sizeof(SchedParam));
+    if (pthread_setschedparam(pthread_self(), SCHED_IDLE, &SchedParam) != 0)
+    {
+        setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), 19);
+    }
+    syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, (IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT));
+
+    MfwListSegments(&vecSegments);
+
+    std::unique_lock<std::mutex> Lock(BackgroundMutex_l);
+
+    for (nIdx=0; nIdx<vecSegments.size(); nIdx++)
+    {
+        if ( vecSegments[nIdx].m_fTemporary )
+        {
+            unlink(vecSegments[nIdx].m_strFileName.c_str());
+        }
+        else if ( RotationCfg_l.m_fCompress && !vecSegments[nIdx].m_fCompressed )
+        {
+            deqCompressJobs_l.push_back(vecSegments[nIdx].m_strFileName);
+        }
+    }
+    fRetentionPending_l = true;
+    fBackgroundBusy_l   = false;
+
+    while (true)
+    {
+        BackgroundCond_l.wait(Lock, [] { return (fStopBackground_l || !deqCompressJobs_l.empty() || fRetentionPending_l); });
+        if ( fStopBackground_l )
+        {
+            break;
+        }
+
+        fBackgroundBusy_l = true;
+        if ( !deqCompressJobs_l.empty() )
+        {
+            strFileName = deqCompressJobs_l.front();
+            deqCompressJobs_l.pop_front();
+            Lock.unlock();
+            MfwCompressSegment(strFileName);
+            Lock.lock();
+            fRetentionPending_l = true;
+        }
+        else
+        {
+            // retention only after all compressions, so the sizes are final
+            fRetentionPending_l = false;
+            Lock.unlock();
+            MfwApplyRetention();
+            Lock.lock();
+        }
+        fBackgroundBusy_l = false;
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Compress Segment with gzip
+//---------------------------------------------------------------------------
+//  The compressed data is written to '<segment>.gz.tmp' and synced before it
+//  is renamed to '<segment>.gz' and the segment is deleted, so after a power
+//  failure at least one complete copy exists. The modification time of the
+//  segment (time of its last record) is kept for the retention by age. The
+//  IndexFile stays as it is and matches again after 'gunzip'.
+
+static  int  MfwCompressSegment (
+    const std::string& strFileName_p)                   // [IN] Path/Name of Segment
+{
+
+std::vector<uint8_t>  vecBuffer;
+std::string      strTempName;
+std::string      strGzName;
+struct stat      FileStat;
+struct timespec  aFileTimes[2];
+char             szMode[8];
+gzFile           GzFile;
+uint64_t         ui64SizeIn;
+ssize_t          iRead;
+int              iFdIn;
+int              iFdOut;
+int              iRes;
+
+
+    strGzName   = strFileName_p + COMPRESS_EXTENSION;
+    strTempName = strGzName + TEMP_EXTENSION;
+
+    iFdIn = open(strFileName_p.c_str(), O_RDONLY);
+    if (iFdIn < 0)
+    {
+        return (-1);
+    }
+    if (fstat(iFdIn, &FileStat) != 0)
+    {
+        close(iFdIn);
+        return (-1);
+    }
+
+    iFdOut = open(strTempName.c_str(), O_CREAT | O_WRONLY | O_TRUNC, FileStat.st_mode & 0777);
+    if (iFdOut < 0)
+    {
+        close(iFdIn);
+        std::lock_guard<std::mutex> Lock(BackgroundMutex_l);
+        MfwStatistics_l.m_uiCompressErrors++;
+        return (-2);
+    }
+
+    // gzclose() closes the descriptor passed to gzdopen(), <iFdOut> is kept for fsync()
+    snprintf(szMode, sizeof(szMode), "wb%d", MFW_COMPRESS_LEVEL);
+    GzFile = gzdopen(dup(iFdOut), szMode);
+    if (GzFile == NULL)
+    {
+        close(iFdIn);
+        close(iFdOut);
+        unlink(strTempName.c_str());
+        std::lock_guard<std::mutex> Lock(BackgroundMutex_l);
+        MfwStatistics_l.m_uiCompressErrors++;
+        return (-3);
+    }
+
+    vecBuffer.resize(MFW_COMPRESS_BUFFER_SIZE);
+    ui64SizeIn = 0;
+    iRes = 0;
+    while ((iRead = read(iFdIn, vecBuffer.data(), vecBuffer.size())) > 0)
+    {
+        if ( fStopBackground_l )
+        {
+            iRes = -4;
+            break;
+        }
+        if (gzwrite(GzFile, vecBuffer.data(), (unsigned)iRead) != (int)iRead)
+        {
+            iRes = -5;
+            break;
+        }
+        ui64SizeIn += (uint64_t)iRead;
+    }
+    if (iRead < 0)
+    {
+        iRes = -5;
+    }
+    close(iFdIn);
+
+    if ((gzclose(GzFile) != Z_OK) && (iRes == 0))
+    {
+        iRes = -5;
+    }
+    if ((iRes == 0) && (fsync(iFdOut) != 0))
+    {
+        iRes = -5;
+    }
+    if (iRes == 0)
+    {
+        aFileTimes[0] = FileStat.st_atim;
+        aFileTimes[1] = FileStat.st_mtim;
+        futimens(iFdOut, aFileTimes);
+        fstat(iFdOut, &FileStat);
+    }
+    close(iFdOut);
+
+    if ((iRes == 0) && (rename(strTempName.c_str(), strGzName.c_str()) != 0))
+    {
+        iRes = -6;
+    }
+    TRACE3("\nCompress MsgFile: '%s' (%llu bytes) -> iRes=%d\n", strFileName_p.c_str(), (unsigned long long)ui64SizeIn, iRes);
+    if (iRes < 0)
+    {
+        unlink(strTempName.c_str());
+        if (iRes != -4)
+        {
+            std::lock_guard<std::mutex> Lock(BackgroundMutex_l);
+            MfwStatistics_l.m_uiCompressErrors++;
+        }
+        return (iRes);
+    }
+
+    unlink(strFileName_p.c_str());
+
+    {
+        std::lock_guard<std::mutex> Lock(BackgroundMutex_l);
+        MfwStatistics_l.m_uiFilesCompressed++;
+        MfwStatistics_l.m_ui64BytesUncompressed += ui64SizeIn;
+        MfwStatistics_l.m_ui64BytesCompressed   += (uint64_t)FileStat.st_size;
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Delete Segments according to the Retention Rules
+//---------------------------------------------------------------------------
+//  Segments are deleted oldest first, together with their IndexFile. The
+//  size limit applies to all files including the current MessageFile, but
+//  the current MessageFile itself is never deleted.
+
+static  void  MfwApplyRetention (void)
+{
+
+std::vector<tMfwSegment>  vecSegments;
+struct stat  FileStat;
+uint64_t     ui64TotalSize;
+time_t       tmNow;
+size_t       nIdx;
+bool         fDelete;
+
+
+    MfwListSegments(&vecSegments);
+
+    ui64TotalSize = 0;
+    for (nIdx=0; nIdx<vecSegments.size(); nIdx++)
+    {
+        ui64TotalSize += vecSegments[nIdx].m_ui64Size;
+    }
+    if (stat(strMsgFileName_l.c_str(), &FileStat) == 0)
+    {
+        ui64TotalSize += (uint64_t)FileStat.st_size;
+    }
+    if (stat(MixGetIndexFileName(strMsgFileName_l.c_str()).c_str(), &FileStat) == 0)
+    {
+        ui64TotalSize += (uint64_t)FileStat.st_size;
+    }
+
+    tmNow = time(NULL);
+    for (nIdx=0; nIdx<vecSegments.size(); nIdx++)
+    {
+        if ( fStopBackground_l )
+        {
+            break;
+        }
+        if ( vecSegments[nIdx].m_fTemporary )
+        {
+            continue;                                   // compression in progress
+        }
+
+        fDelete = false;
+        if ( (RotationCfg_l.m_uiRetainAge > 0) &&
+             ((tmNow - vecSegments[nIdx].m_tmModified) > (time_t)RotationCfg_l.m_uiRetainAge) )
+        {
+            fDelete = true;
+        }
+        if ( (RotationCfg_l.m_ui64RetainBytes > 0) &&
+             (ui64TotalSize > RotationCfg_l.m_ui64RetainBytes) )
+        {
+            fDelete = true;
+        }
+        if ( !fDelete )
+        {
+            continue;
+        }
+
+        TRACE1("\nRetention: delete '%s'\n", vecSegments[nIdx].m_strFileName.c_str());
+        if (unlink(vecSegments[nIdx].m_strFileName.c_str()) != 0)
+        {
+            continue;
+        }
+        unlink(vecSegments[nIdx].m_strIndexFileName.c_str());
+        ui64TotalSize -= vecSegments[nIdx].m_ui64Size;
+
+        std::lock_guard<std::mutex> Lock(BackgroundMutex_l);
+        MfwStatistics_l.m_uiFilesDeleted++;
+        MfwStatistics_l.m_ui64BytesDeleted += vecSegments[nIdx].m_ui64Size;
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get monotonic Time in [us]
+//---------------------------------------------------------------------------
+
+static  uint64_t  MfwGetTimeUs (void)
+{
+
+struct timespec  TimeSpec;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &TimeSpec);
+
+    return (((uint64_t)TimeSpec.tv_sec * 1000000) + ((uint64_t)TimeSpec.tv_nsec / 1000));
+
+}
+
+
+
 //---------------------------------------------------------------------------
 //  String Trim
 //---------------------------------------------------------------------------
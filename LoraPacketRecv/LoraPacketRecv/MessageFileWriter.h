@@ -10,24 +10,71 @@
   Revision History:
 
   2023/03/25 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Optional binary MessageLog
+  2026/10/18 -rs:   V1.02 Sparse Time/DevID Index
+  2026/10/18 -rs:   V1.03 Rotation, Compression and Retention of MessageFiles
+  2026/10/18 -rs:   V1.04 Build of binary Record is public (Shared Memory Ring)
+  2026/10/18 -rs:   V1.05 MfwWriteMessage() takes const Json Message (Message Sinks)
 
 ****************************************************************************/
 
 #ifndef _MESSAGEFILEWRITER_H_
 #define _MESSAGEFILEWRITER_H_
 
+#include "MessageLogFormat.h"
+
 
 
 //---------------------------------------------------------------------------
 //  Constant definitions
 //---------------------------------------------------------------------------
 
+const  uint  MFW_MAX_SEGMENT_SUFFIX     = 99;           // rotated files with the same time stamp
+const  uint  MFW_COMPRESS_BUFFER_SIZE   = 64 * 1024;    // read buffer of background compression [bytes]
+const  int   MFW_COMPRESS_LEVEL         = 6;            // gzip compression level (1..9)
+
 
 
 //---------------------------------------------------------------------------
 //  Type definitions
 //---------------------------------------------------------------------------
 
+typedef enum
+{
+    kMfwFormatJson      = 0,                            // Json Records separated by an empty line
+    kMfwFormatBinary    = 1                             // fixed-size binary Records (see MessageLogFormat.h)
+
+} tMfwFormat;
+
+
+//  Rotation of the MessageFile: the current file is renamed to a segment
+//  '<name>_YYYYMMDD-HHMMSS<ext>' and a new file is opened under the same name
+typedef struct
+{
+    uint64_t            m_ui64MaxFileSize;          // rotate before the file exceeds this size [bytes] (0 = no limit)
+    uint                m_uiRotationPeriod;         // rotate at each multiple of this period in local time [sec] (0 = never)
+    bool                m_fCompress;                // gzip closed segments in the background
+    uint                m_uiRetainAge;              // delete segments whose last record is older [sec] (0 = keep)
+    uint64_t            m_ui64RetainBytes;          // delete oldest segments while all files need more [bytes] (0 = no limit)
+
+} tMfwRotationCfg;
+
+
+typedef struct
+{
+    uint                m_uiRotations;
+    uint                m_uiRotationErrors;         // rotation failed, writing continued in the current file
+    uint32_t            m_ui32RotationMaxUs;        // duration of rotation incl. reopening [us]
+    uint64_t            m_ui64RotationSumUs;
+    uint                m_uiFilesCompressed;
+    uint                m_uiCompressErrors;
+    uint64_t            m_ui64BytesUncompressed;    // sum of all compressed segments before/after compression
+    uint64_t            m_ui64BytesCompressed;
+    uint                m_uiFilesDeleted;           // by retention
+    uint64_t            m_ui64BytesDeleted;
+
+} tMfwStatistics;
+
 
 
 //---------------------------------------------------------------------------
@@ -35,12 +82,27 @@
 //---------------------------------------------------------------------------
 
 int  MfwOpen (
-    const char* pszMsgFileName_p);                      // [IN] Path/Name of MessageFile
+    const char* pszMsgFileName_p,                       // [IN] Path/Name of MessageFile
+    tMfwFormat MsgFileFormat_p,                         // [IN] Format of MessageFile
+    uint uiIndexBlockRecords_p,                         // [IN] Records per Index Entry (0 = no Index)
+    bool fSyncWrite_p,                                  // [IN] Write each Message synchronously (O_SYNC)
+    const tMfwRotationCfg* pRotationCfg_p);             // [IN] Ptr to Rotation Configuration (NULL = no rotation)
 
 int  MfwClose ();
 
 int  MfwWriteMessage (
-    tJsonMessage* pJsonMessage_p);                      // [IN] Ptr to Json Message
+    const tJsonMessage* pJsonMessage_p);                      // [IN] Ptr to Json Message
+
+void  MfwBuildBinaryRecord (
+    const tJsonMessage* pJsonMessage_p,                 // [IN] Ptr to Json Message
+    tMlfRecord* pMlfRecord_p);                          // [OUT] Ptr to binary Record
+
+bool  MfwIsBackgroundIdle (void);
+
+void  MfwGetStatistics (
+    tMfwStatistics* pStatistics_p);                     // [OUT] Ptr to Statistics
+
+void  MfwPrintStatistics (void);
 
 
 
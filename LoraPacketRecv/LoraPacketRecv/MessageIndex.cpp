@@ -0,0 +1,443 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Implementation of sparse Time/DevID Index of MessageFile
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "MessageLogFormat.h"
+#include "MessageIndex.h"
+#include "Trace.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+//  Only used by the thread writing the MessageFile, so no locking is necessary.
+static  int             iFdIndexFile_l      = -1;
+static  uint            uiBlockRecords_l    = MIX_DEF_BLOCK_RECORDS;
+static  tMixEntry       CurrEntry_l;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  int  MixWriteEntry (void);
+
+static  inline  uint32_t  MixHeaderCrc (
+    const tMixFileHeader* pFileHeader_p);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Open IndexFile
+//---------------------------------------------------------------------------
+//  An existing index is continued, the first block starts with the next
+//  record added. A file that is no index is never overwritten.
+
+int  MixOpen (
+    const char* pszIndexFileName_p,                     // [IN]     Path/Name of IndexFile
+    uint uiBlockRecords_p,                              // [IN]     Records per Index Entry
+    bool fRecreate_p)                                   // [IN]     Discard existing entries (new MessageFile)
+{
+
+tMixFileHeader  MixFileHeader;
+struct stat     FileStat;
+mode_t          OpenMode;
+off_t           nFileSize;
+ssize_t         iRes;
+
+
+    if ((pszIndexFileName_p == NULL) || (uiBlockRecords_p == 0) || (uiBlockRecords_p > MIX_MAX_BLOCK_RECORDS))
+    {
+        return (-1);
+    }
+
+    OpenMode = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
+    iFdIndexFile_l = open(pszIndexFileName_p, (O_CREAT | O_RDWR | O_APPEND), OpenMode);
+    TRACE2("\nOpen IndexFile: pszIndexFileName_p='%s' -> iFdIndexFile_l=%d\n", pszIndexFileName_p, iFdIndexFile_l);
+    if (iFdIndexFile_l < 0)
+    {
+        return (-2);
+    }
+
+    uiBlockRecords_l = uiBlockRecords_p;
+    memset(&CurrEntry_l, 0, sizeof(CurrEntry_l));
+
+    if (fstat(iFdIndexFile_l, &FileStat) != 0)
+    {
+        MixClose();
+        return (-3);
+    }
+
+    if (FileStat.st_size > 0)
+    {
+        iRes = pread(iFdIndexFile_l, &MixFileHeader, sizeof(MixFileHeader), 0);
+        if ( (iRes != (ssize_t)sizeof(MixFileHeader)) ||
+             (memcmp(MixFileHeader.m_achMagic, MIX_FILE_MAGIC, sizeof(MixFileHeader.m_achMagic)) != 0) ||
+             (MixFileHeader.m_ui32CRC32 != MixHeaderCrc(&MixFileHeader)) ||
+             (MixFileHeader.m_ui16FormatVersion != MIX_FORMAT_VERSION) ||
+             (MixFileHeader.m_ui16EntrySize != MIX_ENTRY_SIZE) )
+        {
+            TRACE0("\nOpen IndexFile: no compatible IndexFile\n");
+            close(iFdIndexFile_l);
+            iFdIndexFile_l = -1;
+            return (-4);
+        }
+
+        if ( fRecreate_p )
+        {
+            nFileSize = 0;
+        }
+        else
+        {
+            // cut off an incomplete last entry
+            nFileSize = FileStat.st_size - ((FileStat.st_size - MIX_HEADER_SIZE) % MIX_ENTRY_SIZE);
+        }
+        if (nFileSize != FileStat.st_size)
+        {
+            if (ftruncate(iFdIndexFile_l, nFileSize) != 0)
+            {
+                MixClose();
+                return (-5);
+            }
+        }
+        if (nFileSize > 0)
+        {
+            return (0);
+        }
+    }
+
+    memset(&MixFileHeader, 0, sizeof(MixFileHeader));
+    memcpy(MixFileHeader.m_achMagic, MIX_FILE_MAGIC, sizeof(MixFileHeader.m_achMagic));
+    MixFileHeader.m_ui16FormatVersion = MIX_FORMAT_VERSION;
+    MixFileHeader.m_ui16EntrySize     = MIX_ENTRY_SIZE;
+    MixFileHeader.m_ui16BlockRecords  = (uint16_t)uiBlockRecords_p;
+    MixFileHeader.m_i64CreateTime     = (int64_t)time(NULL);
+    MixFileHeader.m_ui32CRC32         = MixHeaderCrc(&MixFileHeader);
+
+    iRes = write(iFdIndexFile_l, &MixFileHeader, sizeof(MixFileHeader));
+    if (iRes != (ssize_t)sizeof(MixFileHeader))
+    {
+        MixClose();
+        return (-6);
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Close IndexFile
+//---------------------------------------------------------------------------
+//  A partly filled block gets its entry now, so that a later run continues
+//  with a new block directly behind it.
+
+int  MixClose (void)
+{
+
+    if (iFdIndexFile_l < 0)
+    {
+        return (-1);
+    }
+
+    if (CurrEntry_l.m_ui16NumRecords > 0)
+    {
+        MixWriteEntry();
+    }
+
+    close(iFdIndexFile_l);
+    iFdIndexFile_l = -1;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Add Record to Index
+//---------------------------------------------------------------------------
+//  Records must be added in the order they are appended to the MessageFile,
+//  only every <uiBlockRecords_l> records one entry is written.
+
+int  MixAddRecord (
+    uint64_t ui64Offset_p,                              // [IN]     Offset of Record in MessageFile
+    uint32_t ui32Length_p,                              // [IN]     Size of Record in MessageFile
+    int64_t i64TimeStamp_p,                             // [IN]     TimeStamp of Record
+    uint8_t ui8DevID_p)                                 // [IN]     DevID of Record
+{
+
+int  iRes;
+
+
+    if (iFdIndexFile_l < 0)
+    {
+        return (-1);
+    }
+
+    if (CurrEntry_l.m_ui16NumRecords == 0)
+    {
+        CurrEntry_l.m_ui64Offset = ui64Offset_p;
+        CurrEntry_l.m_i64MinTime = i64TimeStamp_p;
+        CurrEntry_l.m_i64MaxTime = i64TimeStamp_p;
+    }
+    else if ((CurrEntry_l.m_ui64Offset + CurrEntry_l.m_ui32Length) != ui64Offset_p)
+    {
+        // record is not contiguous to the block (e.g. failed write before),
+        // close the block so that each entry covers a gapless file range
+        iRes = MixWriteEntry();
+        if (iRes < 0)
+        {
+            return (iRes);
+        }
+        return (MixAddRecord(ui64Offset_p, ui32Length_p, i64TimeStamp_p, ui8DevID_p));
+    }
+
+    CurrEntry_l.m_ui32Length += ui32Length_p;
+    CurrEntry_l.m_ui16NumRecords++;
+    if (i64TimeStamp_p < CurrEntry_l.m_i64MinTime)
+    {
+        CurrEntry_l.m_i64MinTime = i64TimeStamp_p;
+    }
+    if (i64TimeStamp_p > CurrEntry_l.m_i64MaxTime)
+    {
+        CurrEntry_l.m_i64MaxTime = i64TimeStamp_p;
+    }
+    CurrEntry_l.m_abDevIdMask[ui8DevID_p >> 3] |= (uint8_t)(1 << (ui8DevID_p & 0x07));
+
+    if (CurrEntry_l.m_ui16NumRecords >= uiBlockRecords_l)
+    {
+        iRes = MixWriteEntry();
+        if (iRes < 0)
+        {
+            return (iRes);
+        }
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Load Index
+//---------------------------------------------------------------------------
+//  Only entries lying completely inside the MessageFile are returned, so
+//  a stale index (e.g. of a replaced MessageFile) can't refer to wrong data.
+//  The entries are sorted by offset without overlaps, uncovered ranges have
+//  to be scanned by the caller.
+
+int  MixLoad (
+    const char* pszIndexFileName_p,                     // [IN]     Path/Name of IndexFile
+    uint64_t ui64MsgFileSize_p,                         // [IN]     Size of indexed MessageFile
+    std::vector<tMixEntry>* pvecEntries_p)              // [OUT]    Ptr to Vector with valid Index Entries
+{
+
+tMixFileHeader  MixFileHeader;
+tMixEntry       aMixEntry[256];
+uint64_t        ui64PrevEnd;
+ssize_t         iRes;
+size_t          nIdx;
+int             iFd;
+
+
+    if ((pszIndexFileName_p == NULL) || (pvecEntries_p == NULL))
+    {
+        return (-1);
+    }
+
+    pvecEntries_p->clear();
+
+    iFd = open(pszIndexFileName_p, O_RDONLY);
+    if (iFd < 0)
+    {
+        return (-2);
+    }
+
+    iRes = read(iFd, &MixFileHeader, sizeof(MixFileHeader));
+    if ( (iRes != (ssize_t)sizeof(MixFileHeader)) ||
+         (memcmp(MixFileHeader.m_achMagic, MIX_FILE_MAGIC, sizeof(MixFileHeader.m_achMagic)) != 0) ||
+         (MixFileHeader.m_ui32CRC32 != MixHeaderCrc(&MixFileHeader)) ||
+         (MixFileHeader.m_ui16FormatVersion != MIX_FORMAT_VERSION) ||
+         (MixFileHeader.m_ui16EntrySize != MIX_ENTRY_SIZE) )
+    {
+        close(iFd);
+        return (-3);
+    }
+
+    ui64PrevEnd = 0;
+    while ((iRes = read(iFd, aMixEntry, sizeof(aMixEntry))) >= (ssize_t)sizeof(tMixEntry))
+    {
+        for (nIdx=0; nIdx<((size_t)iRes / sizeof(tMixEntry)); nIdx++)
+        {
+            if ( (aMixEntry[nIdx].m_ui16NumRecords == 0) ||
+                 (aMixEntry[nIdx].m_ui64Offset < ui64PrevEnd) ||
+                 ((aMixEntry[nIdx].m_ui64Offset + aMixEntry[nIdx].m_ui32Length) > ui64MsgFileSize_p) )
+            {
+                continue;
+            }
+            pvecEntries_p->push_back(aMixEntry[nIdx]);
+            ui64PrevEnd = aMixEntry[nIdx].m_ui64Offset + aMixEntry[nIdx].m_ui32Length;
+        }
+    }
+
+    close(iFd);
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Check if Index Entry matches the Query
+//---------------------------------------------------------------------------
+
+bool  MixEntryMatches (
+    const tMixEntry* pEntry_p,                          // [IN]     Ptr to Index Entry
+    int iDevID_p,                                       // [IN]     DevID to look for (-1 = any)
+    int64_t i64FromTime_p,                              // [IN]     Time Range to look for
+    int64_t i64ToTime_p)
+{
+
+    if ((pEntry_p->m_i64MaxTime < i64FromTime_p) || (pEntry_p->m_i64MinTime > i64ToTime_p))
+    {
+        return (false);
+    }
+    if ((iDevID_p >= 0) && (iDevID_p <= 255))
+    {
+        if ((pEntry_p->m_abDevIdMask[iDevID_p >> 3] & (1 << (iDevID_p & 0x07))) == 0)
+        {
+            return (false);
+        }
+    }
+
+    return (true);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Name of IndexFile belonging to a MessageFile
+//---------------------------------------------------------------------------
+
+std::string  MixGetIndexFileName (
+    const char* pszMsgFileName_p)                       // [IN]     Path/Name of MessageFile
+{
+
+    return (std::string(pszMsgFileName_p) + MIX_FILE_EXTENSION);
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Write current Entry
+//---------------------------------------------------------------------------
+
+static  int  MixWriteEntry (void)
+{
+
+ssize_t  iRes;
+
+
+    iRes = write(iFdIndexFile_l, &CurrEntry_l, sizeof(CurrEntry_l));
+    TRACE3("\nWrite IndexEntry: Offset=%llu, NumRecords=%u -> iRes=%d\n", (unsigned long long)CurrEntry_l.m_ui64Offset, (uint)CurrEntry_l.m_ui16NumRecords, (int)iRes);
+    memset(&CurrEntry_l, 0, sizeof(CurrEntry_l));
+    if (iRes != (ssize_t)sizeof(CurrEntry_l))
+    {
+        return (-2);
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  CRC32 of IndexFile Header
+//---------------------------------------------------------------------------
+
+static  inline  uint32_t  MixHeaderCrc (
+    const tMixFileHeader* pFileHeader_p)
+{
+
+    return (MlfCrc32(pFileHeader_p, offsetof(tMixFileHeader, m_ui32CRC32)));
+
+}
+
+
+
+// EOF
+
@@ -0,0 +1,124 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Declarations for sparse Time/DevID Index of MessageFile
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _MESSAGEINDEX_H_
+#define _MESSAGEINDEX_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+// Notice:  The index is a side file '<msg_file>.idx' next to the MessageFile
+//          (Json or binary). For every block of MIX_DEF_BLOCK_RECORDS records
+//          appended to the MessageFile one <tMixEntry> is appended to the
+//          index, carrying the file range of the block, the time range of its
+//          records and a bitmap of the DevIDs contained. A query only has to
+//          read the blocks whose entry matches, all other blocks are skipped.
+//
+//          The index can always be derived from the MessageFile, so it is
+//          written without O_SYNC. Records not covered by an entry (e.g. after
+//          a power failure) are scanned completely by the reader.
+//---------------------------------------------------------------------------
+
+const  char      MIX_FILE_MAGIC[8]      = { 'L','o','r','a','M','I','d','x' };
+const  uint16_t  MIX_FORMAT_VERSION     = 1;
+const  size_t    MIX_HEADER_SIZE        = 64;
+const  size_t    MIX_ENTRY_SIZE         = 64;
+const  uint      MIX_DEF_BLOCK_RECORDS  = 256;          // records per index entry
+const  uint      MIX_MAX_BLOCK_RECORDS  = 65535;
+const  char      MIX_FILE_EXTENSION[]   = ".idx";
+
+
+
+//---------------------------------------------------------------------------
+//  Type definitions
+//---------------------------------------------------------------------------
+
+typedef struct
+{
+    char                m_achMagic[8];              // MIX_FILE_MAGIC
+    uint16_t            m_ui16FormatVersion;        // MIX_FORMAT_VERSION
+    uint16_t            m_ui16EntrySize;            // MIX_ENTRY_SIZE
+    uint16_t            m_ui16BlockRecords;         // records per entry used by the writer (informative)
+    uint16_t            m_ui16Reserved;
+    int64_t             m_i64CreateTime;            // Linux Standard Time of file creation
+    uint8_t             m_abReserved[36];
+    uint32_t            m_ui32CRC32;                // CRC32 over all preceding bytes
+
+} tMixFileHeader;
+
+
+typedef struct
+{
+    uint64_t            m_ui64Offset;               // start of block in MessageFile
+    uint32_t            m_ui32Length;               // size of block in MessageFile [bytes]
+    uint16_t            m_ui16NumRecords;
+    uint16_t            m_ui16Reserved;
+    int64_t             m_i64MinTime;               // TimeStamp range of records in block
+    int64_t             m_i64MaxTime;
+    uint8_t             m_abDevIdMask[32];          // Bit <n> set -> block contains records of DevID <n>
+
+} tMixEntry;
+
+
+static_assert(sizeof(tMixFileHeader) == MIX_HEADER_SIZE, "unexpected size of <tMixFileHeader>");
+static_assert(sizeof(tMixEntry)      == MIX_ENTRY_SIZE,  "unexpected size of <tMixEntry>");
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of public functions
+//---------------------------------------------------------------------------
+
+//  Writer (used by MessageFileWriter, one index at a time)
+int  MixOpen (
+    const char* pszIndexFileName_p,                     // [IN]     Path/Name of IndexFile
+    uint uiBlockRecords_p,                              // [IN]     Records per Index Entry
+    bool fRecreate_p);                                  // [IN]     Discard existing entries (new MessageFile)
+
+int  MixClose (void);
+
+int  MixAddRecord (
+    uint64_t ui64Offset_p,                              // [IN]     Offset of Record in MessageFile
+    uint32_t ui32Length_p,                              // [IN]     Size of Record in MessageFile
+    int64_t i64TimeStamp_p,                             // [IN]     TimeStamp of Record
+    uint8_t ui8DevID_p);                                // [IN]     DevID of Record
+
+//  Reader
+int  MixLoad (
+    const char* pszIndexFileName_p,                     // [IN]     Path/Name of IndexFile
+    uint64_t ui64MsgFileSize_p,                         // [IN]     Size of indexed MessageFile
+    std::vector<tMixEntry>* pvecEntries_p);             // [OUT]    Ptr to Vector with valid Index Entries
+
+bool  MixEntryMatches (
+    const tMixEntry* pEntry_p,                          // [IN]     Ptr to Index Entry
+    int iDevID_p,                                       // [IN]     DevID to look for (-1 = any)
+    int64_t i64FromTime_p,                              // [IN]     Time Range to look for
+    int64_t i64ToTime_p);
+
+std::string  MixGetIndexFileName (
+    const char* pszMsgFileName_p);                      // [IN]     Path/Name of MessageFile
+
+
+
+#endif  // #ifndef _MESSAGEINDEX_H_
+
+
+// EOF
+
@@ -0,0 +1,141 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  File Format of binary MessageLog
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _MESSAGELOGFORMAT_H_
+#define _MESSAGELOGFORMAT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+
+//---------------------------------------------------------------------------
+//  File Layout
+//---------------------------------------------------------------------------
+// Notice:  A binary MessageLog consists of one <tMlfFileHeader> followed by
+//          any number of <tMlfRecord>, one per Json Message. Both have a fixed
+//          size of 64 Bytes, so the record <n> is found at offset 64 + n*64 and
+//          every record is naturally aligned in a memory mapped file. All values
+//          are stored little-endian (byte order of RaspberryPi and x86/x64),
+//          the layout is fixed by the static_asserts below.
+//
+//          Each record starts with its length and ends with a CRC32 over all
+//          preceding bytes of the record. A record torn by a power failure is
+//          detected by the CRC (or by an incomplete last record) and is skipped
+//          by the reader.
+//
+//          The fields of the LoRa record itself are kept as raw record (see
+//          LoraPacketSchema.h), the header carries LORA_SCHEMA_VERSION so that
+//          a reader only decodes them with a matching schema.
+//---------------------------------------------------------------------------
+
+const  char      MLF_FILE_MAGIC[8]      = { 'L','o','r','a','M','L','o','g' };
+const  uint16_t  MLF_FORMAT_VERSION     = 1;
+const  size_t    MLF_HEADER_SIZE        = 64;
+const  size_t    MLF_RECORD_SIZE        = 64;
+const  size_t    MLF_SCHEMA_REC_SIZE    = 20;           // space for raw record of <LoraPacketSchema.h>
+
+
+typedef struct
+{
+    char                m_achMagic[8];              // MLF_FILE_MAGIC
+    uint16_t            m_ui16FormatVersion;        // MLF_FORMAT_VERSION
+    uint16_t            m_ui16SchemaVersion;        // LORA_SCHEMA_VERSION of writer
+    uint16_t            m_ui16HeaderSize;           // MLF_HEADER_SIZE
+    uint16_t            m_ui16RecordSize;           // MLF_RECORD_SIZE
+    int64_t             m_i64CreateTime;            // Linux Standard Time of file creation
+    uint8_t             m_abReserved[36];
+    uint32_t            m_ui32CRC32;                // CRC32 over all preceding bytes
+
+} tMlfFileHeader;
+
+
+typedef struct
+{
+    uint16_t            m_ui16RecLen;               // MLF_RECORD_SIZE
+    uint8_t             m_ui8PacketType;            // tLoraPacketType
+    uint8_t             m_ui8DevID;
+    uint32_t            m_ui32MsgID;
+    int64_t             m_i64TimeStamp;             // Bootup: Receive Time, Data Record: reconstructed Time of Record
+    int64_t             m_i64RxTimeStamp;           // Receive Time of LoRa Packet
+    uint32_t            m_ui32SequNum;
+    uint32_t            m_ui32Uptime;
+    int8_t              m_i8Rssi;
+    uint8_t             m_ui8DataGen;
+    uint8_t             m_ui8FirmwareVersion;
+    uint8_t             m_ui8FirmwareRevision;
+    uint8_t             m_ui8SchemaRecLen;          // used bytes of <m_abSchemaRec>
+    uint8_t             m_abReserved[3];
+    uint8_t             m_abSchemaRec[MLF_SCHEMA_REC_SIZE];
+    uint32_t            m_ui32CRC32;                // CRC32 over all preceding bytes
+
+} tMlfRecord;
+
+
+static_assert(sizeof(tMlfFileHeader) == MLF_HEADER_SIZE, "unexpected size of <tMlfFileHeader>");
+static_assert(sizeof(tMlfRecord)     == MLF_RECORD_SIZE, "unexpected size of <tMlfRecord>");
+static_assert(offsetof(tMlfRecord, m_i64TimeStamp)  ==  8, "unexpected layout of <tMlfRecord>");
+static_assert(offsetof(tMlfRecord, m_i8Rssi)        == 32, "unexpected layout of <tMlfRecord>");
+static_assert(offsetof(tMlfRecord, m_abSchemaRec)   == 40, "unexpected layout of <tMlfRecord>");
+static_assert(offsetof(tMlfRecord, m_ui32CRC32)     == 60, "unexpected layout of <tMlfRecord>");
+
+
+
+//---------------------------------------------------------------------------
+//  CRC32 (IEEE 802.3, as used by zlib)
+//---------------------------------------------------------------------------
+//  The table is built on first use (thread-safe initialization of a static
+//  local object, so the function can be used by several reader threads).
+
+struct tMlfCrc32Tab
+{
+    uint32_t  m_aui32Crc[256];
+
+    tMlfCrc32Tab()
+    {
+        for (uint32_t ui32Idx=0; ui32Idx<256; ui32Idx++)
+        {
+            uint32_t  ui32Crc = ui32Idx;
+            for (int iBit=0; iBit<8; iBit++)
+            {
+                ui32Crc = (ui32Crc & 1) ? ((ui32Crc >> 1) ^ 0xEDB88320) : (ui32Crc >> 1);
+            }
+            m_aui32Crc[ui32Idx] = ui32Crc;
+        }
+    }
+};
+
+inline uint32_t  MlfCrc32 (const void* pData_p, size_t nDataLen_p)
+{
+    static const tMlfCrc32Tab  CrcTab;
+    const uint8_t*  pabData = (const uint8_t*)pData_p;
+    uint32_t        ui32Crc = 0xFFFFFFFF;
+
+    while (nDataLen_p-- > 0)
+    {
+        ui32Crc = CrcTab.m_aui32Crc[(ui32Crc ^ *pabData++) & 0xFF] ^ (ui32Crc >> 8);
+    }
+
+    return (ui32Crc ^ 0xFFFFFFFF);
+}
+
+
+
+#endif  // _MESSAGELOGFORMAT_H_
+
+
+
+// EOF
+
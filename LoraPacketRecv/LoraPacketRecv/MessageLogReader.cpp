@@ -0,0 +1,299 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Implementation of Reader of binary MessageLog
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#include <RH_RF95.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <iostream>
+#include <vector>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "LoraPacket.h"
+#include "LoraPacketSchema.h"
+#include "LoraPayloadDecoder.h"
+#include "PacketProcessing.h"
+#include "MessageLogReader.h"
+#include "Trace.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Open MessageLog
+//---------------------------------------------------------------------------
+//  The whole file is mapped read-only, records are then accessed in place
+//  without any copy. Only a header of the same format and schema version is
+//  accepted, because the raw LoRa records can only be decoded with the
+//  schema they were written with.
+
+int  MlrOpen (
+    const char* pszMsgFileName_p,                       // [IN]     Path/Name of MessageLog
+    tMlrLog* pMlrLog_p)                                 // [OUT]    Ptr to MessageLog
+{
+
+struct stat  FileStat;
+void*        pMapAddr;
+
+
+    if ((pszMsgFileName_p == NULL) || (pMlrLog_p == NULL))
+    {
+        return (-1);
+    }
+
+    memset(pMlrLog_p, 0, sizeof(tMlrLog));
+    pMlrLog_p->m_iFd = -1;
+
+    pMlrLog_p->m_iFd = open(pszMsgFileName_p, O_RDONLY);
+    TRACE2("\nOpen MessageLog: pszMsgFileName_p='%s' -> iFd=%d\n", pszMsgFileName_p, pMlrLog_p->m_iFd);
+    if (pMlrLog_p->m_iFd < 0)
+    {
+        return (-2);
+    }
+
+    if ( (fstat(pMlrLog_p->m_iFd, &FileStat) != 0) || (FileStat.st_size < (off_t)MLF_HEADER_SIZE) )
+    {
+        MlrClose(pMlrLog_p);
+        return (-3);
+    }
+
+    pMapAddr = mmap(NULL, (size_t)FileStat.st_size, PROT_READ, MAP_SHARED, pMlrLog_p->m_iFd, 0);
+    if (pMapAddr == MAP_FAILED)
+    {
+        MlrClose(pMlrLog_p);
+        return (-4);
+    }
+    madvise(pMapAddr, (size_t)FileStat.st_size, MADV_SEQUENTIAL);
+
+    pMlrLog_p->m_pabMapAddr = (const uint8_t*)pMapAddr;
+    pMlrLog_p->m_nMapSize   = (size_t)FileStat.st_size;
+    memcpy(&pMlrLog_p->m_FileHeader, pMlrLog_p->m_pabMapAddr, sizeof(tMlfFileHeader));
+
+    if ( (memcmp(pMlrLog_p->m_FileHeader.m_achMagic, MLF_FILE_MAGIC, sizeof(pMlrLog_p->m_FileHeader.m_achMagic)) != 0) ||
+         (pMlrLog_p->m_FileHeader.m_ui32CRC32 != MlfCrc32(&pMlrLog_p->m_FileHeader, offsetof(tMlfFileHeader, m_ui32CRC32))) )
+    {
+        TRACE0("\nOpen MessageLog: no binary MessageLog\n");
+        MlrClose(pMlrLog_p);
+        return (-5);
+    }
+    if ( (pMlrLog_p->m_FileHeader.m_ui16FormatVersion != MLF_FORMAT_VERSION)  ||
+         (pMlrLog_p->m_FileHeader.m_ui16SchemaVersion != LORA_SCHEMA_VERSION) ||
+         (pMlrLog_p->m_FileHeader.m_ui16HeaderSize    != MLF_HEADER_SIZE)     ||
+         (pMlrLog_p->m_FileHeader.m_ui16RecordSize    != MLF_RECORD_SIZE) )
+    {
+        TRACE2("\nOpen MessageLog: incompatible MessageLog (Format=%u, Schema=%u)\n", (uint)pMlrLog_p->m_FileHeader.m_ui16FormatVersion, (uint)pMlrLog_p->m_FileHeader.m_ui16SchemaVersion);
+        MlrClose(pMlrLog_p);
+        return (-6);
+    }
+
+    pMlrLog_p->m_nNumRecords = (pMlrLog_p->m_nMapSize - MLF_HEADER_SIZE) / MLF_RECORD_SIZE;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Close MessageLog
+//---------------------------------------------------------------------------
+
+int  MlrClose (
+    tMlrLog* pMlrLog_p)                                 // [IN/OUT] Ptr to MessageLog
+{
+
+    if (pMlrLog_p == NULL)
+    {
+        return (-1);
+    }
+
+    if (pMlrLog_p->m_pabMapAddr != NULL)
+    {
+        munmap((void*)pMlrLog_p->m_pabMapAddr, pMlrLog_p->m_nMapSize);
+        pMlrLog_p->m_pabMapAddr = NULL;
+        pMlrLog_p->m_nMapSize   = 0;
+    }
+    if (pMlrLog_p->m_iFd >= 0)
+    {
+        close(pMlrLog_p->m_iFd);
+        pMlrLog_p->m_iFd = -1;
+    }
+    pMlrLog_p->m_nNumRecords = 0;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Number of Records
+//---------------------------------------------------------------------------
+
+size_t  MlrGetNumRecords (
+    const tMlrLog* pMlrLog_p)                           // [IN]     Ptr to MessageLog
+{
+
+    if (pMlrLog_p == NULL)
+    {
+        return (0);
+    }
+
+    return (pMlrLog_p->m_nNumRecords);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Record
+//---------------------------------------------------------------------------
+//  Returns a pointer into the mapped file (valid until MlrClose()), the
+//  record is not checked here (see MlrCheckRecord()).
+
+const tMlfRecord*  MlrGetRecord (
+    const tMlrLog* pMlrLog_p,                           // [IN]     Ptr to MessageLog
+    size_t nRecIdx_p)                                   // [IN]     Index of Record (0..NumRecords-1)
+{
+
+    if ((pMlrLog_p == NULL) || (nRecIdx_p >= pMlrLog_p->m_nNumRecords))
+    {
+        return (NULL);
+    }
+
+    return ((const tMlfRecord*)(pMlrLog_p->m_pabMapAddr + MLF_HEADER_SIZE + (nRecIdx_p * MLF_RECORD_SIZE)));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Check Record
+//---------------------------------------------------------------------------
+//  A record torn by a power failure (or otherwise damaged) fails the CRC.
+
+bool  MlrCheckRecord (
+    const tMlfRecord* pMlfRecord_p)                     // [IN]     Ptr to Record
+{
+
+    if (pMlfRecord_p == NULL)
+    {
+        return (false);
+    }
+    if (pMlfRecord_p->m_ui16RecLen != MLF_RECORD_SIZE)
+    {
+        return (false);
+    }
+    if (pMlfRecord_p->m_ui32CRC32 != MlfCrc32(pMlfRecord_p, offsetof(tMlfRecord, m_ui32CRC32)))
+    {
+        return (false);
+    }
+
+    return (true);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get decoded Record Fields
+//---------------------------------------------------------------------------
+//  The result can be passed to PprBuildJsonRecord(), PprBuildLineRecord()
+//  or PprBuildCsvRecord() to get the same records as the live Gateway.
+
+int  MlrGetRecordFields (
+    const tMlfRecord* pMlfRecord_p,                     // [IN]     Ptr to Record
+    tPprRecordFields* pRecordFields_p)                  // [OUT]    Ptr to decoded Record Fields
+{
+
+    if ((pMlfRecord_p == NULL) || (pRecordFields_p == NULL))
+    {
+        return (-1);
+    }
+    if (pMlfRecord_p->m_ui8SchemaRecLen > sizeof(pRecordFields_p->m_SchemaRec))
+    {
+        return (-2);
+    }
+
+    memset(pRecordFields_p, 0, sizeof(tPprRecordFields));
+    pRecordFields_p->m_uiMsgID             = (uint)pMlfRecord_p->m_ui32MsgID;
+    pRecordFields_p->m_PacketType          = (tLoraPacketType)pMlfRecord_p->m_ui8PacketType;
+    pRecordFields_p->m_uiDataGen           = (uint)pMlfRecord_p->m_ui8DataGen;
+    pRecordFields_p->m_tmTimeStamp         = (time_t)pMlfRecord_p->m_i64TimeStamp;
+    pRecordFields_p->m_i8Rssi              = pMlfRecord_p->m_i8Rssi;
+    pRecordFields_p->m_ui8DevID            = pMlfRecord_p->m_ui8DevID;
+    pRecordFields_p->m_ui32SequNum         = pMlfRecord_p->m_ui32SequNum;
+    pRecordFields_p->m_ui32Uptime          = pMlfRecord_p->m_ui32Uptime;
+    pRecordFields_p->m_ui8FirmwareVersion  = pMlfRecord_p->m_ui8FirmwareVersion;
+    pRecordFields_p->m_ui8FirmwareRevision = pMlfRecord_p->m_ui8FirmwareRevision;
+    memcpy(&pRecordFields_p->m_SchemaRec, pMlfRecord_p->m_abSchemaRec, pMlfRecord_p->m_ui8SchemaRecLen);
+
+    return (0);
+
+}
+
+
+
+// EOF
+
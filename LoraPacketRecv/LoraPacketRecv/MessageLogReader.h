@@ -0,0 +1,72 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Declarations for Reader of binary MessageLog
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _MESSAGELOGREADER_H_
+#define _MESSAGELOGREADER_H_
+
+#include "MessageLogFormat.h"
+
+
+
+//---------------------------------------------------------------------------
+//  Type definitions
+//---------------------------------------------------------------------------
+
+//  One opened MessageLog. All functions only read the mapped file, so several
+//  threads can work on the same <tMlrLog> at the same time.
+typedef struct
+{
+    int                 m_iFd;
+    const uint8_t*      m_pabMapAddr;               // read-only mapping of the whole file
+    size_t              m_nMapSize;
+    tMlfFileHeader      m_FileHeader;
+    size_t              m_nNumRecords;              // complete records (an incomplete last record is ignored)
+
+} tMlrLog;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of public functions
+//---------------------------------------------------------------------------
+
+int  MlrOpen (
+    const char* pszMsgFileName_p,                       // [IN]     Path/Name of MessageLog
+    tMlrLog* pMlrLog_p);                                // [OUT]    Ptr to MessageLog
+
+int  MlrClose (
+    tMlrLog* pMlrLog_p);                                // [IN/OUT] Ptr to MessageLog
+
+size_t  MlrGetNumRecords (
+    const tMlrLog* pMlrLog_p);                          // [IN]     Ptr to MessageLog
+
+const tMlfRecord*  MlrGetRecord (
+    const tMlrLog* pMlrLog_p,                           // [IN]     Ptr to MessageLog
+    size_t nRecIdx_p);                                  // [IN]     Index of Record (0..NumRecords-1)
+
+bool  MlrCheckRecord (
+    const tMlfRecord* pMlfRecord_p);                    // [IN]     Ptr to Record
+
+int  MlrGetRecordFields (
+    const tMlfRecord* pMlfRecord_p,                     // [IN]     Ptr to Record
+    tPprRecordFields* pRecordFields_p);                 // [OUT]    Ptr to decoded Record Fields
+
+
+
+#endif  // #ifndef _MESSAGELOGREADER_H_
+
+
+// EOF
+
@@ -10,6 +10,10 @@
   Revision History:
 
   2023/03/25 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Add MquIsSequNumToBeProcessed() for caller-owned
+                          SequNum History Lists (used by LoraChannelSim)
+  2026/10/18 -rs:   V1.02 SequNum History covers Delta Data Packets with
+                          up to LORA_DATA_GEN_DEPTH_MAX generations
 
 ****************************************************************************/
 
@@ -85,21 +89,21 @@ static  uint32_t    aui32SequNumHistList_l[LORA_DEVICES][SEQU_NUM_HIST_LIST] = {
 //  Prototypes of internal functions
 //---------------------------------------------------------------------------
 
-static  int  MquClearMessageList (
-    uint uiDevID_p);
+static  void  MquClearMessageList (
+    uint32_t* paui32SequNumHistList_p);
 
 
-static  int  MquGetHighestSequNum (
-    uint uiDevID_p);
+static  uint32_t  MquGetHighestSequNum (
+    const uint32_t* paui32SequNumHistList_p);
 
 
 static  int  MquIsSequNumInMessageList (
-    uint uiDevID_p,
+    const uint32_t* paui32SequNumHistList_p,
     uint32_t ui32SequNum_p);
 
 
-static  int  MquAppendSequNum (
-    uint uiDevID_p,
+static  void  MquAppendSequNum (
+    uint32_t* paui32SequNumHistList_p,
     uint32_t ui32SequNum_p);
 
 
@@ -145,12 +149,7 @@ int  MquIsMessageToBeProcessed (
     tJsonMessage* pJsonMessage_p)                       // [IN]     Ptr to Json Message
 {
 
-tLoraPacketType  PacketType;
-uint             uiDevID;
-uint32_t         ui32SequNum;
-uint32_t         ui32HighestSequNum;
-int              iIsSequNumInMessageList;
-int              iMessageToBeProcessed;
+uint  uiDevID;
 
 
     if (pJsonMessage_p == NULL)
@@ -159,43 +158,68 @@ int              iMessageToBeProcessed;
         return (-1);
     }
 
-    PacketType  = pJsonMessage_p->m_PacketType;
-    uiDevID     = (uint)pJsonMessage_p->m_ui8DevID;
-    ui32SequNum = pJsonMessage_p->m_ui32SequNum;
-
+    uiDevID = (uint)pJsonMessage_p->m_ui8DevID;
     if (uiDevID >= LORA_DEVICES)
     {
         TRACE0("ERROR: Invalid Parameter!\n");
         return (-1);
     }
 
-    switch (PacketType)
+    return (MquIsSequNumToBeProcessed(aui32SequNumHistList_l[uiDevID], pJsonMessage_p->m_PacketType, pJsonMessage_p->m_ui32SequNum));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  MquIsSequNumToBeProcessed
+//---------------------------------------------------------------------------
+
+int  MquIsSequNumToBeProcessed (
+    uint32_t* paui32SequNumHistList_p,                  // [IN/OUT] SequNum History List of Device [SEQU_NUM_HIST_LIST]
+    tLoraPacketType PacketType_p,                       // [IN]     PacketType (Bootup or DataGen0..N)
+    uint32_t ui32SequNum_p)                             // [IN]     SequNum of Data Record
+{
+
+uint32_t  ui32HighestSequNum;
+int       iIsSequNumInMessageList;
+int       iMessageToBeProcessed;
+
+
+    if (paui32SequNumHistList_p == NULL)
+    {
+        TRACE0("ERROR: Invalid Parameter!\n");
+        return (-1);
+    }
+
+    switch (PacketType_p)
     {
         case kLoraPacketBootup:
         {
             // when the SensorDevice is reset, the entire previous sequence history loses its validity
-            MquClearMessageList(uiDevID);
+            MquClearMessageList(paui32SequNumHistList_p);
             iMessageToBeProcessed = 1;          // always process <kLoraPacketBootup> message
             break;
         }
 
         case kLoraPacketDataGen0:
         {
-            ui32HighestSequNum = (uint32_t)MquGetHighestSequNum(uiDevID);
-            if (ui32SequNum < ui32HighestSequNum)
+            ui32HighestSequNum = MquGetHighestSequNum(paui32SequNumHistList_p);
+            if (ui32SequNum_p < ui32HighestSequNum)
             {
                 // a jump back in the sequence history means a reset of the SensorDevice with a simultaneous loss of the bootup message
-                MquClearMessageList(uiDevID);
+                MquClearMessageList(paui32SequNumHistList_p);
             }
-            MquAppendSequNum(uiDevID, ui32SequNum);
+            MquAppendSequNum(paui32SequNumHistList_p, ui32SequNum_p);
             iMessageToBeProcessed = 1;          // always process <kLoraPacketDataGen0> message
             break;
         }
 
         case kLoraPacketDataGen1:
         case kLoraPacketDataGen2:
+        case kLoraPacketDataGenN:
         {
-            iIsSequNumInMessageList = MquIsSequNumInMessageList(uiDevID, ui32SequNum);
+            iIsSequNumInMessageList = MquIsSequNumInMessageList(paui32SequNumHistList_p, ui32SequNum_p);
             if (iIsSequNumInMessageList == 1)
             {
                 // message was already processed -> ignore duplicate
@@ -204,7 +228,7 @@ int              iMessageToBeProcessed;
             else
             {
                 // process message copy after loss of original Gen0 message
-                MquAppendSequNum(uiDevID, ui32SequNum);
+                MquAppendSequNum(paui32SequNumHistList_p, ui32SequNum_p);
                 iMessageToBeProcessed = 1;
             }
             break;
@@ -212,7 +236,7 @@ int              iMessageToBeProcessed;
 
         default:
         {
-            TRACE1("ERROR: Unexpected PacketType (%d)!\n", (int)pJsonMessage_p->m_PacketType);
+            TRACE1("ERROR: Unexpected PacketType (%d)!\n", (int)PacketType_p);
             iMessageToBeProcessed = -2;
             break;
         }
@@ -272,24 +296,19 @@ uint  uiIdxSequNum;
 //  MquClearMessageList
 //---------------------------------------------------------------------------
 
-static  int  MquClearMessageList (
-    uint uiDevID_p)
+static  void  MquClearMessageList (
+    uint32_t* paui32SequNumHistList_p)
 {
 
 uint  uiIdxSequNum;
 
 
-    if (uiDevID_p >= LORA_DEVICES)
-    {
-        return (-1);
-    }
-
     for (uiIdxSequNum=0; uiIdxSequNum<SEQU_NUM_HIST_LIST; uiIdxSequNum++)
     {
-        aui32SequNumHistList_l[uiDevID_p][uiIdxSequNum] = 0;
+        paui32SequNumHistList_p[uiIdxSequNum] = 0;
     }
 
-    return (0);
+    return;
 
 }
 
@@ -299,29 +318,24 @@ uint  uiIdxSequNum;
 //  MquGetHighestSequNum
 //---------------------------------------------------------------------------
 
-static  int  MquGetHighestSequNum (
-    uint uiDevID_p)
+static  uint32_t  MquGetHighestSequNum (
+    const uint32_t* paui32SequNumHistList_p)
 {
 
 uint32_t  ui32HighestSequNum;
 uint      uiIdxSequNum;
 
 
-    if (uiDevID_p >= LORA_DEVICES)
-    {
-        return (-1);
-    }
-
     ui32HighestSequNum = 0;
     for (uiIdxSequNum=0; uiIdxSequNum<SEQU_NUM_HIST_LIST; uiIdxSequNum++)
     {
-        if (ui32HighestSequNum < aui32SequNumHistList_l[uiDevID_p][uiIdxSequNum])
+        if (ui32HighestSequNum < paui32SequNumHistList_p[uiIdxSequNum])
         {
-            ui32HighestSequNum = aui32SequNumHistList_l[uiDevID_p][uiIdxSequNum];
+            ui32HighestSequNum = paui32SequNumHistList_p[uiIdxSequNum];
         }
     }
 
-    return ((int)ui32HighestSequNum);
+    return (ui32HighestSequNum);
 
 }
 
@@ -332,21 +346,16 @@ uint      uiIdxSequNum;
 //---------------------------------------------------------------------------
 
 static  int  MquIsSequNumInMessageList (
-    uint uiDevID_p,
+    const uint32_t* paui32SequNumHistList_p,
     uint32_t ui32SequNum_p)
 {
 
 uint  uiIdxSequNum;
 
 
-    if (uiDevID_p >= LORA_DEVICES)
-    {
-        return (-1);
-    }
-
     for (uiIdxSequNum=0; uiIdxSequNum<SEQU_NUM_HIST_LIST; uiIdxSequNum++)
     {
-        if (aui32SequNumHistList_l[uiDevID_p][uiIdxSequNum] == ui32SequNum_p)
+        if (paui32SequNumHistList_p[uiIdxSequNum] == ui32SequNum_p)
         {
             return (1);
         }
@@ -362,26 +371,21 @@ uint  uiIdxSequNum;
 //  MquAppendSequNum
 //---------------------------------------------------------------------------
 
-static  int  MquAppendSequNum (
-    uint uiDevID_p,
+static  void  MquAppendSequNum (
+    uint32_t* paui32SequNumHistList_p,
     uint32_t ui32SequNum_p)
 {
 
 uint  uiIdxSequNum;
 
 
-    if (uiDevID_p >= LORA_DEVICES)
-    {
-        return (-1);
-    }
-
     for (uiIdxSequNum=1; uiIdxSequNum<SEQU_NUM_HIST_LIST; uiIdxSequNum++)
     {
-        aui32SequNumHistList_l[uiDevID_p][uiIdxSequNum-1] = aui32SequNumHistList_l[uiDevID_p][uiIdxSequNum];
+        paui32SequNumHistList_p[uiIdxSequNum-1] = paui32SequNumHistList_p[uiIdxSequNum];
     }
-    aui32SequNumHistList_l[uiDevID_p][uiIdxSequNum-1] = ui32SequNum_p;
+    paui32SequNumHistList_p[uiIdxSequNum-1] = ui32SequNum_p;
 
-    return (0);
+    return;
 
 }
 
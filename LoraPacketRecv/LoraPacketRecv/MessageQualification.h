@@ -10,6 +10,10 @@
   Revision History:
 
   2023/03/25 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Add MquIsSequNumToBeProcessed() for caller-owned
+                          SequNum History Lists (used by LoraChannelSim)
+  2026/10/18 -rs:   V1.02 SequNum History covers Delta Data Packets with
+                          up to LORA_DATA_GEN_DEPTH_MAX generations
 
 ****************************************************************************/
 
@@ -23,7 +27,7 @@
 //---------------------------------------------------------------------------
 
 const  uint  LORA_DEVICES           = 16;
-const  uint  SEQU_NUM_HIST_LIST     = 10;
+const  uint  SEQU_NUM_HIST_LIST     = (2 * LORA_DATA_GEN_DEPTH_MAX);   // covers all generations of a Delta Data Packet
 
 
 
@@ -42,6 +46,11 @@ void  MquInitialize ();
 int  MquIsMessageToBeProcessed (
     tJsonMessage* pJsonMessage_p);                      // [IN] Ptr to Json Message
 
+int  MquIsSequNumToBeProcessed (
+    uint32_t* paui32SequNumHistList_p,                  // [IN/OUT] SequNum History List of Device [SEQU_NUM_HIST_LIST]
+    tLoraPacketType PacketType_p,                       // [IN] PacketType (Bootup or DataGen0..N)
+    uint32_t ui32SequNum_p);                            // [IN] SequNum of Data Record
+
 void  MquPrintSequNumHistList ();
 
 
@@ -0,0 +1,1443 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Implementation of Re-Publishing of archived MessageFiles
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+
+#include <RH_RF95.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "LoraPacket.h"
+#include "LoraPacketSchema.h"
+#include "LoraPayloadDecoder.h"
+#include "PacketProcessing.h"
+#include "MessageQualification.h"
+#include "MessageLogFormat.h"
+#include "MessageLogReader.h"
+#include "MessageIndex.h"
+#include "MessageSink.h"
+#include "MessageReplay.h"
+#include "Trace.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+static  const char      JSON_KEY_MSGID[]        = "\"MsgID\": ";
+static  const char      JSON_KEY_DEVID[]        = "\"DevID\": ";
+static  const char      JSON_KEY_TIMESTAMP[]    = "\"TimeStamp\": ";
+static  const char      JSON_KEY_DATA_REC[]     = "\"MsgType\": \"StationData";
+static  const char      JSON_REC_DELIMITER[]    = "\n\n";
+
+static  const char      COMPRESS_EXTENSION[]    = ".gz";
+static  const char      TEMP_EXTENSION[]        = ".tmp";
+
+static  const uint      MRP_WINDOW_PER_THREAD   = 2;                // chunks read ahead per reader thread
+static  const uint      MRP_JSON_READ_AHEAD     = 64 * 1024;        // [bytes] record crossing the end of a chunk
+static  const uint      MRP_SUBMIT_TIMEOUT      = 100;              // [ms] MskSubmit(), then check for stop
+static  const uint      MRP_POLL_INTERVAL       = 100;              // [ms] publisher waits for chunk or sink
+
+//  I/O priority of reader threads (see linux/ioprio.h)
+static  const int       IOPRIO_WHO_PROCESS      = 1;
+static  const int       IOPRIO_CLASS_IDLE       = 3;
+static  const int       IOPRIO_CLASS_SHIFT      = 13;
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+//  MessageFile read with pread() (not mapped, so that an archive of several GB
+//  isn't locked into memory by mlockall() in real-time mode)
+typedef struct
+{
+    std::string             m_strFileName;
+    bool                    m_fBinary;
+    int                     m_iFd;
+    uint64_t                m_ui64DataEnd;          // binary: behind last complete record
+
+} tMrpFile;
+
+
+//  Range of a MessageFile read by one reader thread
+typedef struct
+{
+    uint                    m_uiFile;
+    uint64_t                m_ui64Offset;
+    uint64_t                m_ui64Length;
+    bool                    m_fAtRecStart;          // <m_ui64Offset> is known as start of a record
+
+    // result, owned by the reader until <m_fDone> is set
+    bool                    m_fDone;
+    std::vector<tJsonMessage>  m_vecMessages;
+    std::vector<uint64_t>   m_vecRecEnd;            // per message: position behind its record
+    uint64_t                m_ui64ResumeOffset;     // behind last record starting in chunk (0 = none)
+    uint                    m_uiRecords;
+    uint                    m_uiDamaged;
+
+} tMrpChunk;
+
+
+//  Position that becomes the checkpoint once the sink has handled <m_ui64Seq> messages
+typedef struct
+{
+    uint64_t                m_ui64Seq;
+    uint                    m_uiFile;
+    uint64_t                m_ui64Offset;
+
+} tMrpPending;
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+static  tMrpConfig              Config_l;
+static  std::string             strCheckpointFile_l;
+static  std::vector<tMrpFile>   vecFiles_l;
+static  std::vector<tMrpChunk>  vecChunks_l;
+static  bool                    fOpen_l             = false;
+static  bool                    fRunning_l          = false;
+
+static  std::mutex              Mutex_l;            // protects chunk states and statistics
+static  std::condition_variable CondWindow_l;       // reader waits for free space in read-ahead window
+static  std::condition_variable CondChunkDone_l;    // publisher waits for next chunk
+static  size_t                  nNextChunk_l        = 0;
+static  size_t                  nPublishChunk_l     = 0;
+static  size_t                  nWindow_l           = 0;
+static  std::atomic<bool>       fStop_l;
+static  std::atomic<bool>       fDone_l;
+static  std::vector<std::thread>  vecReaderThreads_l;
+static  std::thread             PublisherThread_l;
+
+// checkpoint (publisher thread, MrpClose() after it has stopped)
+static  std::deque<tMrpPending> deqPending_l;
+static  uint64_t                ui64SinkBase_l      = 0;    // <m_ui64Backfilled> of sink at MrpStart()
+static  uint                    uiCkptFile_l        = 0;
+static  uint64_t                ui64CkptOffset_l    = 0;    // 0 = begin of file
+static  uint64_t                ui64CkptPublished_l = 0;    // of previous runs
+static  bool                    fCkptComplete_l     = false;
+static  bool                    fCkptChanged_l      = false;
+static  int64_t                 i64NextCkptWrite_l  = 0;
+
+// statistics (protected by <Mutex_l>)
+static  tMrpStatistics          Statistics_l;
+static  int64_t                 i64StartTime_l      = 0;    // [us]
+static  int64_t                 i64DoneTime_l       = 0;    // [us] (0 = running)
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  int  MrpOpenFile (
+    const char* pszFileName_p,
+    tMrpFile* pFile_p);
+
+static  int  MrpReadCheckpoint (void);
+
+static  int  MrpWriteCheckpoint (void);
+
+static  void  MrpUpdateCheckpoint (
+    bool fForce_p);
+
+static  void  MrpAddChunks (
+    uint uiFile_p,
+    uint64_t ui64Start_p,
+    uint64_t ui64End_p,
+    bool fAtRecStart_p);
+
+static  void  MrpReaderThread (void);
+
+static  void  MrpReadBinary (
+    tMrpChunk* pChunk_p);
+
+static  void  MrpReadJson (
+    tMrpChunk* pChunk_p);
+
+static  void  MrpPublisherThread (void);
+
+static  bool  MrpSubmitMessage (
+    const tJsonMessage* pJsonMessage_p,
+    double* pdTokens_p,
+    int64_t* pi64TokenTime_p);
+
+static  bool  MrpReadRange (
+    int iFd_p,
+    uint64_t ui64Offset_p,
+    size_t nLength_p,
+    std::string* pstrBuffer_p);
+
+static  void  MrpLowerPriority (void);
+
+static  int64_t  MrpGetTimeUs (void);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Open MessageFiles and select the Chunks to re-publish
+//---------------------------------------------------------------------------
+//  The reading starts behind the checkpoint, for each file only the blocks
+//  whose index entry matches the time range are read, ranges not covered by
+//  the index are read completely. If a file can't be opened, -10 minus the
+//  error of MrpOpenFile() is returned (e.g. -16: Json MessageFile, but the
+//  sink needs binary records).
+
+int  MrpOpen (
+    const tMrpConfig* pConfig_p)                        // [IN]     Ptr to Replay Configuration
+{
+
+std::vector<tMixEntry>  vecMixEntries;
+const tMrpFile*  pFile;
+uint64_t         ui64DataStart;
+uint64_t         ui64Pos;
+uint64_t         ui64EntryEnd;
+size_t           nIdx;
+uint             uiFile;
+int              iRes;
+
+
+    if ((pConfig_p == NULL) || (pConfig_p->m_apszMsgFiles == NULL) || (pConfig_p->m_uiMsgFiles == 0))
+    {
+        return (-1);
+    }
+    if ( fOpen_l )
+    {
+        return (-2);
+    }
+    if (pConfig_p->m_uiSink >= MskGetSinkCount())
+    {
+        return (-3);
+    }
+
+    Config_l = *pConfig_p;
+    i64StartTime_l = 0;
+    i64DoneTime_l  = 0;
+    if (Config_l.m_uiBurst == 0)
+    {
+        Config_l.m_uiBurst = MRP_DEF_BURST;
+    }
+    if (Config_l.m_uiThreads == 0)
+    {
+        Config_l.m_uiThreads = MRP_DEF_THREADS;
+    }
+    strCheckpointFile_l = (Config_l.m_pszCheckpointFile != NULL) ? Config_l.m_pszCheckpointFile
+                                                                 : (std::string(Config_l.m_apszMsgFiles[0]) + MRP_CHECKPOINT_EXTENSION);
+    memset(&Statistics_l, 0, sizeof(Statistics_l));
+    vecFiles_l.clear();
+    vecChunks_l.clear();
+    deqPending_l.clear();
+
+    // open all files
+    vecFiles_l.resize(Config_l.m_uiMsgFiles);
+    for (uiFile=0; uiFile<Config_l.m_uiMsgFiles; uiFile++)
+    {
+        iRes = MrpOpenFile(Config_l.m_apszMsgFiles[uiFile], &vecFiles_l[uiFile]);
+        if (iRes < 0)
+        {
+            TRACE2("\nMrpOpen: can't open '%s' (iRes=%d)\n", Config_l.m_apszMsgFiles[uiFile], iRes);
+            vecFiles_l.resize(uiFile + 1);
+            fOpen_l = true;
+            MrpClose();
+            return (iRes - 10);
+        }
+        Statistics_l.m_ui64BytesTotal += vecFiles_l[uiFile].m_ui64DataEnd;
+    }
+    Statistics_l.m_uiFiles = (uint)vecFiles_l.size();
+    fOpen_l = true;
+
+    // continue behind the checkpoint of a previous run
+    uiCkptFile_l        = 0;
+    ui64CkptOffset_l    = 0;
+    ui64CkptPublished_l = 0;
+    fCkptComplete_l     = false;
+    fCkptChanged_l      = false;
+    iRes = MrpReadCheckpoint();
+    if (iRes < 0)
+    {
+        MrpClose();
+        return (-4);
+    }
+
+    // select the ranges to read
+    for (uiFile=uiCkptFile_l; (uiFile<vecFiles_l.size()) && !fCkptComplete_l; uiFile++)
+    {
+        pFile = &vecFiles_l[uiFile];
+        ui64DataStart = pFile->m_fBinary ? MLF_HEADER_SIZE : 0;
+        ui64Pos = ui64DataStart;
+        if ((uiFile == uiCkptFile_l) && (ui64CkptOffset_l > ui64Pos))
+        {
+            ui64Pos = ui64CkptOffset_l;
+        }
+
+        vecMixEntries.clear();
+        MixLoad(MixGetIndexFileName(pFile->m_strFileName.c_str()).c_str(), pFile->m_ui64DataEnd, &vecMixEntries);
+
+        for (nIdx=0; nIdx<vecMixEntries.size(); nIdx++)
+        {
+            ui64EntryEnd = vecMixEntries[nIdx].m_ui64Offset + vecMixEntries[nIdx].m_ui32Length;
+            if ( (ui64EntryEnd <= ui64Pos) ||
+                 (vecMixEntries[nIdx].m_ui64Offset < ui64DataStart) ||
+                 (pFile->m_fBinary && (((vecMixEntries[nIdx].m_ui64Offset - MLF_HEADER_SIZE) % MLF_RECORD_SIZE) != 0)) ||
+                 (pFile->m_fBinary && ((vecMixEntries[nIdx].m_ui32Length % MLF_RECORD_SIZE) != 0)) )
+            {
+                continue;                               // before checkpoint or doesn't fit to this file
+            }
+            if (vecMixEntries[nIdx].m_ui64Offset < ui64Pos)
+            {
+                MrpAddChunks(uiFile, ui64Pos, ui64EntryEnd, true);      // block with checkpoint: read rest of block
+            }
+            else
+            {
+                MrpAddChunks(uiFile, ui64Pos, vecMixEntries[nIdx].m_ui64Offset, true);
+                if ( MixEntryMatches(&vecMixEntries[nIdx], -1, Config_l.m_i64FromTime, Config_l.m_i64ToTime) )
+                {
+                    MrpAddChunks(uiFile, vecMixEntries[nIdx].m_ui64Offset, ui64EntryEnd, true);
+                }
+            }
+            ui64Pos = ui64EntryEnd;
+        }
+        MrpAddChunks(uiFile, ui64Pos, pFile->m_ui64DataEnd, true);
+    }
+
+    Statistics_l.m_uiChunks = (uint)vecChunks_l.size();
+    Statistics_l.m_ui64PublishedTotal = ui64CkptPublished_l;
+    Statistics_l.m_fDone = fCkptComplete_l;
+    fDone_l = fCkptComplete_l;
+
+    TRACE3("\nMrpOpen: %u Files, %u Chunks, Checkpoint='%s'\n", Statistics_l.m_uiFiles, Statistics_l.m_uiChunks, strCheckpointFile_l.c_str());
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Start Reader and Publisher Threads
+//---------------------------------------------------------------------------
+
+int  MrpStart (void)
+{
+
+tMskStatistics  SinkStatistics;
+uint            uiThread;
+
+
+    if (!fOpen_l || fRunning_l)
+    {
+        return (-1);
+    }
+
+    MskGetStatistics(Config_l.m_uiSink, &SinkStatistics);
+    ui64SinkBase_l  = SinkStatistics.m_ui64Backfilled;
+    nNextChunk_l    = 0;
+    nPublishChunk_l = 0;
+    nWindow_l       = Config_l.m_uiThreads * MRP_WINDOW_PER_THREAD;
+    fStop_l         = false;
+    fDone_l         = fCkptComplete_l;
+    i64StartTime_l  = MrpGetTimeUs();
+    i64DoneTime_l   = fCkptComplete_l ? i64StartTime_l : 0;
+    i64NextCkptWrite_l = i64StartTime_l + (MRP_CHECKPOINT_INTERVAL * 1000);
+    fRunning_l      = true;
+
+    if ( fCkptComplete_l )
+    {
+        return (0);                                     // nothing left to re-publish
+    }
+
+    for (uiThread=0; uiThread<Config_l.m_uiThreads; uiThread++)
+    {
+        vecReaderThreads_l.push_back(std::thread(MrpReaderThread));
+    }
+    PublisherThread_l = std::thread(MrpPublisherThread);
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Stop Reader and Publisher Threads
+//---------------------------------------------------------------------------
+//  Messages already handed over to the sink are still written, the final
+//  checkpoint is written by MrpClose() (after MskStop()).
+
+int  MrpStop (void)
+{
+
+size_t  nIdx;
+
+
+    if ( !fRunning_l )
+    {
+        return (-1);
+    }
+
+    {
+        std::lock_guard<std::mutex>  Lock(Mutex_l);
+        fStop_l = true;
+        if (i64DoneTime_l == 0)
+        {
+            i64DoneTime_l = MrpGetTimeUs();
+        }
+        CondWindow_l.notify_all();
+        CondChunkDone_l.notify_all();
+    }
+
+    if ( PublisherThread_l.joinable() )
+    {
+        PublisherThread_l.join();
+    }
+    for (nIdx=0; nIdx<vecReaderThreads_l.size(); nIdx++)
+    {
+        vecReaderThreads_l[nIdx].join();
+    }
+    vecReaderThreads_l.clear();
+
+    fRunning_l = false;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Write final Checkpoint and close MessageFiles
+//---------------------------------------------------------------------------
+
+int  MrpClose (void)
+{
+
+size_t  nIdx;
+
+
+    if ( !fOpen_l )
+    {
+        return (-1);
+    }
+
+    MrpStop();
+
+    // the sink has stopped meanwhile, so its statistics are final
+    if (i64StartTime_l != 0)
+    {
+        MrpUpdateCheckpoint(true);
+    }
+
+    for (nIdx=0; nIdx<vecFiles_l.size(); nIdx++)
+    {
+        if (vecFiles_l[nIdx].m_iFd >= 0)
+        {
+            close(vecFiles_l[nIdx].m_iFd);
+        }
+    }
+    vecFiles_l.clear();
+    std::vector<tMrpChunk>().swap(vecChunks_l);
+    deqPending_l.clear();
+    fOpen_l = false;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Check if all Messages are re-published
+//---------------------------------------------------------------------------
+
+bool  MrpIsDone (void)
+{
+
+    return (fDone_l);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Statistics
+//---------------------------------------------------------------------------
+
+int  MrpGetStatistics (
+    tMrpStatistics* pStatistics_p)                      // [OUT]    Ptr to Statistics
+{
+
+int64_t  i64Now;
+int64_t  i64RunTime;
+
+
+    if (pStatistics_p == NULL)
+    {
+        return (-1);
+    }
+
+    std::lock_guard<std::mutex>  Lock(Mutex_l);
+
+    *pStatistics_p = Statistics_l;
+    pStatistics_p->m_fDone = fDone_l;
+
+    i64Now = MrpGetTimeUs();
+    i64RunTime = ((i64DoneTime_l != 0) ? i64DoneTime_l : i64Now) - i64StartTime_l;
+    if ((i64StartTime_l != 0) && (i64RunTime > 0))
+    {
+        pStatistics_p->m_dRunTime    = (double)i64RunTime / 1000000.0;
+        pStatistics_p->m_dThroughput = (double)Statistics_l.m_ui64Published * 1000000.0 / (double)i64RunTime;
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Print Statistics
+//---------------------------------------------------------------------------
+
+void  MrpPrintStatistics (void)
+{
+
+tMrpStatistics  Statistics;
+
+
+    MrpGetStatistics(&Statistics);
+
+    printf("Message Replay:\n");
+    printf("  Files             = %u (%.1f MB), %u/%u chunks read\n", Statistics.m_uiFiles,
+           (double)Statistics.m_ui64BytesTotal / (1024.0 * 1024.0), Statistics.m_uiChunksDone, Statistics.m_uiChunks);
+    printf("  Records           = %llu read, %llu in time range, %llu damaged (%.1f MB read)\n",
+           (unsigned long long)Statistics.m_ui64Records, (unsigned long long)Statistics.m_ui64Matches,
+           (unsigned long long)Statistics.m_ui64Damaged, (double)Statistics.m_ui64BytesRead / (1024.0 * 1024.0));
+    printf("  Published         = %llu of %llu submitted (total incl. previous runs: %llu)%s\n",
+           (unsigned long long)Statistics.m_ui64Published, (unsigned long long)Statistics.m_ui64Submitted,
+           (unsigned long long)Statistics.m_ui64PublishedTotal, (Statistics.m_fDone ? ", complete" : ""));
+    printf("  Throughput        = %.1f messages/s sustained over %.1f s (rate limit: %u/s, burst %u)\n",
+           Statistics.m_dThroughput, Statistics.m_dRunTime, Config_l.m_uiRate, Config_l.m_uiBurst);
+    printf("  Waited            = %.1f s for tokens, %.1f s for sink\n",
+           (double)Statistics.m_ui64ThrottledUs / 1000000.0, (double)Statistics.m_ui64BlockedUs / 1000000.0);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Parse Time of Range (seconds since 1970 or local time)
+//---------------------------------------------------------------------------
+
+bool  MrpParseTime (
+    const char* pszTime_p,                              // [IN]     Seconds since 1970 or 'YYYY/MM/DD[-hh:mm[:ss]]'
+    bool fEndOfDay_p,                                   // [IN]     Date only: end of day instead of begin
+    int64_t* pi64Time_p)                                // [OUT]    Linux Standard Time
+{
+
+struct tm    TimeInfo;
+const char*  pszEnd;
+char*        pszNumEnd;
+long long    llSeconds;
+
+
+    if ((pszTime_p == NULL) || (*pszTime_p == '\0'))
+    {
+        return (false);
+    }
+
+    // seconds since 1970
+    if (strchr(pszTime_p, '/') == NULL)
+    {
+        llSeconds = strtoll(pszTime_p, &pszNumEnd, 10);
+        if (*pszNumEnd != '\0')
+        {
+            return (false);
+        }
+        *pi64Time_p = (int64_t)llSeconds;
+        return (true);
+    }
+
+    // 'YYYY/MM/DD[-hh:mm[:ss]]' in local time
+    memset(&TimeInfo, 0, sizeof(TimeInfo));
+    pszEnd = strptime(pszTime_p, "%Y/%m/%d", &TimeInfo);
+    if (pszEnd == NULL)
+    {
+        return (false);
+    }
+    if (*pszEnd == '\0')
+    {
+        if ( fEndOfDay_p )
+        {
+            TimeInfo.tm_hour = 23;
+            TimeInfo.tm_min  = 59;
+            TimeInfo.tm_sec  = 59;
+        }
+    }
+    else
+    {
+        pszEnd = strptime(pszEnd, "-%H:%M", &TimeInfo);
+        if ((pszEnd != NULL) && (*pszEnd == ':'))
+        {
+            pszEnd = strptime(pszEnd, ":%S", &TimeInfo);
+        }
+        if ((pszEnd == NULL) || (*pszEnd != '\0'))
+        {
+            return (false);
+        }
+    }
+
+    TimeInfo.tm_isdst = -1;
+    *pi64Time_p = (int64_t)mktime(&TimeInfo);
+
+    return (true);
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Open MessageFile
+//---------------------------------------------------------------------------
+//  A file starting with the MessageLog magic is read as binary MessageLog,
+//  all others as Json MessageFile.
+
+static  int  MrpOpenFile (
+    const char* pszFileName_p,
+    tMrpFile* pFile_p)
+{
+
+tMlfFileHeader  FileHeader;
+struct stat     FileStat;
+size_t          nNameLen;
+ssize_t         iRead;
+
+
+    pFile_p->m_strFileName = pszFileName_p;
+    pFile_p->m_fBinary     = false;
+    pFile_p->m_iFd         = -1;
+    pFile_p->m_ui64DataEnd = 0;
+
+    nNameLen = strlen(pszFileName_p);
+    if ( (nNameLen > strlen(COMPRESS_EXTENSION)) &&
+         (strcmp(pszFileName_p + nNameLen - strlen(COMPRESS_EXTENSION), COMPRESS_EXTENSION) == 0) )
+    {
+        return (-1);                                    // compressed segment
+    }
+
+    pFile_p->m_iFd = open(pszFileName_p, O_RDONLY);
+    if (pFile_p->m_iFd < 0)
+    {
+        return (-2);
+    }
+    if (fstat(pFile_p->m_iFd, &FileStat) != 0)
+    {
+        return (-3);
+    }
+    posix_fadvise(pFile_p->m_iFd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    iRead = pread(pFile_p->m_iFd, &FileHeader, sizeof(FileHeader), 0);
+    if ( (iRead >= (ssize_t)sizeof(MLF_FILE_MAGIC)) &&
+         (memcmp(FileHeader.m_achMagic, MLF_FILE_MAGIC, sizeof(MLF_FILE_MAGIC)) == 0) )
+    {
+        if ( (iRead != (ssize_t)sizeof(FileHeader)) ||
+             (FileHeader.m_ui32CRC32 != MlfCrc32(&FileHeader, offsetof(tMlfFileHeader, m_ui32CRC32))) )
+        {
+            return (-4);
+        }
+        if ( (FileHeader.m_ui16FormatVersion != MLF_FORMAT_VERSION)  ||
+             (FileHeader.m_ui16SchemaVersion != LORA_SCHEMA_VERSION) ||
+             (FileHeader.m_ui16HeaderSize    != MLF_HEADER_SIZE)     ||
+             (FileHeader.m_ui16RecordSize    != MLF_RECORD_SIZE) )
+        {
+            return (-5);                                // incompatible MessageLog
+        }
+        pFile_p->m_fBinary = true;
+        pFile_p->m_ui64DataEnd = MLF_HEADER_SIZE + ((((uint64_t)FileStat.st_size - MLF_HEADER_SIZE) / MLF_RECORD_SIZE) * MLF_RECORD_SIZE);
+        return (0);
+    }
+
+    if ( Config_l.m_fBinaryOnly )
+    {
+        return (-6);                                    // Json MessageFile, but sink needs decoded fields
+    }
+    pFile_p->m_ui64DataEnd = (uint64_t)FileStat.st_size;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Read Checkpoint of a previous Run
+//---------------------------------------------------------------------------
+//  The checkpoint names the file, so a replay started with other files
+//  than the checkpoint was written for is refused.
+
+static  int  MrpReadCheckpoint (void)
+{
+
+FILE*         pCkptFile;
+char          szLine[1024];
+char*         pszValue;
+std::string   strFileName;
+uint          uiFile;
+
+
+    pCkptFile = fopen(strCheckpointFile_l.c_str(), "r");
+    if (pCkptFile == NULL)
+    {
+        return (0);                                     // first run
+    }
+
+    while (fgets(szLine, sizeof(szLine), pCkptFile) != NULL)
+    {
+        szLine[strcspn(szLine, "\r\n")] = '\0';
+        pszValue = strchr(szLine, '=');
+        if ((szLine[0] == '#') || (pszValue == NULL))
+        {
+            continue;
+        }
+        *pszValue++ = '\0';
+        if (strcmp(szLine, "File") == 0)
+        {
+            strFileName = pszValue;
+        }
+        else if (strcmp(szLine, "Offset") == 0)
+        {
+            ui64CkptOffset_l = strtoull(pszValue, NULL, 10);
+        }
+        else if (strcmp(szLine, "Published") == 0)
+        {
+            ui64CkptPublished_l = strtoull(pszValue, NULL, 10);
+        }
+        else if (strcmp(szLine, "Complete") == 0)
+        {
+            fCkptComplete_l = (atoi(pszValue) != 0);
+        }
+    }
+    fclose(pCkptFile);
+
+    for (uiFile=0; uiFile<vecFiles_l.size(); uiFile++)
+    {
+        if (vecFiles_l[uiFile].m_strFileName == strFileName)
+        {
+            uiCkptFile_l = uiFile;
+            if (ui64CkptOffset_l > vecFiles_l[uiFile].m_ui64DataEnd)
+            {
+                return (-2);                            // file is shorter than at time of checkpoint
+            }
+            return (1);
+        }
+    }
+
+    return (-1);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Write Checkpoint (atomically by rename of a temporary file)
+//---------------------------------------------------------------------------
+
+static  int  MrpWriteCheckpoint (void)
+{
+
+std::string  strTempFile;
+FILE*        pCkptFile;
+int          iRes;
+
+
+    strTempFile = strCheckpointFile_l + TEMP_EXTENSION;
+    pCkptFile = fopen(strTempFile.c_str(), "w");
+    if (pCkptFile == NULL)
+    {
+        return (-1);
+    }
+
+    fprintf(pCkptFile, "# LoraPacketRecv Replay Checkpoint\n");
+    fprintf(pCkptFile, "File=%s\n",      vecFiles_l[uiCkptFile_l].m_strFileName.c_str());
+    fprintf(pCkptFile, "Offset=%llu\n",  (unsigned long long)ui64CkptOffset_l);
+    fprintf(pCkptFile, "Published=%llu\n", (unsigned long long)(ui64CkptPublished_l + Statistics_l.m_ui64Published));
+    fprintf(pCkptFile, "Complete=%d\n",  (fCkptComplete_l ? 1 : 0));
+    fflush(pCkptFile);
+    iRes = fsync(fileno(pCkptFile));
+    fclose(pCkptFile);
+    if (iRes != 0)
+    {
+        unlink(strTempFile.c_str());
+        return (-2);
+    }
+
+    if (rename(strTempFile.c_str(), strCheckpointFile_l.c_str()) != 0)
+    {
+        unlink(strTempFile.c_str());
+        return (-3);
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Advance Checkpoint to the Messages handled by the Sink
+//---------------------------------------------------------------------------
+
+static  void  MrpUpdateCheckpoint (
+    bool fForce_p)
+{
+
+tMskStatistics  SinkStatistics;
+uint64_t        ui64Published;
+int64_t         i64Now;
+
+
+    MskGetStatistics(Config_l.m_uiSink, &SinkStatistics);
+    ui64Published = SinkStatistics.m_ui64Backfilled - ui64SinkBase_l;
+
+    while (!deqPending_l.empty() && (deqPending_l.front().m_ui64Seq <= ui64Published))
+    {
+        uiCkptFile_l     = deqPending_l.front().m_uiFile;
+        ui64CkptOffset_l = deqPending_l.front().m_ui64Offset;
+        deqPending_l.pop_front();
+        fCkptChanged_l = true;
+    }
+
+    {
+        std::lock_guard<std::mutex>  Lock(Mutex_l);
+        Statistics_l.m_ui64Published      = ui64Published;
+        Statistics_l.m_ui64PublishedTotal = ui64CkptPublished_l + ui64Published;
+    }
+
+    i64Now = MrpGetTimeUs();
+    if ( fCkptChanged_l && (fForce_p || (i64Now >= i64NextCkptWrite_l)) )
+    {
+        if (MrpWriteCheckpoint() == 0)
+        {
+            fCkptChanged_l = false;
+        }
+        i64NextCkptWrite_l = i64Now + (MRP_CHECKPOINT_INTERVAL * 1000);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Add Range (split into Chunks for parallel reading)
+//---------------------------------------------------------------------------
+//  <ui64Start_p> is a record boundary. Chunks of a binary MessageLog are
+//  aligned to records, chunks of a Json MessageFile start at any byte and
+//  the reader looks for the first record starting in it.
+
+static  void  MrpAddChunks (
+    uint uiFile_p,
+    uint64_t ui64Start_p,
+    uint64_t ui64End_p,
+    bool fAtRecStart_p)
+{
+
+tMrpChunk  Chunk;
+uint64_t   ui64ChunkSize;
+uint64_t   ui64Pos;
+
+
+    ui64ChunkSize = vecFiles_l[uiFile_p].m_fBinary ? (MRP_CHUNK_RECORDS * MLF_RECORD_SIZE) : MRP_CHUNK_SIZE;
+
+    for (ui64Pos=ui64Start_p; ui64Pos<ui64End_p; ui64Pos+=ui64ChunkSize)
+    {
+        Chunk.m_uiFile           = uiFile_p;
+        Chunk.m_ui64Offset       = ui64Pos;
+        Chunk.m_ui64Length       = std::min(ui64End_p - ui64Pos, ui64ChunkSize);
+        Chunk.m_fAtRecStart      = (ui64Pos == ui64Start_p) ? fAtRecStart_p : false;
+        Chunk.m_fDone            = false;
+        Chunk.m_ui64ResumeOffset = 0;
+        Chunk.m_uiRecords        = 0;
+        Chunk.m_uiDamaged        = 0;
+        vecChunks_l.push_back(Chunk);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Reader Thread: read Chunks within the Read-Ahead Window
+//---------------------------------------------------------------------------
+
+static  void  MrpReaderThread (void)
+{
+
+size_t  nChunk;
+
+
+    MrpLowerPriority();
+
+    std::unique_lock<std::mutex>  Lock(Mutex_l);
+
+    for (;;)
+    {
+        while ( !fStop_l && (nNextChunk_l < vecChunks_l.size()) && (nNextChunk_l >= nPublishChunk_l + nWindow_l) )
+        {
+            CondWindow_l.wait(Lock);
+        }
+        if (fStop_l || (nNextChunk_l >= vecChunks_l.size()))
+        {
+            break;
+        }
+        nChunk = nNextChunk_l++;
+
+        Lock.unlock();
+        if ( vecFiles_l[vecChunks_l[nChunk].m_uiFile].m_fBinary )
+        {
+            MrpReadBinary(&vecChunks_l[nChunk]);
+        }
+        else
+        {
+            MrpReadJson(&vecChunks_l[nChunk]);
+        }
+        Lock.lock();
+
+        vecChunks_l[nChunk].m_fDone = true;
+        if (nChunk == nPublishChunk_l)
+        {
+            CondChunkDone_l.notify_one();
+        }
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Read Chunk of binary MessageLog
+//---------------------------------------------------------------------------
+
+static  void  MrpReadBinary (
+    tMrpChunk* pChunk_p)
+{
+
+std::string        strBuffer;
+const tMlfRecord*  pMlfRecord;
+tPprRecordFields   RecordFields;
+tJsonMessage       JsonMessage;
+uint64_t           ui64RecEnd;
+size_t             nPos;
+
+
+    if ( !MrpReadRange(vecFiles_l[pChunk_p->m_uiFile].m_iFd, pChunk_p->m_ui64Offset, (size_t)pChunk_p->m_ui64Length, &strBuffer) )
+    {
+        pChunk_p->m_uiDamaged += (uint)(pChunk_p->m_ui64Length / MLF_RECORD_SIZE);
+    }
+
+    for (nPos=0; (nPos + MLF_RECORD_SIZE) <= strBuffer.length(); nPos+=MLF_RECORD_SIZE)
+    {
+        pChunk_p->m_uiRecords++;
+        ui64RecEnd = pChunk_p->m_ui64Offset + nPos + MLF_RECORD_SIZE;
+        pMlfRecord = (const tMlfRecord*)(strBuffer.data() + nPos);
+        if ( !MlrCheckRecord(pMlfRecord) )
+        {
+            pChunk_p->m_uiDamaged++;
+            continue;
+        }
+        if ((pMlfRecord->m_i64TimeStamp < Config_l.m_i64FromTime) || (pMlfRecord->m_i64TimeStamp > Config_l.m_i64ToTime))
+        {
+            continue;
+        }
+        if (MlrGetRecordFields(pMlfRecord, &RecordFields) < 0)
+        {
+            pChunk_p->m_uiDamaged++;
+            continue;
+        }
+
+        // same content as built by PprBuildJsonMessages() at the time of receiving
+        JsonMessage.m_uiMsgID      = RecordFields.m_uiMsgID;
+        JsonMessage.m_PacketType   = RecordFields.m_PacketType;
+        JsonMessage.m_ui8DevID     = RecordFields.m_ui8DevID;
+        JsonMessage.m_ui32SequNum  = RecordFields.m_ui32SequNum;
+        JsonMessage.m_i8Rssi       = RecordFields.m_i8Rssi;
+        JsonMessage.m_tmTimeStamp  = (time_t)pMlfRecord->m_i64RxTimeStamp;
+        JsonMessage.m_RecordFields = RecordFields;
+        PprBuildJsonRecord(&RecordFields, &JsonMessage.m_strJsonRecord);
+        PprBuildLineRecord(&RecordFields, &JsonMessage.m_strLineRecord);
+
+        pChunk_p->m_vecMessages.push_back(JsonMessage);
+        pChunk_p->m_vecRecEnd.push_back(ui64RecEnd);
+    }
+
+    pChunk_p->m_ui64ResumeOffset = pChunk_p->m_ui64Offset + pChunk_p->m_ui64Length;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Read Chunk of Json MessageFile
+//---------------------------------------------------------------------------
+//  Records are separated by an empty line, so a record starts at the
+//  beginning of the file or behind "\n\n". Each record belongs to the chunk
+//  it starts in, a record crossing the end of the chunk is read on. The
+//  record is re-published unchanged, only "MsgID", "DevID", "TimeStamp" and
+//  the type are extracted (no decoded fields, no Line Protocol Record).
+
+static  void  MrpReadJson (
+    tMrpChunk* pChunk_p)
+{
+
+const tMrpFile*  pFile;
+std::string      strBuffer;
+std::string      strMore;
+tJsonMessage     JsonMessage;
+uint64_t         ui64BuffStart;
+size_t           nRangeEnd;
+size_t           nPos;
+size_t           nRecEnd;
+size_t           nLast;
+size_t           nKey;
+long             lDevID;
+long long        llTimeStamp;
+bool             fTimeStamp;
+
+
+    pFile = &vecFiles_l[pChunk_p->m_uiFile];
+    ui64BuffStart = pChunk_p->m_fAtRecStart ? pChunk_p->m_ui64Offset : (pChunk_p->m_ui64Offset - 2);
+    if ( !MrpReadRange(pFile->m_iFd, ui64BuffStart, (size_t)(pChunk_p->m_ui64Offset + pChunk_p->m_ui64Length - ui64BuffStart), &strBuffer) )
+    {
+        pChunk_p->m_uiDamaged++;
+        return;
+    }
+    nPos      = (size_t)(pChunk_p->m_ui64Offset - ui64BuffStart);
+    nRangeEnd = nPos + (size_t)pChunk_p->m_ui64Length;
+
+    if ( !pChunk_p->m_fAtRecStart )
+    {
+        while ((nPos < nRangeEnd) && !((strBuffer[nPos-1] == '\n') && (strBuffer[nPos-2] == '\n') && (strBuffer[nPos] != '\n')))
+        {
+            nPos++;
+        }
+    }
+
+    while (nPos < nRangeEnd)
+    {
+        // skip additional empty lines
+        if ((strBuffer[nPos] == '\n') || (strBuffer[nPos] == '\r'))
+        {
+            nPos++;
+            continue;
+        }
+
+        // find end of record, read on if it crosses the end of the chunk
+        nRecEnd = strBuffer.find(JSON_REC_DELIMITER, nPos);
+        while ((nRecEnd == std::string::npos) && ((ui64BuffStart + strBuffer.length()) < pFile->m_ui64DataEnd))
+        {
+            if ( !MrpReadRange(pFile->m_iFd, ui64BuffStart + strBuffer.length(),
+                               (size_t)std::min((uint64_t)MRP_JSON_READ_AHEAD, pFile->m_ui64DataEnd - (ui64BuffStart + strBuffer.length())), &strMore) )
+            {
+                break;
+            }
+            strBuffer += strMore;
+            nRecEnd = strBuffer.find(JSON_REC_DELIMITER, std::max(nPos, strBuffer.length() - strMore.length() - 1));
+        }
+        if (nRecEnd == std::string::npos)
+        {
+            nRecEnd = strBuffer.length();
+        }
+        pChunk_p->m_uiRecords++;
+
+        lDevID = -1;
+        nKey = strBuffer.find(JSON_KEY_DEVID, nPos);
+        if ((nKey != std::string::npos) && (nKey < nRecEnd))
+        {
+            lDevID = strtol(strBuffer.c_str() + nKey + sizeof(JSON_KEY_DEVID)-1, NULL, 10);
+        }
+        llTimeStamp = 0;
+        nKey = strBuffer.find(JSON_KEY_TIMESTAMP, nPos);
+        fTimeStamp = ((nKey != std::string::npos) && (nKey < nRecEnd));
+        if ( fTimeStamp )
+        {
+            llTimeStamp = strtoll(strBuffer.c_str() + nKey + sizeof(JSON_KEY_TIMESTAMP)-1, NULL, 10);
+        }
+
+        nLast = nRecEnd - 1;
+        while ((nLast > nPos) && ((strBuffer[nLast] == '\n') || (strBuffer[nLast] == '\r') || (strBuffer[nLast] == ' ')))
+        {
+            nLast--;
+        }
+
+        if ((lDevID < 0) || (lDevID >= LORA_DEVICES) || !fTimeStamp || (strBuffer[nLast] != '}'))
+        {
+            pChunk_p->m_uiDamaged++;
+        }
+        else if ((llTimeStamp >= Config_l.m_i64FromTime) && (llTimeStamp <= Config_l.m_i64ToTime))
+        {
+            memset(&JsonMessage.m_RecordFields, 0, sizeof(JsonMessage.m_RecordFields));
+            JsonMessage.m_uiMsgID = 0;
+            nKey = strBuffer.find(JSON_KEY_MSGID, nPos);
+            if ((nKey != std::string::npos) && (nKey < nRecEnd))
+            {
+                JsonMessage.m_uiMsgID = (uint)strtoul(strBuffer.c_str() + nKey + sizeof(JSON_KEY_MSGID)-1, NULL, 10);
+            }
+            nKey = strBuffer.find(JSON_KEY_DATA_REC, nPos);
+            JsonMessage.m_PacketType  = ((nKey != std::string::npos) && (nKey < nRecEnd)) ? kLoraPacketDataGenN : kLoraPacketBootup;
+            JsonMessage.m_ui8DevID    = (uint8_t)lDevID;
+            JsonMessage.m_ui32SequNum = 0;
+            JsonMessage.m_i8Rssi      = 0;
+            JsonMessage.m_tmTimeStamp = (time_t)llTimeStamp;
+            JsonMessage.m_strJsonRecord.assign(strBuffer, nPos, nLast + 1 - nPos);
+            JsonMessage.m_strLineRecord.clear();
+            JsonMessage.m_RecordFields.m_uiMsgID     = JsonMessage.m_uiMsgID;
+            JsonMessage.m_RecordFields.m_PacketType  = JsonMessage.m_PacketType;
+            JsonMessage.m_RecordFields.m_tmTimeStamp = JsonMessage.m_tmTimeStamp;
+            JsonMessage.m_RecordFields.m_ui8DevID    = JsonMessage.m_ui8DevID;
+
+            pChunk_p->m_vecMessages.push_back(JsonMessage);
+            pChunk_p->m_vecRecEnd.push_back(ui64BuffStart + nRecEnd);
+        }
+
+        pChunk_p->m_ui64ResumeOffset = ui64BuffStart + nRecEnd;
+        nPos = nRecEnd;
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Publisher Thread: hand over Chunks in File Order to the Sink
+//---------------------------------------------------------------------------
+
+static  void  MrpPublisherThread (void)
+{
+
+std::vector<tJsonMessage>  vecMessages;
+std::vector<uint64_t>      vecRecEnd;
+tMrpChunk*     pChunk;
+tMrpPending    Pending;
+uint64_t       ui64Submitted;
+uint64_t       ui64ResumeOffset;
+double         dTokens;
+int64_t        i64TokenTime;
+size_t         nIdx;
+uint           uiFile;
+
+
+    MrpLowerPriority();
+
+    ui64Submitted   = 0;
+    dTokens         = (double)Config_l.m_uiBurst;
+    i64TokenTime    = MrpGetTimeUs();
+
+    while ( !fStop_l )
+    {
+        // wait for next chunk in file order
+        {
+            std::unique_lock<std::mutex>  Lock(Mutex_l);
+            if (nPublishChunk_l >= vecChunks_l.size())
+            {
+                break;
+            }
+            pChunk = &vecChunks_l[nPublishChunk_l];
+            if ( !pChunk->m_fDone )
+            {
+                CondChunkDone_l.wait_for(Lock, std::chrono::milliseconds(MRP_POLL_INTERVAL));
+                Lock.unlock();
+                MrpUpdateCheckpoint(false);
+                continue;
+            }
+            vecMessages.swap(pChunk->m_vecMessages);
+            vecRecEnd.swap(pChunk->m_vecRecEnd);
+            uiFile           = pChunk->m_uiFile;
+            ui64ResumeOffset = pChunk->m_ui64ResumeOffset;
+
+            Statistics_l.m_ui64Records   += pChunk->m_uiRecords;
+            Statistics_l.m_ui64Damaged   += pChunk->m_uiDamaged;
+            Statistics_l.m_ui64Matches   += vecMessages.size();
+            Statistics_l.m_ui64BytesRead += pChunk->m_ui64Length;
+        }
+
+        for (nIdx=0; (nIdx<vecMessages.size()) && !fStop_l; nIdx++)
+        {
+            if ( !MrpSubmitMessage(&vecMessages[nIdx], &dTokens, &i64TokenTime) )
+            {
+                break;
+            }
+            ui64Submitted++;
+            Pending.m_ui64Seq    = ui64Submitted;
+            Pending.m_uiFile     = uiFile;
+            Pending.m_ui64Offset = vecRecEnd[nIdx];
+            deqPending_l.push_back(Pending);
+            {
+                std::lock_guard<std::mutex>  Lock(Mutex_l);
+                Statistics_l.m_ui64Submitted = ui64Submitted;
+            }
+            MrpUpdateCheckpoint(false);
+        }
+        if (nIdx < vecMessages.size())
+        {
+            break;                                      // stopped, the rest is re-published by the next run
+        }
+
+        // records behind the last message (e.g. out of time range) are done as well
+        if (ui64ResumeOffset != 0)
+        {
+            Pending.m_ui64Seq    = ui64Submitted;
+            Pending.m_uiFile     = uiFile;
+            Pending.m_ui64Offset = ui64ResumeOffset;
+            deqPending_l.push_back(Pending);
+        }
+        vecMessages.clear();
+        vecRecEnd.clear();
+
+        {
+            std::lock_guard<std::mutex>  Lock(Mutex_l);
+            nPublishChunk_l++;
+            Statistics_l.m_uiChunksDone = (uint)nPublishChunk_l;
+            CondWindow_l.notify_all();
+        }
+    }
+
+    // all chunks handed over: wait until the sink has handled them
+    while ( !fStop_l )
+    {
+        MrpUpdateCheckpoint(false);
+        if ( deqPending_l.empty() )
+        {
+            fCkptComplete_l = true;
+            fCkptChanged_l  = true;
+            MrpUpdateCheckpoint(true);
+            {
+                std::lock_guard<std::mutex>  Lock(Mutex_l);
+                i64DoneTime_l = MrpGetTimeUs();
+            }
+            fDone_l = true;
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(MRP_POLL_INTERVAL));
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Hand over Message to the Sink (Token Bucket)
+//---------------------------------------------------------------------------
+//  The bucket holds up to <m_uiBurst> tokens and is refilled with <m_uiRate>
+//  tokens per second, each message takes one token. Returns false on stop.
+
+static  bool  MrpSubmitMessage (
+    const tJsonMessage* pJsonMessage_p,
+    double* pdTokens_p,
+    int64_t* pi64TokenTime_p)
+{
+
+int64_t  i64Now;
+int64_t  i64Wait;
+int64_t  i64Start;
+int      iRes;
+
+
+    if (Config_l.m_uiRate > 0)
+    {
+        for (;;)
+        {
+            i64Now = MrpGetTimeUs();
+            *pdTokens_p = std::min((double)Config_l.m_uiBurst,
+                                   *pdTokens_p + ((double)(i64Now - *pi64TokenTime_p) * Config_l.m_uiRate / 1000000.0));
+            *pi64TokenTime_p = i64Now;
+            if (*pdTokens_p >= 1.0)
+            {
+                break;
+            }
+            if ( fStop_l )
+            {
+                return (false);
+            }
+            i64Wait = (int64_t)((1.0 - *pdTokens_p) * 1000000.0 / Config_l.m_uiRate) + 1;
+            i64Wait = std::min(i64Wait, (int64_t)MRP_POLL_INTERVAL * 1000);
+            std::this_thread::sleep_for(std::chrono::microseconds(i64Wait));
+            std::lock_guard<std::mutex>  Lock(Mutex_l);
+            Statistics_l.m_ui64ThrottledUs += (uint64_t)(MrpGetTimeUs() - i64Now);
+        }
+        *pdTokens_p -= 1.0;
+    }
+
+    // wait for free space in the backfill queue of the sink
+    i64Start = MrpGetTimeUs();
+    do
+    {
+        iRes = MskSubmit(Config_l.m_uiSink, pJsonMessage_p, MRP_SUBMIT_TIMEOUT);
+        if (iRes == -3)
+        {
+            MrpUpdateCheckpoint(false);
+        }
+    }
+    while ((iRes == -3) && !fStop_l);
+
+    i64Now = MrpGetTimeUs();
+    {
+        std::lock_guard<std::mutex>  Lock(Mutex_l);
+        Statistics_l.m_ui64BlockedUs += (uint64_t)(i64Now - i64Start);
+    }
+
+    return (iRes == 0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Read Range of File
+//---------------------------------------------------------------------------
+
+static  bool  MrpReadRange (
+    int iFd_p,
+    uint64_t ui64Offset_p,
+    size_t nLength_p,
+    std::string* pstrBuffer_p)
+{
+
+size_t   nRead;
+ssize_t  iRes;
+
+
+    pstrBuffer_p->resize(nLength_p);
+    nRead = 0;
+    while (nRead < nLength_p)
+    {
+        iRes = pread(iFd_p, &(*pstrBuffer_p)[nRead], nLength_p - nRead, (off_t)(ui64Offset_p + nRead));
+        if (iRes <= 0)
+        {
+            pstrBuffer_p->resize(nRead);
+            return (false);
+        }
+        nRead += (size_t)iRes;
+    }
+
+    return (true);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Lower CPU and I/O Priority of calling Thread
+//---------------------------------------------------------------------------
+
+static  void  MrpLowerPriority (void)
+{
+
+struct sched_param  SchedParam;
+
+
+    memset(&SchedParam, 0, sizeof(SchedParam));
+    if (pthread_setschedparam(pthread_self(), SCHED_IDLE, &SchedParam) != 0)
+    {
+        setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), 19);
+    }
+    syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, (IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT));
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get monotonic Time in [us]
+//---------------------------------------------------------------------------
+
+static  int64_t  MrpGetTimeUs (void)
+{
+
+    return ((int64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+
+}
+
+
+
+// EOF
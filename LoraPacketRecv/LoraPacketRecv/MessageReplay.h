@@ -0,0 +1,129 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Declarations for Re-Publishing of archived MessageFiles
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _MESSAGEREPLAY_H_
+#define _MESSAGEREPLAY_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+// Notice:  The replay reads MessageFiles written by MessageFileWriter (Json or
+//          binary, e.g. the rotated segments of an outage) and hands over the
+//          records of the selected time range to one Message Sink through its
+//          backfill queue (MskSubmit()). The sink only writes them if no live
+//          message is pending, so the receive path keeps priority.
+//
+//          The files are split into chunks that are read and decoded by
+//          several reader threads in parallel (SCHED_IDLE, I/O class idle),
+//          the chunks of all files are handed over strictly in file order by
+//          the publisher thread. It is paced by a token bucket (<m_uiRate>
+//          messages/s, bursts up to <m_uiBurst>).
+//
+//          The checkpoint file records the position behind the last record
+//          the sink has handled. A replay started again with the same files
+//          continues from there, a completed replay is not repeated (delete
+//          the checkpoint file to start over). Compressed segments ('.gz')
+//          have to be decompressed before.
+//---------------------------------------------------------------------------
+
+const  uint  MRP_DEF_RATE               = 100;          // [messages/s]
+const  uint  MRP_DEF_BURST              = 16;           // [messages]
+const  uint  MRP_DEF_THREADS            = 2;            // reader threads
+const  uint  MRP_CHUNK_RECORDS          = 1024;         // records per chunk of binary MessageLog
+const  uint  MRP_CHUNK_SIZE             = 256 * 1024;   // bytes per chunk of Json MessageFile
+const  uint  MRP_CHECKPOINT_INTERVAL    = 1000;         // [ms]
+const  char  MRP_CHECKPOINT_EXTENSION[] = ".ckpt";
+
+
+
+//---------------------------------------------------------------------------
+//  Type definitions
+//---------------------------------------------------------------------------
+
+typedef struct
+{
+    const char* const*  m_apszMsgFiles;             // MessageFiles in chronological order
+    uint                m_uiMsgFiles;
+    const char*         m_pszCheckpointFile;        // NULL = '<first MessageFile>.ckpt'
+    int64_t             m_i64FromTime;              // TimeStamp range of records to re-publish
+    int64_t             m_i64ToTime;
+    uint                m_uiRate;                   // [messages/s] (0 = unlimited)
+    uint                m_uiBurst;                  // [messages] (0 = MRP_DEF_BURST)
+    uint                m_uiThreads;                // reader threads (0 = MRP_DEF_THREADS)
+    uint                m_uiSink;                   // Message Sink (returned by MskAddSink())
+    bool                m_fBinaryOnly;              // sink needs decoded fields (Json MessageFiles only carry the Json Record)
+
+} tMrpConfig;
+
+
+typedef struct
+{
+    uint                m_uiFiles;
+    uint                m_uiChunks;                 // to read (behind checkpoint and matching index)
+    uint                m_uiChunksDone;             // handed over to the sink
+    uint64_t            m_ui64BytesTotal;
+    uint64_t            m_ui64BytesRead;
+    uint64_t            m_ui64Records;              // read
+    uint64_t            m_ui64Matches;              // in time range
+    uint64_t            m_ui64Damaged;              // skipped (torn or incompatible)
+    uint64_t            m_ui64Submitted;            // handed over to the sink
+    uint64_t            m_ui64Published;            // handled by the sink (this run)
+    uint64_t            m_ui64PublishedTotal;       // incl. previous runs (checkpoint)
+    uint64_t            m_ui64ThrottledUs;          // publisher waited for tokens
+    uint64_t            m_ui64BlockedUs;            // publisher waited for free space in the sink (live traffic, sink not ready)
+    double              m_dRunTime;                 // [sec] MrpStart() until done (or now)
+    double              m_dThroughput;              // [messages/s] published
+    bool                m_fDone;
+
+} tMrpStatistics;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of public functions
+//---------------------------------------------------------------------------
+
+int  MrpOpen (
+    const tMrpConfig* pConfig_p);                       // [IN]     Ptr to Replay Configuration
+
+int  MrpStart (void);
+
+int  MrpStop (void);
+
+int  MrpClose (void);
+
+bool  MrpIsDone (void);
+
+int  MrpGetStatistics (
+    tMrpStatistics* pStatistics_p);                     // [OUT]    Ptr to Statistics
+
+void  MrpPrintStatistics (void);
+
+bool  MrpParseTime (
+    const char* pszTime_p,                              // [IN]     Seconds since 1970 or 'YYYY/MM/DD[-hh:mm[:ss]]'
+    bool fEndOfDay_p,                                   // [IN]     Date only: end of day instead of begin
+    int64_t* pi64Time_p);                               // [OUT]    Linux Standard Time
+
+
+
+#endif  // #ifndef _MESSAGEREPLAY_H_
+
+
+// EOF
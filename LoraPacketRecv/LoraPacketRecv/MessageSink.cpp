@@ -0,0 +1,988 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Implementation of Fan-Out of Json Messages to Message Sinks
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Backfill Queue for re-published Messages (lower priority)
+
+****************************************************************************/
+
+
+#include <RH_RF95.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "LoraPacket.h"
+#include "LoraPacketSchema.h"
+#include "LoraPayloadDecoder.h"
+#include "PacketProcessing.h"
+#include "MessageSink.h"
+#include "Trace.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+#define MSK_IDLE_WAIT_TIME      1000                    // [ms] worker of a sink without service function
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+//  All sinks share the same copy of a message, it is released by the last one
+typedef std::shared_ptr<const tJsonMessage>  tMskMessageRef;
+
+
+typedef struct
+{
+    tMskMessageRef          m_pJsonMessage;
+    int64_t                 m_i64QueueTime;         // [us] MskGetTimeUs() of MskDispatch()
+
+} tMskEntry;
+
+
+typedef struct
+{
+    tMskSinkCfg             m_Cfg;
+    std::thread             m_WorkerThread;
+
+    std::mutex              m_Mutex;                // protects all following members
+    std::condition_variable m_CondData;             // worker waits for messages
+    std::condition_variable m_CondSpace;            // MskDispatch() (kMskOverflowBlock) and MskSubmit() wait for free space
+    std::vector<tMskEntry>  m_vecQueue;             // ring buffer of <m_Cfg.m_uiQueueSize> entries
+    uint                    m_uiQueueHead;          // index of oldest entry
+    uint                    m_uiQueueLen;
+    uint                    m_uiBatchLen;           // messages taken by worker, but not handled yet
+    int64_t                 m_i64BatchQueueTime;    // queue time of oldest message of batch
+    std::deque<tMskEntry>   m_deqBackfill;          // up to <m_Cfg.m_uiBackfillSize> entries
+    bool                    m_fWorkerWaiting;
+    uint                    m_uiDispatchWaiting;
+    bool                    m_fStop;
+    int64_t                 m_i64DrainDeadline;     // [us] pending messages are dropped afterwards
+
+    uint64_t                m_ui64Queued;
+    uint64_t                m_ui64Written;
+    uint64_t                m_ui64Failed;
+    uint64_t                m_ui64Dropped;
+    uint64_t                m_ui64Batches;
+    uint64_t                m_ui64Retries;
+    uint                    m_uiMaxQueueLen;
+    uint64_t                m_ui64SumLatencyUs;
+    uint64_t                m_ui64MaxLatencyUs;
+    uint64_t                m_ui64BlockedUs;
+    uint64_t                m_ui64Backfilled;
+
+} tMskSink;
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+static  tMskSink                aSink_l[MSK_MAX_SINKS];
+static  uint                    uiSinkCount_l       = 0;
+static  bool                    fRunning_l          = false;
+static  int64_t                 i64StartTime_l      = 0;        // [us] MskStart()
+static  int64_t                 i64StopTime_l       = 0;        // [us] MskStop() (0 = running)
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  bool  MskEnqueue (
+    tMskSink* pSink_p,
+    const tMskMessageRef& pJsonMessage_p,
+    int64_t i64Now_p);
+
+static  void  MskWorkerThread (
+    tMskSink* pSink_p);
+
+static  void  MskWaitForBatch (
+    tMskSink* pSink_p,
+    std::unique_lock<std::mutex>& Lock_p,
+    int64_t i64NextService_p);
+
+static  void  MskTakeBatch (
+    tMskSink* pSink_p,
+    std::vector<tMskEntry>* pvecBatch_p,
+    bool* pfBackfill_p);
+
+static  void  MskDropPending (
+    tMskSink* pSink_p,
+    std::vector<tMskEntry>* pvecBatch_p);
+
+static  void  MskWaitUntil (
+    std::condition_variable& Cond_p,
+    std::unique_lock<std::mutex>& Lock_p,
+    int64_t i64Time_p);
+
+static  int64_t  MskGetTimeUs (void);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Add Sink (before MskStart())
+//---------------------------------------------------------------------------
+
+int  MskAddSink (
+    const tMskSinkCfg* pSinkCfg_p)                      // [IN]     Ptr to Sink Configuration
+{
+
+tMskSink*  pSink;
+
+
+    if ((pSinkCfg_p == NULL) || (pSinkCfg_p->m_pfnWrite == NULL))
+    {
+        return (-1);
+    }
+    if ( fRunning_l )
+    {
+        return (-2);
+    }
+    if (uiSinkCount_l >= MSK_MAX_SINKS)
+    {
+        return (-3);
+    }
+
+    pSink = &aSink_l[uiSinkCount_l];
+    pSink->m_Cfg = *pSinkCfg_p;
+    if (pSink->m_Cfg.m_pszName == NULL)
+    {
+        pSink->m_Cfg.m_pszName = "Sink";
+    }
+    if (pSink->m_Cfg.m_uiQueueSize == 0)
+    {
+        pSink->m_Cfg.m_uiQueueSize = MSK_DEF_QUEUE_SIZE;
+    }
+    if (pSink->m_Cfg.m_uiMaxBatch == 0)
+    {
+        pSink->m_Cfg.m_uiMaxBatch = MSK_DEF_MAX_BATCH;
+    }
+    if (pSink->m_Cfg.m_uiServiceInterval == 0)
+    {
+        pSink->m_Cfg.m_uiServiceInterval = MSK_IDLE_WAIT_TIME;
+    }
+    if (pSink->m_Cfg.m_pfnWriteBackfill == NULL)
+    {
+        pSink->m_Cfg.m_pfnWriteBackfill = pSink->m_Cfg.m_pfnWrite;
+    }
+    if (pSink->m_Cfg.m_uiBackfillSize == 0)
+    {
+        pSink->m_Cfg.m_uiBackfillSize = MSK_DEF_BACKFILL_SIZE;
+    }
+
+    pSink->m_vecQueue.clear();
+    pSink->m_vecQueue.resize(pSink->m_Cfg.m_uiQueueSize);
+    pSink->m_uiQueueHead        = 0;
+    pSink->m_uiQueueLen         = 0;
+    pSink->m_uiBatchLen         = 0;
+    pSink->m_i64BatchQueueTime  = 0;
+    pSink->m_deqBackfill.clear();
+    pSink->m_fWorkerWaiting     = false;
+    pSink->m_uiDispatchWaiting  = 0;
+    pSink->m_fStop              = false;
+    pSink->m_i64DrainDeadline   = 0;
+    pSink->m_ui64Queued         = 0;
+    pSink->m_ui64Written        = 0;
+    pSink->m_ui64Failed         = 0;
+    pSink->m_ui64Dropped        = 0;
+    pSink->m_ui64Batches        = 0;
+    pSink->m_ui64Retries        = 0;
+    pSink->m_uiMaxQueueLen      = 0;
+    pSink->m_ui64SumLatencyUs   = 0;
+    pSink->m_ui64MaxLatencyUs   = 0;
+    pSink->m_ui64BlockedUs      = 0;
+    pSink->m_ui64Backfilled     = 0;
+
+    TRACE3("\nMskAddSink: Name='%s', QueueSize=%u -> Sink=%u\n", pSink->m_Cfg.m_pszName, pSink->m_Cfg.m_uiQueueSize, uiSinkCount_l);
+
+    return ((int)uiSinkCount_l++);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Start Worker Threads of all Sinks
+//---------------------------------------------------------------------------
+
+int  MskStart (void)
+{
+
+uint  uiSink;
+
+
+    if ( fRunning_l )
+    {
+        return (-1);
+    }
+
+    i64StartTime_l = MskGetTimeUs();
+    i64StopTime_l  = 0;
+    fRunning_l     = true;
+
+    for (uiSink=0; uiSink<uiSinkCount_l; uiSink++)
+    {
+        aSink_l[uiSink].m_WorkerThread = std::thread(MskWorkerThread, &aSink_l[uiSink]);
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Stop Worker Threads of all Sinks
+//---------------------------------------------------------------------------
+//  The workers write the pending messages until <uiDrainTimeout_p> has
+//  elapsed, messages still pending afterwards (e.g. broker not reachable)
+//  are counted as dropped.
+
+int  MskStop (
+    uint uiDrainTimeout_p)                              // [IN]     Max. Time to write pending Messages [ms]
+{
+
+int64_t  i64Deadline;
+uint     uiSink;
+
+
+    if ( !fRunning_l )
+    {
+        return (-1);
+    }
+
+    i64Deadline = MskGetTimeUs() + ((int64_t)uiDrainTimeout_p * 1000);
+    for (uiSink=0; uiSink<uiSinkCount_l; uiSink++)
+    {
+        std::lock_guard<std::mutex>  Lock(aSink_l[uiSink].m_Mutex);
+        aSink_l[uiSink].m_fStop = true;
+        aSink_l[uiSink].m_i64DrainDeadline = i64Deadline;
+        aSink_l[uiSink].m_CondData.notify_all();
+        aSink_l[uiSink].m_CondSpace.notify_all();
+    }
+
+    for (uiSink=0; uiSink<uiSinkCount_l; uiSink++)
+    {
+        if ( aSink_l[uiSink].m_WorkerThread.joinable() )
+        {
+            aSink_l[uiSink].m_WorkerThread.join();
+        }
+    }
+
+    i64StopTime_l = MskGetTimeUs();
+    fRunning_l    = false;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Hand over Json Message to all Sinks
+//---------------------------------------------------------------------------
+//  The message is copied once, each sink only gets a reference to the copy.
+//  Returns the number of sinks that had to drop a message.
+
+uint  MskDispatch (
+    const tJsonMessage* pJsonMessage_p)                 // [IN]     Json Message (Bootup or Data Record)
+{
+
+tMskMessageRef  pJsonMessage;
+int64_t         i64Now;
+uint            uiDropped;
+uint            uiSink;
+
+
+    if ((pJsonMessage_p == NULL) || !fRunning_l || (uiSinkCount_l == 0))
+    {
+        return (0);
+    }
+
+    pJsonMessage = std::make_shared<const tJsonMessage>(*pJsonMessage_p);
+    i64Now = MskGetTimeUs();
+
+    uiDropped = 0;
+    for (uiSink=0; uiSink<uiSinkCount_l; uiSink++)
+    {
+        if ( !MskEnqueue(&aSink_l[uiSink], pJsonMessage, i64Now) )
+        {
+            uiDropped++;
+        }
+    }
+
+    return (uiDropped);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Hand over re-published Json Message to Backfill Queue of one Sink
+//---------------------------------------------------------------------------
+//  Blocks up to <uiTimeout_p> until there is space in the backfill queue
+//  (the worker only takes backfill messages if no live message is pending).
+//  Returns 0 if the message was queued, -3 on timeout, -2 after MskStop().
+
+int  MskSubmit (
+    uint uiSink_p,                                      // [IN]     Sink (returned by MskAddSink())
+    const tJsonMessage* pJsonMessage_p,                 // [IN]     Json Message to re-publish
+    uint uiTimeout_p)                                   // [IN]     Max. Time to wait for free space [ms]
+{
+
+tMskSink*       pSink;
+tMskMessageRef  pJsonMessage;
+int64_t         i64Deadline;
+
+
+    if ((uiSink_p >= uiSinkCount_l) || (pJsonMessage_p == NULL) || !fRunning_l)
+    {
+        return (-1);
+    }
+
+    pSink = &aSink_l[uiSink_p];
+    pJsonMessage = std::make_shared<const tJsonMessage>(*pJsonMessage_p);
+    i64Deadline = MskGetTimeUs() + ((int64_t)uiTimeout_p * 1000);
+
+    std::unique_lock<std::mutex>  Lock(pSink->m_Mutex);
+
+    pSink->m_uiDispatchWaiting++;
+    while ((pSink->m_deqBackfill.size() >= pSink->m_Cfg.m_uiBackfillSize) && !pSink->m_fStop &&
+           (MskGetTimeUs() < i64Deadline))
+    {
+        MskWaitUntil(pSink->m_CondSpace, Lock, i64Deadline);
+    }
+    pSink->m_uiDispatchWaiting--;
+    if ( pSink->m_fStop )
+    {
+        return (-2);
+    }
+    if (pSink->m_deqBackfill.size() >= pSink->m_Cfg.m_uiBackfillSize)
+    {
+        return (-3);
+    }
+
+    pSink->m_deqBackfill.push_back(tMskEntry());
+    pSink->m_deqBackfill.back().m_pJsonMessage = std::move(pJsonMessage);
+    pSink->m_deqBackfill.back().m_i64QueueTime = MskGetTimeUs();
+
+    if ( pSink->m_fWorkerWaiting && (pSink->m_deqBackfill.size() == 1) )
+    {
+        pSink->m_CondData.notify_one();
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Number of Sinks
+//---------------------------------------------------------------------------
+
+uint  MskGetSinkCount (void)
+{
+
+    return (uiSinkCount_l);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Find Sink by Name
+//---------------------------------------------------------------------------
+
+int  MskFindSink (
+    const char* pszName_p)                              // [IN]     Name of Sink
+{
+
+uint  uiSink;
+
+
+    if (pszName_p == NULL)
+    {
+        return (-1);
+    }
+
+    for (uiSink=0; uiSink<uiSinkCount_l; uiSink++)
+    {
+        if (strcasecmp(aSink_l[uiSink].m_Cfg.m_pszName, pszName_p) == 0)
+        {
+            return ((int)uiSink);
+        }
+    }
+
+    return (-1);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Statistics of a Sink
+//---------------------------------------------------------------------------
+
+int  MskGetStatistics (
+    uint uiSink_p,                                      // [IN]     Sink (returned by MskAddSink())
+    tMskStatistics* pStatistics_p)                      // [OUT]    Ptr to Statistics
+{
+
+tMskSink*  pSink;
+int64_t    i64Now;
+int64_t    i64Oldest;
+int64_t    i64RunTime;
+uint64_t   ui64Handled;
+
+
+    if ((uiSink_p >= uiSinkCount_l) || (pStatistics_p == NULL))
+    {
+        return (-1);
+    }
+
+    pSink  = &aSink_l[uiSink_p];
+    i64Now = MskGetTimeUs();
+    memset(pStatistics_p, 0, sizeof(tMskStatistics));
+
+    std::lock_guard<std::mutex>  Lock(pSink->m_Mutex);
+
+    pStatistics_p->m_pszName          = pSink->m_Cfg.m_pszName;
+    pStatistics_p->m_ui64Queued       = pSink->m_ui64Queued;
+    pStatistics_p->m_ui64Written      = pSink->m_ui64Written;
+    pStatistics_p->m_ui64Failed       = pSink->m_ui64Failed;
+    pStatistics_p->m_ui64Dropped      = pSink->m_ui64Dropped;
+    pStatistics_p->m_ui64Batches      = pSink->m_ui64Batches;
+    pStatistics_p->m_ui64Retries      = pSink->m_ui64Retries;
+    pStatistics_p->m_uiQueueLen       = pSink->m_uiQueueLen + pSink->m_uiBatchLen;
+    pStatistics_p->m_uiMaxQueueLen    = pSink->m_uiMaxQueueLen;
+    pStatistics_p->m_uiQueueSize      = pSink->m_Cfg.m_uiQueueSize;
+    pStatistics_p->m_ui64MaxLatencyUs = pSink->m_ui64MaxLatencyUs;
+    pStatistics_p->m_ui64BlockedUs    = pSink->m_ui64BlockedUs;
+    pStatistics_p->m_ui64Backfilled   = pSink->m_ui64Backfilled;
+    pStatistics_p->m_uiBackfillLen    = (uint)pSink->m_deqBackfill.size();
+
+    // lag: the batch in progress is older than everything still queued
+    i64Oldest = 0;
+    if (pSink->m_uiBatchLen > 0)
+    {
+        i64Oldest = pSink->m_i64BatchQueueTime;
+    }
+    else if (pSink->m_uiQueueLen > 0)
+    {
+        i64Oldest = pSink->m_vecQueue[pSink->m_uiQueueHead].m_i64QueueTime;
+    }
+    if ((i64Oldest != 0) && (i64Now > i64Oldest))
+    {
+        pStatistics_p->m_ui64LagUs = (uint64_t)(i64Now - i64Oldest);
+    }
+
+    ui64Handled = pSink->m_ui64Written + pSink->m_ui64Failed;
+    if (ui64Handled > 0)
+    {
+        pStatistics_p->m_ui64AvgLatencyUs = pSink->m_ui64SumLatencyUs / ui64Handled;
+    }
+    i64RunTime = ((i64StopTime_l != 0) ? i64StopTime_l : i64Now) - i64StartTime_l;
+    if ((i64StartTime_l != 0) && (i64RunTime > 0))
+    {
+        pStatistics_p->m_dThroughput = (double)ui64Handled * 1000000.0 / (double)i64RunTime;
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Print Statistics of all Sinks
+//---------------------------------------------------------------------------
+
+void  MskPrintStatistics (void)
+{
+
+tMskStatistics  Statistics;
+uint            uiSink;
+
+
+    printf("Message Sinks:\n");
+    for (uiSink=0; uiSink<uiSinkCount_l; uiSink++)
+    {
+        MskGetStatistics(uiSink, &Statistics);
+        printf("  %-8s Messages  = %llu queued, %llu written, %llu failed, %llu dropped\n",
+               Statistics.m_pszName, (unsigned long long)Statistics.m_ui64Queued, (unsigned long long)Statistics.m_ui64Written,
+               (unsigned long long)Statistics.m_ui64Failed, (unsigned long long)Statistics.m_ui64Dropped);
+        printf("  %-8s Queue     = %u pending, %u max, %u size (lag: %.1f ms, blocked: %.1f ms)\n", "",
+               Statistics.m_uiQueueLen, Statistics.m_uiMaxQueueLen, Statistics.m_uiQueueSize,
+               (double)Statistics.m_ui64LagUs / 1000.0, (double)Statistics.m_ui64BlockedUs / 1000.0);
+        printf("  %-8s Latency   = %.1f ms avg, %.1f ms max (%llu batches, %llu retries, %.1f messages/s)\n", "",
+               (double)Statistics.m_ui64AvgLatencyUs / 1000.0, (double)Statistics.m_ui64MaxLatencyUs / 1000.0,
+               (unsigned long long)Statistics.m_ui64Batches, (unsigned long long)Statistics.m_ui64Retries,
+               Statistics.m_dThroughput);
+        if ((Statistics.m_ui64Backfilled > 0) || (Statistics.m_uiBackfillLen > 0))
+        {
+            printf("  %-8s Backfill  = %llu handled, %u pending\n", "",
+                   (unsigned long long)Statistics.m_ui64Backfilled, Statistics.m_uiBackfillLen);
+        }
+    }
+
+    return;
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Append Message to Queue of a Sink
+//---------------------------------------------------------------------------
+
+static  bool  MskEnqueue (
+    tMskSink* pSink_p,
+    const tMskMessageRef& pJsonMessage_p,
+    int64_t i64Now_p)
+{
+
+std::unique_lock<std::mutex>  Lock(pSink_p->m_Mutex);
+tMskEntry*  pEntry;
+int64_t     i64Deadline;
+int64_t     i64Blocked;
+bool        fDropped;
+
+
+    pSink_p->m_ui64Queued++;
+    fDropped = false;
+
+    if (pSink_p->m_uiQueueLen >= pSink_p->m_Cfg.m_uiQueueSize)
+    {
+        switch (pSink_p->m_Cfg.m_OverflowPolicy)
+        {
+            case kMskOverflowDropOldest:
+            {
+                pSink_p->m_vecQueue[pSink_p->m_uiQueueHead].m_pJsonMessage.reset();
+                pSink_p->m_uiQueueHead = (pSink_p->m_uiQueueHead + 1) % pSink_p->m_Cfg.m_uiQueueSize;
+                pSink_p->m_uiQueueLen--;
+                pSink_p->m_ui64Dropped++;
+                fDropped = true;
+                break;
+            }
+
+            case kMskOverflowBlock:
+            {
+                i64Deadline = i64Now_p + ((int64_t)pSink_p->m_Cfg.m_uiBlockTimeout * 1000);
+                pSink_p->m_uiDispatchWaiting++;
+                while ((pSink_p->m_uiQueueLen >= pSink_p->m_Cfg.m_uiQueueSize) && !pSink_p->m_fStop &&
+                       (MskGetTimeUs() < i64Deadline))
+                {
+                    MskWaitUntil(pSink_p->m_CondSpace, Lock, i64Deadline);
+                }
+                pSink_p->m_uiDispatchWaiting--;
+                i64Blocked = MskGetTimeUs() - i64Now_p;
+                pSink_p->m_ui64BlockedUs += (uint64_t)((i64Blocked > 0) ? i64Blocked : 0);
+                if (pSink_p->m_uiQueueLen < pSink_p->m_Cfg.m_uiQueueSize)
+                {
+                    break;
+                }
+                pSink_p->m_ui64Dropped++;
+                return (false);
+            }
+
+            case kMskOverflowDropNewest:
+            default:
+            {
+                pSink_p->m_ui64Dropped++;
+                return (false);
+            }
+        }
+    }
+
+    pEntry = &pSink_p->m_vecQueue[(pSink_p->m_uiQueueHead + pSink_p->m_uiQueueLen) % pSink_p->m_Cfg.m_uiQueueSize];
+    pEntry->m_pJsonMessage = pJsonMessage_p;
+    pEntry->m_i64QueueTime = i64Now_p;
+    pSink_p->m_uiQueueLen++;
+    if (pSink_p->m_uiQueueLen > pSink_p->m_uiMaxQueueLen)
+    {
+        pSink_p->m_uiMaxQueueLen = pSink_p->m_uiQueueLen;
+    }
+
+    // wake up worker only if it waits for the first message or for a full batch
+    if ( pSink_p->m_fWorkerWaiting &&
+         ((pSink_p->m_uiQueueLen == 1) || (pSink_p->m_uiQueueLen >= pSink_p->m_Cfg.m_uiMaxBatch)) )
+    {
+        pSink_p->m_CondData.notify_one();
+    }
+
+    return ( !fDropped );
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Worker Thread of a Sink
+//---------------------------------------------------------------------------
+
+static  void  MskWorkerThread (
+    tMskSink* pSink_p)
+{
+
+std::vector<tMskEntry>            vecBatch;
+std::vector<const tJsonMessage*>  vecMessages;
+int64_t  i64NextService;
+int64_t  i64Now;
+int64_t  i64Latency;
+uint     uiHandled;
+uint     uiFailed;
+uint     uiIdx;
+bool     fBackfill;
+
+
+    vecBatch.reserve(pSink_p->m_Cfg.m_uiMaxBatch);
+    vecMessages.reserve(pSink_p->m_Cfg.m_uiMaxBatch);
+    i64NextService = MskGetTimeUs() + ((int64_t)pSink_p->m_Cfg.m_uiServiceInterval * 1000);
+    fBackfill = false;
+
+    for (;;)
+    {
+        // get next batch (a batch the sink wasn't ready for is passed again)
+        if ( vecBatch.empty() )
+        {
+            std::unique_lock<std::mutex>  Lock(pSink_p->m_Mutex);
+            MskWaitForBatch(pSink_p, Lock, (pSink_p->m_Cfg.m_pfnService != NULL) ? i64NextService : INT64_MAX);
+            if ( pSink_p->m_fStop )
+            {
+                if ((pSink_p->m_uiQueueLen == 0) || (MskGetTimeUs() >= pSink_p->m_i64DrainDeadline))
+                {
+                    MskDropPending(pSink_p, &vecBatch);
+                    break;
+                }
+            }
+            MskTakeBatch(pSink_p, &vecBatch, &fBackfill);
+        }
+
+        i64Now = MskGetTimeUs();
+        if ((pSink_p->m_Cfg.m_pfnService != NULL) && (i64Now >= i64NextService))
+        {
+            pSink_p->m_Cfg.m_pfnService(pSink_p->m_Cfg.m_pArg);
+            i64NextService = i64Now + ((int64_t)pSink_p->m_Cfg.m_uiServiceInterval * 1000);
+        }
+        if ( vecBatch.empty() )
+        {
+            continue;
+        }
+
+        vecMessages.clear();
+        for (uiIdx=0; uiIdx<vecBatch.size(); uiIdx++)
+        {
+            vecMessages.push_back(vecBatch[uiIdx].m_pJsonMessage.get());
+        }
+        uiFailed  = 0;
+        if ( !fBackfill )
+        {
+            uiHandled = pSink_p->m_Cfg.m_pfnWrite(vecMessages.data(), (uint)vecMessages.size(), &uiFailed, pSink_p->m_Cfg.m_pArg);
+        }
+        else
+        {
+            uiHandled = pSink_p->m_Cfg.m_pfnWriteBackfill(vecMessages.data(), (uint)vecMessages.size(), &uiFailed, pSink_p->m_Cfg.m_pArg);
+        }
+        if (uiHandled > vecMessages.size())
+        {
+            uiHandled = (uint)vecMessages.size();
+        }
+        if (uiFailed > uiHandled)
+        {
+            uiFailed = uiHandled;
+        }
+
+        i64Now = MskGetTimeUs();
+        {
+            std::unique_lock<std::mutex>  Lock(pSink_p->m_Mutex);
+
+            // backfill messages are kept out of the live statistics
+            if ( fBackfill )
+            {
+                pSink_p->m_ui64Backfilled += uiHandled;
+                vecBatch.erase(vecBatch.begin(), vecBatch.begin() + uiHandled);
+
+                // a replay is resumed from its checkpoint, so don't retry at stop
+                if ( pSink_p->m_fStop )
+                {
+                    vecBatch.clear();
+                }
+            }
+            else
+            {
+                pSink_p->m_ui64Written += uiHandled - uiFailed;
+                pSink_p->m_ui64Failed  += uiFailed;
+                pSink_p->m_ui64Batches++;
+                for (uiIdx=0; uiIdx<uiHandled; uiIdx++)
+                {
+                    i64Latency = i64Now - vecBatch[uiIdx].m_i64QueueTime;
+                    pSink_p->m_ui64SumLatencyUs += (uint64_t)i64Latency;
+                    if ((uint64_t)i64Latency > pSink_p->m_ui64MaxLatencyUs)
+                    {
+                        pSink_p->m_ui64MaxLatencyUs = (uint64_t)i64Latency;
+                    }
+                }
+                vecBatch.erase(vecBatch.begin(), vecBatch.begin() + uiHandled);
+                pSink_p->m_uiBatchLen = (uint)vecBatch.size();
+                if ( !vecBatch.empty() )
+                {
+                    pSink_p->m_i64BatchQueueTime = vecBatch[0].m_i64QueueTime;
+                }
+            }
+
+            // sink not ready: retry after a delay, the service function is
+            // called before (e.g. reconnect), new messages are still queued
+            if ( !vecBatch.empty() )
+            {
+                pSink_p->m_ui64Retries++;
+                if (pSink_p->m_fStop && (i64Now >= pSink_p->m_i64DrainDeadline))
+                {
+                    MskDropPending(pSink_p, &vecBatch);
+                    break;
+                }
+                MskWaitUntil(pSink_p->m_CondData, Lock,
+                             pSink_p->m_fStop ? std::min(i64Now + ((int64_t)pSink_p->m_Cfg.m_uiRetryDelay * 1000), pSink_p->m_i64DrainDeadline)
+                                              : i64Now + ((int64_t)pSink_p->m_Cfg.m_uiRetryDelay * 1000));
+                i64NextService = 0;
+            }
+        }
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Wait until a Batch is to be written (Worker Thread, locked)
+//---------------------------------------------------------------------------
+
+static  void  MskWaitForBatch (
+    tMskSink* pSink_p,
+    std::unique_lock<std::mutex>& Lock_p,
+    int64_t i64NextService_p)
+{
+
+int64_t  i64Now;
+int64_t  i64WaitUntil;
+int64_t  i64BatchDeadline;
+
+
+    for (;;)
+    {
+        if ( pSink_p->m_fStop )
+        {
+            return;
+        }
+        if (pSink_p->m_uiQueueLen >= pSink_p->m_Cfg.m_uiMaxBatch)
+        {
+            return;
+        }
+        if ((pSink_p->m_uiQueueLen == 0) && !pSink_p->m_deqBackfill.empty())
+        {
+            return;                                 // backfill is written without batch delay
+        }
+
+        i64Now = MskGetTimeUs();
+        if (i64Now >= i64NextService_p)
+        {
+            return;
+        }
+        i64WaitUntil = (i64NextService_p != INT64_MAX) ? i64NextService_p : (i64Now + (MSK_IDLE_WAIT_TIME * 1000));
+
+        // partial batch: wait up to <m_uiBatchDelay> after its oldest message
+        if (pSink_p->m_uiQueueLen > 0)
+        {
+            if (pSink_p->m_Cfg.m_uiBatchDelay == 0)
+            {
+                return;
+            }
+            i64BatchDeadline = pSink_p->m_vecQueue[pSink_p->m_uiQueueHead].m_i64QueueTime +
+                               ((int64_t)pSink_p->m_Cfg.m_uiBatchDelay * 1000);
+            if (i64Now >= i64BatchDeadline)
+            {
+                return;
+            }
+            i64WaitUntil = std::min(i64WaitUntil, i64BatchDeadline);
+        }
+
+        pSink_p->m_fWorkerWaiting = true;
+        MskWaitUntil(pSink_p->m_CondData, Lock_p, i64WaitUntil);
+        pSink_p->m_fWorkerWaiting = false;
+    }
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Take next Batch from Queue (Worker Thread, locked)
+//---------------------------------------------------------------------------
+//  Live messages always go first, a backfill batch is only taken if the
+//  live queue is empty. A batch never mixes both kinds.
+
+static  void  MskTakeBatch (
+    tMskSink* pSink_p,
+    std::vector<tMskEntry>* pvecBatch_p,
+    bool* pfBackfill_p)
+{
+
+tMskEntry*  pEntry;
+
+
+    *pfBackfill_p = false;
+    while ((pSink_p->m_uiQueueLen > 0) && (pvecBatch_p->size() < pSink_p->m_Cfg.m_uiMaxBatch))
+    {
+        pEntry = &pSink_p->m_vecQueue[pSink_p->m_uiQueueHead];
+        pvecBatch_p->push_back(tMskEntry());
+        pvecBatch_p->back().m_pJsonMessage = std::move(pEntry->m_pJsonMessage);
+        pvecBatch_p->back().m_i64QueueTime = pEntry->m_i64QueueTime;
+        pSink_p->m_uiQueueHead = (pSink_p->m_uiQueueHead + 1) % pSink_p->m_Cfg.m_uiQueueSize;
+        pSink_p->m_uiQueueLen--;
+    }
+
+    pSink_p->m_uiBatchLen = (uint)pvecBatch_p->size();
+    if ( !pvecBatch_p->empty() )
+    {
+        pSink_p->m_i64BatchQueueTime = pvecBatch_p->front().m_i64QueueTime;
+    }
+    else if ( !pSink_p->m_fStop )
+    {
+        while (!pSink_p->m_deqBackfill.empty() && (pvecBatch_p->size() < pSink_p->m_Cfg.m_uiMaxBatch))
+        {
+            pvecBatch_p->push_back(std::move(pSink_p->m_deqBackfill.front()));
+            pSink_p->m_deqBackfill.pop_front();
+        }
+        *pfBackfill_p = !pvecBatch_p->empty();
+    }
+
+    if (pSink_p->m_uiDispatchWaiting > 0)
+    {
+        pSink_p->m_CondSpace.notify_all();
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Drop all pending Messages at Stop (Worker Thread, locked)
+//---------------------------------------------------------------------------
+
+static  void  MskDropPending (
+    tMskSink* pSink_p,
+    std::vector<tMskEntry>* pvecBatch_p)
+{
+
+    pSink_p->m_ui64Dropped += pvecBatch_p->size() + pSink_p->m_uiQueueLen;
+    pvecBatch_p->clear();
+
+    while (pSink_p->m_uiQueueLen > 0)
+    {
+        pSink_p->m_vecQueue[pSink_p->m_uiQueueHead].m_pJsonMessage.reset();
+        pSink_p->m_uiQueueHead = (pSink_p->m_uiQueueHead + 1) % pSink_p->m_Cfg.m_uiQueueSize;
+        pSink_p->m_uiQueueLen--;
+    }
+    pSink_p->m_uiBatchLen = 0;
+
+    // pending backfill isn't counted as dropped (replay resumes from its checkpoint)
+    pSink_p->m_deqBackfill.clear();
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Wait for Condition until given Time
+//---------------------------------------------------------------------------
+
+static  void  MskWaitUntil (
+    std::condition_variable& Cond_p,
+    std::unique_lock<std::mutex>& Lock_p,
+    int64_t i64Time_p)
+{
+
+    Cond_p.wait_until(Lock_p, std::chrono::steady_clock::time_point(std::chrono::microseconds(i64Time_p)));
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get monotonic Time in [us]
+//---------------------------------------------------------------------------
+
+static  int64_t  MskGetTimeUs (void)
+{
+
+    return (std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+
+}
+
+
+
+// EOF
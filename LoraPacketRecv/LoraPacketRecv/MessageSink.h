@@ -0,0 +1,162 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Declarations for Fan-Out of Json Messages to Message Sinks
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Backfill Queue for re-published Messages (lower priority)
+
+****************************************************************************/
+
+#ifndef _MESSAGESINK_H_
+#define _MESSAGESINK_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+// Notice:  Each sink (MessageFile, MQTT Broker, ...) gets its own bounded
+//          queue and worker thread, so a slow or unreachable sink delays
+//          neither the main loop nor any other sink. MskDispatch() copies
+//          the Json Message once and only appends a reference to the queue
+//          of each sink. The worker passes up to <m_uiMaxBatch> messages
+//          at once to the write function of the sink.
+//
+//          The write function returns the number of messages it has handled
+//          (written or failed). If it returns less, the sink isn't ready
+//          (e.g. broker not reachable): the remaining messages are kept and
+//          passed again after <m_uiRetryDelay>, the service function (e.g.
+//          reconnect) is called before. A full queue is handled according to
+//          <m_OverflowPolicy>. The callbacks of a sink are only called by its
+//          worker thread.
+//
+//          In addition each sink has a small backfill queue for messages that
+//          are re-published from an archive (MskSubmit()). The worker only
+//          takes a backfill batch if no live message is pending, so a replay
+//          never delays the live path. MskSubmit() blocks the caller until
+//          there is space (backpressure instead of dropping), backfill messages
+//          still pending at MskStop() are discarded without counting them as
+//          dropped (the replay has its own checkpoint).
+//---------------------------------------------------------------------------
+
+const  uint  MSK_MAX_SINKS          = 8;
+const  uint  MSK_DEF_QUEUE_SIZE     = 4096;             // [messages]
+const  uint  MSK_DEF_MAX_BATCH      = 64;               // [messages]
+const  uint  MSK_DEF_DRAIN_TIMEOUT  = 5000;             // [ms] MskStop() waits for pending messages
+const  uint  MSK_DEF_BACKFILL_SIZE  = 256;              // [messages]
+
+
+
+//---------------------------------------------------------------------------
+//  Type definitions
+//---------------------------------------------------------------------------
+
+typedef enum
+{
+    kMskOverflowDropNewest  = 0,                    // new message is discarded
+    kMskOverflowDropOldest  = 1,                    // oldest queued message is discarded
+    kMskOverflowBlock       = 2                     // MskDispatch() waits up to <m_uiBlockTimeout> for free space (backpressure), then discards new message
+
+} tMskOverflowPolicy;
+
+
+typedef uint  (*tMskWriteFunc) (
+    const tJsonMessage* const* apJsonMessage_p,         // [IN]     Messages to write (oldest first)
+    uint uiCount_p,                                     // [IN]     Number of Messages
+    uint* puiFailed_p,                                  // [OUT]    Number of handled Messages that failed (counted by sink)
+    void* pArg_p);                                      // [IN]     <m_pArg> of Sink Config
+
+typedef void  (*tMskServiceFunc) (
+    void* pArg_p);                                      // [IN]     <m_pArg> of Sink Config
+
+
+typedef struct
+{
+    const char*         m_pszName;
+    tMskWriteFunc       m_pfnWrite;
+    tMskServiceFunc     m_pfnService;               // NULL = none
+    void*               m_pArg;
+    uint                m_uiQueueSize;              // [messages] (0 = MSK_DEF_QUEUE_SIZE)
+    uint                m_uiMaxBatch;               // [messages] (0 = MSK_DEF_MAX_BATCH)
+    uint                m_uiBatchDelay;             // [ms] wait for a full batch (0 = write immediately)
+    tMskOverflowPolicy  m_OverflowPolicy;
+    uint                m_uiBlockTimeout;           // [ms] kMskOverflowBlock only
+    uint                m_uiServiceInterval;        // [ms] call of <m_pfnService>
+    uint                m_uiRetryDelay;             // [ms] sink not ready
+    tMskWriteFunc       m_pfnWriteBackfill;         // write function for backfill batches (NULL = <m_pfnWrite>)
+    uint                m_uiBackfillSize;           // [messages] (0 = MSK_DEF_BACKFILL_SIZE)
+
+} tMskSinkCfg;
+
+
+typedef struct
+{
+    const char*         m_pszName;
+    uint64_t            m_ui64Queued;               // handed over by MskDispatch()
+    uint64_t            m_ui64Written;
+    uint64_t            m_ui64Failed;               // handled, but failed (e.g. write error)
+    uint64_t            m_ui64Dropped;              // queue overflow or still pending at MskStop()
+    uint64_t            m_ui64Batches;
+    uint64_t            m_ui64Retries;              // sink wasn't ready
+    uint                m_uiQueueLen;               // messages pending (incl. batch in progress)
+    uint                m_uiMaxQueueLen;
+    uint                m_uiQueueSize;
+    uint64_t            m_ui64LagUs;                // age of oldest pending message
+    uint64_t            m_ui64AvgLatencyUs;         // MskDispatch() to handled
+    uint64_t            m_ui64MaxLatencyUs;
+    uint64_t            m_ui64BlockedUs;            // time MskDispatch() waited (kMskOverflowBlock)
+    double              m_dThroughput;              // [messages/s] handled since MskStart()
+    uint64_t            m_ui64Backfilled;           // backfill messages handled (not included above)
+    uint                m_uiBackfillLen;            // backfill messages pending
+
+} tMskStatistics;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of public functions
+//---------------------------------------------------------------------------
+
+int  MskAddSink (
+    const tMskSinkCfg* pSinkCfg_p);                     // [IN]     Ptr to Sink Configuration
+
+int  MskStart (void);
+
+int  MskStop (
+    uint uiDrainTimeout_p);                             // [IN]     Max. Time to write pending Messages [ms]
+
+uint  MskDispatch (
+    const tJsonMessage* pJsonMessage_p);                // [IN]     Json Message (Bootup or Data Record)
+
+int  MskSubmit (
+    uint uiSink_p,                                      // [IN]     Sink (returned by MskAddSink())
+    const tJsonMessage* pJsonMessage_p,                 // [IN]     Json Message to re-publish
+    uint uiTimeout_p);                                  // [IN]     Max. Time to wait for free space [ms]
+
+uint  MskGetSinkCount (void);
+
+int  MskFindSink (
+    const char* pszName_p);                             // [IN]     Name of Sink
+
+int  MskGetStatistics (
+    uint uiSink_p,                                      // [IN]     Sink (returned by MskAddSink())
+    tMskStatistics* pStatistics_p);                     // [OUT]    Ptr to Statistics
+
+void  MskPrintStatistics (void);
+
+
+
+#endif  // #ifndef _MESSAGESINK_H_
+
+
+// EOF
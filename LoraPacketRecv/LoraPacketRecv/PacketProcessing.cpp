@@ -10,6 +10,11 @@
   Revision History:
 
   2023/03/25 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Delta Data Packet with variable Generation Depth
+  2026/10/18 -rs:   V1.02 Compact Data Packet with Sensor dependent Layout
+  2026/10/18 -rs:   V1.03 Json and Line Protocol Fields generated from <LoraPacketSchema.h>
+  2026/10/18 -rs:   V1.04 Json, Line Protocol and CSV Records built from <tPprRecordFields>
+  2026/10/18 -rs:   V1.05 Record Builders usable from several Threads
 
 ****************************************************************************/
 
@@ -25,9 +30,11 @@
 #include <iostream>
 #include <vector>
 #include <string.h>
+#include <math.h>
 #include <algorithm>
 #include <time.h>
 #include "LoraPacket.h"
+#include "LoraPacketSchema.h"
 #include "LoraPayloadDecoder.h"
 #include "PacketProcessing.h"
 #include "Trace.h"
@@ -54,6 +61,7 @@
 //  Constant definitions
 //---------------------------------------------------------------------------
 
+static  const  char*    LINE_PROTOCOL_MEASUREMENT = "LoraAmbMon";
 
 
 //---------------------------------------------------------------------------
@@ -102,6 +110,24 @@ static  int  PprBuildJsonMessagesStationData (
     std::vector<tJsonMessage>* pvecJsonMessages_p);     // [IN/OUT] Ptr to Vector with Json Messages
 
 
+static  std::string  PprBuildJsonSchemaItems (
+    const tLoraFieldDesc* paSchema_p,                   // [IN]     Schema of Record
+    uint uiNumFields_p,                                 // [IN]     Number of Fields in Schema
+    const void* pRec_p);                                // [IN]     Ptr to raw Record
+
+
+static  std::string  PprBuildLineSchemaFields (
+    const tLoraFieldDesc* paSchema_p,                   // [IN]     Schema of Record
+    uint uiNumFields_p,                                 // [IN]     Number of Fields in Schema
+    const void* pRec_p);                                // [IN]     Ptr to raw Record
+
+
+static  std::string  PprBuildCsvSchemaValues (
+    const tLoraFieldDesc* paSchema_p,                   // [IN]     Schema of Record
+    uint uiNumFields_p,                                 // [IN]     Number of Fields in Schema
+    const void* pRec_p);                                // [IN]     Ptr to raw Record (NULL = empty Values)
+
+
 static  std::string  PprFormatTimeStamp (
     time_t tmTimeStamp_p);
 
@@ -151,6 +177,8 @@ int  PprGainLoraDataRecord (
 
 LoraPayloadDecoder  LoraPayloadDec;
 tLoraDataPacket*    pLoraDataPacket;
+tLoraDataDeltaPacket*  pLoraDataDeltaPacket;
+tLoraDataCompactPacket*  pLoraDataCompactPacket;
 tLoraPacketType     LoraPacketType;
 uint                uiRxDataBuffLen;
 bool                fIsKnownLoraMsgFormat;
@@ -200,7 +228,24 @@ bool                fIsKnownLoraMsgFormat;
     TRACE0("    Checking plausibility of length of received data packet:\n");
     TRACE1("      Size expected (sizeof(tLoraDataPacket)): %u\n", sizeof(tLoraDataPacket));
     TRACE1("      Size received:                           %u\n", uiRxDataBuffLen);
-    if (uiRxDataBuffLen == sizeof(tLoraDataPacket))
+    if ( (uiRxDataBuffLen >= LORA_DATA_COMPACT_PACKET_SIZE(0, 1)) &&
+         (LoraPayloadDec.GetRxPacketType((tLoraDataPacket*)pabRxDataBuff_p) == kLoraPacketDataHeaderCompact) )
+    {
+        // Compact Data Packets are checked first, as their length depends on the sensor
+        // layout and may also match the classic Data Packet; they are processed like
+        // classic Data Packets (kLoraPacketDataHeader)
+        TRACE0("        -> Compact Data Packet\n");
+
+        pLoraDataCompactPacket = (tLoraDataCompactPacket*)pabRxDataBuff_p;
+        pLoraMsgData_p->m_LoraPacketType = kLoraPacketDataHeader;
+        pLoraMsgData_p->m_iLoraDevID = (int)LoraPayloadDec.GetRxPacketDevID((tLoraDataPacket*)pabRxDataBuff_p);
+        pLoraMsgData_p->m_LoraStationData = LoraPayloadDec.DecodeRxDataCompactPacket(pLoraDataCompactPacket, uiRxDataBuffLen);
+        PprReconstructStationData(pLoraMsgData_p);
+        pLoraMsgData_p->m_strLogLoraMsgData  = LoraPayloadDec.LogStationData(&pLoraMsgData_p->m_LoraStationData);
+        pLoraMsgData_p->m_strLogLoraMsgData += PprLogReconstructStationData(pLoraMsgData_p);
+        fIsKnownLoraMsgFormat = (pLoraMsgData_p->m_LoraStationData.m_uiNumDataRec > 0);
+    }
+    else if (uiRxDataBuffLen == sizeof(tLoraDataPacket))
     {
         TRACE0("        -> Size Match\n");
 
@@ -257,6 +302,22 @@ bool                fIsKnownLoraMsgFormat;
             }
         }
     }
+    else if ( (uiRxDataBuffLen >= LORA_DATA_DELTA_PACKET_SIZE(1)) &&
+              (LoraPayloadDec.GetRxPacketType((tLoraDataPacket*)pabRxDataBuff_p) == kLoraPacketDataHeaderDelta) )
+    {
+        // Delta Data Packets have a variable length depending on the generation depth,
+        // they are processed like classic Data Packets (kLoraPacketDataHeader)
+        TRACE0("        -> Delta Data Packet\n");
+
+        pLoraDataDeltaPacket = (tLoraDataDeltaPacket*)pabRxDataBuff_p;
+        pLoraMsgData_p->m_LoraPacketType = kLoraPacketDataHeader;
+        pLoraMsgData_p->m_iLoraDevID = (int)LoraPayloadDec.GetRxPacketDevID((tLoraDataPacket*)pabRxDataBuff_p);
+        pLoraMsgData_p->m_LoraStationData = LoraPayloadDec.DecodeRxDataDeltaPacket(pLoraDataDeltaPacket, uiRxDataBuffLen);
+        PprReconstructStationData(pLoraMsgData_p);
+        pLoraMsgData_p->m_strLogLoraMsgData  = LoraPayloadDec.LogStationData(&pLoraMsgData_p->m_LoraStationData);
+        pLoraMsgData_p->m_strLogLoraMsgData += PprLogReconstructStationData(pLoraMsgData_p);
+        fIsKnownLoraMsgFormat = (pLoraMsgData_p->m_LoraStationData.m_uiNumDataRec > 0);
+    }
     else
     {
         TRACE0("        -> Size Mismatch\n");
@@ -325,6 +386,213 @@ int  iRes;
 
 
 
+//---------------------------------------------------------------------------
+//  PprBuildJsonRecord
+//---------------------------------------------------------------------------
+
+int  PprBuildJsonRecord (
+    const tPprRecordFields* pRecordFields_p,            // [IN]     Ptr to decoded Record Fields
+    std::string* pstrJsonRecord_p)                      // [OUT]    Ptr to Json Record
+{
+
+std::string  strJsonRecord;
+char         szJsonItem[256];
+
+
+    if ( (pRecordFields_p  == NULL) ||
+         (pstrJsonRecord_p == NULL)  )
+    {
+        TRACE0("ERROR: Invalid Parameter!\n");
+        return (-1);
+    }
+
+    strJsonRecord = "{\n";
+    snprintf(szJsonItem, sizeof(szJsonItem), "  \"MsgID\": %u,\n", pRecordFields_p->m_uiMsgID);
+    strJsonRecord += szJsonItem;
+    if (pRecordFields_p->m_PacketType == kLoraPacketBootup)
+    {
+        snprintf(szJsonItem, sizeof(szJsonItem), "  \"MsgType\": \"StationBootup\",\n");
+    }
+    else
+    {
+        snprintf(szJsonItem, sizeof(szJsonItem), "  \"MsgType\": \"StationDataGen%u\",\n", pRecordFields_p->m_uiDataGen);
+    }
+    strJsonRecord += szJsonItem;
+    snprintf(szJsonItem, sizeof(szJsonItem), "  \"TimeStamp\": %u,\n", (unsigned)pRecordFields_p->m_tmTimeStamp);
+    strJsonRecord += szJsonItem;
+    snprintf(szJsonItem, sizeof(szJsonItem), "  \"TimeStampFmt\": \"%s\",\n", PprFormatTimeStamp(pRecordFields_p->m_tmTimeStamp).c_str());
+    strJsonRecord += szJsonItem;
+    snprintf(szJsonItem, sizeof(szJsonItem), "  \"RSSI\": %d,\n", (int)pRecordFields_p->m_i8Rssi);
+    strJsonRecord += szJsonItem;
+    snprintf(szJsonItem, sizeof(szJsonItem), "  \"DevID\": %u,\n", (unsigned)pRecordFields_p->m_ui8DevID);
+    strJsonRecord += szJsonItem;
+
+    if (pRecordFields_p->m_PacketType == kLoraPacketBootup)
+    {
+        // LoraStationBootup
+        snprintf(szJsonItem, sizeof(szJsonItem), "  \"FirmwareVer\": \"%u.%02u\",\n", (unsigned)pRecordFields_p->m_ui8FirmwareVersion, (unsigned)pRecordFields_p->m_ui8FirmwareRevision);
+        strJsonRecord += szJsonItem;
+        strJsonRecord += PprBuildJsonSchemaItems(LORA_SCHEMA_BOOTUP_HEADER, kLoraBootupNumFields, &pRecordFields_p->m_SchemaRec.m_LoraBootupHeader);
+    }
+    else
+    {
+        // LoraStationData.DataHeader
+        snprintf(szJsonItem, sizeof(szJsonItem), "  \"SequNum\": %u,\n", (unsigned)pRecordFields_p->m_ui32SequNum);
+        strJsonRecord += szJsonItem;
+        snprintf(szJsonItem, sizeof(szJsonItem), "  \"Uptime\": %u,\n", (unsigned)pRecordFields_p->m_ui32Uptime);
+        strJsonRecord += szJsonItem;
+        snprintf(szJsonItem, sizeof(szJsonItem), "  \"UptimeFmt\": \"%s\",\n", PprFormatUptime(pRecordFields_p->m_ui32Uptime).c_str());
+        strJsonRecord += szJsonItem;
+
+        // LoraStationData.DataRec[nIdx]
+        strJsonRecord += PprBuildJsonSchemaItems(LORA_SCHEMA_DATA_REC, kLoraDataRecNumFields, &pRecordFields_p->m_SchemaRec.m_LoraDataRec);
+    }
+
+    strJsonRecord += "}";
+
+    *pstrJsonRecord_p = strJsonRecord;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  PprBuildLineRecord
+//---------------------------------------------------------------------------
+
+int  PprBuildLineRecord (
+    const tPprRecordFields* pRecordFields_p,            // [IN]     Ptr to decoded Record Fields
+    std::string* pstrLineRecord_p)                      // [OUT]    Ptr to Line Protocol Record
+{
+
+std::string  strLineRecord;
+char         szLineItem[256];
+
+
+    if ( (pRecordFields_p  == NULL) ||
+         (pstrLineRecord_p == NULL)  )
+    {
+        TRACE0("ERROR: Invalid Parameter!\n");
+        return (-1);
+    }
+
+    if (pRecordFields_p->m_PacketType == kLoraPacketBootup)
+    {
+        snprintf(szLineItem, sizeof(szLineItem), "%s,DevID=%u,MsgType=StationBootup RSSI=%di,FirmwareVer=\"%u.%02u\",",
+                 LINE_PROTOCOL_MEASUREMENT, (unsigned)pRecordFields_p->m_ui8DevID, (int)pRecordFields_p->m_i8Rssi,
+                 (unsigned)pRecordFields_p->m_ui8FirmwareVersion, (unsigned)pRecordFields_p->m_ui8FirmwareRevision);
+        strLineRecord  = szLineItem;
+        strLineRecord += PprBuildLineSchemaFields(LORA_SCHEMA_BOOTUP_HEADER, kLoraBootupNumFields, &pRecordFields_p->m_SchemaRec.m_LoraBootupHeader);
+    }
+    else
+    {
+        snprintf(szLineItem, sizeof(szLineItem), "%s,DevID=%u,MsgType=StationDataGen%u RSSI=%di,SequNum=%ui,Uptime=%ui,",
+                 LINE_PROTOCOL_MEASUREMENT, (unsigned)pRecordFields_p->m_ui8DevID, pRecordFields_p->m_uiDataGen, (int)pRecordFields_p->m_i8Rssi,
+                 (unsigned)pRecordFields_p->m_ui32SequNum, (unsigned)pRecordFields_p->m_ui32Uptime);
+        strLineRecord  = szLineItem;
+        strLineRecord += PprBuildLineSchemaFields(LORA_SCHEMA_DATA_REC, kLoraDataRecNumFields, &pRecordFields_p->m_SchemaRec.m_LoraDataRec);
+    }
+    snprintf(szLineItem, sizeof(szLineItem), " %u000000000", (unsigned)pRecordFields_p->m_tmTimeStamp);
+    strLineRecord += szLineItem;
+
+    *pstrLineRecord_p = strLineRecord;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  PprBuildCsvHeader
+//---------------------------------------------------------------------------
+//  Bootup and Data Records share one column layout, the columns of the
+//  other record type are left empty.
+
+std::string  PprBuildCsvHeader (void)
+{
+
+std::string  strCsvHeader;
+uint         uiField;
+
+
+    strCsvHeader = "MsgID,MsgType,TimeStamp,TimeStampFmt,RSSI,DevID,SequNum,Uptime,FirmwareVer";
+    for (uiField=0; uiField<kLoraBootupNumFields; uiField++)
+    {
+        if ( LORA_SCHEMA_BOOTUP_HEADER[uiField].m_fPublish )
+        {
+            strCsvHeader += ",";
+            strCsvHeader += LORA_SCHEMA_BOOTUP_HEADER[uiField].m_pszName;
+        }
+    }
+    for (uiField=0; uiField<kLoraDataRecNumFields; uiField++)
+    {
+        if ( LORA_SCHEMA_DATA_REC[uiField].m_fPublish )
+        {
+            strCsvHeader += ",";
+            strCsvHeader += LORA_SCHEMA_DATA_REC[uiField].m_pszName;
+        }
+    }
+
+    return (strCsvHeader);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  PprBuildCsvRecord
+//---------------------------------------------------------------------------
+
+int  PprBuildCsvRecord (
+    const tPprRecordFields* pRecordFields_p,            // [IN]     Ptr to decoded Record Fields
+    std::string* pstrCsvRecord_p)                       // [OUT]    Ptr to CSV Record
+{
+
+std::string  strCsvRecord;
+char         szCsvItem[128];
+
+
+    if ( (pRecordFields_p == NULL) ||
+         (pstrCsvRecord_p == NULL)  )
+    {
+        TRACE0("ERROR: Invalid Parameter!\n");
+        return (-1);
+    }
+
+    if (pRecordFields_p->m_PacketType == kLoraPacketBootup)
+    {
+        snprintf(szCsvItem, sizeof(szCsvItem), "%u,StationBootup,%u,%s,%d,%u,,,%u.%02u",
+                 pRecordFields_p->m_uiMsgID, (unsigned)pRecordFields_p->m_tmTimeStamp,
+                 PprFormatTimeStamp(pRecordFields_p->m_tmTimeStamp).c_str(),
+                 (int)pRecordFields_p->m_i8Rssi, (unsigned)pRecordFields_p->m_ui8DevID,
+                 (unsigned)pRecordFields_p->m_ui8FirmwareVersion, (unsigned)pRecordFields_p->m_ui8FirmwareRevision);
+        strCsvRecord  = szCsvItem;
+        strCsvRecord += PprBuildCsvSchemaValues(LORA_SCHEMA_BOOTUP_HEADER, kLoraBootupNumFields, &pRecordFields_p->m_SchemaRec.m_LoraBootupHeader);
+        strCsvRecord += PprBuildCsvSchemaValues(LORA_SCHEMA_DATA_REC, kLoraDataRecNumFields, NULL);
+    }
+    else
+    {
+        snprintf(szCsvItem, sizeof(szCsvItem), "%u,StationDataGen%u,%u,%s,%d,%u,%u,%u,",
+                 pRecordFields_p->m_uiMsgID, pRecordFields_p->m_uiDataGen, (unsigned)pRecordFields_p->m_tmTimeStamp,
+                 PprFormatTimeStamp(pRecordFields_p->m_tmTimeStamp).c_str(),
+                 (int)pRecordFields_p->m_i8Rssi, (unsigned)pRecordFields_p->m_ui8DevID,
+                 (unsigned)pRecordFields_p->m_ui32SequNum, (unsigned)pRecordFields_p->m_ui32Uptime);
+        strCsvRecord  = szCsvItem;
+        strCsvRecord += PprBuildCsvSchemaValues(LORA_SCHEMA_BOOTUP_HEADER, kLoraBootupNumFields, NULL);
+        strCsvRecord += PprBuildCsvSchemaValues(LORA_SCHEMA_DATA_REC, kLoraDataRecNumFields, &pRecordFields_p->m_SchemaRec.m_LoraDataRec);
+    }
+
+    *pstrCsvRecord_p = strCsvRecord;
+
+    return (0);
+
+}
+
+
+
 //---------------------------------------------------------------------------
 //  PprBuildTelemetryMessage
 //---------------------------------------------------------------------------
@@ -491,6 +759,7 @@ int  PprPrintJsonMessage (
         case kLoraPacketDataGen0:       printf("kLoraPacketDataGen0");        break;
         case kLoraPacketDataGen1:       printf("kLoraPacketDataGen1");        break;
         case kLoraPacketDataGen2:       printf("kLoraPacketDataGen2");        break;
+        case kLoraPacketDataGenN:       printf("kLoraPacketDataGenN");        break;
         default:                        printf("???");                        break;
     }
     printf("\n");
@@ -536,20 +805,20 @@ uint   uiUptimeSnippetDiff;
         return (-1);
     }
 
-    for (nDataGen=0; nDataGen<(sizeof(pLoraMsgData_p->m_LoraStationData.m_aDataRec)/sizeof(LoraPayloadDecoder::tDataRec)); nDataGen++)
+    for (nDataGen=0; nDataGen<pLoraMsgData_p->m_LoraStationData.m_uiNumDataRec; nDataGen++)
     {
         // check validity
         if (pLoraMsgData_p->m_LoraStationData.m_aDataRec[nDataGen].m_DataStatus != LoraPayloadDecoder::kStatusValid)
         {
-            // skip invalid Data records (unused or invalid CRC)
-            TRACE0("INFO: Skip invalid Data records (unused or invalid CRC)\n");
+            // skip invalid Data records (unused, invalid CRC or clipped DeltaRecord)
+            TRACE0("INFO: Skip invalid Data records (unused, invalid CRC or clipped)\n");
             continue;
         }
 
         // ---- Reconstruct SequenceNumber ----
-        // The DataRecords included in a LoRa Package are 3 consecutive generations (Gen0/Gen1/Gen2).
-        // Therefore the SequenceNumber for Gen1 and Gen2 is obtained by decreasing the SequenceNumber
-        // of the DataHeader accordingly
+        // The DataRecords included in a LoRa Package are consecutive generations (Gen0/Gen1/Gen2,
+        // or Gen0..GenN for Delta Data Packets). Therefore the SequenceNumber for Gen1..GenN is
+        // obtained by decreasing the SequenceNumber of the DataHeader accordingly
         pLoraMsgData_p->m_aLoraStationDataReconstruct[nDataGen].m_ui32SequNum = pLoraMsgData_p->m_LoraStationData.m_DataHeader.m_ui32SequNum - nDataGen;
 
         // ---- Reconstruct Uptime und TimeStamp----
@@ -566,7 +835,7 @@ uint   uiUptimeSnippetDiff;
         }
         else
         {
-            // for Gen1 and Gen2 DataRecords the uptime is reconstructed from uptime of the DataHeader reduced by
+            // for Gen1..GenN DataRecords the uptime is reconstructed from uptime of the DataHeader reduced by
             // the uptime difference between Gen1 or Gen2 and DataHeader
             //     tDataHeader.m_ui32Uptime      -> Uptime        32Bit  -> 0..4294967296 [sec] resp. 0..136 [year]
             //     tDataRec.m_ui12UptimeSnippet  -> UptimeSnippet 12Bit  -> 0..4095 [10 sec] resp. 0..11 [h]
@@ -576,7 +845,7 @@ uint   uiUptimeSnippetDiff;
             uiUptimeSnippetDiff &= 0x0FFF;                                      // reduce difference to 12Bit
             pLoraMsgData_p->m_aLoraStationDataReconstruct[nDataGen].m_ui32Uptime = pLoraMsgData_p->m_LoraStationData.m_DataHeader.m_ui32Uptime - uiUptimeSnippetDiff;
 
-            // for Gen1 and Gen2 DataRecords the TimeStamp is reconstructed from receiving TimeStamp
+            // for Gen1..GenN DataRecords the TimeStamp is reconstructed from receiving TimeStamp
             // the uptime difference between Gen1 or Gen2 and DataHeader
             pLoraMsgData_p->m_aLoraStationDataReconstruct[nDataGen].m_tmTimeStamp = pLoraMsgData_p->m_tmTimeStamp - uiUptimeSnippetDiff;
         }
@@ -604,7 +873,7 @@ uint         nDataGen;
     strLogData.clear();
     strLogData += " === ReconstructStationData ===\n";
     strLogData += " *ReconstructDataRecords*\n";
-    for (nDataGen=0; nDataGen<(sizeof(pLoraMsgData_p->m_aLoraStationDataReconstruct)/sizeof(tLoraStationDataReconstruct)); nDataGen++)
+    for (nDataGen=0; nDataGen<pLoraMsgData_p->m_LoraStationData.m_uiNumDataRec; nDataGen++)
     {
         snprintf(szLogBuffer, sizeof(szLogBuffer), "  ReconstructDataRecord[%d]:\n", nDataGen);
         strLogData += szLogBuffer;
@@ -632,9 +901,8 @@ static  int  PprBuildJsonMessagesStationBootup (
     std::vector<tJsonMessage>* pvecJsonMessages_p)      // [IN/OUT] Ptr to Vector with Json Messages
 {
 
-tJsonMessage  JsonMessage;
-std::string   strJsonRecord;
-char          szJsonItem[256];
+tJsonMessage      JsonMessage;
+tPprRecordFields  RecordFields;
 
 
     // clear Message Vector
@@ -646,54 +914,27 @@ char          szJsonItem[256];
         return (-1);
     }
 
-    // build Json Record
-    strJsonRecord = "{\n";
-    snprintf(szJsonItem, sizeof(szJsonItem), "  \"MsgID\": %u,\n", pLoraMsgData_p->m_uiMsgID);
-    strJsonRecord += szJsonItem;
-    snprintf(szJsonItem, sizeof(szJsonItem), "  \"MsgType\": \"StationBootup\",\n");
-    strJsonRecord += szJsonItem;
-    snprintf(szJsonItem, sizeof(szJsonItem), "  \"TimeStamp\": %u,\n", (unsigned)pLoraMsgData_p->m_tmTimeStamp);
-    strJsonRecord += szJsonItem;
-    snprintf(szJsonItem, sizeof(szJsonItem), "  \"TimeStampFmt\": \"%s\",\n", PprFormatTimeStamp(pLoraMsgData_p->m_tmTimeStamp).c_str());
-    strJsonRecord += szJsonItem;
-    snprintf(szJsonItem, sizeof(szJsonItem), "  \"RSSI\": %d,\n", (int)pLoraMsgData_p->m_i8Rssi);
-    strJsonRecord += szJsonItem;
-    snprintf(szJsonItem, sizeof(szJsonItem), "  \"DevID\": %u,\n", (unsigned)pLoraMsgData_p->m_LoraStationBootup.m_ui8DevID);
-    strJsonRecord += szJsonItem;
-    snprintf(szJsonItem, sizeof(szJsonItem), "  \"FirmwareVer\": \"%u.%02u\",\n", (unsigned)pLoraMsgData_p->m_LoraStationBootup.m_ui8FirmwareVersion, (unsigned)pLoraMsgData_p->m_LoraStationBootup.m_ui8FirmwareRevision);
-    strJsonRecord += szJsonItem;
-    snprintf(szJsonItem, sizeof(szJsonItem), "  \"DataPackCycleTm\": %u,\n", (unsigned)pLoraMsgData_p->m_LoraStationBootup.m_ui16DataPackCycleTm);
-    strJsonRecord += szJsonItem;
-    snprintf(szJsonItem, sizeof(szJsonItem), "  \"CfgOledDisplay\": %u,\n", (unsigned)(pLoraMsgData_p->m_LoraStationBootup.m_fCfgOledDisplay & 0x01));
-    strJsonRecord += szJsonItem;
-    snprintf(szJsonItem, sizeof(szJsonItem), "  \"CfgDhtSensor\": %u,\n", (unsigned)(pLoraMsgData_p->m_LoraStationBootup.m_fCfgDhtSensor & 0x01));
-    strJsonRecord += szJsonItem;
-    snprintf(szJsonItem, sizeof(szJsonItem), "  \"CfgSr501Sensor\": %u,\n", (unsigned)(pLoraMsgData_p->m_LoraStationBootup.m_fCfgSr501Sensor & 0x01));
-    strJsonRecord += szJsonItem;
-    snprintf(szJsonItem, sizeof(szJsonItem), "  \"CfgAdcLightSensor\": %u,\n", (unsigned)(pLoraMsgData_p->m_LoraStationBootup.m_fCfgAdcLightSensor & 0x01));
-    strJsonRecord += szJsonItem;
-    snprintf(szJsonItem, sizeof(szJsonItem), "  \"CfgAdcCarBatAin\": %u,\n", (unsigned)(pLoraMsgData_p->m_LoraStationBootup.m_fCfgAdcCarBatAin & 0x01));
-    strJsonRecord += szJsonItem;
-    snprintf(szJsonItem, sizeof(szJsonItem), "  \"CfgAsyncLoraEvent\": %u,\n", (unsigned)(pLoraMsgData_p->m_LoraStationBootup.m_fCfgAsyncLoraEvent & 0x01));
-    strJsonRecord += szJsonItem;
-    snprintf(szJsonItem, sizeof(szJsonItem), "  \"Sr501PauseOnLoraTx\": %u,\n", (unsigned)(pLoraMsgData_p->m_LoraStationBootup.m_fSr501PauseOnLoraTx & 0x01));
-    strJsonRecord += szJsonItem;
-    snprintf(szJsonItem, sizeof(szJsonItem), "  \"CommissioningMode\": %u,\n", (unsigned)(pLoraMsgData_p->m_LoraStationBootup.m_fCommissioningMode & 0x01));
-    strJsonRecord += szJsonItem;
-    snprintf(szJsonItem, sizeof(szJsonItem), "  \"LoraTxPower\": %u,\n", (unsigned)pLoraMsgData_p->m_LoraStationBootup.m_ui8LoraTxPower);
-    strJsonRecord += szJsonItem;
-    snprintf(szJsonItem, sizeof(szJsonItem), "  \"LoraSpreadFactor\": %u\n", (unsigned)pLoraMsgData_p->m_LoraStationBootup.m_ui8LoraSpreadFactor);
-    strJsonRecord += szJsonItem;
-    strJsonRecord += "}";
-
-    // build Json Message InfoBlock
+    // collect Record Fields
+    memset(&RecordFields, 0, sizeof(RecordFields));
+    RecordFields.m_uiMsgID              = pLoraMsgData_p->m_uiMsgID;
+    RecordFields.m_PacketType           = pLoraMsgData_p->m_LoraPacketType;
+    RecordFields.m_tmTimeStamp          = pLoraMsgData_p->m_tmTimeStamp;
+    RecordFields.m_i8Rssi               = pLoraMsgData_p->m_i8Rssi;
+    RecordFields.m_ui8DevID             = pLoraMsgData_p->m_LoraStationBootup.m_ui8DevID;
+    RecordFields.m_ui8FirmwareVersion   = pLoraMsgData_p->m_LoraStationBootup.m_ui8FirmwareVersion;
+    RecordFields.m_ui8FirmwareRevision  = pLoraMsgData_p->m_LoraStationBootup.m_ui8FirmwareRevision;
+    RecordFields.m_SchemaRec.m_LoraBootupHeader = pLoraMsgData_p->m_LoraStationBootup.m_LoraBootupHeader;
+
+    // build Json Message InfoBlock and Records
     JsonMessage.m_uiMsgID       = pLoraMsgData_p->m_uiMsgID;
     JsonMessage.m_PacketType    = pLoraMsgData_p->m_LoraPacketType;
     JsonMessage.m_ui8DevID      = pLoraMsgData_p->m_LoraStationBootup.m_ui8DevID;
     JsonMessage.m_ui32SequNum   = 0;
     JsonMessage.m_i8Rssi        = pLoraMsgData_p->m_i8Rssi;
     JsonMessage.m_tmTimeStamp   = pLoraMsgData_p->m_tmTimeStamp;
-    JsonMessage.m_strJsonRecord = strJsonRecord;
+    JsonMessage.m_RecordFields  = RecordFields;
+    PprBuildJsonRecord(&RecordFields, &JsonMessage.m_strJsonRecord);
+    PprBuildLineRecord(&RecordFields, &JsonMessage.m_strLineRecord);
     pvecJsonMessages_p->push_back(JsonMessage);
 
     return (0);
@@ -711,12 +952,9 @@ static  int  PprBuildJsonMessagesStationData (
     std::vector<tJsonMessage>* pvecJsonMessages_p)      // [IN/OUT] Ptr to Vector with Json Messages
 {
 
-tJsonMessage  JsonMessage;
-std::string   strJsonRecord;
-std::string   strDataHeader;
-std::string   strDataRec;
-char          szJsonItem[256];
-uint          nDataGen;
+tJsonMessage      JsonMessage;
+tPprRecordFields  RecordFields;
+uint              nDataGen;
 
 
     // clear Message Vector
@@ -728,64 +966,37 @@ uint          nDataGen;
         return (-1);
     }
 
-    for (nDataGen=0; nDataGen<(sizeof(pLoraMsgData_p->m_LoraStationData.m_aDataRec)/sizeof(LoraPayloadDecoder::tDataRec)); nDataGen++)
+    for (nDataGen=0; nDataGen<pLoraMsgData_p->m_LoraStationData.m_uiNumDataRec; nDataGen++)
     {
         // check validity
         if (pLoraMsgData_p->m_LoraStationData.m_aDataRec[nDataGen].m_DataStatus != LoraPayloadDecoder::kStatusValid)
         {
-            // skip invalid records (unused or invalid CRC)
+            // skip invalid records (unused, invalid CRC or clipped DeltaRecord)
             continue;
         }
 
-        // LoRa Packet Header
-        strJsonRecord = "{\n";
-        snprintf(szJsonItem, sizeof(szJsonItem), "  \"MsgID\": %u,\n", pLoraMsgData_p->m_uiMsgID);
-        strJsonRecord += szJsonItem;
-        snprintf(szJsonItem, sizeof(szJsonItem), "  \"MsgType\": \"StationDataGen%u\",\n", nDataGen);
-        strJsonRecord += szJsonItem;
-        snprintf(szJsonItem, sizeof(szJsonItem), "  \"TimeStamp\": %u,\n", (unsigned)pLoraMsgData_p->m_aLoraStationDataReconstruct[nDataGen].m_tmTimeStamp);
-        strJsonRecord += szJsonItem;
-        snprintf(szJsonItem, sizeof(szJsonItem), "  \"TimeStampFmt\": \"%s\",\n", PprFormatTimeStamp(pLoraMsgData_p->m_aLoraStationDataReconstruct[nDataGen].m_tmTimeStamp).c_str());
-        strJsonRecord += szJsonItem;
-        snprintf(szJsonItem, sizeof(szJsonItem), "  \"RSSI\": %d,\n", (int)pLoraMsgData_p->m_i8Rssi);
-        strJsonRecord += szJsonItem;
-
-        // LoraStationData.DataHeader
-        snprintf(szJsonItem, sizeof(szJsonItem), "  \"DevID\": %u,\n", (unsigned)pLoraMsgData_p->m_LoraStationData.m_DataHeader.m_ui8DevID);
-        strJsonRecord += szJsonItem;
-        snprintf(szJsonItem, sizeof(szJsonItem), "  \"SequNum\": %u,\n", (unsigned)pLoraMsgData_p->m_aLoraStationDataReconstruct[nDataGen].m_ui32SequNum);
-        strJsonRecord += szJsonItem;
-        snprintf(szJsonItem, sizeof(szJsonItem), "  \"Uptime\": %u,\n", (unsigned)pLoraMsgData_p->m_aLoraStationDataReconstruct[nDataGen].m_ui32Uptime);
-        strJsonRecord += szJsonItem;
-        snprintf(szJsonItem, sizeof(szJsonItem), "  \"UptimeFmt\": \"%s\",\n", PprFormatUptime(pLoraMsgData_p->m_aLoraStationDataReconstruct[nDataGen].m_ui32Uptime).c_str());
-        strJsonRecord += szJsonItem;
-
-        // LoraStationData.DataRec[nIdx]
-        snprintf(szJsonItem, sizeof(szJsonItem), "  \"Temperature\": %.1f,\n", pLoraMsgData_p->m_LoraStationData.m_aDataRec[nDataGen].m_flTemperature);
-        strJsonRecord += szJsonItem;
-        snprintf(szJsonItem, sizeof(szJsonItem), "  \"Humidity\": %.1f,\n", pLoraMsgData_p->m_LoraStationData.m_aDataRec[nDataGen].m_flHumidity);
-        strJsonRecord += szJsonItem;
-        snprintf(szJsonItem, sizeof(szJsonItem), "  \"MotionActive\": %u,\n", (unsigned)pLoraMsgData_p->m_LoraStationData.m_aDataRec[nDataGen].m_fMotionActive);
-        strJsonRecord += szJsonItem;
-        snprintf(szJsonItem, sizeof(szJsonItem), "  \"MotionActiveTime\": %u,\n", (unsigned)pLoraMsgData_p->m_LoraStationData.m_aDataRec[nDataGen].m_ui16MotionActiveTime);
-        strJsonRecord += szJsonItem;
-        snprintf(szJsonItem, sizeof(szJsonItem), "  \"MotionActiveCount\": %u,\n", (unsigned)pLoraMsgData_p->m_LoraStationData.m_aDataRec[nDataGen].m_ui16MotionActiveCount);
-        strJsonRecord += szJsonItem;
-        snprintf(szJsonItem, sizeof(szJsonItem), "  \"LightLevel\": %u,\n", (unsigned)pLoraMsgData_p->m_LoraStationData.m_aDataRec[nDataGen].m_ui8LightLevel);
-        strJsonRecord += szJsonItem;
-        snprintf(szJsonItem, sizeof(szJsonItem), "  \"CarBattLevel\": %.1f\n", pLoraMsgData_p->m_LoraStationData.m_aDataRec[nDataGen].m_flCarBattLevel);
-        strJsonRecord += szJsonItem;
-
-        strJsonRecord += "}";
-
-        // build Json Message InfoBlock
+        // collect Record Fields (LoRa Packet Header, DataHeader and DataRec[nIdx])
+        memset(&RecordFields, 0, sizeof(RecordFields));
+        RecordFields.m_uiMsgID      = pLoraMsgData_p->m_uiMsgID;
+        RecordFields.m_PacketType   = pLoraMsgData_p->m_LoraStationData.m_aDataRec[nDataGen].m_PacketType;
+        RecordFields.m_uiDataGen    = nDataGen;
+        RecordFields.m_tmTimeStamp  = pLoraMsgData_p->m_aLoraStationDataReconstruct[nDataGen].m_tmTimeStamp;
+        RecordFields.m_i8Rssi       = pLoraMsgData_p->m_i8Rssi;
+        RecordFields.m_ui8DevID     = pLoraMsgData_p->m_LoraStationData.m_DataHeader.m_ui8DevID;
+        RecordFields.m_ui32SequNum  = pLoraMsgData_p->m_aLoraStationDataReconstruct[nDataGen].m_ui32SequNum;
+        RecordFields.m_ui32Uptime   = pLoraMsgData_p->m_aLoraStationDataReconstruct[nDataGen].m_ui32Uptime;
+        RecordFields.m_SchemaRec.m_LoraDataRec = pLoraMsgData_p->m_LoraStationData.m_aDataRec[nDataGen].m_LoraDataRec;
+
+        // build Json Message InfoBlock and Records
         JsonMessage.m_uiMsgID       = pLoraMsgData_p->m_uiMsgID;
         JsonMessage.m_PacketType    = pLoraMsgData_p->m_LoraStationData.m_aDataRec[nDataGen].m_PacketType;
         JsonMessage.m_ui8DevID      = pLoraMsgData_p->m_LoraStationData.m_DataHeader.m_ui8DevID;
         JsonMessage.m_ui32SequNum   = pLoraMsgData_p->m_aLoraStationDataReconstruct[nDataGen].m_ui32SequNum;
         JsonMessage.m_i8Rssi        = pLoraMsgData_p->m_i8Rssi;
         JsonMessage.m_tmTimeStamp   = pLoraMsgData_p->m_tmTimeStamp;
-        JsonMessage.m_strJsonRecord = strJsonRecord;
+        JsonMessage.m_RecordFields  = RecordFields;
+        PprBuildJsonRecord(&RecordFields, &JsonMessage.m_strJsonRecord);
+        PprBuildLineRecord(&RecordFields, &JsonMessage.m_strLineRecord);
         pvecJsonMessages_p->push_back(JsonMessage);
     }
 
@@ -795,6 +1006,149 @@ uint          nDataGen;
 
 
 
+//---------------------------------------------------------------------------
+//  Build Json Items of all published Fields of a Record
+//---------------------------------------------------------------------------
+
+static  std::string  PprBuildJsonSchemaItems (
+    const tLoraFieldDesc* paSchema_p,                   // [IN]     Schema of Record
+    uint uiNumFields_p,                                 // [IN]     Number of Fields in Schema
+    const void* pRec_p)                                 // [IN]     Ptr to raw Record
+{
+
+std::string  strJsonItems;
+char         szJsonItem[128];
+const char*  pszSeparator;
+double       dValue;
+uint         uiField;
+
+
+    // Items are separated by ",\n", last Item closes the Json Record with "\n"
+    pszSeparator = "";
+    for (uiField=0; uiField<uiNumFields_p; uiField++)
+    {
+        if ( !paSchema_p[uiField].m_fPublish )
+        {
+            continue;
+        }
+
+        dValue = LoraSchemaGetValue(&paSchema_p[uiField], pRec_p);
+        if (paSchema_p[uiField].m_ui8Decimals > 0)
+        {
+            snprintf(szJsonItem, sizeof(szJsonItem), "%s  \"%s\": %.*f", pszSeparator, paSchema_p[uiField].m_pszName,
+                     (int)paSchema_p[uiField].m_ui8Decimals, dValue);
+        }
+        else
+        {
+            snprintf(szJsonItem, sizeof(szJsonItem), "%s  \"%s\": %lld", pszSeparator, paSchema_p[uiField].m_pszName,
+                     (long long)llround(dValue));
+        }
+        strJsonItems += szJsonItem;
+        pszSeparator = ",\n";
+    }
+    strJsonItems += "\n";
+
+    return (strJsonItems);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Build Line Protocol Fields of all published Fields of a Record
+//---------------------------------------------------------------------------
+
+static  std::string  PprBuildLineSchemaFields (
+    const tLoraFieldDesc* paSchema_p,                   // [IN]     Schema of Record
+    uint uiNumFields_p,                                 // [IN]     Number of Fields in Schema
+    const void* pRec_p)                                 // [IN]     Ptr to raw Record
+{
+
+std::string  strLineFields;
+char         szLineField[128];
+const char*  pszSeparator;
+double       dValue;
+uint         uiField;
+
+
+    // Integer Fields get the suffix 'i', Fields are separated by ','
+    pszSeparator = "";
+    for (uiField=0; uiField<uiNumFields_p; uiField++)
+    {
+        if ( !paSchema_p[uiField].m_fPublish )
+        {
+            continue;
+        }
+
+        dValue = LoraSchemaGetValue(&paSchema_p[uiField], pRec_p);
+        if (paSchema_p[uiField].m_ui8Decimals > 0)
+        {
+            snprintf(szLineField, sizeof(szLineField), "%s%s=%.*f", pszSeparator, paSchema_p[uiField].m_pszName,
+                     (int)paSchema_p[uiField].m_ui8Decimals, dValue);
+        }
+        else
+        {
+            snprintf(szLineField, sizeof(szLineField), "%s%s=%lldi", pszSeparator, paSchema_p[uiField].m_pszName,
+                     (long long)llround(dValue));
+        }
+        strLineFields += szLineField;
+        pszSeparator = ",";
+    }
+
+    return (strLineFields);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Build CSV Values of all published Fields of a Record
+//---------------------------------------------------------------------------
+
+static  std::string  PprBuildCsvSchemaValues (
+    const tLoraFieldDesc* paSchema_p,                   // [IN]     Schema of Record
+    uint uiNumFields_p,                                 // [IN]     Number of Fields in Schema
+    const void* pRec_p)                                 // [IN]     Ptr to raw Record (NULL = empty Values)
+{
+
+std::string  strCsvValues;
+char         szCsvValue[64];
+double       dValue;
+uint         uiField;
+
+
+    // each Value is preceded by ',', so the result can be appended to the common columns
+    for (uiField=0; uiField<uiNumFields_p; uiField++)
+    {
+        if ( !paSchema_p[uiField].m_fPublish )
+        {
+            continue;
+        }
+
+        strCsvValues += ",";
+        if (pRec_p == NULL)
+        {
+            continue;
+        }
+
+        dValue = LoraSchemaGetValue(&paSchema_p[uiField], pRec_p);
+        if (paSchema_p[uiField].m_ui8Decimals > 0)
+        {
+            snprintf(szCsvValue, sizeof(szCsvValue), "%.*f", (int)paSchema_p[uiField].m_ui8Decimals, dValue);
+        }
+        else
+        {
+            snprintf(szCsvValue, sizeof(szCsvValue), "%lld", (long long)llround(dValue));
+        }
+        strCsvValues += szCsvValue;
+    }
+
+    return (strCsvValues);
+
+}
+
+
+
 //---------------------------------------------------------------------------
 //  Format TimeStamp as Date/Time String
 //---------------------------------------------------------------------------
@@ -822,15 +1176,16 @@ static  int  PprFormatTimeStamp (
     int iBuffSize_p)
 {
 
-struct tm*  LocTime;
+struct tm   LocTime;
 int         iStrLen;
 
 
-    LocTime = localtime(&tmTimeStamp_p);
+    // localtime_r() instead of localtime(): LoraMsgLog builds records in several threads
+    localtime_r(&tmTimeStamp_p, &LocTime);
 
     snprintf(pszBuffer_p, iBuffSize_p, "%04d/%02d/%02d - %02d:%02d:%02d",
-             LocTime->tm_year + 1900, LocTime->tm_mon + 1, LocTime->tm_mday,
-             LocTime->tm_hour, LocTime->tm_min, LocTime->tm_sec);
+             LocTime.tm_year + 1900, LocTime.tm_mon + 1, LocTime.tm_mday,
+             LocTime.tm_hour, LocTime.tm_min, LocTime.tm_sec);
 
     iStrLen = (int)strlen(pszBuffer_p);
 
@@ -10,6 +10,8 @@
   Revision History:
 
   2023/03/25 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Line Protocol Record generated from <LoraPacketSchema.h>
+  2026/10/18 -rs:   V1.02 Record Fields of Json Message, CSV Record
 
 ****************************************************************************/
 
@@ -60,6 +62,29 @@ typedef struct
 } tLoraMsgData;
 
 
+//  Decoded content of a single Json Message, the Json, Line Protocol and CSV
+//  Records are built from these fields only (also used by the binary MessageLog)
+typedef struct
+{
+    uint                m_uiMsgID;
+    tLoraPacketType     m_PacketType;               // kLoraPacketBootup or Type of Data Record
+    uint                m_uiDataGen;                // Data Record only: Generation (MsgType "StationDataGen<n>")
+    time_t              m_tmTimeStamp;              // Bootup: Receive Time, Data Record: reconstructed Time of Record
+    int8_t              m_i8Rssi;
+    uint8_t             m_ui8DevID;
+    uint32_t            m_ui32SequNum;              // Data Record only: reconstructed SequNum
+    uint32_t            m_ui32Uptime;               // Data Record only: reconstructed Uptime
+    uint8_t             m_ui8FirmwareVersion;       // Bootup only
+    uint8_t             m_ui8FirmwareRevision;      // Bootup only
+    union
+    {
+        tLoraBootupHeader   m_LoraBootupHeader;     // raw Record, Fields see LORA_SCHEMA_BOOTUP_HEADER
+        tLoraDataRec        m_LoraDataRec;          // raw Record, Fields see LORA_SCHEMA_DATA_REC
+    }                   m_SchemaRec;
+
+} tPprRecordFields;
+
+
 typedef struct
 {
     uint                m_uiMsgID;
@@ -69,6 +94,8 @@ typedef struct
     int8_t              m_i8Rssi;
     time_t              m_tmTimeStamp;
     std::string         m_strJsonRecord;
+    std::string         m_strLineRecord;            // same content in InfluxDB Line Protocol
+    tPprRecordFields    m_RecordFields;             // decoded Fields of both Records
 
 } tJsonMessage;
 
@@ -93,6 +120,24 @@ int  PprBuildJsonMessages (
     std::vector<tJsonMessage>* pvecJsonMessages_p);     // [IN/OUT] Ptr to Vector with Json Messages
 
 
+int  PprBuildJsonRecord (
+    const tPprRecordFields* pRecordFields_p,            // [IN]     Ptr to decoded Record Fields
+    std::string* pstrJsonRecord_p);                     // [OUT]    Ptr to Json Record
+
+
+int  PprBuildLineRecord (
+    const tPprRecordFields* pRecordFields_p,            // [IN]     Ptr to decoded Record Fields
+    std::string* pstrLineRecord_p);                     // [OUT]    Ptr to Line Protocol Record
+
+
+std::string  PprBuildCsvHeader (void);
+
+
+int  PprBuildCsvRecord (
+    const tPprRecordFields* pRecordFields_p,            // [IN]     Ptr to decoded Record Fields
+    std::string* pstrCsvRecord_p);                      // [OUT]    Ptr to CSV Record
+
+
 int  PprBuildTelemetryMessage (
     const tJsonMessage* pJsonMessage_p,                 // [IN]     Json Message with Telemetry Data
     uint8_t* pabMsgBuffer_p,                            // [IN]     Ptr to Message Buffer
@@ -0,0 +1,650 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Implementation of Raw Frame Capture (pcap with LoRaTap Header)
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#include <RH_RF95.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "RxQueue.h"
+#include "RealTime.h"
+#include "PcapWriter.h"
+#include "Trace.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+//  pcap File Format (classic libpcap format, microsecond resolution)
+static  const  uint32_t     PCAP_MAGIC_NUMBER       = 0xA1B2C3D4;
+static  const  uint16_t     PCAP_VERSION_MAJOR      = 2;
+static  const  uint16_t     PCAP_VERSION_MINOR      = 4;
+static  const  uint32_t     PCAP_SNAPLEN            = 65535;
+static  const  uint         PCAP_FILE_HDR_SIZE      = 24;
+static  const  uint         PCAP_REC_HDR_SIZE       = 16;
+
+static  const  uint         PCW_MAX_REC_SIZE        = PCAP_REC_HDR_SIZE + PCW_LORATAP_HDR_SIZE + RH_RF95_MAX_PAYLOAD_LEN;
+
+
+
+//---------------------------------------------------------------------------
+//  Macro definitions
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+//  Only used by the main loop, so no locking is necessary. Frames are collected
+//  in the preallocated buffer and written with a single write() if the buffer
+//  is full, the file is rotated or PcwService() detects that the oldest frame
+//  has been waiting for more than PCW_DEF_FLUSH_TIME_MS.
+static  char            szFileNameBase_l[256];
+static  char            szFileName_l[272];
+static  int             iFdCaptureFile_l        = -1;
+static  uint64_t        ui64MaxFileSize_l       = 0;
+static  uint64_t        ui64FileSize_l          = 0;
+static  uint            uiFileIndex_l           = 0;
+static  int64_t         i64MonoToRealUs_l       = 0;
+
+static  uint8_t*        pabBuffer_l             = NULL;
+static  uint            uiBuffLevel_l           = 0;
+static  uint            uiBuffFrames_l          = 0;
+static  uint64_t        ui64BuffFirstUs_l       = 0;
+
+static  tPcwStatistics  PcwStatistics_l;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  int   PcwOpenFile (void);
+
+static  void  PcwBuildFileName (
+    uint uiFileIndex_p,
+    char* pszFileName_p,
+    size_t nFileNameSize_p);
+
+static  inline  uint8_t*  PcwPutLe16 (uint8_t* pabBuff_p, uint16_t ui16Value_p);
+static  inline  uint8_t*  PcwPutLe32 (uint8_t* pabBuff_p, uint32_t ui32Value_p);
+static  inline  uint8_t*  PcwPutBe16 (uint8_t* pabBuff_p, uint16_t ui16Value_p);
+static  inline  uint8_t*  PcwPutBe32 (uint8_t* pabBuff_p, uint32_t ui32Value_p);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Open CaptureFile
+//---------------------------------------------------------------------------
+//  Without rotation the file is created with the given name. With rotation
+//  by size a 4-digit file number is inserted in front of the file extension
+//  ('capture.pcap' -> 'capture_0000.pcap', 'capture_0001.pcap', ...),
+//  numbering continues after the highest existing file of a previous run
+//  and wraps around after PCW_MAX_FILE_INDEX.
+
+int  PcwOpen (
+    const char* pszCaptureFileName_p,                   // [IN]     Path/Name of CaptureFile
+    uint64_t ui64MaxFileSize_p)                         // [IN]     Max. Size of each File [bytes] (0 = no rotation)
+{
+
+struct stat  FileStat;
+int          iRes;
+
+
+    if ((pszCaptureFileName_p == NULL) || (strlen(pszCaptureFileName_p) >= sizeof(szFileNameBase_l)))
+    {
+        return (-1);
+    }
+    if ((ui64MaxFileSize_p != 0) && (ui64MaxFileSize_p < (PCAP_FILE_HDR_SIZE + PCW_MAX_REC_SIZE)))
+    {
+        return (-1);
+    }
+    if (iFdCaptureFile_l >= 0)
+    {
+        return (-2);
+    }
+
+    memset(&PcwStatistics_l, 0, sizeof(PcwStatistics_l));
+    strcpy(szFileNameBase_l, pszCaptureFileName_p);
+    ui64MaxFileSize_l = ui64MaxFileSize_p;
+
+    // allocate and touch write buffer in advance, so that no page faults
+    // occur later on (in real-time mode the memory is locked afterwards)
+    pabBuffer_l = (uint8_t*)malloc(PCW_DEF_BUFFER_SIZE);
+    if (pabBuffer_l == NULL)
+    {
+        return (-3);
+    }
+    memset(pabBuffer_l, 0, PCW_DEF_BUFFER_SIZE);
+    uiBuffLevel_l  = 0;
+    uiBuffFrames_l = 0;
+
+    // continue numbering after files of a previous run
+    uiFileIndex_l = 0;
+    if (ui64MaxFileSize_l != 0)
+    {
+        for (uiFileIndex_l=PCW_MAX_FILE_INDEX+1; uiFileIndex_l>0; uiFileIndex_l--)
+        {
+            PcwBuildFileName(uiFileIndex_l-1, szFileName_l, sizeof(szFileName_l));
+            if (stat(szFileName_l, &FileStat) == 0)
+            {
+                break;
+            }
+        }
+        if (uiFileIndex_l > PCW_MAX_FILE_INDEX)
+        {
+            uiFileIndex_l = 0;
+        }
+    }
+
+    iRes = PcwOpenFile();
+    if (iRes < 0)
+    {
+        free(pabBuffer_l);
+        pabBuffer_l = NULL;
+        return (-4);
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Close CaptureFile
+//---------------------------------------------------------------------------
+
+int  PcwClose (void)
+{
+
+    if (iFdCaptureFile_l < 0)
+    {
+        return (-1);
+    }
+
+    PcwFlush();
+
+    close(iFdCaptureFile_l);
+    iFdCaptureFile_l = -1;
+
+    free(pabBuffer_l);
+    pabBuffer_l = NULL;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Write received Frame to CaptureFile
+//---------------------------------------------------------------------------
+//  The frame is only copied into the write buffer, file I/O happens if the
+//  buffer is full or the file has to be rotated. The timestamp is the DIO0
+//  interrupt time converted from the monotonic to the real-time clock.
+//
+//  Record layout: pcap Record Header (little endian, as the File Header)
+//  followed by the LoRaTap Version 0 Header (big endian) and the raw frame:
+//
+//    Offs  Size  LoRaTap Field
+//      0     1   lt_version        0
+//      1     1   lt_padding        0
+//      2     2   lt_length         15
+//      4     4   frequency         [Hz]
+//      8     1   bandwidth         [125 kHz]
+//      9     1   sf                7..12
+//     10     1   packet_rssi       RSSI + 139 [dBm]
+//     11     1   max_rssi          (RF95 only provides the packet RSSI)
+//     12     1   current_rssi      (RF95 only provides the packet RSSI)
+//     13     1   snr               [0.25 dB]
+//     14     1   sync_word
+
+int  PcwWriteFrame (
+    const tRxqFrame* pRxFrame_p,                        // [IN]     Ptr to received Frame
+    uint32_t ui32FrequencyHz_p,                         // [IN]     Centre Frequency of Radio [Hz]
+    uint uiBandwidthKHz_p,                              // [IN]     Bandwidth of Radio [kHz]
+    uint uiSpreadFactor_p)                              // [IN]     Spreading Factor of Radio
+{
+
+uint8_t*  pabRec;
+uint64_t  ui64RealTimeUs;
+uint      uiDataLen;
+uint      uiRecSize;
+int       iRssi;
+uint8_t   ui8Rssi;
+int       iRes;
+
+
+    if (pRxFrame_p == NULL)
+    {
+        return (-1);
+    }
+    if (iFdCaptureFile_l < 0)
+    {
+        return (-2);
+    }
+
+    uiDataLen = pRxFrame_p->m_uiDataLen;
+    if (uiDataLen > RH_RF95_MAX_PAYLOAD_LEN)
+    {
+        uiDataLen = RH_RF95_MAX_PAYLOAD_LEN;
+    }
+    uiRecSize = PCAP_REC_HDR_SIZE + PCW_LORATAP_HDR_SIZE + uiDataLen;
+
+    // rotate file if the record doesn't fit any longer (each file gets at least one record)
+    if ((ui64MaxFileSize_l != 0) &&
+        ((ui64FileSize_l + uiBuffLevel_l + uiRecSize) > ui64MaxFileSize_l) &&
+        ((ui64FileSize_l + uiBuffLevel_l) > PCAP_FILE_HDR_SIZE))
+    {
+        PcwFlush();
+        close(iFdCaptureFile_l);
+        iFdCaptureFile_l = -1;
+        if (uiFileIndex_l > PCW_MAX_FILE_INDEX)
+        {
+            uiFileIndex_l = 0;                          // wrap around, oldest files are overwritten
+        }
+        iRes = PcwOpenFile();
+        if (iRes < 0)
+        {
+            PcwStatistics_l.m_uiFramesLost++;
+            return (-3);
+        }
+    }
+
+    if ((uiBuffLevel_l + uiRecSize) > PCW_DEF_BUFFER_SIZE)
+    {
+        PcwFlush();
+    }
+    if (uiBuffLevel_l == 0)
+    {
+        ui64BuffFirstUs_l = pRxFrame_p->m_ui64ReadTimeUs;
+    }
+
+    ui64RealTimeUs = (uint64_t)((int64_t)pRxFrame_p->m_ui64WakeTimeUs + i64MonoToRealUs_l);
+    iRssi = (int)pRxFrame_p->m_i8Rssi + 139;
+    ui8Rssi = (uint8_t)((iRssi < 0) ? 0 : ((iRssi > 255) ? 255 : iRssi));
+
+    // pcap Record Header
+    pabRec = &pabBuffer_l[uiBuffLevel_l];
+    pabRec = PcwPutLe32(pabRec, (uint32_t)(ui64RealTimeUs / 1000000));
+    pabRec = PcwPutLe32(pabRec, (uint32_t)(ui64RealTimeUs % 1000000));
+    pabRec = PcwPutLe32(pabRec, PCW_LORATAP_HDR_SIZE + uiDataLen);
+    pabRec = PcwPutLe32(pabRec, PCW_LORATAP_HDR_SIZE + uiDataLen);
+
+    // LoRaTap Header
+    *pabRec++ = 0;
+    *pabRec++ = 0;
+    pabRec = PcwPutBe16(pabRec, PCW_LORATAP_HDR_SIZE);
+    pabRec = PcwPutBe32(pabRec, ui32FrequencyHz_p);
+    *pabRec++ = (uint8_t)(uiBandwidthKHz_p / 125);
+    *pabRec++ = (uint8_t)uiSpreadFactor_p;
+    *pabRec++ = ui8Rssi;
+    *pabRec++ = ui8Rssi;
+    *pabRec++ = ui8Rssi;
+    *pabRec++ = (uint8_t)pRxFrame_p->m_i8Snr;
+    *pabRec++ = PCW_LORA_SYNC_WORD;
+
+    // raw LoRa frame
+    memcpy(pabRec, pRxFrame_p->m_abData, uiDataLen);
+
+    uiBuffLevel_l += uiRecSize;
+    uiBuffFrames_l++;
+    PcwStatistics_l.m_uiFramesWritten++;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Flush Write Buffer if its oldest Frame is waiting too long
+//---------------------------------------------------------------------------
+//  Called cyclically by the main loop, so that a capture which is copied
+//  or analysed while the receiver is running is never older than
+//  PCW_DEF_FLUSH_TIME_MS.
+
+int  PcwService (
+    uint64_t ui64NowUs_p)                               // [IN]     Current Time (see RtmGetTimeUs())
+{
+
+    if ((iFdCaptureFile_l < 0) || (uiBuffLevel_l == 0))
+    {
+        return (0);
+    }
+    if ((ui64BuffFirstUs_l + ((uint64_t)PCW_DEF_FLUSH_TIME_MS * 1000)) > ui64NowUs_p)
+    {
+        return (0);
+    }
+
+    return (PcwFlush());
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Write Buffer to CaptureFile
+//---------------------------------------------------------------------------
+
+int  PcwFlush (void)
+{
+
+uint     uiOffs;
+ssize_t  iRes;
+
+
+    if (iFdCaptureFile_l < 0)
+    {
+        return (-1);
+    }
+    if (uiBuffLevel_l == 0)
+    {
+        return (0);
+    }
+
+    uiOffs = 0;
+    while (uiOffs < uiBuffLevel_l)
+    {
+        iRes = write(iFdCaptureFile_l, &pabBuffer_l[uiOffs], uiBuffLevel_l - uiOffs);
+        if (iRes < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        uiOffs += (uint)iRes;
+    }
+    TRACE3("\nFlush CaptureFile: uiBuffLevel_l=%u, uiBuffFrames_l=%u -> uiOffs=%u\n", uiBuffLevel_l, uiBuffFrames_l, uiOffs);
+
+    ui64FileSize_l += uiOffs;
+    PcwStatistics_l.m_ui64BytesWritten += uiOffs;
+    PcwStatistics_l.m_uiBufferFlushes++;
+    if (uiOffs < uiBuffLevel_l)
+    {
+        // a partially written record can't be repaired, count all frames of the buffer as lost
+        PcwStatistics_l.m_uiFramesLost += uiBuffFrames_l;
+        uiBuffLevel_l  = 0;
+        uiBuffFrames_l = 0;
+        return (-2);
+    }
+
+    uiBuffLevel_l  = 0;
+    uiBuffFrames_l = 0;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Name of current CaptureFile
+//---------------------------------------------------------------------------
+
+const char*  PcwGetFileName (void)
+{
+
+    return (szFileName_l);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Statistics
+//---------------------------------------------------------------------------
+
+void  PcwGetStatistics (
+    tPcwStatistics* pStatistics_p)                      // [OUT]    Ptr to Statistics
+{
+
+    memcpy(pStatistics_p, &PcwStatistics_l, sizeof(tPcwStatistics));
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Print Statistics
+//---------------------------------------------------------------------------
+
+void  PcwPrintStatistics (void)
+{
+
+    printf("Raw Frame Capture:\n");
+    printf("  Frames captured   = %u\n", PcwStatistics_l.m_uiFramesWritten);
+    printf("  Frames lost       = %u\n", PcwStatistics_l.m_uiFramesLost);
+    printf("  Files created     = %u\n", PcwStatistics_l.m_uiFilesCreated);
+    printf("  Buffer flushes    = %u\n", PcwStatistics_l.m_uiBufferFlushes);
+    printf("  Bytes written     = %llu\n", (unsigned long long)PcwStatistics_l.m_ui64BytesWritten);
+
+    return;
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Create next CaptureFile and write pcap File Header
+//---------------------------------------------------------------------------
+
+static  int  PcwOpenFile (void)
+{
+
+struct timespec  TimeSpec;
+uint8_t          abFileHdr[PCAP_FILE_HDR_SIZE];
+uint8_t*         pabHdr;
+mode_t           OpenMode;
+ssize_t          iRes;
+
+
+    PcwBuildFileName(uiFileIndex_l, szFileName_l, sizeof(szFileName_l));
+    uiFileIndex_l++;
+
+    OpenMode = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
+
+    iFdCaptureFile_l = open(szFileName_l, (O_CREAT | O_WRONLY | O_TRUNC), OpenMode);
+    TRACE2("\nOpen CaptureFile: szFileName_l='%s' -> iFdCaptureFile_l=%d\n", szFileName_l, iFdCaptureFile_l);
+    if (iFdCaptureFile_l < 0)
+    {
+        return (-1);
+    }
+
+    // the offset between both clocks changes with NTP corrections,
+    // so it's updated with each new file
+    clock_gettime(CLOCK_REALTIME, &TimeSpec);
+    i64MonoToRealUs_l = ((int64_t)TimeSpec.tv_sec * 1000000 + TimeSpec.tv_nsec / 1000) - (int64_t)RtmGetTimeUs();
+
+    pabHdr = abFileHdr;
+    pabHdr = PcwPutLe32(pabHdr, PCAP_MAGIC_NUMBER);
+    pabHdr = PcwPutLe16(pabHdr, PCAP_VERSION_MAJOR);
+    pabHdr = PcwPutLe16(pabHdr, PCAP_VERSION_MINOR);
+    pabHdr = PcwPutLe32(pabHdr, 0);                     // thiszone (GMT)
+    pabHdr = PcwPutLe32(pabHdr, 0);                     // sigfigs
+    pabHdr = PcwPutLe32(pabHdr, PCAP_SNAPLEN);
+    pabHdr = PcwPutLe32(pabHdr, PCW_LINKTYPE_LORATAP);
+
+    iRes = write(iFdCaptureFile_l, abFileHdr, sizeof(abFileHdr));
+    if (iRes != (ssize_t)sizeof(abFileHdr))
+    {
+        close(iFdCaptureFile_l);
+        iFdCaptureFile_l = -1;
+        return (-2);
+    }
+
+    ui64FileSize_l = sizeof(abFileHdr);
+    PcwStatistics_l.m_ui64BytesWritten += sizeof(abFileHdr);
+    PcwStatistics_l.m_uiFilesCreated++;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Build Name of CaptureFile
+//---------------------------------------------------------------------------
+
+static  void  PcwBuildFileName (
+    uint uiFileIndex_p,
+    char* pszFileName_p,
+    size_t nFileNameSize_p)
+{
+
+const char*  pszExt;
+const char*  pszDir;
+
+
+    if (ui64MaxFileSize_l == 0)
+    {
+        snprintf(pszFileName_p, nFileNameSize_p, "%s", szFileNameBase_l);
+        return;
+    }
+
+    // insert file number in front of extension (only in the file name itself, not in the path)
+    pszExt = strrchr(szFileNameBase_l, '.');
+    pszDir = strrchr(szFileNameBase_l, '/');
+    if ((pszExt == NULL) || ((pszDir != NULL) && (pszExt < pszDir)) || (pszExt == szFileNameBase_l) || (pszExt == pszDir+1))
+    {
+        snprintf(pszFileName_p, nFileNameSize_p, "%s_%04u", szFileNameBase_l, uiFileIndex_p);
+    }
+    else
+    {
+        snprintf(pszFileName_p, nFileNameSize_p, "%.*s_%04u%s", (int)(pszExt - szFileNameBase_l), szFileNameBase_l, uiFileIndex_p, pszExt);
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Store Values in defined Byte Order
+//---------------------------------------------------------------------------
+
+static  inline  uint8_t*  PcwPutLe16 (uint8_t* pabBuff_p, uint16_t ui16Value_p)
+{
+
+    pabBuff_p[0] = (uint8_t)(ui16Value_p);
+    pabBuff_p[1] = (uint8_t)(ui16Value_p >> 8);
+
+    return (pabBuff_p + 2);
+
+}
+
+
+static  inline  uint8_t*  PcwPutLe32 (uint8_t* pabBuff_p, uint32_t ui32Value_p)
+{
+
+    pabBuff_p[0] = (uint8_t)(ui32Value_p);
+    pabBuff_p[1] = (uint8_t)(ui32Value_p >> 8);
+    pabBuff_p[2] = (uint8_t)(ui32Value_p >> 16);
+    pabBuff_p[3] = (uint8_t)(ui32Value_p >> 24);
+
+    return (pabBuff_p + 4);
+
+}
+
+
+static  inline  uint8_t*  PcwPutBe16 (uint8_t* pabBuff_p, uint16_t ui16Value_p)
+{
+
+    pabBuff_p[0] = (uint8_t)(ui16Value_p >> 8);
+    pabBuff_p[1] = (uint8_t)(ui16Value_p);
+
+    return (pabBuff_p + 2);
+
+}
+
+
+static  inline  uint8_t*  PcwPutBe32 (uint8_t* pabBuff_p, uint32_t ui32Value_p)
+{
+
+    pabBuff_p[0] = (uint8_t)(ui32Value_p >> 24);
+    pabBuff_p[1] = (uint8_t)(ui32Value_p >> 16);
+    pabBuff_p[2] = (uint8_t)(ui32Value_p >> 8);
+    pabBuff_p[3] = (uint8_t)(ui32Value_p);
+
+    return (pabBuff_p + 4);
+
+}
+
+
+
+
+// EOF
+
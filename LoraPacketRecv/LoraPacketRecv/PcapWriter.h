@@ -0,0 +1,85 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Declarations for Raw Frame Capture (pcap with LoRaTap Header)
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _PCAPWRITER_H_
+#define _PCAPWRITER_H_
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+const  uint  PCW_DEF_BUFFER_SIZE    = 64 * 1024;    // preallocated write buffer [bytes]
+const  uint  PCW_DEF_FLUSH_TIME_MS  = 1000;         // max. time a frame stays in the write buffer [ms]
+const  uint  PCW_MAX_FILE_INDEX     = 9999;         // highest file number with rotation by size
+
+const  uint  PCW_LINKTYPE_LORATAP   = 270;          // LINKTYPE_LORATAP (www.tcpdump.org/linktypes.html)
+const  uint  PCW_LORATAP_HDR_SIZE   = 15;           // LoRaTap Version 0 Header
+const  uint  PCW_LORA_SYNC_WORD     = 0x12;         // private network (RadioHead default)
+
+
+
+//---------------------------------------------------------------------------
+//  Type definitions
+//---------------------------------------------------------------------------
+
+typedef struct
+{
+    uint                m_uiFramesWritten;          // frames passed to the write buffer
+    uint                m_uiFramesLost;             // frames lost because of write errors
+    uint                m_uiFilesCreated;
+    uint                m_uiBufferFlushes;
+    uint64_t            m_ui64BytesWritten;
+
+} tPcwStatistics;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of public functions
+//---------------------------------------------------------------------------
+
+int   PcwOpen (
+    const char* pszCaptureFileName_p,                   // [IN]     Path/Name of CaptureFile
+    uint64_t ui64MaxFileSize_p);                        // [IN]     Max. Size of each File [bytes] (0 = no rotation)
+
+int   PcwClose (void);
+
+int   PcwWriteFrame (
+    const tRxqFrame* pRxFrame_p,                        // [IN]     Ptr to received Frame
+    uint32_t ui32FrequencyHz_p,                         // [IN]     Centre Frequency of Radio [Hz]
+    uint uiBandwidthKHz_p,                              // [IN]     Bandwidth of Radio [kHz]
+    uint uiSpreadFactor_p);                             // [IN]     Spreading Factor of Radio
+
+int   PcwService (
+    uint64_t ui64NowUs_p);                              // [IN]     Current Time (see RtmGetTimeUs())
+
+int   PcwFlush (void);
+
+const char*  PcwGetFileName (void);
+
+void  PcwGetStatistics (
+    tPcwStatistics* pStatistics_p);                     // [OUT]    Ptr to Statistics
+
+void  PcwPrintStatistics (void);
+
+
+
+#endif  // #ifndef _PCAPWRITER_H_
+
+
+// EOF
+
@@ -0,0 +1,478 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Implementation of Cross-Radio Packet Deduplication
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Header Fields via <LoraPacketSchema.h> instead of Bitfields
+
+****************************************************************************/
+
+#include <RH_RF95.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "LoraPacket.h"
+#include "LoraPacketSchema.h"
+#include "RxQueue.h"
+#include "RadioDedup.h"
+#include "Trace.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Macro definitions
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+typedef enum
+{
+    kRddEntryFree               = 0,
+    kRddEntryPending            = 1,                    // waiting for further copies
+    kRddEntryForwarded          = 2                     // best copy already forwarded
+
+} tRddEntryState;
+
+
+typedef struct
+{
+    tRddEntryState      m_State;
+    bool                m_fKeyValid;                    // false -> frame without (DevID, SequNum)
+    uint8_t             m_ui8PacketType;
+    uint8_t             m_ui8DevID;
+    uint32_t            m_ui32SequNum;                  // SequNum (DataPacket) or CRC16 of Header (BootupPacket)
+    uint64_t            m_ui64FirstRxUs;                // arrival of first copy
+    tRxqFrame           m_Frame;                        // copy with best RSSI so far
+
+} tRddEntry;
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+//  Only used by the main loop, so no locking is necessary. The table is small
+//  (a few packets per cycle time), a linear search is cheaper than any index.
+static  tRddEntry       aRddEntry_l[RDD_MAX_ENTRIES];
+static  uint64_t        ui64HoldTimeUs_l        = 0;
+static  uint64_t        ui64HistoryTimeUs_l     = 0;
+static  tRddStatistics  RddStatistics_l;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  bool  RddGetFrameKey (
+    const tRxqFrame* pRxFrame_p,
+    uint8_t* pui8PacketType_p,
+    uint8_t* pui8DevID_p,
+    uint32_t* pui32SequNum_p);
+
+static  tRddEntry*  RddAllocEntry (
+    uint64_t ui64NowUs_p);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Initialize Deduplication
+//---------------------------------------------------------------------------
+//  A hold time of 0 forwards each frame immediately (single radio), only
+//  late copies of an already forwarded packet are rejected.
+
+int  RddInitialize (
+    uint uiHoldTimeMs_p)                                // [IN]     Hold Time for pending Frames [ms]
+{
+
+    memset(aRddEntry_l, 0, sizeof(aRddEntry_l));
+    memset(&RddStatistics_l, 0, sizeof(RddStatistics_l));
+
+    ui64HoldTimeUs_l    = (uint64_t)uiHoldTimeMs_p * 1000;
+    ui64HistoryTimeUs_l = (uint64_t)uiHoldTimeMs_p * 1000 * 10;
+    if (ui64HistoryTimeUs_l < ((uint64_t)RDD_MIN_HISTORY_MS * 1000))
+    {
+        ui64HistoryTimeUs_l = (uint64_t)RDD_MIN_HISTORY_MS * 1000;
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Add received Frame
+//---------------------------------------------------------------------------
+//  Return:  0 = new packet, held back until hold time is elapsed
+//           1 = copy of pending packet (merged, best RSSI is kept)
+//           2 = late copy of already forwarded packet (discarded)
+//          <0 = table full, frame has to be processed by the caller directly
+
+int  RddAddFrame (
+    const tRxqFrame* pRxFrame_p,                        // [IN]     Ptr to received Frame
+    uint64_t ui64NowUs_p)                               // [IN]     Current Time (see RtmGetTimeUs())
+{
+
+tRddEntry*  pEntry;
+uint8_t     ui8PacketType;
+uint8_t     ui8DevID;
+uint32_t    ui32SequNum;
+bool        fKeyValid;
+uint        uiRadioMask;
+uint        uiRxPacketCntr;
+uint        uiIdx;
+
+
+    RddStatistics_l.m_uiFramesIn++;
+
+    fKeyValid = RddGetFrameKey(pRxFrame_p, &ui8PacketType, &ui8DevID, &ui32SequNum);
+    if ( fKeyValid )
+    {
+        for (uiIdx=0; uiIdx<RDD_MAX_ENTRIES; uiIdx++)
+        {
+            pEntry = &aRddEntry_l[uiIdx];
+            if ((pEntry->m_State == kRddEntryFree) || !pEntry->m_fKeyValid)
+            {
+                continue;
+            }
+            if ((pEntry->m_ui8PacketType != ui8PacketType) ||
+                (pEntry->m_ui8DevID      != ui8DevID)      ||
+                (pEntry->m_ui32SequNum   != ui32SequNum))
+            {
+                continue;
+            }
+
+            if (pEntry->m_State == kRddEntryForwarded)
+            {
+                TRACE3("RddAddFrame: late copy DevID=%u, SequNum=%u (Radio %u) discarded\n", (uint)ui8DevID, ui32SequNum, pRxFrame_p->m_uiRadio);
+                RddStatistics_l.m_uiLateDuplicates++;
+                return (2);
+            }
+
+            // copy of pending packet -> keep the one with best RSSI
+            RddStatistics_l.m_uiDuplicates++;
+            pEntry->m_Frame.m_uiRadioMask |= (1u << pRxFrame_p->m_uiRadio);
+            if (pRxFrame_p->m_i8Rssi > pEntry->m_Frame.m_i8Rssi)
+            {
+                uiRadioMask    = pEntry->m_Frame.m_uiRadioMask;
+                uiRxPacketCntr = pEntry->m_Frame.m_uiRxPacketCntr;
+                memcpy(&pEntry->m_Frame, pRxFrame_p, sizeof(tRxqFrame));
+                pEntry->m_Frame.m_uiRadioMask    = uiRadioMask;
+                pEntry->m_Frame.m_uiRxPacketCntr = uiRxPacketCntr;
+                RddStatistics_l.m_uiBetterRssi++;
+            }
+            return (1);
+        }
+    }
+
+    // first copy of packet
+    pEntry = RddAllocEntry(ui64NowUs_p);
+    if (pEntry == NULL)
+    {
+        RddStatistics_l.m_uiOverflows++;
+        return (-1);
+    }
+
+    pEntry->m_State         = kRddEntryPending;
+    pEntry->m_fKeyValid     = fKeyValid;
+    pEntry->m_ui8PacketType = ui8PacketType;
+    pEntry->m_ui8DevID      = ui8DevID;
+    pEntry->m_ui32SequNum   = ui32SequNum;
+    pEntry->m_ui64FirstRxUs = ui64NowUs_p;
+    memcpy(&pEntry->m_Frame, pRxFrame_p, sizeof(tRxqFrame));
+    pEntry->m_Frame.m_uiRadioMask = (1u << pRxFrame_p->m_uiRadio);
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get next Frame whose Hold Time has elapsed
+//---------------------------------------------------------------------------
+//  Frames are returned in order of arrival of their first copy.
+
+bool  RddGetReadyFrame (
+    tRxqFrame* pRxFrame_p,                              // [OUT]    Ptr to Buffer for Frame
+    uint64_t ui64NowUs_p)                               // [IN]     Current Time (see RtmGetTimeUs())
+{
+
+tRddEntry*  pEntry;
+tRddEntry*  pOldestEntry;
+uint        uiIdx;
+
+
+    pOldestEntry = NULL;
+    for (uiIdx=0; uiIdx<RDD_MAX_ENTRIES; uiIdx++)
+    {
+        pEntry = &aRddEntry_l[uiIdx];
+        if (pEntry->m_State != kRddEntryPending)
+        {
+            continue;
+        }
+        if ((pEntry->m_ui64FirstRxUs + ui64HoldTimeUs_l) > ui64NowUs_p)
+        {
+            continue;
+        }
+        if ((pOldestEntry == NULL) || (pEntry->m_ui64FirstRxUs < pOldestEntry->m_ui64FirstRxUs))
+        {
+            pOldestEntry = pEntry;
+        }
+    }
+
+    if (pOldestEntry == NULL)
+    {
+        return (false);
+    }
+
+    memcpy(pRxFrame_p, &pOldestEntry->m_Frame, sizeof(tRxqFrame));
+
+    // frames without key can't be recognized again, so there is no need to remember them
+    pOldestEntry->m_State = (pOldestEntry->m_fKeyValid) ? kRddEntryForwarded : kRddEntryFree;
+    RddStatistics_l.m_uiFramesOut++;
+
+    return (true);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Timeout until next pending Frame gets ready (for poll())
+//---------------------------------------------------------------------------
+
+int  RddGetTimeout (
+    uint64_t ui64NowUs_p,                               // [IN]     Current Time (see RtmGetTimeUs())
+    int iMaxTimeoutMs_p)                                // [IN]     Timeout if no Frame is pending [ms]
+{
+
+uint64_t  ui64ReadyUs;
+int       iTimeoutMs;
+uint      uiIdx;
+
+
+    iTimeoutMs = iMaxTimeoutMs_p;
+    for (uiIdx=0; uiIdx<RDD_MAX_ENTRIES; uiIdx++)
+    {
+        if (aRddEntry_l[uiIdx].m_State != kRddEntryPending)
+        {
+            continue;
+        }
+
+        ui64ReadyUs = aRddEntry_l[uiIdx].m_ui64FirstRxUs + ui64HoldTimeUs_l;
+        if (ui64ReadyUs <= ui64NowUs_p)
+        {
+            return (0);
+        }
+        if ((int)((ui64ReadyUs - ui64NowUs_p + 999) / 1000) < iTimeoutMs)
+        {
+            iTimeoutMs = (int)((ui64ReadyUs - ui64NowUs_p + 999) / 1000);
+        }
+    }
+
+    return (iTimeoutMs);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Statistics
+//---------------------------------------------------------------------------
+
+void  RddGetStatistics (
+    tRddStatistics* pStatistics_p)                      // [OUT]    Ptr to Statistics
+{
+
+    memcpy(pStatistics_p, &RddStatistics_l, sizeof(tRddStatistics));
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Print Statistics
+//---------------------------------------------------------------------------
+
+void  RddPrintStatistics (void)
+{
+
+    printf("Cross-Radio Deduplication:\n");
+    printf("  Frames received   = %u\n", RddStatistics_l.m_uiFramesIn);
+    printf("  Frames forwarded  = %u\n", RddStatistics_l.m_uiFramesOut);
+    printf("  Copies merged     = %u (better RSSI: %u)\n", RddStatistics_l.m_uiDuplicates, RddStatistics_l.m_uiBetterRssi);
+    printf("  Late copies       = %u\n", RddStatistics_l.m_uiLateDuplicates);
+    printf("  Table overflows   = %u\n", RddStatistics_l.m_uiOverflows);
+
+    return;
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Get identification of LoRa Packet
+//---------------------------------------------------------------------------
+//  DataPackets are identified by (DevID, SequNum). BootupPackets have no
+//  SequNum, here the CRC16 of the Header is used instead - all copies of the
+//  same transmission are bitwise identical.
+
+static  bool  RddGetFrameKey (
+    const tRxqFrame* pRxFrame_p,
+    uint8_t* pui8PacketType_p,
+    uint8_t* pui8DevID_p,
+    uint32_t* pui32SequNum_p)
+{
+
+const tLoraDataHeader*  pLoraHeader;
+
+
+    *pui8PacketType_p = 0;
+    *pui8DevID_p      = 0;
+    *pui32SequNum_p   = 0;
+
+    if (pRxFrame_p->m_uiDataLen < sizeof(tLoraDataHeader))
+    {
+        return (false);
+    }
+
+    pLoraHeader = (const tLoraDataHeader*)pRxFrame_p->m_abData;
+    *pui8PacketType_p = (uint8_t)LoraDataHeaderField<kLoraHeaderPacketType>::Get(pLoraHeader);
+    *pui8DevID_p      = (uint8_t)LoraDataHeaderField<kLoraHeaderDevID>::Get(pLoraHeader);
+
+    switch (*pui8PacketType_p)
+    {
+        case kLoraPacketDataHeader:
+        case kLoraPacketDataHeaderDelta:
+        case kLoraPacketDataHeaderCompact:
+        {
+            *pui32SequNum_p = LoraDataHeaderField<kLoraHeaderSequNum>::Get(pLoraHeader);
+            break;
+        }
+
+        case kLoraPacketBootup:
+        {
+            *pui32SequNum_p = (uint32_t)LoraGetCrc16(pLoraHeader->m_abCRC16);
+            break;
+        }
+
+        default:
+        {
+            return (false);
+        }
+    }
+
+    return (true);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Allocate free Table Entry
+//---------------------------------------------------------------------------
+
+static  tRddEntry*  RddAllocEntry (
+    uint64_t ui64NowUs_p)
+{
+
+tRddEntry*  pEntry;
+tRddEntry*  pOldestEntry;
+uint        uiIdx;
+
+
+    pOldestEntry = NULL;
+    for (uiIdx=0; uiIdx<RDD_MAX_ENTRIES; uiIdx++)
+    {
+        pEntry = &aRddEntry_l[uiIdx];
+
+        // expire forwarded packets after history time
+        if ((pEntry->m_State == kRddEntryForwarded) &&
+            ((pEntry->m_ui64FirstRxUs + ui64HistoryTimeUs_l) <= ui64NowUs_p))
+        {
+            pEntry->m_State = kRddEntryFree;
+        }
+
+        if (pEntry->m_State == kRddEntryFree)
+        {
+            return (pEntry);
+        }
+        if (pEntry->m_State == kRddEntryForwarded)
+        {
+            if ((pOldestEntry == NULL) || (pEntry->m_ui64FirstRxUs < pOldestEntry->m_ui64FirstRxUs))
+            {
+                pOldestEntry = pEntry;
+            }
+        }
+    }
+
+    // no free entry -> reuse the oldest forwarded packet (pending packets are never dropped)
+    return (pOldestEntry);
+
+}
+
+
+
+// EOF
+
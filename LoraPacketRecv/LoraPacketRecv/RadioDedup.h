@@ -0,0 +1,78 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Declarations for Cross-Radio Packet Deduplication
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _RADIODEDUP_H_
+#define _RADIODEDUP_H_
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+const  uint  RDD_DEF_HOLD_TIME_MS   = 200;      // time to wait for copies of a packet from further radios [ms]
+const  uint  RDD_MIN_HISTORY_MS     = 2000;     // time to remember forwarded packets to reject late copies [ms]
+const  uint  RDD_MAX_ENTRIES        = 32;
+
+
+
+//---------------------------------------------------------------------------
+//  Type definitions
+//---------------------------------------------------------------------------
+
+typedef struct
+{
+    uint                m_uiFramesIn;               // frames passed to RddAddFrame()
+    uint                m_uiFramesOut;              // frames returned by RddGetReadyFrame()
+    uint                m_uiDuplicates;             // copies merged into a pending frame
+    uint                m_uiBetterRssi;             // copies which replaced the pending frame because of a better RSSI
+    uint                m_uiLateDuplicates;         // copies received after the frame was already forwarded
+    uint                m_uiOverflows;              // frames not deduplicated because of a full table
+
+} tRddStatistics;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of public functions
+//---------------------------------------------------------------------------
+
+int   RddInitialize (
+    uint uiHoldTimeMs_p);                               // [IN]     Hold Time for pending Frames [ms]
+
+int   RddAddFrame (
+    const tRxqFrame* pRxFrame_p,                        // [IN]     Ptr to received Frame
+    uint64_t ui64NowUs_p);                              // [IN]     Current Time (see RtmGetTimeUs())
+
+bool  RddGetReadyFrame (
+    tRxqFrame* pRxFrame_p,                              // [OUT]    Ptr to Buffer for Frame
+    uint64_t ui64NowUs_p);                              // [IN]     Current Time (see RtmGetTimeUs())
+
+int   RddGetTimeout (
+    uint64_t ui64NowUs_p,                               // [IN]     Current Time (see RtmGetTimeUs())
+    int iMaxTimeoutMs_p);                               // [IN]     Timeout if no Frame is pending [ms]
+
+void  RddGetStatistics (
+    tRddStatistics* pStatistics_p);                     // [OUT]    Ptr to Statistics
+
+void  RddPrintStatistics (void);
+
+
+
+#endif  // #ifndef _RADIODEDUP_H_
+
+
+// EOF
+
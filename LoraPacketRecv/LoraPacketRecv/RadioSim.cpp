@@ -0,0 +1,482 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Implementation of Simulation of LoRa Nodes and Radios
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Packets built via <LoraPacketSchema.h> instead of Bitfields
+
+****************************************************************************/
+
+#include <RH_RF95.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <atomic>
+#include <thread>
+#include "LoraPacket.h"
+#include "LoraPacketSchema.h"
+#include "LibRf95.h"
+#include "RadioSim.h"
+#include "BinaryLogger.h"
+#include "Trace.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+const  uint  RSM_MAX_DEVICES        = 15;       // DevID 1..15
+
+
+
+//---------------------------------------------------------------------------
+//  Macro definitions
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+typedef struct
+{
+    uint8_t             m_ui8DevID;
+    uint32_t            m_ui32SequNum;
+    uint32_t            m_ui32Uptime;                   // [sec]
+    uint                m_uiMotionCount;
+    tLoraDataPacket     m_TxLoraDataPacket;             // keeps DataRec generations between packets
+
+} tRsmDevice;
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+static  std::thread         RsmThread_l;
+static  std::atomic<bool>   fRsmRun_l (false);
+static  uint                uiRadioCount_l      = 0;
+static  uint                uiDevCount_l        = 0;
+static  uint                uiCycleTimeMs_l     = 0;
+static  unsigned int        uiRandSeed_l        = 0;
+static  tRsmDevice          aRsmDevice_l[RSM_MAX_DEVICES];
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  void  RsmThread (void);
+
+static  void  RsmBuildBootupPacket (
+    tRsmDevice* pDevice_p,
+    tLoraDataPacket* pLoraPacket_p);
+
+static  void  RsmBuildDataPacket (
+    tRsmDevice* pDevice_p);
+
+static  void  RsmTransmit (
+    tRsmDevice* pDevice_p,
+    const tLoraDataPacket* pLoraPacket_p);
+
+static  bool  RsmSleep (
+    uint uiSleepTimeMs_p);
+
+static  int  RsmRand (
+    int iMin_p,
+    int iMax_p);
+
+static  uint16_t  RsmCalcCrc16 (
+    const void* pDataBlock_p,
+    unsigned int uiDataBlockSize_p);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Start Simulation
+//---------------------------------------------------------------------------
+//  Each simulated node sends a BootupPacket followed by DataPackets in the
+//  same format as the firmware. Every packet is injected into all simulated
+//  radios, with individual RSSI, random loss and a small delay between the
+//  radios, like several gateways hearing the same transmission.
+
+int  RsmStart (
+    uint uiRadioCount_p,                                // [IN]     Number of simulated Radios (0..n-1)
+    uint uiDevCount_p,                                  // [IN]     Number of simulated LoRa Nodes
+    uint uiCycleTimeMs_p)                               // [IN]     DataPacket Cycle Time [ms]
+{
+
+uint  uiIdx;
+
+
+    if ((uiRadioCount_p == 0) || (uiRadioCount_p > RF95_MAX_RADIOS))
+    {
+        return (-1);
+    }
+    if ((uiDevCount_p == 0) || (uiDevCount_p > RSM_MAX_DEVICES))
+    {
+        return (-2);
+    }
+    if ( fRsmRun_l )
+    {
+        return (-3);
+    }
+
+    uiRadioCount_l  = uiRadioCount_p;
+    uiDevCount_l    = uiDevCount_p;
+    uiCycleTimeMs_l = uiCycleTimeMs_p;
+    uiRandSeed_l    = (unsigned int)time(NULL);
+
+    memset(aRsmDevice_l, 0, sizeof(aRsmDevice_l));
+    for (uiIdx=0; uiIdx<uiDevCount_l; uiIdx++)
+    {
+        aRsmDevice_l[uiIdx].m_ui8DevID = (uint8_t)(uiIdx + 1);
+    }
+
+    fRsmRun_l = true;
+    RsmThread_l = std::thread(RsmThread);
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Stop Simulation
+//---------------------------------------------------------------------------
+
+int  RsmStop (void)
+{
+
+    fRsmRun_l = false;
+    if ( RsmThread_l.joinable() )
+    {
+        RsmThread_l.join();
+    }
+
+    return (0);
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Simulation Thread
+//---------------------------------------------------------------------------
+
+static  void  RsmThread (void)
+{
+
+tLoraDataPacket  LoraBootupPacket;
+uint             uiIdx;
+
+
+    BlgRegisterThread();
+
+    // nodes boot one after another
+    for (uiIdx=0; (uiIdx<uiDevCount_l) && fRsmRun_l; uiIdx++)
+    {
+        RsmBuildBootupPacket(&aRsmDevice_l[uiIdx], &LoraBootupPacket);
+        RsmTransmit(&aRsmDevice_l[uiIdx], &LoraBootupPacket);
+        RsmSleep(500);
+    }
+
+    while ( fRsmRun_l )
+    {
+        for (uiIdx=0; (uiIdx<uiDevCount_l) && fRsmRun_l; uiIdx++)
+        {
+            RsmBuildDataPacket(&aRsmDevice_l[uiIdx]);
+            RsmTransmit(&aRsmDevice_l[uiIdx], &aRsmDevice_l[uiIdx].m_TxLoraDataPacket);
+        }
+
+        RsmSleep(uiCycleTimeMs_l);
+        for (uiIdx=0; uiIdx<uiDevCount_l; uiIdx++)
+        {
+            aRsmDevice_l[uiIdx].m_ui32Uptime += (uiCycleTimeMs_l / 1000);
+        }
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Build BootupPacket
+//---------------------------------------------------------------------------
+
+static  void  RsmBuildBootupPacket (
+    tRsmDevice* pDevice_p,
+    tLoraDataPacket* pLoraPacket_p)
+{
+
+tLoraBootupHeader*  pLoraBootupHeader;
+
+
+    memset(pLoraPacket_p, 0x00, sizeof(tLoraDataPacket));
+    pLoraBootupHeader = (tLoraBootupHeader*)&pLoraPacket_p->m_LoraHeader;
+
+    LoraBootupHeaderField<kLoraBootupPacketType       >::Put(pLoraBootupHeader, kLoraPacketBootup);
+    LoraBootupHeaderField<kLoraBootupDevID            >::Put(pLoraBootupHeader, pDevice_p->m_ui8DevID);
+    LoraBootupHeaderField<kLoraBootupFirmwareVersion  >::Put(pLoraBootupHeader, 1);
+    LoraBootupHeaderField<kLoraBootupFirmwareRevision >::Put(pLoraBootupHeader, 0);
+    LoraBootupHeaderField<kLoraBootupDataPackCycleTm  >::Put(pLoraBootupHeader, (uiCycleTimeMs_l / 1000));
+    LoraBootupHeaderField<kLoraBootupCfgDhtSensor     >::Put(pLoraBootupHeader, 1);
+    LoraBootupHeaderField<kLoraBootupCfgSr501Sensor   >::Put(pLoraBootupHeader, 1);
+    LoraBootupHeaderField<kLoraBootupCfgAdcLightSensor>::Put(pLoraBootupHeader, 1);
+    LoraBootupHeaderField<kLoraBootupLoraTxPower      >::Put(pLoraBootupHeader, 14);
+    LoraBootupHeaderField<kLoraBootupLoraSpreadFactor >::Put(pLoraBootupHeader, 7);
+    LoraPutCrc16(pLoraBootupHeader->m_abCRC16, RsmCalcCrc16(pLoraBootupHeader, (64/8)));
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Build next DataPacket (same generation handling as LoraPayloadEncoder)
+//---------------------------------------------------------------------------
+
+static  void  RsmBuildDataPacket (
+    tRsmDevice* pDevice_p)
+{
+
+tLoraDataPacket*  pLoraPacket;
+tLoraDataRec*     pLoraDataRec;
+bool              fMotionActive;
+
+
+    pLoraPacket = &pDevice_p->m_TxLoraDataPacket;
+    pDevice_p->m_ui32SequNum++;
+
+    // setup Header of LoRa Data Packet
+    LoraDataHeaderField<kLoraHeaderPacketType>::Put(&pLoraPacket->m_LoraHeader, kLoraPacketDataHeader);
+    LoraDataHeaderField<kLoraHeaderDevID     >::Put(&pLoraPacket->m_LoraHeader, pDevice_p->m_ui8DevID);
+    LoraDataHeaderField<kLoraHeaderSequNum   >::Put(&pLoraPacket->m_LoraHeader, pDevice_p->m_ui32SequNum);
+    LoraDataHeaderField<kLoraHeaderUptime    >::Put(&pLoraPacket->m_LoraHeader, pDevice_p->m_ui32Uptime);
+    LoraPutCrc16(pLoraPacket->m_LoraHeader.m_abCRC16, RsmCalcCrc16(&pLoraPacket->m_LoraHeader, (64/8)));
+
+    // process generation list ([2]->[1] | [1]->[0])
+    pLoraPacket->m_aLoraDataRec[2] = pLoraPacket->m_aLoraDataRec[1];
+    if ((tLoraPacketType)LoraDataRecField<kLoraDataRecPacketType>::Get(&pLoraPacket->m_aLoraDataRec[2]) == kLoraPacketDataGen1)
+    {
+        LoraDataRecField<kLoraDataRecPacketType>::Put(&pLoraPacket->m_aLoraDataRec[2], kLoraPacketDataGen2);
+        LoraPutCrc16(pLoraPacket->m_aLoraDataRec[2].m_abCRC16, RsmCalcCrc16(&pLoraPacket->m_aLoraDataRec[2], (64/8)));
+    }
+    pLoraPacket->m_aLoraDataRec[1] = pLoraPacket->m_aLoraDataRec[0];
+    if ((tLoraPacketType)LoraDataRecField<kLoraDataRecPacketType>::Get(&pLoraPacket->m_aLoraDataRec[1]) == kLoraPacketDataGen0)
+    {
+        LoraDataRecField<kLoraDataRecPacketType>::Put(&pLoraPacket->m_aLoraDataRec[1], kLoraPacketDataGen1);
+        LoraPutCrc16(pLoraPacket->m_aLoraDataRec[1].m_abCRC16, RsmCalcCrc16(&pLoraPacket->m_aLoraDataRec[1], (64/8)));
+    }
+
+    // setup newest element with simulated process data
+    fMotionActive = (RsmRand(0, 3) == 0);
+    if ( fMotionActive )
+    {
+        pDevice_p->m_uiMotionCount++;
+    }
+    // raw values (scaling see <LORA_SCHEMA_DATA_REC>)
+    pLoraDataRec = &pLoraPacket->m_aLoraDataRec[0];
+    LoraDataRecField<kLoraDataRecPacketType       >::Put(pLoraDataRec, kLoraPacketDataGen0);
+    LoraDataRecField<kLoraDataRecUptimeSnippet    >::Put(pLoraDataRec, (pDevice_p->m_ui32Uptime / 10));
+    LoraDataRecField<kLoraDataRecTemperature      >::Put(pLoraDataRec, (40 + RsmRand(-4, 4)));      // 20.0 +/- 2.0 [C]
+    LoraDataRecField<kLoraDataRecHumidity         >::Put(pLoraDataRec, (50 + RsmRand(-10, 10)));    // 40..60 [%]
+    LoraDataRecField<kLoraDataRecMotionActive     >::Put(pLoraDataRec, (fMotionActive ? 1 : 0));
+    LoraDataRecField<kLoraDataRecMotionActiveTime >::Put(pLoraDataRec, (fMotionActive ? RsmRand(1, 6) : 0));
+    LoraDataRecField<kLoraDataRecMotionActiveCount>::Put(pLoraDataRec, pDevice_p->m_uiMotionCount);
+    LoraDataRecField<kLoraDataRecLightLevel       >::Put(pLoraDataRec, RsmRand(10, 40));
+    LoraDataRecField<kLoraDataRecCarBattLevel     >::Put(pLoraDataRec, 0);
+    LoraPutCrc16(pLoraDataRec->m_abCRC16, RsmCalcCrc16(pLoraDataRec, (64/8)));
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Transmit Packet to all simulated Radios
+//---------------------------------------------------------------------------
+
+static  void  RsmTransmit (
+    tRsmDevice* pDevice_p,
+    const tLoraDataPacket* pLoraPacket_p)
+{
+
+int8_t  i8Rssi;
+uint    uiRadio;
+int     iRes;
+
+
+    for (uiRadio=0; uiRadio<uiRadioCount_l; uiRadio++)
+    {
+        if (uiRadio > 0)
+        {
+            usleep(RsmRand(0, RSM_MAX_RADIO_SKEW_MS) * 1000);
+        }
+
+        // every radio has its own link quality to each node
+        if (RsmRand(0, 99) < (int)RSM_LOSS_PERCENT)
+        {
+            TRACE3("RsmTransmit: DevID=%u SequNum=%u lost on Radio %u\n", (uint)pDevice_p->m_ui8DevID, pDevice_p->m_ui32SequNum, uiRadio);
+            continue;
+        }
+        i8Rssi = (int8_t)(-60 - (8 * pDevice_p->m_ui8DevID) - (6 * uiRadio) + RsmRand(-10, 10));
+
+        iRes = RF95SimInjectPacket(uiRadio, (const uint8_t*)pLoraPacket_p, sizeof(tLoraDataPacket), i8Rssi);
+        if (iRes != 0)
+        {
+            BLG_WARNING("\nWARNING: RF95SimInjectPacket(%u) failed (iRes=%d)!\n", uiRadio, iRes);
+        }
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Sleep, interruptible by RsmStop()
+//---------------------------------------------------------------------------
+
+static  bool  RsmSleep (
+    uint uiSleepTimeMs_p)
+{
+
+    while ((uiSleepTimeMs_p > 0) && fRsmRun_l)
+    {
+        if (uiSleepTimeMs_p >= 100)
+        {
+            usleep(100 * 1000);
+            uiSleepTimeMs_p -= 100;
+        }
+        else
+        {
+            usleep(uiSleepTimeMs_p * 1000);
+            uiSleepTimeMs_p = 0;
+        }
+    }
+
+    return (fRsmRun_l);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get random number in range [iMin_p, iMax_p]
+//---------------------------------------------------------------------------
+
+static  int  RsmRand (
+    int iMin_p,
+    int iMax_p)
+{
+
+    return (iMin_p + (rand_r(&uiRandSeed_l) % (iMax_p - iMin_p + 1)));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Calculate CRC16 (identical to LoraPayloadEncoder/Decoder)
+//---------------------------------------------------------------------------
+
+static  uint16_t  RsmCalcCrc16 (
+    const void* pDataBlock_p,
+    unsigned int uiDataBlockSize_p)
+{
+
+// CCITT-Polynom (DIN 66 219): X^16 + X^12 + X^5 + 1 (=0x1021)
+#define CCITT_CRC_POLYNOM   0x1021
+
+uint8_t*  pabDataBlock;
+uint      uiBitCnt;
+bool      fOverflow;
+uint16_t  ui16CrcSum;
+
+
+    pabDataBlock = (uint8_t*)pDataBlock_p;
+    ui16CrcSum = 0;
+
+    while ( uiDataBlockSize_p-- )
+    {
+        uiBitCnt = 8;
+        while ( uiBitCnt-- )
+        {
+            fOverflow = (bool)((ui16CrcSum & 0x8000) != 0);
+            ui16CrcSum <<= 1;
+            if ( fOverflow )
+            {
+                ui16CrcSum ^= CCITT_CRC_POLYNOM;
+            }
+        }
+        ui16CrcSum ^= *pabDataBlock++;
+    }
+
+
+    return (ui16CrcSum);
+
+}
+
+
+
+// EOF
+
@@ -0,0 +1,49 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Declarations for Simulation of LoRa Nodes and Radios
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _RADIOSIM_H_
+#define _RADIOSIM_H_
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+const  uint  RSM_DEF_DEVICES        = 3;        // number of simulated LoRa nodes (DevID 1..n)
+const  uint  RSM_DEF_CYCLE_TIME_MS  = 5000;     // DataPacket cycle time of each node [ms]
+const  uint  RSM_LOSS_PERCENT       = 20;       // probability that a radio misses a packet [%]
+const  uint  RSM_MAX_RADIO_SKEW_MS  = 30;       // max. delay of a copy between two radios [ms]
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of public functions
+//---------------------------------------------------------------------------
+
+int   RsmStart (
+    uint uiRadioCount_p,                                // [IN]     Number of simulated Radios (0..n-1)
+    uint uiDevCount_p,                                  // [IN]     Number of simulated LoRa Nodes
+    uint uiCycleTimeMs_p);                              // [IN]     DataPacket Cycle Time [ms]
+
+int   RsmStop (void);
+
+
+
+#endif  // #ifndef _RADIOSIM_H_
+
+
+// EOF
+
@@ -0,0 +1,594 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Implementation of Real-Time Scheduling Support
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+#include <sched.h>
+#include <pthread.h>
+#include <malloc.h>
+#include <alloca.h>
+#include <sys/mman.h>
+#include <sys/timerfd.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "RealTime.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+const  unsigned int  RTM_JITTER_TIMER_PERIOD    = 2000;             // timer period of jitter test [us]
+const  unsigned int  RTM_JITTER_LOAD_BUFF_SIZE  = (512 * 1024);     // memory touched by each load thread [Bytes]
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Macro definitions
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+// upper limits of histogram buckets [us], last bucket collects everything above
+static  const uint32_t  aui32HistLimitUs_l[RTM_LATENCY_HIST_BUCKETS] =
+{
+    10, 20, 50, 100, 200, 500, 1000, 2000, 5000, UINT32_MAX
+};
+
+static  std::atomic<bool>   fStopLoad_l (false);
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  void  RtmLoadThread (void);
+
+static  int  RtmMeasureWakeupLatency (
+    unsigned int uiDurationSec_p,
+    int iCpuCore_p,
+    int iPriority_p,
+    tRtmLatencyStat* pLatencyStat_p);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Lock all current and future Memory and prefault Heap
+//---------------------------------------------------------------------------
+//  After this call no page faults occur for memory that is already mapped.
+//  The prefaulted heap is kept in the process (no trimming, no mmap for
+//  large blocks), so that later allocations are served without faults.
+
+int  RtmLockMemory (
+    unsigned int uiPrefaultHeapSize_p)                  // [IN]     Heap Size to prefault [Bytes]
+{
+
+uint8_t*  pabHeap;
+long      lPageSize;
+unsigned int  uiIdx;
+int       iRes;
+
+
+    iRes = mlockall(MCL_CURRENT | MCL_FUTURE);
+    if (iRes != 0)
+    {
+        return (-1);
+    }
+
+    // keep freed memory in the process and serve all requests from the heap
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+
+    if (uiPrefaultHeapSize_p > 0)
+    {
+        pabHeap = (uint8_t*)malloc(uiPrefaultHeapSize_p);
+        if (pabHeap == NULL)
+        {
+            return (-2);
+        }
+        lPageSize = sysconf(_SC_PAGESIZE);
+        for (uiIdx=0; uiIdx<uiPrefaultHeapSize_p; uiIdx+=(unsigned int)lPageSize)
+        {
+            ((volatile uint8_t*)pabHeap)[uiIdx] = 0;
+        }
+        free(pabHeap);
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Prefault Stack of the calling Thread
+//---------------------------------------------------------------------------
+
+int  RtmPrefaultStack (
+    unsigned int uiPrefaultStackSize_p)                 // [IN]     Stack Size to prefault [Bytes]
+{
+
+volatile uint8_t*  pabStack;
+
+
+    pabStack = (volatile uint8_t*)alloca(uiPrefaultStackSize_p);
+    memset((void*)pabStack, 0, uiPrefaultStackSize_p);
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Remove CPU Core from Affinity of the calling Thread
+//---------------------------------------------------------------------------
+//  All threads created afterwards by the calling thread inherit this mask,
+//  so this keeps the non-realtime threads (main loop, logger) away from
+//  the core reserved for the radio thread.
+
+int  RtmExcludeCpuCore (
+    int iCpuCore_p)                                     // [IN]     CPU Core reserved for RT Thread
+{
+
+cpu_set_t  CpuSet;
+int        iRes;
+
+
+    iRes = sched_getaffinity(0, sizeof(CpuSet), &CpuSet);
+    if (iRes != 0)
+    {
+        return (-1);
+    }
+
+    if ( !CPU_ISSET(iCpuCore_p, &CpuSet) )
+    {
+        return (-2);
+    }
+    CPU_CLR(iCpuCore_p, &CpuSet);
+    if (CPU_COUNT(&CpuSet) == 0)
+    {
+        // single core system -> nothing to separate
+        return (-3);
+    }
+
+    iRes = sched_setaffinity(0, sizeof(CpuSet), &CpuSet);
+    if (iRes != 0)
+    {
+        return (-4);
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Pin calling Thread to CPU Core and switch to SCHED_FIFO
+//---------------------------------------------------------------------------
+
+int  RtmSetupRealtimeThread (
+    int iCpuCore_p,                                     // [IN]     CPU Core to pin calling Thread to
+    int iPriority_p)                                    // [IN]     SCHED_FIFO Priority (1..99)
+{
+
+cpu_set_t           CpuSet;
+struct sched_param  SchedParam;
+int                 iRes;
+
+
+    if (iCpuCore_p >= 0)
+    {
+        CPU_ZERO(&CpuSet);
+        CPU_SET(iCpuCore_p, &CpuSet);
+        iRes = pthread_setaffinity_np(pthread_self(), sizeof(CpuSet), &CpuSet);
+        if (iRes != 0)
+        {
+            return (-1);
+        }
+    }
+
+    memset(&SchedParam, 0, sizeof(SchedParam));
+    SchedParam.sched_priority = iPriority_p;
+    iRes = pthread_setschedparam(pthread_self(), SCHED_FIFO, &SchedParam);
+    if (iRes != 0)
+    {
+        return (-2);
+    }
+
+    RtmPrefaultStack(RTM_DEF_PREFAULT_STACK);
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get monotonic Time [us]
+//---------------------------------------------------------------------------
+
+uint64_t  RtmGetTimeUs (void)
+{
+
+struct timespec  tsNow;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &tsNow);
+
+    return (((uint64_t)tsNow.tv_sec * 1000000ULL) + ((uint64_t)tsNow.tv_nsec / 1000ULL));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Latency Statistics
+//---------------------------------------------------------------------------
+
+void  RtmLatencyReset (
+    tRtmLatencyStat* pLatencyStat_p)                    // [IN/OUT] Ptr to Latency Statistics
+{
+
+    memset(pLatencyStat_p, 0, sizeof(tRtmLatencyStat));
+    pLatencyStat_p->m_ui32MinUs = UINT32_MAX;
+
+    return;
+
+}
+
+
+void  RtmLatencyAdd (
+    tRtmLatencyStat* pLatencyStat_p,                    // [IN/OUT] Ptr to Latency Statistics
+    uint32_t ui32LatencyUs_p)                           // [IN]     Measured Latency [us]
+{
+
+unsigned int  uiBucket;
+
+
+    pLatencyStat_p->m_ui32Count++;
+    pLatencyStat_p->m_ui64SumUs += ui32LatencyUs_p;
+    if (ui32LatencyUs_p < pLatencyStat_p->m_ui32MinUs)
+    {
+        pLatencyStat_p->m_ui32MinUs = ui32LatencyUs_p;
+    }
+    if (ui32LatencyUs_p > pLatencyStat_p->m_ui32MaxUs)
+    {
+        pLatencyStat_p->m_ui32MaxUs = ui32LatencyUs_p;
+    }
+
+    for (uiBucket=0; uiBucket<RTM_LATENCY_HIST_BUCKETS-1; uiBucket++)
+    {
+        if (ui32LatencyUs_p < aui32HistLimitUs_l[uiBucket])
+        {
+            break;
+        }
+    }
+    pLatencyStat_p->m_aui32Hist[uiBucket]++;
+
+    return;
+
+}
+
+
+void  RtmLatencyPrint (
+    const char* pszTitle_p,                             // [IN]     Title of Statistics
+    const tRtmLatencyStat* pLatencyStat_p)              // [IN]     Ptr to Latency Statistics
+{
+
+unsigned int  uiBucket;
+uint32_t      ui32LowerLimit;
+
+
+    printf("%s:\n", pszTitle_p);
+    if (pLatencyStat_p->m_ui32Count == 0)
+    {
+        printf("  no samples\n");
+        return;
+    }
+
+    printf("  Samples = %u\n", pLatencyStat_p->m_ui32Count);
+    printf("  Min     = %u [us]\n", pLatencyStat_p->m_ui32MinUs);
+    printf("  Avg     = %u [us]\n", (uint32_t)(pLatencyStat_p->m_ui64SumUs / pLatencyStat_p->m_ui32Count));
+    printf("  Max     = %u [us]\n", pLatencyStat_p->m_ui32MaxUs);
+
+    ui32LowerLimit = 0;
+    for (uiBucket=0; uiBucket<RTM_LATENCY_HIST_BUCKETS; uiBucket++)
+    {
+        if (aui32HistLimitUs_l[uiBucket] != UINT32_MAX)
+        {
+            printf("  %5u .. %5u [us] : %u\n", ui32LowerLimit, aui32HistLimitUs_l[uiBucket]-1, pLatencyStat_p->m_aui32Hist[uiBucket]);
+        }
+        else
+        {
+            printf("  %5u .. ...   [us] : %u\n", ui32LowerLimit, pLatencyStat_p->m_aui32Hist[uiBucket]);
+        }
+        ui32LowerLimit = aui32HistLimitUs_l[uiBucket];
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Measure Wakeup Jitter under synthetic CPU Load
+//---------------------------------------------------------------------------
+//  A periodic timerfd takes the role of the DIO0 interrupt. It is waited
+//  for with poll(), exactly like the GPIO fd in the main loop, and the
+//  latency between timer expiry and return of poll() is recorded. Meanwhile
+//  one busy load thread per CPU core keeps the system saturated.
+//  Phase(1) runs with default scheduling, Phase(2) with the real-time
+//  settings used by option '-r'.
+
+int  RtmRunJitterTest (
+    unsigned int uiDurationSec_p,                       // [IN]     Duration of each Test Phase [sec]
+    int iCpuCore_p,                                     // [IN]     CPU Core for RT Phase
+    int iPriority_p)                                    // [IN]     SCHED_FIFO Priority for RT Phase
+{
+
+std::vector<std::thread>  vecLoadThreads;
+tRtmLatencyStat           aLatencyStat[2];
+unsigned int              uiLoadThreads;
+unsigned int              uiIdx;
+int                       iPhase;
+int                       aiRes[2];
+
+
+    uiLoadThreads = std::thread::hardware_concurrency();
+    if (uiLoadThreads == 0)
+    {
+        uiLoadThreads = 4;
+    }
+
+    printf("Jitter Test: %u [sec] per phase, timer period %u [us], %u load threads\n",
+           uiDurationSec_p, RTM_JITTER_TIMER_PERIOD, uiLoadThreads);
+    fflush(stdout);
+
+    for (iPhase=0; iPhase<2; iPhase++)
+    {
+        RtmLatencyReset(&aLatencyStat[iPhase]);
+
+        if (iPhase == 1)
+        {
+            if (RtmLockMemory(RTM_DEF_PREFAULT_HEAP) != 0)
+            {
+                printf("WARNING: mlockall() failed (errno=%d), continue without locked memory\n", errno);
+            }
+        }
+
+        fStopLoad_l = false;
+        for (uiIdx=0; uiIdx<uiLoadThreads; uiIdx++)
+        {
+            vecLoadThreads.push_back(std::thread(RtmLoadThread));
+        }
+
+        // measuring thread is a separate thread, so that its scheduling
+        // policy doesn't affect the calling (main) thread
+        std::thread MeasureThread([&]()
+        {
+            aiRes[iPhase] = RtmMeasureWakeupLatency(uiDurationSec_p,
+                                                    ((iPhase == 1) ? iCpuCore_p  : -1),
+                                                    ((iPhase == 1) ? iPriority_p :  0),
+                                                    &aLatencyStat[iPhase]);
+        });
+        MeasureThread.join();
+
+        fStopLoad_l = true;
+        for (uiIdx=0; uiIdx<vecLoadThreads.size(); uiIdx++)
+        {
+            vecLoadThreads[uiIdx].join();
+        }
+        vecLoadThreads.clear();
+
+        printf("\n");
+        if (aiRes[iPhase] != 0)
+        {
+            printf("Phase(%d): measurement failed (iRes=%d)%s\n", iPhase+1, aiRes[iPhase],
+                   ((aiRes[iPhase] == -1) ? " - SCHED_FIFO requires root privileges" : ""));
+            continue;
+        }
+        if (iPhase == 0)
+        {
+            RtmLatencyPrint("Phase(1): Wakeup Latency with default scheduling (SCHED_OTHER)", &aLatencyStat[iPhase]);
+        }
+        else
+        {
+            printf("Phase(2): CPU Core %d, SCHED_FIFO Priority %d, locked Memory\n", iCpuCore_p, iPriority_p);
+            RtmLatencyPrint("Phase(2): Wakeup Latency with real-time scheduling", &aLatencyStat[iPhase]);
+        }
+        fflush(stdout);
+    }
+
+    printf("\n");
+
+    return (0);
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Synthetic CPU and Memory Load
+//---------------------------------------------------------------------------
+
+static  void  RtmLoadThread (void)
+{
+
+std::vector<uint8_t>  vecBuffer(RTM_JITTER_LOAD_BUFF_SIZE);
+uint32_t              ui32Sum;
+unsigned int          uiIdx;
+
+
+    ui32Sum = 0;
+    while ( !fStopLoad_l.load(std::memory_order_relaxed) )
+    {
+        // touch a buffer larger than the L2 cache to stress the memory bus too
+        for (uiIdx=0; uiIdx<vecBuffer.size(); uiIdx+=64)
+        {
+            vecBuffer[uiIdx] = (uint8_t)(vecBuffer[uiIdx] + ui32Sum);
+            ui32Sum += vecBuffer[uiIdx];
+        }
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Measure Latency between Timer Expiry and Return of poll()
+//---------------------------------------------------------------------------
+
+static  int  RtmMeasureWakeupLatency (
+    unsigned int uiDurationSec_p,                       // [IN]     Measurement Duration [sec]
+    int iCpuCore_p,                                     // [IN]     CPU Core (-1 = no RT Setup)
+    int iPriority_p,                                    // [IN]     SCHED_FIFO Priority
+    tRtmLatencyStat* pLatencyStat_p)                    // [IN/OUT] Ptr to Latency Statistics
+{
+
+struct pollfd      FdSet[1];
+struct itimerspec  TimerSpec;
+uint64_t           ui64StartUs;
+uint64_t           ui64EndUs;
+uint64_t           ui64ExpiryUs;
+uint64_t           ui64NowUs;
+uint64_t           ui64Expirations;
+int                iTimerFd;
+int                iRes;
+
+
+    if (iCpuCore_p >= 0)
+    {
+        iRes = RtmSetupRealtimeThread(iCpuCore_p, iPriority_p);
+        if (iRes != 0)
+        {
+            return (-1);
+        }
+    }
+
+    iTimerFd = timerfd_create(CLOCK_MONOTONIC, 0);
+    if (iTimerFd < 0)
+    {
+        return (-2);
+    }
+
+    // absolute periodic timer, so that the expected expiry times are known exactly
+    ui64StartUs  = RtmGetTimeUs() + 10000;
+    ui64EndUs    = ui64StartUs + ((uint64_t)uiDurationSec_p * 1000000ULL);
+    ui64ExpiryUs = ui64StartUs;
+    memset(&TimerSpec, 0, sizeof(TimerSpec));
+    TimerSpec.it_value.tv_sec     = (time_t)(ui64StartUs / 1000000ULL);
+    TimerSpec.it_value.tv_nsec    = (long)((ui64StartUs % 1000000ULL) * 1000ULL);
+    TimerSpec.it_interval.tv_sec  = 0;
+    TimerSpec.it_interval.tv_nsec = (long)RTM_JITTER_TIMER_PERIOD * 1000L;
+    iRes = timerfd_settime(iTimerFd, TFD_TIMER_ABSTIME, &TimerSpec, NULL);
+    if (iRes != 0)
+    {
+        close(iTimerFd);
+        return (-3);
+    }
+
+    FdSet[0].fd = iTimerFd;
+    FdSet[0].events = POLLIN;
+
+    do
+    {
+        FdSet[0].revents = 0;
+        iRes = poll(FdSet, 1, 1000);
+        ui64NowUs = RtmGetTimeUs();
+        if ((iRes > 0) && (FdSet[0].revents & POLLIN))
+        {
+            if (read(iTimerFd, &ui64Expirations, sizeof(ui64Expirations)) == sizeof(ui64Expirations))
+            {
+                // latency is related to the latest expiry (overruns count as one sample)
+                ui64ExpiryUs += (ui64Expirations - 1) * RTM_JITTER_TIMER_PERIOD;
+                RtmLatencyAdd(pLatencyStat_p, (uint32_t)(ui64NowUs - ui64ExpiryUs));
+                ui64ExpiryUs += RTM_JITTER_TIMER_PERIOD;
+            }
+        }
+    }
+    while (ui64NowUs < ui64EndUs);
+
+    close(iTimerFd);
+
+    return (0);
+
+}
+
+
+
+// EOF
+
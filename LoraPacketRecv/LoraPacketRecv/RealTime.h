@@ -0,0 +1,89 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Declarations for Real-Time Scheduling Support
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _REALTIME_H_
+#define _REALTIME_H_
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+const  int           RTM_DEF_PRIORITY           = 80;               // default SCHED_FIFO priority of radio thread
+const  unsigned int  RTM_DEF_PREFAULT_STACK     = (256 * 1024);     // stack to prefault for each RT thread [Bytes]
+const  unsigned int  RTM_DEF_PREFAULT_HEAP      = (4 * 1024 * 1024);// heap to prefault and keep in process [Bytes]
+const  unsigned int  RTM_LATENCY_HIST_BUCKETS   = 10;
+
+
+
+//---------------------------------------------------------------------------
+//  Type definitions
+//---------------------------------------------------------------------------
+
+typedef struct
+{
+    uint32_t            m_ui32Count;
+    uint32_t            m_ui32MinUs;
+    uint32_t            m_ui32MaxUs;
+    uint64_t            m_ui64SumUs;
+    uint32_t            m_aui32Hist[RTM_LATENCY_HIST_BUCKETS];     // see <aui32HistLimitUs_l> for bucket limits
+
+} tRtmLatencyStat;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of public functions
+//---------------------------------------------------------------------------
+
+int   RtmLockMemory (
+    unsigned int uiPrefaultHeapSize_p);                 // [IN]     Heap Size to prefault [Bytes]
+
+int   RtmPrefaultStack (
+    unsigned int uiPrefaultStackSize_p);                // [IN]     Stack Size to prefault [Bytes]
+
+int   RtmExcludeCpuCore (
+    int iCpuCore_p);                                    // [IN]     CPU Core reserved for RT Thread
+
+int   RtmSetupRealtimeThread (
+    int iCpuCore_p,                                     // [IN]     CPU Core to pin calling Thread to
+    int iPriority_p);                                   // [IN]     SCHED_FIFO Priority (1..99)
+
+uint64_t  RtmGetTimeUs (void);
+
+void  RtmLatencyReset (
+    tRtmLatencyStat* pLatencyStat_p);                   // [IN/OUT] Ptr to Latency Statistics
+
+void  RtmLatencyAdd (
+    tRtmLatencyStat* pLatencyStat_p,                    // [IN/OUT] Ptr to Latency Statistics
+    uint32_t ui32LatencyUs_p);                          // [IN]     Measured Latency [us]
+
+void  RtmLatencyPrint (
+    const char* pszTitle_p,                             // [IN]     Title of Statistics
+    const tRtmLatencyStat* pLatencyStat_p);             // [IN]     Ptr to Latency Statistics
+
+int   RtmRunJitterTest (
+    unsigned int uiDurationSec_p,                       // [IN]     Duration of each Test Phase [sec]
+    int iCpuCore_p,                                     // [IN]     CPU Core for RT Phase
+    int iPriority_p);                                   // [IN]     SCHED_FIFO Priority for RT Phase
+
+
+
+#endif  // #ifndef _REALTIME_H_
+
+
+// EOF
+
@@ -0,0 +1,284 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Implementation of Receive Frame Queue
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#include <RH_RF95.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/eventfd.h>
+#include <atomic>
+#include "RxQueue.h"
+#include "Trace.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Macro definitions
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+//  Single producer (radio thread) / single consumer (main loop). All frames
+//  are allocated and touched in RxqInitialize(), so pushing a frame never
+//  causes an allocation or page fault on the radio thread.
+static  tRxqFrame*              paRxFrames_l        = NULL;
+static  unsigned int            uiQueueSize_l       = 0;    // power of two
+static  std::atomic<uint32_t>   ui32Head_l (0);             // written by producer only
+static  std::atomic<uint32_t>   ui32Tail_l (0);             // written by consumer only
+static  std::atomic<uint>       uiDropCount_l (0);
+static  int                     iEventFd_l          = -1;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Initialize Queue
+//---------------------------------------------------------------------------
+
+int  RxqInitialize (
+    unsigned int uiQueueSize_p)                         // [IN]     Number of Frames
+{
+
+unsigned int  uiQueueSize;
+
+
+    if (uiQueueSize_p == 0)
+    {
+        uiQueueSize_p = RXQ_DEF_QUEUE_SIZE;
+    }
+    uiQueueSize = 1;
+    while (uiQueueSize < uiQueueSize_p)
+    {
+        uiQueueSize <<= 1;
+    }
+
+    paRxFrames_l = (tRxqFrame*)malloc(uiQueueSize * sizeof(tRxqFrame));
+    if (paRxFrames_l == NULL)
+    {
+        TRACE0("ERROR: Out of memory!\n");
+        return (-1);
+    }
+    memset(paRxFrames_l, 0, uiQueueSize * sizeof(tRxqFrame));
+
+    iEventFd_l = eventfd(0, EFD_NONBLOCK);
+    if (iEventFd_l < 0)
+    {
+        TRACE0("ERROR: eventfd() failed!\n");
+        free(paRxFrames_l);
+        paRxFrames_l = NULL;
+        return (-2);
+    }
+
+    uiQueueSize_l = uiQueueSize;
+    ui32Head_l    = 0;
+    ui32Tail_l    = 0;
+    uiDropCount_l = 0;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Close Queue
+//---------------------------------------------------------------------------
+
+int  RxqClose (void)
+{
+
+    if (iEventFd_l >= 0)
+    {
+        close(iEventFd_l);
+        iEventFd_l = -1;
+    }
+
+    free(paRxFrames_l);
+    paRxFrames_l  = NULL;
+    uiQueueSize_l = 0;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get File Descriptor signaled by RxqPush() (for poll())
+//---------------------------------------------------------------------------
+
+int  RxqGetEventFD (void)
+{
+
+    return (iEventFd_l);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Append Frame to Queue (Producer)
+//---------------------------------------------------------------------------
+
+bool  RxqPush (
+    const tRxqFrame* pRxFrame_p)                        // [IN]     Ptr to received Frame
+{
+
+uint32_t  ui32Head;
+uint32_t  ui32Tail;
+uint64_t  ui64Event;
+
+
+    ui32Head = ui32Head_l.load(std::memory_order_relaxed);
+    ui32Tail = ui32Tail_l.load(std::memory_order_acquire);
+    if ((ui32Head - ui32Tail) >= uiQueueSize_l)
+    {
+        uiDropCount_l++;
+        return (false);
+    }
+
+    memcpy(&paRxFrames_l[ui32Head & (uiQueueSize_l - 1)], pRxFrame_p, sizeof(tRxqFrame));
+    ui32Head_l.store(ui32Head + 1, std::memory_order_release);
+
+    ui64Event = 1;
+    if (write(iEventFd_l, &ui64Event, sizeof(ui64Event)) != sizeof(ui64Event))
+    {
+        // counter overflow is impossible here, event is signaled anyway
+    }
+
+    return (true);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Remove oldest Frame from Queue (Consumer)
+//---------------------------------------------------------------------------
+
+bool  RxqPop (
+    tRxqFrame* pRxFrame_p)                              // [OUT]    Ptr to Buffer for Frame
+{
+
+uint32_t  ui32Head;
+uint32_t  ui32Tail;
+
+
+    ui32Tail = ui32Tail_l.load(std::memory_order_relaxed);
+    ui32Head = ui32Head_l.load(std::memory_order_acquire);
+    if (ui32Head == ui32Tail)
+    {
+        return (false);
+    }
+
+    memcpy(pRxFrame_p, &paRxFrames_l[ui32Tail & (uiQueueSize_l - 1)], sizeof(tRxqFrame));
+    ui32Tail_l.store(ui32Tail + 1, std::memory_order_release);
+
+    return (true);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Reset Event of File Descriptor (Consumer, before draining the Queue)
+//---------------------------------------------------------------------------
+
+int  RxqClearEvent (void)
+{
+
+uint64_t  ui64Event;
+
+
+    if (read(iEventFd_l, &ui64Event, sizeof(ui64Event)) != sizeof(ui64Event))
+    {
+        return (0);
+    }
+
+    return ((int)ui64Event);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get number of Frames dropped because of a full Queue
+//---------------------------------------------------------------------------
+
+uint  RxqGetDropCount (void)
+{
+
+    return (uiDropCount_l.load());
+
+}
+
+
+
+// EOF
+
@@ -0,0 +1,79 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Declarations for Receive Frame Queue
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Radio index of received Frame
+  2026/10/18 -rs:   V1.02 SNR of received Frame
+
+****************************************************************************/
+
+#ifndef _RXQUEUE_H_
+#define _RXQUEUE_H_
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+const  unsigned int  RXQ_DEF_QUEUE_SIZE     = 64;       // number of frames (rounded up to power of two)
+
+
+
+//---------------------------------------------------------------------------
+//  Type definitions
+//---------------------------------------------------------------------------
+
+typedef struct
+{
+    uint                m_uiRxPacketCntr;
+    uint                m_uiRadio;                  // index of radio which received this frame
+    uint                m_uiRadioMask;              // all radios which received this frame (see RadioDedup)
+    time_t              m_tmTimeStamp;              // Receive TimeStamp (Linux Standard Time)
+    uint64_t            m_ui64WakeTimeUs;           // radio thread woken up by DIO0 edge, i.e. after the wakeup delay (monotonic)
+    uint64_t            m_ui64ReadTimeUs;           // FIFO read completed (monotonic)
+    int8_t              m_i8Rssi;
+    int8_t              m_i8Snr;                    // [0.25 dB], only read in capture mode (otherwise 0)
+    uint                m_uiDataLen;
+    uint8_t             m_abData[RH_RF95_MAX_PAYLOAD_LEN+1];
+
+} tRxqFrame;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of public functions
+//---------------------------------------------------------------------------
+
+int   RxqInitialize (
+    unsigned int uiQueueSize_p);                        // [IN]     Number of Frames
+
+int   RxqClose (void);
+
+int   RxqGetEventFD (void);
+
+bool  RxqPush (
+    const tRxqFrame* pRxFrame_p);                       // [IN]     Ptr to received Frame
+
+bool  RxqPop (
+    tRxqFrame* pRxFrame_p);                             // [OUT]    Ptr to Buffer for Frame
+
+int   RxqClearEvent (void);
+
+uint  RxqGetDropCount (void);
+
+
+
+#endif  // #ifndef _RXQUEUE_H_
+
+
+// EOF
+
@@ -0,0 +1,153 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Layout of Shared Memory Ring for local consumers
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _SHMRINGFORMAT_H_
+#define _SHMRINGFORMAT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#include <atomic>
+#include "MessageLogFormat.h"
+
+
+
+//---------------------------------------------------------------------------
+//  Shared Memory Layout
+//---------------------------------------------------------------------------
+// Notice:  The POSIX Shared Memory Object ('/dev/shm/<name>') consists of one
+//          <tSrfHeader> followed by <m_ui32Slots> (power of 2) <tSrfSlot>.
+//          Each slot carries one decoded record in the format of the binary
+//          MessageLog (tMlfRecord, see MessageLogFormat.h), so readers use
+//          the same decoding (e.g. MlrGetRecordFields()) as for a MessageLog.
+//
+//          There is exactly one writer (LoraPacketRecv), the readers map the
+//          object read-only and never write to it, so any number of readers
+//          (including slow or crashed ones) can't block or disturb the writer.
+//          The records are numbered from 1, record <n> is stored in slot
+//          <n & (m_ui32Slots-1)>. Per slot the writer uses a sequence lock:
+//
+//            m_ui32Sequence = 2n-1     record <n> is being written
+//            m_ui32Sequence = 2n       record <n> is complete
+//
+//          After the slot, <m_ui32Head> is set to <n> and <m_ui32Futex> is
+//          changed, readers waiting for new records sleep on <m_ui32Futex>
+//          (FUTEX_WAIT on the shared mapping). A reader that falls behind by
+//          more than <m_ui32Slots> records loses the overwritten ones, which
+//          it detects by the sequence of the slot.
+//
+//          Only 32 bit atomics are used (64 bit atomics are not lock-free on
+//          all RaspberryPi models, and lock-based atomics don't work between
+//          processes), all record numbers are compared modulo 2^32 and the
+//          number 0 is skipped at the wrap-around (see SrfNextRecNum()).
+//---------------------------------------------------------------------------
+
+const  char      SRF_DEF_NAME[]         = "/LoraPacketRecv";    // '/dev/shm/LoraPacketRecv'
+const  char      SRF_MAGIC[8]           = { 'L','o','r','a','S','R','n','g' };
+const  uint16_t  SRF_FORMAT_VERSION     = 1;
+const  size_t    SRF_HEADER_SIZE        = 256;
+const  size_t    SRF_SLOT_SIZE          = 128;
+
+
+typedef enum
+{
+    kSrfStateInit       = 0,                        // header not valid yet
+    kSrfStateOpen       = 1,                        // writer is publishing
+    kSrfStateClosed     = 2                         // writer has closed the ring (a new one is created at restart)
+
+} tSrfState;
+
+
+typedef struct
+{
+    char                    m_achMagic[8];          // SRF_MAGIC
+    uint16_t                m_ui16FormatVersion;    // SRF_FORMAT_VERSION
+    uint16_t                m_ui16SchemaVersion;    // LORA_SCHEMA_VERSION of writer
+    uint16_t                m_ui16HeaderSize;       // SRF_HEADER_SIZE
+    uint16_t                m_ui16SlotSize;         // SRF_SLOT_SIZE
+    uint32_t                m_ui32Slots;            // number of slots (power of 2)
+    int32_t                 m_i32WriterPid;
+    int64_t                 m_i64CreateTime;        // Linux Standard Time of creation
+    std::atomic<uint32_t>   m_ui32State;            // tSrfState
+    uint8_t                 m_abReserved1[28];
+
+    alignas(64)
+    std::atomic<uint32_t>   m_ui32Head;             // number of last complete record (0 = none yet)
+    uint8_t                 m_abReserved2[60];
+
+    alignas(64)
+    std::atomic<uint32_t>   m_ui32Futex;            // changed with each record and at close
+    uint8_t                 m_abReserved3[60];
+
+    alignas(64)
+    uint8_t                 m_abReserved4[64];
+
+} tSrfHeader;
+
+
+typedef struct
+{
+    std::atomic<uint32_t>   m_ui32Sequence;         // see above, 0 = never written
+    uint32_t                m_ui32Reserved;
+    int64_t                 m_i64PublishTime;       // CLOCK_MONOTONIC [ns] of publishing (SrfGetTime()), like <m_Record> only valid under the sequence lock
+    uint8_t                 m_abReserved[48];
+
+    tMlfRecord              m_Record;               // cache line aligned
+
+} tSrfSlot;
+
+
+static_assert(sizeof(tSrfHeader) == SRF_HEADER_SIZE, "unexpected size of <tSrfHeader>");
+static_assert(sizeof(tSrfSlot)   == SRF_SLOT_SIZE,   "unexpected size of <tSrfSlot>");
+static_assert(offsetof(tSrfHeader, m_ui32Head)  ==  64, "unexpected layout of <tSrfHeader>");
+static_assert(offsetof(tSrfHeader, m_ui32Futex) == 128, "unexpected layout of <tSrfHeader>");
+static_assert(offsetof(tSrfSlot, m_Record)      ==  64, "unexpected layout of <tSrfSlot>");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "lock-free atomics are required in shared memory");
+
+
+
+//---------------------------------------------------------------------------
+//  Number of Record following <ui32RecNum_p>
+//---------------------------------------------------------------------------
+
+inline uint32_t  SrfNextRecNum (uint32_t ui32RecNum_p)
+{
+    ui32RecNum_p++;
+
+    return ((ui32RecNum_p != 0) ? ui32RecNum_p : 1);
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Time Base of <m_i64PublishTime>
+//---------------------------------------------------------------------------
+
+inline int64_t  SrfGetTime (void)
+{
+    struct timespec  TimeSpec;
+
+    clock_gettime(CLOCK_MONOTONIC, &TimeSpec);
+
+    return ((int64_t)TimeSpec.tv_sec * 1000000000LL + TimeSpec.tv_nsec);
+}
+
+
+
+#endif  // _SHMRINGFORMAT_H_
+
+
+
+// EOF
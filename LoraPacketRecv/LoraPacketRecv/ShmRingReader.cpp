@@ -0,0 +1,469 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Implementation of Reader of Shared Memory Ring
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <atomic>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "LoraPacketSchema.h"
+#include "ShmRingReader.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+#define SRR_ALIVE_CHECK_TIME    1000                    // [ms] max. time between checks of writer in SrrWait()
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  inline  bool  SrrIsAvailable (
+    const tSrrReader* pReader_p);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Attach to Shared Memory Ring
+//---------------------------------------------------------------------------
+//  The ring is mapped read-only. Only a ring of the same format and schema
+//  version is accepted, because the raw LoRa records can only be decoded
+//  with the schema they were written with. A ring that is just being created
+//  (-5) or left by a killed writer (-7) is rejected as well, the caller
+//  retries later.
+
+int  SrrOpen (
+    const char* pszName_p,                              // [IN]     Name of Shared Memory Object ('/<name>')
+    bool fFromOldest_p,                                 // [IN]     Start with oldest record in ring (otherwise only new records)
+    tSrrReader* pReader_p)                              // [OUT]    Ptr to Reader
+{
+
+struct stat        FileStat;
+const tSrfHeader*  pHeader;
+void*              pMapAddr;
+uint32_t           ui32Head;
+int                iFd;
+
+
+    if ((pszName_p == NULL) || (pReader_p == NULL))
+    {
+        return (-1);
+    }
+
+    memset(pReader_p, 0, sizeof(tSrrReader));
+
+    iFd = shm_open(pszName_p, O_RDONLY | O_CLOEXEC, 0);
+    if (iFd < 0)
+    {
+        return (-2);
+    }
+    if ( (fstat(iFd, &FileStat) != 0) || (FileStat.st_size < (off_t)(SRF_HEADER_SIZE + SRF_SLOT_SIZE)) )
+    {
+        close(iFd);
+        return (-3);
+    }
+    pMapAddr = mmap(NULL, (size_t)FileStat.st_size, PROT_READ, MAP_SHARED, iFd, 0);
+    close(iFd);
+    if (pMapAddr == MAP_FAILED)
+    {
+        return (-4);
+    }
+
+    pReader_p->m_pabMapAddr = (const uint8_t*)pMapAddr;
+    pReader_p->m_nMapSize   = (size_t)FileStat.st_size;
+    pHeader = (const tSrfHeader*)pMapAddr;
+
+    if ( (pHeader->m_ui32State.load(std::memory_order_acquire) == kSrfStateInit) ||
+         (memcmp(pHeader->m_achMagic, SRF_MAGIC, sizeof(pHeader->m_achMagic)) != 0) )
+    {
+        SrrClose(pReader_p);
+        return (-5);
+    }
+    if ( (pHeader->m_ui16FormatVersion != SRF_FORMAT_VERSION)  ||
+         (pHeader->m_ui16SchemaVersion != LORA_SCHEMA_VERSION) ||
+         (pHeader->m_ui16HeaderSize    != SRF_HEADER_SIZE)     ||
+         (pHeader->m_ui16SlotSize      != SRF_SLOT_SIZE)       ||
+         (pHeader->m_ui32Slots == 0) || ((pHeader->m_ui32Slots & (pHeader->m_ui32Slots - 1)) != 0) ||
+         (pReader_p->m_nMapSize < (SRF_HEADER_SIZE + ((size_t)pHeader->m_ui32Slots * SRF_SLOT_SIZE))) )
+    {
+        SrrClose(pReader_p);
+        return (-6);
+    }
+
+    pReader_p->m_pHeader      = pHeader;
+    pReader_p->m_pSlots       = (const tSrfSlot*)(pReader_p->m_pabMapAddr + SRF_HEADER_SIZE);
+    pReader_p->m_ui32SlotMask = pHeader->m_ui32Slots - 1;
+    if ( !SrrIsWriterAlive(pReader_p) )
+    {
+        SrrClose(pReader_p);
+        return (-7);
+    }
+
+    // start behind the newest record, or with the oldest one still in the ring
+    // (an overwritten one is counted as lost by SrrPeek())
+    ui32Head = pHeader->m_ui32Head.load(std::memory_order_acquire);
+    pReader_p->m_ui32NextRecNum = SrfNextRecNum(ui32Head);
+    if ( fFromOldest_p )
+    {
+        pReader_p->m_ui32NextRecNum = (ui32Head > pHeader->m_ui32Slots) ? (ui32Head - pHeader->m_ui32Slots + 1) : 1;
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Detach from Shared Memory Ring
+//---------------------------------------------------------------------------
+
+int  SrrClose (
+    tSrrReader* pReader_p)                              // [IN/OUT] Ptr to Reader
+{
+
+    if (pReader_p == NULL)
+    {
+        return (-1);
+    }
+
+    if (pReader_p->m_pabMapAddr != NULL)
+    {
+        munmap((void*)pReader_p->m_pabMapAddr, pReader_p->m_nMapSize);
+    }
+    pReader_p->m_pabMapAddr = NULL;
+    pReader_p->m_nMapSize   = 0;
+    pReader_p->m_pHeader    = NULL;
+    pReader_p->m_pSlots     = NULL;
+    pReader_p->m_pPeekSlot  = NULL;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get next Record in place (zero copy)
+//---------------------------------------------------------------------------
+//  Returns a pointer into the ring, which is valid until SrrRelease(). The
+//  writer doesn't wait for readers, so the slot can be overwritten while the
+//  record is used. SrrRelease() tells whether this happened, in this case
+//  everything derived from the record has to be discarded.
+//  Calling SrrPeek() again before SrrRelease() returns the same record.
+
+const tMlfRecord*  SrrPeek (
+    tSrrReader* pReader_p,                              // [IN/OUT] Ptr to Reader
+    int64_t* pi64PublishTime_p)                         // [OUT]    Publish Time (SrfGetTime()), NULL = not needed
+{
+
+const tSrfSlot*  pSlot;
+uint32_t         ui32Head;
+uint32_t         ui32Behind;
+uint32_t         ui32Sequence;
+
+
+    if ((pReader_p == NULL) || (pReader_p->m_pHeader == NULL))
+    {
+        return (NULL);
+    }
+
+    pSlot = pReader_p->m_pPeekSlot;
+    if (pSlot == NULL)
+    {
+        for (;;)
+        {
+            ui32Head = pReader_p->m_pHeader->m_ui32Head.load(std::memory_order_acquire);
+            ui32Behind = ui32Head - pReader_p->m_ui32NextRecNum;
+            if ((int32_t)ui32Behind < 0)
+            {
+                return (NULL);                          // no new record
+            }
+
+            // fallen behind by more than the ring: skip the overwritten records
+            if (ui32Behind > pReader_p->m_ui32SlotMask)
+            {
+                pReader_p->m_ui64Lost += ui32Behind - pReader_p->m_ui32SlotMask;
+                pReader_p->m_ui32NextRecNum = ui32Head - pReader_p->m_ui32SlotMask;
+            }
+
+            pSlot = &pReader_p->m_pSlots[pReader_p->m_ui32NextRecNum & pReader_p->m_ui32SlotMask];
+            ui32Sequence = pSlot->m_ui32Sequence.load(std::memory_order_acquire);
+            if (ui32Sequence == (2 * pReader_p->m_ui32NextRecNum))
+            {
+                break;
+            }
+
+            // overwritten between reading the head and the slot
+            pReader_p->m_ui64Lost++;
+            pReader_p->m_ui32NextRecNum = SrfNextRecNum(pReader_p->m_ui32NextRecNum);
+        }
+
+        pReader_p->m_pPeekSlot        = pSlot;
+        pReader_p->m_ui32PeekSequence = ui32Sequence;
+    }
+
+    if (pi64PublishTime_p != NULL)
+    {
+        *pi64PublishTime_p = pSlot->m_i64PublishTime;
+    }
+
+    return (&pSlot->m_Record);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Release Record of SrrPeek()
+//---------------------------------------------------------------------------
+//  Returns false if the record was overwritten while it was accessed.
+
+bool  SrrRelease (
+    tSrrReader* pReader_p)                              // [IN/OUT] Ptr to Reader
+{
+
+bool  fValid;
+
+
+    if ((pReader_p == NULL) || (pReader_p->m_pPeekSlot == NULL))
+    {
+        return (false);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    fValid = (pReader_p->m_pPeekSlot->m_ui32Sequence.load(std::memory_order_relaxed) == pReader_p->m_ui32PeekSequence);
+    if ( fValid )
+    {
+        pReader_p->m_ui64Received++;
+    }
+    else
+    {
+        pReader_p->m_ui64Lost++;
+    }
+
+    pReader_p->m_ui32NextRecNum = SrfNextRecNum(pReader_p->m_ui32NextRecNum);
+    pReader_p->m_pPeekSlot = NULL;
+
+    return (fValid);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get copy of next Record
+//---------------------------------------------------------------------------
+//  Returns 1 if a record was copied, 0 if there is no new record and -1 if
+//  there is no new record and the writer has closed the ring.
+
+int  SrrRead (
+    tSrrReader* pReader_p,                              // [IN/OUT] Ptr to Reader
+    tMlfRecord* pRecord_p,                              // [OUT]    Copy of Record
+    int64_t* pi64PublishTime_p)                         // [OUT]    Publish Time (SrfGetTime()), NULL = not needed
+{
+
+const tMlfRecord*  pRecord;
+
+
+    if ((pReader_p == NULL) || (pReader_p->m_pHeader == NULL) || (pRecord_p == NULL))
+    {
+        return (-1);
+    }
+
+    do
+    {
+        pRecord = SrrPeek(pReader_p, pi64PublishTime_p);
+        if (pRecord == NULL)
+        {
+            return ((pReader_p->m_pHeader->m_ui32State.load(std::memory_order_acquire) == kSrfStateOpen) ? 0 : -1);
+        }
+        memcpy(pRecord_p, pRecord, sizeof(tMlfRecord));
+    }
+    while ( !SrrRelease(pReader_p) );
+
+    return (1);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Wait for new Records
+//---------------------------------------------------------------------------
+//  Returns 1 if there is a new record, 0 at timeout and -1 if there is no new
+//  record and the writer has closed the ring or is gone (the caller has to
+//  reopen the ring, a restarted writer creates a new one).
+
+int  SrrWait (
+    tSrrReader* pReader_p,                              // [IN]     Ptr to Reader
+    int iTimeout_p)                                     // [IN]     Timeout [ms] (-1 = infinite)
+{
+
+const tSrfHeader*  pHeader;
+struct timespec    TimeSpec;
+int64_t            i64Deadline;
+int64_t            i64WaitTime;
+uint32_t           ui32Futex;
+
+
+    if ((pReader_p == NULL) || (pReader_p->m_pHeader == NULL))
+    {
+        return (-1);
+    }
+
+    pHeader = pReader_p->m_pHeader;
+    i64Deadline = (iTimeout_p >= 0) ? (SrfGetTime() + ((int64_t)iTimeout_p * 1000000LL)) : INT64_MAX;
+
+    for (;;)
+    {
+        // read the futex word before checking, so that a record published
+        // in between lets FUTEX_WAIT return immediately
+        ui32Futex = pHeader->m_ui32Futex.load(std::memory_order_acquire);
+        if ( SrrIsAvailable(pReader_p) )
+        {
+            return (1);
+        }
+        if (pHeader->m_ui32State.load(std::memory_order_acquire) != kSrfStateOpen)
+        {
+            return (-1);
+        }
+
+        i64WaitTime = i64Deadline - SrfGetTime();
+        if (i64WaitTime <= 0)
+        {
+            return (SrrIsWriterAlive(pReader_p) ? 0 : -1);
+        }
+        if (i64WaitTime > (SRR_ALIVE_CHECK_TIME * 1000000LL))
+        {
+            if ( !SrrIsWriterAlive(pReader_p) )
+            {
+                return (-1);
+            }
+            i64WaitTime = SRR_ALIVE_CHECK_TIME * 1000000LL;
+        }
+
+        TimeSpec.tv_sec  = (time_t)(i64WaitTime / 1000000000LL);
+        TimeSpec.tv_nsec = (long)(i64WaitTime % 1000000000LL);
+        syscall(SYS_futex, (uint32_t*)&pHeader->m_ui32Futex, FUTEX_WAIT, ui32Futex, &TimeSpec, NULL, 0);
+    }
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Check if Writer process still exists
+//---------------------------------------------------------------------------
+//  A writer that was killed can't close the ring, its readers would wait
+//  forever without this check.
+
+bool  SrrIsWriterAlive (
+    const tSrrReader* pReader_p)                        // [IN]     Ptr to Reader
+{
+
+    if ((pReader_p == NULL) || (pReader_p->m_pHeader == NULL))
+    {
+        return (false);
+    }
+    if (pReader_p->m_pHeader->m_ui32State.load(std::memory_order_acquire) != kSrfStateOpen)
+    {
+        return (false);
+    }
+
+    // EPERM: process exists, but belongs to another user
+    return ((kill((pid_t)pReader_p->m_pHeader->m_i32WriterPid, 0) == 0) || (errno == EPERM));
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Check for Record not read yet
+//---------------------------------------------------------------------------
+
+static  inline  bool  SrrIsAvailable (
+    const tSrrReader* pReader_p)
+{
+
+uint32_t  ui32Head;
+
+
+    ui32Head = pReader_p->m_pHeader->m_ui32Head.load(std::memory_order_acquire);
+
+    return ((int32_t)(ui32Head - pReader_p->m_ui32NextRecNum) >= 0);
+
+}
+
+
+
+// EOF
@@ -0,0 +1,112 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Declarations for Reader of Shared Memory Ring
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _SHMRINGREADER_H_
+#define _SHMRINGREADER_H_
+
+#include "ShmRingFormat.h"
+
+
+
+//---------------------------------------------------------------------------
+//  Usage
+//---------------------------------------------------------------------------
+// Notice:  Small library for local consumers (display, alarm daemon, ...) of
+//          the records published by 'LoraPacketRecv -x'. It only depends on
+//          ShmRingFormat.h, MessageLogFormat.h and LoraPacketSchema.h, so it
+//          can be built into any application (link with -lrt on older glibc).
+//
+//              SrrOpen(SRF_DEF_NAME, false, &Reader);
+//              while (SrrWait(&Reader, -1) >= 0)
+//              {
+//                  while ((pRecord = SrrPeek(&Reader, NULL)) != NULL)
+//                  {
+//                      ...                         // use record in place
+//                      if ( !SrrRelease(&Reader) )
+//                      {
+//                          ...                     // was overwritten meanwhile, discard
+//                      }
+//                  }
+//              }
+//              SrrClose(&Reader);                  // writer has closed or is gone: reopen
+//
+//          SrrPeek() returns the record in place without any copy, SrrRead()
+//          copies it (64 Bytes) for consumers that keep it longer. The fields
+//          are decoded like those of a binary MessageLog (MlrGetRecordFields()
+//          or LoraField<> of LoraPacketSchema.h on <m_abSchemaRec>).
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Type definitions
+//---------------------------------------------------------------------------
+
+//  One attached reader, used by a single thread (several threads of a
+//  process use their own <tSrrReader>)
+typedef struct
+{
+    const uint8_t*      m_pabMapAddr;               // read-only mapping of the whole ring
+    size_t              m_nMapSize;
+    const tSrfHeader*   m_pHeader;
+    const tSrfSlot*     m_pSlots;
+    uint32_t            m_ui32SlotMask;
+    uint32_t            m_ui32NextRecNum;           // next record to read
+    const tSrfSlot*     m_pPeekSlot;                // slot returned by SrrPeek() (NULL = none)
+    uint32_t            m_ui32PeekSequence;
+    uint64_t            m_ui64Received;
+    uint64_t            m_ui64Lost;                 // overwritten before they were read
+
+} tSrrReader;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of public functions
+//---------------------------------------------------------------------------
+
+int  SrrOpen (
+    const char* pszName_p,                              // [IN]     Name of Shared Memory Object ('/<name>')
+    bool fFromOldest_p,                                 // [IN]     Start with oldest record in ring (otherwise only new records)
+    tSrrReader* pReader_p);                             // [OUT]    Ptr to Reader
+
+int  SrrClose (
+    tSrrReader* pReader_p);                             // [IN/OUT] Ptr to Reader
+
+const tMlfRecord*  SrrPeek (
+    tSrrReader* pReader_p,                              // [IN/OUT] Ptr to Reader
+    int64_t* pi64PublishTime_p);                        // [OUT]    Publish Time (SrfGetTime()), NULL = not needed
+
+bool  SrrRelease (
+    tSrrReader* pReader_p);                             // [IN/OUT] Ptr to Reader
+
+int  SrrRead (
+    tSrrReader* pReader_p,                              // [IN/OUT] Ptr to Reader
+    tMlfRecord* pRecord_p,                              // [OUT]    Copy of Record
+    int64_t* pi64PublishTime_p);                        // [OUT]    Publish Time (SrfGetTime()), NULL = not needed
+
+int  SrrWait (
+    tSrrReader* pReader_p,                              // [IN]     Ptr to Reader
+    int iTimeout_p);                                    // [IN]     Timeout [ms] (-1 = infinite)
+
+bool  SrrIsWriterAlive (
+    const tSrrReader* pReader_p);                       // [IN]     Ptr to Reader
+
+
+
+#endif  // #ifndef _SHMRINGREADER_H_
+
+
+// EOF
@@ -0,0 +1,339 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Implementation of Writer of Shared Memory Ring
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+
+#include <RH_RF95.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "LoraPacket.h"
+#include "LoraPacketSchema.h"
+#include "LoraPayloadDecoder.h"
+#include "PacketProcessing.h"
+#include "MessageFileWriter.h"
+#include "ShmRingWriter.h"
+#include "Trace.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+#define SRW_MIN_SLOTS           16
+#define SRW_MAX_SLOTS           (1024 * 1024)
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+static  char                    szName_l[NAME_MAX]  = "";
+static  tSrfHeader*             pHeader_l           = NULL;
+static  tSrfSlot*               pSlots_l            = NULL;
+static  size_t                  nMapSize_l          = 0;
+static  uint32_t                ui32SlotMask_l      = 0;
+static  uint32_t                ui32Head_l          = 0;        // number of last published record
+static  uint64_t                ui64Published_l     = 0;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  void  SrwWakeReaders (void);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Create Shared Memory Ring
+//---------------------------------------------------------------------------
+//  An existing object of the same name (e.g. left by a crashed gateway) is
+//  removed first. Readers still attached to it keep their mapping, they
+//  notice the missing writer and reattach to the new ring.
+
+int  SrwOpen (
+    const char* pszName_p,                              // [IN]     Name of Shared Memory Object ('/<name>', NULL = SRF_DEF_NAME)
+    uint uiSlots_p)                                     // [IN]     Number of Slots (rounded up to power of 2, 0 = SRW_DEF_SLOTS)
+{
+
+void*     pMapAddr;
+uint32_t  ui32Slots;
+int       iFd;
+
+
+    if (pHeader_l != NULL)
+    {
+        return (-1);
+    }
+
+    if (pszName_p == NULL)
+    {
+        pszName_p = SRF_DEF_NAME;
+    }
+    if ((pszName_p[0] != '/') || (pszName_p[1] == '\0') || (strchr(pszName_p+1, '/') != NULL) ||
+        (strlen(pszName_p) >= sizeof(szName_l)))
+    {
+        TRACE0("ERROR: invalid name of shared memory object!\n");
+        return (-2);
+    }
+    if (uiSlots_p == 0)
+    {
+        uiSlots_p = SRW_DEF_SLOTS;
+    }
+    if (uiSlots_p > SRW_MAX_SLOTS)
+    {
+        return (-3);
+    }
+    for (ui32Slots=SRW_MIN_SLOTS; ui32Slots<uiSlots_p; ui32Slots<<=1)
+    {
+    }
+
+    shm_unlink(pszName_p);
+    iFd = shm_open(pszName_p, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    TRACE2("\nCreate Shared Memory Ring: pszName_p='%s' -> iFd=%d\n", pszName_p, iFd);
+    if (iFd < 0)
+    {
+        return (-4);
+    }
+
+    nMapSize_l = SRF_HEADER_SIZE + ((size_t)ui32Slots * SRF_SLOT_SIZE);
+    if (ftruncate(iFd, (off_t)nMapSize_l) != 0)
+    {
+        close(iFd);
+        shm_unlink(pszName_p);
+        return (-5);
+    }
+    pMapAddr = mmap(NULL, nMapSize_l, PROT_READ | PROT_WRITE, MAP_SHARED, iFd, 0);
+    close(iFd);
+    if (pMapAddr == MAP_FAILED)
+    {
+        shm_unlink(pszName_p);
+        return (-6);
+    }
+
+    // the object is zero-filled by ftruncate(), so all slots are empty
+    strcpy(szName_l, pszName_p);
+    pHeader_l       = (tSrfHeader*)pMapAddr;
+    pSlots_l        = (tSrfSlot*)((uint8_t*)pMapAddr + SRF_HEADER_SIZE);
+    ui32SlotMask_l  = ui32Slots - 1;
+    ui32Head_l      = 0;
+    ui64Published_l = 0;
+
+    memcpy(pHeader_l->m_achMagic, SRF_MAGIC, sizeof(pHeader_l->m_achMagic));
+    pHeader_l->m_ui16FormatVersion = SRF_FORMAT_VERSION;
+    pHeader_l->m_ui16SchemaVersion = LORA_SCHEMA_VERSION;
+    pHeader_l->m_ui16HeaderSize    = (uint16_t)SRF_HEADER_SIZE;
+    pHeader_l->m_ui16SlotSize      = (uint16_t)SRF_SLOT_SIZE;
+    pHeader_l->m_ui32Slots         = ui32Slots;
+    pHeader_l->m_i32WriterPid      = (int32_t)getpid();
+    pHeader_l->m_i64CreateTime     = (int64_t)time(NULL);
+    pHeader_l->m_ui32Head.store(0, std::memory_order_relaxed);
+    pHeader_l->m_ui32Futex.store(0, std::memory_order_relaxed);
+    pHeader_l->m_ui32State.store(kSrfStateOpen, std::memory_order_release);
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Close Shared Memory Ring
+//---------------------------------------------------------------------------
+
+int  SrwClose (void)
+{
+
+    if (pHeader_l == NULL)
+    {
+        return (-1);
+    }
+
+    pHeader_l->m_ui32State.store(kSrfStateClosed, std::memory_order_release);
+    SrwWakeReaders();
+
+    munmap(pHeader_l, nMapSize_l);
+    shm_unlink(szName_l);
+
+    pHeader_l      = NULL;
+    pSlots_l       = NULL;
+    nMapSize_l     = 0;
+    ui32SlotMask_l = 0;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Publish Json Message as binary Record
+//---------------------------------------------------------------------------
+//  The record is built directly in its slot, between the two updates of the
+//  sequence lock. A reader copying or accessing the slot at the same time
+//  sees the changed sequence afterwards and discards what it has read.
+
+int  SrwPublish (
+    const tJsonMessage* pJsonMessage_p)                 // [IN]     Json Message (Bootup or Data Record)
+{
+
+tSrfSlot*  pSlot;
+uint32_t   ui32RecNum;
+
+
+    if ((pJsonMessage_p == NULL) || (pHeader_l == NULL))
+    {
+        return (-1);
+    }
+
+    ui32RecNum = SrfNextRecNum(ui32Head_l);
+    pSlot = &pSlots_l[ui32RecNum & ui32SlotMask_l];
+
+    pSlot->m_ui32Sequence.store((2 * ui32RecNum) - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    pSlot->m_i64PublishTime = SrfGetTime();
+    MfwBuildBinaryRecord(pJsonMessage_p, &pSlot->m_Record);
+
+    pSlot->m_ui32Sequence.store(2 * ui32RecNum, std::memory_order_release);
+    pHeader_l->m_ui32Head.store(ui32RecNum, std::memory_order_release);
+    ui32Head_l = ui32RecNum;
+    ui64Published_l++;
+
+    SrwWakeReaders();
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Statistics
+//---------------------------------------------------------------------------
+
+void  SrwGetStatistics (
+    tSrwStatistics* pStatistics_p)                      // [OUT]    Ptr to Statistics
+{
+
+    if (pStatistics_p == NULL)
+    {
+        return;
+    }
+
+    memset(pStatistics_p, 0, sizeof(tSrwStatistics));
+    pStatistics_p->m_ui64Published = ui64Published_l;
+    pStatistics_p->m_uiSlots       = ui32SlotMask_l + 1;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Print Statistics
+//---------------------------------------------------------------------------
+
+void  SrwPrintStatistics (void)
+{
+
+tSrwStatistics  Statistics;
+
+
+    SrwGetStatistics(&Statistics);
+
+    printf("Shared Memory Ring:\n");
+    printf("  Name              = '%s' (%u slots)\n", szName_l, Statistics.m_uiSlots);
+    printf("  Records published = %llu\n", (unsigned long long)Statistics.m_ui64Published);
+
+    return;
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Wake up Readers waiting for new Records
+//---------------------------------------------------------------------------
+//  The readers map the ring read-only, so the writer doesn't know whether
+//  anybody waits and always calls FUTEX_WAKE (no futex of a process-private
+//  mapping, the readers are other processes).
+
+static  void  SrwWakeReaders (void)
+{
+
+    pHeader_l->m_ui32Futex.fetch_add(1, std::memory_order_release);
+    syscall(SYS_futex, &pHeader_l->m_ui32Futex, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+
+    return;
+
+}
+
+
+
+// EOF
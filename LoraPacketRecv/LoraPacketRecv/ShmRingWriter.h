@@ -0,0 +1,73 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Declarations for Writer of Shared Memory Ring
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _SHMRINGWRITER_H_
+#define _SHMRINGWRITER_H_
+
+#include "ShmRingFormat.h"
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+// Notice:  Each Json Message is published as binary record into the Shared
+//          Memory Ring right after decoding (see ShmRingFormat.h for the
+//          layout and ShmRingReader.h for the reader library). Publishing
+//          never waits for readers, it costs one copy of 64 Bytes and one
+//          FUTEX_WAKE to wake up waiting readers.
+//---------------------------------------------------------------------------
+
+const  uint  SRW_DEF_SLOTS      = 4096;                 // 512 KB
+
+
+
+//---------------------------------------------------------------------------
+//  Type definitions
+//---------------------------------------------------------------------------
+
+typedef struct
+{
+    uint64_t            m_ui64Published;
+    uint                m_uiSlots;
+
+} tSrwStatistics;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of public functions
+//---------------------------------------------------------------------------
+
+int  SrwOpen (
+    const char* pszName_p,                              // [IN]     Name of Shared Memory Object ('/<name>', NULL = SRF_DEF_NAME)
+    uint uiSlots_p);                                    // [IN]     Number of Slots (rounded up to power of 2, 0 = SRW_DEF_SLOTS)
+
+int  SrwClose (void);
+
+int  SrwPublish (
+    const tJsonMessage* pJsonMessage_p);                // [IN]     Json Message (Bootup or Data Record)
+
+void  SrwGetStatistics (
+    tSrwStatistics* pStatistics_p);                     // [OUT]    Ptr to Statistics
+
+void  SrwPrintStatistics (void);
+
+
+
+#endif  // #ifndef _SHMRINGWRITER_H_
+
+
+// EOF
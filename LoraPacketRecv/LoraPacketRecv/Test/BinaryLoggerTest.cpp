@@ -0,0 +1,428 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Host Test and Benchmark for Binary Ring Buffer Logger
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include <string>
+#include "BinaryLogger.h"
+#include "TestCheck.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+const  unsigned int  TST_THREAD_COUNT       = 4;        // producer threads of multi-thread test
+const  unsigned int  TST_THREAD_RECORDS     = 20000;    // records per producer thread
+const  unsigned int  TST_BENCH_ITERATIONS   = 1000000;  // log calls per benchmark run
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+TST_DEFINE_COUNTERS()
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  void  TstFormatting (void);
+static  void  TstLogLevels (void);
+static  void  TstStoppedLogger (void);
+static  void  TstMultiThread (void);
+static  void  TstRingOverflow (void);
+
+static  std::string  TstReadStream (FILE* pStream_p);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Main function of this application
+//---------------------------------------------------------------------------
+//  Without arguments the functional checks are run ('make test'), option
+//  '-b' runs the hot-path benchmark BLG_LOG() vs. printf() ('make bench').
+
+int  main (int iArgCnt_p, char* apszArg_p[])
+{
+
+    if ((iArgCnt_p > 1) && !strcmp(apszArg_p[1], "-b"))
+    {
+        return (BlgRunBenchmark(TST_BENCH_ITERATIONS));
+    }
+
+    TstFormatting();
+    TstLogLevels();
+    TstStoppedLogger();
+    TstMultiThread();
+    TstRingOverflow();
+
+    return (TST_RESULT("BinaryLoggerTest"));
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Deferred Formatting must match printf() for all supported Conversions
+//---------------------------------------------------------------------------
+
+static  void  TstFormatting (void)
+{
+
+static const char*  pszFmtInt   = "i8=%d i16=%d i32=%i i64=%lld u8=%u u16=%04u u64=%llu\n";
+static const char*  pszFmtHex   = "x=%x X=%08X o=%o c=%c pct=100%%\n";
+static const char*  pszFmtFloat = "f=%.3f e=%e g=%g w=[%*d] s=[%-8s] s2=[%s]\n";
+
+FILE*        pStream;
+char         szExpected[512];
+std::string  strExpected;
+std::string  strLongArg;
+std::string  strOutput;
+
+
+    printf("Test: Formatting\n");
+
+    pStream = tmpfile();
+    TST_CHECK(pStream != NULL);
+    if (pStream == NULL)
+    {
+        return;
+    }
+
+    BlgInitialize(0, kBlgLevelDebug, pStream);
+
+    BLG_INFO(pszFmtInt, (int8_t)-128, (int16_t)-32768, (int32_t)INT32_MIN, (long long)INT64_MIN,
+                        (uint8_t)255, (uint16_t)7, (unsigned long long)UINT64_MAX);
+    snprintf(szExpected, sizeof(szExpected), pszFmtInt, -128, -32768, INT32_MIN, (long long)INT64_MIN,
+                                                        255u, 7u, (unsigned long long)UINT64_MAX);
+    strExpected += szExpected;
+
+    BLG_INFO(pszFmtHex, 0xBEEFu, 0x1234u, 8u, 'A');
+    snprintf(szExpected, sizeof(szExpected), pszFmtHex, 0xBEEFu, 0x1234u, 8u, 'A');
+    strExpected += szExpected;
+
+    BLG_DEBUG(pszFmtFloat, 3.14159, -1.5e-7, 0.25f, 6, -42, "LoRa", "");
+    snprintf(szExpected, sizeof(szExpected), pszFmtFloat, 3.14159, -1.5e-7, 0.25, 6, -42, "LoRa", "");
+    strExpected += szExpected;
+
+    // string arguments are truncated to BLG_MAX_STR_LEN
+    strLongArg.assign(BLG_MAX_STR_LEN + 100, 'x');
+    BLG_INFO("%s\n", strLongArg.c_str());
+    strExpected += std::string(BLG_MAX_STR_LEN, 'x') + "\n";
+
+    // missing arguments are marked instead of reading beyond the record
+    BLG_INFO("a=%d b=%d\n", 1);
+    strExpected += "a=1 b=<?>\n";
+
+    TST_CHECK_EQUAL(BlgFlush(), 0);
+    BlgShutdown();
+
+    strOutput = TstReadStream(pStream);
+    TST_CHECK(strOutput == strExpected);
+    if (strOutput != strExpected)
+    {
+        printf("  expected:\n%s  got:\n%s", strExpected.c_str(), strOutput.c_str());
+    }
+
+    fclose(pStream);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Runtime Log Level suppresses Records before they reach the Ring
+//---------------------------------------------------------------------------
+
+static  void  TstLogLevels (void)
+{
+
+FILE*  pStream;
+
+
+    printf("Test: Log Levels\n");
+
+    pStream = tmpfile();
+    TST_CHECK(pStream != NULL);
+    if (pStream == NULL)
+    {
+        return;
+    }
+
+    BlgInitialize(0, kBlgLevelWarning, pStream);
+    BLG_ERROR("E%d\n", 1);
+    BLG_WARNING("W%d\n", 2);
+    BLG_INFO("I%d\n", 3);
+    BLG_TRACE("T%d\n", 4);
+
+    BlgSetLogLevel(kBlgLevelTrace);
+    BLG_TRACE("T%d\n", 5);
+    BlgSetLogLevel(kBlgLevelError);
+    BLG_WARNING("W%d\n", 6);
+    BLG_ERROR("E%d\n", 7);
+    BlgShutdown();
+
+    TST_CHECK(TstReadStream(pStream) == "E1\nW2\nT5\nE7\n");
+
+    // out-of-range levels are clamped
+    BlgSetLogLevel(99);
+    TST_CHECK_EQUAL(BlgGetLogLevel(), kBlgLevelTrace);
+    BlgSetLogLevel(-5);
+    TST_CHECK_EQUAL(BlgGetLogLevel(), kBlgLevelError);
+
+    fclose(pStream);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Records of a stopped Logger are formatted synchronously by the Caller
+//---------------------------------------------------------------------------
+
+static  void  TstStoppedLogger (void)
+{
+
+FILE*  pStream;
+
+
+    printf("Test: Stopped Logger\n");
+
+    pStream = tmpfile();
+    TST_CHECK(pStream != NULL);
+    if (pStream == NULL)
+    {
+        return;
+    }
+
+    // start and stop once, so that the logger keeps 'pStream' as output
+    BlgInitialize(0, kBlgLevelInfo, pStream);
+    BlgShutdown();
+
+    TST_CHECK_EQUAL(BlgRegisterThread(), -1);
+    TST_CHECK_EQUAL(BlgShutdown(), -1);
+    BLG_INFO("sync %u\n", 42u);
+    fflush(pStream);
+
+    TST_CHECK(TstReadStream(pStream) == "sync 42\n");
+
+    fclose(pStream);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Records of concurrent Threads are complete and in Order per Thread
+//---------------------------------------------------------------------------
+
+static  void  TstMultiThread (void)
+{
+
+std::vector<std::thread>  vecThreads;
+std::vector<unsigned int> vecNextSeq(TST_THREAD_COUNT, 0);
+FILE*         pStream;
+char          szLine[64];
+unsigned int  uiThread;
+unsigned int  uiSeq;
+unsigned int  uiLines;
+uint64_t      ui64DropsBefore;
+bool          fInOrder;
+
+
+    printf("Test: Multi-Thread\n");
+
+    pStream = tmpfile();
+    TST_CHECK(pStream != NULL);
+    if (pStream == NULL)
+    {
+        return;
+    }
+
+    ui64DropsBefore = BlgGetDropCount();
+
+    // ring large enough for all records of a thread -> nothing may be dropped
+    BlgInitialize(TST_THREAD_RECORDS * 64, kBlgLevelInfo, pStream);
+    for (uiThread=0; uiThread<TST_THREAD_COUNT; uiThread++)
+    {
+        vecThreads.push_back(std::thread([uiThread]()
+        {
+            unsigned int  uiIdx;
+
+            BlgRegisterThread();
+            for (uiIdx=0; uiIdx<TST_THREAD_RECORDS; uiIdx++)
+            {
+                BLG_INFO("T%u %u\n", uiThread, uiIdx);
+            }
+        }));
+    }
+    for (uiThread=0; uiThread<vecThreads.size(); uiThread++)
+    {
+        vecThreads[uiThread].join();
+    }
+    TST_CHECK_EQUAL(BlgFlush(), 0);
+    BlgShutdown();
+
+    TST_CHECK_EQUAL(BlgGetDropCount() - ui64DropsBefore, 0);
+
+    rewind(pStream);
+    uiLines  = 0;
+    fInOrder = true;
+    while (fgets(szLine, sizeof(szLine), pStream) != NULL)
+    {
+        if ((sscanf(szLine, "T%u %u", &uiThread, &uiSeq) != 2) ||
+            (uiThread >= TST_THREAD_COUNT) || (uiSeq != vecNextSeq[uiThread]))
+        {
+            fInOrder = false;
+            break;
+        }
+        vecNextSeq[uiThread]++;
+        uiLines++;
+    }
+    TST_CHECK(fInOrder);
+    TST_CHECK_EQUAL(uiLines, TST_THREAD_COUNT * TST_THREAD_RECORDS);
+
+    fclose(pStream);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  A full Ring drops Records, each Record is either written or counted
+//---------------------------------------------------------------------------
+
+static  void  TstRingOverflow (void)
+{
+
+FILE*         pStream;
+char          szLine[64];
+unsigned int  uiIdx;
+unsigned int  uiLines;
+uint64_t      ui64DropsBefore;
+uint64_t      ui64Drops;
+
+
+    printf("Test: Ring Overflow\n");
+
+    pStream = tmpfile();
+    TST_CHECK(pStream != NULL);
+    if (pStream == NULL)
+    {
+        return;
+    }
+
+    ui64DropsBefore = BlgGetDropCount();
+
+    // smallest ring, burst without any pause -> the caller must never block
+    BlgInitialize(1, kBlgLevelInfo, pStream);
+    for (uiIdx=0; uiIdx<TST_THREAD_RECORDS; uiIdx++)
+    {
+        BLG_INFO("R %u\n", uiIdx);
+    }
+    BlgFlush();
+    BlgShutdown();
+
+    ui64Drops = BlgGetDropCount() - ui64DropsBefore;
+
+    rewind(pStream);
+    uiLines = 0;
+    while (fgets(szLine, sizeof(szLine), pStream) != NULL)
+    {
+        uiLines++;
+    }
+    printf("  %u records written, %llu dropped\n", uiLines, (unsigned long long)ui64Drops);
+    TST_CHECK(ui64Drops > 0);
+    TST_CHECK_EQUAL(uiLines + ui64Drops, TST_THREAD_RECORDS);
+
+    fclose(pStream);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Read complete Content of a temporary Stream
+//---------------------------------------------------------------------------
+
+static  std::string  TstReadStream (
+    FILE* pStream_p)                                    // [IN]     Stream to read
+{
+
+std::string  strContent;
+char         szBuff[256];
+size_t       nRead;
+
+
+    fflush(pStream_p);
+    rewind(pStream_p);
+    while ((nRead = fread(szBuff, 1, sizeof(szBuff), pStream_p)) > 0)
+    {
+        strContent.append(szBuff, nRead);
+    }
+
+    return (strContent);
+
+}
+
+
+
+// EOF
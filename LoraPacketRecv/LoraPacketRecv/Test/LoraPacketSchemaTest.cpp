@@ -0,0 +1,1107 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Host Test and Benchmark for the Field Access of the
+                Packet Schema (LoraPacketSchema.h)
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 Encoding of Data Record compared with V1.00 Firmware
+  2026/10/18 -rs:   V1.02 Decoding compared with / benchmarked against V1.00 Bitfields
+
+****************************************************************************/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "LoraPacket.h"
+#include "LoraPacketSchema.h"
+#include "TestCheck.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+const  unsigned int  TST_RANDOM_RECORDS     = 2000;             // random Records per Field
+const  unsigned int  TST_GUARD_BYTES        = 4;                // Guard before and after the Record
+const  unsigned int  TST_BENCH_RECORDS      = 4096;             // Records per Benchmark Pass
+const  unsigned int  TST_BENCH_PASSES       = 2000;
+const  unsigned int  TST_V100_RANDOM_RECS   = 100000;           // random Sensor Values encoded as by V1.00
+const  unsigned int  TST_V100_MAX_REPORTS   = 10;               // mismatching Records printed at most
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+//  Record of max. size (tLoraBootupHeader, tLoraDataHeader, tLoraDataRec = 8 Bytes)
+//  embedded between Guard Bytes, which must never be changed by Put()
+typedef struct
+{
+    uint8_t         m_abGuardHead[TST_GUARD_BYTES];
+    uint8_t         m_abRec[8];
+    uint8_t         m_abGuardTail[TST_GUARD_BYTES];
+
+} tTstRecBuff;
+
+
+//  Schema with a single field at any Bit Position and Size, to check all
+//  combinations of SHIFT and BYTES, not only those used by the Packets
+template <unsigned int uiBitPos_p, unsigned int uiBits_p>
+struct  TstSyntheticSchema
+{
+    static constexpr tLoraFieldDesc  DESC[1] =
+    {
+        { "Synthetic", "", uiBitPos_p, uiBits_p, kLoraFieldModulo, kLoraRoundNearest, 1, 1, 0, 0, false }
+    };
+};
+
+template <unsigned int uiBitPos_p, unsigned int uiBits_p>
+constexpr tLoraFieldDesc  TstSyntheticSchema<uiBitPos_p, uiBits_p>::DESC[1];
+
+
+//  <tLoraDataRec> of the V1.00 Firmware (LoraPacket.h, C Bitfields), GCC
+//  places the Bitfields little-endian from Bit0 on, as on the ESP32
+#pragma pack(push, 1)
+typedef struct
+{
+    uint64_t        m_ui4PacketType         :  4;
+    uint64_t        m_ui12UptimeSnippet     : 12;
+    uint64_t        m_i8Temperature         :  8;
+    uint64_t        m_ui7Humidity           :  7;
+    uint64_t        m_ui1MotionActive       :  1;
+    uint64_t        m_ui8MotionActiveTime   :  8;
+    uint64_t        m_ui10MotionActiveCount : 10;
+    uint64_t        m_ui6LightLevel         :  6;
+    uint64_t        m_ui8CarBattLevel       :  8;
+
+} tTstV100DataRec;
+#pragma pack(pop)
+
+
+//  Sensor Values of one Data Record (as <tSensorDataRec> of the Firmware)
+typedef struct
+{
+    uint32_t        m_ui32Uptime;
+    float           m_flTemperature;
+    float           m_flHumidity;
+    bool            m_fMotionActive;
+    uint16_t        m_ui16MotionActiveTime;
+    uint16_t        m_ui16MotionActiveCount;
+    uint8_t         m_ui8LightLevel;
+    float           m_flCarBattLevel;
+
+} tTstSensorValues;
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+TST_DEFINE_COUNTERS()
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+static  uint32_t        ui32RandState_l         = 0x13579BDF;
+static  unsigned int    uiFieldsChecked_l       = 0;
+static  unsigned int    uiGetMismatch_l         = 0;
+static  unsigned int    uiPutMismatch_l         = 0;
+static  unsigned int    uiGuardViolation_l      = 0;
+static  unsigned int    uiV100Reports_l         = 0;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  void  TstPacketSchemas (void);
+static  void  TstAllPositionsAndSizes (void);
+static  void  TstKnownLayout (void);
+static  void  TstEncodingAsV100 (void);
+static  void  TstDecodingAsV100 (void);
+static  void  TstRunBenchmark (void);
+
+static  uint32_t  TstRandom (void);
+static  void      TstFillRandom (tTstRecBuff* pRecBuff_p);
+static  void      TstRefPutRaw (const tLoraFieldDesc* pFieldDesc_p, void* pRec_p, uint32_t ui32Raw_p);
+static  double    TstGetTimeNs (void);
+
+static  void      TstEncodeV100 (const tTstSensorValues* pValues_p, uint8_t* pabRec_p);
+static  void      TstEncodeSchema (const tTstSensorValues* pValues_p, uint8_t* pabRec_p);
+static  bool      TstCompareEncoding (const tTstSensorValues* pValues_p);
+static  inline  void   TstDecodeV100 (const tTstV100DataRec* pLoraDataRec_p, tTstSensorValues* pValues_p);
+static  inline  void   TstDecodeSchema (const uint8_t* pabRec_p, tTstSensorValues* pValues_p);
+static  inline  float  TstV100I8ToFloat (int8_t i8DataValue_p);
+static  int8_t    TstV100FloatToI8 (float flDataValue_p);
+static  uint8_t   TstV100FloatToUI7 (float flDataValue_p);
+static  uint8_t   TstV100FloatToUI8 (float flDataValue_p);
+
+template <const tLoraFieldDesc* paSchema_p, unsigned int uiField_p>
+static  void  TstCheckField (void);
+
+template <const tLoraFieldDesc* paSchema_p, unsigned int uiField_p>
+static  inline  uint32_t  TstLoopGet (const void* pRec_p);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Main function of this application
+//---------------------------------------------------------------------------
+//  Without arguments the functional checks are run ('make test'), option
+//  '-b' measures the decoding of <tLoraDataRec> with the fixed-width Field
+//  Access vs. the C Bitfields of the V1.00 Firmware and the Byte Loops
+//  ('make bench').
+
+int  main (int iArgCnt_p, char* apszArg_p[])
+{
+
+    if ((iArgCnt_p > 1) && !strcmp(apszArg_p[1], "-b"))
+    {
+        TstRunBenchmark();
+        return (0);
+    }
+
+    TstPacketSchemas();
+    TstAllPositionsAndSizes();
+    TstKnownLayout();
+    TstEncodingAsV100();
+    TstDecodingAsV100();
+
+    return (TST_RESULT("LoraPacketSchemaTest"));
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Iterate all Fields of a Schema at Compile Time
+//---------------------------------------------------------------------------
+
+template <const tLoraFieldDesc* paSchema_p, unsigned int uiField_p, unsigned int uiNumFields_p>
+struct  TstSchemaFields
+{
+    static void  Check (void)
+    {
+        TstCheckField<paSchema_p, uiField_p>();
+        TstSchemaFields<paSchema_p, uiField_p + 1, uiNumFields_p>::Check();
+    }
+};
+
+template <const tLoraFieldDesc* paSchema_p, unsigned int uiNumFields_p>
+struct  TstSchemaFields<paSchema_p, uiNumFields_p, uiNumFields_p>
+{
+    static void  Check (void)  { }
+};
+
+
+template <unsigned int uiBitPos_p, unsigned int uiBits_p>
+struct  TstSyntheticSizes
+{
+    static void  Check (void)
+    {
+        TstCheckField<TstSyntheticSchema<uiBitPos_p, uiBits_p>::DESC, 0>();
+        TstSyntheticSizes<uiBitPos_p, uiBits_p + 1>::Check();
+    }
+};
+
+template <unsigned int uiBitPos_p>
+struct  TstSyntheticSizes<uiBitPos_p, 33>
+{
+    static void  Check (void)  { }
+};
+
+
+template <unsigned int uiBitPos_p>
+struct  TstSyntheticPositions
+{
+    static void  Check (void)
+    {
+        TstSyntheticSizes<uiBitPos_p, 1>::Check();
+        TstSyntheticPositions<uiBitPos_p + 1>::Check();
+    }
+};
+
+template <>
+struct  TstSyntheticPositions<24>
+{
+    static void  Check (void)  { }
+};
+
+
+
+//---------------------------------------------------------------------------
+//  All Fields of the Packet Schemas are bit-exact to the Byte Loop
+//---------------------------------------------------------------------------
+
+static  void  TstPacketSchemas (void)
+{
+
+    printf("Test: Fields of Packet Schemas\n");
+
+    uiFieldsChecked_l  = 0;
+    uiGetMismatch_l    = 0;
+    uiPutMismatch_l    = 0;
+    uiGuardViolation_l = 0;
+
+    TstSchemaFields<LORA_SCHEMA_BOOTUP_HEADER,  0, kLoraBootupNumFields>::Check();
+    TstSchemaFields<LORA_SCHEMA_DATA_HEADER,    0, kLoraHeaderNumFields>::Check();
+    TstSchemaFields<LORA_SCHEMA_DATA_REC,       0, kLoraDataRecNumFields>::Check();
+    TstSchemaFields<LORA_SCHEMA_DATA_DELTA_REC, 0, kLoraDeltaRecNumFields>::Check();
+
+    TST_CHECK_EQUAL(uiFieldsChecked_l, kLoraBootupNumFields + kLoraHeaderNumFields + kLoraDataRecNumFields + kLoraDeltaRecNumFields);
+    TST_CHECK_EQUAL(uiGetMismatch_l, 0);
+    TST_CHECK_EQUAL(uiPutMismatch_l, 0);
+    TST_CHECK_EQUAL(uiGuardViolation_l, 0);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  All Bit Positions (SHIFT 0..7, 1..5 Bytes) and Sizes 1..32 Bit
+//---------------------------------------------------------------------------
+
+static  void  TstAllPositionsAndSizes (void)
+{
+
+    printf("Test: All Bit Positions and Sizes\n");
+
+    uiFieldsChecked_l  = 0;
+    uiGetMismatch_l    = 0;
+    uiPutMismatch_l    = 0;
+    uiGuardViolation_l = 0;
+
+    // Bit Positions 0..23 and Sizes 1..32 fit into the 8 Bytes of the Record
+    TstSyntheticPositions<0>::Check();
+
+    TST_CHECK_EQUAL(uiFieldsChecked_l, 24 * 32);
+    TST_CHECK_EQUAL(uiGetMismatch_l, 0);
+    TST_CHECK_EQUAL(uiPutMismatch_l, 0);
+    TST_CHECK_EQUAL(uiGuardViolation_l, 0);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Fields of a known Record are placed little-endian as documented
+//---------------------------------------------------------------------------
+
+static  void  TstKnownLayout (void)
+{
+
+uint8_t  abRec[8];
+
+
+    printf("Test: Known Record Layout\n");
+
+    memset(abRec, 0x00, sizeof(abRec));
+    LoraDataHeaderField<kLoraHeaderPacketType>::Put(abRec, 0x2);
+    LoraDataHeaderField<kLoraHeaderDevID>::Put(abRec, 0x7);
+    LoraDataHeaderField<kLoraHeaderSequNum>::Put(abRec, 0x123456);
+    LoraDataHeaderField<kLoraHeaderUptime>::Put(abRec, 0x89ABCDEF);
+
+    TST_CHECK_EQUAL(abRec[0], 0x72);
+    TST_CHECK_EQUAL(abRec[1], 0x56);
+    TST_CHECK_EQUAL(abRec[2], 0x34);
+    TST_CHECK_EQUAL(abRec[3], 0x12);
+    TST_CHECK_EQUAL(abRec[4], 0xEF);
+    TST_CHECK_EQUAL(abRec[5], 0xCD);
+    TST_CHECK_EQUAL(abRec[6], 0xAB);
+    TST_CHECK_EQUAL(abRec[7], 0x89);
+
+    // Field across a Byte Boundary with Shift (MotionActiveCount: Bit 40..49)
+    memset(abRec, 0xFF, sizeof(abRec));
+    LoraDataRecField<kLoraDataRecMotionActiveCount>::Put(abRec, 0x2A5);
+    TST_CHECK_EQUAL(abRec[5], 0xA5);
+    TST_CHECK_EQUAL(abRec[6], 0xFE);
+    TST_CHECK_EQUAL(LoraDataRecField<kLoraDataRecMotionActiveCount>::Get(abRec), 0x2A5);
+    TST_CHECK_EQUAL(LoraDataRecField<kLoraDataRecLightLevel>::Get(abRec), 0x3F);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Encoding of Sensor Values is bit-exact to the V1.00 Firmware
+//---------------------------------------------------------------------------
+//  The V1.00 Encoder truncated the LightLevel and rounded the MotionActiveTime,
+//  both wrapped around at the end of their field. Each value is swept over
+//  its range (LightLevel and MotionActiveTime over the whole input type),
+//  the other values are kept at a typical setting.
+
+static  void  TstEncodingAsV100 (void)
+{
+
+tTstSensorValues  Values;
+tTstSensorValues  Typical;
+unsigned int      uiMismatch;
+unsigned int      uiRec;
+int               iValue;
+
+
+    printf("Test: Encoding of Data Record as V1.00 Firmware\n");
+
+    Typical.m_ui32Uptime            = 86400;
+    Typical.m_flTemperature         = 21.5f;
+    Typical.m_flHumidity            = 45.0f;
+    Typical.m_fMotionActive         = true;
+    Typical.m_ui16MotionActiveTime  = 120;
+    Typical.m_ui16MotionActiveCount = 17;
+    Typical.m_ui8LightLevel         = 64;
+    Typical.m_flCarBattLevel        = 12.6f;
+
+    // values reported by review of the schema
+    TST_CHECK_EQUAL(LoraDataRecField<kLoraDataRecLightLevel>::FromInt(1), 0);
+    TST_CHECK_EQUAL(LoraDataRecField<kLoraDataRecLightLevel>::FromInt(51), 25);
+    TST_CHECK_EQUAL(LoraDataRecField<kLoraDataRecLightLevel>::FromInt(99), 49);
+    TST_CHECK_EQUAL(LoraDataRecField<kLoraDataRecMotionActiveTime>::FromInt(2555), 0);
+    TST_CHECK_EQUAL(LoraDataRecField<kLoraDataRecMotionActiveTime>::FromInt(2600), 4);
+
+    // LightLevel: 0..100 [%] and the rest of uint8_t
+    uiMismatch = 0;
+    Values = Typical;
+    for (iValue=0; iValue<=255; iValue++)
+    {
+        Values.m_ui8LightLevel = (uint8_t)iValue;
+        uiMismatch += (TstCompareEncoding(&Values) ? 0 : 1);
+    }
+    TST_CHECK_EQUAL(uiMismatch, 0);
+
+    // MotionActiveTime: whole uint16_t (wraps around above 2550 [sec])
+    uiMismatch = 0;
+    Values = Typical;
+    for (iValue=0; iValue<=65535; iValue++)
+    {
+        Values.m_ui16MotionActiveTime = (uint16_t)iValue;
+        uiMismatch += (TstCompareEncoding(&Values) ? 0 : 1);
+    }
+    TST_CHECK_EQUAL(uiMismatch, 0);
+
+    // MotionActiveCount: whole uint16_t (wraps around above 1023)
+    uiMismatch = 0;
+    Values = Typical;
+    for (iValue=0; iValue<=65535; iValue++)
+    {
+        Values.m_ui16MotionActiveCount = (uint16_t)iValue;
+        uiMismatch += (TstCompareEncoding(&Values) ? 0 : 1);
+    }
+    TST_CHECK_EQUAL(uiMismatch, 0);
+
+    // Temperature: -80.00..+80.00 [C] in steps of 0.01 (limited to -63.5..+63.5)
+    uiMismatch = 0;
+    Values = Typical;
+    for (iValue=-8000; iValue<=8000; iValue++)
+    {
+        Values.m_flTemperature = (float)iValue / 100.0f;
+        uiMismatch += (TstCompareEncoding(&Values) ? 0 : 1);
+    }
+    TST_CHECK_EQUAL(uiMismatch, 0);
+
+    // Humidity: -10.00..+140.00 [%] in steps of 0.01 (limited to 0..127)
+    uiMismatch = 0;
+    Values = Typical;
+    for (iValue=-1000; iValue<=14000; iValue++)
+    {
+        Values.m_flHumidity = (float)iValue / 100.0f;
+        uiMismatch += (TstCompareEncoding(&Values) ? 0 : 1);
+    }
+    TST_CHECK_EQUAL(uiMismatch, 0);
+
+    // CarBattLevel: -1.000..+30.000 [V] in steps of 0.001 (limited to 0..25.5)
+    uiMismatch = 0;
+    Values = Typical;
+    for (iValue=-1000; iValue<=30000; iValue++)
+    {
+        Values.m_flCarBattLevel = (float)iValue / 1000.0f;
+        uiMismatch += (TstCompareEncoding(&Values) ? 0 : 1);
+    }
+    TST_CHECK_EQUAL(uiMismatch, 0);
+
+    // random Values of all Fields, Uptime over the whole uint32_t
+    uiMismatch = 0;
+    for (uiRec=0; uiRec<TST_V100_RANDOM_RECS; uiRec++)
+    {
+        Values.m_ui32Uptime            = TstRandom();
+        Values.m_flTemperature         = (float)((int)(TstRandom() % 16001) - 8000) / 100.0f;
+        Values.m_flHumidity            = (float)((int)(TstRandom() % 15001) - 1000) / 100.0f;
+        Values.m_fMotionActive         = ((TstRandom() & 1) != 0);
+        Values.m_ui16MotionActiveTime  = (uint16_t)TstRandom();
+        Values.m_ui16MotionActiveCount = (uint16_t)TstRandom();
+        Values.m_ui8LightLevel         = (uint8_t)TstRandom();
+        Values.m_flCarBattLevel        = (float)((int)(TstRandom() % 31001) - 1000) / 1000.0f;
+        uiMismatch += (TstCompareEncoding(&Values) ? 0 : 1);
+    }
+    TST_CHECK_EQUAL(uiMismatch, 0);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Decoding of Data Record gives the same Values as the V1.00 Gateway
+//---------------------------------------------------------------------------
+
+static  void  TstDecodingAsV100 (void)
+{
+
+uint8_t           abRec[8];
+tTstSensorValues  ValuesV100;
+tTstSensorValues  ValuesSchema;
+unsigned int      uiMismatch;
+unsigned int      uiRec;
+unsigned int      uiByte;
+
+
+    printf("Test: Decoding of Data Record as V1.00 Gateway\n");
+
+    uiMismatch = 0;
+    for (uiRec=0; uiRec<TST_V100_RANDOM_RECS; uiRec++)
+    {
+        for (uiByte=0; uiByte<sizeof(abRec); uiByte++)
+        {
+            abRec[uiByte] = (uint8_t)TstRandom();
+        }
+        TstDecodeV100((const tTstV100DataRec*)abRec, &ValuesV100);
+        TstDecodeSchema(abRec, &ValuesSchema);
+
+        if ( (ValuesV100.m_ui32Uptime            != ValuesSchema.m_ui32Uptime           ) ||
+             (ValuesV100.m_flTemperature         != ValuesSchema.m_flTemperature        ) ||
+             (ValuesV100.m_flHumidity            != ValuesSchema.m_flHumidity           ) ||
+             (ValuesV100.m_fMotionActive         != ValuesSchema.m_fMotionActive        ) ||
+             (ValuesV100.m_ui16MotionActiveTime  != ValuesSchema.m_ui16MotionActiveTime ) ||
+             (ValuesV100.m_ui16MotionActiveCount != ValuesSchema.m_ui16MotionActiveCount) ||
+             (ValuesV100.m_ui8LightLevel         != ValuesSchema.m_ui8LightLevel        ) ||
+             (ValuesV100.m_flCarBattLevel        != ValuesSchema.m_flCarBattLevel       ) )
+        {
+            uiMismatch++;
+        }
+    }
+    TST_CHECK_EQUAL(uiMismatch, 0);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Check one Field against the Byte Loop with random Records and Values
+//---------------------------------------------------------------------------
+
+template <const tLoraFieldDesc* paSchema_p, unsigned int uiField_p>
+static  void  TstCheckField (void)
+{
+
+typedef  LoraField<paSchema_p, uiField_p>  tField;
+
+static const uint32_t  aui32Special[] = { 0x00000000, 0xFFFFFFFF, 0x00000001, 0x80000000, 0x55555555, 0xAAAAAAAA };
+
+tTstRecBuff   RecBuff;
+tTstRecBuff   RefBuff;
+unsigned int  uiRec;
+uint32_t      ui32Raw;
+bool          fGetMismatch;
+bool          fPutMismatch;
+bool          fGuardViolation;
+
+
+    fGetMismatch    = false;
+    fPutMismatch    = false;
+    fGuardViolation = false;
+
+    for (uiRec=0; uiRec<TST_RANDOM_RECORDS; uiRec++)
+    {
+        TstFillRandom(&RecBuff);
+        if (uiRec < sizeof(aui32Special)/sizeof(aui32Special[0]))
+        {
+            memset(RecBuff.m_abRec, (uint8_t)aui32Special[uiRec], sizeof(RecBuff.m_abRec));
+            ui32Raw = aui32Special[(uiRec + 1) % (sizeof(aui32Special)/sizeof(aui32Special[0]))];
+        }
+        else
+        {
+            ui32Raw = TstRandom();
+        }
+        memcpy(&RefBuff, &RecBuff, sizeof(RefBuff));
+
+        // Get() must return the same Raw Value as the runtime Byte Loop
+        if (tField::Get(RecBuff.m_abRec) != LoraSchemaGetRaw(&paSchema_p[uiField_p], RecBuff.m_abRec))
+        {
+            fGetMismatch = true;
+        }
+
+        // Put() must change the same Bits as the Byte Loop, and nothing else
+        tField::Put(RecBuff.m_abRec, ui32Raw);
+        TstRefPutRaw(&paSchema_p[uiField_p], RefBuff.m_abRec, ui32Raw);
+        if (memcmp(RecBuff.m_abRec, RefBuff.m_abRec, sizeof(RecBuff.m_abRec)) != 0)
+        {
+            fPutMismatch = true;
+        }
+        if ((memcmp(RecBuff.m_abGuardHead, RefBuff.m_abGuardHead, TST_GUARD_BYTES) != 0) ||
+            (memcmp(RecBuff.m_abGuardTail, RefBuff.m_abGuardTail, TST_GUARD_BYTES) != 0))
+        {
+            fGuardViolation = true;
+        }
+        if (tField::Get(RecBuff.m_abRec) != (uint32_t)(ui32Raw & tField::Mask()))
+        {
+            fGetMismatch = true;
+        }
+    }
+
+    if (fGetMismatch || fPutMismatch || fGuardViolation)
+    {
+        printf("  Field '%s' (Pos %u, Bits %u): Get %s, Put %s, Guard %s\n",
+               paSchema_p[uiField_p].m_pszName, (unsigned int)tField::BIT_POS, (unsigned int)tField::BITS,
+               (fGetMismatch ? "FAILED" : "ok"), (fPutMismatch ? "FAILED" : "ok"), (fGuardViolation ? "FAILED" : "ok"));
+    }
+
+    uiFieldsChecked_l++;
+    uiGetMismatch_l    += (fGetMismatch ? 1 : 0);
+    uiPutMismatch_l    += (fPutMismatch ? 1 : 0);
+    uiGuardViolation_l += (fGuardViolation ? 1 : 0);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Reference: Put by Byte Loop (Implementation before fixed-width Access)
+//---------------------------------------------------------------------------
+
+static  void  TstRefPutRaw (const tLoraFieldDesc* pFieldDesc_p, void* pRec_p, uint32_t ui32Raw_p)
+{
+
+uint8_t*      pabRec;
+uint64_t      ui64Word;
+uint64_t      ui64Mask;
+unsigned int  uiFirstByte;
+unsigned int  uiLastByte;
+unsigned int  uiShift;
+unsigned int  uiByte;
+
+
+    pabRec      = (uint8_t*)pRec_p;
+    uiFirstByte = pFieldDesc_p->m_ui8BitPos / 8;
+    uiLastByte  = (pFieldDesc_p->m_ui8BitPos + pFieldDesc_p->m_ui8Bits - 1) / 8;
+    uiShift     = pFieldDesc_p->m_ui8BitPos % 8;
+    ui64Mask    = (1ULL << pFieldDesc_p->m_ui8Bits) - 1;
+
+    ui64Word = 0;
+    for (uiByte=uiFirstByte; uiByte<=uiLastByte; uiByte++)
+    {
+        ui64Word |= ((uint64_t)pabRec[uiByte] << (8 * (uiByte - uiFirstByte)));
+    }
+    ui64Word = (ui64Word & ~(ui64Mask << uiShift)) | (((uint64_t)ui32Raw_p & ui64Mask) << uiShift);
+    for (uiByte=uiFirstByte; uiByte<=uiLastByte; uiByte++)
+    {
+        pabRec[uiByte] = (uint8_t)(ui64Word >> (8 * (uiByte - uiFirstByte)));
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Reference: Get by Byte Loop with Bounds known at Compile Time
+//---------------------------------------------------------------------------
+
+template <const tLoraFieldDesc* paSchema_p, unsigned int uiField_p>
+static  inline  uint32_t  TstLoopGet (const void* pRec_p)
+{
+
+typedef  LoraField<paSchema_p, uiField_p>  tField;
+
+const uint8_t*  pabRec;
+uint64_t        ui64Word;
+unsigned int    uiByte;
+
+
+    pabRec   = (const uint8_t*)pRec_p;
+    ui64Word = 0;
+    for (uiByte=tField::FIRST_BYTE; uiByte<=tField::LAST_BYTE; uiByte++)
+    {
+        ui64Word |= ((uint64_t)pabRec[uiByte] << (8 * (uiByte - tField::FIRST_BYTE)));
+    }
+
+    return ((uint32_t)((ui64Word >> tField::SHIFT) & tField::Mask()));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Benchmark: Decoding of <tLoraDataRec>
+//---------------------------------------------------------------------------
+
+static  void  TstRunBenchmark (void)
+{
+
+static uint8_t  abRecords[TST_BENCH_RECORDS][8];
+
+unsigned int    uiRec;
+unsigned int    uiPass;
+unsigned int    uiField;
+double          dblStartNs;
+double          dblBitfieldNs;
+double          dblFieldNs;
+double          dblTmplLoopNs;
+double          dblLoopNs;
+double          dblValuesV100Ns;
+double          dblValuesSchemaNs;
+double          dblRecsPerRun;
+uint32_t        ui32SumBitfield;
+uint32_t        ui32Sum;
+uint32_t        ui32SumTmplLoop;
+uint32_t        ui32SumLoop;
+tTstSensorValues  Values;
+double          dblSumV100;
+double          dblSumSchema;
+
+
+    for (uiRec=0; uiRec<TST_BENCH_RECORDS; uiRec++)
+    {
+        for (uiField=0; uiField<sizeof(abRecords[uiRec]); uiField++)
+        {
+            abRecords[uiRec][uiField] = (uint8_t)TstRandom();
+        }
+    }
+
+    // Baseline: C Bitfields of <tLoraDataRec> in the V1.00 Firmware
+    ui32SumBitfield = 0;
+    dblStartNs = TstGetTimeNs();
+    for (uiPass=0; uiPass<TST_BENCH_PASSES; uiPass++)
+    {
+        for (uiRec=0; uiRec<TST_BENCH_RECORDS; uiRec++)
+        {
+            const tTstV100DataRec*  pLoraDataRec = (const tTstV100DataRec*)abRecords[uiRec];
+            ui32SumBitfield += (uint32_t)pLoraDataRec->m_ui4PacketType;
+            ui32SumBitfield += (uint32_t)pLoraDataRec->m_ui12UptimeSnippet;
+            ui32SumBitfield += (uint32_t)pLoraDataRec->m_i8Temperature;
+            ui32SumBitfield += (uint32_t)pLoraDataRec->m_ui7Humidity;
+            ui32SumBitfield += (uint32_t)pLoraDataRec->m_ui1MotionActive;
+            ui32SumBitfield += (uint32_t)pLoraDataRec->m_ui8MotionActiveTime;
+            ui32SumBitfield += (uint32_t)pLoraDataRec->m_ui10MotionActiveCount;
+            ui32SumBitfield += (uint32_t)pLoraDataRec->m_ui6LightLevel;
+            ui32SumBitfield += (uint32_t)pLoraDataRec->m_ui8CarBattLevel;
+        }
+        __asm__ __volatile__ ("" : : "r" (abRecords) : "memory");
+    }
+    dblBitfieldNs = TstGetTimeNs() - dblStartNs;
+
+    // fixed-width Field Access (used by Encoder and Decoder)
+    ui32Sum = 0;
+    dblStartNs = TstGetTimeNs();
+    for (uiPass=0; uiPass<TST_BENCH_PASSES; uiPass++)
+    {
+        for (uiRec=0; uiRec<TST_BENCH_RECORDS; uiRec++)
+        {
+            const uint8_t*  pabRec = abRecords[uiRec];
+            ui32Sum += LoraDataRecField<kLoraDataRecPacketType>::Get(pabRec);
+            ui32Sum += LoraDataRecField<kLoraDataRecUptimeSnippet>::Get(pabRec);
+            ui32Sum += LoraDataRecField<kLoraDataRecTemperature>::Get(pabRec);
+            ui32Sum += LoraDataRecField<kLoraDataRecHumidity>::Get(pabRec);
+            ui32Sum += LoraDataRecField<kLoraDataRecMotionActive>::Get(pabRec);
+            ui32Sum += LoraDataRecField<kLoraDataRecMotionActiveTime>::Get(pabRec);
+            ui32Sum += LoraDataRecField<kLoraDataRecMotionActiveCount>::Get(pabRec);
+            ui32Sum += LoraDataRecField<kLoraDataRecLightLevel>::Get(pabRec);
+            ui32Sum += LoraDataRecField<kLoraDataRecCarBattLevel>::Get(pabRec);
+        }
+        __asm__ __volatile__ ("" : : "r" (abRecords) : "memory");     // don't hoist Records out of the Pass Loop
+    }
+    dblFieldNs = TstGetTimeNs() - dblStartNs;
+
+    // Byte Loop with Bounds known at Compile Time (LoraField<> before V1.03)
+    ui32SumTmplLoop = 0;
+    dblStartNs = TstGetTimeNs();
+    for (uiPass=0; uiPass<TST_BENCH_PASSES; uiPass++)
+    {
+        for (uiRec=0; uiRec<TST_BENCH_RECORDS; uiRec++)
+        {
+            const uint8_t*  pabRec = abRecords[uiRec];
+            ui32SumTmplLoop += TstLoopGet<LORA_SCHEMA_DATA_REC, kLoraDataRecPacketType>(pabRec);
+            ui32SumTmplLoop += TstLoopGet<LORA_SCHEMA_DATA_REC, kLoraDataRecUptimeSnippet>(pabRec);
+            ui32SumTmplLoop += TstLoopGet<LORA_SCHEMA_DATA_REC, kLoraDataRecTemperature>(pabRec);
+            ui32SumTmplLoop += TstLoopGet<LORA_SCHEMA_DATA_REC, kLoraDataRecHumidity>(pabRec);
+            ui32SumTmplLoop += TstLoopGet<LORA_SCHEMA_DATA_REC, kLoraDataRecMotionActive>(pabRec);
+            ui32SumTmplLoop += TstLoopGet<LORA_SCHEMA_DATA_REC, kLoraDataRecMotionActiveTime>(pabRec);
+            ui32SumTmplLoop += TstLoopGet<LORA_SCHEMA_DATA_REC, kLoraDataRecMotionActiveCount>(pabRec);
+            ui32SumTmplLoop += TstLoopGet<LORA_SCHEMA_DATA_REC, kLoraDataRecLightLevel>(pabRec);
+            ui32SumTmplLoop += TstLoopGet<LORA_SCHEMA_DATA_REC, kLoraDataRecCarBattLevel>(pabRec);
+        }
+        __asm__ __volatile__ ("" : : "r" (abRecords) : "memory");
+    }
+    dblTmplLoopNs = TstGetTimeNs() - dblStartNs;
+
+    // Byte Loop by Field Description (used for JSON and Line Protocol)
+    ui32SumLoop = 0;
+    dblStartNs = TstGetTimeNs();
+    for (uiPass=0; uiPass<TST_BENCH_PASSES; uiPass++)
+    {
+        for (uiRec=0; uiRec<TST_BENCH_RECORDS; uiRec++)
+        {
+            for (uiField=0; uiField<kLoraDataRecNumFields; uiField++)
+            {
+                ui32SumLoop += LoraSchemaGetRaw(&LORA_SCHEMA_DATA_REC[uiField], abRecords[uiRec]);
+            }
+        }
+        __asm__ __volatile__ ("" : : "r" (abRecords) : "memory");
+    }
+    dblLoopNs = TstGetTimeNs() - dblStartNs;
+
+    // Values: V1.00 Gateway (Bitfields and I8ToFloat() etc.)
+    dblSumV100 = 0;
+    dblStartNs = TstGetTimeNs();
+    for (uiPass=0; uiPass<TST_BENCH_PASSES; uiPass++)
+    {
+        for (uiRec=0; uiRec<TST_BENCH_RECORDS; uiRec++)
+        {
+            TstDecodeV100((const tTstV100DataRec*)abRecords[uiRec], &Values);
+            dblSumV100 += Values.m_ui32Uptime + Values.m_flTemperature + Values.m_flHumidity + Values.m_fMotionActive +
+                          Values.m_ui16MotionActiveTime + Values.m_ui16MotionActiveCount + Values.m_ui8LightLevel + Values.m_flCarBattLevel;
+        }
+        __asm__ __volatile__ ("" : : "r" (abRecords) : "memory");
+    }
+    dblValuesV100Ns = TstGetTimeNs() - dblStartNs;
+
+    // Values: LoraField<>::GetInt() / GetFloat() (LoraPayloadDecoder::DecodeDataRecValues())
+    dblSumSchema = 0;
+    dblStartNs = TstGetTimeNs();
+    for (uiPass=0; uiPass<TST_BENCH_PASSES; uiPass++)
+    {
+        for (uiRec=0; uiRec<TST_BENCH_RECORDS; uiRec++)
+        {
+            TstDecodeSchema(abRecords[uiRec], &Values);
+            dblSumSchema += Values.m_ui32Uptime + Values.m_flTemperature + Values.m_flHumidity + Values.m_fMotionActive +
+                            Values.m_ui16MotionActiveTime + Values.m_ui16MotionActiveCount + Values.m_ui8LightLevel + Values.m_flCarBattLevel;
+        }
+        __asm__ __volatile__ ("" : : "r" (abRecords) : "memory");
+    }
+    dblValuesSchemaNs = TstGetTimeNs() - dblStartNs;
+
+    // Speedup > 1 means faster than the Baseline (V1.00 Bitfields)
+    dblRecsPerRun = (double)TST_BENCH_RECORDS * TST_BENCH_PASSES;
+    printf("Decoding of tLoraDataRec (%u Fields, %u Records x %u Passes)\n",
+           (unsigned int)kLoraDataRecNumFields, TST_BENCH_RECORDS, TST_BENCH_PASSES);
+    printf(" Raw Fields:\n");
+    printf("  V1.00 C Bitfields (Baseline)     %7.2f [ns/Record]\n", dblBitfieldNs / dblRecsPerRun);
+    printf("  LoraField<>::Get() fixed-width   %7.2f [ns/Record]  (Speedup %.2f)\n",
+           dblFieldNs / dblRecsPerRun, dblBitfieldNs / dblFieldNs);
+    printf("  Byte Loop, Compile Time Bounds   %7.2f [ns/Record]  (Speedup %.2f)\n",
+           dblTmplLoopNs / dblRecsPerRun, dblBitfieldNs / dblTmplLoopNs);
+    printf("  LoraSchemaGetRaw() Byte Loop     %7.2f [ns/Record]  (Speedup %.2f)\n",
+           dblLoopNs / dblRecsPerRun, dblBitfieldNs / dblLoopNs);
+    printf("  Checksum                         %s\n",
+           (((ui32Sum == ui32SumBitfield) && (ui32Sum == ui32SumTmplLoop) && (ui32Sum == ui32SumLoop)) ? "equal" : "DIFFERENT"));
+    printf(" Values (scaled, sign-extended):\n");
+    printf("  V1.00 Gateway (Baseline)         %7.2f [ns/Record]\n", dblValuesV100Ns / dblRecsPerRun);
+    printf("  LoraField<>::GetInt/GetFloat()   %7.2f [ns/Record]  (Speedup %.2f)\n",
+           dblValuesSchemaNs / dblRecsPerRun, dblValuesV100Ns / dblValuesSchemaNs);
+    printf("  Checksum                         %s\n", ((dblSumV100 == dblSumSchema) ? "equal" : "DIFFERENT"));
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Reference: Encoding of Data Record by V1.00 Firmware
+//---------------------------------------------------------------------------
+//  Expressions of LoraPayloadEncoder::EncodeTxDataPacket() V1.00
+
+static  void  TstEncodeV100 (const tTstSensorValues* pValues_p, uint8_t* pabRec_p)
+{
+
+tTstV100DataRec  LoraDataRec;
+
+
+    memset(&LoraDataRec, 0x00, sizeof(LoraDataRec));
+    LoraDataRec.m_ui4PacketType         = kLoraPacketDataGen0;
+    LoraDataRec.m_ui12UptimeSnippet     = ((pValues_p->m_ui32Uptime / 10) & 0x0FFF);
+    LoraDataRec.m_i8Temperature         = (TstV100FloatToI8(pValues_p->m_flTemperature * 2) & 0xFF);
+    LoraDataRec.m_ui7Humidity           = (TstV100FloatToUI7(pValues_p->m_flHumidity) & 0x7F);
+    LoraDataRec.m_ui1MotionActive       = (pValues_p->m_fMotionActive ? 1 : 0);
+    LoraDataRec.m_ui8MotionActiveTime   = (((pValues_p->m_ui16MotionActiveTime + 5) / 10) & 0xFF);
+    LoraDataRec.m_ui10MotionActiveCount = (pValues_p->m_ui16MotionActiveCount & 0x03FF);
+    LoraDataRec.m_ui6LightLevel         = ((pValues_p->m_ui8LightLevel / 2) & 0x3F);
+    LoraDataRec.m_ui8CarBattLevel       = (TstV100FloatToUI8(pValues_p->m_flCarBattLevel * 10.0f) & 0xFF);
+    memcpy(pabRec_p, &LoraDataRec, sizeof(LoraDataRec));
+
+    return;
+
+}
+
+
+//  Conversions of LoraPayloadEncoder V1.00
+static  int8_t  TstV100FloatToI8 (float flDataValue_p)
+{
+
+    if (flDataValue_p > 127.0f)
+    {
+        flDataValue_p = 127.0f;
+    }
+    if (flDataValue_p < -127.0f)
+    {
+        flDataValue_p = -127.0f;
+    }
+
+    return ((int8_t)((int)round(flDataValue_p) & 0xFF));
+
+}
+
+
+static  uint8_t  TstV100FloatToUI7 (float flDataValue_p)
+{
+
+    if (flDataValue_p > 127.0f)
+    {
+        flDataValue_p = 127.0f;
+    }
+    if (flDataValue_p < 0.0f)
+    {
+        flDataValue_p = 0.0f;
+    }
+
+    return ((uint8_t)((unsigned int)round(flDataValue_p) & 0x7F));
+
+}
+
+
+static  uint8_t  TstV100FloatToUI8 (float flDataValue_p)
+{
+
+    if (flDataValue_p > 255.0f)
+    {
+        flDataValue_p = 255.0f;
+    }
+    if (flDataValue_p < 0.0f)
+    {
+        flDataValue_p = 0.0f;
+    }
+
+    return ((uint8_t)((unsigned int)round(flDataValue_p) & 0xFF));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Reference: Decoding of Data Record by V1.00 Gateway
+//---------------------------------------------------------------------------
+//  Expressions of LoraPayloadDecoder::DecodeRxPacket() V1.00
+
+static  inline  void  TstDecodeV100 (const tTstV100DataRec* pLoraDataRec_p, tTstSensorValues* pValues_p)
+{
+
+    pValues_p->m_ui32Uptime            = (pLoraDataRec_p->m_ui12UptimeSnippet & 0x0FFF) * 10;
+    pValues_p->m_flTemperature         = TstV100I8ToFloat(pLoraDataRec_p->m_i8Temperature & 0xFF) / 2;
+    pValues_p->m_flHumidity            = (float)(pLoraDataRec_p->m_ui7Humidity & 0x7F);
+    pValues_p->m_fMotionActive         = (pLoraDataRec_p->m_ui1MotionActive ? true : false);
+    pValues_p->m_ui16MotionActiveTime  = (pLoraDataRec_p->m_ui8MotionActiveTime & 0xFF) * 10;
+    pValues_p->m_ui16MotionActiveCount = (pLoraDataRec_p->m_ui10MotionActiveCount & 0x03FF);
+    pValues_p->m_ui8LightLevel         = (pLoraDataRec_p->m_ui6LightLevel & 0x3F) * 2;
+    pValues_p->m_flCarBattLevel        = (float)(pLoraDataRec_p->m_ui8CarBattLevel & 0xFF) / 10.0f;
+
+    return;
+
+}
+
+
+static  inline  float  TstV100I8ToFloat (int8_t i8DataValue_p)
+{
+
+int  iDataValue;
+
+
+    iDataValue = (int)(i8DataValue_p & 0xFF);
+    if ( (iDataValue & 0x80) )
+    {
+        iDataValue |= 0xFFFFFF00;
+    }
+
+    return ((float)iDataValue);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Decoding of Data Record by the Schema (as LoraPayloadDecoder)
+//---------------------------------------------------------------------------
+
+static  inline  void  TstDecodeSchema (const uint8_t* pabRec_p, tTstSensorValues* pValues_p)
+{
+
+    pValues_p->m_ui32Uptime            = (uint32_t)LoraDataRecField<kLoraDataRecUptimeSnippet    >::GetInt  (pabRec_p);
+    pValues_p->m_flTemperature         =           LoraDataRecField<kLoraDataRecTemperature      >::GetFloat(pabRec_p);
+    pValues_p->m_flHumidity            =           LoraDataRecField<kLoraDataRecHumidity         >::GetFloat(pabRec_p);
+    pValues_p->m_fMotionActive         = (bool)    LoraDataRecField<kLoraDataRecMotionActive     >::GetInt  (pabRec_p);
+    pValues_p->m_ui16MotionActiveTime  = (uint16_t)LoraDataRecField<kLoraDataRecMotionActiveTime >::GetInt  (pabRec_p);
+    pValues_p->m_ui16MotionActiveCount = (uint16_t)LoraDataRecField<kLoraDataRecMotionActiveCount>::GetInt  (pabRec_p);
+    pValues_p->m_ui8LightLevel         = (uint8_t) LoraDataRecField<kLoraDataRecLightLevel       >::GetInt  (pabRec_p);
+    pValues_p->m_flCarBattLevel        =           LoraDataRecField<kLoraDataRecCarBattLevel     >::GetFloat(pabRec_p);
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Encoding of Data Record by the Schema (as LoraPayloadEncoder)
+//---------------------------------------------------------------------------
+
+static  void  TstEncodeSchema (const tTstSensorValues* pValues_p, uint8_t* pabRec_p)
+{
+
+    memset(pabRec_p, 0x00, 8);
+    LoraDataRecField<kLoraDataRecPacketType       >::Put     (pabRec_p, kLoraPacketDataGen0);
+    LoraDataRecField<kLoraDataRecUptimeSnippet    >::SetInt  (pabRec_p, pValues_p->m_ui32Uptime);
+    LoraDataRecField<kLoraDataRecTemperature      >::SetFloat(pabRec_p, pValues_p->m_flTemperature);
+    LoraDataRecField<kLoraDataRecHumidity         >::SetFloat(pabRec_p, pValues_p->m_flHumidity);
+    LoraDataRecField<kLoraDataRecMotionActive     >::SetInt  (pabRec_p, pValues_p->m_fMotionActive);
+    LoraDataRecField<kLoraDataRecMotionActiveTime >::SetInt  (pabRec_p, pValues_p->m_ui16MotionActiveTime);
+    LoraDataRecField<kLoraDataRecMotionActiveCount>::SetInt  (pabRec_p, pValues_p->m_ui16MotionActiveCount);
+    LoraDataRecField<kLoraDataRecLightLevel       >::SetInt  (pabRec_p, pValues_p->m_ui8LightLevel);
+    LoraDataRecField<kLoraDataRecCarBattLevel     >::SetFloat(pabRec_p, pValues_p->m_flCarBattLevel);
+
+    return;
+
+}
+
+
+static  bool  TstCompareEncoding (const tTstSensorValues* pValues_p)
+{
+
+uint8_t  abRecV100[8];
+uint8_t  abRecSchema[8];
+bool     fEqual;
+
+
+    TstEncodeV100(pValues_p, abRecV100);
+    TstEncodeSchema(pValues_p, abRecSchema);
+
+    fEqual = (memcmp(abRecV100, abRecSchema, sizeof(abRecV100)) == 0);
+    if ( !fEqual && (uiV100Reports_l < TST_V100_MAX_REPORTS) )
+    {
+        uiV100Reports_l++;
+        printf("  Uptime %u, Temp %.3f, Hum %.3f, Motion %u/%u/%u, Light %u, Batt %.3f: "
+               "V1.00 %02X %02X %02X %02X %02X %02X %02X %02X, Schema %02X %02X %02X %02X %02X %02X %02X %02X\n",
+               (unsigned int)pValues_p->m_ui32Uptime, pValues_p->m_flTemperature, pValues_p->m_flHumidity,
+               (unsigned int)pValues_p->m_fMotionActive, (unsigned int)pValues_p->m_ui16MotionActiveTime,
+               (unsigned int)pValues_p->m_ui16MotionActiveCount, (unsigned int)pValues_p->m_ui8LightLevel, pValues_p->m_flCarBattLevel,
+               abRecV100[0], abRecV100[1], abRecV100[2], abRecV100[3], abRecV100[4], abRecV100[5], abRecV100[6], abRecV100[7],
+               abRecSchema[0], abRecSchema[1], abRecSchema[2], abRecSchema[3], abRecSchema[4], abRecSchema[5], abRecSchema[6], abRecSchema[7]);
+    }
+
+    return (fEqual);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Helpers
+//---------------------------------------------------------------------------
+
+static  uint32_t  TstRandom (void)
+{
+
+    // Xorshift32
+    ui32RandState_l ^= ui32RandState_l << 13;
+    ui32RandState_l ^= ui32RandState_l >> 17;
+    ui32RandState_l ^= ui32RandState_l << 5;
+
+    return (ui32RandState_l);
+
+}
+
+
+static  void  TstFillRandom (tTstRecBuff* pRecBuff_p)
+{
+
+uint8_t*      pabBuff;
+unsigned int  uiIdx;
+
+
+    pabBuff = (uint8_t*)pRecBuff_p;
+    for (uiIdx=0; uiIdx<sizeof(tTstRecBuff); uiIdx++)
+    {
+        pabBuff[uiIdx] = (uint8_t)TstRandom();
+    }
+
+    return;
+
+}
+
+
+static  double  TstGetTimeNs (void)
+{
+
+struct timespec  TimeSpec;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &TimeSpec);
+    return ((double)TimeSpec.tv_sec * 1e9 + (double)TimeSpec.tv_nsec);
+
+}
+
+
+
+// EOF
@@ -0,0 +1,307 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Host Test and Jitter Benchmark for Real-Time Receive Path
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+
+#include <RH_RF95.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <thread>
+#include "RealTime.h"
+#include "RxQueue.h"
+#include "TestCheck.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+const  unsigned int  TST_QUEUE_FRAMES       = 200000;   // frames passed between the threads
+const  unsigned int  TST_DEF_JITTER_TIME    = 5;        // duration of each jitter test phase [sec]
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+TST_DEFINE_COUNTERS()
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  void  TstLatencyStat (void);
+static  void  TstRxQueueBasic (void);
+static  void  TstRxQueueThreads (void);
+
+static  bool  TstIsEventSignaled (void);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Main function of this application
+//---------------------------------------------------------------------------
+//  Without arguments the functional checks are run ('make test'), option
+//  '-b[=<sec>]' runs the wakeup jitter measurement under synthetic CPU load
+//  ('make bench'). The real-time phase of the jitter measurement requires
+//  root privileges (SCHED_FIFO, mlockall).
+
+int  main (int iArgCnt_p, char* apszArg_p[])
+{
+
+unsigned int  uiDurationSec;
+
+
+    if ((iArgCnt_p > 1) && !strncmp(apszArg_p[1], "-b", 2))
+    {
+        uiDurationSec = TST_DEF_JITTER_TIME;
+        if (apszArg_p[1][2] == '=')
+        {
+            uiDurationSec = (unsigned int)strtoul(&apszArg_p[1][3], NULL, 10);
+        }
+        return (RtmRunJitterTest(uiDurationSec, (int)(sysconf(_SC_NPROCESSORS_ONLN) - 1), RTM_DEF_PRIORITY));
+    }
+
+    TstLatencyStat();
+    TstRxQueueBasic();
+    TstRxQueueThreads();
+
+    return (TST_RESULT("RealTimeTest"));
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Latency Statistics: Min/Max/Sum and Histogram Bucket Limits
+//---------------------------------------------------------------------------
+
+static  void  TstLatencyStat (void)
+{
+
+static const uint32_t  aui32Samples[] = { 0, 9, 10, 19, 50, 999, 4999, 5000, 100000 };
+
+tRtmLatencyStat  LatencyStat;
+unsigned int     uiIdx;
+
+
+    printf("Test: Latency Statistics\n");
+
+    RtmLatencyReset(&LatencyStat);
+    TST_CHECK_EQUAL(LatencyStat.m_ui32Count, 0);
+    TST_CHECK_EQUAL(LatencyStat.m_ui32MinUs, UINT32_MAX);
+
+    for (uiIdx=0; uiIdx<sizeof(aui32Samples)/sizeof(aui32Samples[0]); uiIdx++)
+    {
+        RtmLatencyAdd(&LatencyStat, aui32Samples[uiIdx]);
+    }
+
+    TST_CHECK_EQUAL(LatencyStat.m_ui32Count, 9);
+    TST_CHECK_EQUAL(LatencyStat.m_ui32MinUs, 0);
+    TST_CHECK_EQUAL(LatencyStat.m_ui32MaxUs, 100000);
+    TST_CHECK_EQUAL(LatencyStat.m_ui64SumUs, 111086);
+
+    // bucket limits are exclusive: 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, ...
+    TST_CHECK_EQUAL(LatencyStat.m_aui32Hist[0], 2);     //    0 ..    9
+    TST_CHECK_EQUAL(LatencyStat.m_aui32Hist[1], 2);     //   10 ..   19
+    TST_CHECK_EQUAL(LatencyStat.m_aui32Hist[2], 0);     //   20 ..   49
+    TST_CHECK_EQUAL(LatencyStat.m_aui32Hist[3], 1);     //   50 ..   99
+    TST_CHECK_EQUAL(LatencyStat.m_aui32Hist[6], 1);     //  500 ..  999
+    TST_CHECK_EQUAL(LatencyStat.m_aui32Hist[8], 1);     // 2000 .. 4999
+    TST_CHECK_EQUAL(LatencyStat.m_aui32Hist[9], 2);     // 5000 .. ...
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  RxQueue: Size Rounding, Overflow, FIFO Order and Event Signaling
+//---------------------------------------------------------------------------
+
+static  void  TstRxQueueBasic (void)
+{
+
+tRxqFrame     RxFrame;
+unsigned int  uiIdx;
+
+
+    printf("Test: RxQueue basic\n");
+
+    // 5 is rounded up to 8 frames
+    TST_CHECK_EQUAL(RxqInitialize(5), 0);
+    TST_CHECK( !RxqPop(&RxFrame) );
+    TST_CHECK( !TstIsEventSignaled() );
+
+    memset(&RxFrame, 0, sizeof(RxFrame));
+    for (uiIdx=0; uiIdx<8; uiIdx++)
+    {
+        RxFrame.m_uiRxPacketCntr = uiIdx;
+        RxFrame.m_uiDataLen      = uiIdx + 1;
+        RxFrame.m_abData[uiIdx]  = (uint8_t)(0xA0 + uiIdx);
+        TST_CHECK( RxqPush(&RxFrame) );
+    }
+    RxFrame.m_uiRxPacketCntr = 8;
+    TST_CHECK( !RxqPush(&RxFrame) );
+    TST_CHECK_EQUAL(RxqGetDropCount(), 1);
+
+    TST_CHECK( TstIsEventSignaled() );
+    TST_CHECK_EQUAL(RxqClearEvent(), 8);
+    TST_CHECK( !TstIsEventSignaled() );
+
+    for (uiIdx=0; uiIdx<8; uiIdx++)
+    {
+        TST_CHECK( RxqPop(&RxFrame) );
+        TST_CHECK_EQUAL(RxFrame.m_uiRxPacketCntr, uiIdx);
+        TST_CHECK_EQUAL(RxFrame.m_uiDataLen, uiIdx + 1);
+        TST_CHECK_EQUAL(RxFrame.m_abData[uiIdx], 0xA0 + uiIdx);
+    }
+    TST_CHECK( !RxqPop(&RxFrame) );
+
+    RxqClose();
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  RxQueue: Radio Thread and Main Loop running concurrently
+//---------------------------------------------------------------------------
+//  The producer retries on a full queue, so that every frame has to arrive
+//  exactly once and in order at the consumer.
+
+static  void  TstRxQueueThreads (void)
+{
+
+tRxqFrame     RxFrame;
+unsigned int  uiExpected;
+bool          fInOrder;
+uint64_t      ui64StartUs;
+
+
+    printf("Test: RxQueue concurrent\n");
+
+    TST_CHECK_EQUAL(RxqInitialize(0), 0);
+    ui64StartUs = RtmGetTimeUs();
+
+    std::thread ProducerThread([]()
+    {
+        tRxqFrame     TxFrame;
+        unsigned int  uiIdx;
+
+        memset(&TxFrame, 0, sizeof(TxFrame));
+        for (uiIdx=0; uiIdx<TST_QUEUE_FRAMES; uiIdx++)
+        {
+            TxFrame.m_uiRxPacketCntr = uiIdx;
+            TxFrame.m_uiDataLen      = uiIdx % (RH_RF95_MAX_PAYLOAD_LEN + 1);
+            TxFrame.m_abData[0]      = (uint8_t)uiIdx;
+            while ( !RxqPush(&TxFrame) )
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uiExpected = 0;
+    fInOrder   = true;
+    while (uiExpected < TST_QUEUE_FRAMES)
+    {
+        if ( !RxqPop(&RxFrame) )
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        if ((RxFrame.m_uiRxPacketCntr != uiExpected) ||
+            (RxFrame.m_uiDataLen != uiExpected % (RH_RF95_MAX_PAYLOAD_LEN + 1)) ||
+            (RxFrame.m_abData[0] != (uint8_t)uiExpected))
+        {
+            fInOrder = false;
+            break;
+        }
+        uiExpected++;
+    }
+
+    ProducerThread.join();
+    printf("  %u frames in %.1f [ms]\n", uiExpected, (double)(RtmGetTimeUs() - ui64StartUs) / 1000.0);
+
+    TST_CHECK(fInOrder);
+    TST_CHECK_EQUAL(uiExpected, TST_QUEUE_FRAMES);
+    TST_CHECK( !RxqPop(&RxFrame) );
+
+    RxqClose();
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Check if the Event FD of the Queue is readable (without blocking)
+//---------------------------------------------------------------------------
+
+static  bool  TstIsEventSignaled (void)
+{
+
+struct pollfd  FdSet[1];
+
+
+    FdSet[0].fd      = RxqGetEventFD();
+    FdSet[0].events  = POLLIN;
+    FdSet[0].revents = 0;
+
+    return ((poll(FdSet, 1, 0) == 1) && ((FdSet[0].revents & POLLIN) != 0));
+
+}
+
+
+
+// EOF
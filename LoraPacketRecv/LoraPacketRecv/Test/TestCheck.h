@@ -0,0 +1,79 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Minimal Check Macros for Host Tests
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _TESTCHECK_H_
+#define _TESTCHECK_H_
+
+#include <stdio.h>
+
+
+
+//---------------------------------------------------------------------------
+//  Global variables
+//---------------------------------------------------------------------------
+
+extern  unsigned int  uiTstChecks_g;                    // number of evaluated checks
+extern  unsigned int  uiTstFailures_g;                  // number of failed checks
+
+
+
+//---------------------------------------------------------------------------
+//  Macro definitions
+//---------------------------------------------------------------------------
+
+//  Each test program defines the two counters once with TST_DEFINE_COUNTERS
+//  and returns TST_RESULT() from main(), so that 'make test' stops on the
+//  first failing program.
+
+#define TST_DEFINE_COUNTERS()                                                               \
+    unsigned int  uiTstChecks_g   = 0;                                                      \
+    unsigned int  uiTstFailures_g = 0;
+
+#define TST_CHECK(fCond_p)                                                                  \
+    do                                                                                      \
+    {                                                                                       \
+        uiTstChecks_g++;                                                                    \
+        if ( !(fCond_p) )                                                                   \
+        {                                                                                   \
+            uiTstFailures_g++;                                                              \
+            printf("  FAILED: %s (%s:%d)\n", #fCond_p, __FILE__, __LINE__);                 \
+        }                                                                                   \
+    } while (0)
+
+#define TST_CHECK_EQUAL(Actual_p, Expected_p)                                               \
+    do                                                                                      \
+    {                                                                                       \
+        long long  llTstActual   = (long long)(Actual_p);                                   \
+        long long  llTstExpected = (long long)(Expected_p);                                 \
+        uiTstChecks_g++;                                                                    \
+        if (llTstActual != llTstExpected)                                                   \
+        {                                                                                   \
+            uiTstFailures_g++;                                                              \
+            printf("  FAILED: %s == %lld, expected %lld (%s:%d)\n",                         \
+                   #Actual_p, llTstActual, llTstExpected, __FILE__, __LINE__);              \
+        }                                                                                   \
+    } while (0)
+
+#define TST_RESULT(pszName_p)                                                               \
+    (printf("%s: %u checks, %u failed -> %s\n", (pszName_p), uiTstChecks_g,                 \
+            uiTstFailures_g, ((uiTstFailures_g == 0) ? "PASSED" : "FAILED")),               \
+     ((uiTstFailures_g == 0) ? 0 : 1))
+
+
+
+#endif  // #ifndef _TESTCHECK_H_
+
+
+// EOF
@@ -0,0 +1,1645 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Implementation of embedded Time Series Store
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+
+#ifndef _WIN64
+    #include <RH_RF95.h>
+#else
+    #define _CRT_SECURE_NO_WARNINGS
+    typedef  unsigned int  uint;
+    #define RH_RF95_MAX_PAYLOAD_LEN 255
+#endif
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "LoraPacket.h"
+#include "LoraPacketSchema.h"
+#include "LoraPayloadDecoder.h"
+#include "PacketProcessing.h"
+#include "MessageLogFormat.h"
+#include "TimeSeriesStore.h"
+#include "Trace.h"
+
+
+
+
+
+/***************************************************************************/
+/*                                                                         */
+/*                                                                         */
+/*          G L O B A L   D E F I N I T I O N S                            */
+/*                                                                         */
+/*                                                                         */
+/***************************************************************************/
+
+//---------------------------------------------------------------------------
+//  Configuration
+//---------------------------------------------------------------------------
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+
+//  Field of <tLoraDataRec> stored for each <tTssField>
+static  const  tLoraDataRecField  TSS_FIELD_SCHEMA[] =
+{
+    kLoraDataRecTemperature,                            // kTssFieldTemperature
+    kLoraDataRecHumidity,                               // kTssFieldHumidity
+    kLoraDataRecLightLevel,                             // kTssFieldLightLevel
+    kLoraDataRecCarBattLevel,                           // kTssFieldCarBattLevel
+    kLoraDataRecMotionActiveTime                        // kTssFieldMotionActiveTime
+};
+
+static_assert(sizeof(TSS_FIELD_SCHEMA) / sizeof(tLoraDataRecField) == kTssNumFields, "TSS_FIELD_SCHEMA incomplete");
+
+
+//  Longest bucket (day with DST change), used to widen the range of points
+//  read for buckets aggregated from the blocks
+static  const  int64_t  TSS_MAX_BUCKET_TIME = 25 * 3600;
+
+static  const  uint8_t  TSS_NO_WINDOW       = 0xFF;     // no XOR window of previous value
+
+
+
+//---------------------------------------------------------------------------
+//  Local types
+//---------------------------------------------------------------------------
+
+//  MSB-first Bit Stream, the last (incomplete) byte is kept in the accumulator
+typedef struct
+{
+    std::vector<uint8_t>    m_vecData;
+    uint64_t                m_ui64Acc;
+    uint                    m_uiAccBits;            // 0..7
+
+} tTssBitWriter;
+
+
+typedef struct
+{
+    const uint8_t*          m_pabData;
+    size_t                  m_nDataLen;
+    size_t                  m_nPos;
+    uint64_t                m_ui64Acc;
+    uint                    m_uiAccBits;
+    bool                    m_fOverrun;
+
+} tTssBitReader;
+
+
+//  Encoder State of one Column pair (shared by encoder and decoder)
+typedef struct
+{
+    uint                    m_uiPoints;
+    int64_t                 m_i64PrevTime;
+    int64_t                 m_i64PrevDelta;
+    uint64_t                m_ui64PrevValue;
+    uint8_t                 m_ui8PrevLeading;
+    uint8_t                 m_ui8PrevTrailing;
+
+} tTssCodecState;
+
+
+typedef struct
+{
+    tTssBitWriter           m_TimeColumn;
+    tTssBitWriter           m_ValueColumn;
+    tTssCodecState          m_CodecState;
+    int64_t                 m_i64MinTime;
+    int64_t                 m_i64MaxTime;
+
+} tTssOpenBlock;
+
+
+//  Sealed Block in StoreFile
+typedef struct
+{
+    uint64_t                m_ui64Offset;
+    uint32_t                m_ui32BlockLen;
+    uint32_t                m_ui32TimeBytes;
+    uint32_t                m_ui32ValueBytes;
+    uint16_t                m_ui16NumPoints;
+    int64_t                 m_i64MinTime;
+    int64_t                 m_i64MaxTime;
+
+} tTssBlockRef;
+
+
+typedef struct
+{
+    int64_t                 m_i64Time;              // start of bucket
+    double                  m_dMin;
+    double                  m_dMax;
+    double                  m_dSum;
+    uint32_t                m_ui32Count;
+
+} tTssRollup;
+
+
+typedef struct
+{
+    tTssOpenBlock           m_OpenBlock;
+    std::vector<tTssBlockRef>  m_vecBlocks;
+    std::deque<tTssRollup>  m_adeqRollups[kTssNumLevels];   // [kTssLevelRaw] unused
+    int64_t                 m_ai64RetainFrom[kTssNumLevels];  // buckets starting before are not kept in memory
+    int64_t                 m_i64NewestTime;
+
+} tTssSeries;
+
+
+//  Local day (range of hour/day buckets)
+typedef struct
+{
+    int64_t                 m_i64Start;
+    int64_t                 m_i64End;
+
+} tTssDayRange;
+
+
+
+//---------------------------------------------------------------------------
+//  Local variables
+//---------------------------------------------------------------------------
+
+static  int             iFdStoreFile_l          = -1;
+static  bool            fReadOnly_l             = false;
+static  uint64_t        ui64FileSize_l          = 0;
+static  tTssSeries*     apSeries_l[TSS_MAX_DEVICES][kTssNumFields];
+static  tTssStatistics  Statistics_l;
+
+//  Local days of last bucket calculations (the retention time is calculated
+//  together with each point, so more than one day must be cached)
+static  tTssDayRange    aDayCache_l[4];
+static  uint            uiDayCacheNext_l        = 0;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of internal functions
+//---------------------------------------------------------------------------
+
+static  int  TssLoadBlocks (void);
+
+static  int  TssSealBlock (
+    uint8_t ui8DevID_p,
+    tTssField Field_p,
+    tTssSeries* pSeries_p);
+
+static  tTssSeries*  TssGetSeries (
+    uint8_t ui8DevID_p,
+    tTssField Field_p,
+    bool fCreate_p);
+
+static  void  TssUpdateRollups (
+    tTssSeries* pSeries_p,
+    int64_t i64Time_p,
+    double dValue_p);
+
+static  int64_t  TssGetBucketStart (
+    tTssLevel Level_p,
+    int64_t i64Time_p);
+
+static  int  TssReadBlock (
+    const tTssBlockRef* pBlockRef_p,
+    std::vector<uint8_t>* pvecData_p);
+
+static  void  TssDecodeBlock (
+    const uint8_t* pabTimeColumn_p,
+    size_t nTimeBytes_p,
+    const uint8_t* pabValueColumn_p,
+    size_t nValueBytes_p,
+    uint uiNumPoints_p,
+    int64_t i64FromTime_p,
+    int64_t i64ToTime_p,
+    std::vector<tTssPoint>* pvecPoints_p);
+
+static  void  TssEncodePoint (
+    tTssCodecState* pState_p,
+    tTssBitWriter* pTimeColumn_p,
+    tTssBitWriter* pValueColumn_p,
+    int64_t i64Time_p,
+    double dValue_p);
+
+static  bool  TssDecodePoint (
+    tTssCodecState* pState_p,
+    tTssBitReader* pTimeColumn_p,
+    tTssBitReader* pValueColumn_p,
+    int64_t* pi64Time_p,
+    double* pdValue_p);
+
+static  void  TssGetColumnData (
+    const tTssBitWriter* pColumn_p,
+    std::vector<uint8_t>* pvecData_p);
+
+static  inline  void  TssPutBits (
+    tTssBitWriter* pWriter_p,
+    uint64_t ui64Value_p,
+    uint uiBits_p);
+
+static  inline  uint64_t  TssGetBits (
+    tTssBitReader* pReader_p,
+    uint uiBits_p);
+
+static  inline  int64_t  TssAddSaturated (
+    int64_t i64Time_p,
+    int64_t i64Diff_p);
+
+static  inline  uint32_t  TssFileHeaderCrc (
+    const tTssFileHeader* pFileHeader_p);
+
+static  inline  uint32_t  TssBlockHeaderCrc (
+    const tTssBlockHeader* pBlockHeader_p);
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P U B L I C   F U N C T I O N S                                //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Open StoreFile
+//---------------------------------------------------------------------------
+//  An existing StoreFile is continued, the blocks are replayed to build the
+//  block list and the rollups of each series. A torn last block (e.g. power
+//  failure) is cut off, blocks with wrong CRC are skipped. A file that is no
+//  StoreFile is never overwritten.
+
+int  TssOpen (
+    const char* pszStoreFileName_p,                     // [IN]     Path/Name of StoreFile
+    bool fReadOnly_p)                                   // [IN]     only query (e.g. StoreFile of running Gateway)
+{
+
+tTssFileHeader  TssFileHeader;
+struct stat     FileStat;
+mode_t          OpenMode;
+ssize_t         iRes;
+
+
+    if ((pszStoreFileName_p == NULL) || (iFdStoreFile_l >= 0))
+    {
+        return (-1);
+    }
+
+    memset(apSeries_l, 0, sizeof(apSeries_l));
+    memset(&Statistics_l, 0, sizeof(Statistics_l));
+    fReadOnly_l = fReadOnly_p;
+    ui64FileSize_l = 0;
+
+    if ( fReadOnly_p )
+    {
+        iFdStoreFile_l = open(pszStoreFileName_p, O_RDONLY);
+    }
+    else
+    {
+        OpenMode = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
+        iFdStoreFile_l = open(pszStoreFileName_p, (O_CREAT | O_RDWR | O_APPEND), OpenMode);
+    }
+    TRACE2("\nOpen StoreFile: pszStoreFileName_p='%s' -> iFdStoreFile_l=%d\n", pszStoreFileName_p, iFdStoreFile_l);
+    if (iFdStoreFile_l < 0)
+    {
+        return (-2);
+    }
+
+    if (fstat(iFdStoreFile_l, &FileStat) != 0)
+    {
+        TssClose();
+        return (-3);
+    }
+
+    if (FileStat.st_size > 0)
+    {
+        iRes = pread(iFdStoreFile_l, &TssFileHeader, sizeof(TssFileHeader), 0);
+        if ( (iRes != (ssize_t)sizeof(TssFileHeader)) ||
+             (memcmp(TssFileHeader.m_achMagic, TSS_FILE_MAGIC, sizeof(TssFileHeader.m_achMagic)) != 0) ||
+             (TssFileHeader.m_ui32CRC32 != TssFileHeaderCrc(&TssFileHeader)) ||
+             (TssFileHeader.m_ui16FormatVersion != TSS_FORMAT_VERSION) ||
+             (TssFileHeader.m_ui16HeaderSize != TSS_HEADER_SIZE) ||
+             (TssFileHeader.m_ui16BlockHeaderSize != TSS_BLOCK_HEADER_SIZE) )
+        {
+            TRACE0("\nOpen StoreFile: no compatible StoreFile\n");
+            close(iFdStoreFile_l);
+            iFdStoreFile_l = -1;
+            return (-4);
+        }
+
+        ui64FileSize_l = (uint64_t)FileStat.st_size;
+        iRes = TssLoadBlocks();
+        if (iRes < 0)
+        {
+            TssClose();
+            return (-5);
+        }
+        return (0);
+    }
+
+    if ( fReadOnly_p )
+    {
+        TssClose();
+        return (-4);
+    }
+
+    memset(&TssFileHeader, 0, sizeof(TssFileHeader));
+    memcpy(TssFileHeader.m_achMagic, TSS_FILE_MAGIC, sizeof(TssFileHeader.m_achMagic));
+    TssFileHeader.m_ui16FormatVersion   = TSS_FORMAT_VERSION;
+    TssFileHeader.m_ui16SchemaVersion   = LORA_SCHEMA_VERSION;
+    TssFileHeader.m_ui16HeaderSize      = TSS_HEADER_SIZE;
+    TssFileHeader.m_ui16BlockHeaderSize = TSS_BLOCK_HEADER_SIZE;
+    TssFileHeader.m_i64CreateTime       = (int64_t)time(NULL);
+    TssFileHeader.m_ui32CRC32           = TssFileHeaderCrc(&TssFileHeader);
+
+    iRes = write(iFdStoreFile_l, &TssFileHeader, sizeof(TssFileHeader));
+    if (iRes != (ssize_t)sizeof(TssFileHeader))
+    {
+        TssClose();
+        return (-6);
+    }
+    ui64FileSize_l = sizeof(TssFileHeader);
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Close StoreFile
+//---------------------------------------------------------------------------
+//  The open blocks of all series are sealed and written now, so a later run
+//  continues with new blocks.
+
+int  TssClose (void)
+{
+
+uint  uiDevID;
+uint  uiField;
+
+
+    if (iFdStoreFile_l < 0)
+    {
+        return (-1);
+    }
+
+    for (uiDevID=0; uiDevID<TSS_MAX_DEVICES; uiDevID++)
+    {
+        for (uiField=0; uiField<kTssNumFields; uiField++)
+        {
+            if (apSeries_l[uiDevID][uiField] == NULL)
+            {
+                continue;
+            }
+            if ( !fReadOnly_l && (apSeries_l[uiDevID][uiField]->m_OpenBlock.m_CodecState.m_uiPoints > 0) )
+            {
+                TssSealBlock((uint8_t)uiDevID, (tTssField)uiField, apSeries_l[uiDevID][uiField]);
+            }
+            delete apSeries_l[uiDevID][uiField];
+            apSeries_l[uiDevID][uiField] = NULL;
+        }
+    }
+
+    close(iFdStoreFile_l);
+    iFdStoreFile_l = -1;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Add Json Message
+//---------------------------------------------------------------------------
+//  Only Data Records are stored, one point per field of TSS_FIELD_SCHEMA
+//  with the (reconstructed) TimeStamp of the record.
+
+int  TssAddMessage (
+    const tJsonMessage* pJsonMessage_p)                 // [IN]     Json Message (only Data Records are stored)
+{
+
+const tPprRecordFields*  pRecordFields;
+double                   dValue;
+uint                     uiField;
+int                      iRes;
+
+
+    if (pJsonMessage_p == NULL)
+    {
+        return (-1);
+    }
+
+    pRecordFields = &pJsonMessage_p->m_RecordFields;
+    if ( (pRecordFields->m_PacketType != kLoraPacketDataGen0) &&
+         (pRecordFields->m_PacketType != kLoraPacketDataGen1) &&
+         (pRecordFields->m_PacketType != kLoraPacketDataGen2) &&
+         (pRecordFields->m_PacketType != kLoraPacketDataGenN) )
+    {
+        return (0);
+    }
+
+    for (uiField=0; uiField<kTssNumFields; uiField++)
+    {
+        dValue = LoraSchemaGetValue(&LORA_SCHEMA_DATA_REC[TSS_FIELD_SCHEMA[uiField]], &pRecordFields->m_SchemaRec.m_LoraDataRec);
+        iRes = TssAddPoint(pRecordFields->m_ui8DevID, (tTssField)uiField, (int64_t)pRecordFields->m_tmTimeStamp, dValue);
+        if (iRes < 0)
+        {
+            return (iRes);
+        }
+    }
+
+    return (1);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Add Point to Series
+//---------------------------------------------------------------------------
+//  Points may arrive out of order (e.g. older generations of a Data Packet),
+//  the encoding only becomes less compact then. The open block is sealed
+//  before it would exceed TSS_BLOCK_MAX_POINTS or TSS_BLOCK_MAX_SPAN.
+
+int  TssAddPoint (
+    uint8_t ui8DevID_p,                                 // [IN]     DevID of Series
+    tTssField Field_p,                                  // [IN]     Field of Series
+    int64_t i64Time_p,                                  // [IN]     TimeStamp of Point
+    double dValue_p)                                    // [IN]     Value of Point
+{
+
+tTssSeries*     pSeries;
+tTssOpenBlock*  pOpenBlock;
+int64_t         i64MinTime;
+int64_t         i64MaxTime;
+
+
+    if (iFdStoreFile_l < 0)
+    {
+        return (-1);
+    }
+    if ( fReadOnly_l )
+    {
+        return (-2);
+    }
+    if (((uint)Field_p >= kTssNumFields) || isnan(dValue_p))
+    {
+        return (-3);
+    }
+
+    pSeries = TssGetSeries(ui8DevID_p, Field_p, true);
+    pOpenBlock = &pSeries->m_OpenBlock;
+
+    if (pOpenBlock->m_CodecState.m_uiPoints > 0)
+    {
+        i64MinTime = std::min(pOpenBlock->m_i64MinTime, i64Time_p);
+        i64MaxTime = std::max(pOpenBlock->m_i64MaxTime, i64Time_p);
+        if ( (pOpenBlock->m_CodecState.m_uiPoints >= TSS_BLOCK_MAX_POINTS) ||
+             ((uint64_t)(i64MaxTime - i64MinTime) >= TSS_BLOCK_MAX_SPAN) )
+        {
+            TssSealBlock(ui8DevID_p, Field_p, pSeries);
+        }
+    }
+
+    if (pOpenBlock->m_CodecState.m_uiPoints == 0)
+    {
+        pOpenBlock->m_i64MinTime = i64Time_p;
+        pOpenBlock->m_i64MaxTime = i64Time_p;
+    }
+    pOpenBlock->m_i64MinTime = std::min(pOpenBlock->m_i64MinTime, i64Time_p);
+    pOpenBlock->m_i64MaxTime = std::max(pOpenBlock->m_i64MaxTime, i64Time_p);
+    TssEncodePoint(&pOpenBlock->m_CodecState, &pOpenBlock->m_TimeColumn, &pOpenBlock->m_ValueColumn, i64Time_p, dValue_p);
+
+    TssUpdateRollups(pSeries, i64Time_p, dValue_p);
+    Statistics_l.m_ui64PointsAdded++;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Query raw Points of a Series
+//---------------------------------------------------------------------------
+//  Only the blocks overlapping the time range are read and decoded, the
+//  open block is decoded from memory.
+
+int  TssQueryRaw (
+    uint8_t ui8DevID_p,                                 // [IN]     DevID of Series
+    tTssField Field_p,                                  // [IN]     Field of Series
+    int64_t i64FromTime_p,                              // [IN]     Time Range (both inclusive)
+    int64_t i64ToTime_p,
+    std::vector<tTssPoint>* pvecPoints_p)               // [OUT]    Ptr to Vector with Points sorted by time
+{
+
+const tTssSeries*     pSeries;
+const tTssOpenBlock*  pOpenBlock;
+std::vector<uint8_t>  vecData;
+std::vector<uint8_t>  vecValueColumn;
+int                   iRes;
+
+
+    if ((iFdStoreFile_l < 0) || ((uint)Field_p >= kTssNumFields) || (pvecPoints_p == NULL))
+    {
+        return (-1);
+    }
+
+    pvecPoints_p->clear();
+    pSeries = TssGetSeries(ui8DevID_p, Field_p, false);
+    if (pSeries == NULL)
+    {
+        return (0);
+    }
+
+    for (const tTssBlockRef& BlockRef : pSeries->m_vecBlocks)
+    {
+        if ((BlockRef.m_i64MaxTime < i64FromTime_p) || (BlockRef.m_i64MinTime > i64ToTime_p))
+        {
+            continue;
+        }
+        iRes = TssReadBlock(&BlockRef, &vecData);
+        if (iRes < 0)
+        {
+            return (-2);
+        }
+        TssDecodeBlock(vecData.data(), BlockRef.m_ui32TimeBytes,
+                       vecData.data() + BlockRef.m_ui32TimeBytes, BlockRef.m_ui32ValueBytes,
+                       BlockRef.m_ui16NumPoints, i64FromTime_p, i64ToTime_p, pvecPoints_p);
+    }
+
+    pOpenBlock = &pSeries->m_OpenBlock;
+    if ( (pOpenBlock->m_CodecState.m_uiPoints > 0) &&
+         (pOpenBlock->m_i64MaxTime >= i64FromTime_p) && (pOpenBlock->m_i64MinTime <= i64ToTime_p) )
+    {
+        TssGetColumnData(&pOpenBlock->m_TimeColumn, &vecData);
+        TssGetColumnData(&pOpenBlock->m_ValueColumn, &vecValueColumn);
+        TssDecodeBlock(vecData.data(), vecData.size(), vecValueColumn.data(), vecValueColumn.size(),
+                       pOpenBlock->m_CodecState.m_uiPoints, i64FromTime_p, i64ToTime_p, pvecPoints_p);
+    }
+
+    if ( !std::is_sorted(pvecPoints_p->begin(), pvecPoints_p->end(),
+                         [](const tTssPoint& P1, const tTssPoint& P2) { return (P1.m_i64Time < P2.m_i64Time); }) )
+    {
+        std::stable_sort(pvecPoints_p->begin(), pvecPoints_p->end(),
+                         [](const tTssPoint& P1, const tTssPoint& P2) { return (P1.m_i64Time < P2.m_i64Time); });
+    }
+
+    return ((int)pvecPoints_p->size());
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Query Aggregates of a Series
+//---------------------------------------------------------------------------
+//  Buckets kept in memory are taken from the rollups, older buckets (beyond
+//  TSS_RETAIN_MINUTE/TSS_RETAIN_HOUR) are aggregated from the raw points.
+//  Only buckets containing points are returned.
+
+int  TssQueryAggregate (
+    uint8_t ui8DevID_p,                                 // [IN]     DevID of Series
+    tTssField Field_p,                                  // [IN]     Field of Series
+    tTssLevel Level_p,                                  // [IN]     Minute, Hour or Day
+    int64_t i64FromTime_p,                              // [IN]     Range of bucket start times (both inclusive)
+    int64_t i64ToTime_p,
+    std::vector<tTssAggregate>* pvecAggregates_p)       // [OUT]    Ptr to Vector with Buckets sorted by time
+{
+
+const tTssSeries*                       pSeries;
+const std::deque<tTssRollup>*           pdeqRollups;
+std::deque<tTssRollup>::const_iterator  itRollup;
+std::vector<tTssPoint>                  vecPoints;
+tTssAggregate                           Aggregate;
+int64_t                                 i64RetainFrom;
+int64_t                                 i64RawToTime;
+int64_t                                 i64Bucket;
+int                                     iRes;
+
+
+    if ( (iFdStoreFile_l < 0) || ((uint)Field_p >= kTssNumFields) ||
+         (Level_p == kTssLevelRaw) || ((uint)Level_p >= kTssNumLevels) || (pvecAggregates_p == NULL) )
+    {
+        return (-1);
+    }
+
+    pvecAggregates_p->clear();
+    pSeries = TssGetSeries(ui8DevID_p, Field_p, false);
+    if ((pSeries == NULL) || (i64FromTime_p > i64ToTime_p))
+    {
+        return (0);
+    }
+
+    // buckets no longer kept in memory -> aggregate raw points
+    i64RetainFrom = pSeries->m_ai64RetainFrom[Level_p];
+    if (i64FromTime_p < i64RetainFrom)
+    {
+        i64RawToTime = std::min(i64ToTime_p, i64RetainFrom - 1);
+        iRes = TssQueryRaw(ui8DevID_p, Field_p, i64FromTime_p, TssAddSaturated(i64RawToTime, TSS_MAX_BUCKET_TIME), &vecPoints);
+        if (iRes < 0)
+        {
+            return (-2);
+        }
+        memset(&Aggregate, 0, sizeof(Aggregate));
+        for (const tTssPoint& Point : vecPoints)
+        {
+            i64Bucket = TssGetBucketStart(Level_p, Point.m_i64Time);
+            if ((i64Bucket < i64FromTime_p) || (i64Bucket > i64RawToTime))
+            {
+                continue;
+            }
+            if ((Aggregate.m_ui32Count > 0) && (Aggregate.m_i64Time != i64Bucket))
+            {
+                Aggregate.m_dMean /= Aggregate.m_ui32Count;
+                pvecAggregates_p->push_back(Aggregate);
+                Aggregate.m_ui32Count = 0;
+            }
+            if (Aggregate.m_ui32Count == 0)
+            {
+                Aggregate.m_i64Time = i64Bucket;
+                Aggregate.m_dMin    = Point.m_dValue;
+                Aggregate.m_dMax    = Point.m_dValue;
+                Aggregate.m_dMean   = 0;
+            }
+            Aggregate.m_dMin   = std::min(Aggregate.m_dMin, Point.m_dValue);
+            Aggregate.m_dMax   = std::max(Aggregate.m_dMax, Point.m_dValue);
+            Aggregate.m_dMean += Point.m_dValue;
+            Aggregate.m_ui32Count++;
+        }
+        if (Aggregate.m_ui32Count > 0)
+        {
+            Aggregate.m_dMean /= Aggregate.m_ui32Count;
+            pvecAggregates_p->push_back(Aggregate);
+        }
+    }
+
+    // buckets kept in memory
+    pdeqRollups = &pSeries->m_adeqRollups[Level_p];
+    itRollup = std::lower_bound(pdeqRollups->begin(), pdeqRollups->end(), std::max(i64FromTime_p, i64RetainFrom),
+                                [](const tTssRollup& Rollup, int64_t i64Time) { return (Rollup.m_i64Time < i64Time); });
+    for (; (itRollup != pdeqRollups->end()) && (itRollup->m_i64Time <= i64ToTime_p); ++itRollup)
+    {
+        Aggregate.m_i64Time   = itRollup->m_i64Time;
+        Aggregate.m_dMin      = itRollup->m_dMin;
+        Aggregate.m_dMax      = itRollup->m_dMax;
+        Aggregate.m_dMean     = itRollup->m_dSum / itRollup->m_ui32Count;
+        Aggregate.m_ui32Count = itRollup->m_ui32Count;
+        pvecAggregates_p->push_back(Aggregate);
+    }
+
+    return ((int)pvecAggregates_p->size());
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Check if Series exists
+//---------------------------------------------------------------------------
+
+bool  TssHasSeries (
+    uint8_t ui8DevID_p,                                 // [IN]     DevID of Series
+    tTssField Field_p)                                  // [IN]     Field of Series
+{
+
+    if ((iFdStoreFile_l < 0) || ((uint)Field_p >= kTssNumFields))
+    {
+        return (false);
+    }
+
+    return (TssGetSeries(ui8DevID_p, Field_p, false) != NULL);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Name and Decimals of Field (as in Json Record)
+//---------------------------------------------------------------------------
+
+const char*  TssGetFieldName (
+    tTssField Field_p)                                  // [IN]     Field
+{
+
+    if ((uint)Field_p >= kTssNumFields)
+    {
+        return ("");
+    }
+
+    return (LORA_SCHEMA_DATA_REC[TSS_FIELD_SCHEMA[Field_p]].m_pszName);
+
+}
+
+
+uint  TssGetFieldDecimals (
+    tTssField Field_p)                                  // [IN]     Field
+{
+
+    if ((uint)Field_p >= kTssNumFields)
+    {
+        return (0);
+    }
+
+    return (LORA_SCHEMA_DATA_REC[TSS_FIELD_SCHEMA[Field_p]].m_ui8Decimals);
+
+}
+
+
+bool  TssGetFieldByName (
+    const char* pszFieldName_p,                         // [IN]     Name as in Json Record (case insensitive)
+    tTssField* pField_p)                                // [OUT]    Field
+{
+
+uint  uiField;
+
+
+    for (uiField=0; uiField<kTssNumFields; uiField++)
+    {
+        if ( !strcasecmp(pszFieldName_p, LORA_SCHEMA_DATA_REC[TSS_FIELD_SCHEMA[uiField]].m_pszName) )
+        {
+            *pField_p = (tTssField)uiField;
+            return (true);
+        }
+    }
+
+    return (false);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get/Print Statistics
+//---------------------------------------------------------------------------
+
+void  TssGetStatistics (
+    tTssStatistics* pStatistics_p)                      // [OUT]    Ptr to Statistics
+{
+
+uint  uiDevID;
+uint  uiField;
+uint  uiLevel;
+
+
+    *pStatistics_p = Statistics_l;
+    for (uiDevID=0; uiDevID<TSS_MAX_DEVICES; uiDevID++)
+    {
+        for (uiField=0; uiField<kTssNumFields; uiField++)
+        {
+            if (apSeries_l[uiDevID][uiField] == NULL)
+            {
+                continue;
+            }
+            pStatistics_p->m_uiSeries++;
+            for (uiLevel=kTssLevelMinute; uiLevel<kTssNumLevels; uiLevel++)
+            {
+                pStatistics_p->m_uiRollups[uiLevel] += (uint)apSeries_l[uiDevID][uiField]->m_adeqRollups[uiLevel].size();
+            }
+        }
+    }
+
+    return;
+
+}
+
+
+void  TssPrintStatistics (void)
+{
+
+tTssStatistics  Statistics;
+
+
+    TssGetStatistics(&Statistics);
+
+    printf("Time Series Store:\n");
+    printf("  Series            = %u\n", Statistics.m_uiSeries);
+    printf("  Points added      = %llu (loaded at open: %llu)\n",
+           (unsigned long long)Statistics.m_ui64PointsAdded, (unsigned long long)Statistics.m_ui64PointsLoaded);
+    printf("  Blocks            = %u (damaged: %u, write errors: %u)\n",
+           Statistics.m_uiBlocks, Statistics.m_uiBlocksDamaged, Statistics.m_uiWriteErrors);
+    printf("  Bytes per Point   = %.2f\n",
+           (Statistics.m_ui64PointsStored > 0) ? ((double)Statistics.m_ui64BytesStored / (double)Statistics.m_ui64PointsStored) : 0.0);
+    printf("  Rollups in memory = %u min, %u hour, %u day\n",
+           Statistics.m_uiRollups[kTssLevelMinute], Statistics.m_uiRollups[kTssLevelHour], Statistics.m_uiRollups[kTssLevelDay]);
+
+    return;
+
+}
+
+
+
+
+
+//=========================================================================//
+//                                                                         //
+//          P R I V A T E   F U N C T I O N S                              //
+//                                                                         //
+//=========================================================================//
+
+//---------------------------------------------------------------------------
+//  Load Blocks of StoreFile
+//---------------------------------------------------------------------------
+//  The blocks are read in file order and their points are replayed into
+//  the rollups. The walk stops at the first invalid block header, in write
+//  mode the file is cut off there, so that new blocks follow a valid one.
+
+static  int  TssLoadBlocks (void)
+{
+
+tTssBlockHeader         BlockHeader;
+tTssBlockRef            BlockRef;
+tTssSeries*             pSeries;
+std::vector<uint8_t>    vecData;
+std::vector<tTssPoint>  vecPoints;
+uint64_t                ui64Offset;
+ssize_t                 iRes;
+
+
+    ui64Offset = TSS_HEADER_SIZE;
+    while ((ui64Offset + TSS_BLOCK_HEADER_SIZE) <= ui64FileSize_l)
+    {
+        iRes = pread(iFdStoreFile_l, &BlockHeader, sizeof(BlockHeader), (off_t)ui64Offset);
+        if ( (iRes != (ssize_t)sizeof(BlockHeader)) ||
+             (BlockHeader.m_ui32CRC32 != TssBlockHeaderCrc(&BlockHeader)) ||
+             (BlockHeader.m_ui8Field >= kTssNumFields) ||
+             (BlockHeader.m_ui16NumPoints == 0) ||
+             (BlockHeader.m_ui32BlockLen != (TSS_BLOCK_HEADER_SIZE + BlockHeader.m_ui32TimeBytes + BlockHeader.m_ui32ValueBytes)) ||
+             ((ui64Offset + BlockHeader.m_ui32BlockLen) > ui64FileSize_l) )
+        {
+            break;
+        }
+
+        BlockRef.m_ui64Offset     = ui64Offset;
+        BlockRef.m_ui32BlockLen   = BlockHeader.m_ui32BlockLen;
+        BlockRef.m_ui32TimeBytes  = BlockHeader.m_ui32TimeBytes;
+        BlockRef.m_ui32ValueBytes = BlockHeader.m_ui32ValueBytes;
+        BlockRef.m_ui16NumPoints  = BlockHeader.m_ui16NumPoints;
+        BlockRef.m_i64MinTime     = BlockHeader.m_i64MinTime;
+        BlockRef.m_i64MaxTime     = BlockHeader.m_i64MaxTime;
+        ui64Offset += BlockHeader.m_ui32BlockLen;
+
+        iRes = TssReadBlock(&BlockRef, &vecData);
+        if ( (iRes < 0) ||
+             (MlfCrc32(vecData.data(), vecData.size()) != BlockHeader.m_ui32DataCRC32) )
+        {
+            TRACE1("\nLoad StoreFile: damaged block at offset %llu\n", (unsigned long long)BlockRef.m_ui64Offset);
+            Statistics_l.m_uiBlocksDamaged++;
+            continue;
+        }
+
+        vecPoints.clear();
+        TssDecodeBlock(vecData.data(), BlockRef.m_ui32TimeBytes,
+                       vecData.data() + BlockRef.m_ui32TimeBytes, BlockRef.m_ui32ValueBytes,
+                       BlockRef.m_ui16NumPoints, INT64_MIN, INT64_MAX, &vecPoints);
+
+        pSeries = TssGetSeries(BlockHeader.m_ui8DevID, (tTssField)BlockHeader.m_ui8Field, true);
+        pSeries->m_vecBlocks.push_back(BlockRef);
+        for (const tTssPoint& Point : vecPoints)
+        {
+            TssUpdateRollups(pSeries, Point.m_i64Time, Point.m_dValue);
+        }
+
+        Statistics_l.m_uiBlocks++;
+        Statistics_l.m_ui64BytesStored  += BlockRef.m_ui32BlockLen;
+        Statistics_l.m_ui64PointsStored += BlockRef.m_ui16NumPoints;
+        Statistics_l.m_ui64PointsLoaded += vecPoints.size();
+    }
+
+    if (ui64Offset != ui64FileSize_l)
+    {
+        TRACE2("\nLoad StoreFile: torn block at offset %llu (file size %llu)\n", (unsigned long long)ui64Offset, (unsigned long long)ui64FileSize_l);
+        if ( !fReadOnly_l )
+        {
+            if (ftruncate(iFdStoreFile_l, (off_t)ui64Offset) != 0)
+            {
+                return (-1);
+            }
+            ui64FileSize_l = ui64Offset;
+        }
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Seal open Block and append it to StoreFile
+//---------------------------------------------------------------------------
+//  Header and both columns are written with one write(). If the write
+//  fails, the block is lost in the StoreFile (its points stay in the
+//  rollups), the file is cut back to the last complete block.
+
+static  int  TssSealBlock (
+    uint8_t ui8DevID_p,
+    tTssField Field_p,
+    tTssSeries* pSeries_p)
+{
+
+tTssOpenBlock*        pOpenBlock;
+tTssBlockHeader       BlockHeader;
+tTssBlockRef          BlockRef;
+std::vector<uint8_t>  vecBlock;
+std::vector<uint8_t>  vecTimeColumn;
+std::vector<uint8_t>  vecValueColumn;
+ssize_t               iRes;
+
+
+    pOpenBlock = &pSeries_p->m_OpenBlock;
+    TssGetColumnData(&pOpenBlock->m_TimeColumn, &vecTimeColumn);
+    TssGetColumnData(&pOpenBlock->m_ValueColumn, &vecValueColumn);
+
+    memset(&BlockHeader, 0, sizeof(BlockHeader));
+    BlockHeader.m_ui32BlockLen   = (uint32_t)(TSS_BLOCK_HEADER_SIZE + vecTimeColumn.size() + vecValueColumn.size());
+    BlockHeader.m_ui8DevID       = ui8DevID_p;
+    BlockHeader.m_ui8Field       = (uint8_t)Field_p;
+    BlockHeader.m_ui16NumPoints  = (uint16_t)pOpenBlock->m_CodecState.m_uiPoints;
+    BlockHeader.m_i64MinTime     = pOpenBlock->m_i64MinTime;
+    BlockHeader.m_i64MaxTime     = pOpenBlock->m_i64MaxTime;
+    BlockHeader.m_ui32TimeBytes  = (uint32_t)vecTimeColumn.size();
+    BlockHeader.m_ui32ValueBytes = (uint32_t)vecValueColumn.size();
+
+    vecBlock.reserve(BlockHeader.m_ui32BlockLen);
+    vecBlock.resize(TSS_BLOCK_HEADER_SIZE);
+    vecBlock.insert(vecBlock.end(), vecTimeColumn.begin(), vecTimeColumn.end());
+    vecBlock.insert(vecBlock.end(), vecValueColumn.begin(), vecValueColumn.end());
+    BlockHeader.m_ui32DataCRC32  = MlfCrc32(vecBlock.data() + TSS_BLOCK_HEADER_SIZE, vecBlock.size() - TSS_BLOCK_HEADER_SIZE);
+    BlockHeader.m_ui32CRC32      = TssBlockHeaderCrc(&BlockHeader);
+    memcpy(vecBlock.data(), &BlockHeader, sizeof(BlockHeader));
+
+    // start new block
+    pOpenBlock->m_TimeColumn.m_vecData.clear();
+    pOpenBlock->m_TimeColumn.m_ui64Acc = 0;
+    pOpenBlock->m_TimeColumn.m_uiAccBits = 0;
+    pOpenBlock->m_ValueColumn.m_vecData.clear();
+    pOpenBlock->m_ValueColumn.m_ui64Acc = 0;
+    pOpenBlock->m_ValueColumn.m_uiAccBits = 0;
+    memset(&pOpenBlock->m_CodecState, 0, sizeof(pOpenBlock->m_CodecState));
+
+    iRes = write(iFdStoreFile_l, vecBlock.data(), vecBlock.size());
+    TRACE3("\nSeal Block: DevID=%u, Field=%u -> iRes=%d\n", (uint)ui8DevID_p, (uint)Field_p, (int)iRes);
+    if (iRes != (ssize_t)vecBlock.size())
+    {
+        Statistics_l.m_uiWriteErrors++;
+        if (iRes > 0)
+        {
+            if (ftruncate(iFdStoreFile_l, (off_t)ui64FileSize_l) != 0)
+            {
+                TRACE0("\nSeal Block: can't cut off incomplete block\n");
+            }
+        }
+        return (-1);
+    }
+
+    BlockRef.m_ui64Offset     = ui64FileSize_l;
+    BlockRef.m_ui32BlockLen   = BlockHeader.m_ui32BlockLen;
+    BlockRef.m_ui32TimeBytes  = BlockHeader.m_ui32TimeBytes;
+    BlockRef.m_ui32ValueBytes = BlockHeader.m_ui32ValueBytes;
+    BlockRef.m_ui16NumPoints  = BlockHeader.m_ui16NumPoints;
+    BlockRef.m_i64MinTime     = BlockHeader.m_i64MinTime;
+    BlockRef.m_i64MaxTime     = BlockHeader.m_i64MaxTime;
+    pSeries_p->m_vecBlocks.push_back(BlockRef);
+    ui64FileSize_l += BlockHeader.m_ui32BlockLen;
+
+    Statistics_l.m_uiBlocks++;
+    Statistics_l.m_ui64BytesStored  += BlockHeader.m_ui32BlockLen;
+    Statistics_l.m_ui64PointsStored += BlockHeader.m_ui16NumPoints;
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Series of DevID/Field
+//---------------------------------------------------------------------------
+
+static  tTssSeries*  TssGetSeries (
+    uint8_t ui8DevID_p,
+    tTssField Field_p,
+    bool fCreate_p)
+{
+
+tTssSeries*  pSeries;
+uint         uiLevel;
+
+
+    pSeries = apSeries_l[ui8DevID_p][Field_p];
+    if ((pSeries == NULL) && fCreate_p)
+    {
+        pSeries = new tTssSeries;
+        memset(&pSeries->m_OpenBlock.m_CodecState, 0, sizeof(pSeries->m_OpenBlock.m_CodecState));
+        pSeries->m_OpenBlock.m_TimeColumn.m_ui64Acc    = 0;
+        pSeries->m_OpenBlock.m_TimeColumn.m_uiAccBits  = 0;
+        pSeries->m_OpenBlock.m_ValueColumn.m_ui64Acc   = 0;
+        pSeries->m_OpenBlock.m_ValueColumn.m_uiAccBits = 0;
+        pSeries->m_OpenBlock.m_i64MinTime = 0;
+        pSeries->m_OpenBlock.m_i64MaxTime = 0;
+        for (uiLevel=0; uiLevel<kTssNumLevels; uiLevel++)
+        {
+            pSeries->m_ai64RetainFrom[uiLevel] = INT64_MIN;
+        }
+        pSeries->m_i64NewestTime = INT64_MIN;
+        apSeries_l[ui8DevID_p][Field_p] = pSeries;
+    }
+
+    return (pSeries);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Update Rollups of Series with a Point
+//---------------------------------------------------------------------------
+//  Usually the bucket of the point is the last one (or is appended), so the
+//  bucket is searched from the end. Points older than the minute/hour
+//  buckets kept in memory are only stored raw.
+
+static  void  TssUpdateRollups (
+    tTssSeries* pSeries_p,
+    int64_t i64Time_p,
+    double dValue_p)
+{
+
+static const int64_t  ai64RetainTime[kTssNumLevels] = { 0, TSS_RETAIN_MINUTE, TSS_RETAIN_HOUR, 0 };
+std::deque<tTssRollup>*           pdeqRollups;
+std::deque<tTssRollup>::iterator  itRollup;
+tTssRollup                        Rollup;
+int64_t                           i64Bucket;
+int64_t                           i64RetainFrom;
+uint                              uiLevel;
+
+
+    if (i64Time_p > pSeries_p->m_i64NewestTime)
+    {
+        pSeries_p->m_i64NewestTime = i64Time_p;
+
+        // drop buckets beyond the retention time
+        for (uiLevel=kTssLevelMinute; uiLevel<kTssNumLevels; uiLevel++)
+        {
+            if (ai64RetainTime[uiLevel] == 0)
+            {
+                continue;
+            }
+            i64RetainFrom = TssGetBucketStart((tTssLevel)uiLevel, i64Time_p - ai64RetainTime[uiLevel]);
+            if (i64RetainFrom <= pSeries_p->m_ai64RetainFrom[uiLevel])
+            {
+                continue;
+            }
+            pSeries_p->m_ai64RetainFrom[uiLevel] = i64RetainFrom;
+            pdeqRollups = &pSeries_p->m_adeqRollups[uiLevel];
+            while ( !pdeqRollups->empty() && (pdeqRollups->front().m_i64Time < i64RetainFrom) )
+            {
+                pdeqRollups->pop_front();
+            }
+        }
+    }
+
+    for (uiLevel=kTssLevelMinute; uiLevel<kTssNumLevels; uiLevel++)
+    {
+        i64Bucket = TssGetBucketStart((tTssLevel)uiLevel, i64Time_p);
+        if (i64Bucket < pSeries_p->m_ai64RetainFrom[uiLevel])
+        {
+            continue;
+        }
+
+        pdeqRollups = &pSeries_p->m_adeqRollups[uiLevel];
+        itRollup = pdeqRollups->end();
+        while ((itRollup != pdeqRollups->begin()) && ((itRollup - 1)->m_i64Time > i64Bucket))
+        {
+            --itRollup;
+        }
+        if ((itRollup != pdeqRollups->begin()) && ((itRollup - 1)->m_i64Time == i64Bucket))
+        {
+            --itRollup;
+            itRollup->m_dMin = std::min(itRollup->m_dMin, dValue_p);
+            itRollup->m_dMax = std::max(itRollup->m_dMax, dValue_p);
+            itRollup->m_dSum += dValue_p;
+            itRollup->m_ui32Count++;
+        }
+        else
+        {
+            Rollup.m_i64Time   = i64Bucket;
+            Rollup.m_dMin      = dValue_p;
+            Rollup.m_dMax      = dValue_p;
+            Rollup.m_dSum      = dValue_p;
+            Rollup.m_ui32Count = 1;
+            pdeqRollups->insert(itRollup, Rollup);
+        }
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Start of Bucket containing a TimeStamp
+//---------------------------------------------------------------------------
+//  Hour and day buckets are aligned to local midnight. The ranges of the
+//  last local days are cached, mktime() (which checks the time zone file on
+//  every call) is only called for a day not in the cache.
+
+static  int64_t  TssGetBucketStart (
+    tTssLevel Level_p,
+    int64_t i64Time_p)
+{
+
+tTssDayRange*  pDayRange;
+struct tm      TimeInfo;
+time_t         tmTime;
+int64_t        i64Rest;
+uint           uiIdx;
+
+
+    if (Level_p == kTssLevelMinute)
+    {
+        i64Rest = i64Time_p % 60;
+        return (i64Time_p - ((i64Rest < 0) ? (i64Rest + 60) : i64Rest));
+    }
+
+    pDayRange = NULL;
+    for (uiIdx=0; uiIdx<(sizeof(aDayCache_l)/sizeof(aDayCache_l[0])); uiIdx++)
+    {
+        if ((i64Time_p >= aDayCache_l[uiIdx].m_i64Start) && (i64Time_p < aDayCache_l[uiIdx].m_i64End))
+        {
+            pDayRange = &aDayCache_l[uiIdx];
+            break;
+        }
+    }
+
+    if (pDayRange == NULL)
+    {
+        pDayRange = &aDayCache_l[uiDayCacheNext_l];
+        uiDayCacheNext_l = (uiDayCacheNext_l + 1) % (sizeof(aDayCache_l)/sizeof(aDayCache_l[0]));
+
+        tmTime = (time_t)i64Time_p;
+        localtime_r(&tmTime, &TimeInfo);
+        TimeInfo.tm_hour  = 0;
+        TimeInfo.tm_min   = 0;
+        TimeInfo.tm_sec   = 0;
+        TimeInfo.tm_isdst = -1;
+        pDayRange->m_i64Start = (int64_t)mktime(&TimeInfo);
+        TimeInfo.tm_mday++;
+        TimeInfo.tm_isdst = -1;
+        pDayRange->m_i64End = (int64_t)mktime(&TimeInfo);
+        if ((i64Time_p < pDayRange->m_i64Start) || (i64Time_p >= pDayRange->m_i64End))
+        {
+            // time outside of the range of mktime() -> UTC day
+            i64Rest = i64Time_p % 86400;
+            pDayRange->m_i64Start = i64Time_p - ((i64Rest < 0) ? (i64Rest + 86400) : i64Rest);
+            pDayRange->m_i64End   = pDayRange->m_i64Start + 86400;
+        }
+    }
+
+    if (Level_p == kTssLevelDay)
+    {
+        return (pDayRange->m_i64Start);
+    }
+
+    return (pDayRange->m_i64Start + (((i64Time_p - pDayRange->m_i64Start) / 3600) * 3600));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Read both Columns of a sealed Block
+//---------------------------------------------------------------------------
+
+static  int  TssReadBlock (
+    const tTssBlockRef* pBlockRef_p,
+    std::vector<uint8_t>* pvecData_p)
+{
+
+size_t   nDataLen;
+ssize_t  iRes;
+
+
+    nDataLen = pBlockRef_p->m_ui32TimeBytes + pBlockRef_p->m_ui32ValueBytes;
+    pvecData_p->resize(nDataLen);
+    iRes = pread(iFdStoreFile_l, pvecData_p->data(), nDataLen, (off_t)(pBlockRef_p->m_ui64Offset + TSS_BLOCK_HEADER_SIZE));
+    if (iRes != (ssize_t)nDataLen)
+    {
+        return (-1);
+    }
+
+    return (0);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Decode Block and append the Points of the Time Range
+//---------------------------------------------------------------------------
+
+static  void  TssDecodeBlock (
+    const uint8_t* pabTimeColumn_p,
+    size_t nTimeBytes_p,
+    const uint8_t* pabValueColumn_p,
+    size_t nValueBytes_p,
+    uint uiNumPoints_p,
+    int64_t i64FromTime_p,
+    int64_t i64ToTime_p,
+    std::vector<tTssPoint>* pvecPoints_p)
+{
+
+tTssCodecState  CodecState;
+tTssBitReader   TimeReader;
+tTssBitReader   ValueReader;
+tTssPoint       Point;
+uint            uiPoint;
+
+
+    memset(&CodecState, 0, sizeof(CodecState));
+    memset(&TimeReader, 0, sizeof(TimeReader));
+    memset(&ValueReader, 0, sizeof(ValueReader));
+    TimeReader.m_pabData   = pabTimeColumn_p;
+    TimeReader.m_nDataLen  = nTimeBytes_p;
+    ValueReader.m_pabData  = pabValueColumn_p;
+    ValueReader.m_nDataLen = nValueBytes_p;
+
+    for (uiPoint=0; uiPoint<uiNumPoints_p; uiPoint++)
+    {
+        if ( !TssDecodePoint(&CodecState, &TimeReader, &ValueReader, &Point.m_i64Time, &Point.m_dValue) )
+        {
+            break;
+        }
+        if ((Point.m_i64Time >= i64FromTime_p) && (Point.m_i64Time <= i64ToTime_p))
+        {
+            pvecPoints_p->push_back(Point);
+        }
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Encode Point (Time: Delta-of-Delta, Value: XOR with previous Value)
+//---------------------------------------------------------------------------
+//  Time Column:  first point 64 bit, then the change of the time delta:
+//                '0' = 0, '10' + 7 bit, '110' + 9 bit, '1110' + 12 bit,
+//                '1111' + 64 bit (two's complement)
+//  Value Column: first point 64 bit (IEEE double), then XOR with previous:
+//                '0' = same value, '10' + meaningful bits inside the window
+//                of the previous XOR, '11' + 5 bit leading zeros + 6 bit
+//                length (0 = 64) + meaningful bits
+
+static  void  TssEncodePoint (
+    tTssCodecState* pState_p,
+    tTssBitWriter* pTimeColumn_p,
+    tTssBitWriter* pValueColumn_p,
+    int64_t i64Time_p,
+    double dValue_p)
+{
+
+uint64_t  ui64Value;
+uint64_t  ui64Xor;
+int64_t   i64Delta;
+int64_t   i64DeltaOfDelta;
+uint      uiLeading;
+uint      uiTrailing;
+uint      uiBits;
+
+
+    memcpy(&ui64Value, &dValue_p, sizeof(ui64Value));
+
+    if (pState_p->m_uiPoints == 0)
+    {
+        TssPutBits(pTimeColumn_p, (uint64_t)i64Time_p, 64);
+        TssPutBits(pValueColumn_p, ui64Value, 64);
+        pState_p->m_i64PrevTime     = i64Time_p;
+        pState_p->m_i64PrevDelta    = 0;
+        pState_p->m_ui64PrevValue   = ui64Value;
+        pState_p->m_ui8PrevLeading  = TSS_NO_WINDOW;
+        pState_p->m_ui8PrevTrailing = 0;
+        pState_p->m_uiPoints = 1;
+        return;
+    }
+
+    // Time Column
+    i64Delta = (int64_t)((uint64_t)i64Time_p - (uint64_t)pState_p->m_i64PrevTime);
+    i64DeltaOfDelta = (int64_t)((uint64_t)i64Delta - (uint64_t)pState_p->m_i64PrevDelta);
+    if (i64DeltaOfDelta == 0)
+    {
+        TssPutBits(pTimeColumn_p, 0x0, 1);
+    }
+    else if ((i64DeltaOfDelta >= -64) && (i64DeltaOfDelta <= 63))
+    {
+        TssPutBits(pTimeColumn_p, 0x2, 2);
+        TssPutBits(pTimeColumn_p, (uint64_t)i64DeltaOfDelta, 7);
+    }
+    else if ((i64DeltaOfDelta >= -256) && (i64DeltaOfDelta <= 255))
+    {
+        TssPutBits(pTimeColumn_p, 0x6, 3);
+        TssPutBits(pTimeColumn_p, (uint64_t)i64DeltaOfDelta, 9);
+    }
+    else if ((i64DeltaOfDelta >= -2048) && (i64DeltaOfDelta <= 2047))
+    {
+        TssPutBits(pTimeColumn_p, 0xE, 4);
+        TssPutBits(pTimeColumn_p, (uint64_t)i64DeltaOfDelta, 12);
+    }
+    else
+    {
+        TssPutBits(pTimeColumn_p, 0xF, 4);
+        TssPutBits(pTimeColumn_p, (uint64_t)i64DeltaOfDelta, 64);
+    }
+    pState_p->m_i64PrevTime  = i64Time_p;
+    pState_p->m_i64PrevDelta = i64Delta;
+
+    // Value Column
+    ui64Xor = ui64Value ^ pState_p->m_ui64PrevValue;
+    if (ui64Xor == 0)
+    {
+        TssPutBits(pValueColumn_p, 0x0, 1);
+    }
+    else
+    {
+        uiLeading  = (uint)__builtin_clzll(ui64Xor);
+        uiTrailing = (uint)__builtin_ctzll(ui64Xor);
+        uiLeading  = std::min(uiLeading, 31U);
+        if ( (pState_p->m_ui8PrevLeading != TSS_NO_WINDOW) &&
+             (uiLeading >= pState_p->m_ui8PrevLeading) && (uiTrailing >= pState_p->m_ui8PrevTrailing) )
+        {
+            uiBits = 64 - pState_p->m_ui8PrevLeading - pState_p->m_ui8PrevTrailing;
+            TssPutBits(pValueColumn_p, 0x2, 2);
+            TssPutBits(pValueColumn_p, ui64Xor >> pState_p->m_ui8PrevTrailing, uiBits);
+        }
+        else
+        {
+            uiBits = 64 - uiLeading - uiTrailing;
+            TssPutBits(pValueColumn_p, 0x3, 2);
+            TssPutBits(pValueColumn_p, uiLeading, 5);
+            TssPutBits(pValueColumn_p, uiBits & 0x3F, 6);
+            TssPutBits(pValueColumn_p, ui64Xor >> uiTrailing, uiBits);
+            pState_p->m_ui8PrevLeading  = (uint8_t)uiLeading;
+            pState_p->m_ui8PrevTrailing = (uint8_t)uiTrailing;
+        }
+    }
+    pState_p->m_ui64PrevValue = ui64Value;
+    pState_p->m_uiPoints++;
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Decode Point (counterpart of TssEncodePoint())
+//---------------------------------------------------------------------------
+
+static  bool  TssDecodePoint (
+    tTssCodecState* pState_p,
+    tTssBitReader* pTimeColumn_p,
+    tTssBitReader* pValueColumn_p,
+    int64_t* pi64Time_p,
+    double* pdValue_p)
+{
+
+uint64_t  ui64Xor;
+int64_t   i64DeltaOfDelta;
+uint      uiLeading;
+uint      uiTrailing;
+uint      uiBits;
+
+
+    if (pState_p->m_uiPoints == 0)
+    {
+        pState_p->m_i64PrevTime     = (int64_t)TssGetBits(pTimeColumn_p, 64);
+        pState_p->m_i64PrevDelta    = 0;
+        pState_p->m_ui64PrevValue   = TssGetBits(pValueColumn_p, 64);
+        pState_p->m_ui8PrevLeading  = TSS_NO_WINDOW;
+        pState_p->m_ui8PrevTrailing = 0;
+    }
+    else
+    {
+        // Time Column
+        if (TssGetBits(pTimeColumn_p, 1) == 0)
+        {
+            i64DeltaOfDelta = 0;
+        }
+        else if (TssGetBits(pTimeColumn_p, 1) == 0)
+        {
+            i64DeltaOfDelta = ((int64_t)(TssGetBits(pTimeColumn_p, 7) << 57)) >> 57;
+        }
+        else if (TssGetBits(pTimeColumn_p, 1) == 0)
+        {
+            i64DeltaOfDelta = ((int64_t)(TssGetBits(pTimeColumn_p, 9) << 55)) >> 55;
+        }
+        else if (TssGetBits(pTimeColumn_p, 1) == 0)
+        {
+            i64DeltaOfDelta = ((int64_t)(TssGetBits(pTimeColumn_p, 12) << 52)) >> 52;
+        }
+        else
+        {
+            i64DeltaOfDelta = (int64_t)TssGetBits(pTimeColumn_p, 64);
+        }
+        pState_p->m_i64PrevDelta = (int64_t)((uint64_t)pState_p->m_i64PrevDelta + (uint64_t)i64DeltaOfDelta);
+        pState_p->m_i64PrevTime  = (int64_t)((uint64_t)pState_p->m_i64PrevTime + (uint64_t)pState_p->m_i64PrevDelta);
+
+        // Value Column
+        if (TssGetBits(pValueColumn_p, 1) != 0)
+        {
+            if (TssGetBits(pValueColumn_p, 1) == 0)
+            {
+                if (pState_p->m_ui8PrevLeading == TSS_NO_WINDOW)
+                {
+                    return (false);
+                }
+                uiBits = 64 - pState_p->m_ui8PrevLeading - pState_p->m_ui8PrevTrailing;
+                ui64Xor = TssGetBits(pValueColumn_p, uiBits) << pState_p->m_ui8PrevTrailing;
+            }
+            else
+            {
+                uiLeading = (uint)TssGetBits(pValueColumn_p, 5);
+                uiBits    = (uint)TssGetBits(pValueColumn_p, 6);
+                uiBits    = ((uiBits == 0) ? 64 : uiBits);
+                if ((uiLeading + uiBits) > 64)
+                {
+                    return (false);
+                }
+                uiTrailing = 64 - uiLeading - uiBits;
+                ui64Xor = TssGetBits(pValueColumn_p, uiBits) << uiTrailing;
+                pState_p->m_ui8PrevLeading  = (uint8_t)uiLeading;
+                pState_p->m_ui8PrevTrailing = (uint8_t)uiTrailing;
+            }
+            pState_p->m_ui64PrevValue ^= ui64Xor;
+        }
+    }
+
+    if (pTimeColumn_p->m_fOverrun || pValueColumn_p->m_fOverrun)
+    {
+        return (false);
+    }
+
+    pState_p->m_uiPoints++;
+    *pi64Time_p = pState_p->m_i64PrevTime;
+    memcpy(pdValue_p, &pState_p->m_ui64PrevValue, sizeof(double));
+
+    return (true);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Get Bytes of a Column (incl. incomplete last byte)
+//---------------------------------------------------------------------------
+
+static  void  TssGetColumnData (
+    const tTssBitWriter* pColumn_p,
+    std::vector<uint8_t>* pvecData_p)
+{
+
+    *pvecData_p = pColumn_p->m_vecData;
+    if (pColumn_p->m_uiAccBits > 0)
+    {
+        pvecData_p->push_back((uint8_t)(pColumn_p->m_ui64Acc << (8 - pColumn_p->m_uiAccBits)));
+    }
+
+    return;
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Bit Stream Access (MSB first, 1..64 bits)
+//---------------------------------------------------------------------------
+
+static  inline  void  TssPutBits (
+    tTssBitWriter* pWriter_p,
+    uint64_t ui64Value_p,
+    uint uiBits_p)
+{
+
+    if (uiBits_p > 32)
+    {
+        TssPutBits(pWriter_p, ui64Value_p >> 32, uiBits_p - 32);
+        uiBits_p = 32;
+    }
+
+    pWriter_p->m_ui64Acc = (pWriter_p->m_ui64Acc << uiBits_p) | (ui64Value_p & ((1ULL << uiBits_p) - 1));
+    pWriter_p->m_uiAccBits += uiBits_p;
+    while (pWriter_p->m_uiAccBits >= 8)
+    {
+        pWriter_p->m_uiAccBits -= 8;
+        pWriter_p->m_vecData.push_back((uint8_t)(pWriter_p->m_ui64Acc >> pWriter_p->m_uiAccBits));
+    }
+    pWriter_p->m_ui64Acc &= ((1ULL << pWriter_p->m_uiAccBits) - 1);
+
+    return;
+
+}
+
+
+static  inline  uint64_t  TssGetBits (
+    tTssBitReader* pReader_p,
+    uint uiBits_p)
+{
+
+uint64_t  ui64Value;
+
+
+    if (uiBits_p > 32)
+    {
+        ui64Value = TssGetBits(pReader_p, uiBits_p - 32) << 32;
+        return (ui64Value | TssGetBits(pReader_p, 32));
+    }
+
+    while ((pReader_p->m_uiAccBits <= 56) && (pReader_p->m_nPos < pReader_p->m_nDataLen))
+    {
+        pReader_p->m_ui64Acc = (pReader_p->m_ui64Acc << 8) | pReader_p->m_pabData[pReader_p->m_nPos++];
+        pReader_p->m_uiAccBits += 8;
+    }
+    if (pReader_p->m_uiAccBits < uiBits_p)
+    {
+        // end of column -> pad with zeros
+        pReader_p->m_ui64Acc <<= (uiBits_p - pReader_p->m_uiAccBits);
+        pReader_p->m_uiAccBits = uiBits_p;
+        pReader_p->m_fOverrun = true;
+    }
+
+    pReader_p->m_uiAccBits -= uiBits_p;
+    ui64Value = (pReader_p->m_ui64Acc >> pReader_p->m_uiAccBits) & ((1ULL << uiBits_p) - 1);
+
+    return (ui64Value);
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  Time Arithmetic limited to INT64_MAX
+//---------------------------------------------------------------------------
+
+static  inline  int64_t  TssAddSaturated (
+    int64_t i64Time_p,
+    int64_t i64Diff_p)
+{
+
+    return ((i64Time_p > (INT64_MAX - i64Diff_p)) ? INT64_MAX : (i64Time_p + i64Diff_p));
+
+}
+
+
+
+//---------------------------------------------------------------------------
+//  CRC32 of Headers
+//---------------------------------------------------------------------------
+
+static  inline  uint32_t  TssFileHeaderCrc (
+    const tTssFileHeader* pFileHeader_p)
+{
+
+    return (MlfCrc32(pFileHeader_p, offsetof(tTssFileHeader, m_ui32CRC32)));
+
+}
+
+
+static  inline  uint32_t  TssBlockHeaderCrc (
+    const tTssBlockHeader* pBlockHeader_p)
+{
+
+    return (MlfCrc32(pBlockHeader_p, offsetof(tTssBlockHeader, m_ui32CRC32)));
+
+}
+
+
+
+// EOF
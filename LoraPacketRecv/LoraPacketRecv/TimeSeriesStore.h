@@ -0,0 +1,215 @@
+/****************************************************************************
+
+  Copyright (c) 2026 Ronald Sieber
+
+  Project:      LoRa Packet Receiver
+  Description:  Declarations for embedded Time Series Store
+
+  -------------------------------------------------------------------------
+
+  Revision History:
+
+  2026/10/18 -rs:   V1.00 Initial version
+
+****************************************************************************/
+
+#ifndef _TIMESERIESSTORE_H_
+#define _TIMESERIESSTORE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+
+//---------------------------------------------------------------------------
+//  Constant definitions
+//---------------------------------------------------------------------------
+// Notice:  The store keeps one series per DevID and field. The points of a
+//          series are collected in a block, which is sealed and appended to
+//          the StoreFile after TSS_BLOCK_MAX_POINTS points or TSS_BLOCK_MAX_SPAN
+//          seconds. A block is columnar: a <tTssBlockHeader> followed by the
+//          time column (delta-of-delta encoded) and the value column (XOR of
+//          consecutive doubles), both as MSB-first bit streams.
+//
+//          Rollups (min/max/mean/count) of 1 minute, 1 hour and 1 day are
+//          kept in memory and updated on every point added. At open they are
+//          rebuilt from the blocks of the StoreFile. Minute and hour rollups
+//          are kept for TSS_RETAIN_MINUTE/TSS_RETAIN_HOUR seconds behind the
+//          newest point of the series, older ranges are aggregated from the
+//          blocks on query. Hour and day buckets follow local time.
+//
+//          Like the IndexFile, the StoreFile can always be rebuilt from the
+//          MessageFile (LoraMsgLog -y), so it is written without O_SYNC. The
+//          open blocks are written at close, a power failure loses them.
+//---------------------------------------------------------------------------
+
+const  char      TSS_FILE_MAGIC[8]      = { 'L','o','r','a','T','S','S','t' };
+const  uint16_t  TSS_FORMAT_VERSION     = 1;
+const  size_t    TSS_HEADER_SIZE        = 64;
+const  size_t    TSS_BLOCK_HEADER_SIZE  = 48;
+const  uint      TSS_BLOCK_MAX_POINTS   = 1024;
+const  uint      TSS_BLOCK_MAX_SPAN     = 6 * 3600;         // [sec]
+const  uint      TSS_MAX_DEVICES        = 256;
+const  uint      TSS_RETAIN_MINUTE      = 2 * 86400;        // [sec]
+const  uint      TSS_RETAIN_HOUR        = 62 * 86400;       // [sec]
+
+
+
+//---------------------------------------------------------------------------
+//  Type definitions
+//---------------------------------------------------------------------------
+
+//  Fields stored per Device (decoded from <tLoraDataRec> by LORA_SCHEMA_DATA_REC)
+typedef enum
+{
+    kTssFieldTemperature        = 0,
+    kTssFieldHumidity           = 1,
+    kTssFieldLightLevel         = 2,
+    kTssFieldCarBattLevel       = 3,
+    kTssFieldMotionActiveTime   = 4,
+    kTssNumFields
+
+} tTssField;
+
+
+typedef enum
+{
+    kTssLevelRaw                = 0,
+    kTssLevelMinute             = 1,
+    kTssLevelHour               = 2,
+    kTssLevelDay                = 3,
+    kTssNumLevels
+
+} tTssLevel;
+
+
+typedef struct
+{
+    char                m_achMagic[8];              // TSS_FILE_MAGIC
+    uint16_t            m_ui16FormatVersion;        // TSS_FORMAT_VERSION
+    uint16_t            m_ui16SchemaVersion;        // LORA_SCHEMA_VERSION of writer
+    uint16_t            m_ui16HeaderSize;           // TSS_HEADER_SIZE
+    uint16_t            m_ui16BlockHeaderSize;      // TSS_BLOCK_HEADER_SIZE
+    int64_t             m_i64CreateTime;            // Linux Standard Time of file creation
+    uint8_t             m_abReserved[36];
+    uint32_t            m_ui32CRC32;                // CRC32 over all preceding bytes
+
+} tTssFileHeader;
+
+
+typedef struct
+{
+    uint32_t            m_ui32BlockLen;             // Header + Time Column + Value Column [bytes]
+    uint8_t             m_ui8DevID;
+    uint8_t             m_ui8Field;                 // tTssField
+    uint16_t            m_ui16NumPoints;
+    int64_t             m_i64MinTime;               // TimeStamp range of points in block
+    int64_t             m_i64MaxTime;
+    uint32_t            m_ui32TimeBytes;            // size of Time Column
+    uint32_t            m_ui32ValueBytes;           // size of Value Column
+    uint32_t            m_ui32DataCRC32;            // CRC32 over both Columns
+    uint8_t             m_abReserved[8];
+    uint32_t            m_ui32CRC32;                // CRC32 over all preceding bytes
+
+} tTssBlockHeader;
+
+
+static_assert(sizeof(tTssFileHeader)  == TSS_HEADER_SIZE,       "unexpected size of <tTssFileHeader>");
+static_assert(sizeof(tTssBlockHeader) == TSS_BLOCK_HEADER_SIZE, "unexpected size of <tTssBlockHeader>");
+
+
+typedef struct
+{
+    int64_t             m_i64Time;
+    double              m_dValue;
+
+} tTssPoint;
+
+
+typedef struct
+{
+    int64_t             m_i64Time;                  // start of bucket
+    double              m_dMin;
+    double              m_dMax;
+    double              m_dMean;
+    uint32_t            m_ui32Count;
+
+} tTssAggregate;
+
+
+typedef struct
+{
+    uint64_t            m_ui64PointsAdded;
+    uint64_t            m_ui64PointsLoaded;         // points of StoreFile replayed at open
+    uint                m_uiSeries;
+    uint                m_uiBlocks;                 // sealed blocks in StoreFile
+    uint                m_uiBlocksDamaged;          // blocks skipped at open (CRC)
+    uint                m_uiWriteErrors;
+    uint64_t            m_ui64BytesStored;          // size of sealed blocks in StoreFile
+    uint64_t            m_ui64PointsStored;         // points in sealed blocks
+    uint                m_uiRollups[kTssNumLevels]; // buckets kept in memory
+
+} tTssStatistics;
+
+
+
+//---------------------------------------------------------------------------
+//  Prototypes of public functions
+//---------------------------------------------------------------------------
+
+//  The store is used by one thread only (no locking).
+int  TssOpen (
+    const char* pszStoreFileName_p,                     // [IN]     Path/Name of StoreFile
+    bool fReadOnly_p);                                  // [IN]     only query (e.g. StoreFile of running Gateway)
+
+int  TssClose (void);
+
+int  TssAddMessage (
+    const tJsonMessage* pJsonMessage_p);                // [IN]     Json Message (only Data Records are stored)
+
+int  TssAddPoint (
+    uint8_t ui8DevID_p,                                 // [IN]     DevID of Series
+    tTssField Field_p,                                  // [IN]     Field of Series
+    int64_t i64Time_p,                                  // [IN]     TimeStamp of Point
+    double dValue_p);                                   // [IN]     Value of Point
+
+int  TssQueryRaw (
+    uint8_t ui8DevID_p,                                 // [IN]     DevID of Series
+    tTssField Field_p,                                  // [IN]     Field of Series
+    int64_t i64FromTime_p,                              // [IN]     Time Range (both inclusive)
+    int64_t i64ToTime_p,
+    std::vector<tTssPoint>* pvecPoints_p);              // [OUT]    Ptr to Vector with Points sorted by time
+
+int  TssQueryAggregate (
+    uint8_t ui8DevID_p,                                 // [IN]     DevID of Series
+    tTssField Field_p,                                  // [IN]     Field of Series
+    tTssLevel Level_p,                                  // [IN]     Minute, Hour or Day
+    int64_t i64FromTime_p,                              // [IN]     Range of bucket start times (both inclusive)
+    int64_t i64ToTime_p,
+    std::vector<tTssAggregate>* pvecAggregates_p);      // [OUT]    Ptr to Vector with Buckets sorted by time
+
+bool  TssHasSeries (
+    uint8_t ui8DevID_p,                                 // [IN]     DevID of Series
+    tTssField Field_p);                                 // [IN]     Field of Series
+
+const char*  TssGetFieldName (
+    tTssField Field_p);                                 // [IN]     Field
+
+uint  TssGetFieldDecimals (
+    tTssField Field_p);                                 // [IN]     Field
+
+bool  TssGetFieldByName (
+    const char* pszFieldName_p,                         // [IN]     Name as in Json Record (case insensitive)
+    tTssField* pField_p);                               // [OUT]    Field
+
+void  TssGetStatistics (
+    tTssStatistics* pStatistics_p);                     // [OUT]    Ptr to Statistics
+
+void  TssPrintStatistics (void);
+
+
+
+#endif  // #ifndef _TIMESERIESSTORE_H_
+
+
+// EOF
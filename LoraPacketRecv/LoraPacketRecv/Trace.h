@@ -10,6 +10,7 @@
   Revision History:
 
   2021/01/22 -rs:   V1.00 Initial version
+  2026/10/18 -rs:   V1.01 TRACE records are written via BinaryLogger
 
 ****************************************************************************/
 
@@ -21,7 +22,11 @@
 
 #if !defined(NDEBUG)
 
-    #define TRACE  trace
+    // TRACE records are stored unformatted in the ring of the calling thread
+    // and formatted by the BinaryLogger thread (log level 'kBlgLevelDebug')
+    #include "BinaryLogger.h"
+
+    #define TRACE(...)  BLG_DEBUG(__VA_ARGS__)
     void  trace (const char* pszFmt_p, ...);
 
     #ifndef TRACE
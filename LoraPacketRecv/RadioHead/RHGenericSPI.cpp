@@ -14,6 +14,15 @@ RHGenericSPI::RHGenericSPI(Frequency frequency, BitOrder bitOrder, DataMode data
 {
 }
 
+void RHGenericSPI::transfern(uint8_t* buf, uint16_t len)
+{
+    while (len--)
+    {
+	*buf = transfer(*buf);
+	buf++;
+    }
+}
+
 void RHGenericSPI::setBitOrder(BitOrder bitOrder)
 {
     _bitOrder = bitOrder;
@@ -89,6 +89,14 @@ public:
     /// \return The octet read from SPI while the data octet was sent
     virtual uint8_t transfer(uint8_t data) = 0;
 
+    /// Transfer a buffer of octets to and from the SPI interface in one full-duplex transaction.
+    /// Each octet in the buffer is sent and replaced by the octet read while it was sent.
+    /// The default implementation calls transfer() for each octet, subclasses
+    /// override it if the platform can transfer a whole buffer at once.
+    /// \param[in,out] buf The octets to send, overwritten with the octets read
+    /// \param[in] len Number of octets in buf
+    virtual void transfern(uint8_t* buf, uint16_t len);
+
     /// SPI Configuration methods
     /// Enable SPI interrupts (if supported)
     /// This can be used in an SPI slave to indicate when an SPI message has been received
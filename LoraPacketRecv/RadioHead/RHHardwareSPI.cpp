@@ -43,6 +43,13 @@ uint8_t RHHardwareSPI::transfer(uint8_t data)
     return SPI.transfer(data);
 }
 
+#if (RH_PLATFORM == RH_PLATFORM_RASPI)
+void RHHardwareSPI::transfern(uint8_t* buf, uint16_t len)
+{
+    SPI.transfern(buf, len);
+}
+#endif
+
 void RHHardwareSPI::attachInterrupt() 
 {
 #if (RH_PLATFORM == RH_PLATFORM_ARDUINO)
@@ -34,6 +34,13 @@ public:
     /// \return The octet read from SPI while the data octet was sent
     uint8_t transfer(uint8_t data);
 
+#if (RH_PLATFORM == RH_PLATFORM_RASPI)
+    /// Transfer a buffer of octets to and from the SPI interface in one full-duplex transaction
+    /// \param[in,out] buf The octets to send, overwritten with the octets read
+    /// \param[in] len Number of octets in buf
+    void transfern(uint8_t* buf, uint16_t len);
+#endif
+
     // SPI Configuration methods
     /// Enable SPI interrupts
     /// This can be used in an SPI slave to indicate when an SPI message has been received
@@ -27,6 +27,70 @@ bool RHSPIDriver::init()
     return true;
 }
 
+#if (RH_PLATFORM == RH_PLATFORM_RASPI)
+// On Linux each SPI transfer is a separate call into the bcm2835 library or
+// the spidev driver, so every register access is done as one full-duplex
+// transfer of the address byte followed by the data bytes.
+
+uint8_t RHSPIDriver::spiRead(uint8_t reg)
+{
+    uint8_t buf[2];
+    buf[0] = reg & ~RH_SPI_WRITE_MASK; // Send the address with the write mask off
+    buf[1] = 0; // The written value is ignored, reg value is read
+    RPI_CE0_CE1_FIX;
+    ATOMIC_BLOCK_START;
+    digitalWrite(_slaveSelectPin, LOW);
+    _spi.transfern(buf, sizeof(buf));
+    digitalWrite(_slaveSelectPin, HIGH);
+    ATOMIC_BLOCK_END;
+    return buf[1];
+}
+
+uint8_t RHSPIDriver::spiWrite(uint8_t reg, uint8_t val)
+{
+    uint8_t buf[2];
+    buf[0] = reg | RH_SPI_WRITE_MASK; // Send the address with the write mask on
+    buf[1] = val; // New value follows
+    RPI_CE0_CE1_FIX;
+    ATOMIC_BLOCK_START;
+    digitalWrite(_slaveSelectPin, LOW);
+    _spi.transfern(buf, sizeof(buf));
+    digitalWrite(_slaveSelectPin, HIGH);
+    ATOMIC_BLOCK_END;
+    return buf[0];
+}
+
+uint8_t RHSPIDriver::spiBurstRead(uint8_t reg, uint8_t* dest, uint8_t len)
+{
+    uint8_t buf[1 + 255];
+    buf[0] = reg & ~RH_SPI_WRITE_MASK; // Send the start address with the write mask off
+    memset(buf + 1, 0, len);
+    RPI_CE0_CE1_FIX;
+    ATOMIC_BLOCK_START;
+    digitalWrite(_slaveSelectPin, LOW);
+    _spi.transfern(buf, 1 + len);
+    digitalWrite(_slaveSelectPin, HIGH);
+    ATOMIC_BLOCK_END;
+    memcpy(dest, buf + 1, len);
+    return buf[0];
+}
+
+uint8_t RHSPIDriver::spiBurstWrite(uint8_t reg, const uint8_t* src, uint8_t len)
+{
+    uint8_t buf[1 + 255];
+    buf[0] = reg | RH_SPI_WRITE_MASK; // Send the start address with the write mask on
+    memcpy(buf + 1, src, len);
+    RPI_CE0_CE1_FIX;
+    ATOMIC_BLOCK_START;
+    digitalWrite(_slaveSelectPin, LOW);
+    _spi.transfern(buf, 1 + len);
+    digitalWrite(_slaveSelectPin, HIGH);
+    ATOMIC_BLOCK_END;
+    return buf[0];
+}
+
+#else
+
 uint8_t RHSPIDriver::spiRead(uint8_t reg)
 {
     uint8_t val;
@@ -81,6 +145,8 @@ uint8_t RHSPIDriver::spiBurstWrite(uint8_t reg, const uint8_t* src, uint8_t len)
     return status;
 }
 
+#endif
+
 void RHSPIDriver::setSlaveSelectPin(uint8_t slaveSelectPin)
 {
     _slaveSelectPin = slaveSelectPin;
@@ -10,12 +10,37 @@
 
 #if (RH_PLATFORM == RH_PLATFORM_RASPI)
 #include <sys/time.h>
+#include <sys/ioctl.h>
 #include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/spi/spidev.h>
 #include "RasPi.h"
 
 //Initialize the values for sanity
 timeval RHStartTime;
 
+//SPI transport: spidev file descriptor (-1 = bcm2835 library) or loopback
+static int spiDevFd = -1;
+static bool spiLoopback = false;
+static bool spiBulk = true;
+static uint32_t spiClockHz = 0;
+static uint32_t spiSpeedHz = RASPI_SPI_CORE_CLOCK / BCM2835_SPI_CLOCK_DIVIDER_256;
+
+static void spidevTransfer(byte* buf, uint32_t len)
+{
+  struct spi_ioc_transfer xfer;
+
+  memset(&xfer, 0, sizeof(xfer));
+  xfer.tx_buf = (unsigned long)buf;
+  xfer.rx_buf = (unsigned long)buf;
+  xfer.len = len;
+  xfer.speed_hz = spiSpeedHz;
+  xfer.bits_per_word = 8;
+  if (ioctl(spiDevFd, SPI_IOC_MESSAGE(1), &xfer) < 0)
+    memset(buf, 0, len);
+}
+
 void SPIClass::begin()
 {
   //Set SPI Defaults
@@ -28,14 +53,43 @@ void SPIClass::begin()
 
 void SPIClass::begin(uint16_t divider, uint8_t bitOrder, uint8_t dataMode)
 {
-  setClockDivider(divider);
-  setBitOrder(bitOrder);
-  setDataMode(dataMode);
-	bcm2835_spi_chipSelect(BCM2835_SPI_CS_NONE); // RH Library code control CS line
+  //A configured clock overrides the divider, the BCM2835 only divides by even numbers
+  if (spiClockHz != 0)
+  {
+    uint32_t div = (RASPI_SPI_CORE_CLOCK + spiClockHz - 1) / spiClockHz;
+    div = (div + 1) & ~1;
+    if (div < 2)
+      div = 2;
+    if (div > 65534)
+      div = 65534;
+    divider = div;
+  }
+  spiSpeedHz = RASPI_SPI_CORE_CLOCK / divider;
 
-  bcm2835_spi_begin();
+  if (spiDevFd >= 0)
+  {
+    //BCM2835_SPI_MODEx are the same as SPI_MODE_x, RH Library code control CS line
+    uint8_t mode = dataMode | SPI_NO_CS;
+    uint8_t lsbFirst = (bitOrder == BCM2835_SPI_BIT_ORDER_LSBFIRST) ? 1 : 0;
+    uint8_t bits = 8;
+    if (spiClockHz != 0)
+      spiSpeedHz = spiClockHz;
+    if ((ioctl(spiDevFd, SPI_IOC_WR_MODE, &mode) < 0) ||
+        (ioctl(spiDevFd, SPI_IOC_WR_LSB_FIRST, &lsbFirst) < 0) ||
+        (ioctl(spiDevFd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0) ||
+        (ioctl(spiDevFd, SPI_IOC_WR_MAX_SPEED_HZ, &spiSpeedHz) < 0))
+      printf("SPIClass::begin: configuration of spidev failed\n");
+  }
+  else if (!spiLoopback)
+  {
+    //bcm2835_spi_begin() clears the control register, so configure afterwards
+    bcm2835_spi_begin();
 
-  //bcm2835_spi_chipSelect(BCM2835_SPI_CS_NONE); // RH Library code control CS line
+    setClockDivider(divider);
+    setBitOrder(bitOrder);
+    setDataMode(dataMode);
+    bcm2835_spi_chipSelect(BCM2835_SPI_CS_NONE); // RH Library code control CS line
+  }
 
   //Initialize a timestamp for millis calculation
   gettimeofday(&RHStartTime, NULL);
@@ -44,7 +98,8 @@ void SPIClass::begin(uint16_t divider, uint8_t bitOrder, uint8_t dataMode)
 void SPIClass::end()
 {
   //End the SPI
-  bcm2835_spi_end();
+  if ((spiDevFd < 0) && !spiLoopback)
+    bcm2835_spi_end();
 }
 
 void SPIClass::setBitOrder(uint8_t bitOrder)
@@ -67,17 +122,78 @@ void SPIClass::setClockDivider(uint16_t rate)
 
 byte SPIClass::transfer(byte _data)
 {
-  //Set which CS pin to use for next transfers
-  bcm2835_spi_chipSelect(BCM2835_SPI_CS_NONE);
+  //CS pin (BCM2835_SPI_CS_NONE) is set once in begin()
   //Transfer 1 byte
   
   //printf("SPIClass::transfer(%02X)", _data);
   byte data;
-  data = bcm2835_spi_transfer((uint8_t)_data);
+  if (spiLoopback)
+    data = _data;
+  else if (spiDevFd >= 0)
+  {
+    data = _data;
+    spidevTransfer(&data, 1);
+  }
+  else
+    data = bcm2835_spi_transfer((uint8_t)_data);
   //printf("=%02X\n", data);
   return data;
 }
 
+void SPIClass::transfern(byte* buf, uint32_t len)
+{
+  if (!spiBulk)
+  {
+    //Octet by octet as with transfer()
+    for (uint32_t i = 0; i < len; i++)
+      buf[i] = transfer(buf[i]);
+    return;
+  }
+
+  //Transfer the whole buffer in one call
+  if (spiLoopback)
+    return;
+  if (spiDevFd >= 0)
+    spidevTransfer(buf, len);
+  else
+    bcm2835_spi_transfern((char*)buf, len);
+}
+
+bool SPIClass::setDevice(const char* device)
+{
+  if (spiDevFd >= 0)
+  {
+    close(spiDevFd);
+    spiDevFd = -1;
+  }
+  spiLoopback = false;
+
+  if (device == NULL)
+    return true;
+  if (strcmp(device, RASPI_SPI_DEV_LOOPBACK) == 0)
+  {
+    spiLoopback = true;
+    return true;
+  }
+  spiDevFd = open(device, O_RDWR);
+  return (spiDevFd >= 0);
+}
+
+void SPIClass::setClockHz(uint32_t hz)
+{
+  spiClockHz = hz;
+}
+
+uint32_t SPIClass::getClockHz()
+{
+  return spiSpeedHz;
+}
+
+void SPIClass::setBulkTransfers(bool enable)
+{
+  spiBulk = enable;
+}
+
 void pinMode(unsigned char pin, unsigned char mode)
 {
   if (pin == NOT_A_PIN)
@@ -37,10 +37,19 @@ typedef unsigned char byte;
 #define memcpy_P memcpy 
 #endif
 
+// SPI device name for setDevice() that selects a loopback device: no hardware
+// access, every octet reads back as sent (like MOSI connected to MISO)
+#define RASPI_SPI_DEV_LOOPBACK "loopback"
+
+// Core clock of the BCM2835 SPI0, divided by the SPI clock divider
+#define RASPI_SPI_CORE_CLOCK 250000000
+
 class SPIClass
 {
   public:
     static byte transfer(byte _data);
+    // Full-duplex transfer of a buffer in one call, received octets overwrite the sent ones
+    static void transfern(byte* buf, uint32_t len);
     // SPI Configuration methods
     static void begin(); // Default
     static void begin(uint16_t, uint8_t, uint8_t);
@@ -48,6 +57,15 @@ class SPIClass
     static void setBitOrder(uint8_t);
     static void setDataMode(uint8_t);
     static void setClockDivider(uint16_t);
+    // Call before begin(): NULL = SPI0 through bcm2835 library (default),
+    // "/dev/spidevX.Y" = Linux spidev driver, RASPI_SPI_DEV_LOOPBACK = loopback
+    static bool setDevice(const char* device);
+    // Call before begin(): SPI clock [Hz], 0 = use divider given to begin()
+    static void setClockHz(uint32_t hz);
+    // SPI clock [Hz] in use after begin()
+    static uint32_t getClockHz();
+    // Bulk transfers on (default) or off (transfern() calls transfer() per octet)
+    static void setBulkTransfers(bool enable);
 };
 
 extern SPIClass SPI;